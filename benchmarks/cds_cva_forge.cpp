@@ -0,0 +1,423 @@
+/*******************************************************************************
+
+   cds_cva_forge - CVA of a CDS with per-scenario credit curves on Forge kernels
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+// Usage:
+//   cds_cva_forge [--engine=midpoint|isda] [--paths=N] [--steps=N]
+//                 [--runs=N] [--seed=N]
+//
+// A protection buyer CDS is priced at numSteps exposure dates over numPaths
+// credit scenarios.  Each scenario moves the hazard rate pillars of the
+// reference entity, those of the counterparty and the discount rate; the
+// CVA contribution of an exposure date is
+//
+//     LGD_c * max(NPV(t_k), 0) * D(t_k+1) * (Q_c(t_k) - Q_c(t_k+1))
+//
+// with both credit curves rebuilt from the scenario, so that the
+// counterparty curve is re-evaluated per scenario as in a CVA run.
+//
+// Four methods compute the CVA and its sensitivities to the 13 risk
+// factors: QuantLib re-pricing (values only), a forward Forge kernel per
+// exposure date (values only), the same kernel with one-sided bumps, and
+// an AAD kernel.  The Forge values are checked scenario by scenario
+// against QuantLib: with --engine=isda, kernels only stay valid across
+// scenarios if quantlib-isdacdsengine.cpp.patch is applied, since the
+// engine switches between a Taylor expansion and the exact integral of a
+// node interval depending on the rates.  The exit code is 1 if any check
+// fails.
+
+#include <ql/instruments/creditdefaultswap.hpp>
+#include <ql/pricingengines/credit/isdacdsengine.hpp>
+#include <ql/pricingengines/credit/midpointcdsengine.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/settings.hpp>
+#include <ql/termstructures/credit/interpolatedhazardratecurve.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/calendars/weekendsonly.hpp>
+#include <ql/time/daycounters/actual360.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+#include <ql/time/schedule.hpp>
+#include <ql/forge/batchevaluator.hpp>
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace QuantLib;
+
+namespace {
+
+    struct Options {
+        std::string engine = "midpoint";
+        Size numPaths = 1000;
+        Size numSteps = 8;
+        Size runs = 5;
+        unsigned int seed = 42;
+    };
+
+    Size parseSize(const std::string& option, const std::string& value) {
+        char* end = nullptr;
+        unsigned long long n = std::strtoull(value.c_str(), &end, 10);
+        QL_REQUIRE(!value.empty() && *end == '\0', "invalid value '" << value << "' for " << option);
+        return Size(n);
+    }
+
+    Options parse(int argc, char* argv[]) {
+        Options options;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            std::string::size_type eq = arg.find('=');
+            std::string key = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+            if (key == "--engine") {
+                QL_REQUIRE(value == "midpoint" || value == "isda", "unknown engine '" << value << "'");
+                options.engine = value;
+            } else if (key == "--paths") {
+                options.numPaths = parseSize(key, value);
+            } else if (key == "--steps") {
+                options.numSteps = parseSize(key, value);
+            } else if (key == "--runs") {
+                options.runs = parseSize(key, value);
+            } else if (key == "--seed") {
+                options.seed = static_cast<unsigned int>(parseSize(key, value));
+            } else {
+                QL_FAIL("unknown option " << arg);
+            }
+        }
+        QL_REQUIRE(options.numPaths > 0 && options.numSteps > 0 && options.runs > 0,
+                   "empty benchmark configuration");
+        return options;
+    }
+
+    // risk factors: reference entity hazard pillars, counterparty hazard
+    // pillars, flat discount rate
+    const Period hazardTenors[] = {Period(6, Months), Period(1, Years), Period(2, Years),
+                                   Period(3, Years),  Period(5, Years), Period(7, Years)};
+    constexpr Size numPillars = 6;
+    constexpr Size numFactors = 2 * numPillars + 1;
+    const double referenceHazards[numPillars] = {0.0080, 0.0090, 0.0105, 0.0120, 0.0140, 0.0150};
+    const double counterpartyHazards[numPillars] = {0.0150, 0.0160, 0.0175, 0.0190, 0.0210, 0.0220};
+    constexpr double baseRate = 0.02;
+    constexpr double hazardVolatility = 0.5, rateVolatility = 0.01, creditCorrelation = 0.7;
+    constexpr Integer tradeMonths = 60;
+    constexpr double notional = 10000000.0, spread = 0.01, recovery = 0.4;
+    constexpr double counterpartyRecovery = 0.4;
+
+    std::string factorName(Size i) {
+        static const char* tenors[] = {"6M", "1Y", "2Y", "3Y", "5Y", "7Y"};
+        if (i < numPillars)
+            return std::string("ref_") + tenors[i];
+        if (i < 2 * numPillars)
+            return std::string("cpty_") + tenors[i - numPillars];
+        return "rate";
+    }
+
+    /// months from today of exposure date k, on the quarterly CDS grid;
+    /// exposure date numSteps is the maturity of the trade
+    Integer elapsedMonths(Size k, Size numSteps) {
+        return Integer(tradeMonths * k / numSteps) / 3 * 3;
+    }
+
+    class CvaModel {
+      public:
+        explicit CvaModel(const Options& options) : options_(options), today_(21, October, 2014) {
+            Settings::instance().evaluationDate() = today_;
+        }
+
+        const Options& options() const { return options_; }
+
+        /// numPaths x numFactors scenarios of exposure date k, row-major
+        std::vector<double> scenarios(Size k) const {
+            std::mt19937 rng(options_.seed + unsigned(k));
+            std::normal_distribution<double> normal;
+            // the scenario date is the middle of the exposure interval
+            const double t =
+                (elapsedMonths(k, options_.numSteps) + elapsedMonths(k + 1, options_.numSteps)) / 24.0;
+            const double sqrtT = std::sqrt(t);
+            const double rho = creditCorrelation, rhoBar = std::sqrt(1.0 - rho * rho);
+            const double drift = -0.5 * hazardVolatility * hazardVolatility * t;
+            std::vector<double> rows(options_.numPaths * numFactors);
+            for (Size p = 0; p < options_.numPaths; ++p) {
+                double* row = &rows[p * numFactors];
+                const double common = normal(rng);
+                for (Size i = 0; i < numPillars; ++i) {
+                    const double zr = rho * common + rhoBar * normal(rng);
+                    const double zc = rho * common + rhoBar * normal(rng);
+                    row[i] = referenceHazards[i] *
+                             std::exp(hazardVolatility * sqrtT * zr + drift);
+                    row[numPillars + i] = counterpartyHazards[i] *
+                                          std::exp(hazardVolatility * sqrtT * zc + drift);
+                }
+                row[2 * numPillars] = baseRate + rateVolatility * sqrtT * normal(rng);
+            }
+            return rows;
+        }
+
+        /// CVA contribution of exposure date k for the given risk factors
+        Real cvaContribution(Size k, const std::vector<Real>& inputs) const {
+            const DayCounter dayCounter = Actual365Fixed();
+            std::vector<Date> dates = {today_};
+            std::vector<Real> reference = {inputs[0]}, counterparty = {inputs[numPillars]};
+            for (Size i = 0; i < numPillars; ++i) {
+                dates.push_back(today_ + hazardTenors[i]);
+                reference.push_back(inputs[i]);
+                counterparty.push_back(inputs[numPillars + i]);
+            }
+            auto referenceCurve =
+                ext::make_shared<InterpolatedHazardRateCurve<BackwardFlat>>(dates, reference, dayCounter);
+            auto counterpartyCurve =
+                ext::make_shared<InterpolatedHazardRateCurve<BackwardFlat>>(dates, counterparty, dayCounter);
+            referenceCurve->enableExtrapolation();
+            counterpartyCurve->enableExtrapolation();
+            Handle<DefaultProbabilityTermStructure> probability(referenceCurve);
+            Handle<YieldTermStructure> discount(ext::make_shared<FlatForward>(
+                today_, Handle<Quote>(ext::make_shared<SimpleQuote>(inputs[2 * numPillars])),
+                dayCounter));
+
+            // the trade seen from exposure date k: its remaining protection
+            // priced on today's curves, as in the swap XVA benchmarks
+            const Integer start = elapsedMonths(k, options_.numSteps);
+            const Integer end = elapsedMonths(k + 1, options_.numSteps);
+            const Date maturity =
+                cdsMaturity(today_, Period(tradeMonths - start, Months), DateGeneration::CDS);
+            Schedule schedule(today_, maturity, Period(3, Months), WeekendsOnly(), Following,
+                              Unadjusted, DateGeneration::CDS, false, Date(), Date());
+            CreditDefaultSwap cds(Protection::Buyer, notional, spread, schedule, Following,
+                                  Actual360(), true, true, today_ + 1, ext::shared_ptr<Claim>(),
+                                  Actual360(true), true, today_);
+            if (options_.engine == "isda")
+                cds.setPricingEngine(ext::make_shared<IsdaCdsEngine>(probability, recovery, discount));
+            else
+                cds.setPricingEngine(ext::make_shared<MidPointCdsEngine>(probability, recovery, discount));
+
+            const Date d0 = today_ + Period(start, Months), d1 = today_ + Period(end, Months);
+            Real defaultProbability = counterpartyCurve->survivalProbability(d0) -
+                                      counterpartyCurve->survivalProbability(d1);
+            // recorded selection: the kernel stays valid when the NPV changes sign
+            Real exposure = forge::expr::positive_part(cds.NPV());
+            return (1.0 - counterpartyRecovery) * exposure * discount->discount(d1) *
+                   defaultProbability;
+        }
+
+      private:
+        Options options_;
+        Date today_;
+    };
+
+    struct MethodResult {
+        std::string name;
+        double recordMs = 0.0, compileMs = 0.0, evaluateMs = 0.0, totalMs = 0.0;
+        double cva = 0.0;
+        std::vector<double> contributions; // [k * numPaths + p]
+        std::vector<double> sensitivities; // dCVA / dfactor, empty if not computed
+    };
+
+    double milliseconds(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+            .count();
+    }
+
+    MethodResult runQuantLib(const CvaModel& model, const std::vector<std::vector<double>>& scenarios) {
+        const Size numSteps = model.options().numSteps, numPaths = model.options().numPaths;
+        MethodResult result;
+        result.name = "quantlib";
+        result.contributions.resize(numSteps * numPaths);
+        std::vector<Real> inputs(numFactors);
+        auto start = std::chrono::steady_clock::now();
+        for (Size k = 0; k < numSteps; ++k) {
+            for (Size p = 0; p < numPaths; ++p) {
+                for (Size i = 0; i < numFactors; ++i)
+                    inputs[i] = scenarios[k][p * numFactors + i];
+                result.contributions[k * numPaths + p] = value(model.cvaContribution(k, inputs));
+            }
+        }
+        result.evaluateMs = milliseconds(start);
+        return result;
+    }
+
+    enum class ForgeMode { Forward, Bumped, Adjoint };
+
+    MethodResult runForge(const CvaModel& model,
+                          const std::vector<std::vector<double>>& scenarios,
+                          ForgeMode mode) {
+        const Size numSteps = model.options().numSteps, numPaths = model.options().numPaths;
+        const bool adjoint = mode == ForgeMode::Adjoint;
+        MethodResult result;
+        result.name = mode == ForgeMode::Forward ? "forge-forward" :
+                      (mode == ForgeMode::Bumped ? "forge-bump" : "forge-aad");
+        result.contributions.resize(numSteps * numPaths);
+        if (mode != ForgeMode::Forward)
+            result.sensitivities.assign(numFactors, 0.0);
+
+        std::vector<double> gradients(adjoint ? numPaths * numFactors : 0), bumped(numPaths);
+        for (Size k = 0; k < numSteps; ++k) {
+            // one kernel per exposure date: the CDS schedule differs
+            auto start = std::chrono::steady_clock::now();
+            forge::GraphRecorder recorder;
+            recorder.start();
+            std::vector<Real> inputs(numFactors);
+            std::vector<forge::NodeId> ids(numFactors);
+            for (Size i = 0; i < numFactors; ++i) {
+                inputs[i] = scenarios[k][i];
+                if (adjoint)
+                    inputs[i].markForgeInputAndDiff();
+                else
+                    inputs[i].markForgeInput();
+                ids[i] = inputs[i].forgeNodeId();
+            }
+            Real contribution = model.cvaContribution(k, inputs);
+            contribution.markForgeOutput();
+            const std::vector<forge::NodeId> outputs = {contribution.forgeNodeId()};
+            recorder.stop();
+            result.recordMs += milliseconds(start);
+
+            start = std::chrono::steady_clock::now();
+            forge::ForgeEngine compiler;
+            auto kernel = compiler.compile(recorder.graph());
+            QL_REQUIRE(kernel != nullptr, "Forge kernel compilation failed");
+            auto buffer = forge::NodeValueBufferFactory::create(recorder.graph(), *kernel);
+            result.compileMs += milliseconds(start);
+
+            start = std::chrono::steady_clock::now();
+            const std::vector<forge::NodeId> none;
+            double* values = &result.contributions[k * numPaths];
+            forgeEvaluateBatched(*kernel, *buffer, ids, outputs, adjoint ? ids : none,
+                                 scenarios[k].data(), numPaths, numFactors, values,
+                                 adjoint ? gradients.data() : nullptr);
+            if (adjoint) {
+                for (Size p = 0; p < numPaths; ++p)
+                    for (Size i = 0; i < numFactors; ++i)
+                        result.sensitivities[i] += gradients[p * numFactors + i] / numPaths;
+            } else if (mode == ForgeMode::Bumped) {
+                std::vector<double> rows = scenarios[k];
+                for (Size i = 0; i < numFactors; ++i) {
+                    const double h = i < 2 * numPillars ? 1e-7 : 1e-6;
+                    for (Size p = 0; p < numPaths; ++p)
+                        rows[p * numFactors + i] += h;
+                    forgeEvaluateBatched(*kernel, *buffer, ids, outputs, none, rows.data(),
+                                         numPaths, numFactors, bumped.data());
+                    for (Size p = 0; p < numPaths; ++p) {
+                        rows[p * numFactors + i] = scenarios[k][p * numFactors + i];
+                        result.sensitivities[i] += (bumped[p] - values[p]) / h / numPaths;
+                    }
+                }
+            }
+            result.evaluateMs += milliseconds(start);
+        }
+        return result;
+    }
+
+    void finish(MethodResult& result, Size numPaths) {
+        result.cva = 0.0;
+        for (double c : result.contributions)
+            result.cva += c;
+        result.cva /= numPaths;
+        result.totalMs = result.recordMs + result.compileMs + result.evaluateMs;
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        Options options = parse(argc, argv);
+        CvaModel model(options);
+        std::vector<std::vector<double>> scenarios;
+        for (Size k = 0; k < options.numSteps; ++k)
+            scenarios.push_back(model.scenarios(k));
+
+        std::cout << "CDS CVA benchmark: " << options.engine << " engine, " << options.numSteps
+                  << " exposure dates x " << options.numPaths << " paths, " << numFactors
+                  << " risk factors, " << options.runs << " runs\n\n";
+
+        // all methods run options.runs times; the timings are averaged and
+        // the results of the last run are compared
+        std::vector<MethodResult> results(4);
+        for (Size r = 0; r < options.runs; ++r) {
+            MethodResult run[4] = {runQuantLib(model, scenarios),
+                                   runForge(model, scenarios, ForgeMode::Forward),
+                                   runForge(model, scenarios, ForgeMode::Bumped),
+                                   runForge(model, scenarios, ForgeMode::Adjoint)};
+            for (Size m = 0; m < 4; ++m) {
+                finish(run[m], options.numPaths);
+                if (r == 0) {
+                    results[m] = run[m];
+                } else {
+                    results[m].recordMs += run[m].recordMs;
+                    results[m].compileMs += run[m].compileMs;
+                    results[m].evaluateMs += run[m].evaluateMs;
+                    results[m].totalMs += run[m].totalMs;
+                    results[m].contributions = std::move(run[m].contributions);
+                    results[m].sensitivities = std::move(run[m].sensitivities);
+                    results[m].cva = run[m].cva;
+                }
+            }
+        }
+
+        std::cout << std::left << std::setw(16) << "method" << std::right << std::setw(12)
+                  << "record ms" << std::setw(12) << "compile ms" << std::setw(12) << "eval ms"
+                  << std::setw(12) << "total ms" << std::setw(16) << "CVA" << std::setw(14)
+                  << "max |diff|" << "\n";
+        bool verified = true;
+        const MethodResult& reference = results[0];
+        for (MethodResult& m : results) {
+            m.recordMs /= options.runs;
+            m.compileMs /= options.runs;
+            m.evaluateMs /= options.runs;
+            m.totalMs /= options.runs;
+            // scenario by scenario against QuantLib: a kernel that took
+            // another branch than its recording shows up here
+            double maxDiff = 0.0;
+            for (Size s = 0; s < m.contributions.size(); ++s)
+                maxDiff = std::max(maxDiff, std::abs(m.contributions[s] - reference.contributions[s]));
+            verified = verified && maxDiff <= 1e-10 * notional;
+            std::cout << std::left << std::setw(16) << m.name << std::right << std::fixed
+                      << std::setprecision(2) << std::setw(12) << m.recordMs << std::setw(12)
+                      << m.compileMs << std::setw(12) << m.evaluateMs << std::setw(12) << m.totalMs
+                      << std::setprecision(4) << std::setw(16) << m.cva << std::scientific
+                      << std::setprecision(2) << std::setw(14) << maxDiff << "\n";
+        }
+
+        const MethodResult &bumped = results[2], &adjoint = results[3];
+        double largest = 0.0;
+        for (double s : bumped.sensitivities)
+            largest = std::max(largest, std::abs(s));
+        std::cout << "\n" << std::left << std::setw(12) << "factor" << std::right << std::setw(18)
+                  << "forge-bump" << std::setw(18) << "forge-aad" << "\n";
+        for (Size i = 0; i < numFactors; ++i) {
+            std::cout << std::left << std::setw(12) << factorName(i) << std::right << std::fixed
+                      << std::setprecision(4) << std::setw(18) << bumped.sensitivities[i]
+                      << std::setw(18) << adjoint.sensitivities[i] << "\n";
+            verified = verified && std::abs(bumped.sensitivities[i] - adjoint.sensitivities[i]) <=
+                                       1e-3 * largest;
+        }
+
+        if (!verified) {
+            std::cerr << "\nForge results differ from QuantLib or between bumping and AAD\n";
+            return 1;
+        }
+        return 0;
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    } catch (...) {
+        std::cerr << "unknown error" << std::endl;
+        return 1;
+    }
+}
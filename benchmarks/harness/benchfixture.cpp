@@ -0,0 +1,247 @@
+/*******************************************************************************
+
+   Shared swap, curve and scenario fixtures of the ql_forge_bench harness.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   Derived from QuantLib-Risks-Cpp / XAD (https://github.com/auto-differentiation/XAD)
+   Original XAD code: Copyright (C) 2010-2024 Xcelerit Computing Ltd.
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "benchfixture.hpp"
+#include <ql/indexes/ibor/euribor.hpp>
+#include <ql/instruments/vanillaswap.hpp>
+#include <ql/pricingengines/swap/discountingswapengine.hpp>
+#include <ql/settings.hpp>
+#include <ql/termstructures/yield/zerocurve.hpp>
+#include <ql/time/calendars/target.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace QuantLib {
+
+    namespace {
+
+        std::vector<BenchPillar> eurCurvePillars() {
+            return {
+                {"EUR_6M",  Period(6, Months), 0.0320, 0.0060},
+                {"EUR_1Y",  Period(1, Years),  0.0335, 0.0055},
+                {"EUR_2Y",  Period(2, Years),  0.0348, 0.0050},
+                {"EUR_3Y",  Period(3, Years),  0.0358, 0.0048},
+                {"EUR_5Y",  Period(5, Years),  0.0375, 0.0045},
+                {"EUR_7Y",  Period(7, Years),  0.0388, 0.0043},
+                {"EUR_10Y", Period(10, Years), 0.0402, 0.0040},
+                {"EUR_15Y", Period(15, Years), 0.0415, 0.0038},
+                {"EUR_20Y", Period(20, Years), 0.0422, 0.0035},
+                {"EUR_30Y", Period(30, Years), 0.0428, 0.0032}
+            };
+        }
+
+        // base levels of the risk factors after the EUR curve
+        struct AdditionalRiskFactors {
+            std::vector<double> usdRates = {0.0480, 0.0495, 0.0505, 0.0512, 0.0525,
+                                            0.0535, 0.0545, 0.0555, 0.0560, 0.0565};
+            std::vector<double> gbpRates = {0.0420, 0.0435, 0.0448, 0.0458, 0.0470,
+                                            0.0480, 0.0490, 0.0500, 0.0505, 0.0510};
+            std::vector<double> jpyRates = {-0.001, 0.000, 0.002, 0.004, 0.008,
+                                            0.012,  0.018, 0.022, 0.025, 0.028};
+            std::vector<double> chfRates = {0.010, 0.012, 0.015, 0.018, 0.022,
+                                            0.026, 0.030, 0.034, 0.037, 0.040};
+            std::vector<double> fxRates = {1.08, 1.27, 149.5, 0.88, 0.85};
+            std::vector<double> counterpartySpreads = {0.0050, 0.0055, 0.0062, 0.0070, 0.0080,
+                                                       0.0092, 0.0105, 0.0120, 0.0135, 0.0150};
+            std::vector<double> ownSpreads = {0.0030, 0.0033, 0.0038, 0.0044, 0.0052,
+                                              0.0060, 0.0070, 0.0082, 0.0095, 0.0110};
+            std::vector<double> volSurface = {0.20, 0.19, 0.18, 0.19, 0.21,
+                                              0.19, 0.18, 0.17, 0.18, 0.20,
+                                              0.18, 0.17, 0.16, 0.17, 0.19,
+                                              0.17, 0.16, 0.15, 0.16, 0.18,
+                                              0.16, 0.15, 0.14, 0.15, 0.17};
+        };
+
+        ForgeScenarioCube generateScenarios(const BenchConfig& config,
+                                            const std::vector<BenchPillar>& eurPillars,
+                                            unsigned int seed) {
+            const AdditionalRiskFactors base;
+            std::mt19937 gen(seed);
+            std::normal_distribution<> dist(0.0, 1.0);
+
+            ForgeScenarioCube scenarios(config.numTimeSteps, config.numPaths, config.numRiskFactors,
+                                        BenchFixture::scenarioLaneWidth);
+
+            const double rateVol = 0.005, fxVol = 0.10, creditVol = 0.20, volVol = 0.30;
+            const Size n = config.numRiskFactors;
+
+            for (Size t = 0; t < config.numTimeSteps; ++t) {
+                double timeYears =
+                    config.numTimeSteps > 1 ? double(t + 1) / config.numTimeSteps * 5.0 : 0.0;
+                double sqrtTime = std::sqrt(std::max(timeYears, 0.01));
+
+                for (Size p = 0; p < config.numPaths; ++p) {
+                    Size idx = 0;
+                    auto curve = [&](const std::vector<double>& rates) {
+                        double parallel = dist(gen);
+                        for (Size i = 0; i < rates.size() && idx < n; ++i)
+                            scenarios(t, p, idx++) = rates[i] + rateVol * parallel * sqrtTime;
+                    };
+                    auto lognormal = [&](const std::vector<double>& levels, double vol) {
+                        double shock = dist(gen);
+                        for (Size i = 0; i < levels.size() && idx < n; ++i)
+                            scenarios(t, p, idx++) = levels[i] * std::exp(vol * shock * sqrtTime);
+                    };
+
+                    // EUR curve (0-9)
+                    double eurParallel = dist(gen);
+                    for (Size i = 0; i < std::min(Size(10), n); ++i)
+                        scenarios(t, p, idx++) =
+                            eurPillars[i].baseRate + eurPillars[i].volatility * eurParallel * sqrtTime;
+                    if (n <= 10)
+                        continue;
+
+                    // USD, GBP, JPY, CHF curves (10-49)
+                    curve(base.usdRates);
+                    curve(base.gbpRates);
+                    curve(base.jpyRates);
+                    curve(base.chfRates);
+
+                    // FX rates (50-54), one shock each
+                    for (Size i = 0; i < base.fxRates.size() && idx < n; ++i) {
+                        double fxShock = dist(gen);
+                        scenarios(t, p, idx++) =
+                            base.fxRates[i] *
+                            std::exp(fxVol * fxShock * sqrtTime - 0.5 * fxVol * fxVol * timeYears);
+                    }
+
+                    // counterparty and own credit spreads (55-74), vol surface (75-99)
+                    lognormal(base.counterpartySpreads, creditVol);
+                    lognormal(base.ownSpreads, creditVol);
+                    lognormal(base.volSurface, volVol);
+                }
+            }
+            scenarios.padTails();
+            return scenarios;
+        }
+
+        std::vector<BenchSwapDefinition> swapDefinitions(Size numSwaps) {
+            std::vector<BenchSwapDefinition> swaps;
+            swaps.push_back({5, Period(1, Years), Period(6, Months), 1000000.0, 0.03, 0.001});
+            if (numSwaps > 1)
+                swaps.push_back({10, Period(6, Months), Period(3, Months), 2000000.0, 0.035, 0.0015});
+            return swaps;
+        }
+
+    }
+
+    std::vector<BenchConfig> standardBenchConfigs() {
+        return {
+            {"Test 1: Simple (10 RF)",          1, 1, 1,    10,  2, 5, 1e-4},
+            {"Test 2: Full RF (100 RF)",        1, 1, 1,    100, 2, 5, 1e-4},
+            {"Test 3: Time Steps (3 steps)",    1, 3, 1,    100, 2, 5, 1e-4},
+            {"Test 4: MC 10 paths",             1, 3, 10,   100, 2, 5, 1e-4},
+            {"Test 5: MC 100 paths",            1, 3, 100,  100, 2, 5, 1e-4},
+            {"Test 6: Full Scale (1000 paths)", 1, 3, 1000, 100, 2, 5, 1e-4}
+        };
+    }
+
+    BenchFixture::BenchFixture(const BenchConfig& config, unsigned int seed)
+    : config_(config), pillars_(eurCurvePillars()), swaps_(swapDefinitions(config.numSwaps)),
+      today_(15, January, 2024), calendar_(TARGET()), dayCounter_(Actual365Fixed()) {
+        QL_REQUIRE(config_.numRiskFactors == 10 || config_.numRiskFactors == 100,
+                   "the swap fixture has 10 or 100 risk factors, not " << config_.numRiskFactors);
+        QL_REQUIRE(config_.numSwaps >= 1 && config_.numSwaps <= swaps_.size(),
+                   "the swap fixture has 1 or 2 swaps, not " << config_.numSwaps);
+        QL_REQUIRE(config_.numTimeSteps > 0 && config_.numPaths > 0 && config_.timedRuns > 0,
+                   "empty benchmark configuration " << config_.name);
+        scenarios_ = generateScenarios(config_, pillars_, seed);
+        Settings::instance().evaluationDate() = today_;
+    }
+
+    Size BenchFixture::numScenarios() const {
+        return config_.numSwaps * config_.numTimeSteps * config_.numPaths;
+    }
+
+    Size BenchFixture::scenarioIndex(Size swap, Size timeStep, Size path) const {
+        return (swap * config_.numTimeSteps + timeStep) * config_.numPaths + path;
+    }
+
+    Real BenchFixture::price(Size swap, Size timeStep, const std::vector<Real>& inputs) const {
+        const BenchSwapDefinition& swapDef = swaps_[swap];
+        const Size totalTimeSteps = config_.numTimeSteps;
+
+        double timeStepFraction = totalTimeSteps > 1 ? double(timeStep) / totalTimeSteps : 0.0;
+        Integer elapsedYears = Integer(timeStepFraction * swapDef.tenorYears);
+        Integer remainingYears = swapDef.tenorYears - elapsedYears;
+        if (remainingYears <= 0)
+            return Real(0.0);
+
+        std::vector<Date> curveDates;
+        std::vector<Real> curveRates;
+        curveDates.push_back(today_);
+        curveRates.push_back(inputs[0]);
+        for (Size i = 0; i < 10 && i < pillars_.size(); ++i) {
+            curveDates.push_back(calendar_.advance(today_, pillars_[i].tenor));
+            curveRates.push_back(inputs[i]);
+        }
+
+        RelinkableHandle<YieldTermStructure> termStructure;
+        auto zeroCurve = ext::make_shared<ZeroCurve>(curveDates, curveRates, dayCounter_);
+        zeroCurve->enableExtrapolation();
+        termStructure.linkTo(zeroCurve);
+
+        auto index = ext::make_shared<Euribor6M>(termStructure);
+        Date start = calendar_.advance(today_, index->fixingDays(), Days);
+        Date maturity = calendar_.advance(start, remainingYears, Years);
+
+        Schedule fixedSchedule(start, maturity, swapDef.fixedFreq, calendar_, ModifiedFollowing,
+                               ModifiedFollowing, DateGeneration::Forward, false);
+        Schedule floatSchedule(start, maturity, swapDef.floatFreq, calendar_, ModifiedFollowing,
+                               ModifiedFollowing, DateGeneration::Forward, false);
+
+        auto swapInstrument = ext::make_shared<VanillaSwap>(
+            VanillaSwap::Payer, swapDef.notional, fixedSchedule, swapDef.fixedRate, dayCounter_,
+            floatSchedule, index, swapDef.spread, dayCounter_);
+        swapInstrument->setPricingEngine(ext::make_shared<DiscountingSwapEngine>(termStructure));
+        Real baseNpv = swapInstrument->NPV();
+
+        if (config_.numRiskFactors <= 10)
+            return baseNpv;
+
+        // XVA adjustments driven by the remaining 90 risk factors
+        const double notional = swapDef.notional;
+        Real ccyBasisAdj = Real(0.0);
+        const Real& eurusd = inputs[50];
+        const Real& eurgbp = inputs[54];
+        for (Size i = 0; i < 10; ++i) {
+            ccyBasisAdj += (inputs[10 + i] - inputs[i]) * eurusd * Real(0.0001) * notional;
+            ccyBasisAdj += (inputs[20 + i] - inputs[i]) * eurgbp * Real(0.00005) * notional;
+            ccyBasisAdj += inputs[30 + i] * Real(0.00001) * notional;
+            ccyBasisAdj += inputs[40 + i] * Real(0.00002) * notional;
+        }
+
+        Real lgd = Real(0.4);
+        // recorded selections: the kernel stays valid when the NPV changes sign
+        Real exposure = forge::expr::positive_part(baseNpv);
+        Real negExposure = forge::expr::negative_part(baseNpv);
+
+        Real cvaAdj = Real(0.0);
+        Real dvaAdj = Real(0.0);
+        for (Size i = 0; i < 10; ++i) {
+            cvaAdj -= lgd * exposure * inputs[55 + i] * Real(0.1);
+            dvaAdj += lgd * negExposure * inputs[65 + i] * Real(0.1);
+        }
+
+        Real volAdj = Real(0.0);
+        for (Size i = 0; i < 25; ++i)
+            volAdj += inputs[75 + i] * Real(0.001) * notional;
+
+        return baseNpv + ccyBasisAdj + cvaAdj + dvaAdj + volAdj;
+    }
+
+}
@@ -0,0 +1,102 @@
+/*******************************************************************************
+
+   Shared swap, curve and scenario fixtures of the ql_forge_bench harness.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    The XVA swap benchmark prices one or two vanilla swaps on a zero curve
+    with up to 100 risk factors (EUR, USD, GBP, JPY and CHF pillars, FX rates,
+    credit spreads and a vol surface) over time steps x Monte Carlo paths.
+    BenchFixture builds everything once per configuration: the swap
+    definitions, the curve pillars, and the scenario cube, lane-interleaved
+    for the widest (AVX2) kernel so that packed methods load batches
+    directly and scalar methods read single paths through strided views.
+
+    Every method prices the same fixture, so their exposures and
+    sensitivities can be compared with each other.
+*/
+
+#pragma once
+
+#include <ql/forge/scenariocube.hpp>
+#include <ql/time/calendar.hpp>
+#include <ql/time/date.hpp>
+#include <ql/time/daycounter.hpp>
+#include <ql/time/period.hpp>
+#include <string>
+#include <vector>
+
+namespace QuantLib {
+
+    /// size and repetitions of one benchmark case
+    struct BenchConfig {
+        std::string name;
+        Size numSwaps = 1;
+        Size numTimeSteps = 1;
+        Size numPaths = 1;
+        Size numRiskFactors = 10;
+        Size warmupRuns = 2;
+        Size timedRuns = 5;
+        double bumpSize = 1e-4;
+    };
+
+    /// the six cases of the original XVA swap benchmarks
+    std::vector<BenchConfig> standardBenchConfigs();
+
+    /// one curve pillar with its base rate and scenario volatility
+    struct BenchPillar {
+        std::string name;
+        Period tenor;
+        double baseRate;
+        double volatility;
+    };
+
+    struct BenchSwapDefinition {
+        Integer tenorYears;
+        Period fixedFreq;
+        Period floatFreq;
+        double notional;
+        double fixedRate;
+        double spread;
+    };
+
+    /// swaps, curve and scenarios of one configuration
+    class BenchFixture {
+      public:
+        /// lane width of the scenario cube, that of the widest supported kernel
+        static constexpr Size scenarioLaneWidth = 4;
+
+        explicit BenchFixture(const BenchConfig& config, unsigned int seed = 42);
+
+        const BenchConfig& config() const { return config_; }
+        const std::vector<BenchPillar>& pillars() const { return pillars_; }
+        const std::vector<BenchSwapDefinition>& swaps() const { return swaps_; }
+        const ForgeScenarioCube& scenarios() const { return scenarios_; }
+        /// swaps x time steps x paths
+        Size numScenarios() const;
+        /// row of scenario (swap, time step, path) in result storage
+        Size scenarioIndex(Size swap, Size timeStep, Size path) const;
+
+        /// NPV of a swap at a time step for the given risk factors
+        /// With more than 10 risk factors, currency-basis, CVA/DVA and vol
+        /// adjustments driven by the other factors are added to the swap NPV.
+        Real price(Size swap, Size timeStep, const std::vector<Real>& inputs) const;
+
+      private:
+        BenchConfig config_;
+        std::vector<BenchPillar> pillars_;
+        std::vector<BenchSwapDefinition> swaps_;
+        ForgeScenarioCube scenarios_;
+        Date today_;
+        Calendar calendar_;
+        DayCounter dayCounter_;
+    };
+
+}
@@ -0,0 +1,207 @@
+/*******************************************************************************
+
+   Method registry, phase timers and runner of the ql_forge_bench harness.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "benchharness.hpp"
+#include <ql/errors.hpp>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace QuantLib {
+
+    const char* benchPhaseName(BenchPhase phase) {
+        switch (phase) {
+            case BenchPhase::Record:
+                return "record";
+            case BenchPhase::Compile:
+                return "compile";
+            case BenchPhase::BufferAlloc:
+                return "buffer_alloc";
+            case BenchPhase::SetInputs:
+                return "set_inputs";
+            case BenchPhase::Execute:
+                return "execute";
+            case BenchPhase::Outputs:
+                return "outputs";
+            case BenchPhase::Gradients:
+                return "gradients";
+            default:
+                QL_FAIL("unknown benchmark phase");
+        }
+    }
+
+    bool benchAvx2Supported() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#ifdef _MSC_VER
+        int cpuInfo[4];
+        __cpuid(cpuInfo, 0);
+        if (cpuInfo[0] < 7)
+            return false;
+        __cpuidex(cpuInfo, 7, 0);
+        return (cpuInfo[1] & (1 << 5)) != 0;
+#else
+        unsigned int eax, ebx, ecx, edx;
+        if (__get_cpuid_max(0, nullptr) < 7)
+            return false;
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        return (ebx & (1 << 5)) != 0;
+#endif
+#else
+        return false;
+#endif
+    }
+
+    BenchLatencyStats BenchLatencyStats::fromSamples(std::vector<std::uint64_t> samples) {
+        BenchLatencyStats stats;
+        stats.count = samples.size();
+        if (samples.empty())
+            return stats;
+        std::sort(samples.begin(), samples.end());
+        const double us = 1e-3 / forgeTscTicksPerNanosecond();
+        auto rank = [&](double q) {
+            Size k = Size(std::ceil(q * samples.size()));
+            return samples[std::max<Size>(k, 1) - 1] * us;
+        };
+        double sum = 0.0;
+        for (std::uint64_t s : samples)
+            sum += double(s);
+        stats.mean = sum / samples.size() * us;
+        stats.min = samples.front() * us;
+        stats.p50 = rank(0.50);
+        stats.p90 = rank(0.90);
+        stats.p99 = rank(0.99);
+        stats.max = samples.back() * us;
+        return stats;
+    }
+
+    BenchRun::BenchRun(const BenchFixture& fixture)
+    : fixture_(fixture), numRiskFactors_(fixture.config().numRiskFactors),
+      exposures_(fixture.numScenarios(), 0.0),
+      sensitivities_(fixture.numScenarios() * numRiskFactors_, 0.0) {}
+
+    double BenchRun::expectedExposure() const {
+        double sum = 0.0;
+        for (double e : exposures_)
+            sum += e;
+        return exposures_.empty() ? 0.0 : sum / exposures_.size();
+    }
+
+    BenchRegistry& BenchRegistry::instance() {
+        static BenchRegistry registry;
+        return registry;
+    }
+
+    void BenchRegistry::add(std::unique_ptr<BenchMethod> method) {
+        QL_REQUIRE(method != nullptr, "null benchmark method");
+        QL_REQUIRE(find(method->name()) == nullptr,
+                   "benchmark method " << method->name() << " registered twice");
+        methods_.push_back(std::move(method));
+    }
+
+    const BenchMethod* BenchRegistry::find(const std::string& name) const {
+        for (const auto& m : methods_)
+            if (m->name() == name)
+                return m.get();
+        return nullptr;
+    }
+
+    namespace {
+
+        double maxRelativeError(const BenchRun& run, const BenchResult& reference) {
+            const Size n = run.numRiskFactors();
+            const std::vector<double>& s = run.sensitivities();
+            const std::vector<double>& r = reference.sensitivities;
+            QL_REQUIRE(r.size() == s.size(), "reference result of another configuration");
+            double worst = 0.0;
+            for (Size row = 0; row < s.size(); row += n) {
+                double scale = 0.0, error = 0.0;
+                for (Size i = row; i < row + n; ++i) {
+                    scale = std::max(scale, std::fabs(r[i]));
+                    error = std::max(error, std::fabs(s[i] - r[i]));
+                }
+                if (scale > 0.0)
+                    worst = std::max(worst, error / scale);
+                else if (error > 0.0)
+                    worst = std::max(worst, error);
+            }
+            return worst;
+        }
+
+    }
+
+    BenchResult runBenchmark(const BenchMethod& method,
+                             const BenchFixture& fixture,
+                             const BenchResult* reference) {
+        const BenchConfig& config = fixture.config();
+        for (Size i = 0; i < config.warmupRuns; ++i) {
+            BenchRun warmup(fixture);
+            method.run(fixture, warmup);
+        }
+
+        BenchResult result;
+        result.method = method.name();
+        result.config = config;
+        result.runs = config.timedRuns;
+
+        std::vector<std::uint64_t> kernelSamples, evaluationSamples;
+        std::int64_t totalNs = 0;
+        double phaseNs[benchNumPhases] = {};
+        std::unique_ptr<BenchRun> last;
+        for (Size i = 0; i < config.timedRuns; ++i) {
+            auto run = std::make_unique<BenchRun>(fixture);
+            std::int64_t start = benchNanoseconds();
+            method.run(fixture, *run);
+            totalNs += benchNanoseconds() - start;
+
+            for (Size p = 0; p < benchNumPhases; ++p)
+                phaseNs[p] += run->phaseNs(BenchPhase(p));
+            const auto& k = run->samples(BenchLatency::Kernel);
+            const auto& e = run->samples(BenchLatency::Evaluation);
+            kernelSamples.insert(kernelSamples.end(), k.begin(), k.end());
+            evaluationSamples.insert(evaluationSamples.end(), e.begin(), e.end());
+            last = std::move(run);
+        }
+
+        const double runs = double(config.timedRuns);
+        for (Size p = 0; p < benchNumPhases; ++p)
+            result.phaseMs[p] = phaseNs[p] * 1e-6 / runs;
+        result.totalMs = totalNs * 1e-6 / runs;
+        result.kernelLatency = BenchLatencyStats::fromSamples(std::move(kernelSamples));
+        result.evaluationLatency = BenchLatencyStats::fromSamples(std::move(evaluationSamples));
+
+        result.kernels = last->kernels();
+        result.evaluations = last->evaluations();
+        result.scenarios = last->scenarios();
+        QL_REQUIRE(result.scenarios == fixture.numScenarios(),
+                   method.name() << " evaluated " << result.scenarios << " of "
+                                 << fixture.numScenarios() << " scenarios");
+        result.throughput = result.totalMs > 0.0 ? result.scenarios / (result.totalMs * 1e-3) : 0.0;
+        result.expectedExposure = last->expectedExposure();
+        result.cva = result.expectedExposure * 0.4 * 0.02;
+
+        if (reference != nullptr) {
+            result.maxRelativeError = maxRelativeError(*last, *reference);
+            result.verified = result.maxRelativeError <= benchVerificationTolerance;
+        }
+        result.exposures = last->exposures();
+        result.sensitivities = last->sensitivities();
+        return result;
+    }
+
+}
@@ -0,0 +1,225 @@
+/*******************************************************************************
+
+   Method registry, phase timers and runner of the ql_forge_bench harness.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Each way of computing exposures and sensitivities (bump-reval on
+    QuantLib, Forge forward kernels, Forge AAD kernels, ...) is a
+    BenchMethod registered by a static BenchRegistration in its own
+    translation unit:
+
+        class MyMethod : public BenchMethod { ... };
+        const BenchRegistration<MyMethod> registration("my-method", ...);
+
+    A method runs once per repetition on a shared BenchFixture and reports
+    into a BenchRun: phase timers (timestamp-counter reads, see
+    ql/forge/instrumentation.hpp) wrap recording, compilation, buffer
+    allocation, input loading, execution and output/gradient reads,
+
+        {
+            BenchRun::Scope timer(run, BenchPhase::Execute);
+            evaluator.execute();
+        }
+
+    and latency samples wrap the creation of one kernel and one evaluation
+    unit (a scenario with its bumps, or a batch of lanes).  runBenchmark()
+    repeats a method on a fixture and reduces the runs to a BenchResult
+    with mean phase times, latency percentiles and throughput.
+*/
+
+#pragma once
+
+#include "benchfixture.hpp"
+#include <ql/forge/instrumentation.hpp>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace QuantLib {
+
+    /// the phases every method reports separately
+    enum class BenchPhase { Record, Compile, BufferAlloc, SetInputs, Execute, Outputs, Gradients };
+
+    constexpr Size benchNumPhases = 7;
+
+    /// lower-case phase name as used in JSON and CSV column names
+    const char* benchPhaseName(BenchPhase phase);
+
+    /// latency samples a method reports
+    enum class BenchLatency { Kernel, Evaluation };
+
+    /// monotonic nanosecond clock, for whole runs
+    inline std::int64_t benchNanoseconds() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    /// true if the CPU supports AVX2
+    bool benchAvx2Supported();
+
+    /// summary of latency samples, in microseconds
+    struct BenchLatencyStats {
+        Size count = 0;
+        double mean = 0.0, min = 0.0, p50 = 0.0, p90 = 0.0, p99 = 0.0, max = 0.0;
+
+        /// nearest-rank percentiles of the samples (given in timestamp-counter ticks)
+        static BenchLatencyStats fromSamples(std::vector<std::uint64_t> samples);
+    };
+
+    /// timings and results of one repetition of a method
+    class BenchRun {
+      public:
+        explicit BenchRun(const BenchFixture& fixture);
+
+        /// adds the lifetime of the scope to a phase
+        class Scope {
+          public:
+            Scope(BenchRun& run, BenchPhase phase)
+            : run_(run), phase_(phase), start_(forgeReadTsc()) {}
+            ~Scope() { run_.phaseTicks_[Size(phase_)] += forgeReadTsc() - start_; }
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+          private:
+            BenchRun& run_;
+            BenchPhase phase_;
+            std::uint64_t start_;
+        };
+
+        /// records the lifetime of the scope as one latency sample
+        class Sample {
+          public:
+            Sample(BenchRun& run, BenchLatency latency)
+            : run_(run), latency_(latency), start_(forgeReadTsc()) {}
+            ~Sample() { run_.samples_[Size(latency_)].push_back(forgeReadTsc() - start_); }
+            Sample(const Sample&) = delete;
+            Sample& operator=(const Sample&) = delete;
+
+          private:
+            BenchRun& run_;
+            BenchLatency latency_;
+            std::uint64_t start_;
+        };
+
+        void countKernel() { ++kernels_; }
+        void countEvaluations(Size n = 1) { evaluations_ += n; }
+        void countScenarios(Size n = 1) { scenarios_ += n; }
+
+        /// positive part of the NPV of a scenario
+        double& exposure(Size swap, Size timeStep, Size path) {
+            return exposures_[fixture_.scenarioIndex(swap, timeStep, path)];
+        }
+        /// numRiskFactors sensitivities of a scenario
+        double* sensitivities(Size swap, Size timeStep, Size path) {
+            return sensitivities_.data() +
+                   fixture_.scenarioIndex(swap, timeStep, path) * numRiskFactors_;
+        }
+
+        const BenchFixture& fixture() const { return fixture_; }
+        double phaseNs(BenchPhase phase) const {
+            return forgeTicksToNanoseconds(double(phaseTicks_[Size(phase)]));
+        }
+        /// latency samples in timestamp-counter ticks
+        const std::vector<std::uint64_t>& samples(BenchLatency latency) const {
+            return samples_[Size(latency)];
+        }
+        Size kernels() const { return kernels_; }
+        Size evaluations() const { return evaluations_; }
+        Size scenarios() const { return scenarios_; }
+        const std::vector<double>& exposures() const { return exposures_; }
+        const std::vector<double>& sensitivities() const { return sensitivities_; }
+        Size numRiskFactors() const { return numRiskFactors_; }
+
+        /// mean exposure over all scenarios
+        double expectedExposure() const;
+
+      private:
+        const BenchFixture& fixture_;
+        Size numRiskFactors_;
+        std::uint64_t phaseTicks_[benchNumPhases] = {};
+        std::vector<std::uint64_t> samples_[2];
+        Size kernels_ = 0, evaluations_ = 0, scenarios_ = 0;
+        std::vector<double> exposures_, sensitivities_;
+    };
+
+    /// one way of computing exposures and sensitivities
+    class BenchMethod {
+      public:
+        virtual ~BenchMethod() = default;
+        virtual std::string name() const = 0;
+        virtual std::string description() const = 0;
+        /// false if the method cannot run on this machine (e.g. no AVX2)
+        virtual bool available() const { return true; }
+        /// fills exposures and sensitivities of every scenario of the fixture
+        virtual void run(const BenchFixture& fixture, BenchRun& run) const = 0;
+    };
+
+    /// all methods linked into the executable, in registration order
+    class BenchRegistry {
+      public:
+        static BenchRegistry& instance();
+
+        void add(std::unique_ptr<BenchMethod> method);
+        const std::vector<std::unique_ptr<BenchMethod>>& methods() const { return methods_; }
+        /// null if no method has the given name
+        const BenchMethod* find(const std::string& name) const;
+
+      private:
+        BenchRegistry() = default;
+        std::vector<std::unique_ptr<BenchMethod>> methods_;
+    };
+
+    /// registers a method when the static instance is constructed
+    template <class Method>
+    struct BenchRegistration {
+        template <class... Args>
+        explicit BenchRegistration(Args&&... args) {
+            BenchRegistry::instance().add(
+                std::unique_ptr<BenchMethod>(new Method(std::forward<Args>(args)...)));
+        }
+    };
+
+    /// reduced timings of the timed runs of a method on one configuration
+    struct BenchResult {
+        std::string method;
+        BenchConfig config;
+        Size runs = 0;
+        /// mean time per run of each phase, and of the whole run, in milliseconds
+        double phaseMs[benchNumPhases] = {};
+        double totalMs = 0.0;
+        BenchLatencyStats kernelLatency, evaluationLatency;
+        /// scenarios per second of the whole run
+        double throughput = 0.0;
+        Size kernels = 0, evaluations = 0, scenarios = 0;
+        double expectedExposure = 0.0, cva = 0.0;
+        /// largest sensitivity error against the reference method, relative to
+        /// the largest reference sensitivity of the same scenario
+        double maxRelativeError = 0.0;
+        bool verified = true;
+        /// exposures and sensitivities of the last run
+        std::vector<double> exposures, sensitivities;
+    };
+
+    /// relative tolerance of the comparison against the reference method
+    constexpr double benchVerificationTolerance = 1e-2;
+
+    /// runs warm-ups and timed repetitions of a method on a fixture
+    /// With a reference, the sensitivities of the last run are checked
+    /// against those of the reference result.
+    BenchResult runBenchmark(const BenchMethod& method,
+                             const BenchFixture& fixture,
+                             const BenchResult* reference = nullptr);
+
+}
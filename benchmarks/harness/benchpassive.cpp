@@ -0,0 +1,224 @@
+/*******************************************************************************
+
+   Passive pricing on Real against double, for the ql_forge_bench harness.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "benchpassive.hpp"
+#include "benchharness.hpp"
+#include <ql/errors.hpp>
+#include <graph/graph_recorder.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace QuantLib {
+
+    namespace {
+
+        double periodYears(const Period& p) {
+            QL_REQUIRE(p.units() == Months || p.units() == Years,
+                       "passive pricing takes monthly or yearly periods, not " << p);
+            return p.units() == Years ? double(p.length()) : p.length() / 12.0;
+        }
+
+        struct PassiveLeg {
+            std::vector<double> times, accruals;
+        };
+
+        /// cash flows of a swap at one time step, in years from today
+        struct PassiveSwap {
+            double notional = 0.0, fixedRate = 0.0, spread = 0.0;
+            PassiveLeg fixedLeg, floatingLeg;
+        };
+
+        PassiveLeg passiveLeg(double years, const Period& frequency) {
+            PassiveLeg leg;
+            const double accrual = periodYears(frequency);
+            const Size n = Size(std::lround(years / accrual));
+            for (Size k = 1; k <= n; ++k) {
+                leg.times.push_back(k * accrual);
+                leg.accruals.push_back(accrual);
+            }
+            return leg;
+        }
+
+        // same remaining tenor as BenchFixture::price()
+        PassiveSwap passiveSwap(const BenchSwapDefinition& swap, Size timeStep, Size numTimeSteps) {
+            PassiveSwap result;
+            result.notional = swap.notional;
+            result.fixedRate = swap.fixedRate;
+            result.spread = swap.spread;
+            double timeStepFraction = numTimeSteps > 1 ? double(timeStep) / numTimeSteps : 0.0;
+            Integer elapsedYears = Integer(timeStepFraction * swap.tenorYears);
+            Integer remainingYears = swap.tenorYears - elapsedYears;
+            if (remainingYears > 0) {
+                result.fixedLeg = passiveLeg(remainingYears, swap.fixedFreq);
+                result.floatingLeg = passiveLeg(remainingYears, swap.floatFreq);
+            }
+            return result;
+        }
+
+        /// zero rate at t, linear between the pillars and flat outside
+        /// As in BenchFixture::price(), the rate at time 0 is the first input.
+        template <class T>
+        T zeroRate(const std::vector<double>& pillarTimes, const T* inputs, double t) {
+            const auto rate = [&](Size i) -> const T& { return inputs[i == 0 ? 0 : i - 1]; };
+            if (t >= pillarTimes.back())
+                return rate(pillarTimes.size() - 1);
+            const Size i = std::upper_bound(pillarTimes.begin(), pillarTimes.end(), t) -
+                           pillarTimes.begin();
+            const double w = (t - pillarTimes[i - 1]) / (pillarTimes[i] - pillarTimes[i - 1]);
+            return rate(i - 1) + (rate(i) - rate(i - 1)) * w;
+        }
+
+        template <class T>
+        T discount(const std::vector<double>& pillarTimes, const T* inputs, double t) {
+            using std::exp;
+            return exp(-zeroRate(pillarTimes, inputs, t) * t);
+        }
+
+        template <class T>
+        T passiveNpv(const PassiveSwap& swap,
+                     const std::vector<double>& pillarTimes,
+                     const T* inputs,
+                     Size numRiskFactors) {
+            using std::max;
+            if (swap.fixedLeg.times.empty())
+                return T(0.0);
+
+            T fixedLeg = 0.0;
+            for (Size k = 0; k < swap.fixedLeg.times.size(); ++k)
+                fixedLeg += swap.fixedLeg.accruals[k] *
+                            discount(pillarTimes, inputs, swap.fixedLeg.times[k]);
+            T floatingLeg = 0.0, previous = 1.0;
+            for (Size k = 0; k < swap.floatingLeg.times.size(); ++k) {
+                T df = discount(pillarTimes, inputs, swap.floatingLeg.times[k]);
+                floatingLeg += previous - df + swap.spread * swap.floatingLeg.accruals[k] * df;
+                previous = df;
+            }
+            const double notional = swap.notional;
+            T npv = notional * (floatingLeg - swap.fixedRate * fixedLeg);
+            if (numRiskFactors <= 10)
+                return npv;
+
+            // the XVA adjustments of BenchFixture::price()
+            T ccyBasisAdj = 0.0;
+            const T& eurusd = inputs[50];
+            const T& eurgbp = inputs[54];
+            for (Size i = 0; i < 10; ++i) {
+                ccyBasisAdj += (inputs[10 + i] - inputs[i]) * eurusd * 0.0001 * notional;
+                ccyBasisAdj += (inputs[20 + i] - inputs[i]) * eurgbp * 0.00005 * notional;
+                ccyBasisAdj += inputs[30 + i] * 0.00001 * notional;
+                ccyBasisAdj += inputs[40 + i] * 0.00002 * notional;
+            }
+
+            const double lgd = 0.4;
+            T exposure = max(npv, 0.0);
+            T negExposure = max(-npv, 0.0);
+            T cvaAdj = 0.0, dvaAdj = 0.0;
+            for (Size i = 0; i < 10; ++i) {
+                cvaAdj -= lgd * exposure * inputs[55 + i] * 0.1;
+                dvaAdj += lgd * negExposure * inputs[65 + i] * 0.1;
+            }
+
+            T volAdj = 0.0;
+            for (Size i = 0; i < 25; ++i)
+                volAdj += inputs[75 + i] * 0.001 * notional;
+
+            return npv + ccyBasisAdj + cvaAdj + dvaAdj + volAdj;
+        }
+
+        /// bump-and-revalues every scenario on T, returning the elapsed nanoseconds
+        /// Base NPVs go to npvs and the sensitivities to sensitivities, so that
+        /// nothing of the pricing can be optimised away.
+        template <class T>
+        std::int64_t bumpAndRevalue(const BenchFixture& fixture,
+                                    const std::vector<PassiveSwap>& swaps,
+                                    const std::vector<double>& pillarTimes,
+                                    std::vector<double>& npvs,
+                                    std::vector<double>& sensitivities) {
+            const BenchConfig& config = fixture.config();
+            const Size n = config.numRiskFactors;
+            std::vector<T> inputs(n);
+
+            const std::int64_t start = benchNanoseconds();
+            for (Size s = 0; s < config.numSwaps; ++s) {
+                for (Size t = 0; t < config.numTimeSteps; ++t) {
+                    const PassiveSwap& swap = swaps[s * config.numTimeSteps + t];
+                    for (Size p = 0; p < config.numPaths; ++p) {
+                        auto scenario = fixture.scenarios().path(t, p);
+                        for (Size i = 0; i < n; ++i)
+                            inputs[i] = scenario[i];
+                        const Size row = fixture.scenarioIndex(s, t, p);
+                        const double baseNpv =
+                            forge::expr::value(passiveNpv(swap, pillarTimes, inputs.data(), n));
+                        npvs[row] = baseNpv;
+                        for (Size i = 0; i < n; ++i) {
+                            inputs[i] = scenario[i] + config.bumpSize;
+                            const double bumpedNpv = forge::expr::value(
+                                passiveNpv(swap, pillarTimes, inputs.data(), n));
+                            inputs[i] = scenario[i];
+                            sensitivities[row * n + i] = (bumpedNpv - baseNpv) / config.bumpSize;
+                        }
+                    }
+                }
+            }
+            return benchNanoseconds() - start;
+        }
+
+    }
+
+    BenchPassiveResult runPassiveBenchmark(const BenchFixture& fixture) {
+        QL_REQUIRE(!forge::GraphRecorder::isAnyRecording(),
+                   "the passive benchmark cannot run during a Forge recording");
+        const BenchConfig& config = fixture.config();
+
+        std::vector<double> pillarTimes(1, 0.0);
+        for (Size i = 0; i < 10 && i < fixture.pillars().size(); ++i)
+            pillarTimes.push_back(periodYears(fixture.pillars()[i].tenor));
+        std::vector<PassiveSwap> swaps;
+        for (Size s = 0; s < config.numSwaps; ++s)
+            for (Size t = 0; t < config.numTimeSteps; ++t)
+                swaps.push_back(passiveSwap(fixture.swaps()[s], t, config.numTimeSteps));
+
+        const Size scenarios = fixture.numScenarios();
+        std::vector<double> doubleNpvs(scenarios), realNpvs(scenarios),
+            sensitivities(scenarios * config.numRiskFactors);
+        std::int64_t doubleTotal = 0, realTotal = 0;
+        for (Size run = 0; run < config.warmupRuns + config.timedRuns; ++run) {
+            // both types in every repetition, one after the other
+            const std::int64_t doubleNs =
+                bumpAndRevalue<double>(fixture, swaps, pillarTimes, doubleNpvs, sensitivities);
+            const std::int64_t realNs =
+                bumpAndRevalue<Real>(fixture, swaps, pillarTimes, realNpvs, sensitivities);
+            if (run >= config.warmupRuns) {
+                doubleTotal += doubleNs;
+                realTotal += realNs;
+            }
+        }
+
+        BenchPassiveResult result;
+        result.config = config;
+        result.runs = config.timedRuns;
+        result.evaluations = scenarios * (config.numRiskFactors + 1);
+        const double calls = double(result.runs) * double(result.evaluations);
+        result.doubleNs = double(doubleTotal) / calls;
+        result.realNs = double(realTotal) / calls;
+        result.slowdown = result.doubleNs > 0.0 ? result.realNs / result.doubleNs : 0.0;
+
+        double scale = 0.0, error = 0.0;
+        for (Size i = 0; i < scenarios; ++i) {
+            scale = std::max(scale, std::fabs(doubleNpvs[i]));
+            error = std::max(error, std::fabs(realNpvs[i] - doubleNpvs[i]));
+        }
+        result.maxRelativeError = scale > 0.0 ? error / scale : error;
+        return result;
+    }
+
+}
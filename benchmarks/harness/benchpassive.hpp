@@ -0,0 +1,59 @@
+/*******************************************************************************
+
+   Passive pricing on Real against double, for the ql_forge_bench harness.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Outside of a recording, Real should cost about what double does: with
+    FEXPR_FORGE_PASSIVE_FAST_PATH its expressions, copies and moves leave
+    the fdouble side as a plain copy of the scalar, and with FEXPR_NO_TAPE
+    no tape is looked up either.  The passive benchmark measures what is
+    left of the overhead: it bump-and-revalues every scenario of a fixture
+    with one pricing function instantiated on double and on Real, no
+    recording and no tape active, and reports the mean time per
+    evaluation of both.
+
+    The pricing function discounts the fixture's swaps on a linearly
+    interpolated zero curve, with simple year fractions, and adds the same
+    XVA adjustments as BenchFixture::price() for 100 risk factors.  It does
+    not go through QuantLib, which is only built on Real, so its NPVs are
+    close to but not those of the other methods.
+*/
+
+#pragma once
+
+#include "benchfixture.hpp"
+#include <vector>
+
+namespace QuantLib {
+
+    /// passive bump-and-revalue timings of one configuration
+    struct BenchPassiveResult {
+        BenchConfig config;
+        Size runs = 0;
+        /// pricing calls per run, on each type
+        Size evaluations = 0;
+        /// mean time per pricing call, in nanoseconds
+        double doubleNs = 0.0, realNs = 0.0;
+        /// realNs / doubleNs
+        double slowdown = 0.0;
+        /// largest difference between the Real and double NPVs, relative to
+        /// the largest double NPV
+        double maxRelativeError = 0.0;
+    };
+
+    /// largest relative difference of the Real and double NPVs, which are
+    /// computed by the same operations
+    constexpr double benchPassiveTolerance = 1e-12;
+
+    /// runs warm-ups and timed repetitions of the passive pricing on a fixture
+    BenchPassiveResult runPassiveBenchmark(const BenchFixture& fixture);
+
+}
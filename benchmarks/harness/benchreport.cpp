@@ -0,0 +1,283 @@
+/*******************************************************************************
+
+   Table, JSON and CSV reports of the ql_forge_bench harness.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "benchreport.hpp"
+#include <ql/version.hpp>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#ifndef QL_FORGE_BENCH_FORGE_VERSION
+#define QL_FORGE_BENCH_FORGE_VERSION "unknown"
+#endif
+
+namespace QuantLib {
+
+    namespace {
+
+        std::string cpuModel() {
+            std::ifstream cpuinfo("/proc/cpuinfo");
+            std::string line;
+            while (std::getline(cpuinfo, line)) {
+                if (line.compare(0, 10, "model name") == 0) {
+                    std::string::size_type colon = line.find(':');
+                    if (colon != std::string::npos)
+                        return line.substr(line.find_first_not_of(" \t", colon + 1));
+                }
+            }
+            return "unknown";
+        }
+
+        std::string jsonString(const std::string& s) {
+            std::ostringstream out;
+            out << '"';
+            for (char c : s) {
+                switch (c) {
+                    case '"':
+                        out << "\\\"";
+                        break;
+                    case '\\':
+                        out << "\\\\";
+                        break;
+                    case '\n':
+                        out << "\\n";
+                        break;
+                    case '\t':
+                        out << "\\t";
+                        break;
+                    default:
+                        if (static_cast<unsigned char>(c) < 0x20) {
+                            char buf[8];
+                            std::snprintf(buf, sizeof(buf), "\\u%04x", unsigned(c));
+                            out << buf;
+                        } else {
+                            out << c;
+                        }
+                }
+            }
+            out << '"';
+            return out.str();
+        }
+
+        std::string csvString(const std::string& s) {
+            if (s.find_first_of(",\"\n") == std::string::npos)
+                return s;
+            std::string quoted = "\"";
+            for (char c : s) {
+                if (c == '"')
+                    quoted += '"';
+                quoted += c;
+            }
+            return quoted + '"';
+        }
+
+        void writeJsonLatency(std::ostream& out, const char* name, const BenchLatencyStats& s) {
+            out << "      " << jsonString(name) << ": {\"count\": " << s.count
+                << ", \"mean\": " << s.mean << ", \"min\": " << s.min << ", \"p50\": " << s.p50
+                << ", \"p90\": " << s.p90 << ", \"p99\": " << s.p99 << ", \"max\": " << s.max
+                << "}";
+        }
+
+    }
+
+    BenchMetadata BenchMetadata::current(unsigned int seed) {
+        BenchMetadata metadata;
+        metadata.forgeVersion = QL_FORGE_BENCH_FORGE_VERSION;
+        metadata.quantlibVersion = QL_VERSION;
+        std::time_t now = std::time(nullptr);
+        char buf[32];
+        std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+        metadata.timestamp = buf;
+        metadata.cpu = cpuModel();
+        metadata.avx2 = benchAvx2Supported();
+        metadata.seed = seed;
+        return metadata;
+    }
+
+    void writeBenchTable(std::ostream& out,
+                         const BenchMetadata& metadata,
+                         const std::vector<BenchResult>& results) {
+        out << "Forge " << metadata.forgeVersion << ", QuantLib " << metadata.quantlibVersion
+            << ", " << metadata.cpu << (metadata.avx2 ? " (AVX2)" : "") << ", "
+            << metadata.timestamp << "\n"
+            << "phase and total times in ms per run, evaluation latencies in us\n";
+
+        std::string config;
+        for (const BenchResult& r : results) {
+            if (r.config.name != config) {
+                config = r.config.name;
+                out << "\n" << config << " (" << r.config.numSwaps << " swaps, "
+                    << r.config.numTimeSteps << " steps, " << r.config.numPaths << " paths, "
+                    << r.config.numRiskFactors << " risk factors)\n";
+                out << std::left << std::setw(30) << "method" << std::right;
+                for (Size p = 0; p < benchNumPhases; ++p)
+                    out << std::setw(13) << benchPhaseName(BenchPhase(p));
+                out << std::setw(11) << "total ms" << std::setw(11) << "eval p50"
+                    << std::setw(11) << "eval p99" << std::setw(13) << "scen/s"
+                    << std::setw(10) << "max err" << "\n";
+            }
+            out << std::left << std::setw(30) << r.method << std::right << std::fixed
+                << std::setprecision(3);
+            for (Size p = 0; p < benchNumPhases; ++p)
+                out << std::setw(13) << r.phaseMs[p];
+            out << std::setw(11) << r.totalMs << std::setw(11) << r.evaluationLatency.p50
+                << std::setw(11) << r.evaluationLatency.p99 << std::setw(13)
+                << std::setprecision(0) << r.throughput << std::setw(10) << std::scientific
+                << std::setprecision(1) << r.maxRelativeError << std::defaultfloat
+                << (r.verified ? "" : "  MISMATCH") << "\n";
+        }
+    }
+
+    void writeBenchJson(std::ostream& out,
+                        const BenchMetadata& metadata,
+                        const std::vector<BenchResult>& results) {
+        out << std::setprecision(12);
+        out << "{\n  \"metadata\": {\n"
+            << "    \"forge_version\": " << jsonString(metadata.forgeVersion) << ",\n"
+            << "    \"quantlib_version\": " << jsonString(metadata.quantlibVersion) << ",\n"
+            << "    \"timestamp\": " << jsonString(metadata.timestamp) << ",\n"
+            << "    \"cpu\": " << jsonString(metadata.cpu) << ",\n"
+            << "    \"avx2\": " << (metadata.avx2 ? "true" : "false") << ",\n"
+            << "    \"seed\": " << metadata.seed << "\n  },\n  \"results\": [";
+        for (Size i = 0; i < results.size(); ++i) {
+            const BenchResult& r = results[i];
+            out << (i == 0 ? "\n" : ",\n") << "    {\n"
+                << "      \"method\": " << jsonString(r.method) << ",\n"
+                << "      \"config\": " << jsonString(r.config.name) << ",\n"
+                << "      \"swaps\": " << r.config.numSwaps << ",\n"
+                << "      \"time_steps\": " << r.config.numTimeSteps << ",\n"
+                << "      \"paths\": " << r.config.numPaths << ",\n"
+                << "      \"risk_factors\": " << r.config.numRiskFactors << ",\n"
+                << "      \"runs\": " << r.runs << ",\n"
+                << "      \"phases_ms\": {";
+            for (Size p = 0; p < benchNumPhases; ++p)
+                out << (p == 0 ? "" : ", ") << jsonString(benchPhaseName(BenchPhase(p))) << ": "
+                    << r.phaseMs[p];
+            out << "},\n"
+                << "      \"total_ms\": " << r.totalMs << ",\n";
+            writeJsonLatency(out, "kernel_latency_us", r.kernelLatency);
+            out << ",\n";
+            writeJsonLatency(out, "evaluation_latency_us", r.evaluationLatency);
+            out << ",\n"
+                << "      \"throughput_scenarios_per_s\": " << r.throughput << ",\n"
+                << "      \"kernels\": " << r.kernels << ",\n"
+                << "      \"evaluations\": " << r.evaluations << ",\n"
+                << "      \"scenarios\": " << r.scenarios << ",\n"
+                << "      \"expected_exposure\": " << r.expectedExposure << ",\n"
+                << "      \"cva\": " << r.cva << ",\n"
+                << "      \"max_relative_error\": " << r.maxRelativeError << ",\n"
+                << "      \"verified\": " << (r.verified ? "true" : "false") << "\n    }";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+    void writeBenchCsv(std::ostream& out,
+                       const BenchMetadata& metadata,
+                       const std::vector<BenchResult>& results) {
+        out << "forge_version,quantlib_version,timestamp,cpu,avx2,seed,method,config,swaps,"
+               "time_steps,paths,risk_factors,runs";
+        for (Size p = 0; p < benchNumPhases; ++p)
+            out << "," << benchPhaseName(BenchPhase(p)) << "_ms";
+        out << ",total_ms";
+        for (const char* latency : {"kernel", "evaluation"})
+            for (const char* stat : {"count", "mean", "p50", "p90", "p99", "max"})
+                out << "," << latency << "_" << stat << (std::string(stat) == "count" ? "" : "_us");
+        out << ",throughput_scenarios_per_s,kernels,evaluations,scenarios,expected_exposure,cva,"
+               "max_relative_error,verified\n";
+
+        out << std::setprecision(12);
+        for (const BenchResult& r : results) {
+            out << csvString(metadata.forgeVersion) << "," << csvString(metadata.quantlibVersion)
+                << "," << metadata.timestamp << "," << csvString(metadata.cpu) << ","
+                << (metadata.avx2 ? 1 : 0) << "," << metadata.seed << "," << csvString(r.method)
+                << "," << csvString(r.config.name) << "," << r.config.numSwaps << ","
+                << r.config.numTimeSteps << "," << r.config.numPaths << ","
+                << r.config.numRiskFactors << "," << r.runs;
+            for (Size p = 0; p < benchNumPhases; ++p)
+                out << "," << r.phaseMs[p];
+            out << "," << r.totalMs;
+            for (const BenchLatencyStats* s : {&r.kernelLatency, &r.evaluationLatency})
+                out << "," << s->count << "," << s->mean << "," << s->p50 << "," << s->p90 << ","
+                    << s->p99 << "," << s->max;
+            out << "," << r.throughput << "," << r.kernels << "," << r.evaluations << ","
+                << r.scenarios << "," << r.expectedExposure << "," << r.cva << ","
+                << r.maxRelativeError << "," << (r.verified ? 1 : 0) << "\n";
+        }
+    }
+
+    void writePassiveTable(std::ostream& out,
+                           const BenchMetadata& metadata,
+                           const std::vector<BenchPassiveResult>& results) {
+        out << "Forge " << metadata.forgeVersion << ", QuantLib " << metadata.quantlibVersion
+            << ", " << metadata.cpu << ", " << metadata.timestamp << "\n"
+            << "passive bump-and-revalue, ns per pricing call\n\n";
+        out << std::left << std::setw(36) << "configuration" << std::right << std::setw(13)
+            << "calls/run" << std::setw(11) << "double" << std::setw(11) << "Real"
+            << std::setw(11) << "slowdown" << std::setw(10) << "max err" << "\n";
+        for (const BenchPassiveResult& r : results)
+            out << std::left << std::setw(36) << r.config.name << std::right << std::setw(13)
+                << r.evaluations << std::fixed << std::setprecision(1) << std::setw(11)
+                << r.doubleNs << std::setw(11) << r.realNs << std::setprecision(2)
+                << std::setw(11) << r.slowdown << std::setw(10) << std::scientific
+                << std::setprecision(1) << r.maxRelativeError << std::defaultfloat << "\n";
+    }
+
+    void writePassiveJson(std::ostream& out,
+                          const BenchMetadata& metadata,
+                          const std::vector<BenchPassiveResult>& results) {
+        out << std::setprecision(12);
+        out << "{\n  \"metadata\": {\n"
+            << "    \"forge_version\": " << jsonString(metadata.forgeVersion) << ",\n"
+            << "    \"quantlib_version\": " << jsonString(metadata.quantlibVersion) << ",\n"
+            << "    \"timestamp\": " << jsonString(metadata.timestamp) << ",\n"
+            << "    \"cpu\": " << jsonString(metadata.cpu) << ",\n"
+            << "    \"avx2\": " << (metadata.avx2 ? "true" : "false") << ",\n"
+            << "    \"seed\": " << metadata.seed << "\n  },\n  \"passive\": [";
+        for (Size i = 0; i < results.size(); ++i) {
+            const BenchPassiveResult& r = results[i];
+            out << (i == 0 ? "\n" : ",\n") << "    {\n"
+                << "      \"config\": " << jsonString(r.config.name) << ",\n"
+                << "      \"swaps\": " << r.config.numSwaps << ",\n"
+                << "      \"time_steps\": " << r.config.numTimeSteps << ",\n"
+                << "      \"paths\": " << r.config.numPaths << ",\n"
+                << "      \"risk_factors\": " << r.config.numRiskFactors << ",\n"
+                << "      \"runs\": " << r.runs << ",\n"
+                << "      \"evaluations\": " << r.evaluations << ",\n"
+                << "      \"double_ns\": " << r.doubleNs << ",\n"
+                << "      \"real_ns\": " << r.realNs << ",\n"
+                << "      \"slowdown\": " << r.slowdown << ",\n"
+                << "      \"max_relative_error\": " << r.maxRelativeError << "\n    }";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+    void writePassiveCsv(std::ostream& out,
+                         const BenchMetadata& metadata,
+                         const std::vector<BenchPassiveResult>& results) {
+        out << "forge_version,quantlib_version,timestamp,cpu,avx2,seed,config,swaps,time_steps,"
+               "paths,risk_factors,runs,evaluations,double_ns,real_ns,slowdown,"
+               "max_relative_error\n";
+        out << std::setprecision(12);
+        for (const BenchPassiveResult& r : results)
+            out << csvString(metadata.forgeVersion) << "," << csvString(metadata.quantlibVersion)
+                << "," << metadata.timestamp << "," << csvString(metadata.cpu) << ","
+                << (metadata.avx2 ? 1 : 0) << "," << metadata.seed << ","
+                << csvString(r.config.name) << "," << r.config.numSwaps << ","
+                << r.config.numTimeSteps << "," << r.config.numPaths << ","
+                << r.config.numRiskFactors << "," << r.runs << "," << r.evaluations << ","
+                << r.doubleNs << "," << r.realNs << "," << r.slowdown << ","
+                << r.maxRelativeError << "\n";
+    }
+
+}
@@ -0,0 +1,68 @@
+/*******************************************************************************
+
+   Table, JSON and CSV reports of the ql_forge_bench harness.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    The JSON report is one object with the run metadata (Forge and
+    QuantLib versions, CPU, timestamp, seed) and one entry per
+    method x configuration; the CSV report has one row per entry with the
+    metadata repeated in the leading columns, so that files from several
+    machines or Forge versions can be concatenated and compared directly.
+    Times are in milliseconds per run, latencies in microseconds and
+    throughput in scenarios per second.  The passive reports (see
+    benchpassive.hpp) have the same layout with one entry per
+    configuration and times in nanoseconds per pricing call.
+*/
+
+#pragma once
+
+#include "benchharness.hpp"
+#include "benchpassive.hpp"
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace QuantLib {
+
+    /// where and with what a report was produced
+    struct BenchMetadata {
+        std::string forgeVersion;
+        std::string quantlibVersion;
+        std::string timestamp;
+        std::string cpu;
+        bool avx2 = false;
+        unsigned int seed = 0;
+
+        /// metadata of the current process and machine
+        static BenchMetadata current(unsigned int seed);
+    };
+
+    void writeBenchTable(std::ostream& out,
+                         const BenchMetadata& metadata,
+                         const std::vector<BenchResult>& results);
+    void writeBenchJson(std::ostream& out,
+                        const BenchMetadata& metadata,
+                        const std::vector<BenchResult>& results);
+    void writeBenchCsv(std::ostream& out,
+                       const BenchMetadata& metadata,
+                       const std::vector<BenchResult>& results);
+
+    void writePassiveTable(std::ostream& out,
+                           const BenchMetadata& metadata,
+                           const std::vector<BenchPassiveResult>& results);
+    void writePassiveJson(std::ostream& out,
+                          const BenchMetadata& metadata,
+                          const std::vector<BenchPassiveResult>& results);
+    void writePassiveCsv(std::ostream& out,
+                         const BenchMetadata& metadata,
+                         const std::vector<BenchPassiveResult>& results);
+
+}
@@ -0,0 +1,418 @@
+/*******************************************************************************
+
+   Forge forward and AAD kernel methods of ql_forge_bench.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Both families record one kernel per swap and time step and evaluate all
+    paths through it.  Forward kernels (markForgeInput) take the bumped
+    scenarios as extra lanes, base and bumps of one path filling the lanes
+    of consecutive executions; AAD kernels (markForgeInputAndDiff) take one
+    path per lane and read the adjoints.  The kernel cache is deliberately
+    not used, so that recording, compilation and buffer allocation are
+    timed for every kernel.  The pipelined AAD methods compile the next
+    kernels on a background thread while the current one is evaluated.
+
+    The autotuned AAD method leaves the compiler configuration to a
+    ForgeAutotuner, which measures the candidates on the first paths of
+    the first kernel of each graph family; tuning and compilation are both
+    timed as compilation, and since the tuner compiles through kernel
+    caches, recordings that repeat a graph reuse its kernel.
+*/
+
+#include "benchharness.hpp"
+#include <ql/forge/autotuner.hpp>
+#include <ql/forge/batchevaluator.hpp>
+#include <ql/forge/compilepipeline.hpp>
+#include <ql/forge/kernelcache.hpp>
+#include <graph/graph_recorder.hpp>
+#include <compiler/compiler_config.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+#include <algorithm>
+
+namespace QuantLib {
+
+    namespace {
+
+        enum class BenchOptimization { StabilityOnly, AllOptimizations, NoOptimization };
+
+        forge::CompilerConfig compilerConfig(BenchOptimization optimization,
+                                             forge::CompilerConfig::InstructionSet instructionSet) {
+            forge::CompilerConfig config;
+            switch (optimization) {
+                case BenchOptimization::StabilityOnly:
+                    config = forge::CompilerConfig::Default();
+                    break;
+                case BenchOptimization::AllOptimizations:
+                    config.enableOptimizations = true;
+                    config.enableCSE = true;
+                    config.enableAlgebraicSimplification = true;
+                    config.enableInactiveFolding = true;
+                    config.enableStabilityCleaning = true;
+                    break;
+                case BenchOptimization::NoOptimization:
+                    config = forge::CompilerConfig::NoOptimization();
+                    break;
+            }
+            config.instructionSet = instructionSet;
+            return config;
+        }
+
+        struct RecordedKernel {
+            ForgeKernelPtr kernel;
+            ForgeBufferPtr buffer;
+            std::vector<forge::NodeId> inputs;
+            forge::NodeId npv;
+        };
+
+        /// records the kernel of one swap and time step, keeping its node ids in ids
+        forge::Graph recordKernel(const BenchFixture& fixture,
+                                  BenchRun& run,
+                                  Size swap,
+                                  Size timeStep,
+                                  bool differentiate,
+                                  RecordedKernel& ids) {
+            BenchRun::Scope timer(run, BenchPhase::Record);
+            const Size n = fixture.config().numRiskFactors;
+            forge::GraphRecorder recorder;
+            recorder.start();
+            auto scenario = fixture.scenarios().path(timeStep, 0);
+            std::vector<Real> inputs(n);
+            ids.inputs.resize(n);
+            for (Size i = 0; i < n; ++i) {
+                inputs[i] = scenario[i];
+                if (differentiate)
+                    inputs[i].markForgeInputAndDiff();
+                else
+                    inputs[i].markForgeInput();
+                ids.inputs[i] = inputs[i].forgeNodeId();
+            }
+            Real npv = fixture.price(swap, timeStep, inputs);
+            npv.markForgeOutput();
+            ids.npv = npv.forgeNodeId();
+            recorder.stop();
+            return recorder.graph();
+        }
+
+        /// records, compiles and allocates the kernel of one swap and time step
+        RecordedKernel createKernel(const BenchFixture& fixture,
+                                    BenchRun& run,
+                                    const forge::CompilerConfig& config,
+                                    Size swap,
+                                    Size timeStep,
+                                    bool differentiate) {
+            BenchRun::Sample sample(run, BenchLatency::Kernel);
+            RecordedKernel result;
+            forge::Graph graph = recordKernel(fixture, run, swap, timeStep, differentiate, result);
+            {
+                BenchRun::Scope timer(run, BenchPhase::Compile);
+                forge::ForgeEngine compiler(config);
+                result.kernel = compiler.compile(graph);
+                QL_REQUIRE(result.kernel != nullptr, "Forge kernel compilation failed");
+            }
+            {
+                BenchRun::Scope timer(run, BenchPhase::BufferAlloc);
+                result.buffer = forge::NodeValueBufferFactory::create(graph, *result.kernel);
+            }
+            run.countKernel();
+            return result;
+        }
+
+        /// evaluates all paths of one swap and time step through an adjoint kernel
+        void evaluateAad(const BenchFixture& fixture,
+                         BenchRun& run,
+                         Size s,
+                         Size t,
+                         ForgeKernel& kernel,
+                         ForgeBuffer& buffer,
+                         const RecordedKernel& ids) {
+            const BenchConfig& config = fixture.config();
+            const Size n = config.numRiskFactors;
+            const ForgeScenarioCube& scenarios = fixture.scenarios();
+            forgeWithBatchWidth(buffer.getVectorWidth(), [&](auto w) {
+                constexpr Size W = decltype(w)::value;
+                ForgeBatchEvaluator<W> evaluator(kernel, buffer, ids.inputs, {ids.npv}, ids.inputs);
+                // the cube batches match the lanes only at its own width
+                const bool interleaved = scenarios.laneWidth() == W;
+                std::vector<double> rows(W * n);
+                double npvs[W];
+                for (Size first = 0; first < config.numPaths; first += W) {
+                    BenchRun::Sample sample(run, BenchLatency::Evaluation);
+                    Size count = std::min(W, config.numPaths - first);
+                    {
+                        BenchRun::Scope timer(run, BenchPhase::SetInputs);
+                        if (interleaved) {
+                            evaluator.loadInterleaved(scenarios.batch(t, first / W), count);
+                        } else {
+                            for (Size lane = 0; lane < count; ++lane) {
+                                auto scenario = scenarios.path(t, first + lane);
+                                for (Size i = 0; i < n; ++i)
+                                    rows[lane * n + i] = scenario[i];
+                            }
+                            evaluator.load(rows.data(), n, 0, count);
+                        }
+                    }
+                    {
+                        BenchRun::Scope timer(run, BenchPhase::Execute);
+                        evaluator.execute();
+                    }
+                    {
+                        BenchRun::Scope timer(run, BenchPhase::Outputs);
+                        evaluator.readOutputs(npvs, 1);
+                    }
+                    {
+                        BenchRun::Scope timer(run, BenchPhase::Gradients);
+                        evaluator.readGradientRows(
+                            [&](Size lane) { return run.sensitivities(s, t, first + lane); });
+                    }
+                    for (Size lane = 0; lane < count; ++lane)
+                        run.exposure(s, t, first + lane) = std::max(0.0, npvs[lane]);
+                    run.countEvaluations();
+                    run.countScenarios(count);
+                }
+            });
+        }
+
+        class ForgeMethod : public BenchMethod {
+          public:
+            ForgeMethod(std::string name,
+                        BenchOptimization optimization,
+                        forge::CompilerConfig::InstructionSet instructionSet)
+            : name_(std::move(name)), optimization_(optimization), instructionSet_(instructionSet) {}
+
+            std::string name() const override { return name_; }
+
+            bool available() const override {
+                return instructionSet_ != forge::CompilerConfig::InstructionSet::AVX2_PACKED ||
+                       benchAvx2Supported();
+            }
+
+          protected:
+            std::string optimizationName() const {
+                switch (optimization_) {
+                    case BenchOptimization::StabilityOnly:
+                        return "stability-only optimizations";
+                    case BenchOptimization::AllOptimizations:
+                        return "all optimizations";
+                    default:
+                        return "no optimizations";
+                }
+            }
+            std::string instructionSetName() const {
+                return instructionSet_ == forge::CompilerConfig::InstructionSet::AVX2_PACKED ?
+                           "AVX2" :
+                           "SSE2";
+            }
+            forge::CompilerConfig config() const {
+                return compilerConfig(optimization_, instructionSet_);
+            }
+
+          private:
+            std::string name_;
+            BenchOptimization optimization_;
+            forge::CompilerConfig::InstructionSet instructionSet_;
+        };
+
+        /// forward-only kernel, sensitivities by bumping in the lanes
+        class ForgeForwardMethod : public ForgeMethod {
+          public:
+            using ForgeMethod::ForgeMethod;
+
+            std::string description() const override {
+                return "Forge forward kernel, " + instructionSetName() + ", " +
+                       optimizationName() + ", bumps in the lanes";
+            }
+
+            void run(const BenchFixture& fixture, BenchRun& run) const override {
+                const BenchConfig& config = fixture.config();
+                const Size n = config.numRiskFactors;
+                const forge::CompilerConfig compiler = this->config();
+                // base scenario in row 0, the scenario bumped in factor i in row i + 1
+                std::vector<double> bumped((n + 1) * n), npvs(n + 1);
+
+                for (Size s = 0; s < config.numSwaps; ++s) {
+                    for (Size t = 0; t < config.numTimeSteps; ++t) {
+                        RecordedKernel k = createKernel(fixture, run, compiler, s, t, false);
+                        forgeWithBatchWidth(k.buffer->getVectorWidth(), [&](auto w) {
+                            constexpr Size W = decltype(w)::value;
+                            ForgeBatchEvaluator<W> evaluator(*k.kernel, *k.buffer, k.inputs,
+                                                             {k.npv});
+                            for (Size p = 0; p < config.numPaths; ++p) {
+                                BenchRun::Sample sample(run, BenchLatency::Evaluation);
+                                auto scenario = fixture.scenarios().path(t, p);
+                                {
+                                    BenchRun::Scope timer(run, BenchPhase::SetInputs);
+                                    for (Size i = 0; i < n; ++i)
+                                        bumped[i] = scenario[i];
+                                    for (Size row = 1; row <= n; ++row) {
+                                        std::copy(bumped.begin(), bumped.begin() + n,
+                                                  bumped.begin() + row * n);
+                                        bumped[row * n + row - 1] += config.bumpSize;
+                                    }
+                                }
+                                for (Size first = 0; first <= n; first += W) {
+                                    Size count = std::min(W, n + 1 - first);
+                                    {
+                                        BenchRun::Scope timer(run, BenchPhase::SetInputs);
+                                        evaluator.load(bumped.data(), n, first, count);
+                                    }
+                                    {
+                                        BenchRun::Scope timer(run, BenchPhase::Execute);
+                                        evaluator.execute();
+                                    }
+                                    BenchRun::Scope timer(run, BenchPhase::Outputs);
+                                    evaluator.readOutputs(npvs.data() + first, 1);
+                                    run.countEvaluations();
+                                }
+                                BenchRun::Scope timer(run, BenchPhase::Outputs);
+                                double* sensitivities = run.sensitivities(s, t, p);
+                                for (Size i = 0; i < n; ++i)
+                                    sensitivities[i] = (npvs[i + 1] - npvs[0]) / config.bumpSize;
+                                run.exposure(s, t, p) = std::max(0.0, npvs[0]);
+                                run.countScenarios();
+                            }
+                        });
+                    }
+                }
+            }
+        };
+
+        /// adjoint kernel, one path per lane
+        class ForgeAadMethod : public ForgeMethod {
+          public:
+            using ForgeMethod::ForgeMethod;
+
+            std::string description() const override {
+                return "Forge AAD kernel, " + instructionSetName() + ", " + optimizationName();
+            }
+
+            void run(const BenchFixture& fixture, BenchRun& run) const override {
+                const BenchConfig& config = fixture.config();
+                const forge::CompilerConfig compiler = this->config();
+                for (Size s = 0; s < config.numSwaps; ++s) {
+                    for (Size t = 0; t < config.numTimeSteps; ++t) {
+                        RecordedKernel k = createKernel(fixture, run, compiler, s, t, true);
+                        evaluateAad(fixture, run, s, t, *k.kernel, *k.buffer, k);
+                    }
+                }
+            }
+        };
+
+        /// adjoint kernel, compiled on a background thread while the previous one evaluates
+        class ForgeAadPipelinedMethod : public ForgeMethod {
+          public:
+            using ForgeMethod::ForgeMethod;
+
+            std::string description() const override {
+                return "Forge AAD kernel, " + instructionSetName() + ", " + optimizationName() +
+                       ", background compilation";
+            }
+
+            void run(const BenchFixture& fixture, BenchRun& run) const override {
+                const BenchConfig& config = fixture.config();
+                const Size steps = config.numTimeSteps;
+                const Size kernels = config.numSwaps * steps;
+                std::vector<RecordedKernel> ids(kernels);
+                ForgeCompilePipeline pipeline(this->config());
+                // compilation and buffer allocation run on the pipeline thread and
+                // are not in the phase timings; the overlap shows in the run time
+                forgePipelined(
+                    pipeline, kernels, 2,
+                    [&](Size k) {
+                        return recordKernel(fixture, run, k / steps, k % steps, true, ids[k]);
+                    },
+                    [&](Size k, ForgeCompiledKernel& compiled) {
+                        run.countKernel();
+                        evaluateAad(fixture, run, k / steps, k % steps, *compiled.kernel,
+                                    *compiled.buffer, ids[k]);
+                    });
+            }
+        };
+
+        /// adjoint kernel, compiler configuration chosen per graph family by measurement
+        class ForgeAadAutotunedMethod : public BenchMethod {
+          public:
+            explicit ForgeAadAutotunedMethod(std::string name) : name_(std::move(name)) {}
+
+            std::string name() const override { return name_; }
+
+            std::string description() const override {
+                return "Forge AAD kernel, instruction set and optimizations autotuned per graph";
+            }
+
+            void run(const BenchFixture& fixture, BenchRun& run) const override {
+                const BenchConfig& config = fixture.config();
+                const Size n = config.numRiskFactors;
+                const Size numSamples = std::min<Size>(config.numPaths, 64);
+                ForgeAutotuneOptions options;
+                options.sampleScenarios = 4 * numSamples;
+                ForgeAutotuner tuner(forgeAutotuneCandidates(), options);
+                std::vector<double> rows(numSamples * n);
+                for (Size s = 0; s < config.numSwaps; ++s) {
+                    for (Size t = 0; t < config.numTimeSteps; ++t) {
+                        RecordedKernel ids;
+                        ForgeKernelCache::Entry entry;
+                        {
+                            BenchRun::Sample sample(run, BenchLatency::Kernel);
+                            forge::Graph graph = recordKernel(fixture, run, s, t, true, ids);
+                            for (Size p = 0; p < numSamples; ++p) {
+                                auto scenario = fixture.scenarios().path(t, p);
+                                for (Size i = 0; i < n; ++i)
+                                    rows[p * n + i] = scenario[i];
+                            }
+                            BenchRun::Scope timer(run, BenchPhase::Compile);
+                            entry = tuner.acquire(graph, ids.inputs, rows.data(), numSamples, n);
+                        }
+                        run.countKernel();
+                        evaluateAad(fixture, run, s, t, *entry.kernel, *entry.buffer, ids);
+                    }
+                }
+            }
+
+          private:
+            std::string name_;
+        };
+
+        const auto sse2 = forge::CompilerConfig::InstructionSet::SSE2_SCALAR;
+        const auto avx2 = forge::CompilerConfig::InstructionSet::AVX2_PACKED;
+
+        const BenchRegistration<ForgeForwardMethod> forwardSse2Stability(
+            "forge-forward-sse2-stability", BenchOptimization::StabilityOnly, sse2);
+        const BenchRegistration<ForgeForwardMethod> forwardSse2AllOpt(
+            "forge-forward-sse2-allopt", BenchOptimization::AllOptimizations, sse2);
+        const BenchRegistration<ForgeForwardMethod> forwardAvx2Stability(
+            "forge-forward-avx2-stability", BenchOptimization::StabilityOnly, avx2);
+        const BenchRegistration<ForgeForwardMethod> forwardAvx2AllOpt(
+            "forge-forward-avx2-allopt", BenchOptimization::AllOptimizations, avx2);
+
+        const BenchRegistration<ForgeAadMethod> aadSse2Stability(
+            "forge-aad-sse2-stability", BenchOptimization::StabilityOnly, sse2);
+        const BenchRegistration<ForgeAadMethod> aadSse2AllOpt(
+            "forge-aad-sse2-allopt", BenchOptimization::AllOptimizations, sse2);
+        const BenchRegistration<ForgeAadMethod> aadSse2NoOpt(
+            "forge-aad-sse2-noopt", BenchOptimization::NoOptimization, sse2);
+        const BenchRegistration<ForgeAadMethod> aadAvx2Stability(
+            "forge-aad-avx2-stability", BenchOptimization::StabilityOnly, avx2);
+        const BenchRegistration<ForgeAadMethod> aadAvx2AllOpt(
+            "forge-aad-avx2-allopt", BenchOptimization::AllOptimizations, avx2);
+        const BenchRegistration<ForgeAadMethod> aadAvx2NoOpt(
+            "forge-aad-avx2-noopt", BenchOptimization::NoOptimization, avx2);
+
+        const BenchRegistration<ForgeAadPipelinedMethod> aadSse2Pipelined(
+            "forge-aad-sse2-pipelined", BenchOptimization::StabilityOnly, sse2);
+        const BenchRegistration<ForgeAadPipelinedMethod> aadAvx2Pipelined(
+            "forge-aad-avx2-pipelined", BenchOptimization::StabilityOnly, avx2);
+
+        const BenchRegistration<ForgeAadAutotunedMethod> aadAutotuned("forge-aad-autotuned");
+
+    }
+
+}
@@ -0,0 +1,67 @@
+/*******************************************************************************
+
+   Bump-and-revalue on QuantLib, the reference method of ql_forge_bench.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "benchharness.hpp"
+#include <algorithm>
+
+namespace QuantLib {
+
+    namespace {
+
+        /// prices every scenario and its one-sided bumps through QuantLib
+        class BumpRevalMethod : public BenchMethod {
+          public:
+            std::string name() const override { return "bump-reval"; }
+            std::string description() const override {
+                return "QuantLib re-pricing with one-sided finite differences";
+            }
+
+            void run(const BenchFixture& fixture, BenchRun& run) const override {
+                const BenchConfig& config = fixture.config();
+                const Size n = config.numRiskFactors;
+                std::vector<Real> inputs(n);
+
+                for (Size s = 0; s < config.numSwaps; ++s) {
+                    for (Size t = 0; t < config.numTimeSteps; ++t) {
+                        for (Size p = 0; p < config.numPaths; ++p) {
+                            BenchRun::Sample sample(run, BenchLatency::Evaluation);
+                            auto scenario = fixture.scenarios().path(t, p);
+                            {
+                                BenchRun::Scope timer(run, BenchPhase::SetInputs);
+                                for (Size i = 0; i < n; ++i)
+                                    inputs[i] = scenario[i];
+                            }
+
+                            double* sensitivities = run.sensitivities(s, t, p);
+                            BenchRun::Scope timer(run, BenchPhase::Execute);
+                            double baseNpv = value(fixture.price(s, t, inputs));
+                            run.exposure(s, t, p) = std::max(0.0, baseNpv);
+                            for (Size i = 0; i < n; ++i) {
+                                // bump in place and restore
+                                inputs[i] = scenario[i] + config.bumpSize;
+                                double bumpedNpv = value(fixture.price(s, t, inputs));
+                                inputs[i] = scenario[i];
+                                sensitivities[i] = (bumpedNpv - baseNpv) / config.bumpSize;
+                            }
+                            run.countEvaluations(n + 1);
+                            run.countScenarios();
+                        }
+                    }
+                }
+            }
+        };
+
+        const BenchRegistration<BumpRevalMethod> bumpReval;
+
+    }
+
+}
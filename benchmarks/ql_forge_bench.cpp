@@ -0,0 +1,238 @@
+/*******************************************************************************
+
+   ql_forge_bench - XVA swap benchmark over all registered methods
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+// Usage:
+//   ql_forge_bench [--list] [--passive] [--methods=a,b,...] [--configs=1,3,...]
+//                  [--format=table|json|csv] [--output=file]
+//                  [--warmup=N] [--runs=N] [--seed=N]
+//
+// Runs every selected method on every selected configuration (the six
+// cases of the swap_xva_* programs, numbered from 1).  The first selected
+// method is the reference the sensitivities of the others are checked
+// against; the exit code is 1 if any of them differs by more than 1%.
+//
+// With --passive, the methods are not run: every selected configuration
+// is bump-and-revalued with one pricing function on double and on Real,
+// outside of any recording (see harness/benchpassive.hpp), and the exit
+// code is 1 if the two give different NPVs.
+
+#include "harness/benchpassive.hpp"
+#include "harness/benchreport.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace QuantLib;
+
+namespace {
+
+    std::vector<std::string> split(const std::string& list) {
+        std::vector<std::string> items;
+        std::istringstream in(list);
+        std::string item;
+        while (std::getline(in, item, ','))
+            if (!item.empty())
+                items.push_back(item);
+        return items;
+    }
+
+    Size parseSize(const std::string& option, const std::string& value) {
+        char* end = nullptr;
+        unsigned long long n = std::strtoull(value.c_str(), &end, 10);
+        QL_REQUIRE(!value.empty() && *end == '\0', "invalid value '" << value << "' for " << option);
+        return Size(n);
+    }
+
+    struct Options {
+        bool list = false;
+        bool passive = false;
+        std::vector<std::string> methods;
+        std::vector<Size> configs;
+        std::string format = "table";
+        std::string output;
+        Size warmup = Size(-1), runs = Size(-1);
+        unsigned int seed = 42;
+    };
+
+    Options parse(int argc, char* argv[]) {
+        Options options;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            std::string::size_type eq = arg.find('=');
+            std::string key = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+            if (key == "--list") {
+                options.list = true;
+            } else if (key == "--passive") {
+                options.passive = true;
+            } else if (key == "--methods") {
+                options.methods = split(value);
+            } else if (key == "--configs") {
+                for (const std::string& c : split(value))
+                    options.configs.push_back(parseSize(key, c));
+            } else if (key == "--format") {
+                QL_REQUIRE(value == "table" || value == "json" || value == "csv",
+                           "unknown format '" << value << "'");
+                options.format = value;
+            } else if (key == "--output") {
+                options.output = value;
+            } else if (key == "--warmup") {
+                options.warmup = parseSize(key, value);
+            } else if (key == "--runs") {
+                options.runs = parseSize(key, value);
+            } else if (key == "--seed") {
+                options.seed = static_cast<unsigned int>(parseSize(key, value));
+            } else {
+                QL_FAIL("unknown option " << arg);
+            }
+        }
+        return options;
+    }
+
+    /// the --output file if given, standard output otherwise
+    std::ostream& reportStream(const Options& options, std::ofstream& file) {
+        if (options.output.empty())
+            return std::cout;
+        file.open(options.output);
+        QL_REQUIRE(file, "cannot open " << options.output);
+        return file;
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        Options options = parse(argc, argv);
+        const BenchRegistry& registry = BenchRegistry::instance();
+
+        if (options.list) {
+            for (const auto& m : registry.methods())
+                std::cout << m->name() << (m->available() ? "" : " (unavailable)") << "\n    "
+                          << m->description() << "\n";
+            return 0;
+        }
+
+        std::vector<BenchConfig> configs, standard = standardBenchConfigs();
+        if (options.configs.empty()) {
+            configs = standard;
+        } else {
+            for (Size c : options.configs) {
+                QL_REQUIRE(c >= 1 && c <= standard.size(),
+                           "configuration " << c << " out of range 1-" << standard.size());
+                configs.push_back(standard[c - 1]);
+            }
+        }
+
+        if (options.passive) {
+            std::vector<BenchPassiveResult> results;
+            bool agreed = true;
+            for (BenchConfig config : configs) {
+                if (options.warmup != Size(-1))
+                    config.warmupRuns = options.warmup;
+                if (options.runs != Size(-1))
+                    config.timedRuns = options.runs;
+                BenchFixture fixture(config, options.seed);
+                std::cerr << config.name << "\n";
+                results.push_back(runPassiveBenchmark(fixture));
+                agreed = agreed && results.back().maxRelativeError <= benchPassiveTolerance;
+            }
+
+            BenchMetadata metadata = BenchMetadata::current(options.seed);
+            std::ofstream file;
+            std::ostream& out = reportStream(options, file);
+            if (options.format == "json")
+                writePassiveJson(out, metadata, results);
+            else if (options.format == "csv")
+                writePassiveCsv(out, metadata, results);
+            else
+                writePassiveTable(out, metadata, results);
+
+            if (!agreed) {
+                std::cerr << "NPVs on Real differ from those on double\n";
+                return 1;
+            }
+            return 0;
+        }
+
+        std::vector<const BenchMethod*> methods;
+        if (options.methods.empty()) {
+            for (const auto& m : registry.methods())
+                if (m->available())
+                    methods.push_back(m.get());
+            // registration order across translation units is unspecified
+            auto bumpReval = std::find(methods.begin(), methods.end(), registry.find("bump-reval"));
+            if (bumpReval != methods.end())
+                std::rotate(methods.begin(), bumpReval, bumpReval + 1);
+        } else {
+            for (const std::string& name : options.methods) {
+                const BenchMethod* m = registry.find(name);
+                QL_REQUIRE(m != nullptr, "unknown method " << name << " (see --list)");
+                if (m->available())
+                    methods.push_back(m);
+                else
+                    std::cerr << "skipping " << name << ", not available on this machine\n";
+            }
+        }
+        QL_REQUIRE(!methods.empty(), "no method to run");
+
+        std::vector<BenchResult> results;
+        bool verified = true;
+        for (BenchConfig config : configs) {
+            if (options.warmup != Size(-1))
+                config.warmupRuns = options.warmup;
+            if (options.runs != Size(-1))
+                config.timedRuns = options.runs;
+            BenchFixture fixture(config, options.seed);
+            std::cerr << config.name << "\n";
+
+            Size reference = results.size();
+            for (const BenchMethod* m : methods) {
+                std::cerr << "  " << m->name() << "\n";
+                results.push_back(runBenchmark(
+                    *m, fixture, results.size() > reference ? &results[reference] : nullptr));
+                verified = verified && results.back().verified;
+                // only the reference keeps its sensitivities
+                if (results.size() > reference + 1) {
+                    std::vector<double>().swap(results.back().exposures);
+                    std::vector<double>().swap(results.back().sensitivities);
+                }
+            }
+        }
+
+        BenchMetadata metadata = BenchMetadata::current(options.seed);
+        std::ofstream file;
+        std::ostream& out = reportStream(options, file);
+        if (options.format == "json")
+            writeBenchJson(out, metadata, results);
+        else if (options.format == "csv")
+            writeBenchCsv(out, metadata, results);
+        else
+            writeBenchTable(out, metadata, results);
+
+        if (!verified) {
+            std::cerr << "sensitivities differ from " << methods.front()->name() << "\n";
+            return 1;
+        }
+        return 0;
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    } catch (...) {
+        std::cerr << "unknown error" << std::endl;
+        return 1;
+    }
+}
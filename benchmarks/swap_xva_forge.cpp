@@ -45,6 +45,10 @@
 // Forge provides two distinct benefits:
 //   A) JIT Compilation: Kernel can be re-evaluated with different inputs much faster
 //   B) AAD: Gradients computed automatically in single backward pass (no bumping)
+//
+// The Forge approaches record each swap from a cached ForgeSwapSkeleton: the
+// schedules, index, pillar dates and legs are built on the first recording of
+// a swap and only the curve and the pricing are recorded again afterwards.
 // =============================================================================
 
 #include <ql/qldefines.hpp>
@@ -61,6 +65,7 @@
 #include <ql/time/calendars/target.hpp>
 #include <ql/time/daycounters/actual365fixed.hpp>
 #include <ql/settings.hpp>
+#include <ql/forge/tradeskeleton.hpp>
 
 // Forge integration headers
 #include <graph/graph_recorder.hpp>
@@ -71,6 +76,7 @@
 #include <iomanip>
 #include <iostream>
 #include <random>
+#include <tuple>
 #include <vector>
 #include <algorithm>
 #include <cmath>
@@ -301,58 +307,126 @@ namespace {
     }
 
     //=========================================================================
-    // Price swap - 10 risk factors (EUR curve only)
+    // Swap skeletons: schedules, index and legs shared by re-recordings
     //=========================================================================
-    Real priceSwap10RF(
-        const SwapDefinition& swapDef,
-        Size timeStep,
-        Size totalTimeSteps,
-        const std::vector<Real>& allInputs,
-        const std::vector<IRPillar>& eurPillarDefs,
+    // tenor, remaining years, fixed and float frequencies, notional, fixed rate, spread
+    using SwapSkeletonKey = std::tuple<Integer, Integer, Period, Period, double, double, double>;
+    using SwapSkeletonCache = ForgeSkeletonCache<SwapSkeletonKey, ForgeSwapSkeleton>;
+
+    ext::shared_ptr<VanillaSwap> buildSwap(
+        const SwapSkeletonKey& key,
+        const Handle<YieldTermStructure>& termStructure,
         const Date& today,
         const Calendar& calendar,
         const DayCounter& dayCounter) {
 
-        double timeStepFraction = totalTimeSteps > 1 ? double(timeStep) / totalTimeSteps : 0.0;
-        Integer elapsedYears = Integer(timeStepFraction * swapDef.tenorYears);
-        Integer remainingYears = swapDef.tenorYears - elapsedYears;
+        auto index = ext::make_shared<Euribor6M>(termStructure);
+        Date start = calendar.advance(today, index->fixingDays(), Days);
+        Date maturity = calendar.advance(start, std::get<1>(key), Years);
 
-        if (remainingYears <= 0) {
-            return Real(0.0);
-        }
+        Schedule fixedSchedule(start, maturity, std::get<2>(key), calendar,
+                               ModifiedFollowing, ModifiedFollowing,
+                               DateGeneration::Forward, false);
+        Schedule floatSchedule(start, maturity, std::get<3>(key), calendar,
+                               ModifiedFollowing, ModifiedFollowing,
+                               DateGeneration::Forward, false);
+
+        auto swap = ext::make_shared<VanillaSwap>(
+            VanillaSwap::Payer, std::get<4>(key), fixedSchedule, std::get<5>(key),
+            dayCounter, floatSchedule, index, std::get<6>(key), dayCounter);
+
+        swap->setPricingEngine(ext::make_shared<DiscountingSwapEngine>(termStructure));
+        return swap;
+    }
+
+    std::vector<Date> curvePillarDates(
+        const std::vector<IRPillar>& eurPillarDefs,
+        const Date& today,
+        const Calendar& calendar) {
 
         std::vector<Date> curveDates;
-        std::vector<Real> curveRates;
         curveDates.push_back(today);
-        curveRates.push_back(allInputs[0]);
-
         for (Size i = 0; i < 10 && i < eurPillarDefs.size(); ++i) {
             curveDates.push_back(calendar.advance(today, eurPillarDefs[i].tenor));
+        }
+        return curveDates;
+    }
+
+    // skeletons of the benchmark's EUR swaps (TARGET, Actual/365F), kept across runs
+    SwapSkeletonCache& swapSkeletons() {
+        static SwapSkeletonCache cache([](const SwapSkeletonKey& key) {
+            const Calendar calendar = TARGET();
+            const DayCounter dayCounter = Actual365Fixed();
+            const Date today = Settings::instance().evaluationDate();
+            auto skeleton = ext::make_shared<ForgeSwapSkeleton>();
+            skeleton->pillarDates = curvePillarDates(createEURCurvePillars(), today, calendar);
+            skeleton->swap = buildSwap(key, skeleton->curve, today, calendar, dayCounter);
+            return skeleton;
+        });
+        return cache;
+    }
+
+    //=========================================================================
+    // Swap NPV on the EUR zero curve, from scratch or from a cached skeleton
+    //=========================================================================
+    Real swapNpv(
+        const SwapDefinition& swapDef,
+        Integer remainingYears,
+        const std::vector<Real>& allInputs,
+        const std::vector<IRPillar>& eurPillarDefs,
+        const Date& today,
+        const Calendar& calendar,
+        const DayCounter& dayCounter,
+        bool useSkeletons) {
+
+        std::vector<Real> curveRates;
+        curveRates.push_back(allInputs[0]);
+        for (Size i = 0; i < 10 && i < eurPillarDefs.size(); ++i) {
             curveRates.push_back(allInputs[i]);
         }
 
+        const SwapSkeletonKey key(swapDef.tenorYears, remainingYears, swapDef.fixedFreq,
+                                  swapDef.floatFreq, value(swapDef.notional),
+                                  value(swapDef.fixedRate), value(swapDef.spread));
+        if (useSkeletons) {
+            auto skeleton = swapSkeletons().get(key);
+            auto zeroCurve = ext::make_shared<ZeroCurve>(skeleton->pillarDates, curveRates, dayCounter);
+            zeroCurve->enableExtrapolation();
+            return skeleton->npv(zeroCurve);
+        }
+
         RelinkableHandle<YieldTermStructure> termStructure;
-        auto zeroCurve = ext::make_shared<ZeroCurve>(curveDates, curveRates, dayCounter);
+        auto zeroCurve = ext::make_shared<ZeroCurve>(curvePillarDates(eurPillarDefs, today, calendar),
+                                                     curveRates, dayCounter);
         zeroCurve->enableExtrapolation();
         termStructure.linkTo(zeroCurve);
+        return buildSwap(key, termStructure, today, calendar, dayCounter)->NPV();
+    }
 
-        auto index = ext::make_shared<Euribor6M>(termStructure);
-        Date start = calendar.advance(today, index->fixingDays(), Days);
-        Date maturity = calendar.advance(start, remainingYears, Years);
+    //=========================================================================
+    // Price swap - 10 risk factors (EUR curve only)
+    //=========================================================================
+    Real priceSwap10RF(
+        const SwapDefinition& swapDef,
+        Size timeStep,
+        Size totalTimeSteps,
+        const std::vector<Real>& allInputs,
+        const std::vector<IRPillar>& eurPillarDefs,
+        const Date& today,
+        const Calendar& calendar,
+        const DayCounter& dayCounter,
+        bool useSkeletons = false) {
 
-        Schedule fixedSchedule(start, maturity, swapDef.fixedFreq, calendar,
-                               ModifiedFollowing, ModifiedFollowing,
-                               DateGeneration::Forward, false);
-        Schedule floatSchedule(start, maturity, swapDef.floatFreq, calendar,
-                               ModifiedFollowing, ModifiedFollowing,
-                               DateGeneration::Forward, false);
+        double timeStepFraction = totalTimeSteps > 1 ? double(timeStep) / totalTimeSteps : 0.0;
+        Integer elapsedYears = Integer(timeStepFraction * swapDef.tenorYears);
+        Integer remainingYears = swapDef.tenorYears - elapsedYears;
 
-        auto swap = ext::make_shared<VanillaSwap>(
-            VanillaSwap::Payer, swapDef.notional, fixedSchedule, swapDef.fixedRate,
-            dayCounter, floatSchedule, index, swapDef.spread, dayCounter);
+        if (remainingYears <= 0) {
+            return Real(0.0);
+        }
 
-        swap->setPricingEngine(ext::make_shared<DiscountingSwapEngine>(termStructure));
-        return swap->NPV();
+        return swapNpv(swapDef, remainingYears, allInputs, eurPillarDefs, today, calendar, dayCounter,
+                       useSkeletons);
     }
 
     //=========================================================================
@@ -366,7 +440,8 @@ namespace {
         const std::vector<IRPillar>& eurPillarDefs,
         const Date& today,
         const Calendar& calendar,
-        const DayCounter& dayCounter) {
+        const DayCounter& dayCounter,
+        bool useSkeletons = false) {
 
         double timeStepFraction = totalTimeSteps > 1 ? double(timeStep) / totalTimeSteps : 0.0;
         Integer elapsedYears = Integer(timeStepFraction * swapDef.tenorYears);
@@ -376,38 +451,8 @@ namespace {
             return Real(0.0);
         }
 
-        std::vector<Date> curveDates;
-        std::vector<Real> curveRates;
-        curveDates.push_back(today);
-        curveRates.push_back(allInputs[0]);
-
-        for (Size i = 0; i < 10 && i < eurPillarDefs.size(); ++i) {
-            curveDates.push_back(calendar.advance(today, eurPillarDefs[i].tenor));
-            curveRates.push_back(allInputs[i]);
-        }
-
-        RelinkableHandle<YieldTermStructure> termStructure;
-        auto zeroCurve = ext::make_shared<ZeroCurve>(curveDates, curveRates, dayCounter);
-        zeroCurve->enableExtrapolation();
-        termStructure.linkTo(zeroCurve);
-
-        auto index = ext::make_shared<Euribor6M>(termStructure);
-        Date start = calendar.advance(today, index->fixingDays(), Days);
-        Date maturity = calendar.advance(start, remainingYears, Years);
-
-        Schedule fixedSchedule(start, maturity, swapDef.fixedFreq, calendar,
-                               ModifiedFollowing, ModifiedFollowing,
-                               DateGeneration::Forward, false);
-        Schedule floatSchedule(start, maturity, swapDef.floatFreq, calendar,
-                               ModifiedFollowing, ModifiedFollowing,
-                               DateGeneration::Forward, false);
-
-        auto swap = ext::make_shared<VanillaSwap>(
-            VanillaSwap::Payer, swapDef.notional, fixedSchedule, swapDef.fixedRate,
-            dayCounter, floatSchedule, index, swapDef.spread, dayCounter);
-
-        swap->setPricingEngine(ext::make_shared<DiscountingSwapEngine>(termStructure));
-        Real baseNpv = swap->NPV();
+        Real baseNpv = swapNpv(swapDef, remainingYears, allInputs, eurPillarDefs, today, calendar,
+                               dayCounter, useSkeletons);
 
         // XVA adjustments using remaining 90 risk factors
         std::vector<Real> eurRates(allInputs.begin(), allInputs.begin() + 10);
@@ -431,8 +476,9 @@ namespace {
         }
 
         Real lgd = Real(0.4);
-        Real exposure = baseNpv > Real(0.0) ? baseNpv : Real(0.0);
-        Real negExposure = baseNpv < Real(0.0) ? -baseNpv : Real(0.0);
+        // recorded selections: the kernel stays valid when the NPV changes sign
+        Real exposure = forge::expr::positive_part(baseNpv);
+        Real negExposure = forge::expr::negative_part(baseNpv);
 
         Real cvaAdj = Real(0.0);
         Real dvaAdj = Real(0.0);
@@ -461,12 +507,13 @@ namespace {
         const Date& today,
         const Calendar& calendar,
         const DayCounter& dayCounter,
-        Size numRiskFactors) {
+        Size numRiskFactors,
+        bool useSkeletons = false) {
 
         if (numRiskFactors <= 10) {
-            return priceSwap10RF(swapDef, timeStep, totalTimeSteps, allInputs, eurPillarDefs, today, calendar, dayCounter);
+            return priceSwap10RF(swapDef, timeStep, totalTimeSteps, allInputs, eurPillarDefs, today, calendar, dayCounter, useSkeletons);
         } else {
-            return priceSwap100RF(swapDef, timeStep, totalTimeSteps, allInputs, eurPillarDefs, today, calendar, dayCounter);
+            return priceSwap100RF(swapDef, timeStep, totalTimeSteps, allInputs, eurPillarDefs, today, calendar, dayCounter, useSkeletons);
         }
     }
 
@@ -591,7 +638,7 @@ namespace {
                     rateNodeIds[i] = rateInputs[i].forgeNodeId();
                 }
 
-                Real npv = priceSwap(swaps[s], t, config.numTimeSteps, rateInputs, pillars, today, calendar, dayCounter, config.numRiskFactors);
+                Real npv = priceSwap(swaps[s], t, config.numTimeSteps, rateInputs, pillars, today, calendar, dayCounter, config.numRiskFactors, true);
                 npv.markForgeOutput();
                 forge::NodeId npvNodeId = npv.forgeNodeId();
 
@@ -719,7 +766,7 @@ namespace {
                     rateNodeIds[i] = rateInputs[i].forgeNodeId();
                 }
 
-                Real npv = priceSwap(swaps[s], t, config.numTimeSteps, rateInputs, pillars, today, calendar, dayCounter, config.numRiskFactors);
+                Real npv = priceSwap(swaps[s], t, config.numTimeSteps, rateInputs, pillars, today, calendar, dayCounter, config.numRiskFactors, true);
                 npv.markForgeOutput();
                 forge::NodeId npvNodeId = npv.forgeNodeId();
 
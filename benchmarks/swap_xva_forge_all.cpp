@@ -72,6 +72,11 @@
 #include <compiler/forge_engine.hpp>
 #include <compiler/compiler_config.hpp>
 #include <compiler/node_value_buffers/node_value_buffer.hpp>
+#include <ql/forge/batchevaluator.hpp>
+#include <ql/forge/bumpbatch.hpp>
+#include <ql/forge/kernelcache.hpp>
+#include <ql/forge/scenariocube.hpp>
+#include <ql/forge/sensitivitytensor.hpp>
 
 #include <chrono>
 #include <iomanip>
@@ -80,7 +85,6 @@
 #include <vector>
 #include <algorithm>
 #include <cmath>
-#include <immintrin.h>  // AVX2 intrinsics for direct buffer writes
 
 // Check for AVX2 support at runtime
 #if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
@@ -195,6 +199,8 @@ namespace {
         Size warmupRuns = 2;
         Size timedRuns = 5;
         double bumpSize = 1e-4;
+        // Aggregated keeps only path sums of the sensitivities
+        ForgeSensitivityLayout sensitivityLayout = ForgeSensitivityLayout::PathMajor;
     };
 
     //=========================================================================
@@ -210,20 +216,18 @@ namespace {
     };
 
     //=========================================================================
-    // Market Scenario
+    // Market Scenarios
+    //    One contiguous cube, lane-interleaved for the widest (AVX2) kernel;
+    //    scalar paths read single scenarios through strided views
     //=========================================================================
-    struct MarketScenario {
-        std::vector<double> flatData;
-
-        const std::vector<double>& flatten() const { return flatData; }
-    };
+    const Size SCENARIO_LANE_WIDTH = 4;
 
     //=========================================================================
     // Results
     //=========================================================================
     struct XvaResults {
         std::vector<std::vector<std::vector<double>>> exposures;
-        std::vector<std::vector<std::vector<std::vector<double>>>> sensitivities;
+        ForgeSensitivityTensor sensitivities;
         double expectedExposure = 0.0;
         double cva = 0.0;
     };
@@ -281,7 +285,7 @@ namespace {
     //=========================================================================
     // Generate scenarios with specified number of risk factors
     //=========================================================================
-    std::vector<std::vector<MarketScenario>> generateScenarios(
+    ForgeScenarioCube generateScenarios(
         const XvaConfig& config,
         const std::vector<IRPillar>& eurPillars,
         const AdditionalRiskFactors& baseFactors,
@@ -290,7 +294,7 @@ namespace {
         std::mt19937 gen(seed);
         std::normal_distribution<> dist(0.0, 1.0);
 
-        std::vector<std::vector<MarketScenario>> scenarios(config.numTimeSteps);
+        ForgeScenarioCube scenarios(config.numTimeSteps, config.numPaths, config.numRiskFactors, SCENARIO_LANE_WIDTH);
 
         double rateVol = 0.005;
         double fxVol = 0.10;
@@ -298,19 +302,16 @@ namespace {
         double volVol = 0.30;
 
         for (Size t = 0; t < config.numTimeSteps; ++t) {
-            scenarios[t].resize(config.numPaths);
             double timeYears = config.numTimeSteps > 1 ? double(t + 1) / config.numTimeSteps * 5.0 : 0.0;
             double sqrtTime = std::sqrt(std::max(timeYears, 0.01));
 
             for (Size p = 0; p < config.numPaths; ++p) {
-                MarketScenario& sc = scenarios[t][p];
-                sc.flatData.resize(config.numRiskFactors);
                 Size idx = 0;
 
                 // EUR curve (first 10 risk factors)
                 double eurParallel = dist(gen);
                 for (Size i = 0; i < std::min(Size(10), config.numRiskFactors); ++i) {
-                    sc.flatData[idx++] = eurPillars[i].baseRate + eurPillars[i].volatility * eurParallel * sqrtTime;
+                    scenarios(t, p, idx++) = eurPillars[i].baseRate + eurPillars[i].volatility * eurParallel * sqrtTime;
                 }
 
                 if (config.numRiskFactors <= 10) continue;
@@ -318,52 +319,53 @@ namespace {
                 // USD curve (10-19)
                 double usdParallel = dist(gen);
                 for (Size i = 0; i < 10 && idx < config.numRiskFactors; ++i) {
-                    sc.flatData[idx++] = baseFactors.usdRates[i] + rateVol * usdParallel * sqrtTime;
+                    scenarios(t, p, idx++) = baseFactors.usdRates[i] + rateVol * usdParallel * sqrtTime;
                 }
 
                 // GBP curve (20-29)
                 double gbpParallel = dist(gen);
                 for (Size i = 0; i < 10 && idx < config.numRiskFactors; ++i) {
-                    sc.flatData[idx++] = baseFactors.gbpRates[i] + rateVol * gbpParallel * sqrtTime;
+                    scenarios(t, p, idx++) = baseFactors.gbpRates[i] + rateVol * gbpParallel * sqrtTime;
                 }
 
                 // JPY curve (30-39)
                 double jpyParallel = dist(gen);
                 for (Size i = 0; i < 10 && idx < config.numRiskFactors; ++i) {
-                    sc.flatData[idx++] = baseFactors.jpyRates[i] + rateVol * jpyParallel * sqrtTime;
+                    scenarios(t, p, idx++) = baseFactors.jpyRates[i] + rateVol * jpyParallel * sqrtTime;
                 }
 
                 // CHF curve (40-49)
                 double chfParallel = dist(gen);
                 for (Size i = 0; i < 10 && idx < config.numRiskFactors; ++i) {
-                    sc.flatData[idx++] = baseFactors.chfRates[i] + rateVol * chfParallel * sqrtTime;
+                    scenarios(t, p, idx++) = baseFactors.chfRates[i] + rateVol * chfParallel * sqrtTime;
                 }
 
                 // FX rates (50-54)
                 for (Size i = 0; i < 5 && idx < config.numRiskFactors; ++i) {
                     double fxShock = dist(gen);
-                    sc.flatData[idx++] = baseFactors.fxRates[i] * std::exp(fxVol * fxShock * sqrtTime - 0.5 * fxVol * fxVol * timeYears);
+                    scenarios(t, p, idx++) = baseFactors.fxRates[i] * std::exp(fxVol * fxShock * sqrtTime - 0.5 * fxVol * fxVol * timeYears);
                 }
 
                 // Counterparty credit spreads (55-64)
                 double cptyShock = dist(gen);
                 for (Size i = 0; i < 10 && idx < config.numRiskFactors; ++i) {
-                    sc.flatData[idx++] = baseFactors.counterpartySpreads[i] * std::exp(creditVol * cptyShock * sqrtTime);
+                    scenarios(t, p, idx++) = baseFactors.counterpartySpreads[i] * std::exp(creditVol * cptyShock * sqrtTime);
                 }
 
                 // Own credit spreads (65-74)
                 double ownShock = dist(gen);
                 for (Size i = 0; i < 10 && idx < config.numRiskFactors; ++i) {
-                    sc.flatData[idx++] = baseFactors.ownSpreads[i] * std::exp(creditVol * ownShock * sqrtTime);
+                    scenarios(t, p, idx++) = baseFactors.ownSpreads[i] * std::exp(creditVol * ownShock * sqrtTime);
                 }
 
                 // Vol surface (75-99)
                 double volShock = dist(gen);
                 for (Size i = 0; i < 25 && idx < config.numRiskFactors; ++i) {
-                    sc.flatData[idx++] = baseFactors.volSurface[i] * std::exp(volVol * volShock * sqrtTime);
+                    scenarios(t, p, idx++) = baseFactors.volSurface[i] * std::exp(volVol * volShock * sqrtTime);
                 }
             }
         }
+        scenarios.padTails();
         return scenarios;
     }
 
@@ -510,8 +512,9 @@ namespace {
         }
 
         Real lgd = Real(0.4);
-        Real exposure = baseNpv > Real(0.0) ? baseNpv : Real(0.0);
-        Real negExposure = baseNpv < Real(0.0) ? -baseNpv : Real(0.0);
+        // recorded selections: the kernel stays valid when the NPV changes sign
+        Real exposure = forge::expr::positive_part(baseNpv);
+        Real negExposure = forge::expr::negative_part(baseNpv);
 
         Real cvaAdj = Real(0.0);
         Real dvaAdj = Real(0.0);
@@ -555,7 +558,7 @@ namespace {
     XvaResults computeBumpReval(
         const XvaConfig& config,
         const std::vector<SwapDefinition>& swaps,
-        const std::vector<std::vector<MarketScenario>>& scenarios,
+        const ForgeScenarioCube& scenarios,
         const std::vector<IRPillar>& pillars,
         const Date& today,
         const Calendar& calendar,
@@ -564,26 +567,28 @@ namespace {
 
         XvaResults results;
         results.exposures.resize(config.numSwaps);
-        results.sensitivities.resize(config.numSwaps);
+        results.sensitivities = ForgeSensitivityTensor(
+            config.numSwaps, config.numTimeSteps, config.numPaths, config.numRiskFactors, config.sensitivityLayout);
+        std::vector<double> pathSensitivities(config.numRiskFactors);
 
         double totalExposure = 0.0;
         Size totalEvaluations = 0;
         Size numScenarios = 0;
+        std::vector<Real> realInputs(config.numRiskFactors);
 
         auto startTime = std::chrono::high_resolution_clock::now();
 
         for (Size s = 0; s < config.numSwaps; ++s) {
             results.exposures[s].resize(config.numTimeSteps);
-            results.sensitivities[s].resize(config.numTimeSteps);
 
             for (Size t = 0; t < config.numTimeSteps; ++t) {
                 results.exposures[s][t].resize(config.numPaths);
-                results.sensitivities[s][t].resize(config.numPaths);
 
                 for (Size p = 0; p < config.numPaths; ++p) {
-                    const auto& scenario = scenarios[t][p];
-                    std::vector<double> flatInputs = scenario.flatten();
-                    std::vector<Real> realInputs(flatInputs.begin(), flatInputs.end());
+                    auto scenario = scenarios.path(t, p);
+                    for (Size i = 0; i < config.numRiskFactors; ++i) {
+                        realInputs[i] = scenario[i];
+                    }
 
                     double baseNpv = value(priceSwap(
                         swaps[s], t, config.numTimeSteps, realInputs, pillars, today, calendar, dayCounter, config.numRiskFactors));
@@ -592,15 +597,16 @@ namespace {
                     results.exposures[s][t][p] = std::max(0.0, baseNpv);
                     totalExposure += results.exposures[s][t][p];
 
-                    results.sensitivities[s][t][p].resize(config.numRiskFactors);
                     for (Size i = 0; i < config.numRiskFactors; ++i) {
-                        std::vector<Real> bumpedInputs = realInputs;
-                        bumpedInputs[i] += config.bumpSize;
+                        // Bump in place and restore, instead of copying the inputs per bump
+                        realInputs[i] = scenario[i] + config.bumpSize;
                         double bumpedNpv = value(priceSwap(
-                            swaps[s], t, config.numTimeSteps, bumpedInputs, pillars, today, calendar, dayCounter, config.numRiskFactors));
+                            swaps[s], t, config.numTimeSteps, realInputs, pillars, today, calendar, dayCounter, config.numRiskFactors));
+                        realInputs[i] = scenario[i];
                         totalEvaluations++;
-                        results.sensitivities[s][t][p][i] = (bumpedNpv - baseNpv) / config.bumpSize;
+                        pathSensitivities[i] = (bumpedNpv - baseNpv) / config.bumpSize;
                     }
+                    results.sensitivities.addPath(s, t, p, pathSensitivities.data());
                     numScenarios++;
                 }
             }
@@ -630,7 +636,7 @@ namespace {
     XvaResults computeForgeKernelBumpReval(
         const XvaConfig& config,
         const std::vector<SwapDefinition>& swaps,
-        const std::vector<std::vector<MarketScenario>>& scenarios,
+        const ForgeScenarioCube& scenarios,
         const std::vector<IRPillar>& pillars,
         const Date& today,
         const Calendar& calendar,
@@ -639,7 +645,9 @@ namespace {
 
         XvaResults results;
         results.exposures.resize(config.numSwaps);
-        results.sensitivities.resize(config.numSwaps);
+        results.sensitivities = ForgeSensitivityTensor(
+            config.numSwaps, config.numTimeSteps, config.numPaths, config.numRiskFactors, config.sensitivityLayout);
+        std::vector<double> pathSensitivities(config.numRiskFactors);
 
         double totalExposure = 0.0;
         Size numKernels = 0;
@@ -648,13 +656,20 @@ namespace {
         double totalKernelCreationUs = 0.0;
         double totalEvalUs = 0.0;
 
+        // Configure compiler with all optimizations enabled
+        forge::CompilerConfig compilerConfig;
+        compilerConfig.enableOptimizations = true;
+        compilerConfig.enableCSE = true;
+        compilerConfig.enableAlgebraicSimplification = true;
+        compilerConfig.enableInactiveFolding = true;
+        compilerConfig.enableStabilityCleaning = true;
+        ForgeKernelCache kernelCache(compilerConfig);
+
         for (Size s = 0; s < config.numSwaps; ++s) {
             results.exposures[s].resize(config.numTimeSteps);
-            results.sensitivities[s].resize(config.numTimeSteps);
 
             for (Size t = 0; t < config.numTimeSteps; ++t) {
                 results.exposures[s][t].resize(config.numPaths);
-                results.sensitivities[s][t].resize(config.numPaths);
 
                 // --- KERNEL CREATION ---
                 auto kernelStartTime = std::chrono::high_resolution_clock::now();
@@ -662,7 +677,7 @@ namespace {
                 forge::GraphRecorder recorder;
                 recorder.start();
 
-                std::vector<double> flatInputs = scenarios[t][0].flatten();
+                auto flatInputs = scenarios.path(t, 0);
                 std::vector<Real> rateInputs(config.numRiskFactors);
                 std::vector<forge::NodeId> rateNodeIds(config.numRiskFactors);
                 for (Size i = 0; i < config.numRiskFactors; ++i) {
@@ -676,30 +691,23 @@ namespace {
                 forge::NodeId npvNodeId = npv.forgeNodeId();
 
                 recorder.stop();
-                forge::Graph graph = recorder.graph();
-
-                // Configure compiler with all optimizations enabled
-                forge::CompilerConfig compilerConfig;
-                compilerConfig.enableOptimizations = true;
-                compilerConfig.enableCSE = true;
-                compilerConfig.enableAlgebraicSimplification = true;
-                compilerConfig.enableInactiveFolding = true;
-                compilerConfig.enableStabilityCleaning = true;
-                forge::ForgeEngine compiler(compilerConfig);
-                auto kernel = compiler.compile(graph);
-                auto buffer = forge::NodeValueBufferFactory::create(graph, *kernel);
+
+                // Structurally identical graphs share one compiled kernel
+                auto cached = kernelCache.acquire(recorder.graph());
+                auto kernel = cached.kernel;
+                auto buffer = std::move(cached.buffer);
 
                 auto kernelEndTime = std::chrono::high_resolution_clock::now();
                 totalKernelCreationUs += std::chrono::duration_cast<std::chrono::microseconds>(kernelEndTime - kernelStartTime).count();
-                numKernels++;
+                if (!cached.hit)
+                    numKernels++;
 
                 // --- EVALUATION ---
                 auto evalStartTime = std::chrono::high_resolution_clock::now();
                 int vectorWidth = buffer->getVectorWidth();
 
                 for (Size p = 0; p < config.numPaths; ++p) {
-                    const auto& scenario = scenarios[t][p];
-                    std::vector<double> scenarioInputs = scenario.flatten();
+                    auto scenarioInputs = scenarios.path(t, p);
 
                     for (Size i = 0; i < config.numRiskFactors; ++i) {
                         double inputVal[4] = {scenarioInputs[i], scenarioInputs[i], scenarioInputs[i], scenarioInputs[i]};
@@ -714,7 +722,6 @@ namespace {
                     results.exposures[s][t][p] = std::max(0.0, baseNpv);
                     totalExposure += results.exposures[s][t][p];
 
-                    results.sensitivities[s][t][p].resize(config.numRiskFactors);
                     for (Size i = 0; i < config.numRiskFactors; ++i) {
                         double bumpedInputVal[4] = {scenarioInputs[i] + config.bumpSize, scenarioInputs[i] + config.bumpSize, scenarioInputs[i] + config.bumpSize, scenarioInputs[i] + config.bumpSize};
                         buffer->setLanes(rateNodeIds[i], bumpedInputVal);
@@ -724,11 +731,12 @@ namespace {
                         double bumpedOutputVal[4];
                         buffer->getLanes(npvNodeId, bumpedOutputVal);
                         double bumpedNpv = bumpedOutputVal[0];
-                        results.sensitivities[s][t][p][i] = (bumpedNpv - baseNpv) / config.bumpSize;
+                        pathSensitivities[i] = (bumpedNpv - baseNpv) / config.bumpSize;
 
                         double restoreVal[4] = {scenarioInputs[i], scenarioInputs[i], scenarioInputs[i], scenarioInputs[i]};
                         buffer->setLanes(rateNodeIds[i], restoreVal);
                     }
+                    results.sensitivities.addPath(s, t, p, pathSensitivities.data());
                     numScenarios++;
                 }
 
@@ -757,7 +765,7 @@ namespace {
     XvaResults computeForgeForwardBumpRevalImpl(
         const XvaConfig& config,
         const std::vector<SwapDefinition>& swaps,
-        const std::vector<std::vector<MarketScenario>>& scenarios,
+        const ForgeScenarioCube& scenarios,
         const std::vector<IRPillar>& pillars,
         const Date& today,
         const Calendar& calendar,
@@ -768,7 +776,8 @@ namespace {
 
         XvaResults results;
         results.exposures.resize(config.numSwaps);
-        results.sensitivities.resize(config.numSwaps);
+        results.sensitivities = ForgeSensitivityTensor(
+            config.numSwaps, config.numTimeSteps, config.numPaths, config.numRiskFactors, config.sensitivityLayout);
 
         double totalExposure = 0.0;
         Size numKernels = 0;
@@ -777,13 +786,16 @@ namespace {
         double totalKernelCreationUs = 0.0;
         double totalEvalUs = 0.0;
 
+        // Configure compiler based on optimization mode and instruction set
+        forge::CompilerConfig compilerConfig = configureOptimizations(optMode);
+        compilerConfig.instructionSet = instructionSet;
+        ForgeKernelCache kernelCache(compilerConfig);
+
         for (Size s = 0; s < config.numSwaps; ++s) {
             results.exposures[s].resize(config.numTimeSteps);
-            results.sensitivities[s].resize(config.numTimeSteps);
 
             for (Size t = 0; t < config.numTimeSteps; ++t) {
                 results.exposures[s][t].resize(config.numPaths);
-                results.sensitivities[s][t].resize(config.numPaths);
 
                 // --- KERNEL CREATION ---
                 auto kernelStartTime = std::chrono::high_resolution_clock::now();
@@ -791,7 +803,7 @@ namespace {
                 forge::GraphRecorder recorder;
                 recorder.start();
 
-                std::vector<double> flatInputs = scenarios[t][0].flatten();
+                auto flatInputs = scenarios.path(t, 0);
                 std::vector<Real> rateInputs(config.numRiskFactors);
                 std::vector<forge::NodeId> rateNodeIds(config.numRiskFactors);
                 for (Size i = 0; i < config.numRiskFactors; ++i) {
@@ -805,58 +817,37 @@ namespace {
                 forge::NodeId npvNodeId = npv.forgeNodeId();
 
                 recorder.stop();
-                forge::Graph graph = recorder.graph();
 
-                // Configure compiler based on optimization mode and instruction set
-                forge::CompilerConfig compilerConfig = configureOptimizations(optMode);
-                compilerConfig.instructionSet = instructionSet;
-                forge::ForgeEngine compiler(compilerConfig);
-                auto kernel = compiler.compile(graph);
-                auto buffer = forge::NodeValueBufferFactory::create(graph, *kernel);
+                // Structurally identical graphs share one compiled kernel
+                auto cached = kernelCache.acquire(recorder.graph());
+                auto kernel = cached.kernel;
+                auto buffer = std::move(cached.buffer);
 
                 auto kernelEndTime = std::chrono::high_resolution_clock::now();
                 totalKernelCreationUs += std::chrono::duration_cast<std::chrono::microseconds>(kernelEndTime - kernelStartTime).count();
-                numKernels++;
+                if (!cached.hit)
+                    numKernels++;
 
                 // --- EVALUATION ---
+                // The base scenario and one bump per risk factor share the
+                // lanes of each execution (numRF + 1 lanes per path)
                 auto evalStartTime = std::chrono::high_resolution_clock::now();
-                int vectorWidth = buffer->getVectorWidth();
-
-                for (Size p = 0; p < config.numPaths; ++p) {
-                    const auto& scenario = scenarios[t][p];
-                    std::vector<double> scenarioInputs = scenario.flatten();
 
-                    for (Size i = 0; i < config.numRiskFactors; ++i) {
-                        double inputVal[4] = {scenarioInputs[i], scenarioInputs[i], scenarioInputs[i], scenarioInputs[i]};
-                        buffer->setLanes(rateNodeIds[i], inputVal);
-                    }
-                    kernel->execute(*buffer);
-                    numEvaluations++;
-
-                    double outputVal[4];
-                    buffer->getLanes(npvNodeId, outputVal);
-                    double baseNpv = outputVal[0];
-                    results.exposures[s][t][p] = std::max(0.0, baseNpv);
-                    totalExposure += results.exposures[s][t][p];
-
-                    // Compute sensitivities via bump-reval (no AAD)
-                    results.sensitivities[s][t][p].resize(config.numRiskFactors);
-                    for (Size i = 0; i < config.numRiskFactors; ++i) {
-                        double bumpedInputVal[4] = {scenarioInputs[i] + config.bumpSize, scenarioInputs[i] + config.bumpSize, scenarioInputs[i] + config.bumpSize, scenarioInputs[i] + config.bumpSize};
-                        buffer->setLanes(rateNodeIds[i], bumpedInputVal);
-                        kernel->execute(*buffer);
-                        numEvaluations++;
-
-                        double bumpedOutputVal[4];
-                        buffer->getLanes(npvNodeId, bumpedOutputVal);
-                        double bumpedNpv = bumpedOutputVal[0];
-                        results.sensitivities[s][t][p][i] = (bumpedNpv - baseNpv) / config.bumpSize;
-
-                        double restoreVal[4] = {scenarioInputs[i], scenarioInputs[i], scenarioInputs[i], scenarioInputs[i]};
-                        buffer->setLanes(rateNodeIds[i], restoreVal);
+                forgeWithBatchWidth(buffer->getVectorWidth(), [&](auto w) {
+                    constexpr Size W = decltype(w)::value;
+                    ForgeBumpBatch<W> bumps(*kernel, *buffer, rateNodeIds, {npvNodeId},
+                                            config.bumpSize);
+                    for (Size p = 0; p < config.numPaths; ++p) {
+                        auto scenarioInputs = scenarios.path(t, p);
+                        double baseNpv = bumps.evaluate(scenarioInputs.data(), scenarioInputs.stride(),
+                                                        results.sensitivities, s, t, p);
+                        numEvaluations += bumps.executions();
+
+                        results.exposures[s][t][p] = std::max(0.0, baseNpv);
+                        totalExposure += results.exposures[s][t][p];
+                        numScenarios++;
                     }
-                    numScenarios++;
-                }
+                });
 
                 auto evalEndTime = std::chrono::high_resolution_clock::now();
                 totalEvalUs += std::chrono::duration_cast<std::chrono::microseconds>(evalEndTime - evalStartTime).count();
@@ -883,7 +874,7 @@ namespace {
     XvaResults computeForgeAadSSE2Impl(
         const XvaConfig& config,
         const std::vector<SwapDefinition>& swaps,
-        const std::vector<std::vector<MarketScenario>>& scenarios,
+        const ForgeScenarioCube& scenarios,
         const std::vector<IRPillar>& pillars,
         const Date& today,
         const Calendar& calendar,
@@ -893,7 +884,9 @@ namespace {
 
         XvaResults results;
         results.exposures.resize(config.numSwaps);
-        results.sensitivities.resize(config.numSwaps);
+        results.sensitivities = ForgeSensitivityTensor(
+            config.numSwaps, config.numTimeSteps, config.numPaths, config.numRiskFactors, config.sensitivityLayout);
+        std::vector<double> pathSensitivities(config.numRiskFactors);
 
         double totalExposure = 0.0;
         Size numKernels = 0;
@@ -906,13 +899,16 @@ namespace {
         double totalGetOutputsUs = 0.0;
         double totalGetGradientsUs = 0.0;
 
+        // Configure the compiler for SSE2 scalar
+        forge::CompilerConfig compilerConfig = configureOptimizations(optMode);
+        compilerConfig.instructionSet = forge::CompilerConfig::InstructionSet::SSE2_SCALAR;
+        ForgeKernelCache kernelCache(compilerConfig);
+
         for (Size s = 0; s < config.numSwaps; ++s) {
             results.exposures[s].resize(config.numTimeSteps);
-            results.sensitivities[s].resize(config.numTimeSteps);
 
             for (Size t = 0; t < config.numTimeSteps; ++t) {
                 results.exposures[s][t].resize(config.numPaths);
-                results.sensitivities[s][t].resize(config.numPaths);
 
                 // --- KERNEL CREATION ---
                 auto kernelStartTime = std::chrono::high_resolution_clock::now();
@@ -920,7 +916,7 @@ namespace {
                 forge::GraphRecorder recorder;
                 recorder.start();
 
-                std::vector<double> flatInputs = scenarios[t][0].flatten();
+                auto flatInputs = scenarios.path(t, 0);
                 std::vector<Real> rateInputs(config.numRiskFactors);
                 std::vector<forge::NodeId> rateNodeIds(config.numRiskFactors);
                 for (Size i = 0; i < config.numRiskFactors; ++i) {
@@ -934,15 +930,11 @@ namespace {
                 forge::NodeId npvNodeId = npv.forgeNodeId();
 
                 recorder.stop();
-                forge::Graph graph = recorder.graph();
-
-                // Configure the compiler for SSE2 scalar
-                forge::CompilerConfig compilerConfig = configureOptimizations(optMode);
-                compilerConfig.instructionSet = forge::CompilerConfig::InstructionSet::SSE2_SCALAR;
 
-                forge::ForgeEngine compiler(compilerConfig);
-                auto kernel = compiler.compile(graph);
-                auto buffer = forge::NodeValueBufferFactory::create(graph, *kernel);
+                // Structurally identical graphs share one compiled kernel
+                auto cached = kernelCache.acquire(recorder.graph());
+                auto kernel = cached.kernel;
+                auto buffer = std::move(cached.buffer);
 
                 // Pre-compute gradient buffer indices (vectorWidth=1 for SSE2)
                 int vectorWidth = buffer->getVectorWidth();
@@ -953,7 +945,8 @@ namespace {
 
                 auto kernelEndTime = std::chrono::high_resolution_clock::now();
                 totalKernelCreationUs += std::chrono::duration_cast<std::chrono::microseconds>(kernelEndTime - kernelStartTime).count();
-                numKernels++;
+                if (!cached.hit)
+                    numKernels++;
 
                 // --- EVALUATION (1 scenario per execution) ---
                 auto evalStartTime = std::chrono::high_resolution_clock::now();
@@ -962,8 +955,7 @@ namespace {
                 std::vector<double> gradOutput(config.numRiskFactors * vectorWidth);
 
                 for (Size p = 0; p < config.numPaths; ++p) {
-                    const auto& scenario = scenarios[t][p];
-                    std::vector<double> scenarioInputs = scenario.flatten();
+                    auto scenarioInputs = scenarios.path(t, p);
 
                     // Set inputs (vectorWidth values per node)
                     auto setInputsStart = std::chrono::high_resolution_clock::now();
@@ -995,10 +987,10 @@ namespace {
                     auto getGradientsStart = std::chrono::high_resolution_clock::now();
                     buffer->getGradientLanes(gradientIndices, gradOutput.data());
                     // For scalar mode, gradOutput is just the gradients directly
-                    results.sensitivities[s][t][p].resize(config.numRiskFactors);
                     for (Size i = 0; i < config.numRiskFactors; ++i) {
-                        results.sensitivities[s][t][p][i] = gradOutput[i * vectorWidth];
+                        pathSensitivities[i] = gradOutput[i * vectorWidth];
                     }
+                    results.sensitivities.addPath(s, t, p, pathSensitivities.data());
                     auto getGradientsEnd = std::chrono::high_resolution_clock::now();
                     totalGetGradientsUs += std::chrono::duration_cast<std::chrono::nanoseconds>(getGradientsEnd - getGradientsStart).count() / 1000.0;
 
@@ -1035,7 +1027,7 @@ namespace {
     XvaResults computeForgeAadAVX2Impl(
         const XvaConfig& config,
         const std::vector<SwapDefinition>& swaps,
-        const std::vector<std::vector<MarketScenario>>& scenarios,
+        const ForgeScenarioCube& scenarios,
         const std::vector<IRPillar>& pillars,
         const Date& today,
         const Calendar& calendar,
@@ -1045,7 +1037,8 @@ namespace {
 
         XvaResults results;
         results.exposures.resize(config.numSwaps);
-        results.sensitivities.resize(config.numSwaps);
+        results.sensitivities = ForgeSensitivityTensor(
+            config.numSwaps, config.numTimeSteps, config.numPaths, config.numRiskFactors, config.sensitivityLayout);
 
         double totalExposure = 0.0;
         Size numKernels = 0;
@@ -1058,20 +1051,19 @@ namespace {
         double totalGetOutputsUs = 0.0;
         double totalGetGradientsUs = 0.0;
 
-        const int VECTOR_WIDTH = 4;  // AVX2 processes 4 doubles at a time
+        const Size VECTOR_WIDTH = 4;  // AVX2 processes 4 doubles at a time
+        QL_REQUIRE(scenarios.laneWidth() == VECTOR_WIDTH, "scenario cube is not interleaved for AVX2");
+
+        // Configure the compiler for AVX2 packed (4-wide)
+        forge::CompilerConfig compilerConfig = configureOptimizations(optMode);
+        compilerConfig.instructionSet = forge::CompilerConfig::InstructionSet::AVX2_PACKED;
+        ForgeKernelCache kernelCache(compilerConfig);
 
         for (Size s = 0; s < config.numSwaps; ++s) {
             results.exposures[s].resize(config.numTimeSteps);
-            results.sensitivities[s].resize(config.numTimeSteps);
 
             for (Size t = 0; t < config.numTimeSteps; ++t) {
                 results.exposures[s][t].resize(config.numPaths);
-                results.sensitivities[s][t].resize(config.numPaths);
-
-                // Pre-allocate sensitivities for all paths to avoid allocation in hot loop
-                for (Size p = 0; p < config.numPaths; ++p) {
-                    results.sensitivities[s][t][p].resize(config.numRiskFactors);
-                }
 
                 // --- KERNEL CREATION ---
                 auto kernelStartTime = std::chrono::high_resolution_clock::now();
@@ -1079,7 +1071,7 @@ namespace {
                 forge::GraphRecorder recorder;
                 recorder.start();
 
-                std::vector<double> flatInputs = scenarios[t][0].flatten();
+                auto flatInputs = scenarios.path(t, 0);
                 std::vector<Real> rateInputs(config.numRiskFactors);
                 std::vector<forge::NodeId> rateNodeIds(config.numRiskFactors);
                 for (Size i = 0; i < config.numRiskFactors; ++i) {
@@ -1093,159 +1085,56 @@ namespace {
                 forge::NodeId npvNodeId = npv.forgeNodeId();
 
                 recorder.stop();
-                forge::Graph graph = recorder.graph();
-
-                // Configure the compiler for AVX2 packed (4-wide)
-                forge::CompilerConfig compilerConfig = configureOptimizations(optMode);
-                compilerConfig.instructionSet = forge::CompilerConfig::InstructionSet::AVX2_PACKED;
 
-                forge::ForgeEngine compiler(compilerConfig);
-                auto kernel = compiler.compile(graph);
-                auto buffer = forge::NodeValueBufferFactory::create(graph, *kernel);
+                // Structurally identical graphs share one compiled kernel
+                auto cached = kernelCache.acquire(recorder.graph());
+                auto kernel = cached.kernel;
+                auto buffer = std::move(cached.buffer);
 
-                // Pre-compute buffer indices for optimized access (no mapping in hot loop)
-                // NOTE: These methods require PATCHED Forge
-                std::vector<size_t> gradientIndices(config.numRiskFactors);
-                std::vector<size_t> inputIndices(config.numRiskFactors);
-                bool allIndicesValid = true;
-                Size invalidCount = 0;
-                for (Size i = 0; i < config.numRiskFactors; ++i) {
-                    gradientIndices[i] = buffer->getBufferIndex(rateNodeIds[i]);
-                    inputIndices[i] = gradientIndices[i];  // Same indices for inputs
-                    if (gradientIndices[i] == SIZE_MAX) {
-                        allIndicesValid = false;
-                        invalidCount++;
-                    }
-                }
-                size_t outputIndex = buffer->getBufferIndex(npvNodeId);
-                if (outputIndex == SIZE_MAX) {
-                    allIndicesValid = false;
-                    invalidCount++;
-                }
-
-                // Report once per kernel if falling back to vanilla API
+                // Lane-batched evaluator: transposition, tail padding and the
+                // direct-pointer / setLanes fallback live in ql/forge/batchevaluator.hpp
+                ForgeBatchEvaluator<VECTOR_WIDTH> evaluator(*kernel, *buffer, rateNodeIds, {npvNodeId}, rateNodeIds);
                 static bool reportedFallback = false;
-                if (!allIndicesValid && !reportedFallback) {
-                    std::cerr << "[AVX2 PATCHED] Warning: " << invalidCount
-                              << " invalid buffer indices, using fallback API" << std::endl;
+                if (!evaluator.direct() && !reportedFallback) {
+                    std::cerr << "[AVX2 PATCHED] Warning: invalid buffer indices, using fallback API" << std::endl;
                     reportedFallback = true;
                 }
 
-                // Get raw buffer pointer for direct memory access (Option 6 optimization)
-                double* valuesPtr = buffer->getValuesPtr();
-                double* gradientsPtr = buffer->getGradientsPtr();
-
                 auto kernelEndTime = std::chrono::high_resolution_clock::now();
                 totalKernelCreationUs += std::chrono::duration_cast<std::chrono::microseconds>(kernelEndTime - kernelStartTime).count();
-                numKernels++;
+                if (!cached.hit)
+                    numKernels++;
 
                 // --- EVALUATION (4 scenarios per execution using SIMD) ---
                 auto evalStartTime = std::chrono::high_resolution_clock::now();
 
-                // Pre-allocate working buffers (reused across batches)
                 double npvValues[VECTOR_WIDTH];
 
-                // Process paths in batches of 4
-                Size numBatches = (config.numPaths + VECTOR_WIDTH - 1) / VECTOR_WIDTH;
-
-                // =================================================================
-                // PRE-TRANSPOSE all scenario data for this timestep (ONCE per timestep)
-                // =================================================================
-                // Layout: transposedInputs[batch * numRF * 4 + rf * 4 + lane]
-                // This allows fast _mm256_load_pd instead of slow _mm256_set_pd gather
-
-                // Allocate aligned buffer for AVX2 loads (32-byte alignment)
-                size_t transposedSize = numBatches * config.numRiskFactors * VECTOR_WIDTH;
-                double* transposedInputs = static_cast<double*>(
-#ifdef _WIN32
-                    _aligned_malloc(transposedSize * sizeof(double), 32)
-#else
-                    aligned_alloc(32, transposedSize * sizeof(double))
-#endif
-                );
-
-                // Transpose: convert from [scenario][riskFactor] to [batch][riskFactor][lane]
-                for (Size batch = 0; batch < numBatches; ++batch) {
-                    Size batchStart = batch * VECTOR_WIDTH;
-                    Size batchSize = std::min(static_cast<Size>(VECTOR_WIDTH), config.numPaths - batchStart);
-                    size_t batchBase = batch * config.numRiskFactors * VECTOR_WIDTH;
-
-                    for (Size rf = 0; rf < config.numRiskFactors; ++rf) {
-                        size_t rfBase = batchBase + rf * VECTOR_WIDTH;
-                        // Copy actual scenario values
-                        for (Size lane = 0; lane < batchSize; ++lane) {
-                            transposedInputs[rfBase + lane] = scenarios[t][batchStart + lane].flatData[rf];
-                        }
-                        // Pad remaining lanes with last valid value
-                        for (Size lane = batchSize; lane < VECTOR_WIDTH; ++lane) {
-                            transposedInputs[rfBase + lane] = transposedInputs[rfBase + batchSize - 1];
-                        }
-                    }
-                }
-
-                for (Size batch = 0; batch < numBatches; ++batch) {
-                    Size batchStart = batch * VECTOR_WIDTH;
+                for (Size batchStart = 0; batchStart < config.numPaths; batchStart += VECTOR_WIDTH) {
                     Size batchSize = std::min(static_cast<Size>(VECTOR_WIDTH), config.numPaths - batchStart);
 
-                    // Calculate base offset into transposed buffer for this batch
-                    size_t transposedBase = batch * config.numRiskFactors * VECTOR_WIDTH;
-
-                    // Set inputs: DIRECT WRITE with PRE-TRANSPOSED data
+                    // Set inputs: transpose the batch straight into the buffer lanes
                     auto setInputsStart = std::chrono::high_resolution_clock::now();
-                    if (allIndicesValid && valuesPtr) {
-                        for (Size i = 0; i < config.numRiskFactors; ++i) {
-                            __m256d vals = _mm256_load_pd(&transposedInputs[transposedBase + i * VECTOR_WIDTH]);
-                            _mm256_store_pd(&valuesPtr[inputIndices[i]], vals);
-                        }
-                    } else {
-                        // Fallback: use setLanes (AVX2: 4 values)
-                        double vectorInput[VECTOR_WIDTH];
-                        for (Size i = 0; i < config.numRiskFactors; ++i) {
-                            vectorInput[0] = transposedInputs[transposedBase + i * VECTOR_WIDTH + 0];
-                            vectorInput[1] = transposedInputs[transposedBase + i * VECTOR_WIDTH + 1];
-                            vectorInput[2] = transposedInputs[transposedBase + i * VECTOR_WIDTH + 2];
-                            vectorInput[3] = transposedInputs[transposedBase + i * VECTOR_WIDTH + 3];
-                            buffer->setLanes(rateNodeIds[i], vectorInput);
-                        }
-                    }
+                    evaluator.loadInterleaved(scenarios.batch(t, batchStart / VECTOR_WIDTH), batchSize);
                     auto setInputsEnd = std::chrono::high_resolution_clock::now();
                     totalSetInputsUs += std::chrono::duration_cast<std::chrono::nanoseconds>(setInputsEnd - setInputsStart).count() / 1000.0;
 
                     // Execute kernel - processes all 4 scenarios in parallel
                     auto executeStart = std::chrono::high_resolution_clock::now();
-                    kernel->execute(*buffer);
+                    evaluator.execute();
                     auto executeEnd = std::chrono::high_resolution_clock::now();
                     totalExecuteKernelUs += std::chrono::duration_cast<std::chrono::nanoseconds>(executeEnd - executeStart).count() / 1000.0;
                     numEvaluations++;
 
-                    // Get 4 output values
+                    // Get output values of the valid lanes
                     auto getOutputsStart = std::chrono::high_resolution_clock::now();
-                    if (allIndicesValid && valuesPtr) {
-                        npvValues[0] = valuesPtr[outputIndex + 0];
-                        npvValues[1] = valuesPtr[outputIndex + 1];
-                        npvValues[2] = valuesPtr[outputIndex + 2];
-                        npvValues[3] = valuesPtr[outputIndex + 3];
-                    } else {
-                        buffer->getLanes(npvNodeId, npvValues);
-                    }
+                    evaluator.readOutputs(npvValues, 1);
                     auto getOutputsEnd = std::chrono::high_resolution_clock::now();
                     totalGetOutputsUs += std::chrono::duration_cast<std::chrono::nanoseconds>(getOutputsEnd - getOutputsStart).count() / 1000.0;
 
-                    // Get gradients for all 4 lanes (interleaved layout)
+                    // Get gradients of the valid lanes straight into the tensor (or its path sums)
                     auto getGradientsStart = std::chrono::high_resolution_clock::now();
-                    // getGradientLanes returns interleaved: [node0_lane0..3, node1_lane0..3, ...]
-                    std::vector<double> gradOutputInterleaved(config.numRiskFactors * VECTOR_WIDTH);
-                    buffer->getGradientLanes(gradientIndices, gradOutputInterleaved.data());
-
-                    // Distribute to per-scenario results
-                    for (Size b = 0; b < batchSize; ++b) {
-                        Size p = batchStart + b;
-                        results.sensitivities[s][t][p].resize(config.numRiskFactors);
-                        for (Size i = 0; i < config.numRiskFactors; ++i) {
-                            // Interleaved layout: node i, lane b is at index i * VECTOR_WIDTH + b
-                            results.sensitivities[s][t][p][i] = gradOutputInterleaved[i * VECTOR_WIDTH + b];
-                        }
-                    }
+                    results.sensitivities.add(s, t, batchStart, evaluator);
                     auto getGradientsEnd = std::chrono::high_resolution_clock::now();
                     totalGetGradientsUs += std::chrono::duration_cast<std::chrono::nanoseconds>(getGradientsEnd - getGradientsStart).count() / 1000.0;
 
@@ -1258,13 +1147,6 @@ namespace {
                     }
                 }
 
-                // Free the transposed buffer for this timestep
-#ifdef _WIN32
-                _aligned_free(transposedInputs);
-#else
-                free(transposedInputs);
-#endif
-
                 auto evalEndTime = std::chrono::high_resolution_clock::now();
                 totalEvalUs += std::chrono::duration_cast<std::chrono::microseconds>(evalEndTime - evalStartTime).count();
             }
@@ -1294,7 +1176,7 @@ namespace {
     XvaResults computeForgeForwardSSE2Stability(
         const XvaConfig& config,
         const std::vector<SwapDefinition>& swaps,
-        const std::vector<std::vector<MarketScenario>>& scenarios,
+        const ForgeScenarioCube& scenarios,
         const std::vector<IRPillar>& pillars,
         const Date& today,
         const Calendar& calendar,
@@ -1307,7 +1189,7 @@ namespace {
     XvaResults computeForgeForwardSSE2AllOpt(
         const XvaConfig& config,
         const std::vector<SwapDefinition>& swaps,
-        const std::vector<std::vector<MarketScenario>>& scenarios,
+        const ForgeScenarioCube& scenarios,
         const std::vector<IRPillar>& pillars,
         const Date& today,
         const Calendar& calendar,
@@ -1320,7 +1202,7 @@ namespace {
     XvaResults computeForgeForwardAVX2Stability(
         const XvaConfig& config,
         const std::vector<SwapDefinition>& swaps,
-        const std::vector<std::vector<MarketScenario>>& scenarios,
+        const ForgeScenarioCube& scenarios,
         const std::vector<IRPillar>& pillars,
         const Date& today,
         const Calendar& calendar,
@@ -1333,7 +1215,7 @@ namespace {
     XvaResults computeForgeForwardAVX2AllOpt(
         const XvaConfig& config,
         const std::vector<SwapDefinition>& swaps,
-        const std::vector<std::vector<MarketScenario>>& scenarios,
+        const ForgeScenarioCube& scenarios,
         const std::vector<IRPillar>& pillars,
         const Date& today,
         const Calendar& calendar,
@@ -1351,7 +1233,7 @@ namespace {
     XvaResults computeForgeAadSSE2Stability(
         const XvaConfig& config,
         const std::vector<SwapDefinition>& swaps,
-        const std::vector<std::vector<MarketScenario>>& scenarios,
+        const ForgeScenarioCube& scenarios,
         const std::vector<IRPillar>& pillars,
         const Date& today,
         const Calendar& calendar,
@@ -1364,7 +1246,7 @@ namespace {
     XvaResults computeForgeAadSSE2(
         const XvaConfig& config,
         const std::vector<SwapDefinition>& swaps,
-        const std::vector<std::vector<MarketScenario>>& scenarios,
+        const ForgeScenarioCube& scenarios,
         const std::vector<IRPillar>& pillars,
         const Date& today,
         const Calendar& calendar,
@@ -1377,7 +1259,7 @@ namespace {
     XvaResults computeForgeAadAVX2Stability(
         const XvaConfig& config,
         const std::vector<SwapDefinition>& swaps,
-        const std::vector<std::vector<MarketScenario>>& scenarios,
+        const ForgeScenarioCube& scenarios,
         const std::vector<IRPillar>& pillars,
         const Date& today,
         const Calendar& calendar,
@@ -1390,7 +1272,7 @@ namespace {
     XvaResults computeForgeAadAVX2(
         const XvaConfig& config,
         const std::vector<SwapDefinition>& swaps,
-        const std::vector<std::vector<MarketScenario>>& scenarios,
+        const ForgeScenarioCube& scenarios,
         const std::vector<IRPillar>& pillars,
         const Date& today,
         const Calendar& calendar,
@@ -1407,7 +1289,7 @@ namespace {
         ComputeFunc computeFunc,
         const XvaConfig& config,
         const std::vector<SwapDefinition>& swaps,
-        const std::vector<std::vector<MarketScenario>>& scenarios,
+        const ForgeScenarioCube& scenarios,
         const std::vector<IRPillar>& pillars,
         const Date& today,
         const Calendar& calendar,
@@ -1716,6 +1598,14 @@ int main(int argc, char* argv[]) {
         auto baseRiskFactors = createBaseRiskFactors();
         auto testCases = createTestCases();
 
+        // --aggregate-sensitivities sums the gradients over paths instead of storing them
+        for (int i = 1; i < argc; ++i) {
+            if (std::string(argv[i]) == "--aggregate-sensitivities") {
+                for (auto& config : testCases)
+                    config.sensitivityLayout = ForgeSensitivityLayout::Aggregated;
+            }
+        }
+
         bool allPassed = true;
 
         for (const auto& config : testCases) {
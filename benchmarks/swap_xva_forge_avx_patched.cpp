@@ -503,8 +503,9 @@ namespace {
         }
 
         Real lgd = Real(0.4);
-        Real exposure = baseNpv > Real(0.0) ? baseNpv : Real(0.0);
-        Real negExposure = baseNpv < Real(0.0) ? -baseNpv : Real(0.0);
+        // recorded selections: the kernel stays valid when the NPV changes sign
+        Real exposure = forge::expr::positive_part(baseNpv);
+        Real negExposure = forge::expr::negative_part(baseNpv);
 
         Real cvaAdj = Real(0.0);
         Real dvaAdj = Real(0.0);
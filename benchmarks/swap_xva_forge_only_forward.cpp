@@ -69,6 +69,8 @@
 #include <compiler/forge_engine.hpp>
 #include <compiler/compiler_config.hpp>
 #include <compiler/node_value_buffers/node_value_buffer.hpp>
+#include <ql/forge/batchevaluator.hpp>
+#include <ql/forge/bumpbatch.hpp>
 
 #include <chrono>
 #include <iomanip>
@@ -498,8 +500,9 @@ namespace {
         }
 
         Real lgd = Real(0.4);
-        Real exposure = baseNpv > Real(0.0) ? baseNpv : Real(0.0);
-        Real negExposure = baseNpv < Real(0.0) ? -baseNpv : Real(0.0);
+        // recorded selections: the kernel stays valid when the NPV changes sign
+        Real exposure = forge::expr::positive_part(baseNpv);
+        Real negExposure = forge::expr::negative_part(baseNpv);
 
         Real cvaAdj = Real(0.0);
         Real dvaAdj = Real(0.0);
@@ -679,43 +682,27 @@ namespace {
                 numKernels++;
 
                 // --- EVALUATION ---
+                // The base scenario and one bump per risk factor share the
+                // lanes of each execution (numRF + 1 lanes per path)
                 auto evalStartTime = std::chrono::high_resolution_clock::now();
 
-                for (Size p = 0; p < config.numPaths; ++p) {
-                    const auto& scenario = scenarios[t][p];
-                    std::vector<double> scenarioInputs = scenario.flatten();
-
-                    for (Size i = 0; i < config.numRiskFactors; ++i) {
-                        double inputVal[4] = {scenarioInputs[i], scenarioInputs[i], scenarioInputs[i], scenarioInputs[i]};
-                        buffer->setLanes(rateNodeIds[i], inputVal);
+                forgeWithBatchWidth(buffer->getVectorWidth(), [&](auto w) {
+                    constexpr Size W = decltype(w)::value;
+                    ForgeBumpBatch<W> bumps(*kernel, *buffer, rateNodeIds, {npvNodeId},
+                                            config.bumpSize);
+                    for (Size p = 0; p < config.numPaths; ++p) {
+                        const std::vector<double>& scenarioInputs = scenarios[t][p].flatten();
+                        std::vector<double>& sensitivities = results.sensitivities[s][t][p];
+                        sensitivities.resize(config.numRiskFactors);
+                        double baseNpv;
+                        bumps.evaluate(scenarioInputs.data(), 1, &baseNpv, sensitivities.data());
+                        numEvaluations += bumps.executions();
+
+                        results.exposures[s][t][p] = std::max(0.0, baseNpv);
+                        totalExposure += results.exposures[s][t][p];
+                        numScenarios++;
                     }
-                    kernel->execute(*buffer);
-                    numEvaluations++;
-
-                    double outputVal[4];
-                    buffer->getLanes(npvNodeId, outputVal);
-                    double baseNpv = outputVal[0];
-                    results.exposures[s][t][p] = std::max(0.0, baseNpv);
-                    totalExposure += results.exposures[s][t][p];
-
-                    // Compute sensitivities via bump-reval (no AAD)
-                    results.sensitivities[s][t][p].resize(config.numRiskFactors);
-                    for (Size i = 0; i < config.numRiskFactors; ++i) {
-                        double bumpedInputVal[4] = {scenarioInputs[i] + config.bumpSize, scenarioInputs[i] + config.bumpSize, scenarioInputs[i] + config.bumpSize, scenarioInputs[i] + config.bumpSize};
-                        buffer->setLanes(rateNodeIds[i], bumpedInputVal);
-                        kernel->execute(*buffer);
-                        numEvaluations++;
-
-                        double bumpedOutputVal[4];
-                        buffer->getLanes(npvNodeId, bumpedOutputVal);
-                        double bumpedNpv = bumpedOutputVal[0];
-                        results.sensitivities[s][t][p][i] = (bumpedNpv - baseNpv) / config.bumpSize;
-
-                        double restoreVal[4] = {scenarioInputs[i], scenarioInputs[i], scenarioInputs[i], scenarioInputs[i]};
-                        buffer->setLanes(rateNodeIds[i], restoreVal);
-                    }
-                    numScenarios++;
-                }
+                });
 
                 auto evalEndTime = std::chrono::high_resolution_clock::now();
                 totalEvalUs += std::chrono::duration_cast<std::chrono::microseconds>(evalEndTime - evalStartTime).count();
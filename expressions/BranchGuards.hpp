@@ -0,0 +1,91 @@
+/*******************************************************************************
+
+   Branch guards: recording the outcome of native branches on ABool.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: Zlib
+
+******************************************************************************/
+
+#pragma once
+
+#include <expressions/Macros.hpp>
+#include <graph/handles.hpp>
+#include <types/fbool.hpp>
+#include <types/fdouble.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace forge {
+
+/**
+ * BranchGuards: collects the branches taken on active ABool conditions.
+ *
+ * Code that has not been converted to ABool::If branches in plain C++ via
+ * ABool::operator bool(), which bakes the branch taken into the recorded
+ * graph.  While a BranchGuards object is installed on the recording thread,
+ * every such conversion adds a guard: a graph node evaluating the condition
+ * to 1 or 0 per lane, together with the outcome seen while recording.
+ *
+ * After marking the regular outputs, markOutputs() adds the guards as
+ * kernel outputs.  A lane whose guard values differ from signature() took
+ * a different branch than the recording and its results must be discarded
+ * (see ql/forge/guardedkernels.hpp).
+ *
+ * Guards nest: the constructor installs the object for the current thread
+ * and the destructor restores the previous one.
+ */
+class BranchGuards {
+public:
+    BranchGuards() : previous_(slot()) { slot() = this; }
+    ~BranchGuards() { slot() = previous_; }
+
+    BranchGuards(const BranchGuards&) = delete;
+    BranchGuards& operator=(const BranchGuards&) = delete;
+
+    /// the guards installed on this thread, or nullptr
+    static BranchGuards* current() { return slot(); }
+
+    /// records that cond evaluated to passive in a native branch
+    void add(const fbool& cond, bool passive) {
+        values_.push_back(cond.If(fdouble(1.0), fdouble(0.0)));
+        signature_.push_back(passive ? 1 : 0);
+    }
+
+    std::size_t size() const { return signature_.size(); }
+    bool empty() const { return signature_.empty(); }
+
+    /// branch outcomes seen while recording, one per guard
+    const std::vector<char>& signature() const { return signature_; }
+
+    /// marks every guard as a graph output and returns the node ids
+    std::vector<NodeId> markOutputs() {
+        std::vector<NodeId> ids;
+        ids.reserve(values_.size());
+        for (fdouble& v : values_) {
+            v.markOutput();
+            ids.push_back(v.node());
+        }
+        return ids;
+    }
+
+    void clear() {
+        values_.clear();
+        signature_.clear();
+    }
+
+private:
+    static BranchGuards*& slot() {
+        static FEXPR_THREAD_LOCAL BranchGuards* current = nullptr;
+        return current;
+    }
+
+    BranchGuards* previous_;
+    std::vector<fdouble> values_;
+    std::vector<char> signature_;
+};
+
+} // namespace forge
@@ -19,6 +19,7 @@
 #include <expressions/Literals.hpp>
 #include <expressions/Traits.hpp>
 #include <expressions/ExpressionTemplates/UnaryOperators.hpp>
+#include <expressions/ExpressionTemplates/ForgeComplexFunctions.hpp>
 #include <cmath>
 #include <complex>
 #include <iostream>
@@ -102,6 +103,214 @@ class complex_impl
     T real_, imag_;
 };
 
+// ========== Forge Integration: packed complex recording ==========
+// The complex operations below compute their values on the passive scalars
+// and, while Forge tracks values, record both parts at once through the
+// intrinsics of ForgeComplexFunctions.hpp instead of the AReal operators.
+// With a tape active, the parts of the result are taped with their
+// analytic partials.
+
+template <class Scalar, std::size_t N>
+FEXPR_INLINE Scalar complexPassivePart(const AReal<Scalar, N>& x)
+{
+    return passiveValueOf(x);
+}
+
+template <class X>
+FEXPR_INLINE typename std::enable_if<std::is_arithmetic<X>::value, X>::type complexPassivePart(
+    const X& x)
+{
+    return x;
+}
+
+template <class Scalar, std::size_t N>
+FEXPR_INLINE const ::forge::fdouble& complexForgePart(const AReal<Scalar, N>& x)
+{
+    return x.forgeValue();
+}
+
+template <class X>
+FEXPR_INLINE typename std::enable_if<std::is_arithmetic<X>::value, ::forge::fdouble>::type
+complexForgePart(const X& x)
+{
+    return ::forge::fdouble(static_cast<double>(x));
+}
+
+template <class Scalar, std::size_t N>
+FEXPR_INLINE slot_type complexSlotOf(const AReal<Scalar, N>& x)
+{
+    return x.getSlot();
+}
+
+template <class X>
+FEXPR_INLINE typename std::enable_if<std::is_arithmetic<X>::value, slot_type>::type complexSlotOf(
+    const X&)
+{
+    return INVALID_SLOT_VALUE;
+}
+
+template <class X>
+FEXPR_INLINE ForgeComplex complexForgeValue(const std::complex<X>& z)
+{
+    return {complexForgePart(z.real()), complexForgePart(z.imag())};
+}
+
+template <class X>
+FEXPR_INLINE auto complexPassiveValue(const std::complex<X>& z)
+    -> std::complex<decltype(complexPassivePart(z.real()))>
+{
+    return {complexPassivePart(z.real()), complexPassivePart(z.imag())};
+}
+
+/// tapes (re, im) = f(z1, z2) for f holomorphic in both, with derivatives c1 and c2
+///
+/// dw = c1 dz1 + c2 dz2 in complex arithmetic, that is
+/// d re = Re c dre - Im c dim and d im = Im c dre + Re c dim for each operand.
+template <class T, class X, class Y>
+FEXPR_INLINE void complexTapeHolomorphic(T& re, T& im, const std::complex<X>& z1,
+                                         const std::complex<typename ExprTraits<T>::nested_type>& c1,
+                                         const std::complex<Y>& z2,
+                                         const std::complex<typename ExprTraits<T>::nested_type>& c2)
+{
+    typename T::tape_type* tape = T::tape_type::getActive();
+    if (tape == nullptr)
+        return;
+    const slot_type r1 = complexSlotOf(z1.real()), i1 = complexSlotOf(z1.imag());
+    const slot_type r2 = complexSlotOf(z2.real()), i2 = complexSlotOf(z2.imag());
+    tape->pushPartials(re, {{c1.real(), r1}, {-c1.imag(), i1}, {c2.real(), r2}, {-c2.imag(), i2}});
+    tape->pushPartials(im, {{c1.imag(), r1}, {c1.real(), i1}, {c2.imag(), r2}, {c2.real(), i2}});
+}
+
+template <class T, class X>
+FEXPR_INLINE void complexTapeHolomorphic(T& re, T& im, const std::complex<X>& z,
+                                         const std::complex<typename ExprTraits<T>::nested_type>& c)
+{
+    typedef typename ExprTraits<T>::nested_type nested;
+    complexTapeHolomorphic(re, im, z, c, std::complex<nested>(), std::complex<nested>());
+}
+
+/// sets z to v, recording its Forge side with record() while tracking and
+/// taping its parts with tape(re, im) before z is overwritten
+template <class T, class Record, class TapeParts>
+FEXPR_INLINE void complexAssignRecorded(std::complex<T>& z,
+                                        const std::complex<typename ExprTraits<T>::nested_type>& v,
+                                        Record record, TapeParts tape)
+{
+    T re(v.real()), im(v.imag());
+    if (forgeTracking())
+    {
+        ForgeComplex f = record();
+        re.setForgeValue(f.re);
+        im.setForgeValue(f.im);
+    }
+    tape(re, im);
+    z.real(re);
+    z.imag(im);
+}
+
+template <class T, class Record, class TapeParts>
+FEXPR_INLINE std::complex<T> complexRecorded(
+    const std::complex<typename ExprTraits<T>::nested_type>& v, Record record, TapeParts tape)
+{
+    std::complex<T> z;
+    complexAssignRecorded(z, v, record, tape);
+    return z;
+}
+
+template <class T, class X>
+FEXPR_INLINE void complexMultiplyAssign(std::complex<T>& z, const std::complex<X>& o)
+{
+    const auto a = complexPassiveValue(z);
+    const auto b = complexPassiveValue(o);
+    complexAssignRecorded(z,
+                          {a.real() * b.real() - a.imag() * b.imag(),
+                           a.real() * b.imag() + a.imag() * b.real()},
+                          [&] { return forgeComplexMul(complexForgeValue(z), complexForgeValue(o)); },
+                          [&](T& re, T& im) { complexTapeHolomorphic(re, im, z, b, o, a); });
+}
+
+template <class T, class X>
+FEXPR_INLINE void complexDivideAssign(std::complex<T>& z, const std::complex<X>& o)
+{
+    typedef typename ExprTraits<T>::nested_type nested;
+    const auto a = complexPassiveValue(z);
+    const auto b = complexPassiveValue(o);
+    const nested inv = nested(1) / (b.real() * b.real() + b.imag() * b.imag());
+    const std::complex<nested> w((a.real() * b.real() + a.imag() * b.imag()) * inv,
+                                 (a.imag() * b.real() - a.real() * b.imag()) * inv);
+    // d(z / o) = dz / o - (z / o) do / o
+    const std::complex<nested> reciprocal = nested(1) / std::complex<nested>(b);
+    complexAssignRecorded(
+        z, w, [&] { return forgeComplexDiv(complexForgeValue(z), complexForgeValue(o)); },
+        [&](T& re, T& im) {
+            complexTapeHolomorphic(re, im, z, reciprocal, o, -w * reciprocal);
+        });
+}
+
+template <class T>
+FEXPR_INLINE std::complex<T> complexExp(const std::complex<T>& z)
+{
+    typedef typename ExprTraits<T>::nested_type nested;
+    const std::complex<nested> w = std::exp(complexPassiveValue(z));
+    return complexRecorded<T>(w, [&] { return forgeComplexExp(complexForgeValue(z)); },
+                              [&](T& re, T& im) { complexTapeHolomorphic(re, im, z, w); });
+}
+
+template <class T>
+FEXPR_INLINE std::complex<T> complexLog(const std::complex<T>& z)
+{
+    typedef typename ExprTraits<T>::nested_type nested;
+    const std::complex<nested> a = complexPassiveValue(z);
+    return complexRecorded<T>(std::log(a), [&] { return forgeComplexLog(complexForgeValue(z)); },
+                              [&](T& re, T& im) {
+                                  complexTapeHolomorphic(re, im, z, nested(1) / a);
+                              });
+}
+
+template <class T>
+FEXPR_INLINE std::complex<T> complexSqrt(const std::complex<T>& z)
+{
+    typedef typename ExprTraits<T>::nested_type nested;
+    const std::complex<nested> w = std::sqrt(complexPassiveValue(z));
+    return complexRecorded<T>(w, [&] { return forgeComplexSqrt(complexForgeValue(z)); },
+                              [&](T& re, T& im) {
+                                  complexTapeHolomorphic(re, im, z, nested(0.5) / w);
+                              });
+}
+
+template <class T>
+FEXPR_INLINE T complexAbs(const std::complex<T>& z)
+{
+    typedef typename ExprTraits<T>::nested_type nested;
+    const std::complex<nested> a = complexPassiveValue(z);
+    const nested m = std::abs(a);
+    T r(m);
+    if (forgeTracking())
+        r.setForgeValue(forgeComplexAbs(complexForgeValue(z)));
+    if (typename T::tape_type* tape = T::tape_type::getActive())
+        tape->pushPartials(r, {{a.real() / m, complexSlotOf(z.real())},
+                               {a.imag() / m, complexSlotOf(z.imag())}});
+    return r;
+}
+
+template <class T>
+FEXPR_INLINE T complexArg(const std::complex<T>& z)
+{
+    typedef typename ExprTraits<T>::nested_type nested;
+    const std::complex<nested> a = complexPassiveValue(z);
+    T r(std::arg(a));
+    if (forgeTracking())
+        r.setForgeValue(forgeComplexArg(complexForgeValue(z)));
+    if (typename T::tape_type* tape = T::tape_type::getActive())
+    {
+        const nested n = std::norm(a);
+        tape->pushPartials(r, {{-a.imag() / n, complexSlotOf(z.real())},
+                               {a.real() / n, complexSlotOf(z.imag())}});
+    }
+    return r;
+}
+// ==================================================================
+
 }  // namespace detail
 
 }}  // namespace forge::expr
@@ -158,9 +367,7 @@ class complex<forge::expr::ADTypeBase<Scalar, T, Deriv>> : public forge::expr::d
     template <class X>
     complex<T>& operator*=(const std::complex<X>& other)
     {
-        T real_t = base::real() * other.real() - base::imag() * other.imag();
-        base::imag(base::real() * other.imag() + other.real() * base::imag());
-        base::real(real_t);
+        forge::expr::detail::complexMultiplyAssign(derived(), other);
         return derived();
     }
 
@@ -174,10 +381,7 @@ class complex<forge::expr::ADTypeBase<Scalar, T, Deriv>> : public forge::expr::d
     template <class X>
     complex<T>& operator/=(const std::complex<X>& other)
     {
-        T den = T(other.real()) * T(other.real()) + T(other.imag()) * T(other.imag());
-        T real_t = ((base::real() * T(other.real())) + (base::imag() * T(other.imag()))) / den;
-        base::imag((base::imag() * T(other.real()) - base::real() * T(other.imag())) / den);
-        base::real(real_t);
+        forge::expr::detail::complexDivideAssign(derived(), other);
         return derived();
     }
 };
@@ -1211,7 +1415,7 @@ FEXPR_INLINE complex<forge::expr::AReal<T, N>> exp(const complex<forge::expr::AR
 template <class T, std::size_t N = 1>
 FEXPR_INLINE complex<forge::expr::AReal<T, N>> log(const complex<forge::expr::AReal<T, N>>& z)
 {
-    return complex<forge::expr::AReal<T, N>>(log(forge::expr::detail::abs_impl(z)), forge::expr::detail::arg_impl(z));
+    return forge::expr::detail::complexLog(z);
 }
 
 // FReal log function removed - not used by QuantLib-Risks-Cpp
@@ -1501,50 +1705,13 @@ FEXPR_INLINE T norm_impl(const std::complex<T>& x)
 template <class T>
 FEXPR_INLINE T abs_impl(const std::complex<T>& x)
 {
-    using std::sqrt;
-    if (forge::expr::isinf(x.real()) || forge::expr::isinf(x.imag()))
-        return std::numeric_limits<double>::infinity();
-    return forge::expr::hypot(x.real(), x.imag());
+    return ::forge::expr::detail::complexAbs(x);
 }
 
 template <class T>
 FEXPR_INLINE std::complex<T> exp_impl(const std::complex<T>& z)
 {
-    using std::cos;
-    using std::exp;
-    using std::sin;
-    typedef typename forge::expr::ExprTraits<T>::nested_type nested;
-    if (forge::expr::isinf(z.real()))
-    {
-        if (z.real() > 0.0)
-        {
-            if (z.imag() == 0.0)
-                return std::complex<T>(std::numeric_limits<nested>::infinity(), 0.0);
-            if (forge::expr::isinf(z.imag()) && z.imag() > 0.0)
-                return std::complex<T>(std::numeric_limits<nested>::infinity(),
-                                       std::numeric_limits<nested>::quiet_NaN());
-            if (forge::expr::isnan(z.imag()))
-                return std::complex<T>(std::numeric_limits<nested>::infinity(),
-                                       std::numeric_limits<nested>::quiet_NaN());
-        }
-        else
-        {
-            if (forge::expr::isinf(z.imag()) && z.imag() > 0.0)
-                return std::complex<T>(0.0, 0.0);
-            if (forge::expr::isnan(z.imag()))
-                return std::complex<T>(0.0, 0.0);
-        }
-    }
-    else if (forge::expr::isnan(z.real()))
-    {
-        if (z.imag() == 0.0 && !forge::expr::signbit(z.imag()))
-            return std::complex<T>(std::numeric_limits<nested>::quiet_NaN(), 0.0);
-        else
-            return std::complex<T>(std::numeric_limits<nested>::quiet_NaN(),
-                                   std::numeric_limits<nested>::quiet_NaN());
-    }
-    T e = ::forge::expr::exp(z.real());
-    return std::complex<T>(e * cos(z.imag()), e * sin(z.imag()));
+    return ::forge::expr::detail::complexExp(z);
 }
 
 template <class T1, class T2>
@@ -1560,29 +1727,7 @@ FEXPR_INLINE std::complex<typename forge::expr::ExprTraits<T1>::value_type> pola
 template <class T>
 FEXPR_INLINE std::complex<T> sqrt_impl(const std::complex<T>& z)
 {
-    typedef typename forge::expr::ExprTraits<T>::nested_type nested;
-    if (forge::expr::isinf(z.real()) && z.real() < 0.0)
-    {
-        if (forge::expr::isfinite(z.imag()) && z.imag() > 0.0)
-            return std::complex<T>(0.0, std::numeric_limits<nested>::infinity());
-        if (forge::expr::isnan(z.imag()))
-            return std::complex<T>(std::numeric_limits<nested>::quiet_NaN(),
-                                   std::numeric_limits<nested>::infinity());
-    }
-    if (forge::expr::isinf(z.real()) && z.real() > 0.0)
-    {
-        if (forge::expr::isfinite(z.imag()) && z.imag() > 0.0)
-            return std::complex<T>(std::numeric_limits<nested>::infinity(), 0.0);
-
-        if (forge::expr::isnan(z.imag()))
-            return std::complex<T>(std::numeric_limits<nested>::infinity(),
-                                   std::numeric_limits<nested>::quiet_NaN());
-    }
-    if (forge::expr::isinf(z.imag()) && z.imag() > 0.0)
-        return std::complex<T>(std::numeric_limits<nested>::infinity(),
-                               std::numeric_limits<nested>::infinity());
-
-    return ::forge::expr::detail::polar_impl(sqrt(abs(z)), arg(z) * T(0.5));
+    return ::forge::expr::detail::complexSqrt(z);
 }
 
 template <class T>
@@ -1858,8 +2003,7 @@ FEXPR_INLINE std::complex<T> atan_impl(const std::complex<T>& z)
 template <class T>
 FEXPR_INLINE T arg_impl(const std::complex<T>& z)
 {
-    using std::atan2;
-    return atan2(z.imag(), z.real());
+    return ::forge::expr::detail::complexArg(z);
 }
 
 template <class Scalar, class Derived, class Deriv>
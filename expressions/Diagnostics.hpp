@@ -0,0 +1,262 @@
+/*******************************************************************************
+
+   Graph-drop diagnostics for Forge recording.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#pragma once
+
+#include <expressions/Macros.hpp>
+
+// A graph drop happens when recorded code leaves the Forge graph, e.g. by
+// reading the scalar value of an active AReal or by branching on an active
+// ABool in plain C++.  The resulting kernel is then only valid for the
+// recorded inputs.  Every place that can cause a drop reports it with
+// FEXPR_FORGE_GRAPH_DROP(condition, description); each such call site owns an
+// atomic counter which is registered with GraphDropRegistry on first hit.
+//
+// The sites inside AReal and ABool are shared by all of QuantLib, so the code
+// that actually drops out of the graph is found through stack capture: the
+// registry prints the first few hits of every site, with their stacks when
+// capture is enabled, and produces a summary for the whole process:
+//
+//     forge::expr::GraphDropRegistry::instance().summary(std::cout);
+//
+// Diagnostics are compiled in with FEXPR_FORGE_DIAGNOSTICS, which defaults to
+// on unless NDEBUG is defined; FEXPR_FORGE_NO_DIAGNOSTICS forces them off.
+// Without them, FEXPR_FORGE_GRAPH_DROP expands to nothing and its condition is
+// never evaluated.
+
+#if !defined(FEXPR_FORGE_DIAGNOSTICS) && !defined(FEXPR_FORGE_NO_DIAGNOSTICS) && !defined(NDEBUG)
+#define FEXPR_FORGE_DIAGNOSTICS
+#endif
+#if defined(FEXPR_FORGE_DIAGNOSTICS) && defined(FEXPR_FORGE_NO_DIAGNOSTICS)
+#undef FEXPR_FORGE_DIAGNOSTICS
+#endif
+
+#ifdef FEXPR_FORGE_DIAGNOSTICS
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h>
+#include <cstdlib>
+#define FEXPR_FORGE_HAVE_BACKTRACE
+#endif
+
+namespace forge { namespace expr {
+
+class GraphDropSite;
+
+/// process-wide registry of graph-drop call sites
+class GraphDropRegistry
+{
+  public:
+    /// snapshot of one call site
+    struct Entry
+    {
+        const char* description;
+        const char* file;
+        int line;
+        const char* function;
+        std::size_t count;
+        std::vector<std::string> stack;
+    };
+
+    static GraphDropRegistry& instance()
+    {
+        static GraphDropRegistry registry;
+        return registry;
+    }
+
+    /// hits printed per call site; 0 silences the messages but keeps counting
+    void setMessageLimit(std::size_t n) { messageLimit_.store(n, std::memory_order_relaxed); }
+    std::size_t messageLimit() const { return messageLimit_.load(std::memory_order_relaxed); }
+
+    /// print the stack of every reported hit and keep the first one of every
+    /// site for the summary (glibc and macOS only)
+    void setCaptureStacks(bool capture) { captureStacks_.store(capture, std::memory_order_relaxed); }
+    bool captureStacks() const { return captureStacks_.load(std::memory_order_relaxed); }
+
+    /// stream for the per-hit messages, std::cerr by default
+    void setStream(std::ostream& os)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stream_ = &os;
+    }
+
+    inline std::vector<Entry> entries() const;
+    inline std::size_t totalDrops() const;
+    /// sites sorted by hit count, with stacks where captured
+    inline void summary(std::ostream& os) const;
+    /// zeroes all counters and forgets captured stacks
+    inline void reset();
+
+  private:
+    friend class GraphDropSite;
+
+    GraphDropRegistry() = default;
+
+    inline void add(GraphDropSite* site);
+    inline void report(GraphDropSite& site, std::size_t occurrence);
+
+    mutable std::mutex mutex_;
+    std::vector<GraphDropSite*> sites_;
+    std::ostream* stream_ = &std::cerr;
+    std::atomic<std::size_t> messageLimit_{10};
+    std::atomic<bool> captureStacks_{false};
+};
+
+/// one FEXPR_FORGE_GRAPH_DROP call site; constructed once, on its first hit
+class GraphDropSite
+{
+  public:
+    GraphDropSite(const char* description, const char* file, int line, const char* function)
+        : description_(description), file_(file), line_(line), function_(function)
+    {
+        GraphDropRegistry::instance().add(this);
+    }
+
+    GraphDropSite(const GraphDropSite&) = delete;
+    GraphDropSite& operator=(const GraphDropSite&) = delete;
+
+    FEXPR_NEVER_INLINE void hit()
+    {
+        std::size_t n = count_.fetch_add(1, std::memory_order_relaxed) + 1;
+        GraphDropRegistry& registry = GraphDropRegistry::instance();
+        if (n <= registry.messageLimit())
+            registry.report(*this, n);
+    }
+
+    std::size_t count() const { return count_.load(std::memory_order_relaxed); }
+
+  private:
+    friend class GraphDropRegistry;
+
+    static std::vector<std::string> captureStack()
+    {
+        std::vector<std::string> stack;
+#ifdef FEXPR_FORGE_HAVE_BACKTRACE
+        void* frames[32];
+        int n = ::backtrace(frames, 32);
+        char** symbols = ::backtrace_symbols(frames, n);
+        // skip captureStack(), report() and hit()
+        for (int i = 3; symbols != nullptr && i < n; ++i)
+            stack.emplace_back(symbols[i]);
+        std::free(symbols);
+#endif
+        return stack;
+    }
+
+    const char* description_;
+    const char* file_;
+    int line_;
+    const char* function_;
+    std::atomic<std::size_t> count_{0};
+    std::vector<std::string> stack_;  // guarded by the registry mutex
+};
+
+inline void GraphDropRegistry::add(GraphDropSite* site)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    sites_.push_back(site);
+}
+
+inline void GraphDropRegistry::report(GraphDropSite& site, std::size_t occurrence)
+{
+    std::vector<std::string> stack;
+    if (captureStacks())
+        stack = GraphDropSite::captureStack();
+    std::lock_guard<std::mutex> lock(mutex_);
+    *stream_ << "[Forge][Warning] " << site.description_ << " at " << site.file_ << ":"
+             << site.line_ << " in " << site.function_ << " (occurrence " << occurrence
+             << ")\n";
+    for (const std::string& frame : stack)
+        *stream_ << "    " << frame << "\n";
+    if (site.stack_.empty())
+        site.stack_.swap(stack);
+}
+
+inline std::vector<GraphDropRegistry::Entry> GraphDropRegistry::entries() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Entry> result;
+    result.reserve(sites_.size());
+    for (const GraphDropSite* s : sites_)
+        result.push_back(
+            {s->description_, s->file_, s->line_, s->function_, s->count(), s->stack_});
+    return result;
+}
+
+inline std::size_t GraphDropRegistry::totalDrops() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t total = 0;
+    for (const GraphDropSite* s : sites_)
+        total += s->count();
+    return total;
+}
+
+inline void GraphDropRegistry::summary(std::ostream& os) const
+{
+    std::vector<Entry> sites = entries();
+    std::stable_sort(sites.begin(), sites.end(),
+                     [](const Entry& a, const Entry& b) { return a.count > b.count; });
+    std::size_t total = 0;
+    for (const Entry& e : sites)
+        total += e.count;
+    os << "[Forge] graph drops: " << total << " at " << sites.size() << " call sites\n";
+    for (const Entry& e : sites)
+    {
+        if (e.count == 0)
+            continue;
+        os << "  " << e.count << "  " << e.description << "\n      at " << e.file << ":"
+           << e.line << " in " << e.function << "\n";
+        for (const std::string& frame : e.stack)
+            os << "        " << frame << "\n";
+    }
+}
+
+inline void GraphDropRegistry::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (GraphDropSite* s : sites_)
+    {
+        s->count_.store(0, std::memory_order_relaxed);
+        s->stack_.clear();
+    }
+}
+
+}}  // namespace forge::expr
+
+#define FEXPR_FORGE_GRAPH_DROP(condition, description)                                         \
+    do                                                                                         \
+    {                                                                                          \
+        if (FEXPR_UNLIKELY(condition))                                                         \
+        {                                                                                      \
+            static ::forge::expr::GraphDropSite fexpr_graph_drop_site_((description), __FILE__, \
+                                                                       __LINE__, __func__);     \
+            fexpr_graph_drop_site_.hit();                                                      \
+        }                                                                                      \
+    } while (false)
+
+#else
+
+#define FEXPR_FORGE_GRAPH_DROP(condition, description) \
+    do                                                 \
+    {                                                  \
+    } while (false)
+
+#endif
@@ -15,6 +15,7 @@
 
 #pragma once
 #include <expressions/Macros.hpp>
+#include <cstddef>
 
 namespace forge { namespace expr {
 
@@ -104,6 +105,35 @@ FEXPR_INLINE Scalar value(const Expression<Scalar, Expr, DerivativeType>& expr)
     return expr.value();
 }
 
+// ========== Forge Integration: passive value reads ==========
+template <class, std::size_t>
+struct AReal;
+
+namespace detail
+{
+// the scalar value of an expression, read by the expression templates and the
+// comparisons while the Forge side is recorded separately; unlike
+// AReal::value() this is not reported as a graph drop
+template <class Expr>
+FEXPR_INLINE auto passiveValueOf(const Expr& expr) -> decltype(expr.value())
+{
+    return expr.value();
+}
+
+template <class Scalar, std::size_t M>
+FEXPR_INLINE const Scalar& passiveValueOf(const AReal<Scalar, M>& x)
+{
+    return static_cast<const typename AReal<Scalar, M>::base_type&>(x).value();
+}
+
+template <class Scalar, class Expr, class DerivativeType>
+FEXPR_INLINE Scalar passiveValue(const Expression<Scalar, Expr, DerivativeType>& expr)
+{
+    return passiveValueOf(expr.derived());
+}
+}  // namespace detail
+// =============================================================
+
 template <class Scalar, class Expr, class DerivativeType>
 FEXPR_INLINE DerivativeType derivative(const Expression<Scalar, Expr, DerivativeType>& expr)
 {
@@ -17,6 +17,7 @@
 
 #include <expressions/ExpressionTemplates/BinaryDerivativeImpl.hpp>
 #include <expressions/ExpressionTemplates/BinaryFunctors.hpp>
+#include <expressions/Diagnostics.hpp>
 #include <expressions/Expression.hpp>
 #include <expressions/Macros.hpp>
 #include <expressions/Traits.hpp>
@@ -26,6 +27,7 @@
 
 // ========== Forge Integration: Add includes ==========
 #include <types/fdouble.hpp>
+#include <expressions/ExpressionTemplates/ForgeFusion.hpp>
 // =====================================================
 
 #include <type_traits>
@@ -42,6 +44,12 @@ struct max_op;
 template <class Scalar>
 struct min_op;
 
+template <class Scalar>
+struct fmax_op;
+
+template <class Scalar>
+struct fmin_op;
+
 template <class Scalar, class Op, class Expr1, class Expr2, class DerivativeType = Scalar>
 struct BinaryExpr
     : Expression<Scalar, BinaryExpr<Scalar, Op, Expr1, Expr2, DerivativeType>, DerivativeType>
@@ -49,7 +57,7 @@ struct BinaryExpr
     typedef detail::BinaryDerivativeImpl<OperatorTraits<Op>::useResultBasedDerivatives == 1>
         der_impl;
     FEXPR_INLINE BinaryExpr(const Expr1& a, const Expr2& b, Op op = Op())
-        : a_(a), b_(b), op_(op), v_(op_(a_.value(), b_.value()))
+        : a_(a), b_(b), op_(op), v_(op_(detail::passiveValue(a_), detail::passiveValue(b_)))
     {
     }
     FEXPR_INLINE Scalar value() const { return v_; }
@@ -85,20 +93,45 @@ struct BinaryExpr
 
     // ========== Forge Integration: Compute forge result from operands ==========
     FEXPR_INLINE ::forge::fdouble forgeValue() const {
-        // Apply the operator to the forge values of the operands
-        return applyForgeOp(getForgeValue(a_), getForgeValue(b_));
+        // Apply the operator to the forge values of the operands, fusing
+        // multiply-add shapes where Forge supports it (see ForgeFusion.hpp)
+        return recordForge(std::integral_constant<detail::ForgeFusion,
+                                                  detail::ForgeFusionOf<Op, Expr1, Expr2>::value>());
     }
     // ===========================================================================
 
   private:
+    template <class, class, class, class, class>
+    friend struct BinaryExpr;
+
     Expr1 a_;
     Expr2 b_;
     Op op_;
     Scalar v_;
 
+    // ========== Forge Integration: plain and fused recording ==========
+    template <detail::ForgeFusion F>
+    using fusion_tag = std::integral_constant<detail::ForgeFusion, F>;
+
+    FEXPR_INLINE ::forge::fdouble recordForge(fusion_tag<detail::ForgeFusion::None>) const {
+        return applyForgeOp(getForgeValue(a_), getForgeValue(b_));
+    }
+    FEXPR_INLINE ::forge::fdouble recordForge(fusion_tag<detail::ForgeFusion::MultiplyAddLeft>) const {
+        return detail::forgeMultiplyAdd(getForgeValue(a_.a_), getForgeValue(a_.b_), getForgeValue(b_));
+    }
+    FEXPR_INLINE ::forge::fdouble recordForge(fusion_tag<detail::ForgeFusion::MultiplyAddRight>) const {
+        return detail::forgeMultiplyAdd(getForgeValue(b_.a_), getForgeValue(b_.b_), getForgeValue(a_));
+    }
+    FEXPR_INLINE ::forge::fdouble recordForge(fusion_tag<detail::ForgeFusion::NegMultiplyAddRight>) const {
+        return detail::forgeNegMultiplyAdd(getForgeValue(b_.a_), getForgeValue(b_.b_), getForgeValue(a_));
+    }
+    // ==================================================================
+
     // ========== Forge Integration: Helper to extract forge values ==========
+    // Leaves hand out a reference to their stored fdouble, nested expressions
+    // the node they record; neither is copied on the way to the operator.
     template<class T>
-    FEXPR_INLINE ::forge::fdouble getForgeValue(const T& expr) const {
+    FEXPR_INLINE decltype(auto) getForgeValue(const T& expr) const {
         return expr.forgeValue();  // Recursive for nested expressions
     }
 
@@ -150,19 +183,30 @@ struct BinaryExpr
         return ::forge::min(a, b);
     }
 
+    // fmax(a, b)
+    FEXPR_INLINE static ::forge::fdouble performForgeOp(const fmax_op<Scalar>&,
+                                                    const ::forge::fdouble& a,
+                                                    const ::forge::fdouble& b)
+    {
+        return ::forge::max(a, b);
+    }
+
+    // fmin(a, b)
+    FEXPR_INLINE static ::forge::fdouble performForgeOp(const fmin_op<Scalar>&,
+                                                    const ::forge::fdouble& a,
+                                                    const ::forge::fdouble& b)
+    {
+        return ::forge::min(a, b);
+    }
+
     // Fallback for any other binary functor: evaluate numerically and wrap into forge::fdouble.
     template <class OpT>
     FEXPR_INLINE static ::forge::fdouble performForgeOp(const OpT& op,
                                                     const ::forge::fdouble& a,
                                                     const ::forge::fdouble& b)
     {
-        // DEBUG: Log when unhandled binary operators hit the fallback path
-        static std::size_t fallbackCount = 0;
-        if (fallbackCount < 20) {
-            ++fallbackCount;
-            std::cerr << "[Forge][DEBUG] BinaryExpr fallback hit for unhandled operator type: "
-                      << typeid(OpT).name() << " (occurrence " << fallbackCount << ")\n";
-        }
+        // Unhandled binary operators record a constant: report the graph drop
+        FEXPR_FORGE_GRAPH_DROP(a.isActive() || b.isActive(), typeid(OpT).name());
         const double va = static_cast<double>(a);
         const double vb = static_cast<double>(b);
         const double r = op(va, vb);
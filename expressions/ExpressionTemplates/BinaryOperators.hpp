@@ -22,6 +22,15 @@
 #include <expressions/ExpressionTemplates/BinaryOperatorMacros.hpp>
 #include <expressions/Macros.hpp>
 
+// ========== Forge Integration: Add Forge includes ==========
+#include <expressions/abool.hpp>
+#include <graph/graph_recorder.hpp>
+#include <types/fdouble.hpp>
+// ===========================================================
+
+#include <functional>
+#include <type_traits>
+
 namespace forge { namespace expr {
 
 FEXPR_BINARY_OPERATOR(operator+, add_op)
@@ -78,31 +87,74 @@ FEXPR_INLINE auto fma(const T1& a, const T2& b, const T3& c) -> decltype(a * b +
     return a * b + c;
 }
 
-/////////// comparisons - they just return bool
+/////////// comparisons
+
+// ========== Forge Integration: recorded comparisons ==========
+// Comparisons involving expressions return forge::ABool, which converts to the
+// plain bool result as before.  While recording with an active operand it also
+// carries the operands' Forge values, and where(a < b, x, y) or ABool::If
+// records the comparison and an If node from them, so that the kernel stays
+// valid on both sides of the branch.  A comparison consumed natively, as in
+// QL_REQUIRE(x > 0.0, ...) or a loop bound, records nothing; operands that are
+// expressions rather than variables still record their own nodes, since the
+// expression does not outlive the comparison.
+namespace detail
+{
+template <class Scalar, class Expr, class DerivativeType>
+FEXPR_INLINE decltype(auto) forgeOperand(const Expression<Scalar, Expr, DerivativeType>& e)
+{
+    return e.derived().forgeValue();
+}
+
+template <class T>
+FEXPR_INLINE typename std::enable_if<!ExprTraits<T>::isExpr, ::forge::fdouble>::type
+forgeOperand(const T& x)
+{
+    return ::forge::fdouble(static_cast<double>(x));
+}
 
-#define FEXPR_COMPARE_OPERATOR(op, opname)                                                           \
+template <class Compare>
+::forge::fbool forgeRecordCompare(const ::forge::fdouble& a, const ::forge::fdouble& b)
+{
+    return Compare()(a, b);
+}
+
+template <class Compare, class T1, class T2>
+FEXPR_INLINE ::forge::ABool forgeCompare(Compare, bool passive, const T1& a, const T2& b)
+{
+    if (FEXPR_LIKELY(!::forge::GraphRecorder::isAnyRecording()))
+        return ::forge::ABool(passive);
+    const ::forge::fdouble &fa = forgeOperand(a), &fb = forgeOperand(b);
+    if (!fa.isActive() && !fb.isActive())
+        return ::forge::ABool(passive);
+    return ::forge::ABool(&forgeRecordCompare<Compare>, fa, fb, passive);
+}
+}  // namespace detail
+// =============================================================
+
+#define FEXPR_COMPARE_OPERATOR(op, cmp)                                                            \
     template <class Scalar, class Expr1, class Expr2, class DerivativeType>                        \
-    FEXPR_INLINE bool operator op(const Expression<Scalar, Expr1, DerivativeType>& a,                \
-                                const Expression<Scalar, Expr2, DerivativeType>& b)                \
+    FEXPR_INLINE ::forge::ABool operator op(const Expression<Scalar, Expr1, DerivativeType>& a,    \
+                                             const Expression<Scalar, Expr2, DerivativeType>& b)   \
     {                                                                                              \
-        return value(a) op value(b);                                                               \
+        return detail::forgeCompare(cmp(), detail::passiveValue(a) op detail::passiveValue(b), a, b); \
     }                                                                                              \
     template <class Scalar, class Expr, class DerivativeType>                                      \
-    FEXPR_INLINE bool operator op(const typename ExprTraits<Expr>::value_type& a,                    \
-                                const Expression<Scalar, Expr, DerivativeType>& b)                 \
+    FEXPR_INLINE ::forge::ABool operator op(const typename ExprTraits<Expr>::value_type& a,        \
+                                             const Expression<Scalar, Expr, DerivativeType>& b)    \
     {                                                                                              \
-        return value(a) op value(b);                                                               \
+        return detail::forgeCompare(cmp(), detail::passiveValue(a) op detail::passiveValue(b), a, b); \
     }                                                                                              \
     template <class Scalar, class Expr, class DerivativeType>                                      \
-    FEXPR_INLINE bool operator op(const Expression<Scalar, Expr, DerivativeType>& a,                 \
-                                const typename ExprTraits<Expr>::value_type& b)                    \
+    FEXPR_INLINE ::forge::ABool operator op(const Expression<Scalar, Expr, DerivativeType>& a,     \
+                                             const typename ExprTraits<Expr>::value_type& b)       \
     {                                                                                              \
-        return value(a) op value(b);                                                               \
+        return detail::forgeCompare(cmp(), detail::passiveValue(a) op detail::passiveValue(b), a, b); \
     }                                                                                              \
     template <class Scalar, std::size_t M = 1>                                                     \
-    FEXPR_INLINE bool operator op(const AReal<Scalar, M>& a, const AReal<Scalar, M>& b)              \
+    FEXPR_INLINE ::forge::ABool operator op(const AReal<Scalar, M>& a, const AReal<Scalar, M>& b)  \
     {                                                                                              \
-        return value(a) op value(b);                                                               \
+        return detail::forgeCompare(cmp(), detail::passiveValue(a) op detail::passiveValue(b), a, b); \
     }                                                                                              \
     template <class Scalar, std::size_t N>                                                         \
     FEXPR_INLINE bool operator op(const FReal<Scalar, N>& a, const FReal<Scalar, N>& b)              \
@@ -166,24 +218,72 @@ FEXPR_INLINE auto fma(const T1& a, const T2& b, const T3& c) -> decltype(a * b +
     }                                                                                              \
                                                                                                    \
     template <class Scalar, class Expr, class DerivativeType>                                      \
-    FEXPR_INLINE bool operator op(typename ExprTraits<Expr>::nested_type a,                          \
-                                const Expression<Scalar, Expr, DerivativeType>& b)                 \
+    FEXPR_INLINE ::forge::ABool operator op(typename ExprTraits<Expr>::nested_type a,              \
+                                             const Expression<Scalar, Expr, DerivativeType>& b)    \
     {                                                                                              \
-        return a op value(b);                                                                      \
+        return detail::forgeCompare(cmp(), a op detail::passiveValue(b), a, b);                    \
     }                                                                                              \
     template <class Scalar, class Expr, class DerivativeType>                                      \
-    FEXPR_INLINE bool operator op(const Expression<Scalar, Expr, DerivativeType>& a,                 \
-                                typename ExprTraits<Expr>::nested_type b)                          \
+    FEXPR_INLINE ::forge::ABool operator op(const Expression<Scalar, Expr, DerivativeType>& a,     \
+                                             typename ExprTraits<Expr>::nested_type b)             \
     {                                                                                              \
-        return value(a) op b;                                                                      \
+        return detail::forgeCompare(cmp(), detail::passiveValue(a) op b, a, b);                    \
     }
 
-FEXPR_COMPARE_OPERATOR(==, "==")
-FEXPR_COMPARE_OPERATOR(!=, "!=")
-FEXPR_COMPARE_OPERATOR(<=, "<=")
-FEXPR_COMPARE_OPERATOR(>=, ">=")
-FEXPR_COMPARE_OPERATOR(<, "<")
-FEXPR_COMPARE_OPERATOR(>, ">")
+FEXPR_COMPARE_OPERATOR(==, std::equal_to<>)
+FEXPR_COMPARE_OPERATOR(!=, std::not_equal_to<>)
+FEXPR_COMPARE_OPERATOR(<=, std::less_equal<>)
+FEXPR_COMPARE_OPERATOR(>=, std::greater_equal<>)
+FEXPR_COMPARE_OPERATOR(<, std::less<>)
+FEXPR_COMPARE_OPERATOR(>, std::greater<>)
+
+// ========== Forge Integration: recorded selection ==========
+namespace detail
+{
+template <class T1, class T2, bool = ExprTraits<T1>::isExpr, bool = ExprTraits<T2>::isExpr>
+struct WhereResult
+{
+};
+
+template <class T1, class T2, bool IsExpr2>
+struct WhereResult<T1, T2, true, IsExpr2>
+{
+    typedef typename ExprTraits<T1>::value_type type;
+};
+
+template <class T1, class T2>
+struct WhereResult<T1, T2, false, true>
+{
+    typedef typename ExprTraits<T2>::value_type type;
+};
+}  // namespace detail
+
+/// cond ? a : b; recorded as an If node when cond carries a Forge condition,
+/// e.g. where(npv > 0.0, npv, 0.0)
+template <class T1, class T2>
+FEXPR_INLINE typename detail::WhereResult<T1, T2>::type where(const ::forge::ABool& cond,
+                                                              const T1& a, const T2& b)
+{
+    typedef typename detail::WhereResult<T1, T2>::type result_type;
+    return cond.If(result_type(a), result_type(b));
+}
+
+/// max(x, 0), e.g. for positive exposure
+template <class T, class = typename std::enable_if<ExprTraits<T>::isExpr>::type>
+FEXPR_INLINE typename ExprTraits<T>::value_type positive_part(const T& x)
+{
+    typedef typename ExprTraits<T>::value_type result_type;
+    return result_type(max(x, typename ExprTraits<T>::nested_type(0)));
+}
+
+/// max(-x, 0), e.g. for negative exposure
+template <class T, class = typename std::enable_if<ExprTraits<T>::isExpr>::type>
+FEXPR_INLINE typename ExprTraits<T>::value_type negative_part(const T& x)
+{
+    typedef typename ExprTraits<T>::value_type result_type;
+    return result_type(max(-x, typename ExprTraits<T>::nested_type(0)));
+}
+// ===========================================================
 
 FEXPR_BINARY_OPERATOR(remainder, remainder_op)
 
@@ -0,0 +1,342 @@
+/*******************************************************************************
+
+   Packed complex arithmetic for Forge values.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#pragma once
+
+#include <expressions/Macros.hpp>
+#include <expressions/ExpressionTemplates/ForgeFusion.hpp>
+
+// ========== Forge Integration: complex intrinsics ==========
+// std::complex<AReal> keeps its real and imaginary parts as two AReal, so
+// a complex product or quotient recorded through the generic operators of
+// Complex.hpp is a tree of expression temporaries, and exp, log, sqrt, abs
+// and arg go through sin, cos, atan2 and hypot, which the expression layer
+// does not map to Forge: they are recorded as constants, together with the
+// native branches on isinf and isnan of the recording values.
+//
+// The functions below record complex operations directly on the pair of
+// Forge values instead, as one fixed, branch-free sequence of nodes each:
+//
+//  - mul and div are four and six multiply-adds, fused where Forge supports
+//    it, with one division by |b|^2 shared by both parts of a quotient,
+//  - exp is exp(re) scaled by sin and cos of the imaginary part,
+//  - log is 0.5 log(|z|^2) and atan2(im, re),
+//  - sqrt is the cancellation-free half-angle formula, with the principal
+//    branch selected by recorded comparisons.
+//
+// sin, cos and atan2 are single nodes whenever Forge provides them on
+// fdouble, found by argument-dependent lookup as in ForgeFusion.hpp.
+// Otherwise sin and cos are reduced by pi/2 with the quadrant found by a
+// recorded binary search of FEXPR_FORGE_SINCOS_REDUCTION_BITS comparisons,
+// which leaves the reduced argument differentiable, followed by the fdlibm
+// kernels; they are accurate to a few ulps for |x| < 2^bits pi/2.  atan2 uses
+// the Cephes rational approximation with octant selection.
+//
+// Complex.hpp takes the passive values from std::complex on the scalars,
+// including its corner cases for infinite and NaN parts; the recorded
+// kernels follow the formulas there.
+#include <types/fbool.hpp>
+#include <types/fdouble.hpp>
+// ============================================================
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#ifndef FEXPR_FORGE_SINCOS_REDUCTION_BITS
+#define FEXPR_FORGE_SINCOS_REDUCTION_BITS 20
+#endif
+
+namespace forge { namespace expr {
+
+namespace complex_special
+{
+// the formulas below are written once for double and fdouble
+
+/// real and imaginary part of one complex value
+template <class T>
+struct Pair
+{
+    T re, im;
+};
+
+FEXPR_INLINE double select(bool cond, double a, double b) { return cond ? a : b; }
+
+FEXPR_INLINE ::forge::fdouble select(const ::forge::fbool& cond, const ::forge::fdouble& a,
+                                     const ::forge::fdouble& b)
+{
+    return cond.If(a, b);
+}
+
+// a * b + c and c - a * b
+FEXPR_INLINE double madd(double a, double b, double c) { return a * b + c; }
+FEXPR_INLINE double nmadd(double a, double b, double c) { return c - a * b; }
+
+FEXPR_INLINE ::forge::fdouble madd(const ::forge::fdouble& a, const ::forge::fdouble& b,
+                                   const ::forge::fdouble& c)
+{
+    return detail::forgeMultiplyAdd(a, b, c);
+}
+
+FEXPR_INLINE ::forge::fdouble nmadd(const ::forge::fdouble& a, const ::forge::fdouble& b,
+                                    const ::forge::fdouble& c)
+{
+    return detail::forgeNegMultiplyAdd(a, b, c);
+}
+
+template <class T>
+FEXPR_INLINE T poly(const T& x, const double* c, int n)
+{
+    T r = T(c[n - 1]);
+    for (int i = n - 2; i >= 0; --i)
+        r = madd(r, x, T(c[i]));
+    return r;
+}
+
+/// sin and cos of r for |r| <= pi/4, fdlibm __kernel_sin and __kernel_cos
+template <class T>
+FEXPR_INLINE Pair<T> sincosKernel(const T& r)
+{
+    static const double s[6] = {-1.66666666666666324348e-01, 8.33333333332248946124e-03,
+                                -1.98412698298579493134e-04, 2.75573137070700676789e-06,
+                                -2.50507602534068634195e-08, 1.58969099521155010221e-10};
+    static const double c[6] = {4.16666666666666019037e-02,  -1.38888888888741095749e-03,
+                                2.48015872894767294178e-05,  -2.75573143513906633035e-07,
+                                2.08757232129817482790e-09,  -1.13596475577881948265e-11};
+    T z = r * r;
+    T sr = madd(r * z, poly(z, s, 6), r);
+    T cr = madd(z * z, poly(z, c, 6), nmadd(T(0.5), z, T(1.0)));
+    return {sr, cr};
+}
+
+/// (sin x, cos x) through reduction by pi/2
+template <class T>
+FEXPR_INLINE Pair<T> sincos(const T& x)
+{
+    using std::abs;
+    // pi/2 split in three parts; k * pio2_1 is exact for k < 2^20
+    const double twoOverPi = 6.36619772367581382433e-01;
+    const double pio2_1 = 1.57079632673412561417e+00;
+    const double pio2_2 = 6.07710050630396597660e-11;
+    const double pio2_3 = 2.02226624879595063154e-21;
+    const int bits = FEXPR_FORGE_SINCOS_REDUCTION_BITS;
+
+    T ax = abs(x);
+    // k = round(|x| 2/pi), one recorded comparison per bit: the selected
+    // powers of two are constants, so k does not carry a derivative
+    T a = madd(ax, T(twoOverPi), T(0.5));
+    T k = T(0.0), quadrant = T(0.0);
+    for (int j = bits - 1; j >= 0; --j)
+    {
+        const double p = std::ldexp(1.0, j);
+        T b = select(a >= T(p), T(p), T(0.0));
+        a = a - b;
+        k = k + b;
+        if (j < 2)
+            quadrant = quadrant + b;
+    }
+    T r = nmadd(k, T(pio2_3), nmadd(k, T(pio2_2), nmadd(k, T(pio2_1), ax)));
+    Pair<T> sc = sincosKernel(r);
+
+    // quadrant = k mod 4: odd quadrants swap sin and cos, sin is negative in
+    // quadrants 2 and 3, cos in quadrants 1 and 2
+    T m = quadrant - T(2.0) * select(quadrant >= T(2.0), T(1.0), T(0.0));
+    T s = select(m > T(0.5), sc.im, sc.re);
+    T c = select(m > T(0.5), sc.re, sc.im);
+    T sinSign = select(quadrant > T(1.5), T(-1.0), T(1.0));
+    T cosSign = select(abs(quadrant - T(1.5)) > T(1.0), T(1.0), T(-1.0));
+    // sin is odd in x, cos is even
+    return {s * select(x < T(0.0), -sinSign, sinSign), c * cosSign};
+}
+
+/// atan2(y, x), Cephes atan with octant selection
+template <class T>
+FEXPR_INLINE T atan2(const T& y, const T& x)
+{
+    using std::abs;
+    using std::max;
+    using std::min;
+    static const double p[5] = {-6.485021904942025371773e1, -1.228866684490136173410e2,
+                                -7.500855792314704667340e1, -1.615753718733365076637e1,
+                                -8.750608600031904122785e-1};
+    static const double q[6] = {1.945506571482613964425e2, 4.853903996359136964868e2,
+                                4.328810604912902668951e2, 1.650270098316988542046e2,
+                                2.485846490142306297962e1, 1.0};
+    const double pio4 = 7.85398163397448309616e-1;
+    const double pio2 = 1.57079632679489661923e0;
+    const double pi = 3.14159265358979323846e0;
+
+    T ay = abs(y), ax = abs(x);
+    // t = min / max in [0, 1]; the guard gives atan2(0, 0) = 0
+    T t = min(ax, ay) / max(max(ax, ay), T(std::numeric_limits<double>::min()));
+    // tan(3 pi / 8) > t > 0.66: atan(t) = pi/4 + atan((t - 1) / (t + 1))
+    auto large = t > T(0.66);
+    T u = select(large, (t - T(1.0)) / (t + T(1.0)), t);
+    T z = u * u;
+    T a = madd(u * z, poly(z, p, 5) / poly(z, q, 6), u);
+    a = a + select(large, T(pio4), T(0.0));
+    a = select(ay > ax, T(pio2) - a, a);
+    a = select(x < T(0.0), T(pi) - a, a);
+    return select(y < T(0.0), -a, a);
+}
+
+template <class T>
+FEXPR_INLINE Pair<T> mul(const Pair<T>& a, const Pair<T>& b)
+{
+    return {nmadd(a.im, b.im, a.re * b.re), madd(a.re, b.im, a.im * b.re)};
+}
+
+template <class T>
+FEXPR_INLINE Pair<T> div(const Pair<T>& a, const Pair<T>& b)
+{
+    T inv = T(1.0) / madd(b.re, b.re, b.im * b.im);
+    return {madd(a.re, b.re, a.im * b.im) * inv, nmadd(a.re, b.im, a.im * b.re) * inv};
+}
+
+template <class T>
+FEXPR_INLINE T norm(const Pair<T>& z)
+{
+    return madd(z.re, z.re, z.im * z.im);
+}
+
+template <class T>
+FEXPR_INLINE T modulus(const Pair<T>& z)
+{
+    using std::sqrt;
+    return sqrt(norm(z));
+}
+}  // namespace complex_special
+
+namespace complex_lookup
+{
+// these hide the forge::expr and std overloads, so that only
+// argument-dependent lookup on the Forge value type can find a native operation
+void sin();
+void cos();
+void atan2();
+
+template <class T, class = void>
+struct HasSinCos : std::false_type
+{
+};
+template <class T>
+struct HasSinCos<T, decltype(void(sin(std::declval<const T&>())), void(cos(std::declval<const T&>())))>
+    : std::true_type
+{
+};
+
+template <class T, class = void>
+struct HasAtan2 : std::false_type
+{
+};
+template <class T>
+struct HasAtan2<T, decltype(void(atan2(std::declval<const T&>(), std::declval<const T&>())))>
+    : std::true_type
+{
+};
+
+template <class T>
+FEXPR_INLINE complex_special::Pair<T> sincosOf(const T& a, std::true_type)
+{
+    return {sin(a), cos(a)};
+}
+template <class T>
+FEXPR_INLINE complex_special::Pair<T> sincosOf(const T& a, std::false_type)
+{
+    return complex_special::sincos(a);
+}
+
+template <class T>
+FEXPR_INLINE T atan2Of(const T& y, const T& x, std::true_type)
+{
+    return atan2(y, x);
+}
+template <class T>
+FEXPR_INLINE T atan2Of(const T& y, const T& x, std::false_type)
+{
+    return complex_special::atan2(y, x);
+}
+}  // namespace complex_lookup
+
+namespace detail
+{
+typedef complex_special::Pair<::forge::fdouble> ForgeComplex;
+
+/// records (sin a, cos a), as two nodes if Forge supports them
+FEXPR_INLINE ForgeComplex forgeSinCos(const ::forge::fdouble& a)
+{
+    return complex_lookup::sincosOf(a, complex_lookup::HasSinCos<::forge::fdouble>());
+}
+
+/// records atan2(y, x), as one node if Forge supports it
+FEXPR_INLINE ::forge::fdouble forgeAtan2(const ::forge::fdouble& y, const ::forge::fdouble& x)
+{
+    return complex_lookup::atan2Of(y, x, complex_lookup::HasAtan2<::forge::fdouble>());
+}
+
+/// records a * b
+FEXPR_INLINE ForgeComplex forgeComplexMul(const ForgeComplex& a, const ForgeComplex& b)
+{
+    return complex_special::mul(a, b);
+}
+
+/// records a / b
+FEXPR_INLINE ForgeComplex forgeComplexDiv(const ForgeComplex& a, const ForgeComplex& b)
+{
+    return complex_special::div(a, b);
+}
+
+/// records |z|
+FEXPR_INLINE ::forge::fdouble forgeComplexAbs(const ForgeComplex& z)
+{
+    return complex_special::modulus(z);
+}
+
+/// records arg(z)
+FEXPR_INLINE ::forge::fdouble forgeComplexArg(const ForgeComplex& z)
+{
+    return forgeAtan2(z.im, z.re);
+}
+
+/// records exp(z)
+FEXPR_INLINE ForgeComplex forgeComplexExp(const ForgeComplex& z)
+{
+    ::forge::fdouble e = ::forge::exp(z.re);
+    ForgeComplex sc = forgeSinCos(z.im);
+    return {e * sc.im, e * sc.re};
+}
+
+/// records the principal value of log(z)
+FEXPR_INLINE ForgeComplex forgeComplexLog(const ForgeComplex& z)
+{
+    return {::forge::fdouble(0.5) * ::forge::log(complex_special::norm(z)), forgeComplexArg(z)};
+}
+
+/// records the principal value of sqrt(z)
+FEXPR_INLINE ForgeComplex forgeComplexSqrt(const ForgeComplex& z)
+{
+    using complex_special::select;
+    const ::forge::fdouble zero(0.0);
+    ::forge::fdouble ax = ::forge::abs(z.re);
+    // t = sqrt((|x| + |z|) / 2) without cancellation; the guard keeps the
+    // unselected quotient finite at z = 0
+    ::forge::fdouble t = ::forge::sqrt(::forge::fdouble(0.5) * (ax + complex_special::modulus(z)));
+    ::forge::fdouble half = ::forge::fdouble(0.5) * z.im /
+                            ::forge::max(t, ::forge::fdouble(std::numeric_limits<double>::min()));
+    ::forge::fdouble re = select(z.re >= zero, t, ::forge::abs(half));
+    ::forge::fdouble im = select(z.re >= zero, half, select(z.im < zero, -t, t));
+    return {re, im};
+}
+}  // namespace detail
+
+}}  // namespace forge::expr
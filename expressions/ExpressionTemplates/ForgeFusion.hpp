@@ -0,0 +1,166 @@
+/*******************************************************************************
+
+   Fused multiply-add recording for Forge values.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#pragma once
+
+#include <expressions/Macros.hpp>
+
+// ========== Forge Integration: fused multiply-add ==========
+// Binary expressions of the shapes a * b + c, c + a * b and c - a * b are
+// recorded through forgeMultiplyAdd / forgeNegMultiplyAdd below, so that they
+// become a single node whenever Forge provides fused operations on fdouble,
+// i.e. fma(a, b, c) == a * b + c and fnma(a, b, c) == c - a * b found by
+// argument-dependent lookup.  Without them, or with FEXPR_FORGE_NO_FUSION
+// defined, the usual multiply and add nodes are recorded.
+#include <types/fdouble.hpp>
+// ===========================================================
+
+#include <type_traits>
+#include <utility>
+
+namespace forge { namespace expr {
+
+template <class Scalar, class Op, class Expr1, class Expr2, class DerivativeType>
+struct BinaryExpr;
+
+template <class Scalar>
+struct add_op;
+
+template <class Scalar>
+struct sub_op;
+
+template <class Scalar>
+struct prod_op;
+
+namespace fusion_lookup
+{
+// these hide forge::expr::fma and std::fma, so that only argument-dependent
+// lookup on the Forge value type can find a fused operation
+void fma();
+void fnma();
+
+template <class T, class = void>
+struct HasFma : std::false_type
+{
+};
+
+template <class T>
+struct HasFma<T, decltype(void(fma(std::declval<const T&>(), std::declval<const T&>(),
+                                   std::declval<const T&>())))> : std::true_type
+{
+};
+
+template <class T, class = void>
+struct HasFnma : std::false_type
+{
+};
+
+template <class T>
+struct HasFnma<T, decltype(void(fnma(std::declval<const T&>(), std::declval<const T&>(),
+                                     std::declval<const T&>())))> : std::true_type
+{
+};
+
+template <class T>
+FEXPR_INLINE T multiplyAdd(const T& a, const T& b, const T& c, std::true_type)
+{
+    return fma(a, b, c);
+}
+
+template <class T>
+FEXPR_INLINE T multiplyAdd(const T& a, const T& b, const T& c, std::false_type)
+{
+    return a * b + c;
+}
+
+template <class T>
+FEXPR_INLINE T negMultiplyAdd(const T& a, const T& b, const T& c, std::true_type)
+{
+    return fnma(a, b, c);
+}
+
+template <class T>
+FEXPR_INLINE T negMultiplyAdd(const T& a, const T& b, const T& c, std::false_type)
+{
+    return c - a * b;
+}
+}  // namespace fusion_lookup
+
+namespace detail
+{
+#ifdef FEXPR_FORGE_NO_FUSION
+static constexpr bool forgeHasFma = false;
+static constexpr bool forgeHasFnma = false;
+#else
+static constexpr bool forgeHasFma = fusion_lookup::HasFma<::forge::fdouble>::value;
+static constexpr bool forgeHasFnma = fusion_lookup::HasFnma<::forge::fdouble>::value;
+#endif
+
+/// records a * b + c, as one node if Forge supports it
+FEXPR_INLINE ::forge::fdouble forgeMultiplyAdd(const ::forge::fdouble& a, const ::forge::fdouble& b,
+                                               const ::forge::fdouble& c)
+{
+    return fusion_lookup::multiplyAdd(a, b, c, std::integral_constant<bool, forgeHasFma>());
+}
+
+/// records c - a * b, as one node if Forge supports it
+FEXPR_INLINE ::forge::fdouble forgeNegMultiplyAdd(const ::forge::fdouble& a, const ::forge::fdouble& b,
+                                                  const ::forge::fdouble& c)
+{
+    return fusion_lookup::negMultiplyAdd(a, b, c, std::integral_constant<bool, forgeHasFnma>());
+}
+
+/// true for expressions of the form a * b
+template <class T>
+struct IsProductExpr : std::false_type
+{
+};
+
+template <class Scalar, class Expr1, class Expr2, class DerivativeType>
+struct IsProductExpr<BinaryExpr<Scalar, prod_op<Scalar>, Expr1, Expr2, DerivativeType>>
+    : std::true_type
+{
+};
+
+/// how a binary expression with operator Op is recorded in Forge
+enum class ForgeFusion
+{
+    None,
+    MultiplyAddLeft,      // (a * b) + c
+    MultiplyAddRight,     // c + (a * b)
+    NegMultiplyAddRight,  // c - (a * b)
+};
+
+template <class Op, class Expr1, class Expr2>
+struct ForgeFusionOf : std::integral_constant<ForgeFusion, ForgeFusion::None>
+{
+};
+
+template <class Scalar, class Expr1, class Expr2>
+struct ForgeFusionOf<add_op<Scalar>, Expr1, Expr2>
+    : std::integral_constant<ForgeFusion, !forgeHasFma                 ? ForgeFusion::None
+                                          : IsProductExpr<Expr1>::value ? ForgeFusion::MultiplyAddLeft
+                                          : IsProductExpr<Expr2>::value ? ForgeFusion::MultiplyAddRight
+                                                                        : ForgeFusion::None>
+{
+};
+
+template <class Scalar, class Expr1, class Expr2>
+struct ForgeFusionOf<sub_op<Scalar>, Expr1, Expr2>
+    : std::integral_constant<ForgeFusion, forgeHasFnma && IsProductExpr<Expr2>::value
+                                              ? ForgeFusion::NegMultiplyAddRight
+                                              : ForgeFusion::None>
+{
+};
+}  // namespace detail
+
+}}  // namespace forge::expr
@@ -0,0 +1,350 @@
+/*******************************************************************************
+
+   Normal distribution and error function intrinsics for Forge values.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#pragma once
+
+#include <expressions/Macros.hpp>
+
+// ========== Forge Integration: special function intrinsics ==========
+// erf, erfc, normcdf, normpdf and inverse_normcdf, and for the boost::math
+// overloads of ql/qlforge.hpp also log1p, expm1, lgamma, tgamma, erf_inv and
+// erfc_inv, are recorded as single nodes whenever Forge provides them on
+// fdouble, found by argument-dependent lookup like the fused operations in
+// ForgeFusion.hpp.  Otherwise they are recorded as one fixed, branch-free
+// sequence of arithmetic nodes:
+//
+//  - erfc uses the Chebyshev expansion of Numerical Recipes (3rd ed., 6.2.2),
+//    accurate to about 1e-14 relative for |x| < 6 and 1e-13 beyond,
+//  - erf uses the fdlibm rational approximation for |x| < 0.84375 and erfc
+//    elsewhere,
+//  - inverse_normcdf uses Acklam's rational approximation refined by one
+//    Halley step, accurate to about 1e-14 relative,
+//  - log1p and expm1 use Taylor series for |x| < 0.05 and log and exp beyond,
+//  - lgamma and tgamma use the Lanczos approximation and hold for x > 0 only.
+//
+// Either way the graph is a small fraction of the unrolled, region-by-region
+// recording of QuantLib's ErrorFunction and CumulativeNormalDistribution, and
+// Forge differentiates it with its usual adjoints.  The same formulas
+// evaluated on doubles provide the passive values of normcdf, normpdf and
+// inverse_normcdf.
+#include <types/fbool.hpp>
+#include <types/fdouble.hpp>
+// ====================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <utility>
+
+namespace forge { namespace expr {
+
+namespace special
+{
+// the formulas below are written once for double and fdouble
+
+FEXPR_INLINE double select(bool cond, double a, double b) { return cond ? a : b; }
+
+FEXPR_INLINE ::forge::fdouble select(const ::forge::fbool& cond, const ::forge::fdouble& a,
+                                     const ::forge::fdouble& b)
+{
+    return cond.If(a, b);
+}
+
+template <class T>
+FEXPR_INLINE T poly(const T& x, const double* c, int n)
+{
+    T r = T(c[n - 1]);
+    for (int i = n - 2; i >= 0; --i)
+        r = r * x + T(c[i]);
+    return r;
+}
+
+/// erfc(z) for z >= 0, Numerical Recipes erfccheb
+template <class T>
+FEXPR_INLINE T erfcPositive(const T& z)
+{
+    using std::exp;
+    static const double cof[28] = {
+        -1.3026537197817094,   6.4196979235649026e-1, 1.9476473204185836e-2,
+        -9.561514786808631e-3, -9.46595344482036e-4,  3.66839497852761e-4,
+        4.2523324806907e-5,    -2.0278578112534e-5,   -1.624290004647e-6,
+        1.303655835580e-6,     1.5626441722e-8,       -8.5238095915e-8,
+        6.529054439e-9,        5.059343495e-9,        -9.91364156e-10,
+        -2.27365122e-10,       9.6467911e-11,         2.394038e-12,
+        -6.886027e-12,         8.94487e-13,           3.13092e-13,
+        -1.12708e-13,          3.81e-16,              7.106e-15,
+        -1.523e-15,            -9.4e-17,              1.21e-16,
+        -2.8e-17};
+    T t = T(2.0) / (T(2.0) + z);
+    T ty = T(4.0) * t - T(2.0);
+    T d = T(0.0), dd = T(0.0);
+    for (int j = 27; j > 0; --j)
+    {
+        T tmp = d;
+        d = ty * d - dd + T(cof[j]);
+        dd = tmp;
+    }
+    return t * exp(-z * z + T(0.5) * (T(cof[0]) + ty * d) - dd);
+}
+
+template <class T>
+FEXPR_INLINE T erfc(const T& x)
+{
+    using std::abs;
+    T r = erfcPositive(T(abs(x)));
+    return select(x >= T(0.0), r, T(2.0) - r);
+}
+
+template <class T>
+FEXPR_INLINE T erf(const T& x)
+{
+    using std::abs;
+    // fdlibm s_erf.c, |x| < 0.84375
+    static const double pp[5] = {1.28379167095512558561e-01, -3.25042107247001499370e-01,
+                                 -2.84817495755985104766e-02, -5.77027029648944159157e-03,
+                                 -2.37630166566501626084e-05};
+    static const double qq[6] = {1.0,
+                                 3.97917223959155352819e-01,
+                                 6.50222499887672944485e-02,
+                                 5.08130628187576562776e-03,
+                                 1.32494738004321644526e-04,
+                                 -3.96022827877536812320e-06};
+    T ax = abs(x);
+    T z = x * x;
+    T small = x + x * (poly(z, pp, 5) / poly(z, qq, 6));
+    T rc = erfcPositive(ax);
+    T large = select(x >= T(0.0), T(1.0) - rc, rc - T(1.0));
+    return select(ax < T(0.84375), small, large);
+}
+
+template <class T>
+FEXPR_INLINE T normcdf(const T& x)
+{
+    return T(0.5) * erfc(T(-0.70710678118654752440084436210484903928483593768847) * x);
+}
+
+template <class T>
+FEXPR_INLINE T normpdf(const T& x)
+{
+    using std::exp;
+    return T(0.39894228040143267793994605993438186847585863116493) * exp(T(-0.5) * x * x);
+}
+
+/// Acklam's approximation, refined by one Halley step
+template <class T>
+FEXPR_INLINE T inverse_normcdf(const T& p)
+{
+    using std::exp;
+    using std::log;
+    using std::min;
+    using std::sqrt;
+    static const double a[6] = {2.506628277459239e+00,  -3.066479806614716e+01,
+                                1.383577518672690e+02,  -2.759285104469687e+02,
+                                2.209460984245205e+02,  -3.969683028665376e+01};
+    static const double b[6] = {1.0,
+                                -1.328068155288572e+01, 6.680131188771972e+01,
+                                -1.556989798598866e+02, 1.615858368580409e+02,
+                                -5.447609879822406e+01};
+    static const double c[6] = {2.938163982698783e+00,  4.374664141464968e+00,
+                                -2.549732539343734e+00, -2.400758277161838e+00,
+                                -3.223964580411365e-01, -7.784894002430293e-03};
+    static const double d[5] = {1.0, 3.754408661907416e+00, 2.445134137142996e+00,
+                                3.224671290700398e-01, 7.784695709041462e-03};
+    // work on the lower half, where the refinement is accurate
+    T pm = min(p, T(1.0) - p);
+    T q = pm - T(0.5);
+    T r = q * q;
+    T central = q * poly(r, a, 6) / poly(r, b, 6);
+    T s = sqrt(T(-2.0) * log(pm));
+    T tail = poly(s, c, 6) / poly(s, d, 5);
+    T x = select(pm < T(0.02425), tail, central);
+    T e = T(0.5) * erfcPositive(T(-0.70710678118654752440084436210484903928483593768847) * x) - pm;
+    T u = e * T(2.50662827463100050241576528481104525300698674060994) * exp(T(0.5) * x * x);
+    x = x - u / (T(1.0) + T(0.5) * x * u);
+    return select(p > T(0.5), -x, x);
+}
+
+/// log(1 + x): Taylor series for |x| < 0.05, where log(1 + x) would cancel
+template <class T>
+FEXPR_INLINE T log1p(const T& x)
+{
+    using std::abs;
+    using std::log;
+    static const double c[12] = {1.0,        -1.0 / 2,  1.0 / 3,  -1.0 / 4,
+                                 1.0 / 5,    -1.0 / 6,  1.0 / 7,  -1.0 / 8,
+                                 1.0 / 9,    -1.0 / 10, 1.0 / 11, -1.0 / 12};
+    return select(T(abs(x)) < T(0.05), x * poly(x, c, 12), log(T(1.0) + x));
+}
+
+/// exp(x) - 1: Taylor series for |x| < 0.05
+template <class T>
+FEXPR_INLINE T expm1(const T& x)
+{
+    using std::abs;
+    using std::exp;
+    static const double c[10] = {1.0,         1.0 / 2,      1.0 / 6,       1.0 / 24,
+                                 1.0 / 120,   1.0 / 720,    1.0 / 5040,    1.0 / 40320,
+                                 1.0 / 362880, 1.0 / 3628800};
+    return select(T(abs(x)) < T(0.05), x * poly(x, c, 10), exp(x) - T(1.0));
+}
+
+/// log of the gamma function for x > 0, Lanczos approximation (g = 7, n = 9)
+template <class T>
+FEXPR_INLINE T lgamma(const T& x)
+{
+    using std::log;
+    static const double p[9] = {0.99999999999980993,  676.5203681218851,   -1259.1392167224028,
+                                771.32342877765313,   -176.61502916214059, 12.507343278686905,
+                                -0.13857109526572012, 9.9843695780195716e-6,
+                                1.5056327351493116e-7};
+    // the approximation holds for x >= 0.5; below, lgamma(x) = lgamma(x + 1) - log(x)
+    T y = select(x < T(0.5), x + T(1.0), x);
+    T z = y - T(1.0);
+    T a = T(p[0]);
+    for (int i = 1; i < 9; ++i)
+        a = a + T(p[i]) / (z + T(double(i)));
+    T t = z + T(7.5);
+    T result = T(0.91893853320467274178032973640561763986139747363778) + (z + T(0.5)) * log(t) -
+               t + log(a);
+    return select(x < T(0.5), result - log(x), result);
+}
+
+/// gamma function for x > 0
+template <class T>
+FEXPR_INLINE T tgamma(const T& x)
+{
+    using std::exp;
+    return exp(lgamma(x));
+}
+
+/// inverse of erfc on (0, 2)
+template <class T>
+FEXPR_INLINE T erfc_inv(const T& z)
+{
+    return T(-0.70710678118654752440084436210484903928483593768847) * inverse_normcdf(T(0.5) * z);
+}
+
+/// inverse of erf on (-1, 1)
+template <class T>
+FEXPR_INLINE T erf_inv(const T& x)
+{
+    using std::exp;
+    // erfc_inv(1 - x) loses relative accuracy for small x; one Halley step on
+    // erf, which is accurate there, restores it
+    T y = erfc_inv(T(1.0) - x);
+    T u = (erf(y) - x) / (T(1.1283791670955125738961589031215451716881013) * exp(-y * y));
+    return y - u / (T(1.0) + y * u);
+}
+
+}  // namespace special
+
+namespace special_lookup
+{
+// these hide the forge::expr overloads, so that only argument-dependent
+// lookup on the Forge value type can find a native operation
+void erf();
+void erfc();
+void normcdf();
+void normpdf();
+void inverse_normcdf();
+void log1p();
+void expm1();
+void lgamma();
+void tgamma();
+void erf_inv();
+void erfc_inv();
+
+#define FEXPR_FORGE_NATIVE_LOOKUP(func, trait)                                                     \
+    template <class T, class = void>                                                               \
+    struct trait : std::false_type                                                                 \
+    {                                                                                              \
+    };                                                                                             \
+    template <class T>                                                                             \
+    struct trait<T, decltype(void(func(std::declval<const T&>())))> : std::true_type               \
+    {                                                                                              \
+    };                                                                                             \
+    template <class T>                                                                             \
+    FEXPR_INLINE T func##Of(const T& a, std::true_type)                                            \
+    {                                                                                              \
+        return func(a);                                                                            \
+    }                                                                                              \
+    template <class T>                                                                             \
+    FEXPR_INLINE T func##Of(const T& a, std::false_type)                                           \
+    {                                                                                              \
+        return special::func(a);                                                                   \
+    }
+
+FEXPR_FORGE_NATIVE_LOOKUP(erf, HasErf)
+FEXPR_FORGE_NATIVE_LOOKUP(erfc, HasErfc)
+FEXPR_FORGE_NATIVE_LOOKUP(normcdf, HasNormCdf)
+FEXPR_FORGE_NATIVE_LOOKUP(normpdf, HasNormPdf)
+FEXPR_FORGE_NATIVE_LOOKUP(inverse_normcdf, HasInverseNormCdf)
+FEXPR_FORGE_NATIVE_LOOKUP(log1p, HasLog1p)
+FEXPR_FORGE_NATIVE_LOOKUP(expm1, HasExpm1)
+FEXPR_FORGE_NATIVE_LOOKUP(lgamma, HasLgamma)
+FEXPR_FORGE_NATIVE_LOOKUP(tgamma, HasTgamma)
+FEXPR_FORGE_NATIVE_LOOKUP(erf_inv, HasErfInv)
+FEXPR_FORGE_NATIVE_LOOKUP(erfc_inv, HasErfcInv)
+
+#undef FEXPR_FORGE_NATIVE_LOOKUP
+}  // namespace special_lookup
+
+namespace detail
+{
+#define FEXPR_FORGE_SPECIAL_FUNCTION(name, func, trait)                                            \
+    FEXPR_INLINE ::forge::fdouble name(const ::forge::fdouble& a)                                  \
+    {                                                                                              \
+        return special_lookup::func##Of(a, special_lookup::trait<::forge::fdouble>());             \
+    }
+
+/// records erf(a), as one node if Forge supports it
+FEXPR_FORGE_SPECIAL_FUNCTION(forgeErf, erf, HasErf)
+/// records erfc(a), as one node if Forge supports it
+FEXPR_FORGE_SPECIAL_FUNCTION(forgeErfc, erfc, HasErfc)
+/// records the standard normal CDF of a, as one node if Forge supports it
+FEXPR_FORGE_SPECIAL_FUNCTION(forgeNormCdf, normcdf, HasNormCdf)
+/// records the standard normal density at a, as one node if Forge supports it
+FEXPR_FORGE_SPECIAL_FUNCTION(forgeNormPdf, normpdf, HasNormPdf)
+/// records the inverse standard normal CDF of a, as one node if Forge supports it
+FEXPR_FORGE_SPECIAL_FUNCTION(forgeInverseNormCdf, inverse_normcdf, HasInverseNormCdf)
+/// records log(1 + a), as one node if Forge supports it
+FEXPR_FORGE_SPECIAL_FUNCTION(forgeLog1p, log1p, HasLog1p)
+/// records exp(a) - 1, as one node if Forge supports it
+FEXPR_FORGE_SPECIAL_FUNCTION(forgeExpm1, expm1, HasExpm1)
+/// records log(gamma(a)) for a > 0, as one node if Forge supports it
+FEXPR_FORGE_SPECIAL_FUNCTION(forgeLgamma, lgamma, HasLgamma)
+/// records gamma(a) for a > 0, as one node if Forge supports it
+FEXPR_FORGE_SPECIAL_FUNCTION(forgeTgamma, tgamma, HasTgamma)
+/// records the inverse of erf, as one node if Forge supports it
+FEXPR_FORGE_SPECIAL_FUNCTION(forgeErfInv, erf_inv, HasErfInv)
+/// records the inverse of erfc, as one node if Forge supports it
+FEXPR_FORGE_SPECIAL_FUNCTION(forgeErfcInv, erfc_inv, HasErfcInv)
+
+#undef FEXPR_FORGE_SPECIAL_FUNCTION
+}  // namespace detail
+
+/// standard normal CDF
+FEXPR_INLINE double normcdf(double x)
+{
+    return 0.5 * std::erfc(-0.70710678118654752440084436210484903928483593768847 * x);
+}
+FEXPR_INLINE float normcdf(float x) { return float(normcdf(double(x))); }
+
+/// standard normal density
+FEXPR_INLINE double normpdf(double x) { return special::normpdf(x); }
+FEXPR_INLINE float normpdf(float x) { return float(normpdf(double(x))); }
+
+/// inverse of the standard normal CDF
+FEXPR_INLINE double inverse_normcdf(double p) { return special::inverse_normcdf(p); }
+FEXPR_INLINE float inverse_normcdf(float p) { return float(inverse_normcdf(double(p))); }
+
+}}  // namespace forge::expr
@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include <expressions/Diagnostics.hpp>
 #include <expressions/Expression.hpp>
 #include <expressions/Macros.hpp>
 #include <expressions/Traits.hpp>
@@ -24,6 +25,7 @@
 
 // ========== Forge Integration: forward declarations and includes ==========
 #include <types/fdouble.hpp>
+#include <expressions/ExpressionTemplates/ForgeSpecialFunctions.hpp>
 
 namespace forge { namespace expr {
 // Forward-declare unary functors we want to handle specially for Forge
@@ -57,8 +59,44 @@ struct exp_op;
 template <class Scalar>
 struct log_op;
 
+template <class Scalar>
+struct abs_op;
+
 template <class Scalar>
 struct fabs_op;
+
+template <class Scalar, class T2>
+struct scalar_max_op;
+
+template <class Scalar, class T2>
+struct scalar_fmax_op;
+
+template <class Scalar, class T2>
+struct scalar_min_op;
+
+template <class Scalar, class T2>
+struct scalar_fmin_op;
+
+template <class Scalar>
+struct erf_op;
+
+template <class Scalar>
+struct erfc_op;
+
+template <class Scalar>
+struct normcdf_op;
+
+template <class Scalar>
+struct normpdf_op;
+
+template <class Scalar>
+struct inverse_normcdf_op;
+
+template <class Scalar>
+struct log1p_op;
+
+template <class Scalar>
+struct expm1_op;
 }}  // namespace forge::expr
 // ==========================================================================
 
@@ -96,7 +134,8 @@ struct UnaryExpr : Expression<Scalar, UnaryExpr<Scalar, Op, Expr, DerivativeType
 {
     typedef detail::UnaryDerivativeImpl<OperatorTraits<Op>::useResultBasedDerivatives == 1>
         der_impl;
-    FEXPR_INLINE explicit UnaryExpr(const Expr& a, Op op = Op()) : a_(a), op_(op), v_(op_(a_.value()))
+    FEXPR_INLINE explicit UnaryExpr(const Expr& a, Op op = Op())
+        : a_(a), op_(op), v_(op_(detail::passiveValue(a_)))
     {
     }
     FEXPR_INLINE Scalar value() const { return v_; }
@@ -136,9 +175,10 @@ struct UnaryExpr : Expression<Scalar, UnaryExpr<Scalar, Op, Expr, DerivativeType
 
     // ========== Forge Integration helpers =========================================
     template <class T>
-    FEXPR_INLINE ::forge::fdouble getForgeValue(const T& expr) const
+    FEXPR_INLINE decltype(auto) getForgeValue(const T& expr) const
     {
-        // Rely on nested expressions / literals to provide forgeValue().
+        // Rely on nested expressions / literals to provide forgeValue();
+        // a literal's is passed on by reference, without a copy.
         return expr.forgeValue();
     }
 
@@ -238,6 +278,82 @@ struct UnaryExpr : Expression<Scalar, UnaryExpr<Scalar, Op, Expr, DerivativeType
         // Use Forge's own abs to avoid ambiguity with std::abs/fabs overloads.
         return ::forge::abs(a);
     }
+    static FEXPR_INLINE ::forge::fdouble performForgeOp(const abs_op<Scalar>&,
+                                                    const ::forge::fdouble& a)
+    {
+        return ::forge::abs(a);
+    }
+
+    // max / fmax with a scalar: max(a, b)
+    template <class T2>
+    static FEXPR_INLINE ::forge::fdouble performForgeOp(const scalar_max_op<Scalar, T2>& op,
+                                                    const ::forge::fdouble& a)
+    {
+        ::forge::fdouble b(op.b_);
+        return ::forge::max(a, b);
+    }
+    template <class T2>
+    static FEXPR_INLINE ::forge::fdouble performForgeOp(const scalar_fmax_op<Scalar, T2>& op,
+                                                    const ::forge::fdouble& a)
+    {
+        ::forge::fdouble b(op.b_);
+        return ::forge::max(a, b);
+    }
+
+    // min / fmin with a scalar: min(a, b)
+    template <class T2>
+    static FEXPR_INLINE ::forge::fdouble performForgeOp(const scalar_min_op<Scalar, T2>& op,
+                                                    const ::forge::fdouble& a)
+    {
+        ::forge::fdouble b(op.b_);
+        return ::forge::min(a, b);
+    }
+    template <class T2>
+    static FEXPR_INLINE ::forge::fdouble performForgeOp(const scalar_fmin_op<Scalar, T2>& op,
+                                                    const ::forge::fdouble& a)
+    {
+        ::forge::fdouble b(op.b_);
+        return ::forge::min(a, b);
+    }
+
+    // error function and normal distribution (see ForgeSpecialFunctions.hpp)
+    static FEXPR_INLINE ::forge::fdouble performForgeOp(const erf_op<Scalar>&,
+                                                    const ::forge::fdouble& a)
+    {
+        return detail::forgeErf(a);
+    }
+    static FEXPR_INLINE ::forge::fdouble performForgeOp(const erfc_op<Scalar>&,
+                                                    const ::forge::fdouble& a)
+    {
+        return detail::forgeErfc(a);
+    }
+    static FEXPR_INLINE ::forge::fdouble performForgeOp(const normcdf_op<Scalar>&,
+                                                    const ::forge::fdouble& a)
+    {
+        return detail::forgeNormCdf(a);
+    }
+    static FEXPR_INLINE ::forge::fdouble performForgeOp(const normpdf_op<Scalar>&,
+                                                    const ::forge::fdouble& a)
+    {
+        return detail::forgeNormPdf(a);
+    }
+    static FEXPR_INLINE ::forge::fdouble performForgeOp(const inverse_normcdf_op<Scalar>&,
+                                                    const ::forge::fdouble& a)
+    {
+        return detail::forgeInverseNormCdf(a);
+    }
+
+    // log1p / expm1
+    static FEXPR_INLINE ::forge::fdouble performForgeOp(const log1p_op<Scalar>&,
+                                                    const ::forge::fdouble& a)
+    {
+        return detail::forgeLog1p(a);
+    }
+    static FEXPR_INLINE ::forge::fdouble performForgeOp(const expm1_op<Scalar>&,
+                                                    const ::forge::fdouble& a)
+    {
+        return detail::forgeExpm1(a);
+    }
 
     // Fallback for other unary functors: re-create a Forge value from the numeric value.
     // This keeps dependencies correct for the expression templates but may need extending with more special-
@@ -245,13 +361,8 @@ struct UnaryExpr : Expression<Scalar, UnaryExpr<Scalar, Op, Expr, DerivativeType
     template <class OpT>
     static FEXPR_INLINE ::forge::fdouble performForgeOp(const OpT&, const ::forge::fdouble& a)
     {
-        // DEBUG: Log when unhandled unary operators hit the fallback path
-        static std::size_t fallbackCount = 0;
-        if (fallbackCount < 5) {
-            ++fallbackCount;
-            std::cerr << "[Forge][DEBUG] UnaryExpr fallback hit for unhandled operator type: "
-                      << typeid(OpT).name() << " (occurrence " << fallbackCount << ")\n";
-        }
+        // Unhandled unary operators record a constant: report the graph drop
+        FEXPR_FORGE_GRAPH_DROP(a.isActive(), typeid(OpT).name());
         // Convert to plain double and back into a forge::fdouble node.
         return ::forge::fdouble(static_cast<double>(a));
     }
@@ -18,6 +18,7 @@
 #include <expressions/Macros.hpp>
 #include <expressions/Compatibility/MathFunctions.hpp>
 #include <expressions/ExpressionTemplates/UnaryFunctors.hpp>
+#include <expressions/ExpressionTemplates/ForgeSpecialFunctions.hpp>
 #include <type_traits>
 
 namespace forge { namespace expr {
@@ -72,6 +73,8 @@ FEXPR_MAKE_UNARY_FUNCTOR(atanh, Scalar(1) / (Scalar(1) - a * a))
 
 FEXPR_MAKE_UNARY_FUNCTOR(erf, Scalar(1.1283791670955125738961589031215451716881013) * exp(-a * a))
 FEXPR_MAKE_UNARY_FUNCTOR(erfc, Scalar(-1.1283791670955125738961589031215451716881013) * exp(-a * a))
+FEXPR_MAKE_UNARY_FUNCTOR(normcdf, Scalar(0.3989422804014326779399460599343818684758586) * exp(Scalar(-0.5) * a * a))
+FEXPR_MAKE_UNARY_FUNCTOR(normpdf, -a * Scalar(0.3989422804014326779399460599343818684758586) * exp(Scalar(-0.5) * a * a))
 FEXPR_MAKE_UNARY_FUNCTOR(abs, (a > Scalar()) - (a < Scalar()))
 FEXPR_MAKE_UNARY_FUNCTOR(floor, Scalar())
 FEXPR_MAKE_UNARY_FUNCTOR(ceil, Scalar())
@@ -103,6 +106,7 @@ FEXPR_MAKE_UNARY_FUNCTOR_RES(exp, v)
 FEXPR_MAKE_UNARY_FUNCTOR_RES(tanh, Scalar(1) - v * v)
 FEXPR_MAKE_UNARY_FUNCTOR_RES(sqrt, Scalar(0.5) / v)
 FEXPR_MAKE_UNARY_FUNCTOR_RES(cbrt, Scalar(1) / Scalar(3) / (v * v))
+FEXPR_MAKE_UNARY_FUNCTOR_RES(inverse_normcdf, Scalar(2.506628274631000502415765284811045253006987) * exp(Scalar(0.5) * v * v))
 
 // tangent
 
@@ -323,6 +323,9 @@ FEXPR_MAKE_UNARY_FUNC(cbrt)
 FEXPR_MAKE_UNARY_FUNC(tan)
 FEXPR_MAKE_UNARY_FUNC(erf)
 FEXPR_MAKE_UNARY_FUNC(erfc)
+FEXPR_MAKE_UNARY_FUNC(normcdf)
+FEXPR_MAKE_UNARY_FUNC(normpdf)
+FEXPR_MAKE_UNARY_FUNC(inverse_normcdf)
 
 // no special AD treatement here, but we need the overloads
 
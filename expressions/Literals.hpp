@@ -15,21 +15,28 @@
 
 #pragma once
 
+#include <expressions/Diagnostics.hpp>
 #include <expressions/Expression.hpp>
 #include <expressions/Exceptions.hpp>
+#include <expressions/Tape.hpp>
 #include <expressions/Traits.hpp>
 
 // ========== Forge Integration: Add Forge includes ==========
 #include <types/fdouble.hpp>
+#include <graph/graph_recorder.hpp>  // For GraphRecorder::isAnyRecording()
 #include <graph/handles.hpp>  // For NodeId type
+#include <expressions/ExpressionTemplates/ForgeFusion.hpp>  // For horner()
 // ===========================================================
 
 #include <algorithm>
 #include <complex>
+#include <cstddef>
+#include <initializer_list>
 #include <iosfwd>
 #include <iostream>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <utility>
 
 namespace forge { namespace expr {
@@ -46,141 +53,27 @@ namespace forge { namespace expr {
 #else
 #define FEXPR_INLINE inline
 #endif
-// Forward declaration for AReal (needed by TapeStub)
-template <class, std::size_t>
-struct AReal;
-
-// Minimal TapeStub class definition for template file
-// Provides complete interface matching Tape class for template compatibility
-// Users will implement their own Tape class to replace this stub
-// All methods throw runtime errors to indicate they need implementation
+// Former name of the tape type, kept for code written against the stub
 template <class Scalar, std::size_t N>
-class TapeStub {
-public:
-    typedef unsigned int slot_type;
-    typedef Scalar value_type;
-    typedef AReal<Scalar, N> active_type;
-    typedef typename DerivativesTraits<Scalar, N>::type derivative_type;
-    static constexpr slot_type INVALID_SLOT = slot_type(-1);
-
-    // Static method needed for compilation (called via tape_type::getActive() throughout code)
-    static TapeStub* getActive() { return nullptr; }
-
-    // Tape interface methods - all throw runtime errors in template
-    // Users implementing their own tape backend will provide the full implementation
-
-    void activate() {
-        throw NoTapeException("Template file: Tape backend not implemented. Users must provide their own Tape implementation.");
-    }
-
-    void deactivate() {
-        throw NoTapeException("Template file: Tape backend not implemented. Users must provide their own Tape implementation.");
-    }
-
-    bool isActive() const { return false; }
-
-    static void setActive(TapeStub* t) {
-        (void)t;  // Suppress unused parameter
-        throw NoTapeException("Template file: Tape backend not implemented. Users must provide their own Tape implementation.");
-    }
-
-    static void deactivateAll() {
-        // No-op for template
-    }
-
-    void registerInput(active_type& inp) {
-        (void)inp;  // Suppress unused parameter
-        throw NoTapeException("Template file: Tape backend not implemented. Users must provide their own Tape implementation.");
-    }
-
-    void registerInput(std::complex<active_type>& inp) {
-        (void)inp;  // Suppress unused parameter
-        throw NoTapeException("Template file: Tape backend not implemented. Users must provide their own Tape implementation.");
-    }
-
-    template <class It>
-    void registerInputs(It first, It last) {
-        (void)first;
-        (void)last;
-        throw NoTapeException("Template file: Tape backend not implemented. Users must provide their own Tape implementation.");
-    }
-
-    template <class Container>
-    void registerInputs(Container& v) {
-        (void)v;
-        throw NoTapeException("Template file: Tape backend not implemented. Users must provide their own Tape implementation.");
-    }
-
-    void registerOutput(active_type& outp) {
-        (void)outp;  // Suppress unused parameter
-        throw NoTapeException("Template file: Tape backend not implemented. Users must provide their own Tape implementation.");
-    }
-
-    void registerOutput(std::complex<active_type>& outp) {
-        (void)outp;  // Suppress unused parameter
-        throw NoTapeException("Template file: Tape backend not implemented. Users must provide their own Tape implementation.");
-    }
-
-    template <class It>
-    void registerOutputs(It first, It last) {
-        (void)first;
-        (void)last;
-        throw NoTapeException("Template file: Tape backend not implemented. Users must provide their own Tape implementation.");
-    }
-
-    template <class Container>
-    void registerOutputs(Container& v) {
-        (void)v;
-        throw NoTapeException("Template file: Tape backend not implemented. Users must provide their own Tape implementation.");
-    }
-
-    void newRecording() {
-        throw NoTapeException("Template file: Tape backend not implemented. Users must provide their own Tape implementation.");
-    }
-
-    void computeAdjoints() {
-        throw NoTapeException("Template file: Tape backend not implemented. Users must provide their own Tape implementation.");
-    }
-
-    void clearAll() {
-        throw NoTapeException("Template file: Tape backend not implemented. Users must provide their own Tape implementation.");
-    }
-
-    void clearDerivatives() {
-        throw NoTapeException("Template file: Tape backend not implemented. Users must provide their own Tape implementation.");
-    }
-
-    const derivative_type& derivative(slot_type s) const {
-        (void)s;  // Suppress unused parameter
-        throw NoTapeException("Template file: Tape backend not implemented. Users must provide their own Tape implementation.");
-    }
-
-    derivative_type& derivative(slot_type s) {
-        (void)s;  // Suppress unused parameter
-        throw NoTapeException("Template file: Tape backend not implemented. Users must provide their own Tape implementation.");
-    }
-
-    derivative_type getDerivative(slot_type s) const {
-        return derivative(s);
-    }
-
-    void setDerivative(slot_type s, const derivative_type& d) {
-        (void)s;
-        (void)d;
-        throw NoTapeException("Template file: Tape backend not implemented. Users must provide their own Tape implementation.");
-    }
-
-    void setDerivative(slot_type s, derivative_type&& d) {
-        (void)s;
-        (void)d;
-        throw NoTapeException("Template file: Tape backend not implemented. Users must provide their own Tape implementation.");
-    }
-};
+using TapeStub = Tape<Scalar, N>;
 
 // Helper types and constants needed by Literals.hpp
 namespace detail {
     typedef unsigned int slot_type;
     static constexpr slot_type INVALID_SLOT_VALUE = slot_type(-1);  // Match Tape.hpp style
+
+    // Forge integration: true if expressions must build their forge::fdouble
+    // result. Outside of a recording the Forge side of an AReal is only a
+    // passive copy of the scalar value, so with FEXPR_FORGE_PASSIVE_FAST_PATH
+    // expression evaluation skips the fdouble operator tree altogether.
+    FEXPR_FORCE_INLINE bool forgeTracking()
+    {
+#ifdef FEXPR_FORGE_PASSIVE_FAST_PATH
+        return FEXPR_UNLIKELY(::forge::GraphRecorder::isAnyRecording());
+#else
+        return true;
+#endif
+    }
 }
 // Forward declarations for FReal (not used by QuantLib-Risks-Cpp, but needed for template compilation)
 template <class, std::size_t>
@@ -328,7 +221,7 @@ template <class Scalar, std::size_t N = 1>
 struct AReal
     : public ADTypeBase<Scalar, AReal<Scalar, N>, typename DerivativesTraits<Scalar, N>::type>
 {
-    typedef TapeStub<Scalar, N> tape_type;
+    typedef Tape<Scalar, N> tape_type;
     typedef ADTypeBase<Scalar, AReal<Scalar, N>, typename DerivativesTraits<Scalar, N>::type>
         base_type;
     typedef detail::slot_type slot_type;
@@ -359,20 +252,29 @@ struct AReal
     }
 
     FEXPR_INLINE AReal(const AReal& o) : base_type(), slot_(detail::INVALID_SLOT_VALUE),
-        forge_value_(o.forge_value_)
+        forge_value_(detail::forgeTracking() ? o.forge_value_ : ::forge::fdouble(o.getValue()))
     {
-        // Template: No tape recording - users implement their own tape backend
-        // Original logic: auto s = tape_type::getActive(); if (s && o.shouldRecord()) { ... }
-        // For template: Just copy value, no recording
+        // outside recordings the Forge side is rebuilt from the scalar, as in
+        // expressions, rather than copied from the source.  A copy of a
+        // recorded value is a statement of its own, so that assigning to
+        // either later does not alias the other's slot
+        tape_type* s = tape_type::getActive();
+        if (FEXPR_UNLIKELY(s != nullptr) && o.shouldRecord())
+        {
+            slot_ = s->registerVariable();
+            s->pushRhs(Scalar(1), o.slot_);
+            s->pushLhs(slot_);
+        }
         this->a_ = o.getValue();
     }
 
     static constexpr slot_type INVALID_SLOT = detail::INVALID_SLOT_VALUE;
     FEXPR_INLINE slot_type getSlot() const { return slot_; }
-    FEXPR_INLINE tape_type* getTape() const { return nullptr; }  // Template: no tape implementation
+    FEXPR_INLINE tape_type* getTape() const { return tape_type::getActive(); }
 
     FEXPR_INLINE AReal(AReal&& o) noexcept : base_type(static_cast<base_type&&>(o)), slot_(o.slot_),
-        forge_value_(std::move(o.forge_value_))
+        forge_value_(detail::forgeTracking() ? std::move(o.forge_value_)
+                                             : ::forge::fdouble(o.getValue()))
     {
         o.slot_ = detail::INVALID_SLOT_VALUE;
     }
@@ -385,41 +287,34 @@ struct AReal
         // Move Forge side as well so that the target keeps the same Forge
         // value / node as the source. Without this, move-assignment would
         // leave forge_value_ stale (e.g. still 0) even though a_ was updated.
-        forge_value_ = std::move(o.forge_value_);
+        if (detail::forgeTracking())
+            forge_value_ = std::move(o.forge_value_);
+        else
+            forge_value_ = ::forge::fdouble(this->a_);
 
-        // Object moved-from still gets destructor called, so this makes sure
-        // that the old slot we had gets destructed (template stub semantics).
+        // The target takes over the source's slot; the moved-from object
+        // keeps ours, which is never read again.
         std::swap(slot_, o.slot_);
         return *this;
     }
 
-    FEXPR_INLINE ~AReal()
-    {
-        // Template: No tape cleanup - users implement their own tape backend
-        // Original logic: if (auto tape = tape_type::getActive()) { ... }
-        // No action needed in template version
-    }
+    // slots are not reused within a recording, so there is nothing to release
+    FEXPR_INLINE ~AReal() {}
 
     FEXPR_INLINE AReal& operator=(const AReal& o);
 
     FEXPR_INLINE AReal& operator=(nested_type x)
     {
         this->a_ = x;
-        // Template: No tape recording - users implement their own tape backend.
+        // a constant does not depend on anything recorded on the tape
+        slot_ = detail::INVALID_SLOT_VALUE;
         // Forge integration: keep Forge passive side in sync and warn if we're
         // overwriting an active Forge value during recording (dropping out of
         // the Forge graph).
-        if (forge_value_.isRecording() && forge_value_.isActive()) {
-            static std::size_t warnCount = 0;
-            if (warnCount < 10) {
-                ++warnCount;
-                std::cerr
-                    << "[Forge][Warning] AReal::operator=(Scalar) called while Forge "
-                    << "recording is active on an active value – this replaces the "
-                    << "active Forge node with a passive constant (occurrence "
-                    << warnCount << ")\n";
-            }
-        }
+        FEXPR_FORGE_GRAPH_DROP(forge_value_.isActive() && forge_value_.isRecording(),
+                               "AReal::operator=(Scalar) called while Forge recording is active on "
+                               "an active value – this replaces the active Forge node with a "
+                               "passive constant");
         // Reset Forge-side representation to a passive constant matching the
         // scalar value. This keeps forward values consistent even if the graph
         // dependency has been lost.
@@ -437,17 +332,10 @@ struct AReal
         // If this value was active during recording, using += drops the
         // dependency on inputs from the Forge graph. Warn so users can
         // refactor (e.g. use an expression-based update instead).
-        if (forge_value_.isRecording() && forge_value_.isActive()) {
-            static std::size_t warnCount = 0;
-            if (warnCount < 10) {
-                ++warnCount;
-                std::cerr
-                    << "[Forge][Warning] AReal::operator+=(Scalar) called while Forge "
-                    << "recording is active on an active value – this performs an "
-                    << "in-place scalar update and drops you out of the Forge graph "
-                    << "(occurrence " << warnCount << ")\n";
-            }
-        }
+        FEXPR_FORGE_GRAPH_DROP(forge_value_.isActive() && forge_value_.isRecording(),
+                               "AReal::operator+=(Scalar) called while Forge recording is active "
+                               "on an active value – this performs an in-place scalar update and "
+                               "drops you out of the Forge graph");
 
         // Ensure Forge's passive value matches the new scalar, even if the
         // active node (if any) is no longer meaningful.
@@ -459,17 +347,10 @@ struct AReal
     FEXPR_INLINE AReal& operator-=(Scalar rhs)
     {
         base_type::operator-=(rhs);
-        if (forge_value_.isRecording() && forge_value_.isActive()) {
-            static std::size_t warnCount = 0;
-            if (warnCount < 10) {
-                ++warnCount;
-                std::cerr
-                    << "[Forge][Warning] AReal::operator-=(Scalar) called while Forge "
-                    << "recording is active on an active value – this performs an "
-                    << "in-place scalar update and drops you out of the Forge graph "
-                    << "(occurrence " << warnCount << ")\n";
-            }
-        }
+        FEXPR_FORGE_GRAPH_DROP(forge_value_.isActive() && forge_value_.isRecording(),
+                               "AReal::operator-=(Scalar) called while Forge recording is active "
+                               "on an active value – this performs an in-place scalar update and "
+                               "drops you out of the Forge graph");
 
         forge_value_ = ::forge::fdouble(static_cast<double>(this->a_));
         return *this;
@@ -482,31 +363,17 @@ struct AReal
     // not throw) to help locate missing Forge wiring without breaking code.
     FEXPR_INLINE const Scalar& value() const
     {
-        if (forge_value_.isRecording() && forge_value_.isActive()) {
-            static std::size_t warnCount = 0;
-            if (warnCount < 10) {
-                ++warnCount;
-                std::cerr
-                    << "[Forge][Warning] AReal::value() called while Forge recording "
-                    << "is active on an active value – this drops you out of the "
-                    << "Forge graph (occurrence " << warnCount << ")\n";
-            }
-        }
+        FEXPR_FORGE_GRAPH_DROP(forge_value_.isActive() && forge_value_.isRecording(),
+                               "AReal::value() called while Forge recording is active on an active "
+                               "value – this drops you out of the Forge graph");
         return this->a_;
     }
 
     FEXPR_INLINE Scalar& value()
     {
-        if (forge_value_.isRecording() && forge_value_.isActive()) {
-            static std::size_t warnCount = 0;
-            if (warnCount < 10) {
-                ++warnCount;
-                std::cerr
-                    << "[Forge][Warning] AReal::value() called while Forge recording "
-                    << "is active on an active value – this drops you out of the "
-                    << "Forge graph (occurrence " << warnCount << ")\n";
-            }
-        }
+        FEXPR_FORGE_GRAPH_DROP(forge_value_.isActive() && forge_value_.isRecording(),
+                               "AReal::value() called while Forge recording is active on an active "
+                               "value – this drops you out of the Forge graph");
         return this->a_;
     }
 
@@ -561,51 +428,57 @@ struct AReal
     FEXPR_FORCE_INLINE void pushRhs(DerivInfo<tape_type, Size>& info, const Scalar& mul,
                                   slot_type slot) const
     {
-        // Template: No-op - users implement their own tape backend
-        (void)info;
-        (void)mul;
-        (void)slot;
+        info.multipliers[info.index] = mul;
+        info.slots[info.index] = slot;
+        ++info.index;
     }
 
     template <int Size>
     FEXPR_FORCE_INLINE void calc_derivatives(DerivInfo<tape_type, Size>& info, tape_type&,
                                            const Scalar& mul) const
     {
-        // Template: No-op - users implement their own tape backend
-        // Original logic: if (slot_ != INVALID_SLOT) pushRhs(info, mul, slot_);
-        (void)info;  // Suppress unused parameter warning
-        (void)mul;
+        if (slot_ != INVALID_SLOT)
+            pushRhs(info, mul, slot_);
     }
 
     template <int Size>
     FEXPR_FORCE_INLINE void calc_derivatives(DerivInfo<tape_type, Size>& info, tape_type&) const
     {
-        // Template: No-op - users implement their own tape backend
-        (void)info;  // Suppress unused parameter warning
+        if (slot_ != INVALID_SLOT)
+            pushRhs(info, Scalar(1), slot_);
     }
 
     FEXPR_INLINE derivative_type getDerivative() const { return derivative(); }
 
+    /// the derivative on the active tape, zero if this value was never recorded
     FEXPR_INLINE const derivative_type& derivative() const
     {
-        // Template: Throw runtime error - users must implement their own tape backend
-        throw NoTapeException("Template file: Tape backend not implemented. Users must provide their own Tape implementation.");
+        const tape_type* s = tape_type::getActive();
+        if (s == nullptr)
+            throw NoTapeException();
+        return s->derivative(slot_);
     }
 
+    /// the derivative on the active tape, registering this value if it has no slot yet
     FEXPR_INLINE derivative_type& derivative()
     {
-        // Template: Throw runtime error - users must implement their own tape backend
-        throw NoTapeException("Template file: Tape backend not implemented. Users must provide their own Tape implementation.");
+        tape_type* s = tape_type::getActive();
+        if (s == nullptr)
+            throw NoTapeException();
+        if (slot_ == INVALID_SLOT)
+            slot_ = s->registerVariable();
+        return s->derivative(slot_);
     }
     FEXPR_INLINE bool shouldRecord() const { return slot_ != detail::INVALID_SLOT_VALUE; }
 
   private:
+    // pushes the recorded operands of expr with their partial derivatives
     template <int Size, typename Expr>
     FEXPR_FORCE_INLINE void pushAll(tape_type* t, const Expr& expr) const
     {
-        // Template: No-op - users implement their own tape backend
-        (void)t;
-        (void)expr;
+        DerivInfo<tape_type, Size> info;
+        expr.calc_derivatives(info, *t);
+        t->pushAll(info);
     }
 
     template <class T, std::size_t d__cnt>
@@ -628,10 +501,15 @@ struct ADVar
 
     FEXPR_INLINE Scalar getValue() const { return ar_.getValue(); }
 
-    FEXPR_INLINE const Scalar& value() const { return ar_.value(); }
+    // expression templates read operand values here while the Forge side is
+    // recorded separately, so this is not a graph drop
+    FEXPR_INLINE const Scalar& value() const
+    {
+        return static_cast<const typename areal_type::base_type&>(ar_).value();
+    }
 
     // ========== Forge Integration: expose Forge value for expressions ==========
-    FEXPR_INLINE ::forge::fdouble forgeValue() const {
+    FEXPR_INLINE const ::forge::fdouble& forgeValue() const {
         return ar_.forgeValue();
     }
     // ===========================================================================
@@ -646,9 +524,7 @@ struct ADVar
     template <int Size>
     FEXPR_INLINE void calc_derivatives(DerivInfo<tape_type, Size>& info, tape_type& s) const
     {
-        // Template: No-op (fixed typo from original: was calc_derivative, now calc_derivatives)
-        (void)info;
-        (void)s;
+        ar_.calc_derivatives(info, s);
     }
 
     FEXPR_INLINE const typename areal_type::derivative_type& derivative() const
@@ -666,10 +542,24 @@ struct ADVar
 template <class Scalar, std::size_t M>
 FEXPR_INLINE AReal<Scalar, M>& AReal<Scalar, M>::operator=(const AReal& o)
 {
-    // Template: No tape recording - users implement their own tape backend
-    // Original logic: tape_type* s = tape_type::getActive(); if (s && ...) { ... }
+    tape_type* s = tape_type::getActive();
+    if (FEXPR_UNLIKELY(s != nullptr) && this != &o)
+    {
+        if (o.shouldRecord())
+        {
+            if (slot_ == INVALID_SLOT)
+                slot_ = s->registerVariable();
+            s->pushRhs(Scalar(1), o.slot_);
+            s->pushLhs(slot_);
+        }
+        else
+            slot_ = INVALID_SLOT;
+    }
     this->a_ = o.getValue();
-    forge_value_ = o.forge_value_;  // ← Forge: Also copy forge value
+    if (detail::forgeTracking())
+        forge_value_ = o.forge_value_;  // ← Forge: Also copy forge value
+    else
+        forge_value_ = ::forge::fdouble(this->a_);  // ← Forge: passive, no recording active
     return *this;
 }
 
@@ -678,10 +568,17 @@ template <class Expr>
 FEXPR_INLINE AReal<Scalar, M>::AReal(
     const Expression<Scalar, Expr, typename DerivativesTraits<Scalar, M>::type>& expr)
     : base_type(expr.getValue()), slot_(detail::INVALID_SLOT_VALUE),
-      forge_value_(expr.derived().forgeValue())  // ← Forge: Get forge result from expression
+      forge_value_(detail::forgeTracking()
+                       ? expr.derived().forgeValue()  // ← Forge: Get forge result from expression
+                       : ::forge::fdouble(this->a_))  // ← Forge: passive, no recording active
 {
-    // Template: No tape recording - users implement their own tape backend
-    // Original logic: tape_type* s = tape_type::getActive(); if (s && expr.shouldRecord()) { ... }
+    tape_type* s = tape_type::getActive();
+    if (FEXPR_UNLIKELY(s != nullptr) && expr.shouldRecord())
+    {
+        pushAll<ExprTraits<Expr>::numVariables>(s, expr);
+        slot_ = s->registerVariable();
+        s->pushLhs(slot_);
+    }
 }
 
 template <class Scalar, std::size_t M>
@@ -689,10 +586,25 @@ template <class Expr>
 FEXPR_INLINE AReal<Scalar, M>& AReal<Scalar, M>::operator=(
     const Expression<Scalar, Expr, typename DerivativesTraits<Scalar, M>::type>& expr)
 {
-    // Template: No tape recording - users implement their own tape backend
-    // Original logic: tape_type* s = tape_type::getActive(); if (s && ...) { ... }
+    // record before assigning: the partials read the operands, which may include *this
+    tape_type* s = tape_type::getActive();
+    if (FEXPR_UNLIKELY(s != nullptr))
+    {
+        if (expr.shouldRecord())
+        {
+            pushAll<ExprTraits<Expr>::numVariables>(s, expr);
+            if (slot_ == INVALID_SLOT)
+                slot_ = s->registerVariable();
+            s->pushLhs(slot_);
+        }
+        else
+            slot_ = INVALID_SLOT;
+    }
     this->a_ = expr.getValue();
-    forge_value_ = expr.derived().forgeValue();  // ← Forge: Update forge value from expression
+    if (detail::forgeTracking())
+        forge_value_ = expr.derived().forgeValue();  // ← Forge: Update forge value from expression
+    else
+        forge_value_ = ::forge::fdouble(this->a_);  // ← Forge: passive, no recording active
     return *this;
 }
 
@@ -795,6 +707,64 @@ derivative(const T&)
     return T();
 }
 
+// ========== Forge Integration: polynomial evaluation ==========
+// horner(x, {c0, c1, ..., cn}) evaluates c0 + x * (c1 + x * (... + x * cn)).
+// The scalar value and its derivative are computed in one pass without
+// expression temporaries, the derivative for the tape; during recording the
+// Forge side is one multiply-add per coefficient, fused into single nodes
+// where Forge supports it.
+template <class Scalar, std::size_t N>
+FEXPR_INLINE AReal<Scalar, N> horner(const AReal<Scalar, N>& x, const Scalar* coefficients,
+                                     std::size_t n)
+{
+    if (n == 0)
+        return AReal<Scalar, N>(Scalar(0));
+    const Scalar xv = x.getValue();
+    Scalar v = coefficients[n - 1], dv = Scalar(0);
+    for (std::size_t k = n - 1; k-- > 0;)
+    {
+        dv = dv * xv + v;
+        v = v * xv + coefficients[k];
+    }
+    AReal<Scalar, N> result(v);
+    if (Tape<Scalar, N>* tape = Tape<Scalar, N>::getActive())
+        tape->pushPartials(result, {{dv, x.getSlot()}});
+    if (detail::forgeTracking() && n > 1)
+    {
+        const ::forge::fdouble& fx = x.forgeValue();
+        ::forge::fdouble f(static_cast<double>(coefficients[n - 1]));
+        for (std::size_t k = n - 1; k-- > 0;)
+            f = detail::forgeMultiplyAdd(f, fx, ::forge::fdouble(static_cast<double>(coefficients[k])));
+        result.setForgeValue(f);
+    }
+    return result;
+}
+
+template <class Scalar, std::size_t N>
+FEXPR_INLINE AReal<Scalar, N> horner(const AReal<Scalar, N>& x,
+                                     std::initializer_list<Scalar> coefficients)
+{
+    return horner(x, coefficients.begin(), coefficients.size());
+}
+
+template <class T, class = typename std::enable_if<std::is_floating_point<T>::value>::type>
+FEXPR_INLINE T horner(T x, const T* coefficients, std::size_t n)
+{
+    if (n == 0)
+        return T(0);
+    T v = coefficients[n - 1];
+    for (std::size_t k = n - 1; k-- > 0;)
+        v = v * x + coefficients[k];
+    return v;
+}
+
+template <class T, class = typename std::enable_if<std::is_floating_point<T>::value>::type>
+FEXPR_INLINE T horner(T x, std::initializer_list<T> coefficients)
+{
+    return horner(x, coefficients.begin(), coefficients.size());
+}
+// ==============================================================
+
 template <class C, class T, class Scalar, class Derived, class Deriv>
 FEXPR_INLINE std::basic_ostream<C, T>& operator<<(std::basic_ostream<C, T>& os,
                                                 const Expression<Scalar, Derived, Deriv>& x)
@@ -0,0 +1,77 @@
+/*******************************************************************************
+
+   Scoped source tags for nodes recorded into a Forge graph.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#pragma once
+
+#include <expressions/Macros.hpp>
+
+// FORGE_SCOPE("CumulativeNormalDistribution") tags the nodes recorded until
+// the end of the enclosing block with the given name; tags nest, so a node
+// belongs to the innermost open scope and its attribution path is the chain
+// of scopes around it.  The patched QuantLib functions open scopes of their own.
+//
+// The macro only forwards to a RecordingScopeSink installed on the calling
+// thread, normally a QuantLib::ForgeRecordingProfiler, which turns the tags
+// into per-scope node counts.  Without one a scope costs a thread-local load
+// and a branch; FEXPR_FORGE_NO_SCOPES compiles the macro out.
+
+#define FEXPR_SCOPE_CONCAT_IMPL(a, b) a##b
+#define FEXPR_SCOPE_CONCAT(a, b) FEXPR_SCOPE_CONCAT_IMPL(a, b)
+
+namespace forge { namespace expr {
+
+/// receives the scope changes of one thread
+class RecordingScopeSink
+{
+  public:
+    virtual ~RecordingScopeSink() = default;
+    virtual void enter(const char* tag) = 0;
+    virtual void leave() = 0;
+};
+
+/// the sink of the calling thread, or null
+inline RecordingScopeSink*& activeRecordingScopeSink()
+{
+    static thread_local RecordingScopeSink* sink = nullptr;
+    return sink;
+}
+
+/// RAII scope behind FORGE_SCOPE
+class RecordingScope
+{
+  public:
+    explicit RecordingScope(const char* tag) : sink_(activeRecordingScopeSink())
+    {
+        if (FEXPR_UNLIKELY(sink_ != nullptr))
+            sink_->enter(tag);
+    }
+    ~RecordingScope()
+    {
+        if (FEXPR_UNLIKELY(sink_ != nullptr))
+            sink_->leave();
+    }
+
+    RecordingScope(const RecordingScope&) = delete;
+    RecordingScope& operator=(const RecordingScope&) = delete;
+
+  private:
+    RecordingScopeSink* sink_;
+};
+
+}}  // namespace forge::expr
+
+#ifndef FEXPR_FORGE_NO_SCOPES
+#define FORGE_SCOPE(tag) \
+    ::forge::expr::RecordingScope FEXPR_SCOPE_CONCAT(forgeRecordingScope_, __LINE__)(tag)
+#else
+#define FORGE_SCOPE(tag) ((void)0)
+#endif
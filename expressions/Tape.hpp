@@ -0,0 +1,352 @@
+/*******************************************************************************
+
+   Operator-overloading tape for reverse-mode AD without compilation.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   Derived from XAD (https://github.com/auto-differentiation/XAD)
+   Original code: Copyright (C) 2010-2024 Xcelerit Computing Ltd.
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#pragma once
+
+#include <expressions/Exceptions.hpp>
+#include <expressions/Expression.hpp>
+#include <expressions/Macros.hpp>
+#include <expressions/Traits.hpp>
+
+#include <complex>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace forge { namespace expr {
+
+template <class, std::size_t>
+struct AReal;
+
+namespace detail
+{
+/// append-only storage in fixed-size chunks
+///
+/// Growing never moves what was recorded, and clear() keeps the chunks, so
+/// a tape that is reused for the next recording stops allocating once it
+/// has seen the largest one.
+template <class T, unsigned ChunkBits = 14>
+class TapeArena
+{
+  public:
+    static constexpr std::size_t chunk_size = std::size_t(1) << ChunkBits;
+
+    FEXPR_FORCE_INLINE void push_back(const T& v)
+    {
+        const std::size_t chunk = size_ >> ChunkBits;
+        if (FEXPR_UNLIKELY(chunk == chunks_.size()))
+            chunks_.emplace_back(new T[chunk_size]);
+        chunks_[chunk][size_ & (chunk_size - 1)] = v;
+        ++size_;
+    }
+
+    FEXPR_FORCE_INLINE const T& operator[](std::size_t i) const
+    {
+        return chunks_[i >> ChunkBits][i & (chunk_size - 1)];
+    }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    /// drops everything from position n on, keeping the memory
+    void resize_down(std::size_t n)
+    {
+        if (n < size_)
+            size_ = n;
+    }
+    void clear() { size_ = 0; }
+    /// bytes held, including chunks kept for reuse
+    std::size_t memory() const { return chunks_.size() * chunk_size * sizeof(T); }
+
+  private:
+    std::vector<std::unique_ptr<T[]>> chunks_;
+    std::size_t size_ = 0;
+};
+}  // namespace detail
+
+/// records AReal statements on the current thread and sweeps them in reverse
+///
+/// Every assignment of a recorded expression becomes one statement: the slot
+/// assigned to and the (multiplier, slot) pair of each recorded operand, as
+/// collected by calc_derivatives().  computeAdjoints() runs the statements
+/// backwards from the seeded output derivatives.  Inputs are registered
+/// before the recording starts; with no active tape AReal records nothing.
+template <class Real, std::size_t N = 1>
+class Tape
+{
+  public:
+    typedef unsigned int slot_type;
+    typedef std::size_t position_type;
+    typedef Real value_type;
+    typedef AReal<Real, N> active_type;
+    typedef typename DerivativesTraits<Real, N>::type derivative_type;
+    static constexpr slot_type INVALID_SLOT = slot_type(-1);
+
+    /// constructs the tape and (by default) makes it the active one of this thread
+    explicit Tape(bool activateNow = true)
+    {
+        if (activateNow)
+            activate();
+    }
+
+    ~Tape() { deactivate(); }
+
+    Tape(const Tape&) = delete;
+    Tape& operator=(const Tape&) = delete;
+
+#ifdef FEXPR_NO_TAPE
+    // with the tape compiled out no tape is ever active, so the recording
+    // branches of AReal fold away and passive code pays no thread-local read
+    static constexpr Tape* getActive() { return nullptr; }
+
+    void activate() { throw Exception("the tape is compiled out (FEXPR_NO_TAPE)"); }
+#else
+    static Tape* getActive() { return active_tape_; }
+
+    void activate()
+    {
+        if (active_tape_ != nullptr && active_tape_ != this)
+            throw TapeAlreadyActive();
+        active_tape_ = this;
+    }
+#endif
+
+    void deactivate()
+    {
+        if (active_tape_ == this)
+            active_tape_ = nullptr;
+    }
+
+    bool isActive() const { return active_tape_ == this; }
+
+    static void setActive(Tape* t)
+    {
+#ifdef FEXPR_NO_TAPE
+        if (t != nullptr)
+            throw Exception("the tape is compiled out (FEXPR_NO_TAPE)");
+#endif
+        if (t != nullptr && active_tape_ != nullptr && active_tape_ != t)
+            throw TapeAlreadyActive();
+        active_tape_ = t;
+    }
+
+    static void deactivateAll() { active_tape_ = nullptr; }
+
+    void registerInput(active_type& inp)
+    {
+        if (inp.slot_ == INVALID_SLOT)
+            inp.slot_ = registerVariable();
+    }
+
+    void registerInput(std::complex<active_type>& inp)
+    {
+        registerInput(inp.real());
+        registerInput(inp.imag());
+    }
+
+    template <class It>
+    void registerInputs(It first, It last)
+    {
+        for (; first != last; ++first)
+            registerInput(*first);
+    }
+
+    template <class Container>
+    void registerInputs(Container& v)
+    {
+        registerInputs(v.begin(), v.end());
+    }
+
+    /// gives a slot to an output that does not depend on any input
+    void registerOutput(active_type& outp)
+    {
+        if (outp.slot_ == INVALID_SLOT)
+            outp.slot_ = registerVariable();
+    }
+
+    void registerOutput(std::complex<active_type>& outp)
+    {
+        registerOutput(outp.real());
+        registerOutput(outp.imag());
+    }
+
+    template <class It>
+    void registerOutputs(It first, It last)
+    {
+        for (; first != last; ++first)
+            registerOutput(*first);
+    }
+
+    template <class Container>
+    void registerOutputs(Container& v)
+    {
+        registerOutputs(v.begin(), v.end());
+    }
+
+    /// drops the statements recorded so far; registered inputs keep their slots
+    void newRecording()
+    {
+        statements_.clear();
+        operations_.clear();
+        clearDerivatives();
+    }
+
+    /// drops statements and slots; variables recorded before must not be used again
+    void clearAll()
+    {
+        newRecording();
+        numSlots_ = 0;
+    }
+
+    void clearDerivatives() { derivatives_.assign(derivatives_.size(), derivative_type()); }
+
+    /// the position after the statements recorded so far
+    position_type getPosition() const { return statements_.size(); }
+
+    /// drops the statements recorded after pos
+    void resetTo(position_type pos)
+    {
+        if (pos >= statements_.size())
+            return;
+        statements_.resize_down(pos);
+        operations_.resize_down(pos == 0 ? 0 : statements_[pos - 1].end);
+    }
+
+    /// propagates the seeded derivatives back to the inputs
+    void computeAdjoints()
+    {
+        if (derivatives_.empty())
+            throw DerivativesNotInitialized();
+        derivatives_.resize(numSlots_, derivative_type());
+        for (std::size_t i = statements_.size(); i-- > 0;)
+        {
+            const Statement& st = statements_[i];
+            const derivative_type a = derivatives_[st.lhs];
+            derivatives_[st.lhs] = derivative_type();
+            if (a == derivative_type())
+                continue;
+            const std::size_t begin = i == 0 ? 0 : statements_[i - 1].end;
+            for (std::size_t j = begin; j < st.end; ++j)
+            {
+                const Operation& op = operations_[j];
+                derivatives_[op.slot] += op.multiplier * a;
+            }
+        }
+    }
+
+    derivative_type& derivative(slot_type s)
+    {
+        if (s == INVALID_SLOT || s >= numSlots_)
+            throw OutOfRange("Given derivative slot is out of range - did you register the outputs?");
+        if (s >= derivatives_.size())
+            derivatives_.resize(numSlots_, derivative_type());
+        return derivatives_[s];
+    }
+
+    /// zero for slots whose derivative was never set
+    const derivative_type& derivative(slot_type s) const
+    {
+        if (s == INVALID_SLOT || s >= derivatives_.size())
+            return zero_;
+        return derivatives_[s];
+    }
+
+    derivative_type getDerivative(slot_type s) const { return derivative(s); }
+
+    void setDerivative(slot_type s, const derivative_type& d) { derivative(s) = d; }
+
+    void setDerivative(slot_type s, derivative_type&& d) { derivative(s) = std::move(d); }
+
+    // recording interface used by AReal
+
+    slot_type registerVariable() { return numSlots_++; }
+
+    FEXPR_FORCE_INLINE void pushRhs(const Real& multiplier, slot_type slot)
+    {
+        operations_.push_back(Operation{multiplier, slot});
+    }
+
+    template <int Size>
+    FEXPR_FORCE_INLINE void pushAll(const DerivInfo<Tape, Size>& info)
+    {
+        for (unsigned i = 0; i < info.index; ++i)
+            pushRhs(info.multipliers[i], info.slots[i]);
+    }
+
+    /// closes the statement assigning to slot with the operations pushed since the last one
+    FEXPR_FORCE_INLINE void pushLhs(slot_type slot)
+    {
+        statements_.push_back(Statement{operations_.size(), slot});
+    }
+
+    /// records result as a linear function of recorded operands, given as (partial, slot)
+    ///
+    /// For values computed on passive scalars outside the expression
+    /// templates, whose partial derivatives are known in closed form.
+    /// Operands without a slot are skipped; if none is left, result is a
+    /// constant to the tape.
+    void pushPartials(active_type& result, std::initializer_list<std::pair<Real, slot_type>> partials)
+    {
+        result.slot_ = INVALID_SLOT;
+        bool recorded = false;
+        for (const auto& p : partials)
+        {
+            if (p.second == INVALID_SLOT)
+                continue;
+            pushRhs(p.first, p.second);
+            recorded = true;
+        }
+        if (!recorded)
+            return;
+        result.slot_ = registerVariable();
+        pushLhs(result.slot_);
+    }
+
+    std::size_t getNumVariables() const { return numSlots_; }
+    std::size_t getNumStatements() const { return statements_.size(); }
+    std::size_t getNumOperations() const { return operations_.size(); }
+    /// bytes held by statements, operations and derivatives
+    std::size_t getMemory() const
+    {
+        return statements_.memory() + operations_.memory() +
+               derivatives_.capacity() * sizeof(derivative_type);
+    }
+
+  private:
+    struct Statement
+    {
+        std::size_t end;  // one past the last operation of this statement
+        slot_type lhs;
+    };
+    struct Operation
+    {
+        Real multiplier;
+        slot_type slot;
+    };
+
+    detail::TapeArena<Statement> statements_;
+    detail::TapeArena<Operation> operations_;
+    std::vector<derivative_type> derivatives_;
+    slot_type numSlots_ = 0;
+    derivative_type zero_ = derivative_type();
+
+    static FEXPR_THREAD_LOCAL Tape* active_tape_;
+};
+
+template <class Real, std::size_t N>
+FEXPR_THREAD_LOCAL Tape<Real, N>* Tape<Real, N>::active_tape_ = nullptr;
+
+}}  // namespace forge::expr
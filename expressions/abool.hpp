@@ -12,9 +12,10 @@
 
 #pragma once
 
+#include <expressions/BranchGuards.hpp>
+#include <expressions/Diagnostics.hpp>
 #include <types/fbool.hpp>
 #include <types/fdouble.hpp>
-#include <iostream>
 
 namespace forge {
 
@@ -27,16 +28,19 @@ namespace forge {
  *
  * This type is intentionally generic w.r.t. the value type T. T is expected
  * to provide:
- *   - forge::fdouble forgeValue() const;
+ *   - forge::fdouble forgeValue() const; (or const forge::fdouble&)
  *   - void setForgeValue(const forge::fdouble&);
  *
  * In practice, this matches forge::expr::AReal<double,N> in our integration layer.
  */
 class ABool {
 public:
-    bool  passive_;   // C++ truth value
-    fbool active_;    // Graph-side boolean
-    bool  hasActive_; // Whether active_ has a valid graph node
+    // Records the comparison of two Forge values
+    typedef fbool (*Compare)(const fdouble&, const fdouble&);
+
+    bool  passive_;           // C++ truth value
+    mutable fbool active_;    // Graph-side boolean
+    mutable bool  hasActive_; // Whether active_ has a valid graph node
 
     // Constructor: from plain bool (no graph tracking)
     explicit ABool(bool b = false)
@@ -46,10 +50,25 @@ public:
     ABool(const fbool& fb, bool passive)
         : passive_(passive), active_(fb), hasActive_(true) {}
 
+    // Constructor: a comparison of lhs and rhs, recorded only once the
+    // condition is consumed by If(...), active() or a branch guard.  This is
+    // what AReal comparisons return, so that conditions used natively (e.g.
+    // in QL_REQUIRE) add no nodes to the graph.
+    ABool(Compare compare, const fdouble& lhs, const fdouble& rhs, bool passive)
+        : passive_(passive), active_(fbool(passive)), hasActive_(false),
+          compare_(compare), lhs_(lhs), rhs_(rhs) {}
+
     // Accessors
     bool passive() const { return passive_; }
-    const fbool& active() const { return active_; }
-    bool isActive() const { return hasActive_ && active_.isActive(); }
+    const fbool& active() const {
+        if (GraphRecorder::isAnyRecording())
+            record();
+        return active_;
+    }
+    bool isActive() const {
+        return (hasActive_ && active_.isActive()) ||
+               (compare_ != nullptr && (lhs_.isActive() || rhs_.isActive()));
+    }
 
     // Allow seamless use in existing bool contexts (if, while, etc.).
     // NOTE: this only exposes the passive value; recording of dynamic
@@ -57,19 +76,22 @@ public:
     //
     // When Forge recording is active and this ABool is active, using it
     // as a plain bool means we're about to drop out of the Forge graph
-    // (e.g. by doing a normal C++ if/else instead of ABool::If). We
-    // emit a warning (but do not throw) to help locate missing Forge wiring.
+    // (e.g. by doing a normal C++ if/else instead of ABool::If). For a
+    // recorded condition this is reported as a graph drop (see
+    // Diagnostics.hpp) to help locate missing Forge wiring; a pending
+    // comparison is not, since most of them (argument checks, loop bounds)
+    // are meant to be native.  Either is recorded as a guard if BranchGuards
+    // are installed (see BranchGuards.hpp) so that the kernel can detect
+    // other branches.
     operator bool() const {
-        if (GraphRecorder::isAnyRecording() && isActive()) {
-            static std::size_t warnCount = 0;
-            if (warnCount < 10) {
-                ++warnCount;
-                std::cerr
-                    << "[Forge][Warning] ABool::operator bool() called while Forge "
-                    << "recording is active on an active condition – this drops you "
-                    << "out of the Forge graph; use ABool::If(...) instead "
-                    << "(occurrence " << warnCount << ")\n";
-            }
+        FEXPR_FORGE_GRAPH_DROP(hasActive_ && active_.isActive() && GraphRecorder::isAnyRecording(),
+                               "ABool::operator bool() called while Forge recording is active "
+                               "on an active condition – this drops you out of the Forge graph; "
+                               "use ABool::If(...) instead");
+        BranchGuards* guards = BranchGuards::current();
+        if (guards != nullptr && isActive() && GraphRecorder::isAnyRecording()) {
+            record();
+            guards->add(active_, passive_);
         }
         return passive_;
     }
@@ -81,13 +103,14 @@ public:
     T If(const T& trueVal, const T& falseVal) const
     {
         // 1. Fallback to passive behavior when not recording or no active condition
-        if (!hasActive_ || !GraphRecorder::isAnyRecording()) {
+        if ((!hasActive_ && compare_ == nullptr) || !GraphRecorder::isAnyRecording()) {
             return passive_ ? trueVal : falseVal;
         }
+        record();
 
         // 2. Extract Forge numeric side from the value type
-        forge::fdouble forgeTrue  = trueVal.forgeValue();
-        forge::fdouble forgeFalse = falseVal.forgeValue();
+        const forge::fdouble& forgeTrue  = trueVal.forgeValue();
+        const forge::fdouble& forgeFalse = falseVal.forgeValue();
 
         // 3. Graph-level If via fbool
         forge::fdouble forgeResult = active_.If(forgeTrue, forgeFalse);
@@ -105,6 +128,19 @@ public:
     {
         return cond.If(trueVal, falseVal);
     }
+
+private:
+    // Records a pending comparison; only called while recording
+    void record() const {
+        if (compare_ == nullptr)
+            return;
+        active_ = compare_(lhs_, rhs_);
+        hasActive_ = true;
+        compare_ = nullptr;
+    }
+
+    mutable Compare compare_ = nullptr;
+    fdouble lhs_, rhs_;
 };
 
 } // namespace forge
@@ -20,6 +20,7 @@
 
 #include "toplevelfixture.hpp"
 #include "utilities_forge.hpp"
+#include "perf_forge.hpp"
 #include <ql/instruments/vanillaoption.hpp>
 #include <ql/pricingengines/vanilla/baroneadesiwhaleyengine.hpp>
 #include <ql/pricingengines/vanilla/bjerksundstenslandengine.hpp>
@@ -241,6 +242,12 @@ BOOST_AUTO_TEST_CASE(testBaroneAdesiWhaleyValues) {
     QL_CHECK_CLOSE(derivatives_bump.strike, derivatives_forge.strike, 1e-3);
     QL_CHECK_CLOSE(derivatives_bump.t, derivatives_forge.t, 1e-3);
     QL_CHECK_CLOSE(derivatives_bump.v, derivatives_forge.v, 1e-3);
+
+    // kernel-versus-QuantLib timing, under --forge_perf
+    forgePerfMeasure("americanoption/baroneadesiwhaley", data,
+                     {&AmericanOptionData::strike, &AmericanOptionData::s, &AmericanOptionData::q,
+                      &AmericanOptionData::r, &AmericanOptionData::t, &AmericanOptionData::v},
+                     priceBaroneAdesiWhaley);
 }
 
 namespace {
@@ -305,6 +312,12 @@ BOOST_AUTO_TEST_CASE(testBjerksundStenslandDerivatives, *boost::unit_test::disab
     QL_CHECK_CLOSE(derivatives_bump.strike, derivatives_forge.strike, 1e-4);
     QL_CHECK_CLOSE(derivatives_bump.t, derivatives_forge.t, 1e-4);
     QL_CHECK_CLOSE(derivatives_bump.v, derivatives_forge.v, 1e-4);
+
+    // kernel-versus-QuantLib timing, under --forge_perf
+    forgePerfMeasure("americanoption/bjerksundstensland", data,
+                     {&AmericanOptionData::strike, &AmericanOptionData::s, &AmericanOptionData::q,
+                      &AmericanOptionData::r, &AmericanOptionData::t, &AmericanOptionData::v},
+                     priceBjerksundStensland);
 }
 
 namespace {
@@ -364,6 +377,12 @@ BOOST_AUTO_TEST_CASE(testJuDerivatives) {
     QL_CHECK_CLOSE(derivatives_bump.strike, derivatives_forge.strike, 1e-4);
     QL_CHECK_CLOSE(derivatives_bump.t, derivatives_forge.t, 1e-4);
     QL_CHECK_CLOSE(derivatives_bump.v, derivatives_forge.v, 1e-4);
+
+    // kernel-versus-QuantLib timing, under --forge_perf
+    forgePerfMeasure("americanoption/ju", data,
+                     {&AmericanOptionData::strike, &AmericanOptionData::s, &AmericanOptionData::q,
+                      &AmericanOptionData::r, &AmericanOptionData::t, &AmericanOptionData::v},
+                     priceJu);
 }
 
 namespace {
@@ -430,6 +449,12 @@ BOOST_AUTO_TEST_CASE(testFdDerivatives, *boost::unit_test::disabled()) {
     QL_CHECK_CLOSE(derivatives_bump.strike, derivatives_forge.strike, 1e-4);
     QL_CHECK_CLOSE(derivatives_bump.t, derivatives_forge.t, 1e-4);
     QL_CHECK_CLOSE(derivatives_bump.v, derivatives_forge.v, 1e-4);
+
+    // kernel-versus-QuantLib timing, under --forge_perf
+    forgePerfMeasure("americanoption/fd", data,
+                     {&AmericanOptionData::strike, &AmericanOptionData::s, &AmericanOptionData::q,
+                      &AmericanOptionData::r, &AmericanOptionData::t, &AmericanOptionData::v},
+                     priceFd);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
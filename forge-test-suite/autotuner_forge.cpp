@@ -0,0 +1,212 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Compiler configuration autotuning tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/autotuner.hpp>
+#include <ql/forge/batchevaluator.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(AutotunerForgeTests)
+
+namespace {
+
+    struct Recording {
+        forge::Graph graph;
+        std::vector<forge::NodeId> inputs;
+        forge::NodeId output;
+    };
+
+    // y = sum_i w_i exp(-x_i), recorded at the given weight
+    Recording record(double weight, Size terms) {
+        forge::GraphRecorder recorder;
+        recorder.start();
+        Recording rec;
+        std::vector<Real> x(terms);
+        Real y = 0.0;
+        for (Size i = 0; i < terms; ++i) {
+            x[i] = 0.01 * (i + 1);
+            x[i].markForgeInputAndDiff();
+            rec.inputs.push_back(x[i].forgeNodeId());
+            y += weight * (i + 1) * exp(-x[i]);
+        }
+        y.markForgeOutput();
+        rec.output = y.forgeNodeId();
+        recorder.stop();
+        rec.graph = recorder.graph();
+        return rec;
+    }
+
+    void checkEntry(ForgeKernelCache::Entry& entry, const Recording& rec, double weight) {
+        const Size n = rec.inputs.size();
+        std::vector<double> x(n), dy(n);
+        for (Size i = 0; i < n; ++i)
+            x[i] = 0.1 * (i + 1);
+        double y = 0.0;
+        forgeWithBatchWidth(entry.buffer->getVectorWidth(), [&](auto w) {
+            constexpr Size W = decltype(w)::value;
+            ForgeBatchEvaluator<W> evaluator(*entry.kernel, *entry.buffer, rec.inputs,
+                                             {rec.output}, rec.inputs);
+            evaluator.evaluate(x.data(), 1, n, &y, dy.data());
+        });
+        double expected = 0.0;
+        for (Size i = 0; i < n; ++i) {
+            expected += weight * (i + 1) * std::exp(-x[i]);
+            BOOST_CHECK_CLOSE(dy[i], -weight * (i + 1) * std::exp(-x[i]), 1e-10);
+        }
+        BOOST_CHECK_CLOSE(y, expected, 1e-10);
+    }
+
+    std::vector<double> sample(Size rows, Size n) {
+        std::vector<double> s(rows * n);
+        for (Size k = 0; k < s.size(); ++k)
+            s[k] = 0.001 * double(k % 97);
+        return s;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(testTuningOncePerFamily) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing that each graph family is benchmarked once...");
+
+    ForgeAutotuneOptions options;
+    options.sampleScenarios = 64;
+    ForgeAutotuner tuner(forgeAutotuneCandidates(), options);
+    BOOST_TEST_MESSAGE("  CPU model: " << tuner.cpuModel() << ", "
+                                       << tuner.candidates().size() << " candidates");
+
+    const Size n = 8;
+    const std::vector<double> rows = sample(16, n);
+    Recording first = record(1.0, n);
+    ForgeKernelCache::Entry entry = tuner.acquire(first.graph, first.inputs, rows.data(), 16, n);
+    BOOST_CHECK_EQUAL(tuner.tunings(), 1U);
+    checkEntry(entry, first, 1.0);
+
+    ForgeAutotuneChoice choice = tuner.choose(first.graph);
+    BOOST_CHECK(choice.measured);
+    BOOST_CHECK(choice.secondsPerScenario > 0.0);
+    BOOST_CHECK_EQUAL(choice.graphHash, ForgeAutotuner::familyHash(first.graph));
+    BOOST_CHECK(tuner.find(choice.graphHash) != nullptr);
+    BOOST_TEST_MESSAGE("  chose " << choice.candidate << ", "
+                                  << choice.secondsPerScenario * 1e9 << " ns per scenario");
+
+    // a recording at other inputs reuses the kernel
+    entry = tuner.acquire(first.graph, first.inputs, rows.data(), 16, n);
+    BOOST_CHECK(entry.hit);
+
+    // the same structure with other constants is compiled with the same choice
+    Recording second = record(2.0, n);
+    entry = tuner.acquire(second.graph, second.inputs, rows.data(), 16, n);
+    BOOST_CHECK_EQUAL(tuner.tunings(), 1U);
+    BOOST_CHECK(!entry.hit);
+    checkEntry(entry, second, 2.0);
+
+    // another structure is a new family
+    Recording longer = record(1.0, n + 3);
+    const std::vector<double> longerRows = sample(16, n + 3);
+    entry = tuner.acquire(longer.graph, longer.inputs, longerRows.data(), 16, n + 3);
+    BOOST_CHECK_EQUAL(tuner.tunings(), 2U);
+    BOOST_CHECK_EQUAL(tuner.size(), 2U);
+    checkEntry(entry, longer, 1.0);
+
+    // a single candidate always wins
+    forge::CompilerConfig scalar = forge::CompilerConfig::NoOptimization();
+    scalar.instructionSet = forge::CompilerConfig::InstructionSet::SSE2_SCALAR;
+    ForgeAutotuner single({{"only", scalar}}, options);
+    BOOST_CHECK_EQUAL(single.choose(first.graph).candidate, "only");
+
+    BOOST_CHECK_THROW(ForgeAutotuner(std::vector<ForgeAutotuneCandidate>()), Error);
+    BOOST_CHECK_THROW(ForgeAutotuner({{"two words", scalar}}), Error);
+    BOOST_CHECK_THROW(single.choose(longer.graph, longer.inputs), Error);
+}
+
+BOOST_AUTO_TEST_CASE(testChoicesPersist) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing that autotuning choices survive a restart...");
+
+    const std::string path = "forge_autotune_test.txt";
+    std::remove(path.c_str());
+    ForgeAutotuneOptions options;
+    options.sampleScenarios = 32;
+    options.storePath = path;
+
+    const Size n = 6;
+    const std::vector<double> rows = sample(8, n);
+    Recording rec = record(1.0, n);
+    ForgeAutotuneChoice tuned;
+    {
+        ForgeAutotuner tuner(forgeAutotuneCandidates(), options);
+        tuned = tuner.choose(rec.graph, rec.inputs, rows.data(), 8, n);
+        BOOST_CHECK_EQUAL(tuner.tunings(), 1U);
+    }
+
+    // a restarted process reads the winner instead of measuring again
+    ForgeAutotuner restarted(forgeAutotuneCandidates(), options);
+    BOOST_CHECK_EQUAL(restarted.size(), 1U);
+    ForgeKernelCache::Entry entry = restarted.acquire(rec.graph, rec.inputs, rows.data(), 8, n);
+    BOOST_CHECK_EQUAL(restarted.tunings(), 0U);
+    checkEntry(entry, rec, 1.0);
+    ForgeAutotuneChoice loaded = restarted.choose(rec.graph);
+    BOOST_CHECK(!loaded.measured);
+    BOOST_CHECK_EQUAL(loaded.candidate, tuned.candidate);
+    BOOST_CHECK_EQUAL(forgeConfigHash(loaded.config), forgeConfigHash(tuned.config));
+    std::remove(path.c_str());
+
+    // choices made on another CPU model are kept but not used
+    {
+        std::ofstream out(path);
+        out << ForgeAutotuner::magic << ' ' << ForgeAutotuner::formatVersion << '\n'
+            << std::hex << ForgeAutotuner::familyHash(rec.graph) << std::dec
+            << "\tsse2-noopt\t1e-08\t0 0 0 0 0\t0\tSome Other CPU\n";
+    }
+    options.storePath.clear();
+    ForgeAutotuner foreign(forgeAutotuneCandidates(), options);
+    foreign.load(path);
+    BOOST_CHECK_EQUAL(foreign.size(), 0U);
+    foreign.choose(rec.graph, rec.inputs, rows.data(), 8, n);
+    BOOST_CHECK_EQUAL(foreign.tunings(), 1U);
+    foreign.save(path);
+    ForgeAutotuner both;
+    both.load(path);
+    BOOST_CHECK_EQUAL(both.size(), 1U);
+    std::remove(path.c_str());
+
+    {
+        std::ofstream out(path);
+        out << "not an autotuning store";
+    }
+    BOOST_CHECK_THROW(foreign.load(path), Error);
+    std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,354 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Lane-batched evaluator and scenario cube tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/batchevaluator.hpp>
+#include <ql/forge/scenariocube.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+#include <expressions/abool.hpp>
+#include <expressions/abool_helpers.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(BatchEvaluatorForgeTests)
+
+namespace {
+
+    // two-factor toy trade: notional * discount(rate) + spread * notional
+    Real priceTrade(Real rate, Real spread) {
+        Date today = Settings::instance().evaluationDate();
+        auto curve = ext::make_shared<FlatForward>(today, rate, Actual365Fixed());
+        return 1000000.0 * (curve->discount(today + 5 * Years) + spread);
+    }
+
+    struct RecordedTrade {
+        forge::Graph graph;
+        std::vector<forge::NodeId> inputs;
+        forge::NodeId output;
+    };
+
+    RecordedTrade recordTrade() {
+        forge::GraphRecorder recorder;
+        recorder.start();
+        Real rate = 0.03, spread = 0.001;
+        rate.markForgeInputAndDiff();
+        spread.markForgeInputAndDiff();
+        Real npv = priceTrade(rate, spread);
+        npv.markForgeOutput();
+        recorder.stop();
+        return {recorder.graph(), {rate.forgeNodeId(), spread.forgeNodeId()}, npv.forgeNodeId()};
+    }
+
+    double rateOf(Size p) { return 0.01 + 0.001 * p; }
+    double spreadOf(Size p) { return 0.0005 * p; }
+
+}
+
+BOOST_AUTO_TEST_CASE(testBatchedEvaluationWithTail) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing lane-batched evaluation of row-major scenarios with a partial last batch...");
+
+    auto trade = recordTrade();
+    for (auto isa : {forge::CompilerConfig::InstructionSet::SSE2_SCALAR,
+                     forge::CompilerConfig::InstructionSet::AVX2_PACKED}) {
+        forge::CompilerConfig config;
+        config.instructionSet = isa;
+        ForgeKernelCache cache(config);
+        auto entry = cache.acquire(trade.graph);
+        BOOST_CHECK_EQUAL(forgeVectorWidth(config), Size(entry.buffer->getVectorWidth()));
+
+        // 7 scenarios, row stride 3 with an unused column
+        const Size n = 7, stride = 3;
+        std::vector<double> scenarios(n * stride, -1.0);
+        for (Size p = 0; p < n; ++p) {
+            scenarios[p * stride] = rateOf(p);
+            scenarios[p * stride + 1] = spreadOf(p);
+        }
+        std::vector<double> npvs(n), gradients(n * 2);
+        forgeEvaluateBatched(*entry.kernel, *entry.buffer, trade.inputs, {trade.output},
+                             trade.inputs, scenarios.data(), n, stride, npvs.data(),
+                             gradients.data());
+
+        for (Size p = 0; p < n; ++p) {
+            QL_CHECK_CLOSE(Real(npvs[p]), priceTrade(rateOf(p), spreadOf(p)), 1e-10);
+            QL_CHECK_CLOSE(Real(gradients[p * 2 + 1]), Real(1000000.0), 1e-10);
+            BOOST_CHECK(gradients[p * 2] < 0.0);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testScenarioCubeLayout) {
+
+    BOOST_TEST_MESSAGE("Testing scenario cube layout, alignment and tail padding...");
+
+    ForgeScenarioCube cube(2, 5, 3, 4);
+    BOOST_CHECK_EQUAL(cube.batches(), 2U);
+    BOOST_CHECK_EQUAL(cube.batchSize(1), 1U);
+    BOOST_CHECK_EQUAL(cube.size(), 2U * 2U * 3U * 4U);
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(cube.data()) % ForgeScenarioCube::alignment, 0U);
+
+    for (Size t = 0; t < 2; ++t)
+        for (Size p = 0; p < 5; ++p)
+            for (Size f = 0; f < 3; ++f)
+                cube(t, p, f) = 100.0 * t + 10.0 * p + f;
+    cube.padTails();
+
+    // lane-interleaved batches and strided path views
+    BOOST_CHECK_EQUAL(cube.batch(1, 0)[2 * 4 + 3], 100.0 + 30.0 + 2.0);
+    auto path = cube.path(1, 2);
+    BOOST_CHECK_EQUAL(path.stride(), 4U);
+    for (Size f = 0; f < 3; ++f)
+        BOOST_CHECK_EQUAL(path[f], 100.0 + 20.0 + f);
+    // padding lanes repeat the last valid path
+    for (Size lane = 1; lane < 4; ++lane)
+        BOOST_CHECK_EQUAL(cube.batch(0, 1)[1 * 4 + lane], 40.0 + 1.0);
+
+    BOOST_CHECK_THROW(cube(0, 5, 0), Error);
+}
+
+BOOST_AUTO_TEST_CASE(testInterleavedLoadFromCube) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing packed evaluation straight from scenario cube batches...");
+
+    auto trade = recordTrade();
+    forge::CompilerConfig config;
+    config.instructionSet = forge::CompilerConfig::InstructionSet::AVX2_PACKED;
+    ForgeKernelCache cache(config);
+    auto entry = cache.acquire(trade.graph);
+
+    const Size n = 10;
+    ForgeScenarioCube cube(1, n, 2, 4);
+    for (Size p = 0; p < n; ++p) {
+        cube(0, p, 0) = rateOf(p);
+        cube(0, p, 1) = spreadOf(p);
+    }
+    cube.padTails();
+
+    ForgeBatchEvaluator<4> evaluator(*entry.kernel, *entry.buffer, trade.inputs, {trade.output});
+    for (Size b = 0; b < cube.batches(); ++b) {
+        double npvs[4];
+        evaluator.loadInterleaved(cube.batch(0, b), cube.batchSize(b));
+        evaluator.execute();
+        evaluator.readOutputs(npvs, 1);
+        for (Size lane = 0; lane < cube.batchSize(b); ++lane) {
+            Size p = b * 4 + lane;
+            QL_CHECK_CLOSE(Real(npvs[lane]), priceTrade(rateOf(p), spreadOf(p)), 1e-10);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testStridedGradientAccumulation) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing strided and accumulating gradient extraction...");
+
+    auto trade = recordTrade();
+    forge::CompilerConfig config;
+    config.instructionSet = forge::CompilerConfig::InstructionSet::AVX2_PACKED;
+    ForgeKernelCache cache(config);
+    auto entry = cache.acquire(trade.graph);
+
+    const Size n = 6;
+    std::vector<double> scenarios(n * 2);
+    for (Size p = 0; p < n; ++p) {
+        scenarios[p * 2] = rateOf(p);
+        scenarios[p * 2 + 1] = spreadOf(p);
+    }
+
+    ForgeBatchEvaluator<4> evaluator(*entry.kernel, *entry.buffer, trade.inputs, {trade.output},
+                                     trade.inputs);
+    // row-major reference, factor-major destination accumulated over two passes
+    std::vector<double> rows(n * 2), factorMajor(2 * n, 0.0);
+    for (Size pass = 0; pass < 2; ++pass) {
+        for (Size first = 0; first < n; first += 4) {
+            Size count = std::min<Size>(4, n - first);
+            evaluator.load(scenarios.data(), 2, first, count);
+            evaluator.execute();
+            evaluator.readGradients(rows.data() + first * 2, 2);
+            evaluator.readGradients(factorMajor.data() + first, 1, n, true);
+        }
+    }
+
+    for (Size p = 0; p < n; ++p)
+        for (Size g = 0; g < 2; ++g)
+            QL_CHECK_CLOSE(Real(factorMajor[g * n + p]), Real(2.0 * rows[p * 2 + g]), 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(testContiguousInputBlock) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing block loads on a graph relaid for contiguous inputs...");
+
+    // the inputs are marked apart, with pricing nodes recorded in between
+    forge::GraphRecorder recorder;
+    recorder.start();
+    Real rate = 0.03;
+    rate.markForgeInputAndDiff();
+    Real df = exp(-rate * 5.0);
+    Real spread = 0.001;
+    spread.markForgeInputAndDiff();
+    Real npv = 1000000.0 * (df + spread);
+    npv.markForgeOutput();
+    recorder.stop();
+    const std::vector<forge::NodeId> inputs = {rate.forgeNodeId(), spread.forgeNodeId()};
+
+    ForgeRelaidGraph relaid = forgeContiguousLayout(recorder.graph(), inputs, {npv.forgeNodeId()});
+    BOOST_CHECK_EQUAL(relaid.graph.nodes.size(), recorder.graph().nodes.size());
+    BOOST_CHECK_EQUAL(relaid.remap(inputs[0]), forge::NodeId(0));
+    BOOST_CHECK_EQUAL(relaid.remap(inputs[1]), forge::NodeId(1));
+    BOOST_CHECK_EQUAL(relaid.remap(npv.forgeNodeId()),
+                      forge::NodeId(relaid.graph.nodes.size() - 1));
+    BOOST_CHECK_THROW(forgeContiguousLayout(recorder.graph(), {npv.forgeNodeId()}, {}), Error);
+
+    forge::CompilerConfig config;
+    config.instructionSet = forge::CompilerConfig::InstructionSet::AVX2_PACKED;
+    ForgeKernelCache cache(config);
+    auto entry = cache.acquire(relaid.graph);
+    const std::vector<forge::NodeId> ids = relaid.remap(inputs);
+    ForgeBatchEvaluator<4> evaluator(*entry.kernel, *entry.buffer, ids,
+                                     {relaid.remap(npv.forgeNodeId())}, ids);
+    BOOST_TEST_MESSAGE("  contiguous inputs " << evaluator.contiguousInputs() << ", outputs "
+                                              << evaluator.contiguousOutputs() << ", gradients "
+                                              << evaluator.contiguousGradients());
+    // the relaid inputs, outputs and adjoints each form one block of the buffer
+    BOOST_REQUIRE(evaluator.direct());
+    BOOST_CHECK(evaluator.contiguousInputs());
+    BOOST_CHECK(evaluator.contiguousOutputs());
+    BOOST_CHECK(evaluator.contiguousGradients());
+    BOOST_REQUIRE(evaluator.inputBlock() != nullptr);
+
+    double* target = evaluator.inputBlock();
+    for (Size lane = 0; lane < 4; ++lane) {
+        target[lane] = rateOf(lane);
+        target[4 + lane] = spreadOf(lane);
+    }
+    evaluator.loadInterleaved(target, 4);
+    evaluator.execute();
+
+    double npvs[4], npvBlock[4], gradients[8], gradientBlock[8];
+    evaluator.readOutputs(npvs, 1);
+    evaluator.readOutputBlock(npvBlock);
+    evaluator.readGradients(gradients, 2);
+    evaluator.readGradientBlock(gradientBlock);
+    for (Size lane = 0; lane < 4; ++lane) {
+        const double expected = 1000000.0 * (std::exp(-rateOf(lane) * 5.0) + spreadOf(lane));
+        QL_CHECK_CLOSE(Real(npvs[lane]), Real(expected), 1e-10);
+        QL_CHECK_CLOSE(Real(npvBlock[lane]), Real(npvs[lane]), 1e-14);
+        QL_CHECK_CLOSE(Real(gradients[lane * 2]),
+                       Real(-5000000.0 * std::exp(-rateOf(lane) * 5.0)), 1e-10);
+        QL_CHECK_CLOSE(Real(gradientBlock[lane]), Real(gradients[lane * 2]), 1e-14);
+        QL_CHECK_CLOSE(Real(gradientBlock[4 + lane]), Real(gradients[lane * 2 + 1]), 1e-14);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testContiguousLayoutPreservesKernel) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing that a relaid graph computes what the original does...");
+
+    // every kind of operand slot: unary, binary, and the three of a select,
+    // with the inputs marked apart and an output other nodes use
+    forge::GraphRecorder recorder;
+    recorder.start();
+    const Size n = 4;
+    std::vector<Real> x(n);
+    std::vector<forge::NodeId> inputs;
+    Real inner = 0.0;
+    for (Size i = 0; i < n; ++i) {
+        x[i] = 0.5 + i;
+        x[i].markForgeInputAndDiff();
+        inputs.push_back(x[i].forgeNodeId());
+        inner += sqrt(x[i]) * log(1.0 + x[i]) - x[i] / (2.0 + i);
+    }
+    Real used = exp(-x[0] * x[1]) + max(x[2], x[3]) - abs(x[1] - x[2]);
+    forge::ABool cond = forge::greaterEqual(x[0].forgeValue(), x[3].forgeValue());
+    Real product = x[0] * x[2], power = pow(x[3], x[1]);
+    Real selected = cond.If(product, power);
+    Real npv = inner + used * selected - min(used, x[1]);
+    used.markForgeOutput();
+    npv.markForgeOutput();
+    recorder.stop();
+    const std::vector<forge::NodeId> outputs = {used.forgeNodeId(), npv.forgeNodeId()};
+
+    const forge::Graph& graph = recorder.graph();
+    ForgeRelaidGraph relaid = forgeContiguousLayout(graph, inputs, outputs);
+    const std::vector<forge::NodeId> relaidInputs = relaid.remap(inputs);
+    const std::vector<forge::NodeId> relaidOutputs = relaid.remap(outputs);
+    for (Size i = 0; i < n; ++i)
+        BOOST_CHECK_EQUAL(relaidInputs[i], forge::NodeId(i));
+
+    forge::ForgeEngine compiler;
+    auto kernel = compiler.compile(graph);
+    auto buffer = forge::NodeValueBufferFactory::create(graph, *kernel);
+    auto relaidKernel = compiler.compile(relaid.graph);
+    auto relaidBuffer = forge::NodeValueBufferFactory::create(relaid.graph, *relaidKernel);
+    const Size width = buffer->getVectorWidth();
+    BOOST_REQUIRE_EQUAL(Size(relaidBuffer->getVectorWidth()), width);
+
+    std::vector<std::size_t> gradientIndices, relaidGradientIndices;
+    for (Size i = 0; i < n; ++i) {
+        gradientIndices.push_back(buffer->getBufferIndex(inputs[i]));
+        relaidGradientIndices.push_back(relaidBuffer->getBufferIndex(relaidInputs[i]));
+    }
+
+    // both sides of the select, over random scenarios
+    std::mt19937_64 rng(17);
+    std::uniform_real_distribution<double> uniform(0.1, 4.0);
+    std::vector<double> lanes(width), values(width), relaidValues(width);
+    std::vector<double> gradients(n * width), relaidGradients(n * width);
+    for (Size batch = 0; batch < 8; ++batch) {
+        for (Size i = 0; i < n; ++i) {
+            for (Size lane = 0; lane < width; ++lane)
+                lanes[lane] = uniform(rng);
+            buffer->setLanes(inputs[i], lanes.data());
+            relaidBuffer->setLanes(relaidInputs[i], lanes.data());
+        }
+        buffer->clearGradients();
+        relaidBuffer->clearGradients();
+        kernel->execute(*buffer);
+        relaidKernel->execute(*relaidBuffer);
+        for (Size o = 0; o < outputs.size(); ++o) {
+            buffer->getLanes(outputs[o], values.data());
+            relaidBuffer->getLanes(relaidOutputs[o], relaidValues.data());
+            for (Size lane = 0; lane < width; ++lane)
+                QL_CHECK_CLOSE(Real(relaidValues[lane]), Real(values[lane]), 1e-12);
+        }
+        buffer->getGradientLanes(gradientIndices, gradients.data());
+        relaidBuffer->getGradientLanes(relaidGradientIndices, relaidGradients.data());
+        for (Size k = 0; k < n * width; ++k)
+            BOOST_CHECK_SMALL(relaidGradients[k] - gradients[k], 1e-12 * (1.0 + std::fabs(gradients[k])));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -20,6 +20,7 @@
 
 #include "toplevelfixture.hpp"
 #include "utilities_forge.hpp"
+#include "perf_forge.hpp"
 #include <ql/cashflows/coupon.hpp>
 #include <ql/indexes/ibor/euribor.hpp>
 #include <ql/instruments/swaption.hpp>
@@ -242,6 +243,13 @@ BOOST_AUTO_TEST_CASE(testBermudanSwaptionDerivatives) {
     QL_CHECK_CLOSE(derivatives_bumping.forwardRate, derivatives_forge.forwardRate, 1e-3);
     QL_CHECK_CLOSE(derivatives_bumping.a, derivatives_forge.a, 1e-3);
     QL_CHECK_CLOSE(derivatives_bumping.sigma, derivatives_forge.sigma, 1e-3);
+
+    // kernel-versus-QuantLib timing, under --forge_perf
+    forgePerfMeasure("bermudanswaption", data,
+                     {&BermudanSwaptionData::nominal, &BermudanSwaptionData::fixedRate,
+                      &BermudanSwaptionData::forwardRate, &BermudanSwaptionData::a,
+                      &BermudanSwaptionData::sigma},
+                     priceBermudanSwaption);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
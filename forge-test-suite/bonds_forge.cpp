@@ -20,6 +20,7 @@
 
 #include "toplevelfixture.hpp"
 #include "utilities_forge.hpp"
+#include "perf_forge.hpp"
 #include <ql/experimental/callablebonds/callablebond.hpp>
 #include <ql/experimental/callablebonds/treecallablebondengine.hpp>
 #include <ql/instruments/bonds/fixedratebond.hpp>
@@ -231,6 +232,12 @@ BOOST_AUTO_TEST_CASE(testBondsDerivatives) {
     QL_CHECK_CLOSE(derivatives_bumping.spotRate3, derivatives_forge.spotRate3, 1e-3);
     QL_CHECK_CLOSE(derivatives_bumping.couponRate, derivatives_forge.couponRate, 1e-3);
     QL_CHECK_CLOSE(derivatives_bumping.faceValue, derivatives_forge.faceValue, 1e-3);
+
+    // kernel-versus-QuantLib timing, under --forge_perf
+    forgePerfMeasure("bonds", data,
+                     {&BondsData::spotRate1, &BondsData::spotRate2, &BondsData::spotRate3,
+                      &BondsData::couponRate, &BondsData::faceValue},
+                     priceBonds);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,271 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Lane-packed bump-and-revalue tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/bumpbatch.hpp>
+#include <ql/forge/graphhash.hpp>
+#include <ql/forge/kernelcache.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(BumpBatchForgeTests)
+
+namespace {
+
+    const Size numFactors = 9;
+
+    struct Recording {
+        forge::Graph graph;
+        std::vector<forge::NodeId> inputs, outputs;
+    };
+
+    // y0 = sum_i (i + 1) exp(-x_i) + x_0 x_8, y1 = x_1^2 - x_7
+    Recording record() {
+        forge::GraphRecorder recorder;
+        recorder.start();
+        Recording rec;
+        std::vector<Real> x(numFactors, 0.02);
+        Real y0 = 0.0;
+        for (Size i = 0; i < numFactors; ++i) {
+            x[i].markForgeInput();
+            rec.inputs.push_back(x[i].forgeNodeId());
+            y0 += (i + 1) * exp(-x[i]);
+        }
+        y0 += x[0] * x[numFactors - 1];
+        Real y1 = x[1] * x[1] - x[7];
+        y0.markForgeOutput();
+        y1.markForgeOutput();
+        rec.outputs = {y0.forgeNodeId(), y1.forgeNodeId()};
+        recorder.stop();
+        rec.graph = recorder.graph();
+        return rec;
+    }
+
+    double dy0(const double* x, Size i) {
+        double d = -(i + 1.0) * std::exp(-x[i]);
+        if (i == 0)
+            d += x[numFactors - 1];
+        if (i == numFactors - 1)
+            d += x[0];
+        return d;
+    }
+
+    double dy1(const double* x, Size i) {
+        return i == 1 ? 2.0 * x[1] : (i == 7 ? -1.0 : 0.0);
+    }
+
+    double factorOf(Size path, Size i) { return 0.01 + 0.002 * i + 0.005 * path; }
+
+}
+
+BOOST_AUTO_TEST_CASE(testBumpsFromLanes) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing bump-and-revalue sensitivities from packed lanes...");
+
+    const Recording rec = record();
+    for (auto isa : {forge::CompilerConfig::InstructionSet::SSE2_SCALAR,
+                     forge::CompilerConfig::InstructionSet::AVX2_PACKED}) {
+        forge::CompilerConfig config;
+        config.instructionSet = isa;
+        forge::ForgeEngine compiler(config);
+        auto kernel = compiler.compile(rec.graph);
+        auto buffer = forge::NodeValueBufferFactory::create(rec.graph, *kernel);
+
+        forgeWithBatchWidth(buffer->getVectorWidth(), [&](auto w) {
+            constexpr Size W = decltype(w)::value;
+            ForgeBumpBatch<W> forward(*kernel, *buffer, rec.inputs, rec.outputs, 1e-7);
+            BOOST_CHECK_EQUAL(forward.lanes(), numFactors + 1);
+            BOOST_CHECK_EQUAL(forward.executions(), (numFactors + W) / W);
+            // the same bumps given as unit directions
+            ForgeBumpBatch<W> tangents(*kernel, *buffer, rec.inputs, rec.outputs,
+                                       forgeUnitDirections(numFactors), 1e-7);
+
+            // consecutive scenarios, so that the lanes bumped by one are restored for the next
+            for (Size path = 0; path < 3; ++path) {
+                double x[numFactors];
+                for (Size i = 0; i < numFactors; ++i)
+                    x[i] = factorOf(path, i);
+                double values[2], deltas[2 * numFactors], expected[2], reference[2 * numFactors];
+                forward.evaluate(x, 1, values, deltas);
+                tangents.evaluate(x, 1, expected, reference);
+                for (Size o = 0; o < 2; ++o)
+                    BOOST_CHECK_CLOSE(values[o], expected[o], 1e-12);
+                for (Size k = 0; k < 2 * numFactors; ++k)
+                    BOOST_CHECK_CLOSE(deltas[k], reference[k], 1e-9);
+                for (Size i = 0; i < numFactors; ++i) {
+                    BOOST_CHECK_SMALL(deltas[2 * i] - dy0(x, i), 1e-5);
+                    BOOST_CHECK_SMALL(deltas[2 * i + 1] - dy1(x, i), 1e-5);
+                }
+            }
+
+            // central differences with a bump per input, sensitivities factor-major
+            std::vector<double> bumps(numFactors);
+            for (Size i = 0; i < numFactors; ++i)
+                bumps[i] = 1e-4 * (i + 1);
+            ForgeBumpBatch<W> central(*kernel, *buffer, rec.inputs, rec.outputs, bumps,
+                                      ForgeDifferenceScheme::Central);
+            BOOST_CHECK_EQUAL(central.lanes(), 2 * numFactors + 1);
+            double x[numFactors];
+            for (Size i = 0; i < numFactors; ++i)
+                x[i] = factorOf(4, i);
+            double values[2], deltas[2 * numFactors];
+            central.evaluate(x, 1, values, deltas, 1, numFactors);
+            for (Size i = 0; i < numFactors; ++i) {
+                BOOST_CHECK_SMALL(deltas[i] - dy0(x, i), 1e-5);
+                BOOST_CHECK_SMALL(deltas[numFactors + i] - dy1(x, i), 1e-9);
+            }
+
+            BOOST_CHECK_THROW(ForgeBumpBatch<W>(*kernel, *buffer, rec.inputs, rec.outputs, 0.0),
+                              Error);
+            BOOST_CHECK_THROW(ForgeBumpBatch<W>(*kernel, *buffer, rec.inputs, rec.outputs,
+                                                std::vector<double>(2, 1e-4)),
+                              Error);
+        });
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testBumpsIntoTensor) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing bump-and-revalue sensitivities written into a tensor...");
+
+    // a single output, on a graph laid out for in-place scenario generation
+    const Recording rec = record();
+    ForgeRelaidGraph relaid = forgeContiguousLayout(rec.graph, rec.inputs, {rec.outputs[0]});
+    const std::vector<forge::NodeId> inputs = relaid.remap(rec.inputs);
+    const forge::NodeId output = relaid.remap(rec.outputs[0]);
+
+    forge::CompilerConfig config;
+    config.instructionSet = forge::CompilerConfig::InstructionSet::AVX2_PACKED;
+    ForgeKernelCache cache(config);
+    auto entry = cache.acquire(relaid.graph);
+
+    const Size paths = 5;
+    // the scenarios are strided, as in a ForgeScenarioCube
+    std::vector<double> scenarios(paths * numFactors * 2, -1.0);
+    for (Size p = 0; p < paths; ++p)
+        for (Size i = 0; i < numFactors; ++i)
+            scenarios[(p * numFactors + i) * 2] = factorOf(p, i);
+
+    forgeWithBatchWidth(entry.buffer->getVectorWidth(), [&](auto w) {
+        constexpr Size W = decltype(w)::value;
+        ForgeBumpBatch<W> bumps(*entry.kernel, *entry.buffer, inputs, {output}, 1e-7);
+        BOOST_TEST_MESSAGE("  " << bumps.executions() << " executions of width " << W
+                                << " per path, in place " << bumps.inPlace());
+
+        for (auto layout : {ForgeSensitivityLayout::PathMajor, ForgeSensitivityLayout::FactorMajor,
+                            ForgeSensitivityLayout::Aggregated}) {
+            ForgeSensitivityTensor deltas(1, 2, paths, numFactors, layout);
+            std::vector<double> sums(numFactors, 0.0);
+            for (Size p = 0; p < paths; ++p) {
+                const double* x = &scenarios[p * numFactors * 2];
+                double expected = 0.0, plain[numFactors];
+                for (Size i = 0; i < numFactors; ++i)
+                    plain[i] = x[2 * i];
+                for (Size i = 0; i < numFactors; ++i)
+                    expected += (i + 1) * std::exp(-plain[i]);
+                expected += plain[0] * plain[numFactors - 1];
+                BOOST_CHECK_CLOSE(bumps.evaluate(x, 2, deltas, 0, 1, p), expected, 1e-12);
+                for (Size i = 0; i < numFactors; ++i) {
+                    sums[i] += dy0(plain, i);
+                    if (deltas.storesPaths())
+                        BOOST_CHECK_SMALL(deltas(0, 1, p, i) - dy0(plain, i), 1e-5);
+                }
+            }
+            BOOST_CHECK_EQUAL(deltas.count(0, 1), paths);
+            BOOST_CHECK_EQUAL(deltas.count(0, 0), 0U);
+            for (Size i = 0; i < numFactors; ++i)
+                BOOST_CHECK_SMALL(deltas.mean(0, 1, i) - sums[i] / paths, 1e-5);
+        }
+
+        ForgeSensitivityTensor wrongFactors(1, 1, paths, numFactors - 1);
+        BOOST_CHECK_THROW(bumps.evaluate(scenarios.data(), 2, wrongFactors, 0, 0, 0), Error);
+    });
+}
+
+BOOST_AUTO_TEST_CASE(testDirectionalBumps) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing directional derivatives from bumped lanes...");
+
+    // y0 = x0 x1 + x2^2, y1 = x0 - 3 x2
+    forge::GraphRecorder recorder;
+    recorder.start();
+    std::vector<Real> x(3, 1.0);
+    std::vector<forge::NodeId> inputs;
+    for (Size i = 0; i < 3; ++i) {
+        x[i].markForgeInput();
+        inputs.push_back(x[i].forgeNodeId());
+    }
+    Real y0 = x[0] * x[1] + x[2] * x[2];
+    Real y1 = x[0] - 3.0 * x[2];
+    y0.markForgeOutput();
+    y1.markForgeOutput();
+    recorder.stop();
+    forge::ForgeEngine compiler;
+    auto kernel = compiler.compile(recorder.graph());
+    auto buffer = forge::NodeValueBufferFactory::create(recorder.graph(), *kernel);
+    const std::vector<forge::NodeId> outputs = {y0.forgeNodeId(), y1.forgeNodeId()};
+
+    // the scenario is strided, as in a ForgeScenarioCube
+    const double scenario[6] = {0.5, -1.0, 2.0, -1.0, -1.5, -1.0};
+    const double jacobian[2][3] = {{2.0, 0.5, -3.0}, {1.0, 0.0, -3.0}};
+
+    forgeWithBatchWidth(buffer->getVectorWidth(), [&](auto w) {
+        constexpr Size W = decltype(w)::value;
+
+        // two directions, one of them along a single input
+        ForgeBumpBatch<W> forward(*kernel, *buffer, inputs, outputs,
+                                  {{1.0, 1.0, 0.0}, {0.0, 0.0, 1.0}}, 1e-7);
+        BOOST_CHECK_EQUAL(forward.numDirections(), 2U);
+        BOOST_CHECK_EQUAL(forward.lanes(), 3U);
+        BOOST_CHECK_EQUAL(forward.executions(), (3 + W - 1) / W);
+        double values[2], tangents[4];
+        forward.evaluate(scenario, 2, values, tangents);
+        BOOST_CHECK_CLOSE(values[0], 0.5 * 2.0 + 1.5 * 1.5, 1e-12);
+        BOOST_CHECK_CLOSE(values[1], 0.5 + 4.5, 1e-12);
+        for (Size o = 0; o < 2; ++o) {
+            BOOST_CHECK_SMALL(tangents[o] - (jacobian[o][0] + jacobian[o][1]), 1e-5);
+            BOOST_CHECK_SMALL(tangents[2 + o] - jacobian[o][2], 1e-5);
+        }
+
+        // one direction, central differences
+        ForgeBumpBatch<W> central(*kernel, *buffer, inputs, outputs, {{1.0, 1.0, 0.0}}, 1e-4,
+                                  ForgeDifferenceScheme::Central);
+        BOOST_CHECK_EQUAL(central.lanes(), 3U);
+        central.evaluate(scenario, 2, values, tangents);
+        BOOST_CHECK_SMALL(tangents[0] - (jacobian[0][0] + jacobian[0][1]), 1e-8);
+        BOOST_CHECK_SMALL(tangents[1] - (jacobian[1][0] + jacobian[1][1]), 1e-8);
+
+        BOOST_CHECK_THROW(ForgeBumpBatch<W>(*kernel, *buffer, inputs, outputs, {{1.0, 0.0}}, 1e-4),
+                          Error);
+    });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,127 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Kernel-driven calibration tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/calibration.hpp>
+#include <ql/math/optimization/levenbergmarquardt.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(CalibrationForgeTests)
+
+namespace {
+
+    // a term-structure and smile toy: level * exp(-decay * T) + curvature * K^2
+    template <class T>
+    T modelQuote(const T& level, const T& decay, const T& curvature, double maturity,
+                 double moneyness) {
+        return level * exp(-decay * maturity) + curvature * moneyness * moneyness;
+    }
+
+    std::vector<std::vector<double>> helperData(const double* truth) {
+        std::vector<std::vector<double>> data;
+        for (Size m = 0; m < 4; ++m) {
+            for (Size s = 0; s < 5; ++s) {
+                const double t = 0.25 + 0.75 * m, k = -0.2 + 0.1 * s;
+                data.push_back({t, k, modelQuote(truth[0], truth[1], truth[2], t, k)});
+            }
+        }
+        return data;
+    }
+
+    Real residual(const std::vector<Real>& p, const std::vector<Real>& helper) {
+        return p[0] * exp(-p[1] * helper[0]) + p[2] * helper[1] * helper[1] - helper[2];
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(testCostFunctionJacobian) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing calibration residuals and Jacobians from one kernel...");
+
+    const double truth[3] = {0.2, 0.8, 0.5};
+    const std::vector<std::vector<double>> data = helperData(truth);
+    std::vector<double> weights(data.size(), 1.0);
+    weights[3] = 2.0;
+    ForgeCalibrationCostFunction cost(3, data, residual, weights);
+    BOOST_CHECK_EQUAL(cost.numHelpers(), 20U);
+
+    Array x(3);
+    x[0] = 0.25;
+    x[1] = 0.6;
+    x[2] = 0.4;
+    Matrix jac;
+    Array r = cost.valuesAndJacobian(jac, x);
+    BOOST_CHECK_EQUAL(cost.evaluations(), 1U);
+    double sum = 0.0;
+    for (Size k = 0; k < data.size(); ++k) {
+        const double t = data[k][0], m = data[k][1], w = weights[k];
+        const double e = std::exp(-0.6 * t);
+        const double expected = w * (0.25 * e + 0.4 * m * m - data[k][2]);
+        QL_CHECK_CLOSE(r[k], expected, 1e-10);
+        QL_CHECK_CLOSE(jac[k][0], w * e, 1e-10);
+        QL_CHECK_CLOSE(jac[k][1], -w * 0.25 * t * e, 1e-10);
+        QL_CHECK_CLOSE(jac[k][2], w * m * m, 1e-10);
+        sum += expected * expected;
+    }
+    QL_CHECK_CLOSE(cost.value(x), sum, 1e-10);
+
+    Array grad;
+    QL_CHECK_CLOSE(cost.valueAndGradient(grad, x), sum, 1e-10);
+    for (Size p = 0; p < 3; ++p) {
+        double g = 0.0;
+        for (Size k = 0; k < data.size(); ++k)
+            g += 2.0 * value(r[k]) * value(jac[k][p]);
+        QL_CHECK_CLOSE(grad[p], g, 1e-10);
+    }
+
+    BOOST_CHECK_THROW(ForgeCalibrationCostFunction(3, {{1.0, 2.0}, {1.0}}, residual), Error);
+    BOOST_CHECK_THROW(ForgeCalibrationCostFunction(3, data, residual, {1.0}), Error);
+}
+
+BOOST_AUTO_TEST_CASE(testLevenbergMarquardtCalibration) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing Levenberg-Marquardt calibration with kernel Jacobians...");
+
+    const double truth[3] = {0.2, 0.8, 0.5};
+    ForgeCalibrationCostFunction cost(3, helperData(truth), residual);
+
+    Array params(3);
+    params[0] = 0.1;
+    params[1] = 0.3;
+    params[2] = 0.1;
+    LevenbergMarquardt method(1e-12, 1e-12, 1e-12, true);
+    forgeCalibrate(cost, params, method, EndCriteria(400, 40, 1e-14, 1e-14, 1e-14));
+    for (Size p = 0; p < 3; ++p)
+        QL_CHECK_CLOSE(params[p], truth[p], 1e-6);
+    BOOST_TEST_MESSAGE("  kernel passes over all helpers: " << cost.evaluations());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
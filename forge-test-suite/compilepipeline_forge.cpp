@@ -0,0 +1,129 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Background kernel compilation tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/compilepipeline.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(CompilePipelineForgeTests)
+
+namespace {
+
+    struct Recorded {
+        forge::NodeId input, output;
+    };
+
+    // y = x^(k + 1) + k, a structurally different graph for every k
+    forge::Graph recordPower(Size k, Recorded& ids) {
+        forge::GraphRecorder recorder;
+        recorder.start();
+        Real x = 1.0;
+        x.markForgeInputAndDiff();
+        Real y = x;
+        for (Size i = 0; i < k; ++i)
+            y = y * x;
+        y = y + Real(double(k));
+        y.markForgeOutput();
+        ids.input = x.forgeNodeId();
+        ids.output = y.forgeNodeId();
+        recorder.stop();
+        return recorder.graph();
+    }
+
+    double evaluateAt(ForgeCompiledKernel& compiled, const Recorded& ids, double x) {
+        std::vector<double> lanes(compiled.buffer->getVectorWidth(), x);
+        compiled.buffer->setLanes(ids.input, lanes.data());
+        compiled.kernel->execute(*compiled.buffer);
+        compiled.buffer->getLanes(ids.output, lanes.data());
+        return lanes[0];
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(testPipelinedEvaluationMatchesSequential) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing evaluation of kernels compiled in the background...");
+
+    const Size kernels = 8;
+    std::vector<Recorded> ids(kernels);
+    std::vector<double> values(kernels, 0.0);
+    std::vector<Size> order;
+
+    ForgeCompilePipelineOptions options;
+    options.numThreads = 2;
+    options.maxQueued = 2;
+    ForgeCompilePipeline pipeline(forge::CompilerConfig(), options);
+    BOOST_CHECK_EQUAL(pipeline.threads(), 2U);
+
+    forgePipelined(
+        pipeline, kernels, 3, [&](Size k) { return recordPower(k, ids[k]); },
+        [&](Size k, ForgeCompiledKernel& compiled) {
+            BOOST_CHECK(!compiled.cacheHit);
+            BOOST_CHECK(compiled.compileSeconds >= 0.0);
+            order.push_back(k);
+            values[k] = evaluateAt(compiled, ids[k], 2.0);
+        });
+
+    BOOST_CHECK_EQUAL(pipeline.compiled(), kernels);
+    BOOST_CHECK_EQUAL(pipeline.queued(), 0U);
+    for (Size k = 0; k < kernels; ++k) {
+        BOOST_CHECK_EQUAL(order[k], k);
+        BOOST_CHECK_CLOSE(values[k], std::pow(2.0, double(k + 1)) + k, 1e-12);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testPipelineThroughKernelCache) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing background compilation through a kernel cache...");
+
+    ForgeKernelCache cache;
+    std::vector<std::future<ForgeCompiledKernel>> futures;
+    std::vector<Recorded> ids(6);
+    {
+        ForgeCompilePipeline pipeline(cache);
+        // three distinct graphs, each submitted twice
+        for (Size i = 0; i < ids.size(); ++i)
+            futures.push_back(pipeline.submit(recordPower(i % 3, ids[i])));
+        // the destructor compiles whatever is still queued
+    }
+
+    Size hits = 0;
+    for (Size i = 0; i < futures.size(); ++i) {
+        ForgeCompiledKernel compiled = futures[i].get();
+        hits += compiled.cacheHit ? 1 : 0;
+        BOOST_CHECK_CLOSE(evaluateAt(compiled, ids[i], 3.0),
+                          std::pow(3.0, double(i % 3 + 1)) + i % 3, 1e-12);
+    }
+    BOOST_CHECK_EQUAL(cache.size(), 3U);
+    BOOST_CHECK_EQUAL(hits, 3U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -20,13 +20,17 @@
 
 #include "toplevelfixture.hpp"
 #include "utilities_forge.hpp"
+#include "perf_forge.hpp"
 #include <ql/instruments/creditdefaultswap.hpp>
+#include <ql/pricingengines/credit/isdacdsengine.hpp>
 #include <ql/pricingengines/credit/midpointcdsengine.hpp>
 #include <ql/quotes/simplequote.hpp>
 #include <ql/termstructures/credit/flathazardrate.hpp>
+#include <ql/termstructures/credit/interpolatedhazardratecurve.hpp>
 #include <ql/termstructures/defaulttermstructure.hpp>
 #include <ql/termstructures/yield/flatforward.hpp>
 #include <ql/time/calendars/target.hpp>
+#include <ql/time/calendars/weekendsonly.hpp>
 #include <ql/time/dategenerationrule.hpp>
 #include <ql/time/daycounters/actual360.hpp>
 #include <ql/time/schedule.hpp>
@@ -36,6 +40,7 @@
 #include <compiler/forge_engine.hpp>
 #include <compiler/node_value_buffers/node_value_buffer.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <iomanip>
 #include <iostream>
@@ -209,6 +214,76 @@ namespace {
             probabilityCurve, value.recoveryRate, discountCurve));
         return cds->NPV();
     }
+
+    // the same trade as a standard contract priced with the ISDA model
+    Real priceIsdaCreditDefaultSwap(const CreditDefaultSwapData& value) {
+        Settings::instance().evaluationDate() = Date(9, June, 2006);
+        Date today = Settings::instance().evaluationDate();
+
+        std::vector<Date> dates = {today, today + 10 * Years};
+        std::vector<Real> hazards = {value.hazardRate, value.hazardRate};
+        auto hazardCurve =
+            ext::make_shared<InterpolatedHazardRateCurve<BackwardFlat>>(dates, hazards, Actual360());
+        hazardCurve->enableExtrapolation();
+        Handle<DefaultProbabilityTermStructure> probabilityCurve(hazardCurve);
+        Handle<YieldTermStructure> discountCurve(ext::make_shared<FlatForward>(
+            today, Handle<Quote>(ext::make_shared<SimpleQuote>(value.riskFreeRate)), Actual360()));
+
+        Date maturity = cdsMaturity(today, Period(5, Years), DateGeneration::CDS);
+        Schedule schedule(today, maturity, Period(3, Months), WeekendsOnly(), Following,
+                          Unadjusted, DateGeneration::CDS, false, Date(), Date());
+        CreditDefaultSwap cds(Protection::Seller, value.notional, value.fixedRate, schedule,
+                              Following, Actual360(), true, true, today + 1,
+                              ext::shared_ptr<Claim>(), Actual360(true), true, today);
+        cds.setPricingEngine(
+            ext::make_shared<IsdaCdsEngine>(probabilityCurve, value.recoveryRate, discountCurve));
+        return cds.NPV();
+    }
+
+    // records price once at build, differentiating hazard, recovery and discount rate, and
+    // returns the kernel's NPV of each scenario, one scenario per lane
+    template <class PriceFunc>
+    std::vector<double> kernelScenarioNPVs(PriceFunc price,
+                                           const CreditDefaultSwapData& build,
+                                           const std::vector<CreditDefaultSwapData>& scenarios) {
+        forge::GraphRecorder recorder;
+        recorder.start();
+        auto data = build;
+        data.hazardRate.markForgeInputAndDiff();
+        data.recoveryRate.markForgeInputAndDiff();
+        data.riskFreeRate.markForgeInputAndDiff();
+        const std::vector<forge::NodeId> ids = {data.hazardRate.forgeNodeId(),
+                                                data.recoveryRate.forgeNodeId(),
+                                                data.riskFreeRate.forgeNodeId()};
+        auto npv = price(data);
+        npv.markForgeOutput();
+        const forge::NodeId npvNodeId = npv.forgeNodeId();
+        recorder.stop();
+
+        forge::ForgeEngine compiler;
+        auto kernel = compiler.compile(recorder.graph());
+        auto buffer = forge::NodeValueBufferFactory::create(recorder.graph(), *kernel);
+        const Size width = buffer->getVectorWidth();
+
+        // the lanes past the last scenario repeat it
+        std::vector<double> lanes(width), npvs(scenarios.size());
+        auto input = [](const CreditDefaultSwapData& d, Size i) {
+            return value(i == 0 ? d.hazardRate : (i == 1 ? d.recoveryRate : d.riskFreeRate));
+        };
+        for (Size first = 0; first < scenarios.size(); first += width) {
+            for (Size i = 0; i < ids.size(); ++i) {
+                for (Size l = 0; l < width; ++l)
+                    lanes[l] = input(scenarios[std::min(first + l, scenarios.size() - 1)], i);
+                buffer->setLanes(ids[i], lanes.data());
+            }
+            buffer->clearGradients();
+            kernel->execute(*buffer);
+            buffer->getLanes(npvNodeId, lanes.data());
+            for (Size l = 0; l < width && first + l < scenarios.size(); ++l)
+                npvs[first + l] = lanes[l];
+        }
+        return npvs;
+    }
 }
 
 BOOST_AUTO_TEST_CASE(testCreditDefaultSwapDerivatives) {
@@ -234,6 +309,67 @@ BOOST_AUTO_TEST_CASE(testCreditDefaultSwapDerivatives) {
     QL_CHECK_CLOSE(derivatives_bumping.fixedRate, derivatives_forge.fixedRate, 1e-3);
     QL_CHECK_CLOSE(derivatives_bumping.recoveryRate, derivatives_forge.recoveryRate, 1e-3);
     QL_CHECK_CLOSE(derivatives_bumping.riskFreeRate, derivatives_forge.riskFreeRate, 1e-3);
+
+    // kernel-versus-QuantLib timing, under --forge_perf
+    forgePerfMeasure("creditdefaultswap", data,
+                     {&CreditDefaultSwapData::fixedRate, &CreditDefaultSwapData::notional,
+                      &CreditDefaultSwapData::recoveryRate, &CreditDefaultSwapData::hazardRate,
+                      &CreditDefaultSwapData::riskFreeRate},
+                     priceCreditDefaultSwap);
+}
+
+
+BOOST_AUTO_TEST_CASE(testCreditDefaultSwapKernelReuse) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing credit default swap kernel re-evaluation across credit scenarios...");
+
+    // the midpoint engine only branches on dates and on the trade's flags,
+    // so one recording prices any hazard rate, recovery and discount rate
+    const auto build = CreditDefaultSwapData{0.0120, 10000.0, 0.4, 0.01234, 0.06};
+    const std::vector<CreditDefaultSwapData> scenarios = {
+        build,
+        {0.0120, 10000.0, 0.4, 0.0001, 0.06},
+        {0.0120, 10000.0, 0.25, 0.0850, 0.01},
+        {0.0120, 10000.0, 0.6, 0.0300, -0.005},
+    };
+
+    const std::vector<double> npvs = kernelScenarioNPVs(priceCreditDefaultSwap, build, scenarios);
+    for (Size k = 0; k < scenarios.size(); ++k) {
+        const double expected = value(priceCreditDefaultSwap(scenarios[k]));
+        BOOST_TEST_MESSAGE("  scenario " << k << ": Forge=" << npvs[k] << " QuantLib=" << expected);
+        QL_CHECK_CLOSE(expected, npvs[k], 1e-9);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testIsdaCreditDefaultSwapKernelReuse) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing ISDA engine kernel re-evaluation across its Taylor threshold...");
+
+    // The engine integrates each node interval exactly, or through a Taylor
+    // expansion when (forward + hazard rate) x length is below 1e-4; with
+    // quantlib-isdacdsengine.cpp.patch the choice is recorded, so a kernel
+    // recorded on either side prices scenarios on both.
+    const std::vector<CreditDefaultSwapData> scenarios = {
+        {0.0120, 10000.0, 0.4, 0.02, 0.03},
+        {0.0120, 10000.0, 0.4, 0.0001, 0.0001},
+        {0.0120, 10000.0, 0.25, 0.085, 0.01},
+        {0.0120, 10000.0, 0.6, 0.00005, -0.00002},
+        {0.0120, 10000.0, 0.4, 0.0003, 0.0001},
+    };
+
+    for (const auto& build : {scenarios[0], scenarios[1]}) {
+        const std::vector<double> npvs =
+            kernelScenarioNPVs(priceIsdaCreditDefaultSwap, build, scenarios);
+        for (Size k = 0; k < scenarios.size(); ++k) {
+            const double expected = value(priceIsdaCreditDefaultSwap(scenarios[k]));
+            BOOST_TEST_MESSAGE("  recorded at hazard rate " << value(build.hazardRate) << ", scenario "
+                                                            << k << ": Forge=" << npvs[k]
+                                                            << " QuantLib=" << expected);
+            QL_CHECK_CLOSE(expected, npvs[k], 1e-9);
+        }
+    }
 }
 
 
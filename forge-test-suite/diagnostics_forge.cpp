@@ -0,0 +1,105 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Graph-drop diagnostics tests.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <expressions/Diagnostics.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(DiagnosticsForgeTests)
+
+#ifdef FEXPR_FORGE_DIAGNOSTICS
+
+namespace {
+
+    // hits so far of the sites reporting AReal::value() during recording
+    std::size_t valueDrops() {
+        std::size_t n = 0;
+        for (const auto& entry : forge::expr::GraphDropRegistry::instance().entries())
+            if (std::strncmp(entry.description, "AReal::value()", 14) == 0)
+                n += entry.count;
+        return n;
+    }
+
+}
+
+#endif
+
+BOOST_AUTO_TEST_CASE(testGraphDropReported) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing the hit count and report of a graph-drop site...");
+
+#ifdef FEXPR_FORGE_DIAGNOSTICS
+    auto& registry = forge::expr::GraphDropRegistry::instance();
+    const std::size_t limit = registry.messageLimit();
+    // the site may have been hit by earlier tests, past the message limit
+    registry.setMessageLimit(std::numeric_limits<std::size_t>::max());
+    std::ostringstream messages;
+    registry.setStream(messages);
+    const std::size_t before = valueDrops(), total = registry.totalDrops();
+
+    // reading passive values, or active ones outside a recording, drops nothing
+    Real passive = 2.0;
+    Real x = 0.5;
+    {
+        forge::GraphRecorder recorder;
+        recorder.start();
+        x.markForgeInputAndDiff();
+        const Real y = x * passive;
+        BOOST_CHECK_EQUAL(passive.value(), 2.0);
+        BOOST_CHECK_EQUAL(valueDrops(), before);
+        // reading an active value while recording drops out of the graph
+        for (Size k = 0; k < 3; ++k)
+            BOOST_CHECK_EQUAL(y.value(), 1.0);
+        recorder.stop();
+        BOOST_CHECK_EQUAL(y.value(), 1.0);
+    }
+    const std::size_t after = valueDrops();
+    const std::string report = messages.str();
+    registry.setStream(std::cerr);
+    registry.setMessageLimit(limit);
+
+    BOOST_CHECK_EQUAL(after - before, 3U);
+    BOOST_CHECK_EQUAL(registry.totalDrops() - total, 3U);
+    BOOST_CHECK(report.find("[Forge][Warning] AReal::value() called while Forge recording") !=
+                std::string::npos);
+    BOOST_CHECK(report.find("Literals.hpp") != std::string::npos);
+
+    std::ostringstream summary;
+    registry.summary(summary);
+    BOOST_TEST_MESSAGE(summary.str());
+    BOOST_CHECK(summary.str().find("[Forge] graph drops: ") == 0);
+    BOOST_CHECK(summary.str().find("AReal::value() called") != std::string::npos);
+#else
+    BOOST_TEST_MESSAGE("  graph-drop diagnostics are not compiled in");
+#endif
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,55 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Graph-drop diagnostics compiled out with FEXPR_FORGE_NO_DIAGNOSTICS.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+// This file sees Diagnostics.hpp with FEXPR_FORGE_NO_DIAGNOSTICS and nothing
+// else of the expression layer: AReal and QuantLib are compiled with the
+// configured diagnostics in the other files, and including them here under a
+// different setting would give their inline functions two definitions.  For
+// the same reason the cases below run without TopLevelFixture.
+#define FEXPR_FORGE_NO_DIAGNOSTICS
+#include <expressions/Diagnostics.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#ifdef FEXPR_FORGE_DIAGNOSTICS
+#error "FEXPR_FORGE_NO_DIAGNOSTICS must turn FEXPR_FORGE_DIAGNOSTICS off"
+#endif
+
+using namespace boost::unit_test_framework;
+
+BOOST_AUTO_TEST_SUITE(QuantLibForgeRisksTests)
+
+BOOST_AUTO_TEST_SUITE(DiagnosticsForgeTests)
+
+BOOST_AUTO_TEST_CASE(testGraphDropCompiledOut) {
+
+    BOOST_TEST_MESSAGE("Testing that FEXPR_FORGE_NO_DIAGNOSTICS compiles graph drops out...");
+
+    // the condition is never evaluated
+    int evaluations = 0;
+    for (int k = 0; k < 3; ++k)
+        FEXPR_FORGE_GRAPH_DROP(++evaluations > 0, "never reported");
+    BOOST_CHECK_EQUAL(evaluations, 0);
+
+    // the macro is still a single statement
+    if (evaluations == 0)
+        FEXPR_FORGE_GRAPH_DROP(++evaluations > 0, "never reported");
+    else
+        BOOST_FAIL("unreachable");
+    BOOST_CHECK_EQUAL(evaluations, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -20,6 +20,7 @@
 
 #include "toplevelfixture.hpp"
 #include "utilities_forge.hpp"
+#include "perf_forge.hpp"
 #include <ql/pricingengines/vanilla/analyticeuropeanengine.hpp>
 #include <ql/quotes/simplequote.hpp>
 #include <ql/termstructures/volatility/equityfx/blackconstantvol.hpp>
@@ -209,6 +210,12 @@ BOOST_AUTO_TEST_CASE(testEuropeanOptionDerivatives) {
     QL_CHECK_CLOSE(derivatives_analytics.u, derivatives_forge.u, 1e-7);
     QL_CHECK_CLOSE(derivatives_analytics.strike, derivatives_forge.strike, 1e-7);
     QL_CHECK_CLOSE(derivatives_analytics.v, derivatives_forge.v, 1e-7);
+
+    // kernel-versus-QuantLib timing, under --forge_perf
+    forgePerfMeasure("europeanoption", data,
+                     {&EuropeanOptionData::strike, &EuropeanOptionData::u, &EuropeanOptionData::r,
+                      &EuropeanOptionData::d, &EuropeanOptionData::v},
+                     [](const EuropeanOptionData& d) { return priceEuropeanOption(d)[0]; });
 }
 
 
@@ -0,0 +1,213 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Streaming exposure reduction tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/exposurereduction.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(ExposureReductionForgeTests)
+
+namespace {
+
+    // linearly interpolated quantile of a sample, the reference for the sketches
+    double sampleQuantile(std::vector<double> values, double p) {
+        std::sort(values.begin(), values.end());
+        double h = p * (values.size() - 1);
+        Size lo = Size(std::floor(h)), hi = std::min(lo + 1, Size(values.size() - 1));
+        return values[lo] + (h - lo) * (values[hi] - values[lo]);
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(testP2QuantileMatchesSortedSample) {
+
+    BOOST_TEST_MESSAGE("Testing P-square quantile sketches against sorted samples...");
+
+    std::mt19937_64 rng(42);
+    std::normal_distribution<double> normal;
+    std::vector<double> draws(50000);
+    for (double& d : draws)
+        d = normal(rng);
+
+    for (double p : {0.5, 0.9, 0.95, 0.99}) {
+        ForgeP2Quantile sketch(p);
+        for (double d : draws)
+            sketch.add(d);
+        BOOST_CHECK_EQUAL(sketch.count(), draws.size());
+        const double exact = sampleQuantile(draws, p);
+        BOOST_CHECK_MESSAGE(std::fabs(sketch.value() - exact) < 0.01,
+                            "quantile " << p << ": sketch " << sketch.value() << ", sample "
+                                        << exact);
+    }
+
+    // fewer than five values are interpolated exactly
+    ForgeP2Quantile small(0.5);
+    for (double d : {3.0, 1.0, 2.0})
+        small.add(d);
+    BOOST_CHECK_EQUAL(small.value(), 2.0);
+
+    BOOST_CHECK_THROW(ForgeP2Quantile(1.0), Error);
+    BOOST_CHECK_THROW(ForgeP2Quantile(0.5).value(), Error);
+}
+
+BOOST_AUTO_TEST_CASE(testReductionOfKernelOutputLanes) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing exposure aggregates read from kernel output lanes...");
+
+    // two "trades" whose values are linear in the single risk factor
+    forge::GraphRecorder recorder;
+    recorder.start();
+    Real x = 0.0;
+    x.markForgeInputAndDiff();
+    Real payer = 100.0 * (x - 0.03);
+    Real receiver = 40.0 * (0.025 - x);
+    payer.markForgeOutput();
+    receiver.markForgeOutput();
+    recorder.stop();
+    forge::ForgeEngine compiler;
+    auto kernel = compiler.compile(recorder.graph());
+    auto buffer = forge::NodeValueBufferFactory::create(recorder.graph(), *kernel);
+
+    const Size dates = 3, paths = 20001;
+    std::mt19937_64 rng(7);
+    std::normal_distribution<double> normal;
+    std::vector<double> rates(dates * paths);
+    for (Size d = 0; d < dates; ++d)
+        for (Size p = 0; p < paths; ++p)
+            rates[d * paths + p] = 0.03 + 0.01 * std::sqrt(d + 1.0) * normal(rng);
+
+    ForgeExposureOptions options;
+    options.pfeQuantiles = {0.95, 0.975};
+    options.storedPaths = paths;
+    ForgeExposureAccumulator exposures(2, dates, options);
+    ForgeExposureOptions sumsOnly;
+    sumsOnly.pfeQuantiles.clear();
+    ForgeExposureAccumulator first(2, dates, sumsOnly), second(2, dates, sumsOnly);
+
+    forgeWithBatchWidth(buffer->getVectorWidth(), [&](auto w) {
+        constexpr Size W = decltype(w)::value;
+        ForgeBatchEvaluator<W> evaluator(*kernel, *buffer, {x.forgeNodeId()},
+                                         {payer.forgeNodeId(), receiver.forgeNodeId()});
+        for (Size d = 0; d < dates; ++d) {
+            for (Size p = 0; p < paths; p += W) {
+                evaluator.load([&](Size lane) { return &rates[d * paths + p + lane]; },
+                               std::min(W, paths - p));
+                evaluator.execute();
+                BOOST_CHECK_EQUAL(evaluator.count(), std::min(W, paths - p));
+                exposures.add(0, d, evaluator, 0);
+                exposures.add(1, d, evaluator, 1);
+                ForgeExposureAccumulator& half = p < paths / 2 ? first : second;
+                half.add(0, d, evaluator, 0);
+                half.add(1, d, evaluator, 1);
+            }
+        }
+    });
+
+    first.merge(second);
+    for (Size trade = 0; trade < 2; ++trade) {
+        for (Size d = 0; d < dates; ++d) {
+            std::vector<double> values(paths), positive(paths);
+            double epe = 0.0, ene = 0.0, mean = 0.0;
+            for (Size p = 0; p < paths; ++p) {
+                double r = rates[d * paths + p];
+                values[p] = trade == 0 ? 100.0 * (r - 0.03) : 40.0 * (0.025 - r);
+                positive[p] = std::max(values[p], 0.0);
+                epe += positive[p] / paths;
+                ene += std::min(values[p], 0.0) / paths;
+                mean += values[p] / paths;
+            }
+            double variance = 0.0;
+            for (double v : values)
+                variance += (v - mean) * (v - mean) / (paths - 1);
+
+            const ForgeExposureStats& s = exposures.stats(trade, d);
+            BOOST_CHECK_EQUAL(s.count, paths);
+            BOOST_CHECK_CLOSE(s.epe(), epe, 1e-9);
+            BOOST_CHECK_CLOSE(s.ene(), ene, 1e-9);
+            BOOST_CHECK_CLOSE(s.variance(), variance, 1e-7);
+            BOOST_CHECK(s.epeError() > 0.0 && s.epeError() < 0.1 * epe);
+            BOOST_CHECK_CLOSE(first.epe(trade, d), epe, 1e-9);
+            BOOST_CHECK_EQUAL(first.stats(trade, d).count, paths);
+            BOOST_CHECK_EQUAL(exposures.value(trade, d, paths - 1), values[paths - 1]);
+
+            // the sketch error is within the Monte Carlo error of the quantile itself
+            for (Size q = 0; q < 2; ++q) {
+                const double exact = sampleQuantile(positive, options.pfeQuantiles[q]);
+                BOOST_CHECK_CLOSE(exposures.pfe(trade, d, q), exact, 2.0);
+            }
+        }
+        BOOST_CHECK_EQUAL(exposures.epeProfile(trade)[dates - 1], exposures.epe(trade, dates - 1));
+    }
+
+    BOOST_CHECK_THROW(exposures.pfe(0, 0, 2), Error);
+    BOOST_CHECK_THROW(exposures.merge(first), Error);
+}
+
+BOOST_AUTO_TEST_CASE(testAggregatesBeyondStoredPaths) {
+
+    BOOST_TEST_MESSAGE("Testing exposure aggregates over more paths than are stored...");
+
+    const Size stored = 10, paths = 1000;
+    ForgeExposureOptions options;
+    options.storedPaths = stored;
+    ForgeExposureOptions sumsOnly;
+    sumsOnly.pfeQuantiles.clear();
+    ForgeExposureAccumulator exposures(1, 2, options), reference(1, 2, sumsOnly);
+
+    std::mt19937_64 rng(11);
+    std::normal_distribution<double> normal;
+    std::vector<double> values(paths);
+    for (Size p = 0; p < paths; ++p) {
+        values[p] = normal(rng);
+        exposures.add(0, 1, values[p]);
+        reference.add(0, 1, values[p]);
+    }
+
+    const ForgeExposureStats &s = exposures.stats(0, 1), &r = reference.stats(0, 1);
+    BOOST_CHECK_EQUAL(s.count, paths);
+    BOOST_CHECK_EQUAL(s.epe(), r.epe());
+    BOOST_CHECK_EQUAL(s.ene(), r.ene());
+    BOOST_CHECK_EQUAL(s.variance(), r.variance());
+    std::vector<double> positive(paths);
+    for (Size p = 0; p < paths; ++p)
+        positive[p] = std::max(values[p], 0.0);
+    BOOST_CHECK_CLOSE(exposures.pfe(0, 1), sampleQuantile(positive, 0.95), 5.0);
+
+    // only the first paths are kept
+    for (Size p = 0; p < stored; ++p)
+        BOOST_CHECK_EQUAL(exposures.value(0, 1, p), values[p]);
+    BOOST_CHECK_THROW(exposures.value(0, 1, stored), Error);
+    BOOST_CHECK_THROW(exposures.value(0, 0, 0), Error);
+    BOOST_CHECK_EQUAL(exposures.stats(0, 0).count, 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
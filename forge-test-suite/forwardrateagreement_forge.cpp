@@ -20,6 +20,7 @@
 
 #include "toplevelfixture.hpp"
 #include "utilities_forge.hpp"
+#include "perf_forge.hpp"
 #include <ql/indexes/ibor/usdlibor.hpp>
 #include <ql/instruments/forwardrateagreement.hpp>
 #include <ql/termstructures/yield/zerocurve.hpp>
@@ -230,6 +231,13 @@ BOOST_AUTO_TEST_CASE(testForwardRateAgreementDerivatives) {
     QL_CHECK_CLOSE(derivatives_bumping.spotRate2, derivatives_forge.spotRate2, 1e-3);
     QL_CHECK_CLOSE(derivatives_bumping.spotRate3, derivatives_forge.spotRate3, 1e-3);
     QL_CHECK_CLOSE(derivatives_bumping.rate, derivatives_forge.rate, 1e-3);
+
+    // kernel-versus-QuantLib timing, under --forge_perf
+    forgePerfMeasure("forwardrateagreement", data,
+                     {&ForwardRateAgreementData::nominal, &ForwardRateAgreementData::spotRate1,
+                      &ForwardRateAgreementData::spotRate2, &ForwardRateAgreementData::spotRate3,
+                      &ForwardRateAgreementData::rate},
+                     priceForwardRateAgreement);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,87 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Frozen-input kernel specialisation tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/batchevaluator.hpp>
+#include <ql/forge/frozenkernel.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(FrozenKernelForgeTests)
+
+BOOST_AUTO_TEST_CASE(testSpecialisationOnFrozenInputs) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing kernels specialised on frozen input values...");
+
+    // y = r * exp(v * s) + v^2: r moves, the "vol" v and "spread" s are frozen
+    forge::GraphRecorder recorder;
+    recorder.start();
+    Real r = 0.03, v = 0.2, s = 0.01;
+    r.markForgeInputAndDiff();
+    v.markForgeInputAndDiff();
+    s.markForgeInputAndDiff();
+    Real y = r * exp(v * s) + v * v;
+    y.markForgeOutput();
+    recorder.stop();
+    const std::vector<forge::NodeId> inputs = {r.forgeNodeId(), v.forgeNodeId(),
+                                               s.forgeNodeId()};
+    const std::vector<forge::NodeId> frozen = {v.forgeNodeId(), s.forgeNodeId()};
+
+    ForgeFrozenKernelCache kernels(recorder.graph());
+    const std::vector<forge::NodeId> free = ForgeFrozenKernelCache::freeInputs(inputs, frozen);
+    BOOST_REQUIRE_EQUAL(free.size(), 1U);
+    BOOST_CHECK_EQUAL(free[0], r.forgeNodeId());
+
+    const forge::Graph specialised = forgeFreezeInputs(recorder.graph(), frozen, {0.25, 0.02});
+    BOOST_CHECK(forgeActiveNodeCount(specialised) < forgeActiveNodeCount(recorder.graph()));
+    BOOST_CHECK_EQUAL(specialised.diff_inputs.size(), 1U);
+    BOOST_CHECK_THROW(forgeFreezeInputs(recorder.graph(), {y.forgeNodeId()}, {1.0}), Error);
+    BOOST_CHECK_THROW(forgeFreezeInputs(recorder.graph(), frozen, {1.0}), Error);
+
+    auto entry = kernels.specialise(frozen, {0.25, 0.02});
+    BOOST_CHECK(!entry.hit);
+    BOOST_CHECK(kernels.specialise(frozen, {0.25, 0.02}).hit);
+    BOOST_CHECK(!kernels.specialise(frozen, {0.3, 0.02}).hit);
+    BOOST_CHECK_EQUAL(kernels.size(), 2U);
+
+    const double rates[3] = {0.01, 0.03, 0.05};
+    forgeWithBatchWidth(entry.buffer->getVectorWidth(), [&](auto w) {
+        constexpr Size W = decltype(w)::value;
+        ForgeBatchEvaluator<W> evaluator(*entry.kernel, *entry.buffer, free, {y.forgeNodeId()},
+                                         free);
+        double values[3], gradients[3];
+        evaluator.evaluate(rates, 3, 1, values, gradients);
+        for (Size i = 0; i < 3; ++i) {
+            BOOST_CHECK_CLOSE(values[i], rates[i] * std::exp(0.005) + 0.0625, 1e-12);
+            BOOST_CHECK_CLOSE(gradients[i], std::exp(0.005), 1e-12);
+        }
+    });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,211 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Fused multiply-add recording tests.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(FusionForgeTests)
+
+namespace {
+
+    // the recordings below run in whatever configuration the suite is built
+    // with; CI builds it once more with FEXPR_FORGE_NO_FUSION, and in both the
+    // fused AReal recording must match an fdouble recording of plain nodes
+
+    struct Recorded {
+        forge::Graph graph;
+        std::vector<forge::NodeId> inputs;
+        forge::NodeId output;
+    };
+
+    template <class F>
+    Recorded recordReal(const F& f, Size n) {
+        forge::GraphRecorder recorder;
+        recorder.start();
+        Recorded rec;
+        std::vector<Real> x(n, 1.0);
+        for (Real& xi : x) {
+            xi.markForgeInputAndDiff();
+            rec.inputs.push_back(xi.forgeNodeId());
+        }
+        Real y = f(x);
+        y.markForgeOutput();
+        rec.output = y.forgeNodeId();
+        recorder.stop();
+        rec.graph = recorder.graph();
+        return rec;
+    }
+
+    // the same function on fdouble, whose operators never fuse
+    template <class F>
+    Recorded recordUnfused(const F& f, Size n) {
+        forge::GraphRecorder recorder;
+        recorder.start();
+        Recorded rec;
+        std::vector<forge::fdouble> x(n, forge::fdouble(1.0));
+        for (forge::fdouble& xi : x) {
+            xi.markInputAndDiff();
+            rec.inputs.push_back(xi.node());
+        }
+        forge::fdouble y = f(x);
+        y.markOutput();
+        rec.output = y.node();
+        recorder.stop();
+        rec.graph = recorder.graph();
+        return rec;
+    }
+
+    // value and gradient of the kernel of a recording at one point
+    double evaluate(const Recorded& rec, const std::vector<double>& x, std::vector<double>& gradient) {
+        forge::ForgeEngine compiler;
+        auto kernel = compiler.compile(rec.graph);
+        auto buffer = forge::NodeValueBufferFactory::create(rec.graph, *kernel);
+        const Size width = buffer->getVectorWidth();
+        std::vector<double> lanes(width);
+        for (Size i = 0; i < x.size(); ++i) {
+            std::fill(lanes.begin(), lanes.end(), x[i]);
+            buffer->setLanes(rec.inputs[i], lanes.data());
+        }
+        buffer->clearGradients();
+        kernel->execute(*buffer);
+        buffer->getLanes(rec.output, lanes.data());
+        const double value = lanes[0];
+        std::vector<std::size_t> indices;
+        for (auto id : rec.inputs)
+            indices.push_back(buffer->getBufferIndex(id));
+        std::vector<double> gradients(indices.size() * width);
+        buffer->getGradientLanes(indices, gradients.data());
+        gradient.resize(x.size());
+        for (Size i = 0; i < x.size(); ++i)
+            gradient[i] = gradients[i * width];
+        return value;
+    }
+
+    // f on vectors of Real, fdouble and double; df the gradient on doubles
+    template <class F, class DF>
+    void checkShape(const char* name, const F& f, const DF& df, bool fused) {
+        BOOST_TEST_MESSAGE("  " << name);
+        const Recorded real = recordReal(f, 3), unfused = recordUnfused(f, 3);
+        if (fused)
+            BOOST_CHECK(real.graph.nodes.size() < unfused.graph.nodes.size());
+        else
+            BOOST_CHECK_EQUAL(real.graph.nodes.size(), unfused.graph.nodes.size());
+
+        for (const std::vector<double>& x : {std::vector<double>{0.5, -1.25, 2.0},
+                                             std::vector<double>{-3.0, 0.75, -0.125}}) {
+            std::vector<double> gradient, reference;
+            const double fused = evaluate(real, x, gradient);
+            const double plain = evaluate(unfused, x, reference);
+            const std::vector<double> expected = df(x);
+            QL_CHECK_CLOSE(Real(fused), Real(f(x)), 1e-12);
+            QL_CHECK_CLOSE(Real(fused), Real(plain), 1e-12);
+            for (Size i = 0; i < x.size(); ++i) {
+                BOOST_CHECK_SMALL(gradient[i] - expected[i], 1e-12);
+                BOOST_CHECK_SMALL(gradient[i] - reference[i], 1e-12);
+            }
+        }
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(testMultiplyAddShapes) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing values and adjoints of recorded multiply-add shapes...");
+
+    const bool fma = forge::expr::detail::forgeHasFma;
+    const bool fnma = forge::expr::detail::forgeHasFnma;
+    BOOST_TEST_MESSAGE("  fused multiply-add " << fma << ", negated " << fnma);
+
+    checkShape("a * b + c", [](const auto& x) { return x[0] * x[1] + x[2]; },
+               [](const std::vector<double>& x) { return std::vector<double>{x[1], x[0], 1.0}; },
+               fma);
+    checkShape("c + a * b", [](const auto& x) { return x[2] + x[0] * x[1]; },
+               [](const std::vector<double>& x) { return std::vector<double>{x[1], x[0], 1.0}; },
+               fma);
+    checkShape("c - a * b", [](const auto& x) { return x[2] - x[0] * x[1]; },
+               [](const std::vector<double>& x) { return std::vector<double>{-x[1], -x[0], 1.0}; },
+               fnma);
+    // a product on both sides fuses the left one, on operands that are expressions themselves
+    checkShape("(a + c) * b + c * a", [](const auto& x) { return (x[0] + x[2]) * x[1] + x[2] * x[0]; },
+               [](const std::vector<double>& x) {
+                   return std::vector<double>{x[1] + x[2], x[0] + x[2], x[1] + x[0]};
+               },
+               fma);
+}
+
+BOOST_AUTO_TEST_CASE(testHornerRecording) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing values and adjoints of a recorded horner()...");
+
+    const double c[] = {1.0, -0.5, 0.25, 2.0, -0.125};
+    const auto polynomial = [&](const Recorded& rec, double x, double& derivative) {
+        std::vector<double> gradient;
+        const double result = evaluate(rec, {x}, gradient);
+        derivative = gradient[0];
+        return result;
+    };
+    const Recorded real = recordReal([&](const std::vector<Real>& x) {
+        return forge::expr::horner(x[0], {c[0], c[1], c[2], c[3], c[4]});
+    }, 1);
+    const Recorded unfused = recordUnfused([&](const std::vector<forge::fdouble>& x) {
+        forge::fdouble f(c[4]);
+        for (Size k = 4; k-- > 0;)
+            f = f * x[0] + forge::fdouble(c[k]);
+        return f;
+    }, 1);
+    if (forge::expr::detail::forgeHasFma)
+        BOOST_CHECK(real.graph.nodes.size() < unfused.graph.nodes.size());
+    else
+        BOOST_CHECK_EQUAL(real.graph.nodes.size(), unfused.graph.nodes.size());
+
+    for (double x : {-1.5, 0.0, 0.75, 2.25}) {
+        double expected = 0.0, slope = 0.0;
+        for (Size k = 5; k-- > 0;) {
+            slope = slope * x + expected;
+            expected = expected * x + c[k];
+        }
+        double derivative, reference;
+        const double fused = polynomial(real, x, derivative);
+        const double plain = polynomial(unfused, x, reference);
+        BOOST_CHECK_SMALL(fused - expected, 1e-12);
+        BOOST_CHECK_SMALL(fused - plain, 1e-12);
+        BOOST_CHECK_SMALL(derivative - slope, 1e-12);
+        BOOST_CHECK_SMALL(derivative - reference, 1e-12);
+    }
+
+    // the passive value computed alongside agrees
+    BOOST_CHECK_SMALL(forge::expr::horner(0.75, {c[0], c[1], c[2], c[3], c[4]}) -
+                          forge::expr::horner(Real(0.75), {c[0], c[1], c[2], c[3], c[4]}).value(),
+                      1e-15);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
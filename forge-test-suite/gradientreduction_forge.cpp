@@ -0,0 +1,161 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Deterministic gradient reduction tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/gradientreduction.hpp>
+#include <ql/forge/kernelcache.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(GradientReductionForgeTests)
+
+namespace {
+
+    const Size numFactors = 3;
+
+    // a factor of very different magnitudes across scenarios, so that the
+    // rounding of the sums depends on their order
+    double factorOf(Size p, Size i) {
+        return 0.01 * (i + 1) + (p % 7 == 0 ? 5.0 : 1e-3) * std::sin(0.37 * p + i);
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(testReproducibleAcrossThreadCounts) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing bit-identical gradient sums for any thread count and chunk size...");
+
+    // npv = x0 x1 + exp(-x2) x0, with the three factors differentiated
+    forge::GraphRecorder recorder;
+    recorder.start();
+    std::vector<Real> x(numFactors, 0.02);
+    std::vector<forge::NodeId> inputs;
+    for (Real& xi : x) {
+        xi.markForgeInputAndDiff();
+        inputs.push_back(xi.forgeNodeId());
+    }
+    Real npv = x[0] * x[1] + exp(-x[2]) * x[0];
+    npv.markForgeOutput();
+    recorder.stop();
+
+    forge::CompilerConfig config;
+    config.instructionSet = forge::CompilerConfig::InstructionSet::AVX2_PACKED;
+    ForgeKernelCache cache(config);
+    auto entry = cache.acquire(recorder.graph());
+
+    const Size numScenarios = 5003;
+    std::vector<double> scenarios(numScenarios * numFactors);
+    long double exactValue = 0.0L, exactGradient[numFactors] = {0.0L, 0.0L, 0.0L};
+    for (Size p = 0; p < numScenarios; ++p) {
+        const double* s = &scenarios[p * numFactors];
+        for (Size i = 0; i < numFactors; ++i)
+            scenarios[p * numFactors + i] = factorOf(p, i);
+        exactValue += s[0] * s[1] + std::exp(-s[2]) * s[0];
+        exactGradient[0] += s[1] + std::exp(-s[2]);
+        exactGradient[1] += s[0];
+        exactGradient[2] += -std::exp(-s[2]) * s[0];
+    }
+
+    for (auto summation : {ForgeSummation::Plain, ForgeSummation::Compensated}) {
+        ForgeGradientSums reference;
+        bool first = true;
+        for (Size threads : {1, 2, 3, 8}) {
+            for (Size chunk : {0, 1, 5}) {
+                ForgeParallelScenarioEvaluator::Options options;
+                options.numThreads = threads;
+                options.chunkSize = chunk;
+                ForgeParallelScenarioEvaluator evaluator(entry, recorder.graph(), options);
+                ForgeGradientSums sums = forgeParallelGradientSums(
+                    evaluator, inputs, {npv.forgeNodeId()}, inputs, scenarios.data(),
+                    numScenarios, numFactors, 64, summation);
+                BOOST_CHECK_EQUAL(sums.scenarios, numScenarios);
+                BOOST_REQUIRE_EQUAL(sums.gradients.size(), numFactors);
+                if (first) {
+                    reference = sums;
+                    first = false;
+                    continue;
+                }
+                // bit for bit, not within a tolerance
+                BOOST_CHECK(sums.values[0] == reference.values[0]);
+                for (Size i = 0; i < numFactors; ++i)
+                    BOOST_CHECK(sums.gradients[i] == reference.gradients[i]);
+            }
+        }
+        BOOST_CHECK_CLOSE(reference.values[0], double(exactValue), 1e-10);
+        for (Size i = 0; i < numFactors; ++i)
+            BOOST_CHECK_CLOSE(reference.gradients[i], double(exactGradient[i]), 1e-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testBlockOrderAndCompensation) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing block-order independence and compensated summation...");
+
+    // 1 followed by many terms below its rounding unit: the plain sums lose them
+    const Size numScenarios = 10000, blockSize = 100;
+    const double tiny = 1e-17;
+    auto fill = [&](ForgeGradientReduction& reduction, bool reversed) {
+        for (Size k = 0; k < reduction.numBlocks(); ++k) {
+            const Size b = reversed ? reduction.numBlocks() - 1 - k : k;
+            for (Size p = reduction.blockBegin(b); p < reduction.blockEnd(b); ++p) {
+                const double values[2] = {p % blockSize == 0 ? 1.0 : tiny, double(p)};
+                reduction.add(b, values);
+            }
+        }
+    };
+
+    ForgeGradientReduction plain(2, numScenarios, blockSize);
+    ForgeGradientReduction compensated(2, numScenarios, blockSize, ForgeSummation::Compensated);
+    ForgeGradientReduction reversed(2, numScenarios, blockSize, ForgeSummation::Compensated);
+    BOOST_CHECK_EQUAL(plain.numBlocks(), numScenarios / blockSize);
+    BOOST_CHECK_EQUAL(plain.blockOf(blockSize + 1), 1U);
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(plain.blockSums(1)) %
+                          ForgeGradientReduction::alignment,
+                      0U);
+    fill(plain, false);
+    fill(compensated, false);
+    fill(reversed, true);
+
+    const double blocks = double(numScenarios / blockSize);
+    const double expected = blocks + (numScenarios - blocks) * tiny;
+    const std::vector<double> p = plain.sums(), c = compensated.sums(), r = reversed.sums();
+    BOOST_CHECK_EQUAL(p[0], blocks);
+    BOOST_CHECK_CLOSE(c[0], expected, 1e-10);
+    BOOST_CHECK(c[0] == r[0] && c[1] == r[1]);
+    BOOST_CHECK_EQUAL(p[1], double(numScenarios) * (numScenarios - 1) / 2.0);
+
+    compensated.reset();
+    BOOST_CHECK_EQUAL(compensated.sums()[0], 0.0);
+    BOOST_CHECK_THROW(compensated.add(compensated.numBlocks(), &expected), Error);
+    BOOST_CHECK_THROW(ForgeGradientReduction(2, numScenarios, 0), Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,144 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Guarded kernel set tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/guardedkernels.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <expressions/BranchGuards.hpp>
+
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(GuardedKernelsForgeTests)
+
+namespace {
+
+    // exposure-style payoff with native C++ branches, i.e. not using ABool::If
+    std::vector<Real> priceBranchy(const std::vector<Real>& x) {
+        Date today = Settings::instance().evaluationDate();
+        auto curve = ext::make_shared<FlatForward>(today, x[0], Actual365Fixed());
+        Real npv = 1000.0 * (curve->discount(today + 5 * Years) - x[1]);
+        Real exposure;
+        if (npv > 0.0)
+            exposure = npv;
+        else
+            exposure = 0.1 * npv;
+        return {exposure};
+    }
+
+    // plain valuation, not recorded
+    double expectedExposure(double rate, double strike) {
+        return value(priceBranchy({rate, strike})[0]);
+    }
+
+    double rateOf(Size p) { return 0.01 + 0.002 * p; }
+    // alternates the sign of the NPV across scenarios
+    double strikeOf(Size p) { return p % 3 == 0 ? 1.0 : 0.8; }
+
+    std::vector<double> scenarioMatrix(Size n) {
+        std::vector<double> scenarios(n * 2);
+        for (Size p = 0; p < n; ++p) {
+            scenarios[p * 2] = rateOf(p);
+            scenarios[p * 2 + 1] = strikeOf(p);
+        }
+        return scenarios;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(testBranchGuardsRecorded) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing that native branches on ABool are recorded as guards...");
+
+    forge::GraphRecorder recorder;
+    forge::BranchGuards guards;
+    recorder.start();
+    Real x = 2.0;
+    x.markForgeInputAndDiff();
+    Real y = x > 1.0 ? x * 2.0 : x * 3.0;
+    bool small = x < 0.5;
+    y.markForgeOutput();
+    auto guardIds = guards.markOutputs();
+    recorder.stop();
+
+    BOOST_CHECK(!small);
+    BOOST_CHECK_EQUAL(guards.size(), 2U);
+    BOOST_CHECK_EQUAL(guardIds.size(), 2U);
+    BOOST_CHECK_EQUAL(int(guards.signature()[0]), 1);
+    BOOST_CHECK_EQUAL(int(guards.signature()[1]), 0);
+}
+
+BOOST_AUTO_TEST_CASE(testGuardedKernelsRerecordOnDivergence) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing guarded kernels re-recording diverging lanes...");
+
+    forge::CompilerConfig config;
+    config.instructionSet = forge::CompilerConfig::InstructionSet::AVX2_PACKED;
+    ForgeGuardedKernelSet<4> set(config, {rateOf(1), strikeOf(1)}, priceBranchy);
+    BOOST_CHECK_EQUAL(set.variants(), 1U);
+    BOOST_CHECK_EQUAL(set.signature(0).size(), 1U);
+
+    const Size n = 10;
+    auto scenarios = scenarioMatrix(n);
+    std::vector<double> npvs(n), gradients(n * 2);
+    for (Size pass = 0; pass < 2; ++pass) {
+        set.evaluate(scenarios.data(), n, 2, npvs.data(), gradients.data());
+        for (Size p = 0; p < n; ++p) {
+            double expected = expectedExposure(rateOf(p), strikeOf(p));
+            double dStrike = expected > 0.0 ? -1000.0 : -100.0;
+            QL_CHECK_CLOSE(Real(npvs[p]), Real(expected), 1e-10);
+            QL_CHECK_CLOSE(Real(gradients[p * 2 + 1]), Real(dStrike), 1e-10);
+        }
+        // one kernel per branch; the second pass re-records nothing
+        BOOST_CHECK_EQUAL(set.variants(), 2U);
+        BOOST_CHECK_EQUAL(set.recordings(), 2U);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testGuardedKernelsVariantLimit) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing guarded kernels beyond the variant limit...");
+
+    ForgeGuardedKernelOptions options;
+    options.maxVariants = 1;
+    options.differentiate = false;
+    ForgeGuardedKernelSet<1> set(forge::CompilerConfig(), {rateOf(1), strikeOf(1)},
+                                 priceBranchy, options);
+
+    const Size n = 6;
+    auto scenarios = scenarioMatrix(n);
+    std::vector<double> npvs(n);
+    set.evaluate(scenarios.data(), n, 2, npvs.data());
+    for (Size p = 0; p < n; ++p)
+        QL_CHECK_CLOSE(Real(npvs[p]), Real(expectedExposure(rateOf(p), strikeOf(p))), 1e-10);
+    BOOST_CHECK_EQUAL(set.variants(), 1U);
+    BOOST_CHECK_EQUAL(set.oneOffRecordings(), 2U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
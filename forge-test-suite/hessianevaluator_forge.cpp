@@ -0,0 +1,101 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Second-order sensitivity tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/hessianevaluator.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(HessianEvaluatorForgeTests)
+
+BOOST_AUTO_TEST_CASE(testHessianFromGradientLanes) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing Hessian blocks from bumped adjoint lanes...");
+
+    BOOST_CHECK_THROW(forgeUnitDirections(2, {2}), Error);
+
+    // y = s^2 v + exp(v) s, a spot/vol toy with gamma 2v, vanna 2s + exp(v), volga s exp(v)
+    forge::GraphRecorder recorder;
+    recorder.start();
+    Real s = 1.0, v = 0.2;
+    s.markForgeInputAndDiff();
+    v.markForgeInputAndDiff();
+    Real y = s * s * v + exp(v) * s;
+    y.markForgeOutput();
+    recorder.stop();
+    forge::ForgeEngine compiler;
+    auto kernel = compiler.compile(recorder.graph());
+    auto buffer = forge::NodeValueBufferFactory::create(recorder.graph(), *kernel);
+    const std::vector<forge::NodeId> inputs = {s.forgeNodeId(), v.forgeNodeId()};
+
+    const double x[2] = {1.3, 0.25};
+    const double e = std::exp(x[1]);
+    const double delta = 2.0 * x[0] * x[1] + e, vega = x[0] * x[0] + e * x[0];
+    const double gamma = 2.0 * x[1], vanna = 2.0 * x[0] + e, volga = x[0] * e;
+
+    forgeWithBatchWidth(buffer->getVectorWidth(), [&](auto w) {
+        constexpr Size W = decltype(w)::value;
+
+        // spot only: delta, vega, gamma and vanna from three lanes
+        ForgeHessianEvaluator<W> spot(*kernel, *buffer, inputs, y.forgeNodeId(), inputs,
+                                      forgeUnitDirections(2, {0}), 1e-4);
+        BOOST_CHECK_EQUAL(spot.lanes(), 3U);
+        BOOST_CHECK_EQUAL(spot.executions(), (3 + W - 1) / W);
+        double value, gradient[2], hessian[4];
+        spot.evaluate(x, 1, &value, gradient, hessian);
+        BOOST_CHECK_CLOSE(value, x[0] * x[0] * x[1] + e * x[0], 1e-12);
+        BOOST_CHECK_CLOSE(gradient[0], delta, 1e-12);
+        BOOST_CHECK_CLOSE(gradient[1], vega, 1e-12);
+        BOOST_CHECK_CLOSE(hessian[0], gamma, 1e-6);
+        BOOST_CHECK_CLOSE(hessian[1], vanna, 1e-6);
+
+        // the full block, and a Hessian-vector product with forward differences
+        ForgeHessianEvaluator<W> full(*kernel, *buffer, inputs, y.forgeNodeId(), inputs,
+                                      forgeUnitDirections(2), 1e-4);
+        full.evaluate(x, 1, nullptr, nullptr, hessian);
+        BOOST_CHECK_CLOSE(hessian[0], gamma, 1e-6);
+        BOOST_CHECK_CLOSE(hessian[1], vanna, 1e-6);
+        BOOST_CHECK_CLOSE(hessian[2], vanna, 1e-6);
+        BOOST_CHECK_CLOSE(hessian[3], volga, 1e-6);
+
+        ForgeHessianEvaluator<W> product(*kernel, *buffer, inputs, y.forgeNodeId(), inputs,
+                                         {{1.0, -2.0}}, 1e-7,
+                                         ForgeDifferenceScheme::Forward);
+        BOOST_CHECK_EQUAL(product.lanes(), 2U);
+        product.evaluate(x, 1, nullptr, nullptr, hessian);
+        BOOST_CHECK_SMALL(hessian[0] - (gamma - 2.0 * vanna), 1e-5);
+        BOOST_CHECK_SMALL(hessian[1] - (vanna - 2.0 * volga), 1e-5);
+
+        BOOST_CHECK_THROW(ForgeHessianEvaluator<W>(*kernel, *buffer, inputs, y.forgeNodeId(),
+                                                   inputs, {{1.0}}, 1e-4),
+                          Error);
+    });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
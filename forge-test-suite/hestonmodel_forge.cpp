@@ -18,6 +18,7 @@
 
 #include "toplevelfixture.hpp"
 #include "utilities_forge.hpp"
+#include "perf_forge.hpp"
 #include <ql/math/optimization/levenbergmarquardt.hpp>
 #include <ql/models/equity/hestonmodel.hpp>
 #include <ql/models/equity/hestonmodelhelper.hpp>
@@ -34,6 +35,7 @@
 #include <ql/time/calendars/target.hpp>
 #include <ql/time/daycounters/actual360.hpp>
 #include <ql/time/daycounters/actualactual.hpp>
+#include <ql/forge/tapeaad.hpp>
 
 // Forge integration headers
 #include <graph/graph_recorder.hpp>
@@ -41,6 +43,7 @@
 #include <compiler/node_value_buffers/node_value_buffer.hpp>
 
 #include <chrono>
+#include <complex>
 #include <iomanip>
 #include <iostream>
 #include <vector>
@@ -140,6 +143,34 @@ namespace {
 
 }
 
+namespace {
+
+    // Heston characteristic function of the log spot (little Heston trap form)
+    template <class R>
+    std::complex<R> hestonCharacteristicFunction(const std::vector<R>& p) {
+        typedef std::complex<R> C;
+        const R &phi = p[0], &kappa = p[1], &theta = p[2], &sigma = p[3], &rho = p[4],
+                &v0 = p[5], &t = p[6];
+        const C i(R(0.0), R(1.0)), one(R(1.0));
+        C a = C(kappa) - C(rho * sigma * phi) * i;
+        C d = std::sqrt(a * a + C(sigma * sigma) * C(phi * phi, phi));
+        C g = (a - d) / (a + d);
+        C e = std::exp(C(-t) * d);
+        C mean = C(kappa * theta / (sigma * sigma)) *
+                 ((a - d) * C(t) - C(R(2.0)) * std::log((one - g * e) / (one - g)));
+        C variance = C(v0 / (sigma * sigma)) * (a - d) * (one - e) / (one - g * e);
+        return std::exp(mean + variance);
+    }
+
+    // phi, kappa, theta, sigma, rho, v0, t
+    const std::vector<std::vector<double>> characteristicFunctionParameters = {
+        {3.0, 1.5, 0.04, 0.5, -0.7, 0.05, 2.0},
+        {40.0, 2.0, 0.09, 0.3, -0.3, 0.02, 5.0},
+        {0.2, 0.8, 0.06, 0.9, 0.2, 0.1, 0.5},
+        {250.0, 3.0, 0.05, 0.4, -0.9, 0.04, 1.0}};
+
+}
+
 ext::shared_ptr<QuantLib::HestonModel> HestonModelCalibration(const ModelData& value) {
     CalibrationMarketData marketData = getDAXCalibrationMarketData(value);
 
@@ -199,6 +230,117 @@ void printResults(Real v, const std::vector<Real>& derivatives) {
         std::cout << "derivatives " << i << " = " << derivatives[i] << "\n";
 }
 
+BOOST_AUTO_TEST_CASE(testCharacteristicFunctionKernel) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing a recorded Heston characteristic function across parameters...");
+
+    const std::vector<std::vector<double>>& parameters = characteristicFunctionParameters;
+    const Size n = parameters.front().size();
+
+    forge::GraphRecorder recorder;
+    recorder.start();
+    std::vector<Real> inputs(parameters.front().begin(), parameters.front().end());
+    std::vector<forge::NodeId> inputIds;
+    for (auto& x : inputs) {
+        x.markForgeInputAndDiff();
+        inputIds.push_back(x.forgeNodeId());
+    }
+    std::complex<Real> phi = hestonCharacteristicFunction(inputs);
+    Real re = phi.real(), im = phi.imag();
+    // the reverse pass is seeded from the real part
+    re.markForgeOutput();
+    im.markForgeOutput();
+    recorder.stop();
+    forge::Graph graph = recorder.graph();
+
+    forge::ForgeEngine compiler;
+    auto kernel = compiler.compile(graph);
+    auto buffer = forge::NodeValueBufferFactory::create(graph, *kernel);
+    const Size width = buffer->getVectorWidth();
+    std::vector<size_t> gradientIndices;
+    for (auto id : inputIds)
+        gradientIndices.push_back(buffer->getBufferIndex(id));
+
+    std::vector<double> lanes(width), realPart(width), imagPart(width), gradients(width * n);
+    for (const auto& p : parameters) {
+        for (Size j = 0; j < n; ++j) {
+            std::fill(lanes.begin(), lanes.end(), p[j]);
+            buffer->setLanes(inputIds[j], lanes.data());
+        }
+        buffer->clearGradients();
+        kernel->execute(*buffer);
+        buffer->getLanes(re.forgeNodeId(), realPart.data());
+        buffer->getLanes(im.forgeNodeId(), imagPart.data());
+        buffer->getGradientLanes(gradientIndices, gradients.data());
+
+        std::complex<double> expected = hestonCharacteristicFunction(p);
+        const double scale = std::max(std::abs(expected), 1e-300);
+        BOOST_CHECK_MESSAGE(std::abs(std::complex<double>(realPart[0], imagPart[0]) - expected) <=
+                                1e-12 * scale,
+                            "kernel value (" << realPart[0] << ", " << imagPart[0]
+                                             << "), expected " << expected);
+
+        for (Size j = 0; j < n; ++j) {
+            std::vector<double> up = p, down = p;
+            const double h = 1e-6 * std::max(1.0, std::fabs(p[j]));
+            up[j] += h;
+            down[j] -= h;
+            const double bumped = (hestonCharacteristicFunction(up).real() -
+                                   hestonCharacteristicFunction(down).real()) /
+                                  (2.0 * h);
+            BOOST_CHECK_MESSAGE(std::fabs(gradients[j * width] - bumped) <=
+                                    1e-5 * std::max(std::fabs(bumped), scale),
+                                "derivative " << j << ": " << gradients[j * width] << ", bumped "
+                                              << bumped);
+        }
+    }
+
+    // kernel-versus-QuantLib timing, under --forge_perf
+    forgePerfMeasure("hestoncharacteristicfunction", parameters.front(),
+                     [](const std::vector<Real>& x) {
+                         return hestonCharacteristicFunction(x).real();
+                     });
+}
+
+BOOST_AUTO_TEST_CASE(testCharacteristicFunctionTapeMatchesKernel) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing taped Heston characteristic function gradients against the kernel...");
+
+    const std::vector<std::vector<double>>& parameters = characteristicFunctionParameters;
+    const Size n = parameters.front().size(), count = parameters.size();
+    std::vector<double> scenarios;
+    for (const auto& p : parameters)
+        scenarios.insert(scenarios.end(), p.begin(), p.end());
+    const ForgeActiveFunction price = [n](const Real* x) {
+        return hestonCharacteristicFunction(std::vector<Real>(x, x + n)).real();
+    };
+
+    ForgeAadSelectorOptions options;
+    options.breakEvenScenarios = count + 1;
+    std::vector<double> tapeValues(count), tapeGradients(n * count);
+    BOOST_CHECK(forgeEvaluateAad(n, price, scenarios.data(), count, n, tapeValues.data(),
+                                 tapeGradients.data(), options) ==
+                (forgeTapeAvailable ? ForgeAadBackend::Tape : ForgeAadBackend::Kernel));
+    options.breakEvenScenarios = 0;
+    std::vector<double> kernelValues(count), kernelGradients(n * count);
+    BOOST_CHECK(forgeEvaluateAad(n, price, scenarios.data(), count, n, kernelValues.data(),
+                                 kernelGradients.data(), options) == ForgeAadBackend::Kernel);
+
+    for (Size p = 0; p < count; ++p) {
+        const double scale = std::max(std::abs(hestonCharacteristicFunction(parameters[p])), 1e-300);
+        BOOST_CHECK_MESSAGE(std::fabs(tapeValues[p] - kernelValues[p]) <= 1e-12 * scale,
+                            "tape value " << tapeValues[p] << ", kernel " << kernelValues[p]);
+        for (Size j = 0; j < n; ++j) {
+            const double tape = tapeGradients[p * n + j], kernel = kernelGradients[p * n + j];
+            BOOST_CHECK_MESSAGE(std::fabs(tape - kernel) <= 1e-9 * std::max(std::fabs(kernel), scale),
+                                "derivative " << j << " of parameter set " << p << ": tape " << tape
+                                              << ", kernel " << kernel);
+        }
+    }
+}
+
 // TODO: Re-enable when Forge supports sin, cos, atan2, hypot, scalar_max operations
 // Currently fails with: "negative value for stdDev" due to incomplete Forge support
 // for the complex number arithmetic in Heston model calibration
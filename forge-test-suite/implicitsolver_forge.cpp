@@ -0,0 +1,190 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Implicit-function root finding tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/math/solvers1d/brent.hpp>
+#include <ql/forge/batchevaluator.hpp>
+#include <ql/forge/implicitsolver.hpp>
+#include <ql/forge/kernelcache.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(ImplicitSolverForgeTests)
+
+namespace {
+
+    const Size bondYears = 5;
+
+    // price of a bond paying coupon p[1] annually and 1 at maturity, less the
+    // quoted price p[0], in a continuously compounded yield
+    struct BondResidual {
+        Real operator()(const Real& y, const std::vector<Real>& p) const {
+            Real annuity = 0.0;
+            for (Size t = 1; t <= bondYears; ++t)
+                annuity += exp(-y * double(t));
+            return p[1] * annuity + exp(-y * double(bondYears)) - p[0];
+        }
+        Real derivative(const Real& y, const std::vector<Real>& p) const {
+            Real duration = 0.0;
+            for (Size t = 1; t <= bondYears; ++t)
+                duration += double(t) * exp(-y * double(t));
+            return -p[1] * duration - double(bondYears) * exp(-y * double(bondYears));
+        }
+    };
+
+    // the same residual and the yield in plain doubles, by Newton iteration
+    double annuityOf(double y) {
+        double a = 0.0;
+        for (Size t = 1; t <= bondYears; ++t)
+            a += std::exp(-y * double(t));
+        return a;
+    }
+
+    double slopeOf(double y, double coupon) {
+        double d = 0.0;
+        for (Size t = 1; t <= bondYears; ++t)
+            d += double(t) * std::exp(-y * double(t));
+        return -coupon * d - double(bondYears) * std::exp(-y * double(bondYears));
+    }
+
+    double yieldOf(double price, double coupon) {
+        double y = 0.05;
+        for (Size k = 0; k < 50; ++k)
+            y -= (coupon * annuityOf(y) + std::exp(-y * double(bondYears)) - price) /
+                 slopeOf(y, coupon);
+        return y;
+    }
+
+    // zero rates of a 1y deposit and a 2y annual swap, bootstrapped in closed form
+    double depositZero(double q1) { return std::log(1.0 + q1); }
+    double swapZero(double q1, double q2) {
+        return -0.5 * std::log((1.0 - q2 * std::exp(-depositZero(q1))) / (1.0 + q2));
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(testBondYieldAcrossScenarios) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing recorded bond yields and their implicit adjoints on other inputs...");
+
+    forge::GraphRecorder recorder;
+    recorder.start();
+    Real price = 0.98, coupon = 0.03;
+    price.markForgeInputAndDiff();
+    coupon.markForgeInputAndDiff();
+    ForgeImplicitSolver1D<Brent> solver(3);
+    Real y = solver.solve(BondResidual(), {price, coupon}, 1e-12, 0.05, 0.0, 1.0);
+    y.markForgeOutput();
+    recorder.stop();
+    BOOST_CHECK_SMALL(y.getValue() - yieldOf(0.98, 0.03), 1e-12);
+
+    forge::CompilerConfig config;
+    config.instructionSet = forge::CompilerConfig::InstructionSet::AVX2_PACKED;
+    ForgeKernelCache cache(config);
+    auto entry = cache.acquire(recorder.graph());
+    const std::vector<forge::NodeId> inputs = {price.forgeNodeId(), coupon.forgeNodeId()};
+
+    // prices and coupons moving the yield by up to 150bp from the recorded one
+    const Size n = 7;
+    std::vector<double> scenarios(2 * n), yields(n), gradients(2 * n);
+    for (Size p = 0; p < n; ++p) {
+        scenarios[2 * p] = 0.92 + 0.02 * p;
+        scenarios[2 * p + 1] = 0.02 + 0.004 * p;
+    }
+    forgeEvaluateBatched(*entry.kernel, *entry.buffer, inputs, {y.forgeNodeId()}, inputs,
+                         scenarios.data(), n, 2, yields.data(), gradients.data());
+
+    for (Size p = 0; p < n; ++p) {
+        const double P = scenarios[2 * p], c = scenarios[2 * p + 1];
+        const double expected = yieldOf(P, c);
+        BOOST_CHECK_SMALL(yields[p] - expected, 1e-12);
+        // dy/dP = -f_P / f_y and dy/dc = -f_c / f_y at the root
+        const double fy = slopeOf(expected, c);
+        BOOST_CHECK_CLOSE(gradients[2 * p], 1.0 / fy, 1e-8);
+        BOOST_CHECK_CLOSE(gradients[2 * p + 1], -annuityOf(expected) / fy, 1e-8);
+    }
+
+    BOOST_CHECK_THROW(ForgeImplicitSolver1D<Brent>(0), Error);
+}
+
+BOOST_AUTO_TEST_CASE(testSequentialBootstrap) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing a bootstrap of nested recorded solves against its closed form...");
+
+    forge::GraphRecorder recorder;
+    recorder.start();
+    Real q1 = 0.03, q2 = 0.035;
+    q1.markForgeInputAndDiff();
+    q2.markForgeInputAndDiff();
+    // no derivatives given, so the solver records central differences
+    ForgeImplicitSolver1D<Brent> solver(3);
+    Real z1 = solver.solve(
+        [](const Real& z, const std::vector<Real>& p) { return (1.0 + p[0]) * exp(-z) - 1.0; },
+        {q1}, 1e-12, 0.02, 0.01);
+    Real z2 = solver.solve(
+        [](const Real& z, const std::vector<Real>& p) {
+            Real d2 = exp(-2.0 * z);
+            return p[0] * (exp(-p[1]) + d2) + d2 - 1.0;
+        },
+        {q2, z1}, 1e-12, 0.02, -0.5, 0.5);
+    z2.markForgeOutput();
+    z1.markForgeOutput();
+    recorder.stop();
+    BOOST_CHECK_SMALL(z1.getValue() - depositZero(0.03), 1e-12);
+    BOOST_CHECK_SMALL(z2.getValue() - swapZero(0.03, 0.035), 1e-12);
+
+    forge::ForgeEngine compiler;
+    auto kernel = compiler.compile(recorder.graph());
+    auto buffer = forge::NodeValueBufferFactory::create(recorder.graph(), *kernel);
+    const std::vector<forge::NodeId> inputs = {q1.forgeNodeId(), q2.forgeNodeId()};
+
+    const Size n = 5;
+    std::vector<double> quotes(2 * n), zeros(2 * n), gradients(2 * n);
+    for (Size p = 0; p < n; ++p) {
+        quotes[2 * p] = 0.02 + 0.004 * p;
+        quotes[2 * p + 1] = 0.045 - 0.005 * p;
+    }
+    forgeEvaluateBatched(*kernel, *buffer, inputs, {z2.forgeNodeId(), z1.forgeNodeId()}, inputs,
+                         quotes.data(), n, 2, zeros.data(), gradients.data());
+
+    for (Size p = 0; p < n; ++p) {
+        const double a = quotes[2 * p], b = quotes[2 * p + 1];
+        BOOST_CHECK_SMALL(zeros[2 * p] - swapZero(a, b), 1e-12);
+        BOOST_CHECK_SMALL(zeros[2 * p + 1] - depositZero(a), 1e-12);
+        // adjoints of the 2y zero, through both solves
+        const double h = 1e-6;
+        const double d1 = (swapZero(a + h, b) - swapZero(a - h, b)) / (2.0 * h);
+        const double d2 = (swapZero(a, b + h) - swapZero(a, b - h)) / (2.0 * h);
+        BOOST_CHECK_CLOSE(gradients[2 * p], d1, 1e-6);
+        BOOST_CHECK_CLOSE(gradients[2 * p + 1], d2, 1e-6);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
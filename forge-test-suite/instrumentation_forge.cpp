@@ -0,0 +1,133 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Kernel instrumentation tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/instrumentation.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(InstrumentationForgeTests)
+
+BOOST_AUTO_TEST_CASE(testSampledScopedTimers) {
+
+    BOOST_TEST_MESSAGE("Testing sampled timestamp-counter timers...");
+
+    BOOST_CHECK(forgeTscTicksPerNanosecond() > 0.0);
+
+    ForgePhase every("every");
+    ForgePhase fourth("fourth", 4);
+    for (Size i = 0; i < 10; ++i) {
+        ForgeScopedTimer t1(every);
+        ForgeScopedTimer t2(fourth);
+    }
+    ForgePhaseStats s = every.stats();
+    BOOST_CHECK_EQUAL(s.calls, 10U);
+    BOOST_CHECK_EQUAL(s.samples, 10U);
+    BOOST_CHECK(s.minTicks <= s.maxTicks);
+    s = fourth.stats();
+    BOOST_CHECK_EQUAL(s.calls, 10U);
+    // calls 0, 4 and 8 are timed
+    BOOST_CHECK_EQUAL(s.samples, 3U);
+
+    // a sleeping scope is converted back to about its duration
+    ForgePhase sleep("sleep");
+    {
+        ForgeScopedTimer timer(sleep);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    const double ms = sleep.stats().meanNanoseconds() * 1e-6;
+    BOOST_CHECK_MESSAGE(ms > 19.0 && ms < 200.0, "20ms sleep measured as " << ms << "ms");
+
+    every.reset();
+    BOOST_CHECK_EQUAL(every.stats().calls, 0U);
+    BOOST_CHECK_EQUAL(every.stats().minTicks, 0U);
+}
+
+BOOST_AUTO_TEST_CASE(testInstrumentedKernelPhases) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing named kernel phases in a phase registry...");
+
+    forge::GraphRecorder recorder;
+    recorder.start();
+    Real x = 2.0;
+    x.markForgeInputAndDiff();
+    Real y = x * x + 3.0 * x;
+    y.markForgeOutput();
+    recorder.stop();
+    forge::ForgeEngine compiler;
+    auto kernel = compiler.compile(recorder.graph());
+    auto buffer = forge::NodeValueBufferFactory::create(recorder.graph(), *kernel);
+
+    ForgePhaseRegistry registry;
+    ForgePerfCounters counters;
+    ForgeInstrumentedKernel instrumented(*kernel, "square", 2, registry, &counters);
+    BOOST_CHECK_EQUAL(&registry.phase("square.execute"), &instrumented.executePhase());
+
+    const Size width = buffer->getVectorWidth();
+    std::vector<double> lanes(width), gradients(width);
+    for (Size i = 0; i < 7; ++i) {
+        instrumented.setInputs([&] {
+            std::fill(lanes.begin(), lanes.end(), double(i));
+            buffer->setLanes(x.forgeNodeId(), lanes.data());
+        });
+        instrumented.execute(*buffer);
+        double value = instrumented.outputs([&] {
+            buffer->getLanes(y.forgeNodeId(), lanes.data());
+            return lanes[0];
+        });
+        BOOST_CHECK_CLOSE(value, double(i * i + 3 * i), 1e-12);
+        instrumented.gradients([&] {
+            buffer->getGradientLanes({buffer->getBufferIndex(x.forgeNodeId())}, gradients.data());
+        });
+        BOOST_CHECK_CLOSE(gradients[0], 2.0 * i + 3.0, 1e-12);
+    }
+
+    std::vector<ForgePhaseStats> phases = registry.snapshot();
+    BOOST_REQUIRE_EQUAL(phases.size(), 4U);
+    BOOST_CHECK_EQUAL(phases[0].name, "square.execute");
+    for (const ForgePhaseStats& s : phases) {
+        BOOST_CHECK_EQUAL(s.calls, 7U);
+        BOOST_CHECK_EQUAL(s.samples, 4U);
+        if (counters.available(ForgePerfEvent::Instructions)) {
+            BOOST_CHECK_EQUAL(s.counted, 4U);
+            BOOST_CHECK(s.counterPerCall(ForgePerfEvent::Instructions) > 0.0);
+        }
+    }
+
+    std::ostringstream dump;
+    registry.dump(dump);
+    BOOST_CHECK(dump.str().find("square.gradients") != std::string::npos);
+
+    registry.reset();
+    BOOST_CHECK_EQUAL(registry.snapshot()[0].calls, 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
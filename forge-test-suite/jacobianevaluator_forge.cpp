@@ -0,0 +1,117 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Multi-output kernel and Jacobian tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/jacobianevaluator.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(JacobianEvaluatorForgeTests)
+
+BOOST_AUTO_TEST_CASE(testSeededAdjointsAndJacobian) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing seeded adjoints and Jacobians of a multi-output kernel...");
+
+    // three components sharing one sub-expression, as CVA, DVA and NPV share the exposure:
+    // y0 = e x0, y1 = e x1^2, y2 = e + x2 with e = exp(x0 x1)
+    forge::GraphRecorder recorder;
+    recorder.start();
+    std::vector<Real> x(3, 1.0);
+    std::vector<forge::NodeId> inputs;
+    for (auto& xi : x) {
+        xi.markForgeInputAndDiff();
+        inputs.push_back(xi.forgeNodeId());
+    }
+    Real e = exp(x[0] * x[1]);
+    ForgeMultiOutput outputs;
+    outputs.add(e * x[0]);
+    outputs.add(e * x[1] * x[1]);
+    BOOST_CHECK_EQUAL(outputs.add(e + x[2]), 2U);
+    outputs.close();
+    recorder.stop();
+    BOOST_CHECK_EQUAL(outputs.numOutputs(), 3U);
+    BOOST_CHECK_EQUAL(outputs.seedInputs().size(), 3U);
+    BOOST_CHECK_THROW(outputs.close(), Error);
+
+    forge::ForgeEngine compiler;
+    auto kernel = compiler.compile(recorder.graph());
+    auto buffer = forge::NodeValueBufferFactory::create(recorder.graph(), *kernel);
+
+    const double scenarios[6] = {0.3, 0.7, 2.0, -0.4, 1.2, 0.5};
+    auto expected = [](const double* s, double* y, double J[3][3]) {
+        const double ex = std::exp(s[0] * s[1]);
+        y[0] = ex * s[0];
+        y[1] = ex * s[1] * s[1];
+        y[2] = ex + s[2];
+        J[0][0] = ex * (1.0 + s[0] * s[1]);
+        J[0][1] = ex * s[0] * s[0];
+        J[0][2] = 0.0;
+        J[1][0] = ex * s[1] * s[1] * s[1];
+        J[1][1] = ex * (2.0 * s[1] + s[0] * s[1] * s[1]);
+        J[1][2] = 0.0;
+        J[2][0] = ex * s[1];
+        J[2][1] = ex * s[0];
+        J[2][2] = 1.0;
+    };
+
+    forgeWithBatchWidth(buffer->getVectorWidth(), [&](auto w) {
+        constexpr Size W = decltype(w)::value;
+
+        ForgeJacobianEvaluator<W> evaluator(*kernel, *buffer, outputs, inputs, inputs);
+        BOOST_CHECK_EQUAL(evaluator.jacobianExecutions(), (3 + W - 1) / W);
+
+        // the seeded pass gives the gradient of y0 + y1 - 2 y2 for both scenarios
+        const std::vector<double> seeds = {1.0, 1.0, -2.0};
+        double values[6], gradients[6];
+        evaluator.evaluate(scenarios, 2, 3, seeds, values, gradients);
+        for (Size s = 0; s < 2; ++s) {
+            double y[3], J[3][3];
+            expected(scenarios + 3 * s, y, J);
+            for (Size o = 0; o < 3; ++o)
+                BOOST_CHECK_CLOSE(values[3 * s + o], y[o], 1e-12);
+            for (Size g = 0; g < 3; ++g)
+                BOOST_CHECK_SMALL(gradients[3 * s + g] -
+                                      (J[0][g] + J[1][g] - 2.0 * J[2][g]),
+                                  1e-12);
+        }
+
+        double y[3], J[3][3], jacobian[9];
+        expected(scenarios + 3, y, J);
+        evaluator.jacobian(scenarios + 3, 1, values, jacobian);
+        for (Size o = 0; o < 3; ++o) {
+            BOOST_CHECK_CLOSE(values[o], y[o], 1e-12);
+            for (Size g = 0; g < 3; ++g)
+                BOOST_CHECK_SMALL(jacobian[3 * o + g] - J[o][g], 1e-12);
+        }
+
+        BOOST_CHECK_THROW(evaluator.evaluate(scenarios, 1, 3, {1.0}, values, gradients), Error);
+    });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
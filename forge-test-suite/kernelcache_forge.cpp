@@ -0,0 +1,278 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Kernel cache tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/kernelcache.hpp>
+#include <ql/forge/graphstore.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(KernelCacheForgeTests)
+
+namespace {
+
+    Real priceZeroBond(Real rate, Real notional, Integer years) {
+        Date today = Settings::instance().evaluationDate();
+        auto curve = ext::make_shared<FlatForward>(today, rate, Actual365Fixed());
+        return notional * curve->discount(today + years * Years);
+    }
+
+    struct Recording {
+        forge::Graph graph;
+        forge::NodeId rateNodeId;
+        forge::NodeId npvNodeId;
+    };
+
+    Recording recordZeroBond(Real rate, Real notional, Integer years) {
+        forge::GraphRecorder recorder;
+        recorder.start();
+        Real r = rate;
+        r.markForgeInputAndDiff();
+        Real npv = priceZeroBond(r, notional, years);
+        npv.markForgeOutput();
+        recorder.stop();
+        return {recorder.graph(), r.forgeNodeId(), npv.forgeNodeId()};
+    }
+
+    Real evaluate(ForgeKernelCache::Entry& entry, const Recording& rec, double rate, double& dRate) {
+        std::vector<double> lanes(entry.buffer->getVectorWidth(), rate);
+        entry.buffer->setLanes(rec.rateNodeId, lanes.data());
+        entry.buffer->clearGradients();
+        entry.kernel->execute(*entry.buffer);
+        entry.buffer->getLanes(rec.npvNodeId, lanes.data());
+        double npv = lanes[0];
+        entry.buffer->getGradientLanes({entry.buffer->getBufferIndex(rec.rateNodeId)}, lanes.data());
+        dRate = lanes[0];
+        return npv;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(testStructurallyIdenticalGraphsShareKernel) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing that structurally identical graphs reuse a cached kernel...");
+
+    ForgeKernelCache cache;
+
+    // recordings at different market data have the same structure
+    auto rec1 = recordZeroBond(0.03, 1000000.0, 5);
+    auto rec2 = recordZeroBond(0.04, 1000000.0, 5);
+    BOOST_CHECK_EQUAL(forgeGraphHash(rec1.graph), forgeGraphHash(rec2.graph));
+
+    auto entry1 = cache.acquire(rec1.graph);
+    auto entry2 = cache.acquire(rec2.graph);
+    BOOST_CHECK(!entry1.hit);
+    BOOST_CHECK(entry2.hit);
+    BOOST_CHECK(entry1.kernel == entry2.kernel);
+    BOOST_CHECK(entry1.buffer != entry2.buffer);
+    BOOST_CHECK_EQUAL(cache.size(), 1U);
+    BOOST_CHECK_EQUAL(cache.hits(), 1U);
+    BOOST_CHECK_EQUAL(cache.misses(), 1U);
+
+    // the cached kernel evaluates the second trade correctly
+    double dRate1 = 0.0, dRate2 = 0.0;
+    Real npv1 = evaluate(entry1, rec1, 0.04, dRate1);
+    Real npv2 = evaluate(entry2, rec2, 0.04, dRate2);
+    Real expected = priceZeroBond(0.04, 1000000.0, 5);
+    QL_CHECK_CLOSE(npv1, expected, 1e-10);
+    QL_CHECK_CLOSE(npv2, expected, 1e-10);
+    QL_CHECK_CLOSE(Real(dRate1), Real(dRate2), 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(testDifferentConstantsCompileSeparately) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing that graphs differing in constants get their own kernels...");
+
+    ForgeKernelCache cache;
+
+    auto rec1 = recordZeroBond(0.03, 1000000.0, 5);
+    auto rec2 = recordZeroBond(0.03, 2000000.0, 5);
+    auto entry1 = cache.acquire(rec1.graph);
+    auto entry2 = cache.acquire(rec2.graph);
+    BOOST_CHECK(!entry2.hit);
+    BOOST_CHECK(entry1.kernel != entry2.kernel);
+    BOOST_CHECK_EQUAL(cache.size(), 2U);
+
+    double dRate = 0.0;
+    QL_CHECK_CLOSE(evaluate(entry2, rec2, 0.03, dRate), priceZeroBond(0.03, 2000000.0, 5), 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(testCompilerConfigIsPartOfKey) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing that the compiler configuration fingerprint distinguishes caches...");
+
+    forge::CompilerConfig scalar = forge::CompilerConfig::Default();
+    forge::CompilerConfig packed = scalar;
+    packed.instructionSet = forge::CompilerConfig::InstructionSet::AVX2_PACKED;
+    BOOST_CHECK(forgeConfigHash(scalar) != forgeConfigHash(packed));
+    BOOST_CHECK_EQUAL(forgeConfigHash(scalar), forgeConfigHash(forge::CompilerConfig::Default()));
+}
+
+BOOST_AUTO_TEST_CASE(testGraphStoreRoundTrip) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing persistence of kernel records through the graph store...");
+
+    ForgeKernelCache cache;
+    auto rec = recordZeroBond(0.03, 1000000.0, 5);
+    auto entry = cache.acquire(rec.graph);
+
+    ForgeGraphStore store;
+    store.add(rec.graph, cache,
+              ForgeBufferLayout::fromBuffer(*entry.buffer, {rec.rateNodeId}, {rec.npvNodeId}));
+    std::string path = "forge_graphstore_test.bin";
+    store.save(path);
+
+    ForgeGraphStore loaded;
+    loaded.load(path);
+    std::remove(path.c_str());
+    BOOST_REQUIRE_EQUAL(loaded.size(), 1U);
+    const auto& record = loaded.records().front();
+    BOOST_CHECK_EQUAL(record.key.graphHash, forgeGraphHash(rec.graph));
+    BOOST_CHECK_EQUAL(record.layout.outputs.front().index,
+                      entry.buffer->getBufferIndex(rec.npvNodeId));
+
+    // a fresh process compiles the stored graph up front, not on first use
+    ForgeKernelCache restarted;
+    BOOST_CHECK_EQUAL(loaded.prewarm(restarted), 1U);
+    auto rerecorded = recordZeroBond(0.05, 1000000.0, 5);
+    auto restartedEntry = restarted.acquire(rerecorded.graph);
+    BOOST_CHECK(restartedEntry.hit);
+    double dRate = 0.0;
+    QL_CHECK_CLOSE(evaluate(restartedEntry, rerecorded, 0.05, dRate),
+                   priceZeroBond(0.05, 1000000.0, 5), 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(testGraphStoreRejectsForeignFiles) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing that the graph store rejects files it did not write...");
+
+    std::string path = "forge_graphstore_foreign.bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "not a graph store";
+    }
+    ForgeGraphStore store;
+    BOOST_CHECK_THROW(store.load(path), Error);
+    std::remove(path.c_str());
+
+    ForgeKernelCache cache;
+    auto rec = recordZeroBond(0.03, 1000000.0, 5);
+    auto entry = cache.acquire(rec.graph);
+    store.add(rec.graph, cache,
+              ForgeBufferLayout::fromBuffer(*entry.buffer, {rec.rateNodeId}, {rec.npvNodeId}));
+    store.save(path);
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    // magic, version, opcode fingerprint, four record sizes, record count, then the first record
+    const std::size_t fingerprintOffset = 8 + 4, sizesOffset = fingerprintOffset + 8,
+                      inputsOffset = sizesOffset + 4 * 4 + 8 + 3 * 8 + 4,
+                      nodesOffset = inputsOffset + 2 * (8 + sizeof(ForgeBufferLayout::Slot)),
+                      graphOutputsOffset = nodesOffset + 8 + rec.graph.nodes.size() * sizeof(forge::Node);
+    auto rewrite = [&](std::size_t offset, auto word) {
+        std::string patched = bytes;
+        std::memcpy(&patched[offset], &word, sizeof(word));
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(patched.data(), std::streamsize(patched.size()));
+    };
+
+    // graphs of a Forge with other opcodes, or another node layout
+    rewrite(fingerprintOffset, forgeOpcodeFingerprint() + 1);
+    BOOST_CHECK_THROW(store.load(path), Error);
+    rewrite(sizesOffset, std::uint32_t(sizeof(forge::Node) + 8));
+    BOOST_CHECK_THROW(store.load(path), Error);
+    // a count beyond the file is rejected before anything is allocated for it
+    rewrite(inputsOffset, std::uint64_t(1) << 60);
+    BOOST_CHECK_THROW(store.load(path), Error);
+    rewrite(inputsOffset, std::uint64_t(1000));
+    BOOST_CHECK_THROW(store.load(path), Error);
+    // node ids beyond the graph never reach the compiler
+    const forge::NodeId beyond = forge::NodeId(rec.graph.nodes.size());
+    rewrite(graphOutputsOffset + 8, beyond);
+    BOOST_CHECK_THROW(store.load(path), Error);
+    rewrite(nodesOffset - sizeof(ForgeBufferLayout::Slot), std::uint64_t(beyond));
+    BOOST_CHECK_THROW(store.load(path), Error);
+    // nor do operands recorded after the node using them
+    std::size_t user = 0;
+    for (std::size_t i = 0; i < rec.graph.nodes.size(); ++i)
+        if ((detail::forgeOperandMask(rec.graph.nodes[i], i) & 1U) != 0)
+            user = i;
+    BOOST_REQUIRE(user > 0);
+    rewrite(nodesOffset + 8 + user * sizeof(forge::Node) + offsetof(forge::Node, a), forge::NodeId(user));
+    BOOST_CHECK_THROW(store.load(path), Error);
+    // the untouched file still loads
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), std::streamsize(bytes.size()));
+    }
+    ForgeGraphStore reloaded;
+    reloaded.load(path);
+    BOOST_CHECK_EQUAL(reloaded.size(), 1U);
+    // the store is left as it was by a failed load
+    BOOST_CHECK_EQUAL(store.size(), 1U);
+    std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(testOpcodeProbeOutsideRecordings) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing that the opcode probe refuses to run during a recording...");
+
+    BOOST_CHECK(!forgeOpcodeTable().empty());
+    const auto record = [](bool probe) {
+        forge::GraphRecorder recorder;
+        recorder.start();
+        Real x = 0.5;
+        x.markForgeInputAndDiff();
+        Real y = x * x + 2.0 * x;
+        // with a process-wide recorder the probe would record into this graph
+        if (probe)
+            BOOST_CHECK_THROW(detail::forgeProbeOpcodes(), Error);
+        y.markForgeOutput();
+        recorder.stop();
+        return recorder.graph();
+    };
+    const forge::Graph probed = record(true), plain = record(false);
+    BOOST_CHECK(forgeGraphsEquivalent(probed, plain));
+    BOOST_CHECK_EQUAL(detail::forgeProbeOpcodes().size(), forgeOpcodeTable().size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
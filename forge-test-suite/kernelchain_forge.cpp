@@ -0,0 +1,136 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Chained curve and trade kernel tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/kernelchain.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(KernelChainForgeTests)
+
+namespace {
+
+    // discount factors at t = 1, 2, 3 from zero rates r0, r1 at t = 1, 2,
+    // extrapolated linearly in the rate beyond t = 2
+    template <class T>
+    std::vector<T> discounts(const T& r0, const T& r1) {
+        return {exp(-1.0 * r0), exp(-2.0 * r1), exp(-3.0 * (2.0 * r1 - r0))};
+    }
+
+    // a 3y annual bond and a 1y x 2y forward loan on the curve nodes
+    template <class T>
+    T bond(const std::vector<T>& df) {
+        return 0.05 * df[0] + 0.05 * df[1] + 1.05 * df[2];
+    }
+
+    template <class T>
+    T forwardLoan(const std::vector<T>& df) {
+        return df[0] - 1.03 * df[1];
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(testCurveFeedingTrades) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing a curve kernel chained into trade kernels...");
+
+    forge::GraphRecorder curveRecorder;
+    curveRecorder.start();
+    Real r0 = 0.02, r1 = 0.025;
+    r0.markForgeInputAndDiff();
+    r1.markForgeInputAndDiff();
+    const std::vector<forge::NodeId> quotes = {r0.forgeNodeId(), r1.forgeNodeId()};
+    ForgeMultiOutput curveNodes;
+    for (const auto& df : discounts(r0, r1))
+        curveNodes.add(df);
+    curveNodes.close();
+    curveRecorder.stop();
+    forge::ForgeEngine compiler;
+    auto curveKernel = compiler.compile(curveRecorder.graph());
+    auto curveBuffer = forge::NodeValueBufferFactory::create(curveRecorder.graph(), *curveKernel);
+
+    // each trade is recorded against its own copy of the curve nodes
+    auto recordTrade = [&](forge::GraphRecorder& recorder, bool isBond,
+                           std::vector<forge::NodeId>& inputs) {
+        recorder.start();
+        std::vector<Real> df(3, 0.9);
+        for (auto& d : df) {
+            d.markForgeInputAndDiff();
+            inputs.push_back(d.forgeNodeId());
+        }
+        Real npv = isBond ? bond(df) : forwardLoan(df);
+        npv.markForgeOutput();
+        recorder.stop();
+        return npv.forgeNodeId();
+    };
+    forge::GraphRecorder bondRecorder, loanRecorder;
+    std::vector<forge::NodeId> bondInputs, loanInputs;
+    const forge::NodeId bondNpv = recordTrade(bondRecorder, true, bondInputs);
+    const forge::NodeId loanNpv = recordTrade(loanRecorder, false, loanInputs);
+    auto bondKernel = compiler.compile(bondRecorder.graph());
+    auto bondBuffer = forge::NodeValueBufferFactory::create(bondRecorder.graph(), *bondKernel);
+    auto loanKernel = compiler.compile(loanRecorder.graph());
+    auto loanBuffer = forge::NodeValueBufferFactory::create(loanRecorder.graph(), *loanKernel);
+
+    const double scenarios[6] = {0.02, 0.025, 0.01, 0.03, 0.04, 0.035};
+
+    forgeWithBatchWidth(curveBuffer->getVectorWidth(), [&](auto w) {
+        constexpr Size W = decltype(w)::value;
+
+        ForgeCurveTradeChain<W> chain(*curveKernel, *curveBuffer, curveNodes, quotes, quotes);
+        BOOST_CHECK_THROW(chain.evaluate(scenarios, 1, 2, nullptr, nullptr), Error);
+        BOOST_CHECK_EQUAL(chain.addTrade(*bondKernel, *bondBuffer, bondInputs, bondNpv), 0U);
+        BOOST_CHECK_EQUAL(chain.addTrade(*loanKernel, *loanBuffer, loanInputs, loanNpv), 1U);
+        BOOST_CHECK_THROW(chain.addTrade(*loanKernel, *loanBuffer, {loanInputs[0]}, loanNpv),
+                          Error);
+
+        double npvs[6], sensitivities[6];
+        chain.evaluate(scenarios, 3, 2, npvs, sensitivities);
+        for (Size s = 0; s < 3; ++s) {
+            const double a = scenarios[2 * s], b = scenarios[2 * s + 1];
+            const std::vector<double> df = discounts(a, b);
+            BOOST_CHECK_CLOSE(npvs[2 * s], bond(df), 1e-12);
+            BOOST_CHECK_CLOSE(npvs[2 * s + 1], forwardLoan(df), 1e-12);
+
+            // d total / d r0 and d r1 through the discount factors
+            const double dTotal[3] = {0.05 + 1.0, 0.05 - 1.03, 1.05};
+            const double dr0 = -1.0 * dTotal[0] * df[0] + 3.0 * dTotal[2] * df[2];
+            const double dr1 = -2.0 * dTotal[1] * df[1] - 6.0 * dTotal[2] * df[2];
+            BOOST_CHECK_SMALL(sensitivities[2 * s] - dr0, 1e-12);
+            BOOST_CHECK_SMALL(sensitivities[2 * s + 1] - dr1, 1e-12);
+        }
+
+        // values only
+        double values[2];
+        chain.evaluate(scenarios, 1, 2, values, nullptr);
+        BOOST_CHECK_CLOSE(values[0], npvs[0], 1e-12);
+    });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
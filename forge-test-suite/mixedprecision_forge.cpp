@@ -0,0 +1,137 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Float32 scenario screening tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/kernelcache.hpp>
+#include <ql/forge/mixedprecision.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(MixedPrecisionForgeTests)
+
+namespace {
+
+    const Size numFactors = 6;
+
+    // npv = sum_i 0.03 exp(-r_i (i + 1)) + exp(-6 r_5) - 1, a par bond less its price
+    double npvOf(const double* r, Size stride) {
+        double npv = -1.0;
+        for (Size i = 0; i < numFactors; ++i)
+            npv += 0.03 * std::exp(-r[i * stride] * (i + 1.0));
+        return npv + std::exp(-r[(numFactors - 1) * stride] * double(numFactors));
+    }
+
+    ForgeScenarioCube makeCube(Size timeSteps, Size paths, Size laneWidth) {
+        ForgeScenarioCube cube(timeSteps, paths, numFactors, laneWidth);
+        for (Size t = 0; t < timeSteps; ++t)
+            for (Size p = 0; p < paths; ++p)
+                for (Size i = 0; i < numFactors; ++i)
+                    cube(t, p, i) = 0.01 + 0.001 * i + 0.0137 * std::sin(0.7 * p + t);
+        cube.padTails();
+        return cube;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(testFloatScenarioScreening) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing forward kernels over float32 scenarios...");
+
+    forge::GraphRecorder recorder;
+    recorder.start();
+    std::vector<Real> r(numFactors, 0.02);
+    std::vector<forge::NodeId> inputs;
+    Real npv = -1.0;
+    for (Size i = 0; i < numFactors; ++i) {
+        r[i].markForgeInput();
+        inputs.push_back(r[i].forgeNodeId());
+        npv += 0.03 * exp(-r[i] * (i + 1.0));
+    }
+    npv += exp(-r[numFactors - 1] * double(numFactors));
+    npv.markForgeOutput();
+    recorder.stop();
+
+    forge::CompilerConfig config;
+    config.instructionSet = forge::CompilerConfig::InstructionSet::AVX2_PACKED;
+    ForgeKernelCache cache(config);
+    auto entry = cache.acquire(recorder.graph());
+    const Size width = entry.buffer->getVectorWidth();
+
+    // the path count leaves a partial last batch
+    const Size paths = 4 * width + 3;
+    const ForgeScenarioCube cube = makeCube(2, paths, width);
+    const ForgeFloatScenarioCube screening = forgeFloatScenarioCube(cube);
+    BOOST_CHECK_EQUAL(screening.size(), cube.size());
+    BOOST_CHECK_EQUAL(screening.batches(), cube.batches());
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(screening.data()) %
+                          ForgeFloatScenarioCube::alignment,
+                      0U);
+    BOOST_CHECK_EQUAL(screening(1, paths - 1, 2), float(cube(1, paths - 1, 2)));
+
+    forgeWithBatchWidth(width, [&](auto w) {
+        constexpr Size W = decltype(w)::value;
+        ForgeMixedPrecisionEvaluator<W> evaluator(*entry.kernel, *entry.buffer, inputs,
+                                                  {npv.forgeNodeId()});
+        std::vector<float> npvs(paths);
+        evaluator.evaluate(screening, 1, npvs.data());
+        double exactSum = 0.0, sum = 0.0;
+        for (Size p = 0; p < paths; ++p) {
+            const auto path = cube.path(1, p);
+            const double exact = npvOf(path.data(), path.stride());
+            exactSum += exact;
+            // float32 rates and values, the error is that of the rounding
+            BOOST_CHECK_SMALL(double(npvs[p]) - exact, 1e-6);
+        }
+        evaluator.accumulate(screening, 1, &sum);
+        BOOST_CHECK_SMALL(sum / paths - exactSum / paths, 1e-7);
+
+        ForgeFloatScenarioCube narrow(1, paths, numFactors - 1, W);
+        BOOST_CHECK_THROW(evaluator.evaluate(narrow, 0, npvs.data()), Error);
+    });
+
+    ForgeMixedPrecisionAccuracy accuracy = forgeMixedPrecisionAccuracy(
+        *entry.kernel, *entry.buffer, inputs, {npv.forgeNodeId()}, cube, 1, 2 * width + 1);
+    BOOST_CHECK_EQUAL(accuracy.paths, 2 * width + 1);
+    BOOST_REQUIRE_EQUAL(accuracy.outputs(), 1U);
+    BOOST_CHECK(accuracy.maxAbsError[0] > 0.0);
+    BOOST_CHECK(accuracy.maxAbsError[0] < 1e-6);
+    BOOST_CHECK(accuracy.rmsError[0] <= accuracy.maxAbsError[0]);
+    BOOST_CHECK(accuracy.meanError[0] <= accuracy.maxAbsError[0]);
+    BOOST_CHECK(accuracy.worstPath[0] < accuracy.paths);
+    BOOST_CHECK(accuracy.maxRelativeError(0) < 1e-5);
+
+    std::ostringstream report;
+    accuracy.report(report);
+    BOOST_CHECK(report.str().find("float32") != std::string::npos);
+    BOOST_TEST_MESSAGE(report.str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,184 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   In-kernel Monte Carlo path evaluation tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/montecarlokernel.hpp>
+#include <ql/math/distributions/normaldistribution.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(MonteCarloKernelForgeTests)
+
+namespace {
+
+    const double strike = 105.0, maturity = 1.0;
+    const std::vector<double> marketParameters = {100.0, 0.2, 0.03};  // spot, vol, rate
+
+    // discounted call payoff of one path of a GBM sampled at numSteps dates
+    struct RecordedPathPricer {
+        forge::Graph graph;
+        std::vector<forge::NodeId> parameters, draws;
+        forge::NodeId payoff;
+    };
+
+    RecordedPathPricer recordPathPricer(Size numSteps) {
+        forge::GraphRecorder recorder;
+        recorder.start();
+        std::vector<Real> p(marketParameters.begin(), marketParameters.end());
+        RecordedPathPricer pricer;
+        for (auto& x : p) {
+            x.markForgeInputAndDiff();
+            pricer.parameters.push_back(x.forgeNodeId());
+        }
+        const double dt = maturity / numSteps;
+        Real logSpot = log(p[0]);
+        for (Size i = 0; i < numSteps; ++i) {
+            Real z = 0.0;
+            z.markForgeInput();
+            pricer.draws.push_back(z.forgeNodeId());
+            logSpot += (p[2] - 0.5 * p[1] * p[1]) * dt + p[1] * std::sqrt(dt) * z;
+        }
+        Real payoff = exp(-p[2] * maturity) * max(exp(logSpot) - strike, 0.0);
+        payoff.markForgeOutput();
+        pricer.payoff = payoff.forgeNodeId();
+        recorder.stop();
+        pricer.graph = recorder.graph();
+        return pricer;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(testPhiloxKnownAnswers) {
+
+    BOOST_TEST_MESSAGE("Testing the Philox4x32-10 generator against its known-answer vectors...");
+
+    typedef ForgePhilox4x32::Counter Counter;
+    typedef ForgePhilox4x32::Key Key;
+    const Key keys[3] = {{{0U, 0U}}, {{0xffffffffU, 0xffffffffU}}, {{0xa4093822U, 0x299f31d0U}}};
+    const Counter counters[3] = {{{0U, 0U, 0U, 0U}},
+                                 {{0xffffffffU, 0xffffffffU, 0xffffffffU, 0xffffffffU}},
+                                 {{0x243f6a88U, 0x85a308d3U, 0x13198a2eU, 0x03707344U}}};
+    const Counter expected[3] = {{{0x6627e8d5U, 0xe169c58dU, 0xbc57ac4cU, 0x9b00dbd8U}},
+                                 {{0x408f276dU, 0x41c83b0eU, 0xa20bc7c6U, 0x6d5451fdU}},
+                                 {{0xd16cfe09U, 0x94fdccebU, 0x5001e420U, 0x24126ea1U}}};
+    for (Size i = 0; i < 3; ++i) {
+        Counter r = ForgePhilox4x32(keys[i])(counters[i]);
+        for (Size w = 0; w < 4; ++w)
+            BOOST_CHECK_EQUAL(r[w], expected[i][w]);
+    }
+
+    // uniforms stay strictly inside (0, 1)
+    BOOST_CHECK(ForgePhilox4x32::uniform(0U, 0U) > 0.0);
+    BOOST_CHECK(ForgePhilox4x32::uniform(0xffffffffU, 0xffffffffU) < 1.0);
+}
+
+BOOST_AUTO_TEST_CASE(testEuropeanCallPathwiseGreeks) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing in-kernel Monte Carlo price and pathwise Greeks of a European call...");
+
+    auto pricer = recordPathPricer(4);
+    forge::ForgeEngine compiler;
+    auto kernel = compiler.compile(pricer.graph);
+    auto buffer = forge::NodeValueBufferFactory::create(pricer.graph, *kernel);
+
+    const Size numPaths = 200000;
+    ForgeMonteCarloResult mc = forgeRunMonteCarlo(*kernel, *buffer, pricer.draws, {pricer.payoff},
+                                                  pricer.parameters, marketParameters,
+                                                  pricer.parameters, numPaths, 42);
+    BOOST_CHECK_EQUAL(mc.paths, numPaths);
+
+    const double s = marketParameters[0], vol = marketParameters[1], r = marketParameters[2];
+    const double stdDev = vol * std::sqrt(maturity), df = std::exp(-r * maturity);
+    const double d1 = (std::log(s / strike) + r * maturity) / stdDev + 0.5 * stdDev,
+                 d2 = d1 - stdDev;
+    CumulativeNormalDistribution N;
+    NormalDistribution n;
+    const double price = s * value(N(d1)) - strike * df * value(N(d2));
+    const double delta = value(N(d1)), vega = s * value(n(d1)) * std::sqrt(maturity),
+                 rho = strike * maturity * df * value(N(d2));
+
+    BOOST_CHECK_MESSAGE(std::fabs(mc.mean() - price) < 4.0 * mc.errorEstimate(),
+                        "Monte Carlo price " << mc.mean() << " +- " << mc.errorEstimate()
+                                             << ", expected " << price);
+    // pathwise estimators converge like the price
+    QL_CHECK_CLOSE(Real(mc.gradient(0)), Real(delta), 2.0);
+    QL_CHECK_CLOSE(Real(mc.gradient(1)), Real(vega), 2.0);
+    QL_CHECK_CLOSE(Real(mc.gradient(2)), Real(rho), 2.0);
+}
+
+BOOST_AUTO_TEST_CASE(testPathReproducibility) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing that Monte Carlo paths depend on seed and path index only...");
+
+    auto pricer = recordPathPricer(3);
+    forge::ForgeEngine compiler;
+    auto kernel = compiler.compile(pricer.graph);
+    auto buffer = forge::NodeValueBufferFactory::create(pricer.graph, *kernel);
+    auto run = [&](Size numPaths, std::uint64_t seed, std::uint64_t firstPath) {
+        return forgeRunMonteCarlo(*kernel, *buffer, pricer.draws, {pricer.payoff},
+                                  pricer.parameters, marketParameters, pricer.parameters,
+                                  numPaths, seed, firstPath);
+    };
+
+    const Size numPaths = 1001;
+    ForgeMonteCarloResult full = run(numPaths, 7, 0);
+    ForgeMonteCarloResult again = run(numPaths, 7, 0);
+    BOOST_CHECK_EQUAL(full.sum[0], again.sum[0]);
+    BOOST_CHECK_EQUAL(full.gradientSum[1], again.gradientSum[1]);
+
+    // an odd split shifts every path to another lane; only the summation order changes
+    ForgeMonteCarloResult split = run(333, 7, 0);
+    split += run(numPaths - 333, 7, 333);
+    BOOST_CHECK_EQUAL(split.paths, numPaths);
+    QL_CHECK_CLOSE(Real(split.mean()), Real(full.mean()), 1e-10);
+    QL_CHECK_CLOSE(Real(split.gradient(0)), Real(full.gradient(0)), 1e-10);
+
+    // each path sees the draws of the generator for its index
+    std::vector<double> z(pricer.draws.size());
+    const double dt = maturity / z.size();
+    for (std::uint64_t path = 500; path < 510; ++path) {
+        ForgePhilox4x32(7).gaussians(path, z.size(), z.data());
+        double logSpot = std::log(marketParameters[0]);
+        for (double x : z)
+            logSpot +=
+                (marketParameters[2] - 0.5 * marketParameters[1] * marketParameters[1]) * dt +
+                marketParameters[1] * std::sqrt(dt) * x;
+        const double payoff = std::exp(-marketParameters[2] * maturity) *
+                              std::max(std::exp(logSpot) - strike, 0.0);
+        BOOST_CHECK_SMALL(run(1, 7, path).mean() - payoff, 1e-10);
+    }
+
+    ForgeMonteCarloResult otherSeed = run(numPaths, 8, 0);
+    BOOST_CHECK(otherSeed.sum[0] != full.sum[0]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
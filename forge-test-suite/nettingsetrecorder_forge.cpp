@@ -0,0 +1,134 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Netting set recording tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/kernelcache.hpp>
+#include <ql/forge/nettingsetrecorder.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(NettingSetRecorderForgeTests)
+
+namespace {
+
+    struct ZeroBond {
+        Real notional;
+        Integer years;
+    };
+
+    const std::vector<ZeroBond> nettingSet = {{1000000.0, 2}, {-400000.0, 5}, {250000.0, 10}};
+
+    ext::shared_ptr<YieldTermStructure> makeCurve(Real rate) {
+        Date today = Settings::instance().evaluationDate();
+        return ext::make_shared<FlatForward>(today, rate, Actual365Fixed());
+    }
+
+    Real priceOn(const ZeroBond& bond, const YieldTermStructure& curve) {
+        return bond.notional * curve.discount(curve.referenceDate() + bond.years * Years);
+    }
+
+    void recordNettingSet(ForgeNettingSetRecorder& recorder) {
+        recorder.start();
+        auto curve = makeCurve(recorder.inputs()[0]);
+        for (const auto& bond : nettingSet)
+            recorder.addTrade(priceOn(bond, *curve));
+        recorder.stop();
+    }
+
+    double lane0(ForgeBuffer& buffer, forge::NodeId node) {
+        std::vector<double> lanes(buffer.getVectorWidth());
+        buffer.getLanes(node, lanes.data());
+        return lanes[0];
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(testNettingSetInOneKernel) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing netting set valuation with one kernel execution...");
+
+    ForgeNettingSetOptions options;
+    options.totalOutput = true;
+    ForgeNettingSetRecorder recorder({0.03}, options);
+    recordNettingSet(recorder);
+    BOOST_REQUIRE_EQUAL(recorder.numTrades(), nettingSet.size());
+    BOOST_CHECK_EQUAL(recorder.outputNodeIds().size(), nettingSet.size() + 1);
+    BOOST_CHECK(recorder.outputNodeIds().front() == recorder.totalNodeId());
+
+    ForgeKernelCache cache;
+    auto entry = cache.acquire(recorder.graph());
+
+    double rate = 0.045;
+    std::vector<double> lanes(entry.buffer->getVectorWidth(), rate);
+    entry.buffer->setLanes(recorder.inputNodeIds()[0], lanes.data());
+    entry.buffer->clearGradients();
+    entry.kernel->execute(*entry.buffer);
+
+    auto curve = makeCurve(rate);
+    Real expectedTotal = 0.0, expectedDelta = 0.0;
+    for (Size i = 0; i < nettingSet.size(); ++i) {
+        Real expected = priceOn(nettingSet[i], *curve);
+        QL_CHECK_CLOSE(Real(lane0(*entry.buffer, recorder.tradeNodeId(i))), expected, 1e-10);
+        expectedTotal += expected;
+        expectedDelta -= curve->timeFromReference(curve->referenceDate() + nettingSet[i].years * Years) *
+                         expected;
+    }
+    QL_CHECK_CLOSE(Real(lane0(*entry.buffer, recorder.totalNodeId())), expectedTotal, 1e-10);
+
+    // the total is the first output, so the adjoints are netting-set deltas
+    entry.buffer->getGradientLanes({entry.buffer->getBufferIndex(recorder.inputNodeIds()[0])},
+                                   lanes.data());
+    QL_CHECK_CLOSE(Real(lanes[0]), expectedDelta, 1e-8);
+}
+
+BOOST_AUTO_TEST_CASE(testNettingSetRecorderUsage) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing netting set recorder usage checks...");
+
+    ForgeNettingSetOptions noOutputs;
+    noOutputs.tradeOutputs = false;
+    BOOST_CHECK_THROW(ForgeNettingSetRecorder({0.03}, noOutputs), Error);
+
+    ForgeNettingSetRecorder recorder({0.03});
+    BOOST_CHECK_THROW(recorder.addTrade(Real(1.0)), Error);
+    BOOST_CHECK_THROW(recorder.stop(), Error);
+
+    recorder.start();
+    BOOST_CHECK_THROW(recorder.graph(), Error);
+    BOOST_CHECK_THROW(recorder.stop(), Error);
+    recorder.priceTrade([](const std::vector<Real>& x) { return 100.0 * x[0]; });
+    recorder.stop();
+    BOOST_CHECK_EQUAL(recorder.numTrades(), 1U);
+    BOOST_CHECK_THROW(recorder.totalNodeId(), Error);
+    BOOST_CHECK_THROW(recorder.tradeNodeId(1), Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,135 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Multi-threaded scenario evaluator tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/parallelevaluator.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <algorithm>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(ParallelEvaluatorForgeTests)
+
+namespace {
+
+    Real priceZeroBond(Real rate) {
+        Date today = Settings::instance().evaluationDate();
+        auto curve = ext::make_shared<FlatForward>(today, rate, Actual365Fixed());
+        return 1000000.0 * curve->discount(today + 5 * Years);
+    }
+
+    double scenarioRate(Size p) { return 0.01 + 0.0001 * p; }
+
+}
+
+BOOST_AUTO_TEST_CASE(testParallelMatchesSerialEvaluation) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing multi-threaded scenario evaluation against single-threaded results...");
+
+    forge::GraphRecorder recorder;
+    recorder.start();
+    Real rate = 0.03;
+    rate.markForgeInputAndDiff();
+    Real npv = priceZeroBond(rate);
+    npv.markForgeOutput();
+    recorder.stop();
+    forge::NodeId rateNodeId = rate.forgeNodeId();
+    forge::NodeId npvNodeId = npv.forgeNodeId();
+
+    forge::CompilerConfig config;
+    ForgeKernelCache cache(config);
+    auto entry = cache.acquire(recorder.graph());
+
+    ForgeParallelScenarioEvaluator::Options options;
+    options.numThreads = 4;
+    options.chunkSize = 16;
+    ForgeParallelScenarioEvaluator evaluator(entry, recorder.graph(), options);
+
+    const Size numScenarios = 1001;
+    std::vector<double> npvs(numScenarios), deltas(numScenarios);
+    evaluator.run(numScenarios, [&](auto& buffer, Size begin, Size end, Size) {
+        const Size width = buffer.getVectorWidth();
+        std::vector<double> lanes(width);
+        std::vector<size_t> gradientIndices = {buffer.getBufferIndex(rateNodeId)};
+        for (Size p = begin; p < end; p += width) {
+            for (Size lane = 0; lane < width; ++lane)
+                lanes[lane] = scenarioRate(std::min(p + lane, end - 1));
+            buffer.setLanes(rateNodeId, lanes.data());
+            buffer.clearGradients();
+            evaluator.kernel().execute(buffer);
+            Size n = std::min(width, end - p);
+            buffer.getLanes(npvNodeId, lanes.data());
+            std::copy(lanes.begin(), lanes.begin() + n, npvs.begin() + p);
+            buffer.getGradientLanes(gradientIndices, lanes.data());
+            std::copy(lanes.begin(), lanes.begin() + n, deltas.begin() + p);
+        }
+    });
+
+    Size scenarios = 0;
+    for (const auto& stats : evaluator.threadStats())
+        scenarios += stats.scenarios;
+    BOOST_CHECK_EQUAL(scenarios, numScenarios);
+
+    auto serial = forge::NodeValueBufferFactory::create(recorder.graph(), *entry.kernel);
+    std::vector<double> lanes(serial->getVectorWidth());
+    for (Size p = 0; p < numScenarios; p += 97) {
+        std::fill(lanes.begin(), lanes.end(), scenarioRate(p));
+        serial->setLanes(rateNodeId, lanes.data());
+        serial->clearGradients();
+        entry.kernel->execute(*serial);
+        serial->getLanes(npvNodeId, lanes.data());
+        QL_CHECK_CLOSE(Real(npvs[p]), Real(lanes[0]), 1e-12);
+        QL_CHECK_CLOSE(Real(npvs[p]), priceZeroBond(scenarioRate(p)), 1e-10);
+        BOOST_CHECK(deltas[p] < 0.0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testWorkerExceptionIsRethrown) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing that exceptions in worker threads reach the caller...");
+
+    forge::GraphRecorder recorder;
+    recorder.start();
+    Real rate = 0.03;
+    rate.markForgeInput();
+    Real npv = priceZeroBond(rate);
+    npv.markForgeOutput();
+    recorder.stop();
+
+    ForgeKernelCache cache;
+    ForgeParallelScenarioEvaluator::Options options;
+    options.numThreads = 2;
+    ForgeParallelScenarioEvaluator evaluator(cache.acquire(recorder.graph()), recorder.graph(),
+                                             options);
+    BOOST_CHECK_THROW(evaluator.run(100, [](auto&, Size, Size, Size) { QL_FAIL("worker failure"); }),
+                      Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,119 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Parallel kernel recording and compilation tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/batchevaluator.hpp>
+#include <ql/forge/parallelkernelbuilder.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(ParallelKernelBuilderForgeTests)
+
+namespace {
+
+    // kernel k prices y = x * (k + 1) + exp(x) * k, with k + 1 extra terms
+    // so that the kernels differ in structure as well
+    ForgeRecordedIds recordKernel(Size k) {
+        ForgeRecordedIds ids;
+        Real x = 0.5;
+        x.markForgeInputAndDiff();
+        ids.inputs.push_back(x.forgeNodeId());
+        Real y = x * double(k + 1);
+        for (Size i = 0; i < k; ++i)
+            y += exp(x);
+        y.markForgeOutput();
+        ids.outputs.push_back(y.forgeNodeId());
+        return ids;
+    }
+
+    void checkKernels(std::vector<ForgeBuiltKernel>& kernels) {
+        const double x = 0.3;
+        for (Size k = 0; k < kernels.size(); ++k) {
+            ForgeBuiltKernel& built = kernels[k];
+            BOOST_REQUIRE(built.kernel != nullptr);
+            forgeWithBatchWidth(built.buffer->getVectorWidth(), [&](auto w) {
+                constexpr Size W = decltype(w)::value;
+                ForgeBatchEvaluator<W> evaluator(*built.kernel, *built.buffer, built.inputs,
+                                                 built.outputs, built.inputs);
+                double y, dy;
+                evaluator.evaluate(&x, 1, 1, &y, &dy);
+                BOOST_CHECK_CLOSE(y, x * (k + 1) + k * std::exp(x), 1e-12);
+                BOOST_CHECK_CLOSE(dy, (k + 1) + k * std::exp(x), 1e-12);
+            });
+        }
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(testParallelKernelCreation) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing kernels recorded and compiled on several threads...");
+
+    BOOST_TEST_MESSAGE("  recorder state is "
+                       << (forgeRecorderIsThreadLocal() ? "thread-local" : "shared"));
+    BOOST_CHECK(!forge::GraphRecorder::isAnyRecording());
+
+    const Size numKernels = 16;
+    ForgeParallelKernelBuilderOptions options;
+    options.numThreads = 4;
+
+    options.recording = ForgeRecordingConcurrency::Serialised;
+    ForgeParallelKernelBuilder serialised(forge::CompilerConfig(), options);
+    BOOST_CHECK(!serialised.parallelRecording());
+    auto kernels = serialised.build(numKernels, recordKernel);
+    BOOST_CHECK_EQUAL(kernels.size(), numKernels);
+    checkKernels(kernels);
+
+    options.recording = ForgeRecordingConcurrency::Auto;
+    ForgeParallelKernelBuilder automatic(forge::CompilerConfig(), options);
+    BOOST_CHECK_EQUAL(automatic.parallelRecording(), forgeRecorderIsThreadLocal());
+    kernels = automatic.build(numKernels, recordKernel);
+    checkKernels(kernels);
+
+    // through a cache, kernels recorded twice are compiled once
+    ForgeKernelCache cache;
+    ForgeParallelKernelBuilder cached(cache, options);
+    kernels = cached.build(2 * numKernels, [](Size k) { return recordKernel(k % numKernels); });
+    BOOST_CHECK_EQUAL(cache.size(), numKernels);
+    kernels.resize(numKernels);
+    checkKernels(kernels);
+
+    // errors reach the caller, and no recording is left active
+    BOOST_CHECK_THROW(automatic.build(numKernels,
+                                      [](Size k) -> ForgeRecordedIds {
+                                          if (k == 5)
+                                              throw std::runtime_error("trade 5 failed");
+                                          return recordKernel(k);
+                                      }),
+                      std::runtime_error);
+    BOOST_CHECK(!forge::GraphRecorder::isAnyRecording());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
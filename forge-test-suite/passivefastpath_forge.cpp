@@ -0,0 +1,217 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Passive fast path tests: AReal expressions evaluated outside recordings.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(PassiveFastPathForgeTests)
+
+namespace {
+
+    // The suite runs in whatever configuration it is built with; CI builds it
+    // once more with FEXPR_FORGE_PASSIVE_FAST_PATH off, and both must give the
+    // same values and derivatives.
+#ifdef FEXPR_FORGE_PASSIVE_FAST_PATH
+    const bool fastPath = true;
+#else
+    const bool fastPath = false;
+#endif
+
+    // binary and unary expressions, scalars, compound assignment and horner()
+    template <class R>
+    R price(const R* x) {
+        R y = x[0] * x[1] + exp(-x[0]) / (1.0 + x[1]);
+        y += sqrt(x[1]) * log(2.0 + x[0]);
+        y *= 1.5;
+        y -= 0.25 * x[0] / x[1];
+        return y + forge::expr::horner(x[0], {0.5, -1.0, 0.25});
+    }
+
+    // values built from a before any recording starts
+    template <class R>
+    struct Passives {
+        R b, c, d;
+    };
+
+    template <class R>
+    Passives<R> passives(const R& a) {
+        Passives<R> p;
+        p.b = a * 3.0 + exp(a);
+        p.c = 1.0;
+        p.c += p.b * a;
+        p.c = forge::expr::horner(a, {1.0, 0.5, -0.25}) * p.c;
+        const R args[2] = {a, p.b};
+        p.d = price(args);
+        return p;
+    }
+
+    // what is recorded on an input x, using the passive values
+    template <class R>
+    R recorded(const R& x, const Passives<R>& p) {
+        const R args[2] = {x, p.b};
+        R y = x * p.b + p.c * x * x + p.d / x;
+        y += price(args);
+        return y;
+    }
+
+    template <class F>
+    double centralDifference(const F& f, double x, double h = 1e-6) {
+        return (f(x + h) - f(x - h)) / (2.0 * h);
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(testPassiveEvaluation) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing AReal values and tape derivatives outside recordings...");
+
+    BOOST_TEST_MESSAGE("  passive fast path " << fastPath);
+    BOOST_CHECK(!forge::GraphRecorder::isAnyRecording());
+    BOOST_CHECK_EQUAL(forge::expr::detail::forgeTracking(), !fastPath);
+
+    const double x0[2] = {0.3, 1.7};
+    std::vector<Real> x(x0, x0 + 2);
+    const Real y = price(x.data());
+    QL_CHECK_CLOSE(y, Real(price(x0)), 1e-13);
+    // the Forge side of a passive value is a copy of it, whether built or not
+    BOOST_CHECK(!y.forgeValue().isActive());
+    BOOST_CHECK_EQUAL(static_cast<double>(y.forgeValue()), y.value());
+
+#ifndef FEXPR_NO_TAPE
+    typedef Real::tape_type tape_type;
+    tape_type tape;
+    tape.registerInputs(x);
+    tape.newRecording();
+    Real z = price(x.data());
+    tape.registerOutput(z);
+    derivative(z) = 1.0;
+    tape.computeAdjoints();
+    QL_CHECK_CLOSE(z, Real(price(x0)), 1e-13);
+    for (Size i = 0; i < 2; ++i) {
+        const double expected = centralDifference(
+            [&](double xi) {
+                double bumped[2] = {x0[0], x0[1]};
+                bumped[i] = xi;
+                return price(bumped);
+            },
+            x0[i]);
+        BOOST_CHECK_SMALL(derivative(x[i]) - expected, 1e-7);
+    }
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(testRecordingAfterPassiveValues) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing a recording on AReals built before it started...");
+
+    const double a0 = 0.7;
+    const Real a = a0;
+    const Passives<Real> p = passives(a);
+    const Passives<double> expected = passives(a0);
+    QL_CHECK_CLOSE(p.b, Real(expected.b), 1e-13);
+    QL_CHECK_CLOSE(p.c, Real(expected.c), 1e-13);
+    QL_CHECK_CLOSE(p.d, Real(expected.d), 1e-13);
+    for (const Real* v : {&p.b, &p.c, &p.d})
+        BOOST_CHECK_EQUAL(static_cast<double>(v->forgeValue()), v->value());
+
+    // the recording and the tape both see the passive values as constants
+    const double x0 = 0.4;
+    Real x = x0;
+#ifndef FEXPR_NO_TAPE
+    typedef Real::tape_type tape_type;
+    tape_type tape;
+    tape.registerInput(x);
+    tape.newRecording();
+#endif
+    forge::GraphRecorder recorder;
+    recorder.start();
+    x.markForgeInputAndDiff();
+    Real y = recorded(x, p);
+    y.markForgeOutput();
+    recorder.stop();
+
+    const auto formula = [&](double xi) { return recorded(xi, expected); };
+    QL_CHECK_CLOSE(y, Real(formula(x0)), 1e-13);
+#ifndef FEXPR_NO_TAPE
+    tape.registerOutput(y);
+    derivative(y) = 1.0;
+    tape.computeAdjoints();
+    BOOST_CHECK_SMALL(derivative(x) - centralDifference(formula, x0), 1e-6);
+#endif
+
+    const forge::Graph& graph = recorder.graph();
+    forge::ForgeEngine compiler;
+    auto kernel = compiler.compile(graph);
+    auto buffer = forge::NodeValueBufferFactory::create(graph, *kernel);
+    const Size width = buffer->getVectorWidth();
+    std::vector<double> lanes(width), gradients(width);
+    const std::vector<std::size_t> gradient = {buffer->getBufferIndex(x.forgeNodeId())};
+    for (double xi : {x0, 1.1, 2.5}) {
+        std::fill(lanes.begin(), lanes.end(), xi);
+        buffer->setLanes(x.forgeNodeId(), lanes.data());
+        buffer->clearGradients();
+        kernel->execute(*buffer);
+        buffer->getLanes(y.forgeNodeId(), lanes.data());
+        buffer->getGradientLanes(gradient, gradients.data());
+        QL_CHECK_CLOSE(Real(lanes[0]), Real(formula(xi)), 1e-12);
+        BOOST_CHECK_SMALL(gradients[0] - centralDifference(formula, xi),
+                          1e-6 * std::max(1.0, std::fabs(gradients[0])));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testCopiesAfterRecording) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing copies and moves of recorded values after the recording...");
+
+    forge::GraphRecorder recorder;
+    recorder.start();
+    Real x = 0.6;
+    x.markForgeInputAndDiff();
+    Real y = x * x + 1.0;
+    recorder.stop();
+
+    // with the fast path, copies and moves outside recordings rebuild the
+    // Forge side from the scalar instead of carrying the stale node along
+    Real copied(y), assigned, moveAssigned;
+    assigned = y;
+    Real source = y, other = y;
+    Real moved(std::move(source));
+    moveAssigned = std::move(other);
+    for (const Real* v : {&copied, &assigned, &moved, &moveAssigned}) {
+        QL_CHECK_CLOSE(*v, y, 1e-15);
+        BOOST_CHECK_EQUAL(static_cast<double>(v->forgeValue()), v->value());
+        BOOST_CHECK_EQUAL(v->forgeValue().isActive(), !fastPath);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,255 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Kernel-versus-QuantLib performance mode of the QuantLib-Forge test suite.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "perf_forge.hpp"
+#include <ql/errors.hpp>
+#include <ql/forge/autotuner.hpp>
+#include <ql/forge/graphstore.hpp>
+#include <boost/test/results_collector.hpp>
+#include <boost/test/unit_test.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <chrono>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+namespace QuantLib {
+
+    namespace {
+
+        struct PerfOptions {
+            bool enabled = false;
+            // empty for the standard output
+            std::string path;
+        };
+
+        PerfOptions& perfOptions() {
+            static PerfOptions options;
+            return options;
+        }
+
+        // one JSON object per measured fixture
+        std::vector<std::string>& perfEntries() {
+            static std::vector<std::string> entries;
+            return entries;
+        }
+
+        // shortest timed loop; the loop is repeated with four times the calls until it is reached
+        const double minimumSeconds = 0.05;
+
+        template <class F>
+        double nanosecondsPerCall(F&& f) {
+            using clock = std::chrono::steady_clock;
+            f();
+            for (Size calls = 1;; calls *= 4) {
+                const auto start = clock::now();
+                for (Size i = 0; i < calls; ++i)
+                    f();
+                const double seconds = std::chrono::duration<double>(clock::now() - start).count();
+                if (seconds >= minimumSeconds || calls >= (Size(1) << 24))
+                    return 1e9 * seconds / double(calls);
+            }
+        }
+
+        struct PerfRecording {
+            forge::Graph graph;
+            std::vector<forge::NodeId> inputs;
+            forge::NodeId output;
+            double recordMicroseconds;
+        };
+
+        PerfRecording perfRecord(const std::vector<double>& values,
+                                 const std::function<Real(const std::vector<Real>&)>& price,
+                                 bool differentiate) {
+            const auto start = std::chrono::steady_clock::now();
+            forge::GraphRecorder recorder;
+            recorder.start();
+            PerfRecording rec;
+            std::vector<Real> x(values.begin(), values.end());
+            for (Real& xi : x) {
+                if (differentiate)
+                    xi.markForgeInputAndDiff();
+                else
+                    xi.markForgeInput();
+                rec.inputs.push_back(xi.forgeNodeId());
+            }
+            Real npv = price(x);
+            npv.markForgeOutput();
+            rec.output = npv.forgeNodeId();
+            recorder.stop();
+            rec.graph = recorder.graph();
+            rec.recordMicroseconds =
+                1e6 * std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return rec;
+        }
+
+        struct PerfKernelTiming {
+            double compileMicroseconds = 0.0;
+            Size lanes = 0;
+            // per scenario, i.e. per execution over the lanes
+            double nanoseconds = 0.0;
+        };
+
+        PerfKernelTiming perfTimeKernel(const PerfRecording& rec,
+                                        const std::vector<double>& values,
+                                        forge::CompilerConfig::InstructionSet isa,
+                                        bool adjoint) {
+            PerfKernelTiming timing;
+            forge::CompilerConfig config;
+            config.instructionSet = isa;
+            const auto start = std::chrono::steady_clock::now();
+            forge::ForgeEngine compiler(config);
+            auto kernel = compiler.compile(rec.graph);
+            auto buffer = forge::NodeValueBufferFactory::create(rec.graph, *kernel);
+            timing.compileMicroseconds =
+                1e6 * std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            timing.lanes = buffer->getVectorWidth();
+            std::vector<double> lanes(timing.lanes);
+            for (Size i = 0; i < rec.inputs.size(); ++i) {
+                std::fill(lanes.begin(), lanes.end(), values[i]);
+                buffer->setLanes(rec.inputs[i], lanes.data());
+            }
+            timing.nanoseconds = nanosecondsPerCall([&]() {
+                                     if (adjoint)
+                                         buffer->clearGradients();
+                                     kernel->execute(*buffer);
+                                 }) /
+                                 double(timing.lanes);
+            return timing;
+        }
+
+        std::string jsonString(const std::string& s) {
+            std::string quoted = "\"";
+            for (char c : s) {
+                if (c == '"' || c == '\\')
+                    quoted += '\\';
+                quoted += c;
+            }
+            return quoted + "\"";
+        }
+
+        void writePerfReport() {
+            std::ostringstream report;
+            report << "{\n  \"cpu\": " << jsonString(forgeCpuModel()) << ",\n  \"fixtures\": [";
+            const auto& entries = perfEntries();
+            for (Size i = 0; i < entries.size(); ++i)
+                report << (i == 0 ? "\n    " : ",\n    ") << entries[i];
+            report << "\n  ]\n}\n";
+            if (perfOptions().path.empty()) {
+                std::cout << report.str();
+            } else {
+                std::ofstream out(perfOptions().path);
+                out << report.str();
+                if (!out)
+                    std::cerr << "could not write " << perfOptions().path << "\n";
+            }
+        }
+
+        // reads --forge_perf[=path] before the first test and writes the report after the last
+        struct PerfReportFixture {
+            PerfReportFixture() {
+                const auto& suite = boost::unit_test::framework::master_test_suite();
+                const std::string flag = "--forge_perf";
+                for (int i = 1; i < suite.argc; ++i) {
+                    const std::string arg = suite.argv[i];
+                    if (arg == flag) {
+                        perfOptions().enabled = true;
+                    } else if (arg.compare(0, flag.size() + 1, flag + "=") == 0) {
+                        perfOptions().enabled = true;
+                        perfOptions().path = arg.substr(flag.size() + 1);
+                    }
+                }
+            }
+            ~PerfReportFixture() {
+                if (perfOptions().enabled)
+                    writePerfReport();
+            }
+        };
+
+    }
+
+#if BOOST_VERSION >= 106500
+    BOOST_TEST_GLOBAL_FIXTURE(PerfReportFixture);
+#else
+    BOOST_GLOBAL_FIXTURE(PerfReportFixture);
+#endif
+
+    bool forgePerfEnabled() { return perfOptions().enabled; }
+
+    void forgePerfMeasure(const std::string& fixture,
+                          const std::vector<double>& inputs,
+                          const std::function<Real(const std::vector<Real>&)>& price) {
+        if (!forgePerfEnabled())
+            return;
+        // a fixture whose checks failed is not timed: its kernels may not compute the price
+        const auto& results = boost::unit_test::results_collector.results(
+            boost::unit_test::framework::current_test_case().p_id);
+        if (results.p_assertions_failed > 0) {
+            BOOST_TEST_MESSAGE("  perf " << fixture << ": not measured after failed checks");
+            return;
+        }
+
+        std::ostringstream entry;
+        entry << std::setprecision(6) << "{\"fixture\": " << jsonString(fixture)
+              << ", \"inputs\": " << inputs.size();
+        try {
+            // QuantLib on passive values, then the fastest of three recordings
+            const std::vector<Real> passive(inputs.begin(), inputs.end());
+            const double quantlib = nanosecondsPerCall([&]() { price(passive); });
+            PerfRecording adjoint = perfRecord(inputs, price, true);
+            for (Size k = 0; k < 2; ++k) {
+                PerfRecording again = perfRecord(inputs, price, true);
+                if (again.recordMicroseconds < adjoint.recordMicroseconds)
+                    adjoint = std::move(again);
+            }
+            const PerfRecording forward = perfRecord(inputs, price, false);
+            entry << ", \"nodes\": " << adjoint.graph.nodes.size()
+                  << ", \"forwardNodes\": " << forward.graph.nodes.size()
+                  << ", \"recordUs\": " << adjoint.recordMicroseconds
+                  << ", \"quantlibNs\": " << quantlib;
+
+            std::vector<std::pair<const char*, forge::CompilerConfig::InstructionSet>> isas = {
+                {"scalar", forge::CompilerConfig::InstructionSet::SSE2_SCALAR}};
+            if ((forgeCpuFeatures() & ForgeCpuAVX2) != 0)
+                isas.emplace_back("avx2", forge::CompilerConfig::InstructionSet::AVX2_PACKED);
+            for (const auto& isa : isas) {
+                const PerfKernelTiming f = perfTimeKernel(forward, inputs, isa.second, false);
+                const PerfKernelTiming a = perfTimeKernel(adjoint, inputs, isa.second, true);
+                entry << ", \"" << isa.first << "\": {\"lanes\": " << a.lanes
+                      << ", \"compileUs\": " << a.compileMicroseconds
+                      << ", \"forwardCompileUs\": " << f.compileMicroseconds
+                      << ", \"forwardNs\": " << f.nanoseconds << ", \"aadNs\": " << a.nanoseconds
+                      << ", \"forwardSpeedup\": " << quantlib / f.nanoseconds
+                      << ", \"aadSpeedup\": " << double(inputs.size() + 1) * quantlib / a.nanoseconds
+                      << "}";
+            }
+            BOOST_TEST_MESSAGE("  perf " << fixture << ": " << adjoint.graph.nodes.size()
+                                         << " nodes, QuantLib " << quantlib << " ns");
+        } catch (std::exception& e) {
+            // a fixture the kernels cannot handle is reported, not failed
+            entry << ", \"error\": " << jsonString(e.what());
+        }
+        entry << "}";
+        perfEntries().push_back(entry.str());
+    }
+
+}
@@ -0,0 +1,80 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Kernel-versus-QuantLib performance mode of the QuantLib-Forge test suite.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Run with --forge_perf after the Boost.Test arguments,
+
+        forge-test-suite --log_level=message -- --forge_perf=forge_perf.json
+
+    (or build the ql_forge_perf target), and the instrument fixtures time
+    the pricing they check: each calls forgePerfMeasure() with its inputs
+    and pricing function after its checks, and the call does nothing if
+    any check of the test case has failed.  The measurement records the
+    price twice, with the inputs differentiated and as plain inputs,
+    compiles both for SSE2 and, if the CPU has it, AVX2, and times
+
+      - the recording and the compilation of each (compileUs for the AAD
+        kernel, forwardCompileUs for the forward one),
+      - a forward and an AAD kernel execution, per scenario (execution
+        time over the lanes),
+      - the same pricing through QuantLib, outside of a recording,
+
+    and the report gives forwardSpeedup = QuantLib / forward and
+    aadSpeedup = (inputs + 1) QuantLib / AAD, the second against one-sided
+    bump-and-revalue.  The report is one JSON object with an entry per
+    fixture, written to the given file, or to the standard output for a
+    bare --forge_perf, when the suite ends.  Without the flag
+    forgePerfMeasure() does nothing.
+*/
+
+#ifndef quantlib_forge_perf_forge_hpp
+#define quantlib_forge_perf_forge_hpp
+
+#include <ql/types.hpp>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace QuantLib {
+
+    /// true if the suite was started with --forge_perf
+    bool forgePerfEnabled();
+
+    /// times price on the given input values and adds the fixture to the report
+    void forgePerfMeasure(const std::string& fixture,
+                          const std::vector<double>& inputs,
+                          const std::function<Real(const std::vector<Real>&)>& price);
+
+    /// the same for fixtures pricing a data struct, whose listed members are the inputs
+    template <class Data, class PriceFunc>
+    void forgePerfMeasure(const std::string& fixture,
+                          const Data& data,
+                          const std::vector<Real Data::*>& members,
+                          PriceFunc price) {
+        if (!forgePerfEnabled())
+            return;
+        std::vector<double> inputs;
+        for (auto m : members)
+            inputs.push_back((data.*m).getValue());
+        forgePerfMeasure(fixture, inputs, [&](const std::vector<Real>& x) {
+            Data d = data;
+            for (Size i = 0; i < members.size(); ++i)
+                d.*members[i] = x[i];
+            return Real(price(d));
+        });
+    }
+
+}
+
+#endif
@@ -0,0 +1,155 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Recording profiler tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/recordingprofiler.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(RecordingProfilerForgeTests)
+
+namespace {
+
+    Real discount(const Real& rate, double t) {
+        FORGE_SCOPE("discount");
+        return exp(-rate * t);
+    }
+
+    Real leg(const Real& rate, Size periods) {
+        FORGE_SCOPE("leg");
+        Real npv = 0.0;
+        for (Size i = 1; i <= periods; ++i)
+            npv += 0.05 * discount(rate, 0.5 * i);
+        return npv;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(testScopeAttribution) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing attribution of recorded nodes to FORGE_SCOPE tags...");
+
+    BOOST_CHECK(forge::expr::activeRecordingScopeSink() == nullptr);
+
+    forge::GraphRecorder recorder;
+    recorder.start();
+    ForgeRecordingProfile profile;
+    {
+        ForgeRecordingProfiler profiler(recorder, "bond");
+        Real rate = 0.03;
+        rate.markForgeInputAndDiff();
+        Real npv = leg(rate, 6) + discount(rate, 3.25);
+        BOOST_CHECK_EQUAL(profiler.depth(), 1U);
+        npv.markForgeOutput();
+        recorder.stop();
+        profile = profiler.profile();
+    }
+    BOOST_CHECK(forge::expr::activeRecordingScopeSink() == nullptr);
+    const forge::Graph& graph = recorder.graph();
+
+    // every node is attributed once, and the root includes them all
+    BOOST_CHECK_EQUAL(profile.totalNodes(), graph.nodes.size());
+    const ForgeScopeProfile* root = profile.find("bond");
+    const ForgeScopeProfile* legScope = profile.find("bond;leg");
+    const ForgeScopeProfile* nested = profile.find("bond;leg;discount");
+    const ForgeScopeProfile* direct = profile.find("bond;discount");
+    BOOST_REQUIRE(root != nullptr && legScope != nullptr && nested != nullptr && direct != nullptr);
+    BOOST_CHECK_EQUAL(root->inclusiveNodes, graph.nodes.size());
+    BOOST_CHECK_EQUAL(root->inputs, 1U);
+    BOOST_CHECK_EQUAL(legScope->inclusiveNodes, legScope->nodes + nested->nodes);
+
+    // the six calls from the leg land on one path, each recording what the direct call does
+    BOOST_CHECK(direct->nodes > 0);
+    BOOST_CHECK_EQUAL(nested->nodes, 6 * direct->nodes);
+    Size histogram = 0;
+    for (const auto& op : nested->opcodes)
+        histogram += op.second;
+    BOOST_CHECK_EQUAL(histogram, nested->nodes);
+
+    // folded stacks add up to the graph, and cycles to what was attributed
+    std::ostringstream folded;
+    profile.writeFolded(folded);
+    std::istringstream lines(folded.str());
+    std::string path;
+    Size count, total = 0;
+    while (lines >> path >> count)
+        total += count;
+    BOOST_CHECK_EQUAL(total, graph.nodes.size());
+    BOOST_CHECK(folded.str().find("bond;leg;discount ") != std::string::npos);
+
+    profile.attributeCycles(1000.0);
+    double cycles = 0.0;
+    for (const auto& scope : profile.scopes())
+        cycles += scope.estimatedCycles;
+    BOOST_CHECK_CLOSE(cycles, 1000.0, 1e-10);
+    BOOST_CHECK_CLOSE(nested->estimatedCycles, 6 * direct->estimatedCycles, 1e-10);
+
+    forge::ForgeEngine compiler;
+    auto kernel = compiler.compile(graph);
+    auto buffer = forge::NodeValueBufferFactory::create(graph, *kernel);
+    BOOST_CHECK(forgeKernelTicksPerExecution(*kernel, *buffer, 10) > 0.0);
+
+    std::ostringstream report;
+    profile.report(report);
+    BOOST_TEST_MESSAGE(report.str());
+    // opcodes are reported by name
+    BOOST_CHECK_EQUAL(forgeOpcodeName(std::uint32_t(forge::OpCode::Input)), "Input");
+    BOOST_CHECK(report.str().find("Exp x") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(testScopesWithoutProfiler) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing that scopes without a profiler change nothing...");
+
+    forge::GraphRecorder recorder;
+    recorder.start();
+    Real rate = 0.03;
+    rate.markForgeInputAndDiff();
+    Real npv = leg(rate, 3);
+    npv.markForgeOutput();
+    recorder.stop();
+    const Size untagged = recorder.graph().nodes.size();
+
+    // nodes recorded before the profiler are not attributed
+    recorder.start();
+    Real again = 0.03;
+    again.markForgeInputAndDiff();
+    ForgeRecordingProfiler profiler(recorder);
+    npv = leg(again, 3);
+    npv.markForgeOutput();
+    recorder.stop();
+    ForgeRecordingProfile profile = profiler.profile();
+    BOOST_CHECK_EQUAL(recorder.graph().nodes.size(), untagged);
+    BOOST_CHECK_EQUAL(profile.totalNodes(), untagged - 1);
+    BOOST_CHECK(profile.find("recording;leg;discount") != nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,292 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Rolled (repeat region) recording tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/repeatregion.hpp>
+#include <ql/exercise.hpp>
+#include <ql/instruments/vanillaoption.hpp>
+#include <ql/pricingengines/vanilla/binomialengine.hpp>
+#include <ql/processes/blackscholesprocess.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/termstructures/volatility/equityfx/blackconstantvol.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/calendars/nullcalendar.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(RepeatRegionForgeTests)
+
+namespace {
+
+    const double strike = 100.0, maturity = 1.0;
+    // spot, vol, rate; the spot is off the strike so that no tree node sits on the payoff kink
+    const std::vector<double> marketParameters = {102.0, 0.2, 0.05};
+
+    double maxOf(double a, double b) { return std::max(a, b); }
+    Real maxOf(const Real& a, const Real& b) { return max(a, b); }
+
+    // One step of an American put on a Cox-Ross-Rubinstein log-space tree of
+    // numSteps steps, on a fixed grid of numSteps + 1 nodes.  At tree step i
+    // only nodes 0..i are meaningful; the others carry unused values.  The
+    // continuation weight w is 0 on the first iteration, which leaves the
+    // exercise value, i.e. the payoff at maturity, and 1 afterwards.
+    template <class T>
+    std::vector<T> rollbackStep(const std::vector<T>& v, const T& i, const T& w, const T& spot,
+                                const T& vol, const T& rate, Size numSteps) {
+        using std::exp;
+        using std::sqrt;
+        const double dt = maturity / numSteps;
+        T dx = vol * std::sqrt(dt);
+        T pu = 0.5 + 0.5 * (rate - 0.5 * vol * vol) * dt / dx;
+        T pd = 1.0 - pu;
+        T discount = w * exp(-rate * dt);
+        const Size n = v.size();
+        std::vector<T> next(n);
+        for (Size j = 0; j < n; ++j) {
+            T s = spot * exp((2.0 * j - i) * dx);
+            T continuation = discount * (pu * v[std::min(j + 1, n - 1)] + pd * v[j]);
+            next[j] = maxOf(strike - s, continuation);
+        }
+        return next;
+    }
+
+    // tree index and continuation weight of the iterations, [step][input]
+    std::vector<double> treeStepInputs(Size numSteps) {
+        std::vector<double> inputs;
+        for (Size k = 0; k <= numSteps; ++k) {
+            inputs.push_back(double(numSteps - k));
+            inputs.push_back(k == 0 ? 0.0 : 1.0);
+        }
+        return inputs;
+    }
+
+    double referencePrice(const std::vector<double>& p, Size numSteps) {
+        std::vector<double> v(numSteps + 1, 0.0);
+        for (Size k = 0; k <= numSteps; ++k)
+            v = rollbackStep<double>(v, double(numSteps - k), k == 0 ? 0.0 : 1.0, p[0], p[1],
+                                     p[2], numSteps);
+        return v[0];
+    }
+
+    struct RecordedRegion {
+        forge::Graph graph;
+        ForgeRepeatRegion region;
+    };
+
+    RecordedRegion recordRollbackStep(Size numSteps) {
+        forge::GraphRecorder recorder;
+        recorder.start();
+        RecordedRegion recorded;
+        ForgeRepeatRegion& region = recorded.region;
+        std::vector<Real> v = region.state(numSteps + 1);
+        Real i = region.stepInput(double(numSteps)), w = region.stepInput(0.0);
+        Real spot = region.parameter(marketParameters[0]);
+        Real vol = region.parameter(marketParameters[1]);
+        Real rate = region.parameter(marketParameters[2]);
+        region.close(rollbackStep(v, i, w, spot, vol, rate, numSteps));
+        recorder.stop();
+        recorded.graph = recorder.graph();
+        return recorded;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(testRolledTreeMatchesUnrolledRecording) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing a rolled tree rollback against the fully unrolled recording...");
+
+    const Size numSteps = 20;
+
+    // unrolled: every step recorded into one graph
+    forge::GraphRecorder recorder;
+    recorder.start();
+    std::vector<Real> p(marketParameters.begin(), marketParameters.end());
+    std::vector<forge::NodeId> parameterIds;
+    for (auto& x : p) {
+        x.markForgeInputAndDiff();
+        parameterIds.push_back(x.forgeNodeId());
+    }
+    std::vector<Real> v(numSteps + 1, 0.0);
+    for (Size k = 0; k <= numSteps; ++k)
+        v = rollbackStep<Real>(v, Real(double(numSteps - k)), Real(k == 0 ? 0.0 : 1.0), p[0],
+                               p[1], p[2], numSteps);
+    v[0].markForgeOutput();
+    forge::NodeId priceId = v[0].forgeNodeId();
+    recorder.stop();
+    forge::Graph unrolledGraph = recorder.graph();
+
+    forge::ForgeEngine compiler;
+    auto unrolledKernel = compiler.compile(unrolledGraph);
+    auto unrolledBuffer = forge::NodeValueBufferFactory::create(unrolledGraph, *unrolledKernel);
+    const int vectorWidth = unrolledBuffer->getVectorWidth();
+    std::vector<double> lanes(vectorWidth);
+    for (Size j = 0; j < p.size(); ++j) {
+        std::fill(lanes.begin(), lanes.end(), marketParameters[j]);
+        unrolledBuffer->setLanes(parameterIds[j], lanes.data());
+    }
+    unrolledKernel->execute(*unrolledBuffer);
+    unrolledBuffer->getLanes(priceId, lanes.data());
+    const double unrolledPrice = lanes[0];
+    std::vector<size_t> indices;
+    for (auto id : parameterIds)
+        indices.push_back(unrolledBuffer->getBufferIndex(id));
+    std::vector<double> unrolledGradients(indices.size() * vectorWidth);
+    unrolledBuffer->getGradientLanes(indices, unrolledGradients.data());
+
+    // rolled: one step recorded and iterated
+    auto rolled = recordRollbackStep(numSteps);
+    auto kernel = compiler.compile(rolled.graph);
+    auto buffer = forge::NodeValueBufferFactory::create(rolled.graph, *kernel);
+    std::vector<double> seed(numSteps + 1, 0.0);
+    seed[0] = 1.0;
+    ForgeRepeatRegionResult result =
+        forgeRollRepeatRegion(*kernel, *buffer, rolled.region, std::vector<double>(numSteps + 1, 0.0),
+                              marketParameters, treeStepInputs(numSteps), numSteps + 1, seed);
+
+    BOOST_TEST_MESSAGE("  unrolled graph: " << unrolledGraph.nodes.size()
+                                            << " nodes, rolled step: " << rolled.graph.nodes.size());
+    BOOST_CHECK(rolled.graph.nodes.size() < unrolledGraph.nodes.size());
+
+    QL_CHECK_CLOSE(Real(result.finalState[0]), Real(unrolledPrice), 1e-10);
+    QL_CHECK_CLOSE(Real(result.finalState[0]), Real(referencePrice(marketParameters, numSteps)), 1e-10);
+    for (Size j = 0; j < marketParameters.size(); ++j)
+        QL_CHECK_CLOSE(Real(result.parameterAdjoints[j]), Real(unrolledGradients[j * vectorWidth]), 1e-8);
+    // the initial state is overwritten by the payoff on the first iteration
+    for (double a : result.stateAdjoints)
+        BOOST_CHECK_SMALL(a, 1e-14);
+}
+
+BOOST_AUTO_TEST_CASE(testRolledAmericanPutWithManySteps) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing a 500-step rolled binomial American put and its adjoints...");
+
+    const Size numSteps = 500;
+    auto rolled = recordRollbackStep(numSteps);
+    forge::ForgeEngine compiler;
+    auto kernel = compiler.compile(rolled.graph);
+    auto buffer = forge::NodeValueBufferFactory::create(rolled.graph, *kernel);
+    BOOST_TEST_MESSAGE("  rolled step graph: " << rolled.graph.nodes.size() << " nodes for "
+                                               << numSteps << " steps");
+
+    std::vector<double> seed(numSteps + 1, 0.0);
+    seed[0] = 1.0;
+    const std::vector<double> stepInputs = treeStepInputs(numSteps);
+    ForgeRepeatRegionResult result =
+        forgeRollRepeatRegion(*kernel, *buffer, rolled.region, std::vector<double>(numSteps + 1, 0.0),
+                              marketParameters, stepInputs, numSteps + 1, seed);
+    const double price = result.finalState[0];
+
+    // QuantLib's own CRR tree on the same number of steps
+    Date today = Date(15, May, 2025);
+    Settings::instance().evaluationDate() = today;
+    DayCounter dc = Actual365Fixed();
+    auto process = ext::make_shared<BlackScholesProcess>(
+        Handle<Quote>(ext::make_shared<SimpleQuote>(marketParameters[0])),
+        Handle<YieldTermStructure>(ext::make_shared<FlatForward>(today, marketParameters[2], dc)),
+        Handle<BlackVolTermStructure>(
+            ext::make_shared<BlackConstantVol>(today, NullCalendar(), marketParameters[1], dc)));
+    VanillaOption option(ext::make_shared<PlainVanillaPayoff>(Option::Put, strike),
+                         ext::make_shared<AmericanExercise>(today, today + 365));
+    option.setPricingEngine(
+        ext::make_shared<BinomialVanillaEngine<CoxRossRubinstein>>(process, numSteps));
+    QL_CHECK_CLOSE(Real(price), option.NPV(), 0.1);
+
+    // adjoints against central differences of the same tree
+    const double h = 1e-5;
+    for (Size j = 0; j < marketParameters.size(); ++j) {
+        std::vector<double> up(marketParameters), down(marketParameters);
+        up[j] += h;
+        down[j] -= h;
+        const double fd = (referencePrice(up, numSteps) - referencePrice(down, numSteps)) / (2 * h);
+        QL_CHECK_CLOSE(Real(result.parameterAdjoints[j]), Real(fd), 0.1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testCheckpointedReversePass) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing the checkpointed reverse pass of a rolled tree against storing every state...");
+
+    const Size numSteps = 200, numIterations = numSteps + 1;
+    auto rolled = recordRollbackStep(numSteps);
+    forge::ForgeEngine compiler;
+    auto kernel = compiler.compile(rolled.graph);
+    auto buffer = forge::NodeValueBufferFactory::create(rolled.graph, *kernel);
+    const std::vector<double> initial(numSteps + 1, 0.0), stepInputs = treeStepInputs(numSteps);
+    std::vector<double> seed(numSteps + 1, 0.0);
+    seed[0] = 1.0;
+
+    ForgeRepeatRegionResult full = forgeRollRepeatRegion(*kernel, *buffer, rolled.region, initial,
+                                                         marketParameters, stepInputs,
+                                                         numIterations, seed);
+
+    for (Size budget : {Size(1), Size(3), Size(10)}) {
+        forgeWithBatchWidth(Size(buffer->getVectorWidth()), [&](auto w) {
+            ForgeRepeatRegionEvaluator<decltype(w)::value> evaluator(*kernel, *buffer, rolled.region,
+                                                                     budget);
+            evaluator.roll(initial.data(), marketParameters.data(), 1, stepInputs.data(),
+                           numIterations);
+            evaluator.adjoint(seed.data());
+            BOOST_CHECK(evaluator.checkpointed());
+
+            std::vector<double> price(numSteps + 1), parameterAdjoints(marketParameters.size()),
+                stepInputAdjoints(stepInputs.size());
+            evaluator.readStates(price.data());
+            evaluator.readParameterAdjoints(parameterAdjoints.data());
+            evaluator.readStepInputAdjoints(stepInputAdjoints.data());
+            QL_CHECK_CLOSE(Real(price[0]), Real(full.finalState[0]), 1e-12);
+            for (Size j = 0; j < parameterAdjoints.size(); ++j)
+                QL_CHECK_CLOSE(Real(parameterAdjoints[j]), Real(full.parameterAdjoints[j]), 1e-12);
+            for (Size j = 0; j < stepInputAdjoints.size(); ++j)
+                BOOST_CHECK_SMALL(stepInputAdjoints[j] - full.stepInputAdjoints[j], 1e-12);
+
+            BOOST_TEST_MESSAGE("  " << budget << " stored states: " << evaluator.numExecutions()
+                                    << " step executions for " << numIterations << " steps");
+            // Revolve's bound with c = budget - 1 checkpoints besides the initial state:
+            // r + 1 executions per step in the reverse pass, for the fewest r with
+            // C(c + r, r) >= steps; without checkpoints, every step is recomputed
+            const Size c = budget - 1;
+            Size bound = numIterations * (numIterations + 3) / 2;
+            if (c > 0) {
+                Size r = 0;
+                for (double capacity = 1.0; capacity < numIterations;) {
+                    ++r;
+                    capacity = capacity * (c + r) / r;
+                }
+                bound = (r + 2) * numIterations;
+            }
+            BOOST_CHECK(evaluator.numExecutions() <= bound);
+        });
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,237 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Record-once, replay-many instrument tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/replayinstrument.hpp>
+#include <ql/handle.hpp>
+#include <ql/exercise.hpp>
+#include <ql/instruments/vanillaoption.hpp>
+#include <ql/pricingengines/vanilla/analyticeuropeanengine.hpp>
+#include <ql/processes/blackscholesprocess.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/termstructures/volatility/equityfx/blackconstantvol.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/calendars/target.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(ReplayInstrumentForgeTests)
+
+namespace {
+
+    // a forward contract priced in performCalculations, counting its calculations
+    class ForwardContract : public Instrument {
+      public:
+        ForwardContract(Handle<Quote> spot, Handle<Quote> rate, Real strike, Time maturity)
+        : spot_(std::move(spot)), rate_(std::move(rate)), strike_(strike), maturity_(maturity) {
+            registerWith(spot_);
+            registerWith(rate_);
+        }
+        bool isExpired() const override { return false; }
+        Size calculations() const { return calculations_; }
+        /// makes the next calculations throw
+        void fail(bool f) { fail_ = f; }
+
+      protected:
+        void performCalculations() const override {
+            QL_REQUIRE(!fail_, "pricing failed");
+            NPV_ = spot_->value() - strike_ * exp(-rate_->value() * maturity_);
+            ++calculations_;
+        }
+
+      private:
+        Handle<Quote> spot_, rate_;
+        Real strike_;
+        Time maturity_;
+        mutable Size calculations_ = 0;
+        bool fail_ = false;
+    };
+
+}
+
+BOOST_AUTO_TEST_CASE(testReplayWithoutNotification) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing quote changes replayed through a compiled instrument...");
+
+    auto spot = ext::make_shared<ForgeQuote>(100.0);
+    auto rate = ext::make_shared<ForgeQuote>(0.03);
+    auto contract = ext::make_shared<ForwardContract>(Handle<Quote>(spot), Handle<Quote>(rate),
+                                                      95.0, 2.0);
+
+    // before an instrument is compiled on it, a ForgeQuote notifies like a SimpleQuote
+    BOOST_CHECK_CLOSE(value(contract->NPV()), 100.0 - 95.0 * std::exp(-0.06), 1e-12);
+    spot->setValue(101.0);
+    BOOST_CHECK_CLOSE(value(contract->NPV()), 101.0 - 95.0 * std::exp(-0.06), 1e-12);
+    BOOST_CHECK_EQUAL(contract->calculations(), 2U);
+
+    ForgeInstrument forged(contract, {spot, rate});
+    BOOST_CHECK(!forged.bound());
+    BOOST_CHECK_CLOSE(value(forged.NPV()), 101.0 - 95.0 * std::exp(-0.06), 1e-12);
+    BOOST_CHECK_EQUAL(forged.recordings(), 1U);
+    BOOST_CHECK_EQUAL(contract->calculations(), 3U);
+    BOOST_CHECK(forged.bound());
+
+    for (Size i = 0; i < 5; ++i) {
+        const double s = 90.0 + 5.0 * i, r = 0.01 + 0.005 * i;
+        spot->setValue(s);
+        rate->setValue(r);
+        BOOST_CHECK_CLOSE(value(forged.NPV()), s - 95.0 * std::exp(-2.0 * r), 1e-12);
+        const std::vector<double>& sensitivities = forged.sensitivities();
+        BOOST_CHECK_CLOSE(sensitivities[0], 1.0, 1e-12);
+        BOOST_CHECK_CLOSE(sensitivities[1], 2.0 * 95.0 * std::exp(-2.0 * r), 1e-12);
+    }
+    // the decorated instrument was not recalculated, and NPV() without a change does not replay
+    BOOST_CHECK_EQUAL(contract->calculations(), 3U);
+    const Size replays = forged.replays();
+    forged.NPV();
+    BOOST_CHECK_EQUAL(forged.replays(), replays);
+
+    // any other notification of the instrument records it again
+    contract->update();
+    spot->setValue(100.0);
+    BOOST_CHECK_CLOSE(value(forged.NPV()), 100.0 - 95.0 * std::exp(-2.0 * rate->rawValue()),
+                      1e-12);
+    BOOST_CHECK_EQUAL(forged.recordings(), 2U);
+    BOOST_CHECK_EQUAL(contract->calculations(), 4U);
+}
+
+BOOST_AUTO_TEST_CASE(testOutsideObserversNotified) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing an undecorated instrument sharing a quote with a compiled one...");
+
+    auto spot = ext::make_shared<ForgeQuote>(100.0);
+    auto rate = ext::make_shared<ForgeQuote>(0.03);
+    auto contract = ext::make_shared<ForwardContract>(Handle<Quote>(spot), Handle<Quote>(rate),
+                                                      95.0, 2.0);
+    auto other = ext::make_shared<ForwardContract>(Handle<Quote>(spot), Handle<Quote>(rate),
+                                                   105.0, 1.0);
+
+    ForgeInstrument forged(contract, {spot, rate});
+    BOOST_CHECK_CLOSE(value(forged.NPV()), 100.0 - 95.0 * std::exp(-0.06), 1e-12);
+    BOOST_CHECK_CLOSE(value(other->NPV()), 100.0 - 105.0 * std::exp(-0.03), 1e-12);
+    BOOST_CHECK(forged.bound());
+
+    for (Size i = 0; i < 3; ++i) {
+        const double s = 95.0 + 5.0 * i, r = 0.02 + 0.01 * i;
+        spot->setValue(s);
+        rate->setValue(r);
+        // the undecorated instrument is recalculated, the compiled one replays
+        BOOST_CHECK_CLOSE(value(other->NPV()), s - 105.0 * std::exp(-r), 1e-12);
+        BOOST_CHECK_CLOSE(value(forged.NPV()), s - 95.0 * std::exp(-2.0 * r), 1e-12);
+    }
+    BOOST_CHECK_EQUAL(other->calculations(), 4U);
+    BOOST_CHECK_EQUAL(contract->calculations(), 1U);
+    BOOST_CHECK_EQUAL(forged.recordings(), 1U);
+
+    // other changes of the decorated instrument still record it again
+    contract->update();
+    spot->setValue(100.0);
+    BOOST_CHECK_CLOSE(value(forged.NPV()), 100.0 - 95.0 * std::exp(-2.0 * rate->rawValue()),
+                      1e-12);
+    BOOST_CHECK_CLOSE(value(other->NPV()), 100.0 - 105.0 * std::exp(-rate->rawValue()), 1e-12);
+    BOOST_CHECK_EQUAL(forged.recordings(), 2U);
+}
+
+BOOST_AUTO_TEST_CASE(testFailedRecordingNotBound) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing that a failed recording leaves the quotes unbound...");
+
+    auto spot = ext::make_shared<ForgeQuote>(100.0);
+    auto rate = ext::make_shared<ForgeQuote>(0.03);
+    auto contract = ext::make_shared<ForwardContract>(Handle<Quote>(spot), Handle<Quote>(rate),
+                                                      95.0, 2.0);
+    ForgeInstrument forged(contract, {spot, rate});
+
+    contract->fail(true);
+    BOOST_CHECK_THROW(forged.NPV(), Error);
+    BOOST_CHECK(!forged.bound());
+    BOOST_CHECK_EQUAL(forged.recordings(), 0U);
+    // the quotes are passive again
+    BOOST_CHECK(!spot->value().forgeValue().isActive());
+
+    // the next NPV() records again and binds
+    contract->fail(false);
+    BOOST_CHECK_CLOSE(value(forged.NPV()), 100.0 - 95.0 * std::exp(-0.06), 1e-12);
+    BOOST_CHECK(forged.bound());
+    BOOST_CHECK_EQUAL(forged.recordings(), 1U);
+    spot->setValue(102.0);
+    BOOST_CHECK_CLOSE(value(forged.NPV()), 102.0 - 95.0 * std::exp(-0.06), 1e-12);
+    BOOST_CHECK_EQUAL(forged.recordings(), 1U);
+    BOOST_CHECK_EQUAL(contract->calculations(), 1U);
+}
+
+BOOST_AUTO_TEST_CASE(testReplayedEuropeanOption) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing a European option replayed on ForgeQuote inputs...");
+
+    const Date today(15, May, 2025);
+    Settings::instance().evaluationDate() = today;
+    const DayCounter dc = Actual365Fixed();
+
+    auto makeOption = [&](const ext::shared_ptr<Quote>& s, const ext::shared_ptr<Quote>& r,
+                          const ext::shared_ptr<Quote>& v) {
+        Handle<YieldTermStructure> rTS(ext::make_shared<FlatForward>(today, Handle<Quote>(r), dc));
+        Handle<YieldTermStructure> qTS(ext::make_shared<FlatForward>(today, 0.01, dc));
+        Handle<BlackVolTermStructure> volTS(
+            ext::make_shared<BlackConstantVol>(today, TARGET(), Handle<Quote>(v), dc));
+        auto process =
+            ext::make_shared<BlackScholesMertonProcess>(Handle<Quote>(s), qTS, rTS, volTS);
+        auto option = ext::make_shared<VanillaOption>(
+            ext::make_shared<PlainVanillaPayoff>(Option::Call, 100.0),
+            ext::make_shared<EuropeanExercise>(today + Period(1, Years)));
+        option->setPricingEngine(ext::make_shared<AnalyticEuropeanEngine>(process));
+        return option;
+    };
+
+    auto spot = ext::make_shared<ForgeQuote>(100.0);
+    auto rate = ext::make_shared<ForgeQuote>(0.03);
+    auto vol = ext::make_shared<ForgeQuote>(0.2);
+    ForgeInstrument forged(makeOption(spot, rate, vol), {spot, rate, vol});
+
+    const double spots[] = {100.0, 97.5, 103.0};
+    for (double s : spots) {
+        spot->setValue(s);
+        vol->setValue(0.2 + (s - 100.0) * 0.001);
+        auto reference = makeOption(ext::make_shared<SimpleQuote>(s),
+                                    ext::make_shared<SimpleQuote>(0.03),
+                                    ext::make_shared<SimpleQuote>(vol->rawValue()));
+        QL_CHECK_CLOSE(forged.NPV(), reference->NPV(), 1e-9);
+        const std::vector<double>& sensitivities = forged.sensitivities();
+        QL_CHECK_CLOSE(sensitivities[0], reference->delta(), 1e-7);
+        QL_CHECK_CLOSE(sensitivities[1], reference->rho(), 1e-7);
+        QL_CHECK_CLOSE(sensitivities[2], reference->vega(), 1e-7);
+    }
+    BOOST_CHECK_EQUAL(forged.recordings(), 1U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,186 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Memory-mapped scenario file tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/batchevaluator.hpp>
+#include <ql/forge/scenariofile.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(ScenarioFileForgeTests)
+
+namespace {
+
+    const Size timeSteps = 3, paths = 10, factors = 5, laneWidth = 4;
+
+    double scenarioValue(Size t, Size p, Size f) {
+        return 0.01 * (t + 1) + 0.001 * p + 0.1 * f;
+    }
+
+    ForgeScenarioCube makeCube() {
+        ForgeScenarioCube cube(timeSteps, paths, factors, laneWidth);
+        for (Size t = 0; t < timeSteps; ++t)
+            for (Size p = 0; p < paths; ++p)
+                for (Size f = 0; f < factors; ++f)
+                    cube(t, p, f) = scenarioValue(t, p, f);
+        cube.padTails();
+        return cube;
+    }
+
+    // removes the file when the test ends, pass or fail
+    struct TemporaryFile {
+        std::string name;
+        explicit TemporaryFile(std::string n) : name(std::move(n)) {}
+        ~TemporaryFile() { std::remove(name.c_str()); }
+    };
+
+}
+
+BOOST_AUTO_TEST_CASE(testScenarioFileRoundTrip) {
+
+    BOOST_TEST_MESSAGE("Testing scenario files written from cubes and path by path...");
+
+    ForgeScenarioCube cube = makeCube();
+    TemporaryFile fromCube("forge_scenarios_cube.qlfs"), streamed("forge_scenarios_paths.qlfs");
+    forgeWriteScenarioFile(fromCube.name, cube);
+    {
+        ForgeScenarioFileWriter writer(streamed.name, timeSteps, paths, factors, laneWidth);
+        std::vector<double> row(factors);
+        for (Size t = 0; t < timeSteps; ++t) {
+            for (Size p = 0; p < paths; ++p) {
+                for (Size f = 0; f < factors; ++f)
+                    row[f] = scenarioValue(t, p, f);
+                writer.writePath(row.data());
+            }
+        }
+        writer.close();
+    }
+
+    for (const std::string& name : {fromCube.name, streamed.name}) {
+        ForgeMappedScenarioFile file(name);
+        BOOST_CHECK_EQUAL(file.timeSteps(), timeSteps);
+        BOOST_CHECK_EQUAL(file.paths(), paths);
+        BOOST_CHECK_EQUAL(file.factors(), factors);
+        BOOST_CHECK_EQUAL(file.batches(), cube.batches());
+        for (Size t = 0; t < timeSteps; ++t) {
+            // the batches, padding lanes included, match the cube byte for byte
+            for (Size b = 0; b < cube.batches(); ++b)
+                for (Size i = 0; i < factors * laneWidth; ++i)
+                    BOOST_CHECK_EQUAL(file.batch(t, b)[i], cube.batch(t, b)[i]);
+            for (Size p = 0; p < paths; ++p)
+                BOOST_CHECK_EQUAL(file.path(t, p)[factors - 1], scenarioValue(t, p, factors - 1));
+        }
+    }
+
+    // incomplete and corrupt files are rejected
+    {
+        ForgeScenarioFileWriter writer(streamed.name, timeSteps, paths, factors, laneWidth);
+        std::vector<double> row(factors, 0.0);
+        writer.writePath(row.data());
+        BOOST_CHECK_THROW(writer.close(), Error);
+    }
+    BOOST_CHECK_THROW(ForgeMappedScenarioFile file(streamed.name), Error);
+    {
+        std::fstream f(fromCube.name, std::ios::in | std::ios::out | std::ios::binary);
+        f.write("NOTSCEN", 8);
+    }
+    BOOST_CHECK_THROW(ForgeMappedScenarioFile file(fromCube.name), Error);
+}
+
+BOOST_AUTO_TEST_CASE(testStreamedBatchEvaluation) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing kernel evaluation over a double-buffered scenario stream...");
+
+    ForgeScenarioCube cube = makeCube();
+    TemporaryFile scenarios("forge_scenarios_stream.qlfs");
+    forgeWriteScenarioFile(scenarios.name, cube);
+    ForgeMappedScenarioFile file(scenarios.name);
+
+    forge::GraphRecorder recorder;
+    recorder.start();
+    std::vector<Real> x(factors, 0.0);
+    std::vector<forge::NodeId> inputs;
+    Real y = 0.0;
+    for (Size f = 0; f < factors; ++f) {
+        x[f].markForgeInputAndDiff();
+        inputs.push_back(x[f].forgeNodeId());
+        y += (f + 1.0) * x[f] * x[f];
+    }
+    y.markForgeOutput();
+    recorder.stop();
+    forge::ForgeEngine compiler;
+    auto kernel = compiler.compile(recorder.graph());
+    auto buffer = forge::NodeValueBufferFactory::create(recorder.graph(), *kernel);
+
+    // the file's lanes are regrouped into batches of the kernel's width
+    forgeWithBatchWidth(buffer->getVectorWidth(), [&](auto w) {
+        constexpr Size W = decltype(w)::value;
+        ForgeBatchEvaluator<W> evaluator(*kernel, *buffer, inputs, {y.forgeNodeId()}, inputs);
+        std::vector<double> lanes(factors * W);
+
+        // chunks of 2 batches: the last of the 9 batches is a partial chunk
+        ForgeScenarioStream stream(file, 2);
+        BOOST_CHECK_EQUAL(stream.size(), timeSteps * file.batches());
+        ForgeScenarioStream::Batch batch;
+        Size expected = 0;
+        while (stream.next(batch)) {
+            BOOST_CHECK_EQUAL(batch.timeStep * file.batches() + batch.index, expected++);
+            BOOST_CHECK_EQUAL(batch.count, file.batchSize(batch.index));
+            for (Size first = 0; first < batch.count; first += W) {
+                Size count = std::min(W, batch.count - first);
+                for (Size f = 0; f < factors; ++f)
+                    for (Size lane = 0; lane < W; ++lane)
+                        lanes[f * W + lane] =
+                            batch.data[f * laneWidth + first + std::min(lane, count - 1)];
+                evaluator.loadInterleaved(lanes.data(), count);
+                evaluator.execute();
+                double values[W], gradients[W * factors];
+                evaluator.readOutputs(values, 1);
+                evaluator.readGradients(gradients, factors);
+                for (Size lane = 0; lane < count; ++lane) {
+                    Size p = batch.index * laneWidth + first + lane;
+                    double value = 0.0;
+                    for (Size f = 0; f < factors; ++f) {
+                        double s = scenarioValue(batch.timeStep, p, f);
+                        value += (f + 1.0) * s * s;
+                        BOOST_CHECK_CLOSE(gradients[lane * factors + f], 2.0 * (f + 1.0) * s, 1e-10);
+                    }
+                    BOOST_CHECK_CLOSE(values[lane], value, 1e-10);
+                }
+            }
+        }
+        BOOST_CHECK_EQUAL(expected, stream.size());
+        BOOST_CHECK(!stream.next(batch));
+    });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,114 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Sensitivity tensor layout tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/sensitivitytensor.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(SensitivityTensorForgeTests)
+
+BOOST_AUTO_TEST_CASE(testLayoutsFromGradientLanes) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing stored and aggregated sensitivity layouts...");
+
+    const Size factors = 3, dates = 2, paths = 11;
+
+    // y = sum_f (f + 1) x_f^2, so dy/dx_f = 2 (f + 1) x_f
+    forge::GraphRecorder recorder;
+    recorder.start();
+    std::vector<Real> x(factors, 0.0);
+    std::vector<forge::NodeId> inputs;
+    Real y = 0.0;
+    for (Size f = 0; f < factors; ++f) {
+        x[f].markForgeInputAndDiff();
+        inputs.push_back(x[f].forgeNodeId());
+        y += (f + 1.0) * x[f] * x[f];
+    }
+    y.markForgeOutput();
+    recorder.stop();
+    forge::ForgeEngine compiler;
+    auto kernel = compiler.compile(recorder.graph());
+    auto buffer = forge::NodeValueBufferFactory::create(recorder.graph(), *kernel);
+
+    auto scenario = [](Size t, Size p, Size f) { return 0.1 * (t + 1) + 0.01 * p - 0.2 * f; };
+    std::vector<double> rows(dates * paths * factors);
+    for (Size t = 0; t < dates; ++t)
+        for (Size p = 0; p < paths; ++p)
+            for (Size f = 0; f < factors; ++f)
+                rows[(t * paths + p) * factors + f] = scenario(t, p, f);
+
+    ForgeSensitivityTensor pathMajor(1, dates, paths, factors);
+    ForgeSensitivityTensor factorMajor(1, dates, paths, factors, ForgeSensitivityLayout::FactorMajor);
+    ForgeSensitivityTensor aggregated(1, dates, paths, factors, ForgeSensitivityLayout::Aggregated);
+    BOOST_CHECK_EQUAL(aggregated.size(), dates * factors);
+    BOOST_CHECK(!aggregated.storesPaths());
+
+    forgeWithBatchWidth(buffer->getVectorWidth(), [&](auto w) {
+        constexpr Size W = decltype(w)::value;
+        ForgeBatchEvaluator<W> evaluator(*kernel, *buffer, inputs, {y.forgeNodeId()}, inputs);
+        for (Size t = 0; t < dates; ++t) {
+            for (Size first = 0; first < paths; first += W) {
+                evaluator.load(rows.data() + t * paths * factors, factors, first,
+                               std::min(W, paths - first));
+                evaluator.execute();
+                pathMajor.add(0, t, first, evaluator);
+                factorMajor.add(0, t, first, evaluator);
+                aggregated.add(0, t, first, evaluator);
+            }
+        }
+    });
+
+    for (Size t = 0; t < dates; ++t) {
+        BOOST_CHECK_EQUAL(aggregated.count(0, t), paths);
+        for (Size f = 0; f < factors; ++f) {
+            double sum = 0.0;
+            for (Size p = 0; p < paths; ++p) {
+                const double expected = 2.0 * (f + 1.0) * scenario(t, p, f);
+                BOOST_CHECK_CLOSE(pathMajor(0, t, p, f), expected, 1e-10);
+                BOOST_CHECK_CLOSE(factorMajor(0, t, p, f), expected, 1e-10);
+                sum += expected;
+            }
+            BOOST_CHECK_CLOSE(aggregated.sum(0, t, f), sum, 1e-10);
+            BOOST_CHECK_CLOSE(aggregated.mean(0, t, f), pathMajor.mean(0, t, f), 1e-10);
+            BOOST_CHECK_CLOSE(factorMajor.sum(0, t, f), sum, 1e-10);
+        }
+    }
+
+    // rows added one path at a time go to the same places
+    ForgeSensitivityTensor scalar(1, dates, paths, factors, ForgeSensitivityLayout::Aggregated);
+    const double ones[factors] = {1.0, 1.0, 1.0};
+    scalar.addPath(0, 1, 4, ones);
+    scalar.addPath(0, 1, 5, ones);
+    BOOST_CHECK_EQUAL(scalar.sum(0, 1, 2), 2.0);
+    BOOST_CHECK_EQUAL(scalar.mean(0, 1, 2), 1.0);
+    BOOST_CHECK_THROW(scalar.mean(0, 0, 0), Error);
+    BOOST_CHECK_THROW(scalar.addPath(0, 1, paths, ones), Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,253 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Fused short-rate path and swap pricing kernel tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/termstructures/yield/zerocurve.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+#include <ql/forge/montecarlokernel.hpp>
+#include <ql/forge/shortratepaths.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(ShortRatePathsForgeTests)
+
+namespace {
+
+    const Integer pillarYears[] = {0, 1, 2, 3, 5, 7, 10};
+    const Size numPillars = 7;
+    // a 5y annual payer swap, valued on its reset dates
+    const Size swapYears = 5;
+    const double fixedRate = 0.025;
+
+    ext::shared_ptr<YieldTermStructure> initialCurve(std::vector<Real>& rates, bool mark) {
+        const Date today(15, January, 2025);
+        std::vector<Date> dates;
+        for (Size i = 0; i < numPillars; ++i) {
+            dates.push_back(today + pillarYears[i] * Years);
+            rates.push_back(0.02 + 0.002 * i);
+            if (mark)
+                rates[i].markForgeInputAndDiff();
+        }
+        auto curve = ext::make_shared<ZeroCurve>(dates, rates, Actual365Fixed());
+        curve->enableExtrapolation();
+        return curve;
+    }
+
+    // N [1 - P(t_k, T_n) - K sum_j P(t_k, T_j)] over the payments after t_k
+    template <class Discount>
+    Real swapValue(Size k, Discount discount) {
+        Real annuity = 0.0;
+        for (Size j = k + 2; j <= swapYears; ++j)
+            annuity += discount(double(j));
+        return 1.0 - discount(double(swapYears)) - fixedRate * annuity;
+    }
+
+    struct Recording {
+        forge::Graph graph;
+        std::vector<forge::NodeId> shocks, parameters, outputs;
+        std::vector<double> parameterValues;
+        Size numSteps;
+    };
+
+    // outputs: the summed positive exposure, the swap values, x and x + y at the last step
+    Recording record(ForgeShortRateModel model, double sigma, double eta) {
+        forge::GraphRecorder recorder;
+        recorder.start();
+        Recording rec;
+        ForgeG2Parameters params{0.05, sigma, 0.4, eta, -0.7};
+        rec.parameters = params.markInputs(model);
+        rec.parameterValues = {0.05, sigma, 0.4, eta, -0.7};
+        rec.parameterValues.resize(rec.parameters.size());
+        std::vector<Real> rates;
+        auto curve = initialCurve(rates, true);
+        for (const Real& r : rates) {
+            rec.parameters.push_back(r.forgeNodeId());
+            rec.parameterValues.push_back(r.getValue());
+        }
+
+        std::vector<Time> resets;
+        for (Size k = 1; k < swapYears; ++k)
+            resets.push_back(double(k));
+        ForgeShortRatePaths paths(params, *curve, resets, model);
+        rec.shocks = paths.shocks();
+        rec.numSteps = paths.numSteps();
+
+        std::vector<Real> values;
+        Real epe = 0.0;
+        for (Size k = 0; k < paths.numSteps(); ++k) {
+            values.push_back(swapValue(k, [&](double T) { return paths.discount(k, T); }));
+            epe += forge::expr::positive_part(values.back());
+        }
+        const Size last = paths.numSteps() - 1;
+        Real sum = paths.x(last) + paths.y(last);
+        std::vector<Real*> outputs = {&epe};
+        for (Real& v : values)
+            outputs.push_back(&v);
+        Real lastX = paths.x(last);
+        outputs.push_back(&lastX);
+        outputs.push_back(&sum);
+        for (Real* o : outputs) {
+            o->markForgeOutput();
+            rec.outputs.push_back(o->forgeNodeId());
+        }
+        recorder.stop();
+        rec.graph = recorder.graph();
+        return rec;
+    }
+
+    template <Size W>
+    ForgeMonteCarloResult run(ForgeKernel& kernel,
+                              ForgeBuffer& buffer,
+                              const Recording& rec,
+                              const std::vector<double>& parameters,
+                              Size paths) {
+        ForgeMonteCarloKernelRunner<W> runner(kernel, buffer, rec.shocks, rec.outputs,
+                                              rec.parameters, rec.parameters, 42);
+        runner.setParameters(parameters);
+        return runner.run(paths);
+    }
+
+    double variance(const ForgeMonteCarloResult& result, Size output) {
+        const double m = result.mean(output);
+        return result.sumSquares[output] / result.paths - m * m;
+    }
+
+    // covariance at t of two Ornstein-Uhlenbeck factors started at zero, whose
+    // Brownian motions have correlation rho; the variance of one for rho = 1
+    double ouCovariance(double a, double s, double b, double e, double rho, double t) {
+        return rho * s * e * (1.0 - std::exp(-(a + b) * t)) / (a + b);
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(testFactorDistribution) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing the distribution of recorded G2++ and Hull-White factors...");
+
+    const double t = double(swapYears - 1);
+    for (auto model : {ForgeShortRateModel::HullWhite, ForgeShortRateModel::G2}) {
+        const Recording rec = record(model, 0.01, 0.008);
+        const Size perStep = model == ForgeShortRateModel::G2 ? 2 : 1;
+        BOOST_CHECK_EQUAL(rec.shocks.size(), perStep * rec.numSteps);
+
+        forge::CompilerConfig config;
+        config.instructionSet = forge::CompilerConfig::InstructionSet::AVX2_PACKED;
+        forge::ForgeEngine compiler(config);
+        auto kernel = compiler.compile(rec.graph);
+        auto buffer = forge::NodeValueBufferFactory::create(rec.graph, *kernel);
+
+        const Size paths = 16384;
+        ForgeMonteCarloResult result = forgeWithBatchWidth(
+            buffer->getVectorWidth(), [&](auto w) {
+                return run<decltype(w)::value>(*kernel, *buffer, rec, rec.parameterValues, paths);
+            });
+        const Size xOutput = rec.numSteps + 1, sumOutput = rec.numSteps + 2;
+
+        // Var x = sigma^2 (1 - e^{-2at}) / 2a, and Var (x + y) adds Var y and 2 Cov(x, y)
+        const double vx = ouCovariance(0.05, 0.01, 0.05, 0.01, 1.0, t);
+        double vsum = vx;
+        if (model == ForgeShortRateModel::G2)
+            vsum += ouCovariance(0.4, 0.008, 0.4, 0.008, 1.0, t) +
+                    2.0 * ouCovariance(0.05, 0.01, 0.4, 0.008, -0.7, t);
+        BOOST_CHECK_SMALL(result.mean(xOutput), 4.0 * result.errorEstimate(xOutput));
+        BOOST_CHECK_CLOSE(variance(result, xOutput), vx, 5.0);
+        BOOST_CHECK_CLOSE(variance(result, sumOutput), vsum, 5.0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testForwardValuesInTheZeroVolatilityLimit) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing fused swap values against forward values for vanishing volatility...");
+
+    const Recording rec = record(ForgeShortRateModel::G2, 1e-7, 1e-7);
+    forge::ForgeEngine compiler;
+    auto kernel = compiler.compile(rec.graph);
+    auto buffer = forge::NodeValueBufferFactory::create(rec.graph, *kernel);
+    ForgeMonteCarloResult result = forgeWithBatchWidth(buffer->getVectorWidth(), [&](auto w) {
+        return run<decltype(w)::value>(*kernel, *buffer, rec, rec.parameterValues, 64);
+    });
+
+    std::vector<Real> rates;
+    auto curve = initialCurve(rates, false);
+    double epe = 0.0;
+    for (Size k = 0; k < rec.numSteps; ++k) {
+        const double tk = double(k + 1);
+        const double expected = value(swapValue(k, [&](double T) {
+            return curve->discount(T) / curve->discount(tk);
+        }));
+        BOOST_CHECK_SMALL(result.mean(k + 1) - expected, 1e-6);
+        epe += std::max(expected, 0.0);
+    }
+    BOOST_CHECK_SMALL(result.mean(0) - epe, 1e-5);
+}
+
+BOOST_AUTO_TEST_CASE(testSensitivitiesToModelAndCurve) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing fused-kernel sensitivities to G2++ parameters and curve pillars...");
+
+    // the volatilities are high enough for the exposure to cross zero on some paths
+    const Recording rec = record(ForgeShortRateModel::G2, 0.015, 0.01);
+    forge::CompilerConfig config;
+    config.instructionSet = forge::CompilerConfig::InstructionSet::AVX2_PACKED;
+    forge::ForgeEngine compiler(config);
+    auto kernel = compiler.compile(rec.graph);
+    auto buffer = forge::NodeValueBufferFactory::create(rec.graph, *kernel);
+    BOOST_REQUIRE_EQUAL(rec.parameters.size(), 5 + numPillars);
+
+    forgeWithBatchWidth(buffer->getVectorWidth(), [&](auto w) {
+        constexpr Size W = decltype(w)::value;
+        const Size paths = 1024;
+        ForgeMonteCarloResult base = run<W>(*kernel, *buffer, rec, rec.parameterValues, paths);
+        BOOST_CHECK(base.mean(0) > 0.0);
+
+        // central bumps on the same draws
+        for (Size g = 0; g < rec.parameters.size(); ++g) {
+            const double h = 1e-6;
+            std::vector<double> up = rec.parameterValues, down = rec.parameterValues;
+            up[g] += h;
+            down[g] -= h;
+            const double bumped = (run<W>(*kernel, *buffer, rec, up, paths).mean(0) -
+                                   run<W>(*kernel, *buffer, rec, down, paths).mean(0)) /
+                                  (2.0 * h);
+            BOOST_CHECK_SMALL(base.gradient(g) - bumped, 1e-4 * (1.0 + std::fabs(bumped)));
+        }
+    });
+
+    std::vector<Real> rates;
+    ForgeG2Parameters params{0.05, 0.01, 0.4, 0.008, -0.7};
+    auto curve = initialCurve(rates, false);
+    const std::vector<Time> decreasing = {1.0, 0.5}, times = {1.0};
+    BOOST_CHECK_THROW(ForgeShortRatePaths(params, *curve, decreasing), Error);
+    params.eta = 0.0;
+    BOOST_CHECK_THROW(ForgeShortRatePaths(params, *curve, times), Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,185 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Special function intrinsics and boost::math coverage tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/math/distributions/normaldistribution.hpp>
+#include <boost/math/special_functions/beta.hpp>
+#include <boost/math/special_functions/erf.hpp>
+#include <boost/math/special_functions/expm1.hpp>
+#include <boost/math/special_functions/gamma.hpp>
+#include <boost/math/special_functions/log1p.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <cmath>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(SpecialFunctionsForgeTests)
+
+namespace {
+
+    typedef std::function<Real(const Real&)> Function;
+
+    // records f once at x0 and returns its value and derivative at each of xs
+    void evaluateRecorded(const Function& f, double x0, const std::vector<double>& xs,
+                          std::vector<double>& values, std::vector<double>& derivatives) {
+        forge::GraphRecorder recorder;
+        recorder.start();
+        Real x = x0;
+        x.markForgeInputAndDiff();
+        forge::NodeId xId = x.forgeNodeId();
+        Real y = f(x);
+        y.markForgeOutput();
+        forge::NodeId yId = y.forgeNodeId();
+        recorder.stop();
+        forge::Graph graph = recorder.graph();
+
+        forge::ForgeEngine compiler;
+        auto kernel = compiler.compile(graph);
+        auto buffer = forge::NodeValueBufferFactory::create(graph, *kernel);
+        const Size width = buffer->getVectorWidth();
+        std::vector<double> in(width), out(width), grad(width);
+        std::vector<size_t> gradientIndex = {buffer->getBufferIndex(xId)};
+        values.clear();
+        derivatives.clear();
+        for (double xv : xs) {
+            std::fill(in.begin(), in.end(), xv);
+            buffer->setLanes(xId, in.data());
+            buffer->clearGradients();
+            kernel->execute(*buffer);
+            buffer->getLanes(yId, out.data());
+            buffer->getGradientLanes(gradientIndex, grad.data());
+            values.push_back(out[0]);
+            derivatives.push_back(grad[0]);
+        }
+    }
+
+    bool close(double a, double b, double tolerance) {
+        return std::fabs(a - b) <= tolerance * std::max(1.0, std::fabs(b));
+    }
+
+    struct EntryPoint {
+        std::string name;
+        Function recorded;
+        std::function<double(double)> reference;
+        double x0, x1;
+        bool intrinsic;  // recorded through ForgeSpecialFunctions.hpp
+    };
+
+}
+
+BOOST_AUTO_TEST_CASE(testNormalDistributionIntrinsics) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing the normal distribution intrinsics across their range...");
+
+    CumulativeNormalDistribution cdf;
+    NormalDistribution pdf;
+    InverseCumulativeNormal inverse;
+    std::vector<double> values, derivatives;
+
+    std::vector<double> xs = {-12.0, -6.5, -2.0, -0.3, 0.0, 0.7, 3.0, 9.0};
+    evaluateRecorded([](const Real& x) { return Real(forge::expr::normcdf(x)); }, 0.5, xs, values,
+                     derivatives);
+    for (Size i = 0; i < xs.size(); ++i) {
+        double expectedValue = value(cdf(Real(xs[i]))), expectedDerivative = value(pdf(Real(xs[i])));
+        BOOST_CHECK_MESSAGE(std::fabs(values[i] - expectedValue) <= 1e-12 * expectedValue,
+                            "normcdf(" << xs[i] << "): " << values[i] << ", expected "
+                                       << expectedValue);
+        QL_CHECK_CLOSE(Real(derivatives[i]), Real(expectedDerivative), 1e-10);
+    }
+
+    std::vector<double> ps = {1e-12, 1e-5, 0.02, 0.3, 0.5, 0.8, 0.99, 1.0 - 1e-9};
+    evaluateRecorded([](const Real& p) { return Real(forge::expr::inverse_normcdf(p)); }, 0.4, ps,
+                     values, derivatives);
+    for (Size i = 0; i < ps.size(); ++i) {
+        double expectedValue = value(inverse(Real(ps[i])));
+        // QuantLib's InverseCumulativeNormal is accurate to about 1e-9 without refinement
+        BOOST_CHECK_MESSAGE(close(values[i], expectedValue, 1e-8),
+                            "inverse_normcdf(" << ps[i] << "): " << values[i] << ", expected "
+                                               << expectedValue);
+        QL_CHECK_CLOSE(Real(derivatives[i]), Real(1.0 / value(pdf(Real(values[i])))), 1e-6);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testBoostSpecialFunctionCoverage) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing which boost::math entry points are recorded in Forge graphs...");
+
+    // each entry point is recorded at x0 and re-evaluated at x1; one that is
+    // opaque to the graph returns the recorded branch or a constant there
+    std::vector<EntryPoint> entryPoints = {
+        {"erf", [](const Real& x) { return Real(boost::math::erf(x)); },
+         [](double x) { return boost::math::erf(x); }, 0.3, -1.7, true},
+        {"erfc", [](const Real& x) { return Real(boost::math::erfc(x)); },
+         [](double x) { return boost::math::erfc(x); }, 0.3, 3.4, true},
+        {"erf_inv", [](const Real& x) { return Real(boost::math::erf_inv(x)); },
+         [](double x) { return boost::math::erf_inv(x); }, 0.3, -0.9, true},
+        {"erfc_inv", [](const Real& x) { return Real(boost::math::erfc_inv(x)); },
+         [](double x) { return boost::math::erfc_inv(x); }, 0.3, 1.9, true},
+        {"log1p", [](const Real& x) { return Real(boost::math::log1p(x)); },
+         [](double x) { return boost::math::log1p(x); }, 0.3, 1e-3, true},
+        {"expm1", [](const Real& x) { return Real(boost::math::expm1(x)); },
+         [](double x) { return boost::math::expm1(x); }, 0.3, -1e-3, true},
+        {"tgamma", [](const Real& x) { return Real(boost::math::tgamma(x)); },
+         [](double x) { return boost::math::tgamma(x); }, 0.3, 4.5, true},
+        {"lgamma", [](const Real& x) { return Real(boost::math::lgamma(x)); },
+         [](double x) { return boost::math::lgamma(x); }, 0.3, 14.5, true},
+        {"beta", [](const Real& x) { return Real(boost::math::beta(x, Real(2.5))); },
+         [](double x) { return boost::math::beta(x, 2.5); }, 0.3, 3.5, true},
+        {"gamma_p", [](const Real& x) { return Real(boost::math::gamma_p(Real(2.5), x)); },
+         [](double x) { return boost::math::gamma_p(2.5, x); }, 0.3, 3.5, false},
+        {"gamma_q", [](const Real& x) { return Real(boost::math::gamma_q(Real(2.5), x)); },
+         [](double x) { return boost::math::gamma_q(2.5, x); }, 0.3, 3.5, false},
+        {"gamma_p_inv", [](const Real& x) { return Real(boost::math::gamma_p_inv(Real(2.5), x)); },
+         [](double x) { return boost::math::gamma_p_inv(2.5, x); }, 0.3, 0.8, false},
+        {"ibeta", [](const Real& x) { return Real(boost::math::ibeta(Real(2.5), Real(3.5), x)); },
+         [](double x) { return boost::math::ibeta(2.5, 3.5, x); }, 0.3, 0.8, false},
+        {"ibeta_inv",
+         [](const Real& x) { return Real(boost::math::ibeta_inv(Real(2.5), Real(3.5), x)); },
+         [](double x) { return boost::math::ibeta_inv(2.5, 3.5, x); }, 0.3, 0.8, false},
+    };
+
+    std::vector<std::string> opaque;
+    std::vector<double> values, derivatives;
+    for (const auto& e : entryPoints) {
+        evaluateRecorded(e.recorded, e.x0, {e.x1}, values, derivatives);
+        bool tracked = close(values[0], e.reference(e.x1), 1e-12);
+        if (e.intrinsic)
+            BOOST_CHECK_MESSAGE(tracked, e.name << "(" << e.x1 << "): " << values[0]
+                                                << ", expected " << e.reference(e.x1));
+        if (!tracked)
+            opaque.push_back(e.name);
+    }
+    std::string list;
+    for (const auto& name : opaque)
+        list += " " + name;
+    BOOST_TEST_MESSAGE("  graph-opaque boost::math entry points:" << (list.empty() ? " none" : list));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
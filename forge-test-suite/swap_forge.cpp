@@ -20,6 +20,7 @@
 
 #include "toplevelfixture.hpp"
 #include "utilities_forge.hpp"
+#include "perf_forge.hpp"
 #include <ql/cashflows/couponpricer.hpp>
 #include <ql/cashflows/fixedratecoupon.hpp>
 #include <ql/cashflows/iborcoupon.hpp>
@@ -227,6 +228,11 @@ BOOST_AUTO_TEST_CASE(testSwapDerivatives) {
     QL_CHECK_CLOSE(derivatives_Bumping.s, derivatives_forge.s, 1e-3);
     QL_CHECK_CLOSE(derivatives_Bumping.g, derivatives_forge.g, 1e-3);
     QL_CHECK_CLOSE(derivatives_Bumping.v, derivatives_forge.v, 1e-3);
+
+    // kernel-versus-QuantLib timing, under --forge_perf
+    forgePerfMeasure("swap", data,
+                     {&SwapData::n, &SwapData::s, &SwapData::g, &SwapData::v},
+                     priceSwap);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,201 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Tape-based AAD and backend selection tests.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/tapeaad.hpp>
+#include <boost/math/special_functions/beta.hpp>
+#include <boost/math/special_functions/erf.hpp>
+#include <boost/math/special_functions/expm1.hpp>
+#include <boost/math/special_functions/gamma.hpp>
+#include <boost/math/special_functions/log1p.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(TapeAadForgeTests)
+
+namespace {
+
+    // copies, in-place updates and reassignment of a variable in its own expression
+    Real price(const Real* x) {
+        Real y = exp(x[0]) * x[1];
+        Real z = y;
+        z += x[0] * x[0] / x[1];
+        z = z * 2.0 + sqrt(x[1]);
+        z *= x[0];
+        return z;
+    }
+
+    double value(const double* x) {
+        return (2.0 * (std::exp(x[0]) * x[1] + x[0] * x[0] / x[1]) + std::sqrt(x[1])) * x[0];
+    }
+
+    void gradient(const double* x, double* g) {
+        const double e = std::exp(x[0]), inner = e * x[1] + x[0] * x[0] / x[1];
+        g[0] = 2.0 * inner + std::sqrt(x[1]) + x[0] * 2.0 * (e * x[1] + 2.0 * x[0] / x[1]);
+        g[1] = x[0] * (2.0 * (e - x[0] * x[0] / (x[1] * x[1])) + 0.5 / std::sqrt(x[1]));
+    }
+
+    // the helpers computing on passive values and recording their Forge side apart
+    template <class R>
+    R specialFunctions(const R* x) {
+        const R b(1.5), h = 0.5 * x[0];
+        return boost::math::erf(x[0]) * x[1] + boost::math::erfc(x[0]) * boost::math::tgamma(x[1]) +
+               boost::math::lgamma(x[1]) + boost::math::expm1(h) +
+               boost::math::log1p(x[1]) + boost::math::beta(x[1], b) +
+               forge::expr::horner(x[0], {1.0, 0.5, -0.25, 0.125});
+    }
+
+}
+
+#ifndef FEXPR_NO_TAPE
+BOOST_AUTO_TEST_CASE(testTapeGradients) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing gradients recorded on the operator-overloading tape...");
+
+    typedef Real::tape_type tape_type;
+    const double x0[2] = {0.3, 1.7};
+    std::vector<Real> x(x0, x0 + 2);
+
+    BOOST_CHECK_THROW(derivative(x[0]), forge::expr::NoTapeException);
+
+    tape_type tape;
+    BOOST_CHECK(tape_type::getActive() == &tape);
+    tape.registerInputs(x);
+    tape.newRecording();
+    Real y = price(x.data());
+    tape.registerOutput(y);
+    derivative(y) = 1.0;
+    tape.computeAdjoints();
+
+    double expected[2];
+    gradient(x0, expected);
+    BOOST_CHECK_CLOSE(y.getValue(), value(x0), 1e-12);
+    BOOST_CHECK_CLOSE(derivative(x[0]), expected[0], 1e-10);
+    BOOST_CHECK_CLOSE(derivative(x[1]), expected[1], 1e-10);
+    BOOST_CHECK(tape.getNumStatements() > 0);
+
+    // a passive value is a constant to the tape
+    Real c = 2.0;
+    Real d = c * x[0];
+    BOOST_CHECK(!c.shouldRecord());
+    BOOST_CHECK(d.shouldRecord());
+    d = 4.0;
+    BOOST_CHECK(!d.shouldRecord());
+
+    // a new recording on the same inputs gives the same gradients
+    tape.newRecording();
+    Real w = price(x.data());
+    derivative(w) = 1.0;
+    tape.computeAdjoints();
+    BOOST_CHECK_CLOSE(derivative(x[0]), expected[0], 1e-10);
+    BOOST_CHECK_CLOSE(derivative(x[1]), expected[1], 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(testTapedSpecialFunctions) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing taped special functions and horner() against the kernel...");
+
+    const Size count = 4;
+    std::vector<double> scenarios(2 * count);
+    for (Size i = 0; i < count; ++i) {
+        scenarios[2 * i] = -0.6 + 0.4 * i;
+        scenarios[2 * i + 1] = 0.7 + 0.5 * i;
+    }
+    const ForgeActiveFunction f = [](const Real* x) { return specialFunctions(x); };
+
+    ForgeAadSelectorOptions options;
+    options.breakEvenScenarios = count + 1;
+    std::vector<double> tapeValues(count), tapeGradients(2 * count);
+    BOOST_CHECK(forgeEvaluateAad(2, f, scenarios.data(), count, 2, tapeValues.data(),
+                                 tapeGradients.data(), options) == ForgeAadBackend::Tape);
+    options.breakEvenScenarios = 0;
+    std::vector<double> kernelValues(count), kernelGradients(2 * count);
+    BOOST_CHECK(forgeEvaluateAad(2, f, scenarios.data(), count, 2, kernelValues.data(),
+                                 kernelGradients.data(), options) == ForgeAadBackend::Kernel);
+
+    for (Size i = 0; i < count; ++i) {
+        const double* x = &scenarios[2 * i];
+        BOOST_CHECK_CLOSE(tapeValues[i], specialFunctions(x), 1e-12);
+        for (Size k = 0; k < 2; ++k) {
+            const double h = 1e-6;
+            double up[2] = {x[0], x[1]}, down[2] = {x[0], x[1]};
+            up[k] += h;
+            down[k] -= h;
+            const double bumped = (specialFunctions(up) - specialFunctions(down)) / (2.0 * h);
+            BOOST_CHECK_CLOSE(tapeGradients[2 * i + k], bumped, 1e-5);
+            BOOST_CHECK_CLOSE(tapeGradients[2 * i + k], kernelGradients[2 * i + k], 1e-9);
+        }
+    }
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(testBackendSelection) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing tape and kernel AAD backends selected by reuse count...");
+
+    const Size count = 6;
+    std::vector<double> scenarios(2 * count);
+    for (Size i = 0; i < count; ++i) {
+        scenarios[2 * i] = -0.5 + 0.2 * i;
+        scenarios[2 * i + 1] = 0.8 + 0.3 * i;
+    }
+
+    ForgeAadSelectorOptions options;
+    options.breakEvenScenarios = count + 1;
+    std::vector<double> tapeValues(count), tapeGradients(2 * count);
+    // without the tape every count is compiled
+    BOOST_CHECK(forgeEvaluateAad(2, price, scenarios.data(), count, 2, tapeValues.data(),
+                                 tapeGradients.data(), options) ==
+                (forgeTapeAvailable ? ForgeAadBackend::Tape : ForgeAadBackend::Kernel));
+
+    options.breakEvenScenarios = count;
+    std::vector<double> kernelValues(count), kernelGradients(2 * count);
+    BOOST_CHECK(forgeEvaluateAad(2, price, scenarios.data(), count, 2, kernelValues.data(),
+                                 kernelGradients.data(), options) == ForgeAadBackend::Kernel);
+
+    for (Size i = 0; i < count; ++i) {
+        const double* x = &scenarios[2 * i];
+        double expected[2];
+        gradient(x, expected);
+        BOOST_CHECK_CLOSE(tapeValues[i], value(x), 1e-12);
+        BOOST_CHECK_CLOSE(kernelValues[i], value(x), 1e-12);
+        for (Size k = 0; k < 2; ++k) {
+            BOOST_CHECK_CLOSE(tapeGradients[2 * i + k], expected[k], 1e-10);
+            BOOST_CHECK_CLOSE(kernelGradients[2 * i + k], expected[k], 1e-10);
+        }
+    }
+
+    BOOST_CHECK_EQUAL(forgeBreakEvenScenarios(3.0, 0.75, 0.25), 6U);
+    BOOST_CHECK_EQUAL(forgeBreakEvenScenarios(1.0, 0.01, 0.01), std::numeric_limits<Size>::max());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
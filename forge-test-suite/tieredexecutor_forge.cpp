@@ -0,0 +1,235 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Tiered execution tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/tapeaad.hpp>
+#include <ql/forge/tieredexecutor.hpp>
+#include <expressions/abool.hpp>
+#include <expressions/abool_helpers.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(TieredExecutorForgeTests)
+
+namespace {
+
+    // the same function for recording and for the direct tier
+    template <class T>
+    T price(const T& x0, const T& x1) {
+        return x0 * x1 + 3.0 * x0;
+    }
+
+    // a graph with every operation the interpreter knows, the NPV as first output
+    struct Recording {
+        forge::Graph graph;
+        std::vector<forge::NodeId> inputs, outputs;
+    };
+
+    Recording record() {
+        forge::GraphRecorder recorder;
+        recorder.start();
+        Recording rec;
+        const Size n = 4;
+        std::vector<Real> x(n);
+        Real inner = 0.0;
+        for (Size i = 0; i < n; ++i) {
+            x[i] = 0.5 + i;
+            x[i].markForgeInputAndDiff();
+            rec.inputs.push_back(x[i].forgeNodeId());
+            inner += sqrt(x[i]) * log(1.0 + x[i]) - x[i] / (2.0 + i);
+        }
+        Real used = exp(-x[0] * x[1]) + max(x[2], x[3]) - abs(x[1] - x[2]);
+        forge::ABool cond = forge::greaterEqual(x[0].forgeValue(), x[3].forgeValue());
+        Real product = x[0] * x[2], power = pow(x[3], x[1]);
+        Real selected = cond.If(product, power);
+        Real npv = inner + used * selected - min(used, x[1]) + x[2] * x[3] + x[0];
+        npv.markForgeOutput();
+        used.markForgeOutput();
+        recorder.stop();
+        rec.graph = recorder.graph();
+        rec.outputs = {npv.forgeNodeId(), used.forgeNodeId()};
+        return rec;
+    }
+
+}
+
+#ifndef FEXPR_NO_TAPE
+BOOST_AUTO_TEST_CASE(testTiersAgreeAcrossTheSwitch) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing the switch from direct evaluation to the compiled kernel...");
+
+    forge::GraphRecorder recorder;
+    recorder.start();
+    Real x0 = 1.0, x1 = 2.0;
+    x0.markForgeInputAndDiff();
+    x1.markForgeInputAndDiff();
+    Real y = price(x0, x1);
+    y.markForgeOutput();
+    recorder.stop();
+    const std::vector<forge::NodeId> inputs = {x0.forgeNodeId(), x1.forgeNodeId()};
+
+    ForgeCompilePipeline pipeline;
+    ForgeTieredOptions options;
+    options.waitAfter = 5;
+    // the first tier tapes the same pricing code, with exact gradients
+    Size directCalls = 0;
+    ForgeDirectEvaluator taped =
+        forgeTapeEvaluator(2, [](const Real* x) { return price(x[0], x[1]); });
+    ForgeTieredExecutor executor(
+        pipeline, recorder.graph(), inputs, {y.forgeNodeId()}, inputs,
+        [&](const double* x, double* out, double* gradients) {
+            ++directCalls;
+            taped(x, out, gradients);
+        },
+        options);
+
+    // evaluate one scenario at a time, as a what-if service would
+    const Size scenarios = 9;
+    for (Size i = 0; i < scenarios; ++i) {
+        const double x[2] = {0.5 + i, 2.0 - 0.25 * i};
+        double out, gradients[2];
+        executor.evaluate(x, 1, 2, &out, gradients);
+        BOOST_CHECK_CLOSE(out, price(x[0], x[1]), 1e-12);
+        BOOST_CHECK_CLOSE(gradients[0], x[1] + 3.0, 1e-12);
+        BOOST_CHECK_CLOSE(gradients[1], x[0], 1e-12);
+    }
+
+    // at most waitAfter scenarios went through the direct tier
+    BOOST_CHECK(executor.compiled());
+    BOOST_CHECK(executor.directScenarios() <= options.waitAfter);
+    BOOST_CHECK_EQUAL(executor.directScenarios(), directCalls);
+    BOOST_CHECK_EQUAL(executor.directScenarios() + executor.kernelScenarios(), scenarios);
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(testBumpedDirectEvaluator) {
+
+    BOOST_TEST_MESSAGE("Testing forward-difference direct evaluators...");
+
+    ForgeDirectEvaluator direct = forgeBumpedEvaluator(
+        2, [](const double* x) { return price(x[0], x[1]); }, 1e-7);
+    const double x[2] = {1.5, -0.5};
+    double out, gradients[2];
+    direct(x, &out, gradients);
+    BOOST_CHECK_CLOSE(out, price(x[0], x[1]), 1e-12);
+    BOOST_CHECK_CLOSE(gradients[0], x[1] + 3.0, 1e-4);
+    BOOST_CHECK_CLOSE(gradients[1], x[0], 1e-4);
+    direct(x, &out, nullptr);
+    BOOST_CHECK_CLOSE(out, price(x[0], x[1]), 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(testGraphInterpreterMatchesKernel) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing the graph interpreter against the compiled kernel...");
+
+    const Recording rec = record();
+    ForgeGraphInterpreter interpreter(rec.graph, rec.inputs, rec.outputs, rec.inputs);
+    BOOST_REQUIRE(interpreter.supported());
+
+    forge::ForgeEngine compiler;
+    auto kernel = compiler.compile(rec.graph);
+    auto buffer = forge::NodeValueBufferFactory::create(rec.graph, *kernel);
+
+    // both sides of the select, over random scenarios
+    std::mt19937_64 rng(23);
+    std::uniform_real_distribution<double> uniform(0.1, 4.0);
+    const Size n = rec.inputs.size();
+    for (Size k = 0; k < 20; ++k) {
+        std::vector<double> x(n);
+        for (double& xi : x)
+            xi = uniform(rng);
+        std::vector<double> outputs(2), gradients(n), expectedOutputs(2), expectedGradients(n);
+        interpreter(x.data(), outputs.data(), gradients.data());
+        forgeEvaluateBatched(*kernel, *buffer, rec.inputs, rec.outputs, rec.inputs, x.data(), 1, n,
+                             expectedOutputs.data(), expectedGradients.data());
+        for (Size j = 0; j < 2; ++j)
+            BOOST_CHECK_SMALL(outputs[j] - expectedOutputs[j],
+                              1e-12 * std::max(1.0, std::fabs(expectedOutputs[j])));
+        for (Size i = 0; i < n; ++i)
+            BOOST_CHECK_SMALL(gradients[i] - expectedGradients[i],
+                              1e-12 * std::max(1.0, std::fabs(expectedGradients[i])));
+        // values only
+        std::vector<double> valuesOnly(2);
+        interpreter(x.data(), valuesOnly.data(), nullptr);
+        BOOST_CHECK_EQUAL(valuesOnly[0], outputs[0]);
+    }
+
+    // an active node of an operation no probe recorded cannot be interpreted
+    std::uint32_t unknown = 0;
+    while (forgeOpcodeTable().count(unknown) != 0)
+        ++unknown;
+    forge::Graph foreign = rec.graph;
+    for (auto& node : foreign.nodes)
+        if (node.isActive && node.op != forge::OpCode::Input) {
+            node.op = static_cast<forge::OpCode>(unknown);
+            break;
+        }
+    ForgeGraphInterpreter unsupported(foreign, rec.inputs, rec.outputs, rec.inputs);
+    BOOST_CHECK(!unsupported.supported());
+    std::vector<double> x(n, 1.0), outputs(2);
+    BOOST_CHECK_THROW(unsupported(x.data(), outputs.data(), nullptr), Error);
+}
+
+BOOST_AUTO_TEST_CASE(testInterpretedFirstTier) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing a tiered executor given only the recorded graph...");
+
+    const Recording rec = record();
+    ForgeGraphInterpreter reference(rec.graph, rec.inputs, rec.outputs, rec.inputs);
+    ForgeCompilePipeline pipeline;
+    ForgeTieredOptions options;
+    options.waitAfter = 0;
+    ForgeTieredExecutor executor(pipeline, rec.graph, rec.inputs, rec.outputs, rec.inputs, options);
+    BOOST_CHECK(executor.hasDirectTier());
+
+    const Size n = rec.inputs.size(), scenarios = 6;
+    for (Size k = 0; k < scenarios; ++k) {
+        if (k == scenarios / 2)
+            executor.waitForKernel();
+        const std::vector<double> x = {0.5 + 0.25 * k, 1.5, 2.5 - 0.3 * k, 3.5};
+        std::vector<double> outputs(2), gradients(n), expectedOutputs(2), expectedGradients(n);
+        executor.evaluate(x.data(), 1, n, outputs.data(), gradients.data());
+        reference(x.data(), expectedOutputs.data(), expectedGradients.data());
+        for (Size j = 0; j < 2; ++j)
+            BOOST_CHECK_SMALL(outputs[j] - expectedOutputs[j],
+                              1e-12 * std::max(1.0, std::fabs(expectedOutputs[j])));
+        for (Size i = 0; i < n; ++i)
+            BOOST_CHECK_SMALL(gradients[i] - expectedGradients[i],
+                              1e-12 * std::max(1.0, std::fabs(expectedGradients[i])));
+    }
+    BOOST_CHECK(executor.compiled());
+    BOOST_CHECK(executor.kernelScenarios() >= scenarios - scenarios / 2);
+    BOOST_CHECK_EQUAL(executor.directScenarios() + executor.kernelScenarios(), scenarios);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
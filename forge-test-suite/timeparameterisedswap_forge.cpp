@@ -0,0 +1,169 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Time-parameterised swap tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/forge/timeparameterisedswap.hpp>
+#include <ql/cashflows/fixedratecoupon.hpp>
+#include <ql/cashflows/iborcoupon.hpp>
+#include <ql/currencies/europe.hpp>
+#include <ql/indexes/iborindex.hpp>
+#include <ql/pricingengines/swap/discountingswapengine.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/calendars/nullcalendar.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+#include <ql/time/schedule.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(TimeParameterisedSwapForgeTests)
+
+namespace {
+
+    // fixed-payer swap with annual fixed and semiannual floating legs
+    struct SwapSetup {
+        RelinkableHandle<YieldTermStructure> curve;
+        ext::shared_ptr<Swap> swap;
+    };
+
+    SwapSetup makeSwap(const Real& rate, Size years) {
+        SwapSetup s;
+        Date today = Settings::instance().evaluationDate();
+        DayCounter dayCounter = Actual365Fixed();
+        s.curve.linkTo(ext::make_shared<FlatForward>(today, rate, dayCounter));
+        auto index = ext::make_shared<IborIndex>("dummy", 6 * Months, 0, EURCurrency(),
+                                                 NullCalendar(), Unadjusted, false, dayCounter,
+                                                 s.curve);
+        Date maturity = today + Integer(years) * Years;
+        Schedule fixedSchedule(today, maturity, Period(Annual), NullCalendar(), Unadjusted,
+                               Unadjusted, DateGeneration::Forward, false);
+        Schedule floatSchedule(today, maturity, Period(Semiannual), NullCalendar(), Unadjusted,
+                               Unadjusted, DateGeneration::Forward, false);
+        Leg fixedLeg = FixedRateLeg(fixedSchedule)
+                           .withNotionals(1000000.0)
+                           .withCouponRates(0.03, dayCounter);
+        Leg floatingLeg = IborLeg(floatSchedule, index)
+                              .withNotionals(1000000.0)
+                              .withPaymentDayCounter(dayCounter)
+                              .withFixingDays(0);
+        s.swap = ext::make_shared<Swap>(fixedLeg, floatingLeg);
+        return s;
+    }
+
+    // records npv(t) once, with the rate and t as inputs, and evaluates it for
+    // one evaluation time per lane
+    std::vector<double> timedKernelNpvs(double rate, const std::vector<double>& times,
+                                        ForgeCashflowMask mask) {
+        Date today = Settings::instance().evaluationDate();
+        forge::GraphRecorder recorder;
+        recorder.start();
+        Real r = rate;
+        r.markForgeInput();
+        Real t = times.front();
+        t.markForgeInput();
+        forge::NodeId rId = r.forgeNodeId(), tId = t.forgeNodeId();
+        SwapSetup s = makeSwap(r, 5);
+        ForgeTimeParameterisedSwap timed(*s.swap, today, Actual365Fixed(), mask);
+        Real npv = timed.npv(t, **s.curve);
+        npv.markForgeOutput();
+        forge::NodeId npvId = npv.forgeNodeId();
+        recorder.stop();
+        forge::Graph graph = recorder.graph();
+
+        forge::ForgeEngine compiler;
+        auto kernel = compiler.compile(graph);
+        auto buffer = forge::NodeValueBufferFactory::create(graph, *kernel);
+        const Size width = buffer->getVectorWidth();
+        std::vector<double> npvs;
+        std::vector<double> rLanes(width, rate), tLanes(width), out(width);
+        for (Size first = 0; first < times.size(); first += width) {
+            for (Size lane = 0; lane < width; ++lane)
+                tLanes[lane] = times[std::min(first + lane, times.size() - 1)];
+            buffer->setLanes(rId, rLanes.data());
+            buffer->setLanes(tId, tLanes.data());
+            kernel->execute(*buffer);
+            buffer->getLanes(npvId, out.data());
+            for (Size lane = 0; lane < width && first + lane < times.size(); ++lane)
+                npvs.push_back(out[lane]);
+        }
+        return npvs;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(testSingleKernelAcrossTimeSteps) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing one time-parameterised swap kernel across time steps...");
+
+    Date today(15, January, 2025);
+    Settings::instance().evaluationDate() = today;
+    const double rate = 0.025;
+
+    SwapSetup s = makeSwap(rate, 5);
+    ForgeTimeParameterisedSwap timed(*s.swap, today, Actual365Fixed());
+    BOOST_CHECK_EQUAL(timed.numCashflows(), 15U);
+
+    // time steps between and on payment dates, and after maturity
+    std::vector<double> times = {0.0, 0.3, 0.75, 1.0, 2.2, 3.6, 4.9, 6.0};
+    std::vector<double> npvs = timedKernelNpvs(rate, times, ForgeCashflowMask::PaidAfter);
+    BOOST_REQUIRE_EQUAL(npvs.size(), times.size());
+    for (Size i = 0; i < times.size(); ++i) {
+        Real expected = timed.npv(Real(times[i]), **s.curve);
+        BOOST_TEST_MESSAGE("  t = " << times[i] << ": " << npvs[i]);
+        QL_CHECK_CLOSE(Real(npvs[i]), expected, 1e-10);
+    }
+
+    // all flows are alive at t = 0, none after the last payment
+    s.swap->setPricingEngine(ext::make_shared<DiscountingSwapEngine>(s.curve));
+    QL_CHECK_CLOSE(Real(npvs.front()), s.swap->NPV(), 1e-10);
+    BOOST_CHECK(times.back() > timed.lastPaymentTime());
+    BOOST_CHECK_SMALL(npvs.back(), 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(testMaturityHorizonMask) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing the maturity-horizon mask against shortened swaps...");
+
+    Date today(15, January, 2025);
+    Settings::instance().evaluationDate() = today;
+    const double rate = 0.025;
+
+    // horizons just after the payment dates of the 1Y to 4Y swaps
+    std::vector<double> horizons = {1.1, 2.1, 3.1, 4.1};
+    std::vector<double> npvs =
+        timedKernelNpvs(rate, horizons, ForgeCashflowMask::PaidOnOrBefore);
+    BOOST_REQUIRE_EQUAL(npvs.size(), horizons.size());
+    for (Size i = 0; i < horizons.size(); ++i) {
+        SwapSetup shortened = makeSwap(rate, i + 1);
+        shortened.swap->setPricingEngine(
+            ext::make_shared<DiscountingSwapEngine>(shortened.curve));
+        QL_CHECK_CLOSE(Real(npvs[i]), shortened.swap->NPV(), 1e-10);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
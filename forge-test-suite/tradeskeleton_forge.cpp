@@ -0,0 +1,210 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*******************************************************************************
+
+   Cached trade skeleton tests using Forge.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+#include "toplevelfixture.hpp"
+#include "utilities_forge.hpp"
+#include <ql/indexes/ibor/euribor.hpp>
+#include <ql/instruments/vanillaswap.hpp>
+#include <ql/pricingengines/swap/discountingswapengine.hpp>
+#include <ql/termstructures/yield/zerocurve.hpp>
+#include <ql/time/calendars/target.hpp>
+#include <ql/time/daycounters/actual360.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+#include <ql/time/schedule.hpp>
+#include <ql/forge/batchevaluator.hpp>
+#include <ql/forge/kernelcache.hpp>
+#include <ql/forge/tradeskeleton.hpp>
+
+// Forge integration headers
+#include <graph/graph_recorder.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantLibForgeRisksTests, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(TradeSkeletonForgeTests)
+
+namespace {
+
+    struct SwapTerms {
+        Integer years;
+        Period fixedFrequency, floatFrequency;
+        double notional, fixedRate, spread;
+    };
+
+    const SwapTerms swapTerms[] = {
+        {5, Period(1, Years), Period(6, Months), 1000000.0, 0.03, 0.001},
+        {10, Period(6, Months), Period(3, Months), 2000000.0, 0.035, 0.0015}};
+
+    const Integer pillarYears[] = {1, 2, 3, 5, 7, 10, 15};
+    const Size numPillars = 7;
+
+    using SkeletonCache = ForgeSkeletonCache<Size, ForgeSwapSkeleton>;
+
+    std::vector<Date> pillarDates() {
+        const Calendar calendar = TARGET();
+        const Date today = Settings::instance().evaluationDate();
+        std::vector<Date> dates = {today};
+        for (Integer years : pillarYears)
+            dates.push_back(calendar.advance(today, years, Years));
+        return dates;
+    }
+
+    ext::shared_ptr<VanillaSwap> buildSwap(const SwapTerms& terms,
+                                           const Handle<YieldTermStructure>& curve) {
+        const Calendar calendar = TARGET();
+        auto index = ext::make_shared<Euribor6M>(curve);
+        const Date start = calendar.advance(Settings::instance().evaluationDate(),
+                                            index->fixingDays(), Days);
+        const Date maturity = calendar.advance(start, terms.years, Years);
+        Schedule fixedSchedule(start, maturity, terms.fixedFrequency, calendar, ModifiedFollowing,
+                               ModifiedFollowing, DateGeneration::Forward, false);
+        Schedule floatSchedule(start, maturity, terms.floatFrequency, calendar, ModifiedFollowing,
+                               ModifiedFollowing, DateGeneration::Forward, false);
+        auto swap = ext::make_shared<VanillaSwap>(VanillaSwap::Payer, terms.notional, fixedSchedule,
+                                                  terms.fixedRate, Actual365Fixed(), floatSchedule,
+                                                  index, terms.spread, Actual360());
+        swap->setPricingEngine(ext::make_shared<DiscountingSwapEngine>(curve));
+        return swap;
+    }
+
+    ext::shared_ptr<ForgeSwapSkeleton> makeSkeleton(Size s) {
+        auto skeleton = ext::make_shared<ForgeSwapSkeleton>();
+        skeleton->swap = buildSwap(swapTerms[s], skeleton->curve);
+        skeleton->pillarDates = pillarDates();
+        return skeleton;
+    }
+
+    std::vector<double> ratesOf(double shift) {
+        std::vector<double> rates;
+        for (Size i = 0; i <= numPillars; ++i)
+            rates.push_back(0.03 + 0.001 * i + shift);
+        return rates;
+    }
+
+    struct Recording {
+        forge::Graph graph;
+        std::vector<forge::NodeId> inputs;
+        forge::NodeId output;
+        double npv;
+    };
+
+    // records swap s on the given zero rates, from scratch or from a cached skeleton
+    Recording record(Size s, const std::vector<double>& values, SkeletonCache* cache) {
+        forge::GraphRecorder recorder;
+        recorder.start();
+        Recording rec;
+        std::vector<Real> rates;
+        for (double v : values) {
+            rates.emplace_back(v);
+            rates.back().markForgeInputAndDiff();
+            rec.inputs.push_back(rates.back().forgeNodeId());
+        }
+        Real npv;
+        if (cache != nullptr) {
+            auto skeleton = cache->get(s);
+            auto curve = ext::make_shared<ZeroCurve>(skeleton->pillarDates, rates, Actual365Fixed());
+            curve->enableExtrapolation();
+            npv = skeleton->npv(curve);
+        } else {
+            auto curve = ext::make_shared<ZeroCurve>(pillarDates(), rates, Actual365Fixed());
+            curve->enableExtrapolation();
+            npv = buildSwap(swapTerms[s], Handle<YieldTermStructure>(curve))->NPV();
+        }
+        npv.markForgeOutput();
+        recorder.stop();
+        rec.graph = recorder.graph();
+        rec.output = npv.forgeNodeId();
+        rec.npv = npv.getValue();
+        return rec;
+    }
+
+    // NPV and adjoints of a recording on the given rates
+    std::vector<double> evaluate(const Recording& rec, const std::vector<double>& rates) {
+        ForgeKernelCache kernels;
+        auto entry = kernels.acquire(rec.graph);
+        std::vector<double> result(1 + rates.size());
+        forgeEvaluateBatched(*entry.kernel, *entry.buffer, rec.inputs, {rec.output}, rec.inputs,
+                             rates.data(), 1, rates.size(), result.data(), result.data() + 1);
+        return result;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(testReRecordingFromCachedSkeletons) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing re-recorded swaps from cached skeletons against recordings from scratch...");
+
+    Settings::instance().evaluationDate() = Date(15, January, 2024);
+    SkeletonCache cache(makeSkeleton);
+    const std::vector<double> base = ratesOf(0.0), shifted = ratesOf(0.004), other = ratesOf(-0.002);
+
+    for (Size s = 0; s < 2; ++s) {
+        const Recording first = record(s, base, &cache);
+        // the second recording reuses the skeleton on other market inputs
+        const Recording again = record(s, shifted, &cache);
+        const Recording fresh = record(s, shifted, nullptr);
+        BOOST_CHECK_CLOSE(first.npv, record(s, base, nullptr).npv, 1e-10);
+        BOOST_CHECK_CLOSE(again.npv, fresh.npv, 1e-10);
+        BOOST_CHECK(again.npv != first.npv);
+
+        // both kernels are valid on a third scenario, values and adjoints alike
+        const std::vector<double> cached = evaluate(again, other), expected = evaluate(fresh, other);
+        for (Size i = 0; i < expected.size(); ++i)
+            BOOST_CHECK_SMALL(cached[i] - expected[i], 1e-8 * (1.0 + std::fabs(expected[i])));
+    }
+    BOOST_CHECK_EQUAL(cache.size(), 2U);
+    BOOST_CHECK_EQUAL(cache.misses(), 2U);
+    BOOST_CHECK_EQUAL(cache.hits(), 2U);
+}
+
+BOOST_AUTO_TEST_CASE(testEvaluationDateIsPartOfTheKey) {
+
+    SavedSettings save;
+    BOOST_TEST_MESSAGE("Testing skeletons keyed by evaluation date...");
+
+    Settings::instance().evaluationDate() = Date(15, January, 2024);
+    SkeletonCache cache(makeSkeleton);
+    auto january = cache.get(0);
+    BOOST_CHECK(cache.get(0) == january);
+
+    Settings::instance().evaluationDate() = Date(15, July, 2024);
+    auto july = cache.get(0);
+    BOOST_CHECK(july != january);
+    BOOST_CHECK(july->pillarDates.front() == Date(15, July, 2024));
+    BOOST_CHECK_EQUAL(cache.size(), 2U);
+    BOOST_CHECK_EQUAL(cache.misses(), 2U);
+
+    cache.purge();
+    BOOST_CHECK_EQUAL(cache.size(), 1U);
+    BOOST_CHECK(cache.get(0) == july);
+    cache.clear();
+    BOOST_CHECK_EQUAL(cache.size(), 0U);
+
+    const SkeletonCache::Factory none;
+    BOOST_CHECK_THROW(SkeletonCache{none}, Error);
+    SkeletonCache empty([](const Size&) { return ext::shared_ptr<ForgeSwapSkeleton>(); });
+    BOOST_CHECK_THROW(empty.get(0), Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,400 @@
+/*******************************************************************************
+
+   Per-graph choice of instruction set and optimisation passes by measurement.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Which compiler configuration gives the fastest kernel is a property of
+    the graph: a short swap kernel gains nothing from the AVX2 lanes that a
+    long Bermudan one needs, and the optimisation passes pay off only for
+    graphs with enough redundancy.  Choosing it per benchmark method or per
+    trade type by hand does not scale to a book.
+
+    ForgeAutotuner makes the choice once per graph family, the graphs with
+    the same structural hash leaving constants out, on the running CPU:
+
+        ForgeAutotuneOptions options;
+        options.storePath = "autotune.txt";
+        ForgeAutotuner tuner(forgeAutotuneCandidates(), options);
+        ForgeKernelCache::Entry entry =
+            tuner.acquire(recorder.graph(), inputIds, sampleRows.data(), numSamples, stride);
+
+    The first acquire() for a family compiles every candidate configuration,
+    times it on the sample scenarios (load and execute, best of
+    options.repetitions passes after one warm-up pass) and keeps the fastest.
+    The compiled winner goes into a ForgeKernelCache for its configuration;
+    later graphs of the family, e.g. the same trade type at other notionals,
+    are compiled with the winning settings (once per distinct graph, as for
+    any kernel cache) without being measured again.
+
+    Choices are keyed by graph hash and CPU model: a store file shared by a
+    heterogeneous grid keeps one winner per machine type, and a worker only
+    uses the choices made on its own CPU model.  With options.storePath set,
+    the store is read at construction and rewritten after every tuning.
+
+    Timings are wall-clock and taken under a lock, so concurrent callers do
+    not disturb each other's measurements, but other load on the machine
+    does; the sample should be large enough to cover a few milliseconds.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/batchevaluator.hpp>
+#include <ql/forge/graphhash.hpp>
+#include <ql/forge/kernelcache.hpp>
+#include <ql/forge/graphstore.hpp>
+#include <compiler/compiler_config.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace QuantLib {
+
+    /// brand string of the running CPU, or "unknown"
+    inline std::string forgeCpuModel() {
+        std::string model;
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+        unsigned int regs[12] = {};
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0x80000000);
+        if (unsigned(info[0]) >= 0x80000004U) {
+            for (int i = 0; i < 3; ++i) {
+                __cpuid(info, 0x80000002 + i);
+                for (int r = 0; r < 4; ++r)
+                    regs[4 * i + r] = unsigned(info[r]);
+            }
+        }
+#else
+        if (__get_cpuid_max(0x80000000U, nullptr) >= 0x80000004U) {
+            for (unsigned int i = 0; i < 3; ++i)
+                __cpuid(0x80000002U + i, regs[4 * i], regs[4 * i + 1], regs[4 * i + 2],
+                        regs[4 * i + 3]);
+        }
+#endif
+        model.assign(reinterpret_cast<const char*>(regs), sizeof(regs));
+        model = model.substr(0, model.find('\0'));
+        const auto first = model.find_first_not_of(' ');
+        model = first == std::string::npos ? std::string() : model.substr(first);
+        model = model.substr(0, model.find_last_not_of(' ') + 1);
+#endif
+        return model.empty() ? std::string("unknown") : model;
+    }
+
+    /// a compiler configuration tried by ForgeAutotuner
+    struct ForgeAutotuneCandidate {
+        /// stored with the choice; no blanks
+        std::string name;
+        forge::CompilerConfig config;
+    };
+
+    /// stability-only, all and no optimisations, each with SSE2 and (if supported) AVX2
+    inline std::vector<ForgeAutotuneCandidate> forgeAutotuneCandidates() {
+        forge::CompilerConfig all;
+        all.enableOptimizations = true;
+        all.enableCSE = true;
+        all.enableAlgebraicSimplification = true;
+        all.enableInactiveFolding = true;
+        all.enableStabilityCleaning = true;
+        const std::pair<const char*, forge::CompilerConfig> modes[] = {
+            {"stability", forge::CompilerConfig::Default()},
+            {"allopt", all},
+            {"noopt", forge::CompilerConfig::NoOptimization()}};
+
+        std::vector<std::pair<const char*, forge::CompilerConfig::InstructionSet>> isas = {
+            {"sse2", forge::CompilerConfig::InstructionSet::SSE2_SCALAR}};
+        if ((forgeCpuFeatures() & ForgeCpuAVX2) != 0)
+            isas.emplace_back("avx2", forge::CompilerConfig::InstructionSet::AVX2_PACKED);
+
+        std::vector<ForgeAutotuneCandidate> candidates;
+        for (const auto& isa : isas) {
+            for (const auto& mode : modes) {
+                ForgeAutotuneCandidate c{std::string(isa.first) + "-" + mode.first, mode.second};
+                c.config.instructionSet = isa.second;
+                candidates.push_back(std::move(c));
+            }
+        }
+        return candidates;
+    }
+
+    /// measurement and persistence options for ForgeAutotuner
+    struct ForgeAutotuneOptions {
+        /// scenarios timed per pass; the given sample is cycled or truncated to this size
+        Size sampleScenarios = 256;
+        /// timed passes per candidate, the fastest of which counts
+        Size repetitions = 3;
+        /// store file read at construction and rewritten after each tuning, if not empty
+        std::string storePath;
+        /// hashing of the kernel caches; families never include constants
+        ForgeGraphHashOptions hashOptions = ForgeGraphHashOptions();
+    };
+
+    /// the configuration chosen for a graph family
+    struct ForgeAutotuneChoice {
+        /// ForgeAutotuner::familyHash of the graphs it applies to
+        std::uint64_t graphHash = 0;
+        std::string candidate;
+        forge::CompilerConfig config;
+        /// measured time of the winner, in seconds per scenario
+        double secondsPerScenario = 0.0;
+        /// true if measured by this process, false if read from the store
+        bool measured = false;
+    };
+
+    /// picks and caches the fastest compiler configuration per graph family
+    class ForgeAutotuner {
+      public:
+        static constexpr const char* magic = "QLFAUTOTUNE";
+        static constexpr std::uint32_t formatVersion = 1;
+
+        explicit ForgeAutotuner(std::vector<ForgeAutotuneCandidate> candidates = forgeAutotuneCandidates(),
+                                ForgeAutotuneOptions options = ForgeAutotuneOptions())
+        : candidates_(std::move(candidates)), options_(std::move(options)),
+          cpuModel_(forgeCpuModel()) {
+            QL_REQUIRE(!candidates_.empty(), "no autotuning candidates");
+            for (const auto& c : candidates_)
+                QL_REQUIRE(!c.name.empty() && c.name.find_first_of(" \t\n") == std::string::npos,
+                           "autotuning candidate name '" << c.name << "' is empty or has blanks");
+            QL_REQUIRE(options_.sampleScenarios > 0 && options_.repetitions > 0,
+                       "autotuning needs at least one scenario and one repetition");
+            if (!options_.storePath.empty() && std::ifstream(options_.storePath).good())
+                load(options_.storePath);
+        }
+
+        /// structural hash shared by the graphs of a family
+        static std::uint64_t familyHash(const forge::Graph& graph) {
+            ForgeGraphHashOptions structure;
+            structure.includeConstants = false;
+            return forgeGraphHash(graph, structure);
+        }
+
+        /// the configuration for the graph's family, tuned on the first call
+        /// inputs are the nodes fed from the sample, numSamples row-major rows
+        /// with the given stride; with no inputs the recorded values are timed.
+        ForgeAutotuneChoice choose(const forge::Graph& graph,
+                                   const std::vector<forge::NodeId>& inputs = {},
+                                   const double* sample = nullptr,
+                                   Size numSamples = 0,
+                                   Size stride = 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return chooseLocked(graph, inputs, sample, numSamples, stride);
+        }
+
+        /// a kernel for the graph compiled with the configuration of its family
+        ForgeKernelCache::Entry acquire(const forge::Graph& graph,
+                                        const std::vector<forge::NodeId>& inputs = {},
+                                        const double* sample = nullptr,
+                                        Size numSamples = 0,
+                                        Size stride = 0) {
+            ForgeKernelCache* cache;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                cache = &cacheFor(chooseLocked(graph, inputs, sample, numSamples, stride).config);
+            }
+            return cache->acquire(graph);
+        }
+
+        /// the choice known for a family hash on this CPU, or null
+        const ForgeAutotuneChoice* find(std::uint64_t graphHash) const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = choices_.find(key(graphHash));
+            return it != choices_.end() ? &it->second : nullptr;
+        }
+
+        /// families benchmarked by this process
+        Size tunings() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return tunings_;
+        }
+        /// choices known for this CPU model
+        Size size() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            Size n = 0;
+            for (const auto& c : choices_)
+                n += c.first.second == cpuModel_ ? 1 : 0;
+            return n;
+        }
+
+        const std::vector<ForgeAutotuneCandidate>& candidates() const { return candidates_; }
+        const ForgeAutotuneOptions& options() const { return options_; }
+        const std::string& cpuModel() const { return cpuModel_; }
+
+        /// writes the choices of all CPU models, one line each
+        void save(const std::string& path) const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            saveLocked(path);
+        }
+
+        /// adds the choices of the file, replacing known ones
+        void load(const std::string& path) {
+            std::ifstream in(path);
+            QL_REQUIRE(in, "cannot open Forge autotuning store " << path);
+            std::string header;
+            std::uint32_t version = 0;
+            in >> header >> version;
+            QL_REQUIRE(in && header == magic, path << " is not a Forge autotuning store");
+            QL_REQUIRE(version == formatVersion, "Forge autotuning store " << path << " has version "
+                                                     << version << ", expected " << formatVersion);
+            std::map<Key, ForgeAutotuneChoice> loaded;
+            std::string line;
+            std::getline(in, line);
+            while (std::getline(in, line)) {
+                if (line.empty())
+                    continue;
+                // hash \t candidate \t seconds \t optimisation flags \t instruction set \t cpu model
+                std::istringstream fields(line);
+                ForgeAutotuneChoice c;
+                std::string cpu;
+                int opt, cse, algebraic, inactive, stability, isa;
+                fields >> std::hex >> c.graphHash >> std::dec >> c.candidate >>
+                    c.secondsPerScenario >> opt >> cse >> algebraic >> inactive >> stability >> isa;
+                QL_REQUIRE(fields, "malformed line in Forge autotuning store " << path << ": " << line);
+                std::getline(fields >> std::ws, cpu);
+                c.config.enableOptimizations = opt != 0;
+                c.config.enableCSE = cse != 0;
+                c.config.enableAlgebraicSimplification = algebraic != 0;
+                c.config.enableInactiveFolding = inactive != 0;
+                c.config.enableStabilityCleaning = stability != 0;
+                c.config.instructionSet = forge::CompilerConfig::InstructionSet(isa);
+                loaded[Key(c.graphHash, cpu)] = std::move(c);
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& c : loaded)
+                choices_[c.first] = std::move(c.second);
+        }
+
+      private:
+        using Key = std::pair<std::uint64_t, std::string>;
+
+        Key key(std::uint64_t graphHash) const { return Key(graphHash, cpuModel_); }
+
+        ForgeAutotuneChoice chooseLocked(const forge::Graph& graph,
+                                         const std::vector<forge::NodeId>& inputs,
+                                         const double* sample,
+                                         Size numSamples,
+                                         Size stride) {
+            QL_REQUIRE(inputs.empty() || (sample != nullptr && numSamples > 0),
+                       "autotuning inputs given without sample scenarios");
+            const std::uint64_t hash = familyHash(graph);
+            auto it = choices_.find(key(hash));
+            if (it != choices_.end())
+                return it->second;
+
+            ForgeAutotuneChoice best;
+            best.graphHash = hash;
+            best.measured = true;
+            best.secondsPerScenario = std::numeric_limits<double>::max();
+            std::shared_ptr<ForgeKernel> bestKernel;
+            for (const auto& candidate : candidates_) {
+                forge::ForgeEngine compiler(candidate.config);
+                std::shared_ptr<ForgeKernel> kernel(compiler.compile(graph));
+                if (kernel == nullptr)
+                    continue;
+                ForgeBufferPtr buffer = forge::NodeValueBufferFactory::create(graph, *kernel);
+                const double seconds =
+                    time(*kernel, *buffer, inputs, sample, numSamples, stride == 0 ? inputs.size() : stride);
+                if (seconds < best.secondsPerScenario) {
+                    best.candidate = candidate.name;
+                    best.config = candidate.config;
+                    best.secondsPerScenario = seconds;
+                    bestKernel = std::move(kernel);
+                }
+            }
+            QL_REQUIRE(bestKernel != nullptr, "no autotuning candidate compiled the graph");
+            cacheFor(best.config).insert(graph, std::move(bestKernel));
+            ++tunings_;
+            choices_[key(hash)] = best;
+            if (!options_.storePath.empty())
+                saveLocked(options_.storePath);
+            return best;
+        }
+
+        /// best of options_.repetitions passes over the sample, in seconds per scenario
+        double time(ForgeKernel& kernel,
+                    ForgeBuffer& buffer,
+                    const std::vector<forge::NodeId>& inputs,
+                    const double* sample,
+                    Size numSamples,
+                    Size stride) const {
+            const Size n = options_.sampleScenarios;
+            return forgeWithBatchWidth(buffer.getVectorWidth(), [&](auto w) {
+                constexpr Size W = decltype(w)::value;
+                ForgeBatchEvaluator<W> evaluator(kernel, buffer, inputs, {});
+                auto pass = [&]() {
+                    for (Size first = 0; first < n; first += W) {
+                        const Size count = std::min(W, n - first);
+                        if (!inputs.empty())
+                            evaluator.load(
+                                [&](Size lane) {
+                                    return sample + ((first + lane) % numSamples) * stride;
+                                },
+                                count);
+                        evaluator.execute();
+                    }
+                };
+                pass();
+                double best = std::numeric_limits<double>::max();
+                for (Size r = 0; r < options_.repetitions; ++r) {
+                    auto start = std::chrono::steady_clock::now();
+                    pass();
+                    best = std::min(best, std::chrono::duration<double>(
+                                              std::chrono::steady_clock::now() - start)
+                                              .count());
+                }
+                return best / double(n);
+            });
+        }
+
+        ForgeKernelCache& cacheFor(const forge::CompilerConfig& config) {
+            auto& cache = caches_[forgeConfigHash(config)];
+            if (cache == nullptr)
+                cache = std::make_unique<ForgeKernelCache>(config, options_.hashOptions);
+            return *cache;
+        }
+
+        void saveLocked(const std::string& path) const {
+            std::ofstream out(path, std::ios::trunc);
+            QL_REQUIRE(out, "cannot open Forge autotuning store " << path << " for writing");
+            out << magic << ' ' << formatVersion << '\n';
+            out.precision(17);
+            for (const auto& entry : choices_) {
+                const ForgeAutotuneChoice& c = entry.second;
+                out << std::hex << c.graphHash << std::dec << '\t' << c.candidate << '\t'
+                    << c.secondsPerScenario << '\t' << int(c.config.enableOptimizations) << ' '
+                    << int(c.config.enableCSE) << ' ' << int(c.config.enableAlgebraicSimplification)
+                    << ' ' << int(c.config.enableInactiveFolding) << ' '
+                    << int(c.config.enableStabilityCleaning) << '\t'
+                    << int(c.config.instructionSet) << '\t' << entry.first.second << '\n';
+            }
+            QL_REQUIRE(out, "error writing Forge autotuning store " << path);
+        }
+
+        std::vector<ForgeAutotuneCandidate> candidates_;
+        ForgeAutotuneOptions options_;
+        std::string cpuModel_;
+
+        mutable std::mutex mutex_;
+        std::map<Key, ForgeAutotuneChoice> choices_;
+        std::map<std::uint64_t, std::unique_ptr<ForgeKernelCache>> caches_;
+        Size tunings_ = 0;
+    };
+
+}
@@ -0,0 +1,389 @@
+/*******************************************************************************
+
+   Lane-batched evaluation of Forge kernels over row-major scenario data.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Packed kernels (AVX2: 4 lanes, AVX-512: 8 lanes) evaluate several
+    scenarios per execute() call, with every node holding Width consecutive
+    doubles in the buffer.  Scenario data is naturally row-major
+    ([scenario][input]), so each batch has to be transposed into lanes, the
+    last batch padded, and only the valid lanes read back.  Data that is
+    already lane-interleaved (see ForgeScenarioCube) skips the transpose.
+
+    ForgeBatchEvaluator<Width> does this in one place.  When the buffer
+    exposes raw value storage and all node indices are valid, inputs and
+    outputs are copied straight to and from getValuesPtr(); otherwise the
+    setLanes/getLanes API is used.  Padding lanes repeat the last valid
+    scenario so that they never feed out-of-domain values (log of zero,
+    division by zero) into the kernel.
+
+    Adjoints are de-interleaved straight into caller-owned storage, either a
+    strided tensor (lane stride, gradient stride) or one row per scenario,
+    optionally adding to what is already there.  Nothing is allocated per
+    batch: with raw gradient storage the adjoints are read in place, and the
+    getGradientLanes fallback reuses a scratch block sized at construction.
+
+    Where the inputs, outputs or adjoints occupy one contiguous block of
+    the buffer, in the order given to the evaluator (forgeContiguousLayout
+    in graphhash.hpp renumbers a graph so that they do), lane-interleaved
+    blocks move with a single copy: loadInterleaved, readOutputBlock and
+    readGradientBlock.  inputBlock() exposes the input block itself, so
+    that scenarios can be generated straight into the buffer:
+
+        double* block = evaluator.inputBlock();    // null if not contiguous
+        ... write input i of lane l to block[i * Width + l] ...
+        evaluator.loadInterleaved(block, count);   // nothing to copy
+
+    The width is a template parameter so that the lane loops unroll into
+    vector moves; forgeWithBatchWidth() maps a kernel's runtime vector
+    width onto the matching instantiation.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/kernelcache.hpp>
+#include <graph/handles.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace QuantLib {
+
+    /// lane count implied by a compiler configuration
+    /// Returns 0 for instruction sets unknown to this header; callers should then
+    /// use the vector width reported by the kernel's buffer.
+    inline Size forgeVectorWidth(const forge::CompilerConfig& config) {
+        switch (config.instructionSet) {
+            case forge::CompilerConfig::InstructionSet::SSE2_SCALAR:
+                return 1;
+            case forge::CompilerConfig::InstructionSet::AVX2_PACKED:
+                return 4;
+            default:
+                return 0;
+        }
+    }
+
+    /// calls f(std::integral_constant<Size, W>()) for the supported width W == width
+    template <class F>
+    decltype(auto) forgeWithBatchWidth(Size width, F&& f) {
+        switch (width) {
+            case 1:
+                return f(std::integral_constant<Size, 1>());
+            case 2:
+                return f(std::integral_constant<Size, 2>());
+            case 4:
+                return f(std::integral_constant<Size, 4>());
+            case 8:
+                return f(std::integral_constant<Size, 8>());
+            default:
+                QL_FAIL("unsupported Forge vector width " << width);
+        }
+    }
+
+    /// evaluates a kernel over scenarios in batches of Width lanes
+    template <Size Width>
+    class ForgeBatchEvaluator {
+      public:
+        static constexpr Size width = Width;
+
+        /// inputs are the nodes fed per scenario, outputs the nodes read back;
+        /// gradientInputs are the nodes whose adjoints are returned (usually the
+        /// inputs marked with markForgeInputAndDiff)
+        ForgeBatchEvaluator(ForgeKernel& kernel,
+                            ForgeBuffer& buffer,
+                            std::vector<forge::NodeId> inputs,
+                            std::vector<forge::NodeId> outputs,
+                            std::vector<forge::NodeId> gradientInputs = {})
+        : kernel_(kernel), buffer_(buffer), inputs_(std::move(inputs)),
+          outputs_(std::move(outputs)), gradientInputs_(std::move(gradientInputs)) {
+            QL_REQUIRE(Size(buffer_.getVectorWidth()) == Width,
+                       "buffer vector width " << buffer_.getVectorWidth()
+                                              << " does not match batch width " << Width);
+            direct_ = buffer_.getValuesPtr() != nullptr;
+            inputIndices_.reserve(inputs_.size());
+            for (auto id : inputs_)
+                direct_ = addIndex(inputIndices_, id) && direct_;
+            outputIndices_.reserve(outputs_.size());
+            for (auto id : outputs_)
+                direct_ = addIndex(outputIndices_, id) && direct_;
+            gradientIndices_.reserve(gradientInputs_.size());
+            for (auto id : gradientInputs_) {
+                auto index = buffer_.getBufferIndex(id);
+                QL_REQUIRE(index != SIZE_MAX, "gradient input node " << id << " has no buffer slot");
+                gradientIndices_.push_back(index);
+            }
+            gradientScratch_.resize(gradientIndices_.size() * Width);
+            const double* gradients = direct_ ? buffer_.getGradientsPtr() : nullptr;
+            directGradients_ = gradients != nullptr;
+            gradientSources_.reserve(gradientIndices_.size());
+            for (Size g = 0; g < gradientIndices_.size(); ++g)
+                gradientSources_.push_back(directGradients_ ? gradients + gradientIndices_[g]
+                                                            : gradientScratch_.data() + g * Width);
+            contiguousInputs_ = direct_ && contiguous(inputIndices_);
+            contiguousOutputs_ = direct_ && contiguous(outputIndices_);
+            contiguousGradients_ = directGradients_ && contiguous(gradientIndices_);
+        }
+
+        // gradientSources_ may point into gradientScratch_, whose storage a move
+        // keeps and a copy would not; the references rule out assignment
+        ForgeBatchEvaluator(ForgeBatchEvaluator&&) = default;
+        ForgeBatchEvaluator(const ForgeBatchEvaluator&) = delete;
+        ForgeBatchEvaluator& operator=(const ForgeBatchEvaluator&) = delete;
+
+        Size numInputs() const { return inputs_.size(); }
+        Size numOutputs() const { return outputs_.size(); }
+        Size numGradients() const { return gradientInputs_.size(); }
+        /// scenarios in the last loaded batch
+        Size count() const { return count_; }
+        /// true if raw buffer pointers are used instead of setLanes/getLanes
+        bool direct() const { return direct_; }
+        /// true if adjoints are read in place instead of through getGradientLanes
+        bool directGradients() const { return directGradients_; }
+        /// true if the inputs, in the given order, form one block of the buffer
+        bool contiguousInputs() const { return contiguousInputs_; }
+        bool contiguousOutputs() const { return contiguousOutputs_; }
+        bool contiguousGradients() const { return contiguousGradients_; }
+
+        /// the lane-interleaved input block inside the buffer, or null if not contiguous
+        double* inputBlock() {
+            return contiguousInputs_ ? buffer_.getValuesPtr() + inputIndices_[0] : nullptr;
+        }
+
+        /// loads up to Width scenarios; row(lane) returns a pointer to the inputs of scenario lane
+        template <class RowAccessor>
+        void load(RowAccessor row, Size count) {
+            QL_REQUIRE(count > 0 && count <= Width, "batch of " << count << " scenarios for width " << Width);
+            count_ = count;
+            const double* rows[Width];
+            for (Size lane = 0; lane < Width; ++lane)
+                rows[lane] = row(std::min(lane, count - 1));
+            const Size n = inputs_.size();
+            if (Width == 1 && contiguousInputs_) {
+                std::memcpy(inputBlock(), rows[0], n * sizeof(double));
+            } else if (direct_) {
+                double* values = buffer_.getValuesPtr();
+                for (Size i = 0; i < n; ++i) {
+                    double* slot = values + inputIndices_[i];
+                    for (Size lane = 0; lane < Width; ++lane)
+                        slot[lane] = rows[lane][i];
+                }
+            } else {
+                double lanes[Width];
+                for (Size i = 0; i < n; ++i) {
+                    for (Size lane = 0; lane < Width; ++lane)
+                        lanes[lane] = rows[lane][i];
+                    buffer_.setLanes(inputs_[i], lanes);
+                }
+            }
+        }
+
+        /// loads a lane-interleaved block, block[i * Width + lane], as stored by ForgeScenarioCube
+        /// Lanes at or past count are replaced by the last valid lane.
+        void loadInterleaved(const double* block, Size count) {
+            QL_REQUIRE(count > 0 && count <= Width, "batch of " << count << " scenarios for width " << Width);
+            count_ = count;
+            const Size n = inputs_.size();
+            if (contiguousInputs_ && count == Width) {
+                double* dst = inputBlock();
+                if (block != dst)
+                    std::memcpy(dst, block, n * Width * sizeof(double));
+                return;
+            }
+            double lanes[Width];
+            for (Size i = 0; i < n; ++i) {
+                const double* src = block + i * Width;
+                double* dst = direct_ ? buffer_.getValuesPtr() + inputIndices_[i] : lanes;
+                if (src != dst)
+                    std::copy(src, src + count, dst);
+                std::fill(dst + count, dst + Width, src[count - 1]);
+                if (!direct_)
+                    buffer_.setLanes(inputs_[i], lanes);
+            }
+        }
+
+        /// loads a lane-interleaved float32 block, as stored by ForgeFloatScenarioCube
+        /// The values are widened to the doubles of the kernel; lanes at or past
+        /// count are replaced by the last valid lane.
+        void loadInterleaved(const float* block, Size count) {
+            QL_REQUIRE(count > 0 && count <= Width, "batch of " << count << " scenarios for width " << Width);
+            count_ = count;
+            double lanes[Width];
+            for (Size i = 0; i < inputs_.size(); ++i) {
+                const float* src = block + i * Width;
+                double* dst = direct_ ? buffer_.getValuesPtr() + inputIndices_[i] : lanes;
+                for (Size lane = 0; lane < count; ++lane)
+                    dst[lane] = double(src[lane]);
+                std::fill(dst + count, dst + Width, double(src[count - 1]));
+                if (!direct_)
+                    buffer_.setLanes(inputs_[i], lanes);
+            }
+        }
+
+        /// loads scenarios [first, first + count) of a row-major matrix with the given row stride
+        void load(const double* scenarios, Size stride, Size first, Size count) {
+            load([=](Size lane) { return scenarios + (first + lane) * stride; }, count);
+        }
+
+        void execute() { kernel_.execute(buffer_); }
+
+        /// writes the outputs of the loaded scenarios to out[lane * outStride + o]
+        void readOutputs(double* out, Size outStride) const {
+            const Size n = outputs_.size();
+            if (direct_) {
+                const double* values = buffer_.getValuesPtr();
+                for (Size o = 0; o < n; ++o) {
+                    const double* slot = values + outputIndices_[o];
+                    for (Size lane = 0; lane < count_; ++lane)
+                        out[lane * outStride + o] = slot[lane];
+                }
+            } else {
+                double lanes[Width];
+                for (Size o = 0; o < n; ++o) {
+                    buffer_.getLanes(outputs_[o], lanes);
+                    for (Size lane = 0; lane < count_; ++lane)
+                        out[lane * outStride + o] = lanes[lane];
+                }
+            }
+        }
+
+        /// writes the outputs, lane-interleaved, to block[o * Width + lane]
+        void readOutputBlock(double* block) const {
+            if (contiguousOutputs_) {
+                std::memcpy(block, buffer_.getValuesPtr() + outputIndices_[0],
+                            outputs_.size() * Width * sizeof(double));
+            } else {
+                for (Size o = 0; o < outputs_.size(); ++o)
+                    buffer_.getLanes(outputs_[o], block + o * Width);
+            }
+        }
+
+        /// writes the adjoints, lane-interleaved, to block[g * Width + lane]
+        void readGradientBlock(double* block) {
+            if (contiguousGradients_) {
+                std::memcpy(block, gradientSources_[0], gradientSources_.size() * Width * sizeof(double));
+                return;
+            }
+            if (!directGradients_)
+                buffer_.getGradientLanes(gradientIndices_, gradientScratch_.data());
+            for (Size g = 0; g < gradientSources_.size(); ++g)
+                std::copy(gradientSources_[g], gradientSources_[g] + Width, block + g * Width);
+        }
+
+        /// writes the adjoints of the loaded scenarios to out[lane * outStride + g]
+        void readGradients(double* out, Size outStride) { readGradients(out, outStride, 1); }
+
+        /// writes the adjoints to out[lane * laneStride + g * gradientStride]
+        /// With accumulate set, the adjoints are added to the destination.
+        void readGradients(double* out, Size laneStride, Size gradientStride, bool accumulate = false) {
+            readGradientRows([=](Size lane) { return out + lane * laneStride; }, gradientStride,
+                             accumulate);
+        }
+
+        /// writes the adjoints of scenario lane to row(lane)[g * gradientStride]
+        template <class RowAccessor>
+        void readGradientRows(RowAccessor row, Size gradientStride = 1, bool accumulate = false) {
+            if (gradientIndices_.empty())
+                return;
+            // interleaved: [node0 lane0..W-1, node1 lane0..W-1, ...]
+            if (!directGradients_)
+                buffer_.getGradientLanes(gradientIndices_, gradientScratch_.data());
+            const Size n = gradientSources_.size();
+            for (Size lane = 0; lane < count_; ++lane) {
+                double* dst = row(lane);
+                if (accumulate) {
+                    for (Size g = 0; g < n; ++g)
+                        dst[g * gradientStride] += gradientSources_[g][lane];
+                } else {
+                    for (Size g = 0; g < n; ++g)
+                        dst[g * gradientStride] = gradientSources_[g][lane];
+                }
+            }
+        }
+
+        /// adds the sum over the loaded scenarios of each adjoint to sums[g * gradientStride]
+        void sumGradients(double* sums, Size gradientStride = 1) {
+            if (gradientIndices_.empty())
+                return;
+            if (!directGradients_)
+                buffer_.getGradientLanes(gradientIndices_, gradientScratch_.data());
+            const Size n = gradientSources_.size();
+            for (Size g = 0; g < n; ++g) {
+                const double* lanes = gradientSources_[g];
+                double s = 0.0;
+                for (Size lane = 0; lane < count_; ++lane)
+                    s += lanes[lane];
+                sums[g * gradientStride] += s;
+            }
+        }
+
+        /// evaluates numScenarios row-major scenarios
+        /// outputs and gradients are row-major as well, one row per scenario with
+        /// numOutputs() and numGradients() columns; gradients may be null.
+        void evaluate(const double* scenarios, Size numScenarios, Size stride,
+                      double* outputs, double* gradients = nullptr) {
+            for (Size first = 0; first < numScenarios; first += Width) {
+                Size count = std::min(Width, numScenarios - first);
+                load(scenarios, stride, first, count);
+                execute();
+                readOutputs(outputs + first * outputs_.size(), outputs_.size());
+                if (gradients != nullptr)
+                    readGradients(gradients + first * gradientInputs_.size(), gradientInputs_.size());
+            }
+        }
+
+      private:
+        static bool contiguous(const std::vector<std::size_t>& indices) {
+            for (Size k = 1; k < indices.size(); ++k)
+                if (indices[k] != indices[0] + k * Width)
+                    return false;
+            return !indices.empty();
+        }
+
+        bool addIndex(std::vector<std::size_t>& indices, forge::NodeId id) const {
+            auto index = buffer_.getBufferIndex(id);
+            indices.push_back(index);
+            return index != SIZE_MAX;
+        }
+
+        ForgeKernel& kernel_;
+        ForgeBuffer& buffer_;
+        std::vector<forge::NodeId> inputs_, outputs_, gradientInputs_;
+        std::vector<std::size_t> inputIndices_, outputIndices_, gradientIndices_;
+        std::vector<double> gradientScratch_;
+        std::vector<const double*> gradientSources_;
+        bool direct_ = false, directGradients_ = false;
+        bool contiguousInputs_ = false, contiguousOutputs_ = false, contiguousGradients_ = false;
+        Size count_ = 0;
+    };
+
+    /// row-major evaluation with the batch width picked from the buffer
+    inline void forgeEvaluateBatched(ForgeKernel& kernel,
+                                     ForgeBuffer& buffer,
+                                     const std::vector<forge::NodeId>& inputs,
+                                     const std::vector<forge::NodeId>& outputs,
+                                     const std::vector<forge::NodeId>& gradientInputs,
+                                     const double* scenarios,
+                                     Size numScenarios,
+                                     Size stride,
+                                     double* outputValues,
+                                     double* gradients = nullptr) {
+        forgeWithBatchWidth(Size(buffer.getVectorWidth()), [&](auto w) {
+            ForgeBatchEvaluator<decltype(w)::value> evaluator(kernel, buffer, inputs, outputs,
+                                                              gradientInputs);
+            evaluator.evaluate(scenarios, numScenarios, stride, outputValues, gradients);
+        });
+    }
+
+}
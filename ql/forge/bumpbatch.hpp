@@ -0,0 +1,289 @@
+/*******************************************************************************
+
+   Lane-packed bump-and-revalue sensitivities of a forward kernel.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Payoffs that AAD cannot differentiate (digitals, barriers monitored
+    without smoothing) are risked by bumping: the forward kernel runs on
+    the scenario and on the scenario with one input moved at a time.  Run
+    one lane at a time, 100 risk factors cost 101 executions per path.
+
+    ForgeBumpBatch<Width> lays the base and bumped scenarios out as lanes,
+    lane 0 the scenario itself and lane 1 + i the scenario with input i
+    bumped, so a 4-lane AVX2 kernel prices a 100-factor bump set in 26
+    executions and an 8-lane AVX-512 one in 13,
+
+        ForgeBumpBatch<4> bumps(*kernel, *buffer, inputs, {npv}, 1e-4);
+        for (Size p = 0; p < paths; ++p) {
+            auto scenario = cube.path(t, p);
+            exposure[p] = bumps.evaluate(scenario.data(), scenario.stride(),
+                                         deltas, trade, t, p);
+        }
+
+    The central scheme bumps each input both ways and takes two lanes per
+    input.  Bumps may differ per input.  Given directions v_k instead, lane
+    1 + k holds the scenario moved by bump * v_k and the results are
+    directional derivatives, d npv / d input i for the unit vectors of
+    forgeUnitDirections; a direction moves the inputs it has non-zero
+    entries for.
+
+    No row-major scenario copies are formed: the base scenario is
+    broadcast into the lane-interleaved input block once per scenario (in
+    place when the inputs are contiguous in the buffer, see
+    forgeContiguousLayout), and each batch only restores the cells the
+    previous batch moved and moves its own.  Difference quotients are
+    formed as soon as a batch has executed and written straight to their
+    destination, a strided array or a ForgeSensitivityTensor.
+
+    The kernel must not write to its input nodes, which holds for kernels
+    recorded with markForgeInput; it needs no gradient inputs.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/batchevaluator.hpp>
+#include <ql/forge/sensitivitytensor.hpp>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace QuantLib {
+
+    /// difference scheme of ForgeBumpBatch and ForgeHessianEvaluator
+    enum class ForgeDifferenceScheme { Forward, Central };
+
+    /// the unit vectors of the selected inputs out of numInputs
+    inline std::vector<std::vector<double>> forgeUnitDirections(Size numInputs,
+                                                                const std::vector<Size>& selected) {
+        std::vector<std::vector<double>> directions(selected.size(),
+                                                    std::vector<double>(numInputs, 0.0));
+        for (Size k = 0; k < selected.size(); ++k) {
+            QL_REQUIRE(selected[k] < numInputs,
+                       "input " << selected[k] << " out of range for " << numInputs << " inputs");
+            directions[k][selected[k]] = 1.0;
+        }
+        return directions;
+    }
+
+    /// the unit vectors of all numInputs inputs
+    inline std::vector<std::vector<double>> forgeUnitDirections(Size numInputs) {
+        std::vector<Size> all(numInputs);
+        for (Size i = 0; i < numInputs; ++i)
+            all[i] = i;
+        return forgeUnitDirections(numInputs, all);
+    }
+
+    /// bump-and-revalue sensitivities with the bumped scenarios laid out as lanes
+    template <Size Width>
+    class ForgeBumpBatch {
+      public:
+        /// the same bump for every input
+        ForgeBumpBatch(ForgeKernel& kernel,
+                       ForgeBuffer& buffer,
+                       std::vector<forge::NodeId> inputs,
+                       std::vector<forge::NodeId> outputs,
+                       double bump,
+                       ForgeDifferenceScheme scheme = ForgeDifferenceScheme::Forward)
+        : ForgeBumpBatch(kernel, buffer, inputs, std::move(outputs),
+                         std::vector<double>(inputs.size(), bump), scheme) {}
+
+        /// bumps[i] for input i
+        ForgeBumpBatch(ForgeKernel& kernel,
+                       ForgeBuffer& buffer,
+                       std::vector<forge::NodeId> inputs,
+                       std::vector<forge::NodeId> outputs,
+                       std::vector<double> bumps,
+                       ForgeDifferenceScheme scheme = ForgeDifferenceScheme::Forward)
+        : ForgeBumpBatch(kernel, buffer, std::move(inputs), std::move(outputs), scheme) {
+            QL_REQUIRE(bumps.size() == numInputs_,
+                       bumps.size() << " bumps given for " << numInputs_ << " inputs");
+            for (Size i = 0; i < numInputs_; ++i) {
+                QL_REQUIRE(bumps[i] > 0.0, "non-positive bump " << bumps[i] << " for input " << i);
+                moves_.push_back({{i, bumps[i]}});
+            }
+            bumps_ = std::move(bumps);
+            allocate();
+        }
+
+        /// derivatives along directions[k], each with one entry per input, moved by bump
+        ForgeBumpBatch(ForgeKernel& kernel,
+                       ForgeBuffer& buffer,
+                       std::vector<forge::NodeId> inputs,
+                       std::vector<forge::NodeId> outputs,
+                       const std::vector<std::vector<double>>& directions,
+                       double bump,
+                       ForgeDifferenceScheme scheme = ForgeDifferenceScheme::Forward)
+        : ForgeBumpBatch(kernel, buffer, std::move(inputs), std::move(outputs), scheme) {
+            QL_REQUIRE(bump > 0.0, "non-positive bump " << bump);
+            QL_REQUIRE(!directions.empty(), "no directions given for the bump batch");
+            for (const auto& v : directions) {
+                QL_REQUIRE(v.size() == numInputs_,
+                           "direction of size " << v.size() << " for " << numInputs_ << " inputs");
+                std::vector<std::pair<Size, double>> move;
+                for (Size i = 0; i < numInputs_; ++i)
+                    if (v[i] != 0.0)
+                        move.emplace_back(i, bump * v[i]);
+                moves_.push_back(std::move(move));
+            }
+            bumps_.assign(directions.size(), bump);
+            allocate();
+        }
+
+        Size numInputs() const { return numInputs_; }
+        Size numOutputs() const { return numOutputs_; }
+        /// number of derivatives per output: one per input, or one per direction
+        Size numDirections() const { return moves_.size(); }
+        /// the bump of each input or direction
+        const std::vector<double>& bumps() const { return bumps_; }
+        /// lanes used per scenario: the scenario itself and one or two per direction
+        Size lanes() const { return lanes_; }
+        /// kernel executions per scenario
+        Size executions() const { return (lanes_ + Width - 1) / Width; }
+        /// true if scenarios are generated in the buffer itself
+        bool inPlace() const { return scratch_.empty(); }
+
+        /// evaluates one scenario given as inputs[i * stride]
+        /// values takes numOutputs() entries; the derivative of output o along
+        /// direction k (input k for per-input bumps) goes to
+        /// sensitivities[k * directionStride + o * outputStride], added to it if
+        /// accumulate is set.  sensitivities may be null.
+        void evaluate(const double* inputs,
+                      Size stride,
+                      double* values,
+                      double* sensitivities,
+                      Size directionStride,
+                      Size outputStride = 1,
+                      bool accumulate = false) {
+            run(inputs, stride, [&](Size k, Size o, double d) {
+                if (sensitivities == nullptr)
+                    return;
+                double& target = sensitivities[k * directionStride + o * outputStride];
+                target = accumulate ? target + d : d;
+            });
+            std::copy(base_.begin(), base_.end(), values);
+        }
+
+        /// as above, with sensitivities[k * numOutputs() + o]
+        void evaluate(const double* inputs, Size stride, double* values, double* sensitivities) {
+            evaluate(inputs, stride, values, sensitivities, numOutputs_);
+        }
+
+        /// evaluates one path of a single-output kernel into a sensitivity tensor
+        /// with one factor per input or direction, and returns the value of the scenario
+        double evaluate(const double* inputs,
+                        Size stride,
+                        ForgeSensitivityTensor& tensor,
+                        Size trade,
+                        Size t,
+                        Size path) {
+            QL_REQUIRE(numOutputs_ == 1, "a sensitivity tensor takes a single output, not "
+                                             << numOutputs_);
+            QL_REQUIRE(tensor.factors() == moves_.size(), "tensor has " << tensor.factors()
+                                                                       << " factors for "
+                                                                       << moves_.size()
+                                                                       << " directions");
+            ForgeSensitivityTensor::PathCells cells = tensor.addPathCells(trade, t, path);
+            double value;
+            evaluate(inputs, stride, &value, cells.first, cells.stride, 1, cells.accumulate);
+            return value;
+        }
+
+      private:
+        ForgeBumpBatch(ForgeKernel& kernel,
+                       ForgeBuffer& buffer,
+                       std::vector<forge::NodeId> inputs,
+                       std::vector<forge::NodeId> outputs,
+                       ForgeDifferenceScheme scheme)
+        : numInputs_(inputs.size()), numOutputs_(outputs.size()),
+          central_(scheme == ForgeDifferenceScheme::Central),
+          evaluator_(kernel, buffer, std::move(inputs), std::move(outputs)) {
+            QL_REQUIRE(numInputs_ > 0, "no inputs given for the bump batch");
+            QL_REQUIRE(numOutputs_ > 0, "no outputs given for the bump batch");
+        }
+
+        void allocate() {
+            lanes_ = 1 + (central_ ? 2 : 1) * moves_.size();
+            if (evaluator_.inputBlock() == nullptr)
+                scratch_.resize(numInputs_ * Width);
+            values_.resize(Width * numOutputs_);
+            base_.resize(numOutputs_);
+            up_.resize(numOutputs_);
+        }
+
+        // calls store(k, o, d) for every derivative, in direction order
+        template <class Store>
+        void run(const double* inputs, Size stride, Store store) {
+            const Size n = numInputs_, none = moves_.size();
+            double* block = inPlace() ? evaluator_.inputBlock() : scratch_.data();
+            for (Size i = 0; i < n; ++i)
+                std::fill(block + i * Width, block + (i + 1) * Width, inputs[i * stride]);
+            // the direction moved in each lane of the previous batch
+            Size moved[Width];
+            std::fill(moved, moved + Width, none);
+
+            for (Size first = 0; first < lanes_; first += Width) {
+                const Size count = std::min(Width, lanes_ - first);
+                for (Size lane = 0; lane < Width; ++lane) {
+                    if (moved[lane] < none)
+                        for (const auto& cell : moves_[moved[lane]])
+                            block[cell.first * Width + lane] = inputs[cell.first * stride];
+                    moved[lane] = none;
+                }
+                for (Size lane = 0; lane < count; ++lane) {
+                    const Size j = first + lane;
+                    if (j == 0)
+                        continue;
+                    const Size k = direction(j);
+                    for (const auto& cell : moves_[k])
+                        block[cell.first * Width + lane] += down(j) ? -cell.second : cell.second;
+                    moved[lane] = k;
+                }
+                evaluator_.loadInterleaved(block, count);
+                evaluator_.execute();
+                evaluator_.readOutputs(values_.data(), numOutputs_);
+
+                for (Size lane = 0; lane < count; ++lane) {
+                    const double* v = &values_[lane * numOutputs_];
+                    const Size j = first + lane;
+                    if (j == 0) {
+                        std::copy(v, v + numOutputs_, base_.begin());
+                        continue;
+                    }
+                    const Size k = direction(j);
+                    if (!central_) {
+                        for (Size o = 0; o < numOutputs_; ++o)
+                            store(k, o, (v[o] - base_[o]) / bumps_[k]);
+                    } else if (!down(j)) {
+                        std::copy(v, v + numOutputs_, up_.begin());
+                    } else {
+                        for (Size o = 0; o < numOutputs_; ++o)
+                            store(k, o, (up_[o] - v[o]) / (2.0 * bumps_[k]));
+                    }
+                }
+            }
+        }
+
+        // the direction moved in lane j > 0 of the scenario, and the sign
+        Size direction(Size j) const { return central_ ? (j - 1) / 2 : j - 1; }
+        bool down(Size j) const { return central_ && (j - 1) % 2 == 1; }
+
+        Size numInputs_, numOutputs_, lanes_ = 0;
+        // the (input, shift) cells moved by each direction
+        std::vector<std::vector<std::pair<Size, double>>> moves_;
+        std::vector<double> bumps_;
+        bool central_;
+        ForgeBatchEvaluator<Width> evaluator_;
+        std::vector<double> scratch_, values_, base_, up_;
+    };
+
+}
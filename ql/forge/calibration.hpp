@@ -0,0 +1,238 @@
+/*******************************************************************************
+
+   Model calibration on lane-batched kernels with AAD Jacobians.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Calibrating Heston or Bates through CalibratedModel::calibrate re-prices
+    every helper with the full engine for each residual evaluation, and
+    LevenbergMarquardt builds its Jacobian by bumping each parameter, so
+    one iteration costs (numParameters + 1) x numHelpers engine runs.
+
+    ForgeCalibrationCostFunction records the residual of one helper once,
+    with the model parameters as differentiated inputs and the helper data
+    (strike, maturity, market quote, ...) as plain inputs:
+
+        ForgeCalibrationCostFunction cost(5, helperData,
+            [](const std::vector<Real>& p, const std::vector<Real>& helper) {
+                return hestonPrice(p, helper[0], helper[1]) - helper[2];
+            });
+        LevenbergMarquardt method(1e-8, 1e-8, 1e-8, true);
+        Array params = initial;
+        forgeCalibrate(cost, params, method, EndCriteria(400, 40, 1e-8, 1e-8, 1e-8));
+
+    Since the helpers differ only in their data, the compiled kernel prices
+    all of them with one helper per lane, and the adjoints of each lane are
+    a row of the Jacobian: values() and jacobian() cost
+    ceil(numHelpers / Width) kernel executions together.  The cost function
+    overrides jacobian(), so LevenbergMarquardt must be constructed with
+    useCostFunctionsJacobian set; gradient() returns 2 J^T r for gradient
+    based methods.
+
+    The residual is recorded with the data of the first helper, so its
+    branches must not depend on the helper data or on the parameters in the
+    region explored by the optimiser; an engine with a maturity-dependent
+    number of integration points, for instance, needs one cost function per
+    group of helpers sharing that number.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/math/array.hpp>
+#include <ql/math/matrix.hpp>
+#include <ql/math/optimization/constraint.hpp>
+#include <ql/math/optimization/costfunction.hpp>
+#include <ql/math/optimization/endcriteria.hpp>
+#include <ql/math/optimization/method.hpp>
+#include <ql/math/optimization/problem.hpp>
+#include <ql/forge/batchevaluator.hpp>
+#include <ql/forge/kernelcache.hpp>
+#include <compiler/compiler_config.hpp>
+#include <graph/graph_recorder.hpp>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+namespace QuantLib {
+
+    /// residual of one calibration helper from model parameters and helper data
+    using ForgeResidualFunction =
+        std::function<Real(const std::vector<Real>& parameters, const std::vector<Real>& data)>;
+
+    /// calibration cost function evaluating all helpers in the lanes of one kernel
+    class ForgeCalibrationCostFunction : public CostFunction {
+      public:
+        /// helperData[k] holds the data of helper k, all of the same size;
+        /// weights, if given, multiply the residuals
+        ForgeCalibrationCostFunction(Size numParameters,
+                                     std::vector<std::vector<double>> helperData,
+                                     ForgeResidualFunction residual,
+                                     std::vector<double> weights = {},
+                                     const forge::CompilerConfig& config = forge::CompilerConfig())
+        : numParameters_(numParameters), data_(std::move(helperData)),
+          weights_(std::move(weights)), residual_(std::move(residual)), config_(config) {
+            QL_REQUIRE(numParameters_ > 0, "no calibration parameters");
+            QL_REQUIRE(!data_.empty(), "no calibration helpers");
+            numData_ = data_[0].size();
+            for (const auto& d : data_)
+                QL_REQUIRE(d.size() == numData_, "calibration helper data of size "
+                                                     << d.size() << " and " << numData_);
+            QL_REQUIRE(weights_.empty() || weights_.size() == data_.size(),
+                       weights_.size() << " weights given for " << data_.size() << " helpers");
+            const Size row = numParameters_ + numData_;
+            rows_.resize(data_.size() * row);
+            for (Size k = 0; k < data_.size(); ++k)
+                std::copy(data_[k].begin(), data_[k].end(), &rows_[k * row + numParameters_]);
+            residuals_.resize(data_.size());
+            jacobian_.resize(data_.size() * numParameters_);
+        }
+
+        Size numParameters() const { return numParameters_; }
+        Size numHelpers() const { return data_.size(); }
+        /// kernel passes over all helpers so far
+        Size evaluations() const { return evaluations_; }
+
+        /// weighted residuals of all helpers
+        Array values(const Array& x) const override {
+            evaluate(x, false);
+            Array r(residuals_.size());
+            for (Size k = 0; k < residuals_.size(); ++k)
+                r[k] = residuals_[k];
+            return r;
+        }
+
+        /// sum of squared weighted residuals
+        Real value(const Array& x) const override {
+            evaluate(x, false);
+            double s = 0.0;
+            for (double r : residuals_)
+                s += r * r;
+            return s;
+        }
+
+        void gradient(Array& grad, const Array& x) const override { valueAndGradient(grad, x); }
+
+        Real valueAndGradient(Array& grad, const Array& x) const override {
+            evaluate(x, true);
+            grad = Array(numParameters_, 0.0);
+            double s = 0.0;
+            for (Size k = 0; k < residuals_.size(); ++k) {
+                s += residuals_[k] * residuals_[k];
+                for (Size p = 0; p < numParameters_; ++p)
+                    grad[p] += 2.0 * residuals_[k] * jacobian_[k * numParameters_ + p];
+            }
+            return s;
+        }
+
+        /// d residual_k / d parameter_p
+        void jacobian(Matrix& jac, const Array& x) const override { valuesAndJacobian(jac, x); }
+
+        Array valuesAndJacobian(Matrix& jac, const Array& x) const override {
+            evaluate(x, true);
+            jac = Matrix(residuals_.size(), numParameters_);
+            Array r(residuals_.size());
+            for (Size k = 0; k < residuals_.size(); ++k) {
+                r[k] = residuals_[k];
+                for (Size p = 0; p < numParameters_; ++p)
+                    jac[k][p] = jacobian_[k * numParameters_ + p];
+            }
+            return r;
+        }
+
+      private:
+        void record() const {
+            forge::GraphRecorder recorder;
+            recorder.start();
+            std::vector<Real> parameters(numParameters_, 0.0), data(numData_);
+            parameterIds_.clear();
+            dataIds_.clear();
+            for (Size p = 0; p < numParameters_; ++p) {
+                parameters[p] = current_[p];
+                parameters[p].markForgeInputAndDiff();
+                parameterIds_.push_back(parameters[p].forgeNodeId());
+            }
+            for (Size d = 0; d < numData_; ++d) {
+                data[d] = data_[0][d];
+                data[d].markForgeInput();
+                dataIds_.push_back(data[d].forgeNodeId());
+            }
+            Real residual = residual_(parameters, data);
+            residual.markForgeOutput();
+            output_ = residual.forgeNodeId();
+            recorder.stop();
+
+            forge::ForgeEngine compiler(config_);
+            kernel_ = compiler.compile(recorder.graph());
+            QL_REQUIRE(kernel_ != nullptr, "Forge kernel compilation failed");
+            buffer_ = forge::NodeValueBufferFactory::create(recorder.graph(), *kernel_);
+        }
+
+        void evaluate(const Array& x, bool withJacobian) const {
+            QL_REQUIRE(x.size() == numParameters_,
+                       x.size() << " parameters given for " << numParameters_);
+            current_.resize(numParameters_);
+            for (Size p = 0; p < numParameters_; ++p)
+                current_[p] = forge::expr::value(x[p]);
+            if (kernel_ == nullptr)
+                record();
+
+            const Size n = data_.size(), row = numParameters_ + numData_;
+            for (Size k = 0; k < n; ++k)
+                std::copy(current_.begin(), current_.end(), &rows_[k * row]);
+            std::vector<forge::NodeId> inputs = parameterIds_;
+            inputs.insert(inputs.end(), dataIds_.begin(), dataIds_.end());
+            forgeWithBatchWidth(buffer_->getVectorWidth(), [&](auto w) {
+                constexpr Size W = decltype(w)::value;
+                ForgeBatchEvaluator<W> evaluator(*kernel_, *buffer_, inputs, {output_},
+                                                 parameterIds_);
+                evaluator.evaluate(rows_.data(), n, row, residuals_.data(),
+                                   withJacobian ? jacobian_.data() : nullptr);
+            });
+            if (!weights_.empty()) {
+                for (Size k = 0; k < n; ++k) {
+                    residuals_[k] *= weights_[k];
+                    if (withJacobian)
+                        for (Size p = 0; p < numParameters_; ++p)
+                            jacobian_[k * numParameters_ + p] *= weights_[k];
+                }
+            }
+            ++evaluations_;
+        }
+
+        Size numParameters_, numData_ = 0;
+        std::vector<std::vector<double>> data_;
+        std::vector<double> weights_;
+        ForgeResidualFunction residual_;
+        forge::CompilerConfig config_;
+
+        mutable ForgeKernelPtr kernel_;
+        mutable ForgeBufferPtr buffer_;
+        mutable std::vector<forge::NodeId> parameterIds_, dataIds_;
+        mutable forge::NodeId output_ = 0;
+        mutable std::vector<double> current_, rows_, residuals_, jacobian_;
+        mutable Size evaluations_ = 0;
+    };
+
+    /// minimises the cost function from params, which receives the result
+    inline EndCriteria::Type forgeCalibrate(ForgeCalibrationCostFunction& cost,
+                                            Array& params,
+                                            OptimizationMethod& method,
+                                            const EndCriteria& endCriteria,
+                                            Constraint constraint = NoConstraint()) {
+        Problem problem(cost, constraint, params);
+        EndCriteria::Type result = method.minimize(problem, endCriteria);
+        params = problem.currentValue();
+        return result;
+    }
+
+}
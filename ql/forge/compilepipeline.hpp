@@ -0,0 +1,223 @@
+/*******************************************************************************
+
+   Background kernel compilation overlapping with evaluation.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    A book of many small trades alternates record, compile and evaluate for
+    every (trade, date); compilation is often as expensive as evaluating
+    all paths, and both run on the same core.  ForgeCompilePipeline moves
+    compilation (and buffer allocation) to background threads: recorded
+    graphs are submitted and a std::future of the compiled kernel comes
+    back, so the driver thread can evaluate kernel k while kernels
+    k + 1 .. k + n compile,
+
+        ForgeCompilePipeline pipeline(config);
+        forgePipelined(pipeline, numKernels, 2,
+            [&](Size k) { ... record kernel k ...; return recorder.graph(); },
+            [&](Size k, ForgeCompiledKernel& compiled) {
+                ... evaluate all paths with compiled.kernel, compiled.buffer ...
+            });
+
+    and the end-to-end time approaches max(compile, evaluate) rather than
+    their sum.  Recording stays on the driver thread, so node ids captured
+    while recording kernel k are used unchanged with its buffer.
+
+    With a ForgeKernelCache, structurally identical graphs are compiled
+    once; the cache is safe to share with other users.  Compile errors are
+    rethrown by the future's get().  The destructor compiles what is still
+    queued before joining the threads, so no future is left broken.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/kernelcache.hpp>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace QuantLib {
+
+    /// threading options for ForgeCompilePipeline
+    struct ForgeCompilePipelineOptions {
+        /// compiler threads, 0 for all but one hardware thread (at least one)
+        Size numThreads = 1;
+        /// graphs waiting for a compiler thread before submit() blocks, 0 for no limit
+        Size maxQueued = 0;
+    };
+
+    /// what a submitted graph turns into
+    struct ForgeCompiledKernel {
+        std::shared_ptr<ForgeKernel> kernel;
+        ForgeBufferPtr buffer;
+        /// compile and buffer allocation time on the compiler thread
+        double compileSeconds = 0.0;
+        /// true if the kernel came from the cache
+        bool cacheHit = false;
+    };
+
+    /// compiles recorded graphs on background threads
+    class ForgeCompilePipeline {
+      public:
+        using Options = ForgeCompilePipelineOptions;
+
+        explicit ForgeCompilePipeline(const forge::CompilerConfig& config = forge::CompilerConfig(),
+                                      const Options& options = Options())
+        : config_(config), cache_(nullptr) {
+            start(options);
+        }
+
+        /// compiles through a kernel cache, which must outlive the pipeline
+        explicit ForgeCompilePipeline(ForgeKernelCache& cache, const Options& options = Options())
+        : config_(cache.config()), cache_(&cache) {
+            start(options);
+        }
+
+        ForgeCompilePipeline(const ForgeCompilePipeline&) = delete;
+        ForgeCompilePipeline& operator=(const ForgeCompilePipeline&) = delete;
+
+        ~ForgeCompilePipeline() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            ready_.notify_all();
+            space_.notify_all();
+            for (std::thread& t : threads_)
+                t.join();
+        }
+
+        /// queues a graph for compilation; blocks while maxQueued graphs are waiting
+        std::future<ForgeCompiledKernel> submit(forge::Graph graph) {
+            Task task;
+            task.graph = std::move(graph);
+            std::future<ForgeCompiledKernel> result = task.promise.get_future();
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                space_.wait(lock, [this] { return maxQueued_ == 0 || queue_.size() < maxQueued_; });
+                queue_.push_back(std::move(task));
+            }
+            ready_.notify_one();
+            return result;
+        }
+
+        /// graphs submitted but not yet picked up by a compiler thread
+        Size queued() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return queue_.size();
+        }
+        /// graphs compiled (or failed) so far
+        Size compiled() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return compiled_;
+        }
+        Size threads() const { return threads_.size(); }
+        const forge::CompilerConfig& config() const { return config_; }
+
+      private:
+        struct Task {
+            forge::Graph graph;
+            std::promise<ForgeCompiledKernel> promise;
+        };
+
+        void start(const Options& options) {
+            Size n = options.numThreads;
+            if (n == 0)
+                n = std::max<Size>(1, Size(std::thread::hardware_concurrency()) - 1);
+            maxQueued_ = options.maxQueued;
+            threads_.reserve(n);
+            for (Size i = 0; i < n; ++i)
+                threads_.emplace_back([this] { work(); });
+        }
+
+        void work() {
+            for (;;) {
+                Task task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    ready_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+                    if (queue_.empty())
+                        return;
+                    task = std::move(queue_.front());
+                    queue_.pop_front();
+                }
+                space_.notify_one();
+                try {
+                    task.promise.set_value(compile(task.graph));
+                } catch (...) {
+                    task.promise.set_exception(std::current_exception());
+                }
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++compiled_;
+            }
+        }
+
+        ForgeCompiledKernel compile(const forge::Graph& graph) const {
+            auto start = std::chrono::steady_clock::now();
+            ForgeCompiledKernel result;
+            if (cache_ != nullptr) {
+                ForgeKernelCache::Entry entry = cache_->acquire(graph);
+                result.kernel = std::move(entry.kernel);
+                result.buffer = std::move(entry.buffer);
+                result.cacheHit = entry.hit;
+            } else {
+                forge::ForgeEngine compiler(config_);
+                result.kernel = std::shared_ptr<ForgeKernel>(compiler.compile(graph));
+                QL_REQUIRE(result.kernel != nullptr, "Forge kernel compilation failed");
+                result.buffer = forge::NodeValueBufferFactory::create(graph, *result.kernel);
+            }
+            result.compileSeconds =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return result;
+        }
+
+        forge::CompilerConfig config_;
+        ForgeKernelCache* cache_;
+        Size maxQueued_ = 0;
+
+        mutable std::mutex mutex_;
+        std::condition_variable ready_, space_;
+        std::deque<Task> queue_;
+        std::vector<std::thread> threads_;
+        Size compiled_ = 0;
+        bool stop_ = false;
+    };
+
+    /// records, compiles and evaluates count kernels with lookahead kernels compiling ahead
+    /// record(k) runs on the calling thread and returns the graph of kernel k;
+    /// evaluate(k, compiled) runs on the calling thread, in order of k.
+    template <class Record, class Evaluate>
+    void forgePipelined(ForgeCompilePipeline& pipeline,
+                        Size count,
+                        Size lookahead,
+                        Record record,
+                        Evaluate evaluate) {
+        std::deque<std::future<ForgeCompiledKernel>> inFlight;
+        Size submitted = 0;
+        for (Size k = 0; k < count; ++k) {
+            while (submitted < count && submitted <= k + lookahead)
+                inFlight.push_back(pipeline.submit(record(submitted++)));
+            ForgeCompiledKernel compiled = inFlight.front().get();
+            inFlight.pop_front();
+            evaluate(k, compiled);
+        }
+    }
+
+}
@@ -0,0 +1,310 @@
+/*******************************************************************************
+
+   Streaming exposure aggregates (EPE, ENE, PFE) per trade and date.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Exposure simulation only needs aggregates of the path values at each
+    (trade, date): the expected positive and negative exposure, their
+    dispersion, and a high quantile of the positive exposure for PFE.
+    Keeping every path value to compute them afterwards takes
+    trades x dates x paths doubles, tens of GB for a large book.
+    ForgeExposureAccumulator folds the values into running sums and
+    constant-size quantile sketches as they come out of the kernel,
+
+        ForgeExposureAccumulator exposures(numTrades, numDates);
+        for (each batch of paths) {
+            evaluator.loadInterleaved(...);
+            evaluator.execute();
+            exposures.add(trade, date, evaluator);   // reads the output lanes
+        }
+        double epe = exposures.epe(trade, date), pfe = exposures.pfe(trade, date);
+
+    and keeps the path values only if asked to (ForgeExposureOptions::storedPaths).
+
+    Quantiles use the P-square algorithm (Jain and Chlamtac, 1985): five
+    markers per quantile, adjusted by piecewise-parabolic interpolation as
+    values arrive, with an error well below the Monte Carlo error of the
+    quantile itself for the path counts used in exposure simulation.  The
+    sketches depend on the order of the values and cannot be merged, so a
+    (trade, date) cell should be fed by one thread; the sums can be merged.
+
+    Netting-set exposure is the positive part of the sum of the trade
+    values on each path, which the per-trade aggregates cannot give; add
+    the netted value of each path as a trade of its own for that.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/batchevaluator.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace QuantLib {
+
+    /// streaming estimate of one quantile with the P-square algorithm
+    class ForgeP2Quantile {
+      public:
+        explicit ForgeP2Quantile(double probability) : p_(probability) {
+            QL_REQUIRE(p_ > 0.0 && p_ < 1.0, "quantile probability " << p_ << " not in (0, 1)");
+            const double increments[5] = {0.0, p_ / 2.0, p_, (1.0 + p_) / 2.0, 1.0};
+            std::copy(increments, increments + 5, increments_);
+        }
+
+        void add(double x) {
+            if (count_ < 5) {
+                heights_[count_++] = x;
+                if (count_ == 5) {
+                    std::sort(heights_, heights_ + 5);
+                    for (Size i = 0; i < 5; ++i) {
+                        positions_[i] = double(i);
+                        desired_[i] = 4.0 * increments_[i];
+                    }
+                }
+                return;
+            }
+            ++count_;
+            Size k;
+            if (x < heights_[0]) {
+                heights_[0] = x;
+                k = 0;
+            } else if (x >= heights_[4]) {
+                heights_[4] = std::max(heights_[4], x);
+                k = 3;
+            } else {
+                k = 0;
+                while (x >= heights_[k + 1])
+                    ++k;
+            }
+            for (Size i = k + 1; i < 5; ++i)
+                positions_[i] += 1.0;
+            for (Size i = 0; i < 5; ++i)
+                desired_[i] += increments_[i];
+
+            for (Size i = 1; i < 4; ++i) {
+                double d = desired_[i] - positions_[i];
+                if ((d >= 1.0 && positions_[i + 1] - positions_[i] > 1.0) ||
+                    (d <= -1.0 && positions_[i - 1] - positions_[i] < -1.0)) {
+                    const int s = d > 0.0 ? 1 : -1;
+                    double q = parabolic(i, s);
+                    if (heights_[i - 1] < q && q < heights_[i + 1])
+                        heights_[i] = q;
+                    else
+                        heights_[i] = linear(i, s);
+                    positions_[i] += s;
+                }
+            }
+        }
+
+        /// the estimate; exact (by linear interpolation) for fewer than five values
+        double value() const {
+            QL_REQUIRE(count_ > 0, "no values for the quantile");
+            if (count_ >= 5)
+                return heights_[2];
+            double sorted[5];
+            std::copy(heights_, heights_ + count_, sorted);
+            std::sort(sorted, sorted + count_);
+            double h = p_ * (count_ - 1);
+            Size lo = Size(std::floor(h));
+            Size hi = std::min(lo + 1, count_ - 1);
+            return sorted[lo] + (h - lo) * (sorted[hi] - sorted[lo]);
+        }
+
+        double probability() const { return p_; }
+        Size count() const { return count_; }
+
+      private:
+        double parabolic(Size i, int s) const {
+            const double* n = positions_;
+            const double* q = heights_;
+            return q[i] + s / (n[i + 1] - n[i - 1]) *
+                              ((n[i] - n[i - 1] + s) * (q[i + 1] - q[i]) / (n[i + 1] - n[i]) +
+                               (n[i + 1] - n[i] - s) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+        }
+        double linear(Size i, int s) const {
+            return heights_[i] +
+                   s * (heights_[i + s] - heights_[i]) / (positions_[i + s] - positions_[i]);
+        }
+
+        double p_;
+        Size count_ = 0;
+        double heights_[5] = {}, positions_[5] = {}, desired_[5] = {}, increments_[5] = {};
+    };
+
+    /// running sums of the path values V of one (trade, date)
+    struct ForgeExposureStats {
+        Size count = 0;
+        double sum = 0.0, sumSquares = 0.0;
+        /// sums of max(V, 0), max(V, 0)^2 and min(V, 0)
+        double positiveSum = 0.0, positiveSumSquares = 0.0, negativeSum = 0.0;
+
+        void add(double v) {
+            ++count;
+            sum += v;
+            sumSquares += v * v;
+            if (v > 0.0) {
+                positiveSum += v;
+                positiveSumSquares += v * v;
+            } else {
+                negativeSum += v;
+            }
+        }
+
+        void merge(const ForgeExposureStats& other) {
+            count += other.count;
+            sum += other.sum;
+            sumSquares += other.sumSquares;
+            positiveSum += other.positiveSum;
+            positiveSumSquares += other.positiveSumSquares;
+            negativeSum += other.negativeSum;
+        }
+
+        double mean() const { return count > 0 ? sum / count : 0.0; }
+        /// expected positive exposure E[max(V, 0)]
+        double epe() const { return count > 0 ? positiveSum / count : 0.0; }
+        /// expected negative exposure E[min(V, 0)], not positive
+        double ene() const { return count > 0 ? negativeSum / count : 0.0; }
+        /// sample variance of V
+        double variance() const {
+            if (count < 2)
+                return 0.0;
+            double m = mean();
+            return std::max(0.0, (sumSquares - count * m * m) / (count - 1));
+        }
+        /// Monte Carlo standard error of epe()
+        double epeError() const {
+            if (count < 2)
+                return 0.0;
+            double m = epe();
+            double v = std::max(0.0, (positiveSumSquares - count * m * m) / (count - 1));
+            return std::sqrt(v / count);
+        }
+    };
+
+    struct ForgeExposureOptions {
+        /// probabilities of the PFE quantiles of max(V, 0)
+        std::vector<double> pfeQuantiles = {0.95};
+        /// if positive, the values of the first storedPaths paths of each cell are kept
+        Size storedPaths = 0;
+    };
+
+    /// exposure aggregates of trades x dates, fed path by path or lane by lane
+    class ForgeExposureAccumulator {
+      public:
+        ForgeExposureAccumulator(Size trades, Size dates, ForgeExposureOptions options = ForgeExposureOptions())
+        : trades_(trades), dates_(dates), options_(std::move(options)), stats_(trades * dates) {
+            sketches_.reserve(trades * dates * options_.pfeQuantiles.size());
+            for (Size c = 0; c < trades * dates; ++c)
+                for (double p : options_.pfeQuantiles)
+                    sketches_.emplace_back(p);
+            paths_.assign(trades * dates * options_.storedPaths, 0.0);
+        }
+
+        void add(Size trade, Size date, double value) {
+            const Size c = cell(trade, date);
+            ForgeExposureStats& s = stats_[c];
+            // paths beyond the first storedPaths enter the aggregates only
+            if (s.count < options_.storedPaths)
+                paths_[c * options_.storedPaths + s.count] = value;
+            s.add(value);
+            const Size n = options_.pfeQuantiles.size();
+            const double positive = std::max(value, 0.0);
+            for (Size q = 0; q < n; ++q)
+                sketches_[c * n + q].add(positive);
+        }
+
+        /// adds values[i * stride] for i < count
+        void add(Size trade, Size date, const double* values, Size count, Size stride = 1) {
+            for (Size i = 0; i < count; ++i)
+                add(trade, date, values[i * stride]);
+        }
+
+        /// adds the valid lanes of one output of the evaluator's last execution
+        template <Size Width>
+        void add(Size trade, Size date, const ForgeBatchEvaluator<Width>& evaluator, Size output = 0) {
+            const Size n = evaluator.numOutputs();
+            QL_REQUIRE(output < n, "output " << output << " out of range");
+            scratch_.resize(Width * n);
+            evaluator.readOutputs(scratch_.data(), n);
+            add(trade, date, scratch_.data() + output, evaluator.count(), n);
+        }
+
+        /// adds the sums of another accumulator of the same shape and no quantiles
+        void merge(const ForgeExposureAccumulator& other) {
+            QL_REQUIRE(other.trades_ == trades_ && other.dates_ == dates_,
+                       "cannot merge exposure accumulators of different shapes");
+            QL_REQUIRE(options_.pfeQuantiles.empty() && other.options_.pfeQuantiles.empty() &&
+                           options_.storedPaths == 0 && other.options_.storedPaths == 0,
+                       "quantile sketches and stored paths cannot be merged");
+            for (Size c = 0; c < stats_.size(); ++c)
+                stats_[c].merge(other.stats_[c]);
+        }
+
+        const ForgeExposureStats& stats(Size trade, Size date) const {
+            return stats_[cell(trade, date)];
+        }
+        double epe(Size trade, Size date) const { return stats(trade, date).epe(); }
+        double ene(Size trade, Size date) const { return stats(trade, date).ene(); }
+        /// the quantile-th PFE quantile of max(V, 0)
+        double pfe(Size trade, Size date, Size quantile = 0) const {
+            const Size n = options_.pfeQuantiles.size();
+            QL_REQUIRE(quantile < n, "PFE quantile " << quantile << " out of range");
+            return sketches_[cell(trade, date) * n + quantile].value();
+        }
+        /// EPE of a trade at every date
+        std::vector<double> epeProfile(Size trade) const {
+            std::vector<double> profile(dates_);
+            for (Size d = 0; d < dates_; ++d)
+                profile[d] = epe(trade, d);
+            return profile;
+        }
+        /// EPE averaged over all trades and dates, weighted by path counts
+        double expectedExposure() const {
+            double sum = 0.0;
+            Size count = 0;
+            for (const ForgeExposureStats& s : stats_) {
+                sum += s.positiveSum;
+                count += s.count;
+            }
+            return count > 0 ? sum / count : 0.0;
+        }
+
+        bool storesPaths() const { return options_.storedPaths > 0; }
+        /// stored value V of a path
+        double value(Size trade, Size date, Size path) const {
+            const Size c = cell(trade, date);
+            QL_REQUIRE(path < stats_[c].count && path < options_.storedPaths,
+                       "path " << path << " of trade " << trade << ", date " << date
+                               << " not stored");
+            return paths_[c * options_.storedPaths + path];
+        }
+
+        Size trades() const { return trades_; }
+        Size dates() const { return dates_; }
+        const ForgeExposureOptions& options() const { return options_; }
+
+      private:
+        Size cell(Size trade, Size date) const {
+            QL_REQUIRE(trade < trades_ && date < dates_,
+                       "exposure cell (" << trade << ", " << date << ") out of range");
+            return trade * dates_ + date;
+        }
+
+        Size trades_, dates_;
+        ForgeExposureOptions options_;
+        std::vector<ForgeExposureStats> stats_;
+        std::vector<ForgeP2Quantile> sketches_;
+        std::vector<double> paths_, scratch_;
+    };
+
+}
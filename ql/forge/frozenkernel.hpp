@@ -0,0 +1,93 @@
+/*******************************************************************************
+
+   Kernels specialised on frozen input values.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    In a partial stress only some of the inputs move: an IR-only run of
+    priceSwap100RF shocks the rate factors while the 25 vol surface factors
+    and the own-spread curve keep their base values in every scenario.  The
+    kernel still evaluates, and differentiates, everything that depends on
+    them alone.
+
+    ForgeFrozenKernelCache keeps the recorded graph and hands out kernels
+    specialised on a set of frozen input values: the frozen inputs become
+    constants (forgeFreezeInputs), activity is propagated again, and the
+    compiler folds every node depending on frozen inputs only.
+
+        ForgeFrozenKernelCache kernels(recorder.graph());
+        auto entry = kernels.specialise(volAndSpreadIds, baseValues);
+        ForgeBatchEvaluator<4> evaluator(*entry.kernel, *entry.buffer,
+                                         kernels.freeInputs(inputs, volAndSpreadIds),
+                                         {npv}, kernels.freeInputs(inputs, volAndSpreadIds));
+
+    Specialised kernels are cached through a ForgeKernelCache: a frozen
+    graph hashes with its constants, so the cache is keyed by the frozen
+    set and its values, and running the same partial stress again, or on
+    another structurally identical trade, compiles nothing.  Inactive
+    folding is switched on in the configuration, as it is what removes
+    the frozen sub-graphs.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/graphhash.hpp>
+#include <ql/forge/kernelcache.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace QuantLib {
+
+    /// compiles and caches specialisations of one graph on frozen inputs
+    class ForgeFrozenKernelCache {
+      public:
+        using Entry = ForgeKernelCache::Entry;
+
+        explicit ForgeFrozenKernelCache(forge::Graph graph,
+                                        forge::CompilerConfig config = forge::CompilerConfig())
+        : graph_(std::move(graph)), cache_(foldingConfig(config)) {}
+
+        /// a kernel with nodes[k] frozen at values[k], and a buffer for it
+        Entry specialise(const std::vector<forge::NodeId>& nodes, const std::vector<double>& values) {
+            return cache_.acquire(forgeFreezeInputs(graph_, nodes, values));
+        }
+
+        /// the kernel of the graph with no input frozen
+        Entry unspecialised() { return cache_.acquire(graph_); }
+
+        /// inputs with the frozen ones removed, in their original order
+        static std::vector<forge::NodeId> freeInputs(const std::vector<forge::NodeId>& inputs,
+                                                     const std::vector<forge::NodeId>& frozen) {
+            std::vector<forge::NodeId> free;
+            for (auto id : inputs)
+                if (std::find(frozen.begin(), frozen.end(), id) == frozen.end())
+                    free.push_back(id);
+            return free;
+        }
+
+        const forge::Graph& graph() const { return graph_; }
+        /// number of distinct specialisations compiled
+        Size size() const { return cache_.size(); }
+        Size hits() const { return cache_.hits(); }
+        Size misses() const { return cache_.misses(); }
+
+      private:
+        static forge::CompilerConfig foldingConfig(forge::CompilerConfig config) {
+            config.enableInactiveFolding = true;
+            return config;
+        }
+
+        forge::Graph graph_;
+        ForgeKernelCache cache_;
+    };
+
+}
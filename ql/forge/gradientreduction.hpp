@@ -0,0 +1,241 @@
+/*******************************************************************************
+
+   Deterministic multi-threaded reduction of per-scenario gradients.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Portfolio sensitivities are sums over trades and paths of the adjoints
+    of each kernel execution.  Storing every gradient row and summing
+    afterwards costs a paths x factors array and a serial pass; summing
+    into per-thread totals instead makes the result depend on which thread
+    claimed which chunk, so the last bits change with the thread count and
+    from run to run.
+
+    ForgeGradientReduction fixes the summation order independently of the
+    threads.  The scenario range is cut into blocks of a fixed size; each
+    block has its own accumulator row, padded to whole cache lines, which
+    the thread that claimed the block fills in scenario order without
+    contention.  sums() then combines the rows by a pairwise tree in block
+    order, whose shape depends on the number of blocks alone,
+
+        ForgeGradientReduction reduction(numFactors, numPaths, 256);
+        evaluator.run(reduction.numBlocks(), [&](auto& buffer, Size first, Size last, Size) {
+            for (Size b = first; b < last; ++b)
+                for (Size p = reduction.blockBegin(b); p < reduction.blockEnd(b); ++p)
+                    reduction.add(b, gradientOf(p));
+        });
+        std::vector<double> portfolio = reduction.sums();
+
+    so the result is bit-identical for any number of threads and chunk size,
+    given the block size.  With ForgeSummation::Compensated, the blocks keep
+    Kahan-Babuska (Neumaier) compensations which the tree carries along, for
+    sums with cancellation or many small terms; the pairwise tree bounds the
+    error growth of the plain sums across blocks already.  Neither survives
+    compilation with -ffast-math, which may reassociate the additions.
+
+    forgeParallelGradientSums() runs a kernel over row-major scenarios on a
+    ForgeParallelScenarioEvaluator this way and returns the sums of the
+    outputs and of their adjoints in one streaming pass.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/batchevaluator.hpp>
+#include <ql/forge/parallelevaluator.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace QuantLib {
+
+    /// summation within the blocks of a ForgeGradientReduction
+    enum class ForgeSummation {
+        Plain,       ///< running sums
+        Compensated  ///< running sums with Kahan-Babuska compensation
+    };
+
+    /// sums of per-scenario vectors in an order fixed by the block size alone
+    class ForgeGradientReduction {
+      public:
+        static constexpr Size alignment = 64;
+
+        ForgeGradientReduction(Size numValues,
+                               Size numScenarios,
+                               Size blockSize = 256,
+                               ForgeSummation summation = ForgeSummation::Plain)
+        : numValues_(numValues), numScenarios_(numScenarios), blockSize_(blockSize),
+          summation_(summation) {
+            QL_REQUIRE(numValues_ > 0, "no values to reduce");
+            QL_REQUIRE(blockSize_ > 0, "block size must be positive");
+            numBlocks_ = (numScenarios_ + blockSize_ - 1) / blockSize_;
+            // sums, then compensations, rounded up to whole cache lines
+            const Size perLine = alignment / sizeof(double);
+            const Size used = summation_ == ForgeSummation::Compensated ? 2 * numValues_ : numValues_;
+            rowSize_ = (used + perLine - 1) / perLine * perLine;
+            storage_.assign(numBlocks_ * rowSize_ + perLine, 0.0);
+        }
+
+        ForgeGradientReduction(ForgeGradientReduction&&) = default;
+        ForgeGradientReduction& operator=(ForgeGradientReduction&&) = default;
+        ForgeGradientReduction(const ForgeGradientReduction&) = delete;
+        ForgeGradientReduction& operator=(const ForgeGradientReduction&) = delete;
+
+        Size numValues() const { return numValues_; }
+        Size numScenarios() const { return numScenarios_; }
+        Size blockSize() const { return blockSize_; }
+        Size numBlocks() const { return numBlocks_; }
+        ForgeSummation summation() const { return summation_; }
+
+        /// scenarios [blockBegin(b), blockEnd(b)) make up block b
+        Size blockBegin(Size b) const { return b * blockSize_; }
+        Size blockEnd(Size b) const { return std::min(numScenarios_, (b + 1) * blockSize_); }
+        Size blockOf(Size scenario) const { return scenario / blockSize_; }
+
+        /// adds values[i * stride] of one scenario to block b
+        /// A block must be filled by one thread at a time, and in the same
+        /// order on every run (scenario order, usually) for reproducible sums.
+        void add(Size b, const double* values, Size stride = 1) {
+            QL_REQUIRE(b < numBlocks_, "block " << b << " out of range");
+            double* sums = row(b);
+            if (summation_ == ForgeSummation::Plain) {
+                for (Size i = 0; i < numValues_; ++i)
+                    sums[i] += values[i * stride];
+            } else {
+                double* compensations = sums + numValues_;
+                for (Size i = 0; i < numValues_; ++i)
+                    twoSum(sums[i], compensations[i], values[i * stride]);
+            }
+        }
+
+        /// partial sums of block b
+        const double* blockSums(Size b) const {
+            QL_REQUIRE(b < numBlocks_, "block " << b << " out of range");
+            return row(b);
+        }
+
+        /// clears every block
+        void reset() { std::fill(storage_.begin(), storage_.end(), 0.0); }
+
+        /// sums over all scenarios, the blocks combined pairwise in block order
+        std::vector<double> sums() const {
+            std::vector<double> result(numValues_, 0.0);
+            if (numBlocks_ == 0)
+                return result;
+            const bool compensated = summation_ == ForgeSummation::Compensated;
+            const Size width = compensated ? 2 * numValues_ : numValues_;
+            std::vector<double> tree(numBlocks_ * width);
+            for (Size b = 0; b < numBlocks_; ++b)
+                std::copy(row(b), row(b) + width, tree.begin() + b * width);
+            // level by level: block b takes in block b + step, for b a multiple of 2 step
+            for (Size step = 1; step < numBlocks_; step *= 2) {
+                for (Size b = 0; b + step < numBlocks_; b += 2 * step) {
+                    double* left = &tree[b * width];
+                    const double* right = &tree[(b + step) * width];
+                    if (!compensated) {
+                        for (Size i = 0; i < numValues_; ++i)
+                            left[i] += right[i];
+                    } else {
+                        for (Size i = 0; i < numValues_; ++i) {
+                            left[numValues_ + i] += right[numValues_ + i];
+                            twoSum(left[i], left[numValues_ + i], right[i]);
+                        }
+                    }
+                }
+            }
+            for (Size i = 0; i < numValues_; ++i)
+                result[i] = compensated ? tree[i] + tree[numValues_ + i] : tree[i];
+            return result;
+        }
+
+      private:
+        // sum += x, keeping the rounding error in compensation (Neumaier)
+        static void twoSum(double& sum, double& compensation, double x) {
+            const double t = sum + x;
+            if (std::fabs(sum) >= std::fabs(x))
+                compensation += (sum - t) + x;
+            else
+                compensation += (x - t) + sum;
+            sum = t;
+        }
+
+        // rows start on a cache line; the storage is never copied, so the
+        // offset into it stays the same for the lifetime of the reduction
+        double* row(Size b) { return storage_.data() + offset() + b * rowSize_; }
+        const double* row(Size b) const { return storage_.data() + offset() + b * rowSize_; }
+        Size offset() const {
+            const auto address = reinterpret_cast<std::uintptr_t>(storage_.data());
+            return (alignment - address % alignment) % alignment / sizeof(double);
+        }
+
+        Size numValues_, numScenarios_, blockSize_, numBlocks_ = 0, rowSize_ = 0;
+        ForgeSummation summation_;
+        std::vector<double> storage_;
+    };
+
+    /// sums over scenarios of the outputs and of the adjoints of the first output
+    struct ForgeGradientSums {
+        Size scenarios = 0;
+        std::vector<double> values, gradients;
+    };
+
+    /// evaluates row-major scenarios (inputs of scenario p at scenarios + p * stride)
+    /// on every thread of the evaluator and reduces outputs and gradients in a
+    /// thread-independent order
+    inline ForgeGradientSums forgeParallelGradientSums(ForgeParallelScenarioEvaluator& evaluator,
+                                                       const std::vector<forge::NodeId>& inputs,
+                                                       const std::vector<forge::NodeId>& outputs,
+                                                       const std::vector<forge::NodeId>& gradientInputs,
+                                                       const double* scenarios,
+                                                       Size numScenarios,
+                                                       Size stride,
+                                                       Size blockSize = 256,
+                                                       ForgeSummation summation = ForgeSummation::Plain) {
+        const Size m = outputs.size(), n = gradientInputs.size();
+        QL_REQUIRE(m > 0, "no outputs given for the gradient sums");
+        ForgeGradientReduction reduction(m + n, numScenarios, blockSize, summation);
+        // the work items handed to the threads are blocks, not scenarios
+        evaluator.run(reduction.numBlocks(), [&](ForgeBuffer& buffer, Size first, Size last, Size) {
+            forgeWithBatchWidth(Size(buffer.getVectorWidth()), [&](auto w) {
+                constexpr Size W = decltype(w)::value;
+                ForgeBatchEvaluator<W> batch(evaluator.kernel(), buffer, inputs, outputs,
+                                             gradientInputs);
+                std::vector<double> values(W * m), gradients(W * n), row(m + n);
+                for (Size b = first; b < last; ++b) {
+                    const Size end = reduction.blockEnd(b);
+                    for (Size p = reduction.blockBegin(b); p < end; p += W) {
+                        const Size count = std::min(W, end - p);
+                        batch.load([&](Size lane) { return scenarios + (p + lane) * stride; },
+                                   count);
+                        batch.execute();
+                        batch.readOutputs(values.data(), m);
+                        batch.readGradients(gradients.data(), n);
+                        for (Size lane = 0; lane < count; ++lane) {
+                            const double* v = values.data() + lane * m;
+                            const double* g = gradients.data() + lane * n;
+                            std::copy(v, v + m, row.begin());
+                            std::copy(g, g + n, row.begin() + m);
+                            reduction.add(b, row.data());
+                        }
+                    }
+                }
+            });
+        });
+        const std::vector<double> sums = reduction.sums();
+        ForgeGradientSums result;
+        result.scenarios = numScenarios;
+        result.values.assign(sums.begin(), sums.begin() + m);
+        result.gradients.assign(sums.begin() + m, sums.end());
+        return result;
+    }
+
+}
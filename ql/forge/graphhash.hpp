@@ -0,0 +1,478 @@
+/*******************************************************************************
+
+   Structural hashing of recorded Forge graphs.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Two graphs recorded from the same pricing code with the same trade
+    terms produce the same node sequence: the hash below covers opcodes,
+    operand topology, activity flags and the output / differentiation
+    sets.  The values of inactive nodes (the constants) are hashed as well
+    by default; values recorded on active nodes are not, so recordings at
+    different market data still hash identically.  Constants can be left
+    out of the hash when the caller feeds them as kernel inputs instead of
+    letting them be folded into the compiled code.
+
+    forgeFreezeInputs() rewrites selected inputs of a graph into constants,
+    for kernels specialised on inputs that do not change across scenarios.
+
+    The fields of forge::Node (opcodes, operand slots, activity) are only
+    read here; other headers go through forgeNodeInfo(), forgeOpcodeTable()
+    and the layout functions below, so any adaptation to what Forge stores
+    in a node belongs in this file.  The Graph containers are used
+    elsewhere as whole vectors: graphstore.hpp writes nodes and constPool
+    as raw bytes, guarded by forgeOpcodeFingerprint(), and
+    recordingprofiler.hpp counts nodes.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <expressions/ExpressionTemplates/ForgeFusion.hpp>
+#include <graph/graph_recorder.hpp>
+#include <compiler/compiler_config.hpp>
+#include <types/fbool.hpp>
+#include <types/fdouble.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace QuantLib {
+
+    /// options controlling what enters the structural hash
+    struct ForgeGraphHashOptions {
+        /// include constant values (immediates and the constant pool)
+        /// Only switch this off if every constant that varies between trades
+        /// is fed to the kernel as an input; otherwise kernels compiled for one
+        /// trade would be reused with another trade's constants baked in.
+        bool includeConstants = true;
+    };
+
+    namespace detail {
+
+        // 64-bit FNV-1a over arbitrary words, with a final avalanche so
+        // that graphs differing only in the last node still spread well.
+        class ForgeHasher {
+          public:
+            static constexpr std::uint64_t offsetBasis = 14695981039346656037ULL;
+            static constexpr std::uint64_t prime = 1099511628211ULL;
+
+            void add(std::uint64_t word) {
+                for (int i = 0; i < 8; ++i) {
+                    h_ ^= (word >> (8 * i)) & 0xffU;
+                    h_ *= prime;
+                }
+            }
+            void add(double x) {
+                // normalise -0.0 so that it hashes as 0.0
+                if (x == 0.0)
+                    x = 0.0;
+                std::uint64_t bits;
+                std::memcpy(&bits, &x, sizeof(bits));
+                add(bits);
+            }
+            template <class E, typename std::enable_if<std::is_enum<E>::value, int>::type = 0>
+            void add(E e) {
+                add(static_cast<std::uint64_t>(e));
+            }
+            void add(bool b) { add(std::uint64_t(b ? 1 : 0)); }
+
+            std::uint64_t value() const {
+                std::uint64_t z = h_;
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+                return z ^ (z >> 31);
+            }
+
+          private:
+            std::uint64_t h_ = offsetBasis;
+        };
+
+    }
+
+    /// structural hash of a recorded graph
+    inline std::uint64_t
+    forgeGraphHash(const forge::Graph& graph,
+                   const ForgeGraphHashOptions& options = ForgeGraphHashOptions()) {
+        detail::ForgeHasher h;
+        h.add(std::uint64_t(graph.nodes.size()));
+        for (const auto& node : graph.nodes) {
+            h.add(node.op);
+            h.add(std::uint64_t(node.a));
+            h.add(std::uint64_t(node.b));
+            h.add(std::uint64_t(node.c));
+            h.add(node.isActive);
+            h.add(node.needsGradient);
+            // active nodes carry the value seen at recording time in imm,
+            // which is not part of the structure
+            if (options.includeConstants && !node.isActive)
+                h.add(double(node.imm));
+        }
+        h.add(std::uint64_t(graph.outputs.size()));
+        for (auto id : graph.outputs)
+            h.add(std::uint64_t(id));
+        h.add(std::uint64_t(graph.diff_inputs.size()));
+        for (auto id : graph.diff_inputs)
+            h.add(std::uint64_t(id));
+        if (options.includeConstants) {
+            h.add(std::uint64_t(graph.constPool.size()));
+            for (auto c : graph.constPool)
+                h.add(double(c));
+        }
+        return h.value();
+    }
+
+    /// exact structural comparison matching forgeGraphHash
+    /// Used to rule out hash collisions before reusing a kernel.
+    inline bool
+    forgeGraphsEquivalent(const forge::Graph& g1,
+                          const forge::Graph& g2,
+                          const ForgeGraphHashOptions& options = ForgeGraphHashOptions()) {
+        if (g1.nodes.size() != g2.nodes.size() || g1.outputs != g2.outputs ||
+            g1.diff_inputs != g2.diff_inputs)
+            return false;
+        for (std::size_t i = 0; i < g1.nodes.size(); ++i) {
+            const auto& n1 = g1.nodes[i];
+            const auto& n2 = g2.nodes[i];
+            if (n1.op != n2.op || n1.a != n2.a || n1.b != n2.b || n1.c != n2.c ||
+                n1.isActive != n2.isActive || n1.needsGradient != n2.needsGradient)
+                return false;
+            if (options.includeConstants && !n1.isActive && !(n1.imm == n2.imm))
+                return false;
+        }
+        if (options.includeConstants && g1.constPool != g2.constPool)
+            return false;
+        return true;
+    }
+
+    /// fingerprint of the compiler settings that affect generated code
+    inline std::uint64_t forgeConfigHash(const forge::CompilerConfig& config) {
+        detail::ForgeHasher h;
+        h.add(config.enableOptimizations);
+        h.add(config.enableCSE);
+        h.add(config.enableAlgebraicSimplification);
+        h.add(config.enableInactiveFolding);
+        h.add(config.enableStabilityCleaning);
+        h.add(config.instructionSet);
+        return h.value();
+    }
+
+    /// what the operations recorded by fdouble look like in forge::Node
+    struct ForgeOpcodeInfo {
+        std::string name;
+        /// bit k is set if operand slot k (a, b, c) holds an operand
+        std::uint32_t operands = 0;
+    };
+
+    namespace detail {
+
+        inline std::uint32_t forgeOperandSlots(const forge::Node& node, forge::NodeId id) {
+            // node 0 is a padding input no probe uses, so slots holding 0 are unused
+            std::uint32_t slots = 0;
+            const forge::NodeId operands[3] = {node.a, node.b, node.c};
+            for (std::uint32_t k = 0; k < 3; ++k)
+                if (operands[k] != 0 && operands[k] < id)
+                    slots |= 1U << k;
+            return slots;
+        }
+
+        // Forge keeps its OpCode enum to itself, beyond Input, Constant and If: each
+        // operation of fdouble is recorded once and read back from the graph.
+        inline std::map<std::uint32_t, ForgeOpcodeInfo> forgeProbeOpcodes() {
+            // Forge's recorder state may be process-wide (see
+            // forgeRecorderIsThreadLocal()), and then the probe recording would
+            // land in the caller's graph
+            QL_REQUIRE(!forge::GraphRecorder::isAnyRecording(),
+                       "the Forge opcode table is first needed during a recording; "
+                       "call forgeOpcodeTable() before recording starts");
+            std::map<std::uint32_t, ForgeOpcodeInfo> table;
+            table[std::uint32_t(forge::OpCode::Input)] = {"Input", 0};
+            table[std::uint32_t(forge::OpCode::Constant)] = {"Constant", 0};
+            table[std::uint32_t(forge::OpCode::If)] = {"If", 0};
+            // on a thread of its own, outside any thread-local state of the caller
+            std::thread probe([&table]() {
+                forge::GraphRecorder recorder;
+                recorder.start();
+                forge::fdouble padding(1.0), x(0.5), y(2.0), t(3.0), f(4.0);
+                for (forge::fdouble* input : {&padding, &x, &y, &t, &f})
+                    input->markInput();
+                const std::vector<std::pair<const char*, forge::fdouble>> arithmetic = {
+                    {"Add", x + y},           {"Sub", x - y},           {"Mul", x * y},
+                    {"Div", x / y},           {"Neg", -x},              {"Exp", forge::exp(x)},
+                    {"Log", forge::log(x)},   {"Sqrt", forge::sqrt(x)}, {"Abs", forge::abs(x)},
+                    {"Pow", forge::pow(x, y)}, {"Min", forge::min(x, y)}, {"Max", forge::max(x, y)},
+                    // a single node only where Forge fuses them, see ForgeFusion.hpp
+                    {"Fma", forge::expr::detail::forgeMultiplyAdd(x, y, t)},
+                    {"Fnma", forge::expr::detail::forgeNegMultiplyAdd(x, y, t)}};
+                // comparisons are read through the If they select with
+                const std::vector<std::pair<const char*, forge::fdouble>> comparisons = {
+                    {"Less", (x < y).If(t, f)},         {"LessEqual", (x <= y).If(t, f)},
+                    {"Greater", (x > y).If(t, f)},      {"GreaterEqual", (x >= y).If(t, f)},
+                    {"Equal", (x == y).If(t, f)},       {"NotEqual", (x != y).If(t, f)}};
+                recorder.stop();
+                const forge::Graph& graph = recorder.graph();
+
+                auto name = [&](const char* op, forge::NodeId id) {
+                    // a probe that recorded no node of its own is skipped
+                    if (std::size_t(id) <= 4 || std::size_t(id) >= graph.nodes.size())
+                        return;
+                    const forge::Node& node = graph.nodes[id];
+                    // the first probe recording an opcode names it, later ones may reuse it
+                    if (table.count(std::uint32_t(node.op)) == 0)
+                        table[std::uint32_t(node.op)] = {op, forgeOperandSlots(node, id)};
+                };
+                for (const auto& probe : arithmetic)
+                    name(probe.first, probe.second.node());
+                for (const auto& probe : comparisons) {
+                    const forge::NodeId id = probe.second.node();
+                    if (std::size_t(id) >= graph.nodes.size() ||
+                        graph.nodes[id].op != forge::OpCode::If)
+                        continue;
+                    const forge::Node& select = graph.nodes[id];
+                    table[std::uint32_t(forge::OpCode::If)].operands =
+                        forgeOperandSlots(select, id);
+                    for (forge::NodeId operand : {select.a, select.b, select.c})
+                        if (operand != 0 && operand < id &&
+                            graph.nodes[operand].op != forge::OpCode::Input)
+                            name(probe.first, operand);
+                }
+            });
+            probe.join();
+            return table;
+        }
+
+    }
+
+    /// name and operand slots of every opcode fdouble records, by opcode
+    /// Built by a probe recording on first use, which must not happen while
+    /// a recording is active; programs that first need the table inside a
+    /// recording (forgeContiguousLayout(), a graph store) call this once at
+    /// start-up.
+    inline const std::map<std::uint32_t, ForgeOpcodeInfo>& forgeOpcodeTable() {
+        static const std::map<std::uint32_t, ForgeOpcodeInfo> table = detail::forgeProbeOpcodes();
+        return table;
+    }
+
+    namespace detail {
+
+        // the operand slots of a node by its opcode; an opcode no probe recorded
+        // falls back to the slots below the node's own index
+        inline std::uint32_t forgeOperandMask(const forge::Node& node, std::size_t id) {
+            const auto& table = forgeOpcodeTable();
+            auto it = table.find(std::uint32_t(node.op));
+            if (it != table.end())
+                return it->second.operands;
+            std::uint32_t slots = 0;
+            const forge::NodeId operands[3] = {node.a, node.b, node.c};
+            for (std::uint32_t k = 0; k < 3; ++k)
+                if (std::size_t(operands[k]) < id)
+                    slots |= 1U << k;
+            return slots;
+        }
+
+    }
+
+    /// fingerprint of the node layout and the opcodes, to reject graphs saved by another Forge
+    inline std::uint64_t forgeOpcodeFingerprint() {
+        detail::ForgeHasher h;
+        h.add(std::uint64_t(sizeof(forge::Node)));
+        for (const auto& entry : forgeOpcodeTable()) {
+            h.add(std::uint64_t(entry.first));
+            h.add(std::uint64_t(entry.second.operands));
+            for (char c : entry.second.name)
+                h.add(std::uint64_t(static_cast<unsigned char>(c)));
+        }
+        return h.value();
+    }
+
+    /// number of active nodes, those depending on an active input
+    inline std::size_t forgeActiveNodeCount(const forge::Graph& graph) {
+        std::size_t n = 0;
+        for (const auto& node : graph.nodes)
+            n += node.isActive ? 1 : 0;
+        return n;
+    }
+
+    /// a graph with renumbered nodes, and the new id of every old node
+    struct ForgeRelaidGraph {
+        forge::Graph graph;
+        std::vector<forge::NodeId> newIds;
+
+        forge::NodeId remap(forge::NodeId id) const { return newIds[std::size_t(id)]; }
+        std::vector<forge::NodeId> remap(const std::vector<forge::NodeId>& ids) const {
+            std::vector<forge::NodeId> result;
+            result.reserve(ids.size());
+            for (auto id : ids)
+                result.push_back(remap(id));
+            return result;
+        }
+    };
+
+    /// the graph renumbered with the given inputs first and outputs last, in the given order
+    /// Forge lays out node values in node order, so this places the inputs,
+    /// their adjoints and the outputs in contiguous blocks of the buffer.
+    /// Input nodes have no operands and can always move to the front; an
+    /// output can only move to the end if no other node uses it, and stays
+    /// in place otherwise.  The operand slots of each opcode are those of
+    /// forgeOpcodeTable(), and only they are renumbered; the rest of the
+    /// nodes keep their relative order.
+    inline ForgeRelaidGraph forgeContiguousLayout(const forge::Graph& graph,
+                                                  const std::vector<forge::NodeId>& inputs,
+                                                  const std::vector<forge::NodeId>& outputs) {
+        const std::size_t n = graph.nodes.size();
+        std::vector<char> used(n, 0), placed(n, 0);
+        std::vector<std::uint32_t> slots(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto& node = graph.nodes[i];
+            slots[i] = detail::forgeOperandMask(node, i);
+            const forge::NodeId operands[3] = {node.a, node.b, node.c};
+            for (std::uint32_t k = 0; k < 3; ++k)
+                if ((slots[i] & (1U << k)) != 0) {
+                    QL_REQUIRE(std::size_t(operands[k]) < i,
+                               "node " << i << " uses node " << operands[k]
+                                       << " recorded after it");
+                    used[operands[k]] = 1;
+                }
+        }
+
+        std::vector<forge::NodeId> order;
+        order.reserve(n);
+        for (auto id : inputs) {
+            QL_REQUIRE(std::size_t(id) < n && graph.nodes[id].op == forge::OpCode::Input,
+                       "node " << id << " is not an input of the graph");
+            QL_REQUIRE(!placed[id], "input node " << id << " given twice");
+            placed[id] = 1;
+            order.push_back(id);
+        }
+        std::vector<forge::NodeId> last;
+        for (auto id : outputs) {
+            QL_REQUIRE(std::size_t(id) < n, "node " << id << " is not in the graph");
+            if (!used[id] && !placed[id]) {
+                placed[id] = 2;
+                last.push_back(id);
+            }
+        }
+        for (std::size_t i = 0; i < n; ++i)
+            if (!placed[i])
+                order.push_back(forge::NodeId(i));
+        order.insert(order.end(), last.begin(), last.end());
+
+        ForgeRelaidGraph result;
+        result.newIds.resize(n);
+        for (std::size_t k = 0; k < n; ++k)
+            result.newIds[order[k]] = forge::NodeId(k);
+        result.graph = graph;
+        for (std::size_t k = 0; k < n; ++k) {
+            const std::size_t old = order[k];
+            auto node = graph.nodes[old];
+            forge::NodeId* operands[3] = {&node.a, &node.b, &node.c};
+            for (std::uint32_t j = 0; j < 3; ++j)
+                if ((slots[old] & (1U << j)) != 0)
+                    *operands[j] = result.newIds[*operands[j]];
+            result.graph.nodes[k] = node;
+        }
+        result.graph.outputs = result.remap(graph.outputs);
+        result.graph.diff_inputs = result.remap(graph.diff_inputs);
+        return result;
+    }
+
+    /// what profiling and interpreting code outside this header needs to know about a node
+    struct ForgeNodeInfo {
+        std::uint32_t opcode = 0;
+        bool input = false;
+        bool constant = false;
+        bool active = false;
+        /// operand slots a, b, c; forgeOpcodeTable() tells which ones are used
+        forge::NodeId operands[3] = {0, 0, 0};
+        /// the value of a constant, or the value seen at recording time
+        double value = 0.0;
+    };
+
+    inline ForgeNodeInfo forgeNodeInfo(const forge::Node& node) {
+        ForgeNodeInfo info;
+        info.opcode = std::uint32_t(node.op);
+        info.input = node.op == forge::OpCode::Input;
+        info.constant = node.op == forge::OpCode::Constant;
+        info.active = node.isActive;
+        info.operands[0] = node.a;
+        info.operands[1] = node.b;
+        info.operands[2] = node.c;
+        info.value = double(node.imm);
+        return info;
+    }
+
+    /// printable name of an opcode; opcodes fdouble does not record are numbered
+    inline std::string forgeOpcodeName(std::uint32_t opcode) {
+        const auto& table = forgeOpcodeTable();
+        auto it = table.find(opcode);
+        return it != table.end() ? it->second.name : "op" + std::to_string(opcode);
+    }
+
+    /// the graph with the given input nodes turned into constants of the given values
+    /// Activity is propagated again so that whatever depends only on frozen
+    /// inputs becomes inactive and is folded by the compiler
+    /// (enableInactiveFolding); frozen nodes leave the differentiation set.
+    /// Operand slots of the wrong arity are treated as operands, which can only
+    /// keep a node active and never folds one that is not constant.
+    inline forge::Graph forgeFreezeInputs(const forge::Graph& graph,
+                                          const std::vector<forge::NodeId>& nodes,
+                                          const std::vector<double>& values) {
+        QL_REQUIRE(nodes.size() == values.size(),
+                   nodes.size() << " frozen inputs given with " << values.size() << " values");
+        forge::Graph frozen = graph;
+        std::unordered_map<forge::NodeId, double> value;
+        for (std::size_t k = 0; k < nodes.size(); ++k) {
+            const forge::NodeId id = nodes[k];
+            QL_REQUIRE(std::size_t(id) < frozen.nodes.size() &&
+                           frozen.nodes[id].op == forge::OpCode::Input,
+                       "node " << id << " is not an input of the graph");
+            value[id] = values[k];
+        }
+
+        for (std::size_t i = 0; i < frozen.nodes.size(); ++i) {
+            auto& node = frozen.nodes[i];
+            auto it = value.find(forge::NodeId(i));
+            if (it != value.end()) {
+                node.op = forge::OpCode::Constant;
+                node.imm = it->second;
+                node.isActive = false;
+                node.needsGradient = false;
+                continue;
+            }
+            if (node.op == forge::OpCode::Input || node.op == forge::OpCode::Constant ||
+                !node.isActive)
+                continue;
+            bool active = false, gradient = false;
+            for (forge::NodeId operand : {node.a, node.b, node.c}) {
+                if (std::size_t(operand) >= i)
+                    continue;
+                active = active || frozen.nodes[operand].isActive;
+                gradient = gradient || frozen.nodes[operand].needsGradient;
+            }
+            node.isActive = active;
+            node.needsGradient = node.needsGradient && gradient;
+        }
+
+        std::vector<forge::NodeId> diff;
+        for (auto id : frozen.diff_inputs)
+            if (value.find(id) == value.end())
+                diff.push_back(id);
+        frozen.diff_inputs = diff;
+        return frozen;
+    }
+
+}
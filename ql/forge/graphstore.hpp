@@ -0,0 +1,343 @@
+/*******************************************************************************
+
+   Persistent on-disk store of recorded Forge graphs and their buffer layouts.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Grid workers restart often and would otherwise re-record and re-compile
+    every trade.  ForgeGraphStore keeps, per compiled kernel,
+
+        - the key: structural graph hash, CPU feature mask, compiler config
+        - the buffer layout (input/output node -> getBufferIndex mapping)
+        - the graph itself as raw node records
+
+    in a single versioned binary file.  It is a graph store, not a code
+    cache: Forge does not expose its generated machine code, so prewarm()
+    compiles every record matching the current CPU and configuration into
+    a ForgeKernelCache.  The JIT work of a restart is not removed but moved
+    ahead of the first pricing request, onto start-up (or a thread of its
+    own); the pricing code still records its graph to look the kernel up.
+    The stored layout lets callers address buffers without looking up node
+    ids.
+
+    Once Forge can serialise a kernel, the code blob belongs in the record
+    next to the graph and formatVersion must be bumped.  The file carries
+    forgeOpcodeFingerprint() of the Forge that wrote it and the sizes of
+    the raw records (forge::Node, node ids, constants, layout slots), and
+    files from a Forge with another opcode numbering or record layout are
+    rejected.  Loaded graphs are checked before anything reaches the
+    compiler: node ids must be in range, and operands precede their nodes.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/graphhash.hpp>
+#include <ql/forge/kernelcache.hpp>
+#include <graph/handles.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace QuantLib {
+
+    /// CPU feature bits relevant to generated Forge code
+    enum ForgeCpuFeature : std::uint64_t {
+        ForgeCpuSSE2 = 1ULL << 0,
+        ForgeCpuAVX = 1ULL << 1,
+        ForgeCpuAVX2 = 1ULL << 2,
+        ForgeCpuFMA = 1ULL << 3,
+        ForgeCpuAVX512F = 1ULL << 4
+    };
+
+    /// feature mask of the running CPU
+    inline std::uint64_t forgeCpuFeatures() {
+        std::uint64_t features = 0;
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        int nIds = info[0];
+        __cpuid(info, 1);
+        unsigned int ecx1 = info[2], edx1 = info[3], ebx7 = 0;
+        if (nIds >= 7) {
+            __cpuidex(info, 7, 0);
+            ebx7 = info[1];
+        }
+#else
+        unsigned int eax, ebx, ecx1 = 0, edx1 = 0, ebx7 = 0, ecx, edx;
+        __cpuid(1, eax, ebx, ecx1, edx1);
+        if (__get_cpuid_max(0, nullptr) >= 7)
+            __cpuid_count(7, 0, eax, ebx7, ecx, edx);
+#endif
+        if (edx1 & (1U << 26))
+            features |= ForgeCpuSSE2;
+        if (ecx1 & (1U << 28))
+            features |= ForgeCpuAVX;
+        if (ecx1 & (1U << 12))
+            features |= ForgeCpuFMA;
+        if (ebx7 & (1U << 5))
+            features |= ForgeCpuAVX2;
+        if (ebx7 & (1U << 16))
+            features |= ForgeCpuAVX512F;
+#endif
+        return features;
+    }
+
+    /// identifies a kernel across processes
+    struct ForgeKernelKey {
+        std::uint64_t graphHash = 0;
+        std::uint64_t cpuFeatures = 0;
+        std::uint64_t configHash = 0;
+
+        bool operator==(const ForgeKernelKey& o) const {
+            return graphHash == o.graphHash && cpuFeatures == o.cpuFeatures &&
+                   configHash == o.configHash;
+        }
+    };
+
+    /// node id -> buffer index mapping as returned by getBufferIndex
+    struct ForgeBufferLayout {
+        struct Slot {
+            std::uint64_t node; // forge::NodeId, widened to keep records free of padding
+            std::uint64_t index;
+        };
+        std::uint32_t vectorWidth = 1;
+        std::vector<Slot> inputs;
+        std::vector<Slot> outputs;
+
+        /// builds the layout from a live buffer
+        template <class Buffer>
+        static ForgeBufferLayout fromBuffer(const Buffer& buffer,
+                                            const std::vector<forge::NodeId>& inputs,
+                                            const std::vector<forge::NodeId>& outputs) {
+            ForgeBufferLayout layout;
+            layout.vectorWidth = std::uint32_t(buffer.getVectorWidth());
+            for (auto id : inputs)
+                layout.inputs.push_back({std::uint64_t(id), std::uint64_t(buffer.getBufferIndex(id))});
+            for (auto id : outputs)
+                layout.outputs.push_back({std::uint64_t(id), std::uint64_t(buffer.getBufferIndex(id))});
+            return layout;
+        }
+    };
+
+    /// versioned binary file of recorded graphs, keyed like their kernels
+    class ForgeGraphStore {
+      public:
+        static constexpr char magic[8] = {'Q', 'L', 'F', 'G', 'S', 'T', 'O', 'R'};
+        static constexpr std::uint32_t formatVersion = 3;
+
+        struct Record {
+            ForgeKernelKey key;
+            ForgeBufferLayout layout;
+            forge::Graph graph;
+        };
+
+        ForgeGraphStore() = default;
+
+        /// adds (or replaces) the record for a graph compiled by the given cache
+        void add(const forge::Graph& graph, const ForgeKernelCache& cache, ForgeBufferLayout layout) {
+            Record r;
+            r.key.graphHash = forgeGraphHash(graph, cache.hashOptions());
+            r.key.cpuFeatures = forgeCpuFeatures();
+            r.key.configHash = cache.configHash();
+            r.layout = std::move(layout);
+            r.graph = graph;
+            for (auto& existing : records_) {
+                if (existing.key == r.key) {
+                    existing = std::move(r);
+                    return;
+                }
+            }
+            records_.push_back(std::move(r));
+        }
+
+        /// layout stored for the key, or null
+        const ForgeBufferLayout* layout(const ForgeKernelKey& key) const {
+            for (const auto& r : records_)
+                if (r.key == key)
+                    return &r.layout;
+            return nullptr;
+        }
+
+        /// compiles every record usable on this CPU with the cache's config into the cache
+        /// Returns the number of kernels made available; each one not in the
+        /// cache yet costs a full compilation here.
+        Size prewarm(ForgeKernelCache& cache) const {
+            std::uint64_t cpu = forgeCpuFeatures();
+            Size n = 0;
+            for (const auto& r : records_) {
+                if (r.key.cpuFeatures != cpu || r.key.configHash != cache.configHash())
+                    continue;
+                if (!cache.contains(r.graph)) {
+                    forge::ForgeEngine compiler(cache.config());
+                    cache.insert(r.graph, std::shared_ptr<ForgeKernel>(compiler.compile(r.graph)));
+                }
+                ++n;
+            }
+            return n;
+        }
+
+        const std::vector<Record>& records() const { return records_; }
+        Size size() const { return records_.size(); }
+        void clear() { records_.clear(); }
+
+        void save(const std::string& path) const {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            QL_REQUIRE(out, "cannot open Forge graph store " << path << " for writing");
+            out.write(magic, sizeof(magic));
+            put(out, formatVersion);
+            put(out, forgeOpcodeFingerprint());
+            for (std::uint32_t bytes : elementSizes())
+                put(out, bytes);
+            put(out, std::uint64_t(records_.size()));
+            for (const auto& r : records_) {
+                put(out, r.key.graphHash);
+                put(out, r.key.cpuFeatures);
+                put(out, r.key.configHash);
+                put(out, r.layout.vectorWidth);
+                putVector(out, r.layout.inputs);
+                putVector(out, r.layout.outputs);
+                putVector(out, r.graph.nodes);
+                putVector(out, r.graph.outputs);
+                putVector(out, r.graph.diff_inputs);
+                putVector(out, r.graph.constPool);
+            }
+            QL_REQUIRE(out, "error writing Forge graph store " << path);
+        }
+
+        /// replaces the contents with those of the file
+        /// Files written by a different format version or Forge, with other
+        /// record sizes, or holding graphs with out-of-range node ids are
+        /// rejected, and the store is then left as it was.
+        void load(const std::string& path) {
+            std::ifstream in(path, std::ios::binary | std::ios::ate);
+            QL_REQUIRE(in, "cannot open Forge graph store " << path);
+            const std::uint64_t size = std::uint64_t(in.tellg());
+            in.seekg(0);
+            char header[sizeof(magic)];
+            in.read(header, sizeof(header));
+            QL_REQUIRE(in && std::memcmp(header, magic, sizeof(magic)) == 0,
+                       path << " is not a Forge graph store");
+            auto version = get<std::uint32_t>(in);
+            QL_REQUIRE(version == formatVersion, "Forge graph store " << path << " has version "
+                                                      << version << ", expected " << formatVersion);
+            auto fingerprint = get<std::uint64_t>(in);
+            QL_REQUIRE(fingerprint == forgeOpcodeFingerprint(),
+                       "Forge graph store " << path << " was written with a different Forge version");
+            for (std::uint32_t bytes : elementSizes()) {
+                auto stored = get<std::uint32_t>(in);
+                QL_REQUIRE(in && stored == bytes, "Forge graph store "
+                                                      << path << " has " << stored
+                                                      << "-byte records where " << bytes
+                                                      << " are expected");
+            }
+            auto count = get<std::uint64_t>(in);
+            // a record takes more than its key, which bounds a corrupt count
+            QL_REQUIRE(in && count <= size / (3 * sizeof(std::uint64_t)),
+                       "corrupt Forge graph store " << path);
+            std::vector<Record> records(static_cast<std::size_t>(count));
+            for (auto& r : records) {
+                r.key.graphHash = get<std::uint64_t>(in);
+                r.key.cpuFeatures = get<std::uint64_t>(in);
+                r.key.configHash = get<std::uint64_t>(in);
+                r.layout.vectorWidth = get<std::uint32_t>(in);
+                getVector(in, size, r.layout.inputs);
+                getVector(in, size, r.layout.outputs);
+                getVector(in, size, r.graph.nodes);
+                getVector(in, size, r.graph.outputs);
+                getVector(in, size, r.graph.diff_inputs);
+                getVector(in, size, r.graph.constPool);
+                QL_REQUIRE(in, "truncated Forge graph store " << path);
+                QL_REQUIRE(wellFormed(r), "corrupt graph in Forge graph store " << path);
+            }
+            records_ = std::move(records);
+        }
+
+      private:
+        // sizes of the raw elements written, in file order
+        static std::vector<std::uint32_t> elementSizes() {
+            return {std::uint32_t(sizeof(forge::Node)), std::uint32_t(sizeof(forge::NodeId)),
+                    std::uint32_t(sizeof(decltype(forge::Graph::constPool)::value_type)),
+                    std::uint32_t(sizeof(ForgeBufferLayout::Slot))};
+        }
+
+        // node ids in range, and operands recorded before the nodes using them
+        static bool wellFormed(const Record& r) {
+            const std::size_t n = r.graph.nodes.size();
+            for (std::size_t i = 0; i < n; ++i) {
+                const auto& node = r.graph.nodes[i];
+                const std::uint32_t slots = detail::forgeOperandMask(node, i);
+                const forge::NodeId operands[3] = {node.a, node.b, node.c};
+                for (std::uint32_t k = 0; k < 3; ++k)
+                    if ((slots & (1U << k)) != 0 && std::size_t(operands[k]) >= i)
+                        return false;
+            }
+            for (const auto* ids : {&r.graph.outputs, &r.graph.diff_inputs})
+                for (auto id : *ids)
+                    if (std::size_t(id) >= n)
+                        return false;
+            for (const auto* slots : {&r.layout.inputs, &r.layout.outputs})
+                for (const auto& slot : *slots)
+                    if (slot.node >= n)
+                        return false;
+            return true;
+        }
+
+        template <class T>
+        static void put(std::ostream& out, const T& x) {
+            static_assert(std::is_trivially_copyable<T>::value, "record fields must be trivially copyable");
+            out.write(reinterpret_cast<const char*>(&x), sizeof(T));
+        }
+        template <class T>
+        static void putVector(std::ostream& out, const std::vector<T>& v) {
+            static_assert(std::is_trivially_copyable<T>::value, "record fields must be trivially copyable");
+            put(out, std::uint64_t(v.size()));
+            if (!v.empty())
+                out.write(reinterpret_cast<const char*>(v.data()), std::streamsize(v.size() * sizeof(T)));
+        }
+        template <class T>
+        static T get(std::istream& in) {
+            T x{};
+            in.read(reinterpret_cast<char*>(&x), sizeof(T));
+            return x;
+        }
+        // size is that of the whole stream; n is checked against what is left of it
+        template <class T>
+        static void getVector(std::istream& in, std::uint64_t size, std::vector<T>& v) {
+            auto n = get<std::uint64_t>(in);
+            QL_REQUIRE(in, "truncated Forge graph store");
+            const std::uint64_t position = std::uint64_t(in.tellg());
+            QL_REQUIRE(position <= size && n <= (size - position) / sizeof(T),
+                       "truncated Forge graph store: " << n << " elements announced, "
+                                                        << (size - std::min(position, size))
+                                                        << " bytes left");
+            v.resize(std::size_t(n));
+            if (n > 0)
+                in.read(reinterpret_cast<char*>(v.data()), std::streamsize(n * sizeof(T)));
+        }
+
+        std::vector<Record> records_;
+    };
+
+}
@@ -0,0 +1,283 @@
+/*******************************************************************************
+
+   Guarded Forge kernels: one kernel per branch signature.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    QuantLib code that branches on an active comparison in plain C++
+    (if/else, ?:) instead of ABool::If records only the branch taken by the
+    recording scenario; a kernel reused for other scenarios silently returns
+    the numbers of that branch.  ForgeGuardedKernelSet makes such reuse safe.
+
+    The pricing function is recorded with forge::BranchGuards installed, so
+    every native branch on an active condition adds a guard output holding
+    the condition per lane, next to the outcome seen while recording (the
+    branch signature).  After each execute() the guards are compared lane by
+    lane; lanes that took another branch are evaluated again with the other
+    kernels of the set and, if none matches, the pricer is re-recorded at
+    one of those scenarios, which gives the kernel for its branch signature:
+
+        ForgeGuardedKernelSet<4> set(config, initialInputs,
+            [](const std::vector<Real>& x) { return price(x); });
+        set.evaluate(scenarios.data(), n, stride, npvs.data(), gradients.data());
+
+    A pricer without native branches records no guards and behaves exactly
+    like a single kernel.  Kernels are compiled through a ForgeKernelCache,
+    so signatures that happen to record the same graph share one kernel.
+
+    Once maxVariants kernels are cached, lanes matching none of them are
+    evaluated by a recording that is used once and then discarded.
+
+    The set re-records from the calling thread and is not thread-safe; use one
+    per thread (they may share a ForgeKernelCache).
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/batchevaluator.hpp>
+#include <ql/forge/kernelcache.hpp>
+#include <expressions/BranchGuards.hpp>
+#include <graph/graph_recorder.hpp>
+#include <graph/handles.hpp>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace QuantLib {
+
+    /// options of ForgeGuardedKernelSet
+    struct ForgeGuardedKernelOptions {
+        /// mark inputs for differentiation (markForgeInputAndDiff)
+        bool differentiate = true;
+        /// kernels kept per set; diverging lanes beyond that use one-off recordings
+        Size maxVariants = 16;
+    };
+
+    /// kernels of one pricer, one per branch signature, chosen per lane by guard outputs
+    template <Size Width>
+    class ForgeGuardedKernelSet {
+      public:
+        static constexpr Size width = Width;
+        /// prices the trade from the recorded inputs and returns its outputs
+        using Pricer = std::function<std::vector<Real>(const std::vector<Real>&)>;
+
+        /// records the first kernel at initialInputs
+        ForgeGuardedKernelSet(const forge::CompilerConfig& config,
+                              const std::vector<double>& initialInputs,
+                              Pricer pricer,
+                              const ForgeGuardedKernelOptions& options = ForgeGuardedKernelOptions())
+        : ForgeGuardedKernelSet(std::make_shared<ForgeKernelCache>(config), initialInputs,
+                                std::move(pricer), options) {}
+
+        /// as above, compiling through a shared cache
+        ForgeGuardedKernelSet(std::shared_ptr<ForgeKernelCache> cache,
+                              const std::vector<double>& initialInputs,
+                              Pricer pricer,
+                              const ForgeGuardedKernelOptions& options = ForgeGuardedKernelOptions())
+        : cache_(std::move(cache)), pricer_(std::move(pricer)), options_(options),
+          numInputs_(initialInputs.size()) {
+            QL_REQUIRE(cache_ != nullptr, "null Forge kernel cache");
+            QL_REQUIRE(pricer_, "no pricer given");
+            QL_REQUIRE(numInputs_ > 0, "no inputs given");
+            QL_REQUIRE(options_.maxVariants > 0, "at least one kernel variant required");
+            variants_.push_back(record(initialInputs.data()));
+            numOutputs_ = variants_.front()->numOutputs;
+        }
+
+        Size numInputs() const { return numInputs_; }
+        Size numOutputs() const { return numOutputs_; }
+        /// adjoints per scenario: one per input when differentiating, else none
+        Size numGradients() const { return options_.differentiate ? numInputs_ : 0; }
+
+        /// evaluates numScenarios row-major scenarios
+        /// outputs and gradients are row-major with numOutputs() and
+        /// numGradients() columns; gradients may be null.
+        void evaluate(const double* scenarios, Size numScenarios, Size stride,
+                      double* outputs, double* gradients = nullptr) {
+            QL_REQUIRE(stride >= numInputs_, "scenario stride " << stride << " below "
+                                                                << numInputs_ << " inputs");
+            std::vector<Size> pending;
+            pending.reserve(Width);
+            for (Size first = 0; first < numScenarios; first += Width) {
+                pending.clear();
+                for (Size p = first; p < std::min(first + Width, numScenarios); ++p)
+                    pending.push_back(p);
+                std::vector<bool> tried(variants_.size(), false);
+                while (!pending.empty()) {
+                    Variant* variant = nullptr;
+                    std::unique_ptr<Variant> oneOff;
+                    for (Size v = 0; v < variants_.size(); ++v) {
+                        if (!tried[v]) {
+                            tried[v] = true;
+                            variant = variants_[v].get();
+                            break;
+                        }
+                    }
+                    // the first pending lane is the recording scenario of a new
+                    // kernel, so it is accepted even if rounding flips a guard
+                    bool recordedAtFirst = false;
+                    if (variant == nullptr) {
+                        divergentLanes_ += pending.size();
+                        auto recorded = record(scenarios + pending.front() * stride);
+                        recordedAtFirst = true;
+                        // a known signature has been tried already: keep the
+                        // cached kernels unique and use the recording once
+                        if (find(recorded->signature) == nullptr &&
+                            variants_.size() < options_.maxVariants) {
+                            variants_.push_back(std::move(recorded));
+                            variant = variants_.back().get();
+                        } else {
+                            ++oneOffs_;
+                            oneOff = std::move(recorded);
+                            variant = oneOff.get();
+                        }
+                        tried.resize(variants_.size(), true);
+                    }
+                    run(*variant, scenarios, stride, pending, recordedAtFirst, outputs,
+                        gradients);
+                }
+            }
+        }
+
+        /// kernels cached for distinct branch signatures
+        Size variants() const { return variants_.size(); }
+        /// times the pricer has been recorded, including the initial recording
+        Size recordings() const { return recordings_; }
+        /// lanes that matched none of the cached kernels when evaluated
+        Size divergentLanes() const { return divergentLanes_; }
+        /// recordings used once because maxVariants was reached
+        Size oneOffRecordings() const { return oneOffs_; }
+        /// guards of the kernel for signature index v
+        const std::vector<char>& signature(Size v) const {
+            QL_REQUIRE(v < variants_.size(), "variant " << v << " out of range");
+            return variants_[v]->signature;
+        }
+
+        const ForgeKernelCache& cache() const { return *cache_; }
+
+      private:
+        struct Variant {
+            ForgeKernelCache::Entry entry;
+            std::vector<char> signature;
+            Size numOutputs = 0;
+            std::unique_ptr<ForgeBatchEvaluator<Width>> evaluator;
+        };
+
+        std::unique_ptr<Variant> record(const double* inputValues) {
+            auto variant = std::make_unique<Variant>();
+            std::vector<forge::NodeId> inputIds, outputIds;
+            forge::Graph graph;
+            {
+                forge::GraphRecorder recorder;
+                forge::BranchGuards guards;
+                recorder.start();
+                std::vector<Real> inputs(inputValues, inputValues + numInputs_);
+                for (auto& x : inputs) {
+                    if (options_.differentiate)
+                        x.markForgeInputAndDiff();
+                    else
+                        x.markForgeInput();
+                    inputIds.push_back(x.forgeNodeId());
+                }
+                std::vector<Real> outputs = pricer_(inputs);
+                QL_REQUIRE(!outputs.empty(), "pricer returned no outputs");
+                QL_REQUIRE(variants_.empty() || outputs.size() == numOutputs_,
+                           "pricer returned " << outputs.size() << " outputs instead of "
+                                              << numOutputs_);
+                // price outputs first: the reverse pass is seeded from the first output
+                for (auto& y : outputs) {
+                    y.markForgeOutput();
+                    outputIds.push_back(y.forgeNodeId());
+                }
+                std::vector<forge::NodeId> guardIds = guards.markOutputs();
+                outputIds.insert(outputIds.end(), guardIds.begin(), guardIds.end());
+                variant->signature = guards.signature();
+                variant->numOutputs = outputs.size();
+                recorder.stop();
+                graph = recorder.graph();
+            }
+            ++recordings_;
+            variant->entry = cache_->acquire(graph);
+            variant->evaluator = std::make_unique<ForgeBatchEvaluator<Width>>(
+                *variant->entry.kernel, *variant->entry.buffer, inputIds, outputIds,
+                options_.differentiate ? inputIds : std::vector<forge::NodeId>());
+            return variant;
+        }
+
+        Variant* find(const std::vector<char>& signature) const {
+            for (const auto& v : variants_) {
+                if (v->signature == signature)
+                    return v.get();
+            }
+            return nullptr;
+        }
+
+        // evaluates the pending scenarios on one kernel and removes the lanes
+        // whose guards match its signature
+        void run(Variant& variant, const double* scenarios, Size stride,
+                 std::vector<Size>& pending, bool acceptFirst, double* outputs,
+                 double* gradients) {
+            ForgeBatchEvaluator<Width>& evaluator = *variant.evaluator;
+            const Size count = pending.size();
+            const Size numOutputs = evaluator.numOutputs();
+            const Size numGuards = variant.signature.size();
+            evaluator.load([&](Size lane) { return scenarios + pending[lane] * stride; }, count);
+            evaluator.execute();
+            values_.resize(Width * numOutputs);
+            evaluator.readOutputs(values_.data(), numOutputs);
+
+            bool matched[Width];
+            for (Size lane = 0; lane < count; ++lane) {
+                const double* guard = values_.data() + lane * numOutputs + numOutputs_;
+                matched[lane] = true;
+                for (Size g = 0; g < numGuards && matched[lane]; ++g)
+                    matched[lane] = (guard[g] > 0.5) == (variant.signature[g] != 0);
+            }
+            if (acceptFirst)
+                matched[0] = true;
+
+            double* rows[Width];
+            for (Size lane = 0; lane < count; ++lane) {
+                if (!matched[lane])
+                    continue;
+                const double* src = values_.data() + lane * numOutputs;
+                std::copy(src, src + numOutputs_, outputs + pending[lane] * numOutputs_);
+            }
+            const Size numGradients = evaluator.numGradients();
+            if (gradients != nullptr && numGradients > 0) {
+                // unmatched lanes go to scratch so that only valid rows are written
+                scratch_.resize(Width * numGradients);
+                for (Size lane = 0; lane < count; ++lane)
+                    rows[lane] = matched[lane] ? gradients + pending[lane] * numGradients
+                                               : scratch_.data() + lane * numGradients;
+                evaluator.readGradientRows([&](Size lane) { return rows[lane]; });
+            }
+
+            Size kept = 0;
+            for (Size lane = 0; lane < count; ++lane) {
+                if (!matched[lane])
+                    pending[kept++] = pending[lane];
+            }
+            pending.resize(kept);
+        }
+
+        std::shared_ptr<ForgeKernelCache> cache_;
+        Pricer pricer_;
+        ForgeGuardedKernelOptions options_;
+        Size numInputs_, numOutputs_ = 0;
+        std::vector<std::unique_ptr<Variant>> variants_;
+        std::vector<double> values_, scratch_;
+        Size recordings_ = 0, divergentLanes_ = 0, oneOffs_ = 0;
+    };
+
+}
@@ -0,0 +1,142 @@
+/*******************************************************************************
+
+   Second-order sensitivities from lane-packed adjoint kernels.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Gamma, cross-gamma and vanna by bumping prices takes two extra
+    valuations per input and divides by the squared bump, which is slow
+    and noisy.  An AAD kernel already returns the full gradient, so a
+    Hessian column is the derivative of that gradient along one input:
+
+        H e_k = (grad y(x + h e_k) - grad y(x - h e_k)) / 2h
+
+    ForgeHessianEvaluator<Width> lays the base scenario and the bumped
+    ones out as lanes of one adjoint kernel, so with AVX2 a central
+    difference in one second-order input (spot: delta, gamma and vanna
+    against every other gradient input) costs a single execute():
+
+        ForgeHessianEvaluator<4> hessian(*kernel, *buffer, inputs, npv, inputs,
+                                         forgeUnitDirections(n, {spotIndex}), 1e-4);
+        hessian.evaluate(scenario, 1, &value, gradient, secondOrder);
+
+    For G gradient inputs, secondOrder[k * G + g] is the derivative of
+    d npv / d gradientInput_g along direction k: with the unit vectors of
+    the selected second-order inputs a Hessian block, with any other
+    directions Hessian-vector products.  Differencing first derivatives
+    keeps the error at O(h^2) for central differences without the
+    cancellation of a second price difference.
+
+    The kernel is recorded with markForgeInputAndDiff on the gradient
+    inputs; Forge itself has no second-order compile mode, so the outer
+    derivative is taken across lanes.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/batchevaluator.hpp>
+#include <ql/forge/bumpbatch.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace QuantLib {
+
+    /// Hessian blocks and Hessian-vector products of one output of an adjoint kernel
+    template <Size Width>
+    class ForgeHessianEvaluator {
+      public:
+        /// second derivatives along directions[k], each with one entry per input
+        ForgeHessianEvaluator(ForgeKernel& kernel,
+                              ForgeBuffer& buffer,
+                              std::vector<forge::NodeId> inputs,
+                              forge::NodeId output,
+                              std::vector<forge::NodeId> gradientInputs,
+                              std::vector<std::vector<double>> directions,
+                              double bump,
+                              ForgeDifferenceScheme scheme = ForgeDifferenceScheme::Central)
+        : numInputs_(inputs.size()), numGradients_(gradientInputs.size()),
+          directions_(std::move(directions)), bump_(bump), scheme_(scheme),
+          evaluator_(kernel, buffer, std::move(inputs), {output}, std::move(gradientInputs)) {
+            QL_REQUIRE(bump_ > 0.0, "non-positive Hessian bump " << bump_);
+            QL_REQUIRE(numGradients_ > 0, "no gradient inputs given for the Hessian evaluator");
+            for (const auto& v : directions_)
+                QL_REQUIRE(v.size() == numInputs_, "Hessian direction of size "
+                                                       << v.size() << " for " << numInputs_
+                                                       << " inputs");
+            lanes_ = 1 + (scheme_ == ForgeDifferenceScheme::Central ? 2 : 1) * directions_.size();
+            rows_.resize(lanes_ * numInputs_);
+            values_.resize(lanes_);
+            gradients_.resize(lanes_ * numGradients_);
+        }
+
+        Size numInputs() const { return numInputs_; }
+        Size numGradients() const { return numGradients_; }
+        Size numDirections() const { return directions_.size(); }
+        /// lanes used per scenario: the scenario itself and one or two per direction
+        Size lanes() const { return lanes_; }
+        /// kernel executions per scenario
+        Size executions() const { return (lanes_ + Width - 1) / Width; }
+
+        /// evaluates one scenario given as inputs[i * stride]
+        /// gradient takes numGradients() entries and secondOrder
+        /// numDirections() * numGradients(); either may be null.
+        void evaluate(const double* inputs, Size stride, double* value, double* gradient,
+                      double* secondOrder) {
+            const Size n = numInputs_, G = numGradients_;
+            const bool central = scheme_ == ForgeDifferenceScheme::Central;
+            for (Size i = 0; i < n; ++i)
+                rows_[i] = inputs[i * stride];
+            for (Size k = 0; k < directions_.size(); ++k) {
+                const std::vector<double>& v = directions_[k];
+                double* up = &rows_[(1 + (central ? 2 * k : k)) * n];
+                for (Size i = 0; i < n; ++i)
+                    up[i] = rows_[i] + bump_ * v[i];
+                if (central) {
+                    double* down = up + n;
+                    for (Size i = 0; i < n; ++i)
+                        down[i] = rows_[i] - bump_ * v[i];
+                }
+            }
+
+            for (Size first = 0; first < lanes_; first += Width) {
+                const Size count = std::min(Width, lanes_ - first);
+                evaluator_.load(rows_.data(), n, first, count);
+                evaluator_.execute();
+                evaluator_.readOutputs(&values_[first], 1);
+                evaluator_.readGradients(&gradients_[first * G], G);
+            }
+
+            if (value != nullptr)
+                *value = values_[0];
+            if (gradient != nullptr)
+                std::copy(gradients_.begin(), gradients_.begin() + G, gradient);
+            if (secondOrder == nullptr)
+                return;
+            for (Size k = 0; k < directions_.size(); ++k) {
+                const double* up = &gradients_[(1 + (central ? 2 * k : k)) * G];
+                const double* down = central ? up + G : &gradients_[0];
+                const double h = central ? 2.0 * bump_ : bump_;
+                for (Size g = 0; g < G; ++g)
+                    secondOrder[k * G + g] = (up[g] - down[g]) / h;
+            }
+        }
+
+      private:
+        Size numInputs_, numGradients_, lanes_ = 0;
+        std::vector<std::vector<double>> directions_;
+        double bump_;
+        ForgeDifferenceScheme scheme_;
+        ForgeBatchEvaluator<Width> evaluator_;
+        std::vector<double> rows_, values_, gradients_;
+    };
+
+}
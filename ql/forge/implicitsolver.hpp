@@ -0,0 +1,176 @@
+/*******************************************************************************
+
+   One-dimensional root finding recorded through the implicit function theorem.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Recording a bond yield, an implied volatility or a bootstrapped pillar
+    through Brent or NewtonSafe records every iteration of the solver, and
+    the solver's branches are frozen at their recorded outcome: the graph
+    is large, and a kernel run on other inputs repeats the recorded number
+    of steps along the recorded bracket updates, which is not a root-finder
+    any more.
+
+    ForgeImplicitSolver1D separates the search from what is recorded.  The
+    QuantLib solver finds the root x* of f(x, p) = 0 on passive copies of
+    the parameters p, so it records nothing; the kernel then gets a fixed
+    number of Newton steps started at x*,
+
+        x_0 = x*,   x_{k+1} = x_k - f(x_k, p) / f_x(x_k, p),
+
+    recorded on the active parameters:
+
+        ForgeImplicitSolver1D<Brent> solver(3);
+        Real y = solver.solve(
+            [&](const Real& y, const std::vector<Real>& p) {
+                return p[1] * annuity(y) + redemption(y) - p[0];   // p = {price, coupon}
+            },
+            {price, coupon}, 1e-12, 0.05, 0.0, 1.0);
+
+    The steps are the same on every lane, so the kernel solves its own
+    f(x, p) = 0 for each scenario in lockstep, converging quadratically from
+    the recorded root as long as the scenarios stay in its basin.  At a root,
+    the adjoint of the last step is the implicit function theorem's
+
+        p_bar = -x_bar f_p(x, p) / f_x(x, p),
+
+    while the adjoints reaching the earlier steps are scaled by
+    f f_xx / f_x^2, zero at the root.  Forge has no node type that stops the
+    reverse sweep there, so it still visits the steps, but the graph holds
+    iterations() evaluations of f and f_x instead of the solver's unrolled
+    iterations.  With one step, values away from the recorded inputs are the
+    Newton correction from x* (second-order accurate) and derivatives at the
+    recorded inputs are exact.
+
+    The residual must take the active values it depends on through its
+    parameter argument, not capture them, so that the passive search does
+    not record them.  f_x is the residual's derivative(x, p) when it has
+    one, as for NewtonSafe; otherwise it is a central difference recorded
+    with a step fixed at recording time, whose error of order 1e-10 carries
+    over to the sensitivities.  solve(f, p, accuracy, guess, xMin, xMax)
+    also keeps the Newton steps within [xMin, xMax].  Nested solves, such as
+    the pillars of a sequential bootstrap, pass the roots found before as
+    parameters of the next residual.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/math/solvers1d/brent.hpp>
+#include <expressions/ExpressionTemplates/BinaryOperators.hpp>
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace QuantLib {
+
+    namespace detail {
+
+        template <class F, class = void>
+        struct ForgeHasDerivative : std::false_type {};
+
+        template <class F>
+        struct ForgeHasDerivative<F,
+                                  decltype(void(std::declval<const F&>().derivative(
+                                      std::declval<const Real&>(),
+                                      std::declval<const std::vector<Real>&>())))>
+        : std::true_type {};
+
+    }
+
+    /// QuantLib one-dimensional solver whose recorded root follows the
+    /// implicit function theorem
+    template <class Solver = Brent>
+    class ForgeImplicitSolver1D {
+      public:
+        /// Newton steps recorded after the passive search, at least one
+        explicit ForgeImplicitSolver1D(Size iterations = 3, Solver solver = Solver())
+        : iterations_(iterations), solver_(std::move(solver)) {
+            QL_REQUIRE(iterations_ > 0, "at least one recorded Newton step required");
+        }
+
+        Size iterations() const { return iterations_; }
+        Solver& solver() { return solver_; }
+        const Solver& solver() const { return solver_; }
+
+        /// root of f(x, parameters), searched from guess with the given step
+        template <class F>
+        Real solve(const F& f, const std::vector<Real>& parameters,
+                   Real accuracy, Real guess, Real step) const {
+            const std::vector<Real> passive = passiveCopy(parameters);
+            const Real root =
+                solver_.solve(Passive<F>{f, passive, derivativeStep(guess)}, accuracy, guess, step);
+            return record(f, parameters, root.getValue(), false, 0.0, 0.0);
+        }
+
+        /// root of f(x, parameters) in [xMin, xMax], which also bound the
+        /// recorded Newton steps
+        template <class F>
+        Real solve(const F& f, const std::vector<Real>& parameters,
+                   Real accuracy, Real guess, Real xMin, Real xMax) const {
+            const std::vector<Real> passive = passiveCopy(parameters);
+            const Real root = solver_.solve(Passive<F>{f, passive, derivativeStep(guess)}, accuracy,
+                                            guess, xMin, xMax);
+            return record(f, parameters, root.getValue(), true, xMin.getValue(), xMax.getValue());
+        }
+
+      private:
+        // the residual on passive parameters, as Solver1D expects it
+        template <class F>
+        struct Passive {
+            const F& f;
+            const std::vector<Real>& parameters;
+            double h;
+            Real operator()(const Real& x) const { return f(x, parameters); }
+            Real derivative(const Real& x) const { return slope(f, x, parameters, h); }
+        };
+
+        static std::vector<Real> passiveCopy(const std::vector<Real>& parameters) {
+            std::vector<Real> passive;
+            passive.reserve(parameters.size());
+            for (const Real& p : parameters)
+                passive.emplace_back(p.getValue());
+            return passive;
+        }
+
+        static double derivativeStep(const Real& x) { return 1e-5 * (1.0 + std::fabs(x.getValue())); }
+
+        template <class F>
+        static Real slope(const F& f, const Real& x, const std::vector<Real>& parameters, double h) {
+            if constexpr (detail::ForgeHasDerivative<F>::value)
+                return f.derivative(x, parameters);
+            else
+                return (f(x + h, parameters) - f(x - h, parameters)) / (2.0 * h);
+        }
+
+        template <class F>
+        Real record(const F& f, const std::vector<Real>& parameters, double root,
+                    bool bounded, double xMin, double xMax) const {
+            // the step of the central difference is a constant of the kernel
+            const double h = derivativeStep(root);
+            Real x = root;
+            for (Size k = 0; k < iterations_; ++k) {
+                x = x - f(x, parameters) / slope(f, x, parameters, h);
+                if (bounded) {
+                    x = forge::expr::where(x < xMin, Real(xMin), x);
+                    x = forge::expr::where(x > xMax, Real(xMax), x);
+                }
+            }
+            return x;
+        }
+
+        Size iterations_;
+        Solver solver_;
+    };
+
+}
@@ -0,0 +1,459 @@
+/*******************************************************************************
+
+   Low-overhead timing and hardware counters around Forge kernel calls.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    A kernel execution takes well under a microsecond, about as long as a
+    pair of std::chrono clock reads, so timing every call with the clock
+    distorts what is measured.  The timers here read the CPU timestamp
+    counter instead (a few nanoseconds, converted to time with a one-off
+    calibration against steady_clock) and time only every N-th call of a
+    phase, while still counting all calls:
+
+        ForgePhase& execute = ForgePhaseRegistry::instance().phase("swap.execute", 64);
+        for (...) {
+            ForgeScopedTimer timer(execute);
+            kernel.execute(buffer);
+        }
+        ForgePhaseRegistry::instance().dump(std::cout);
+
+    Phases are named, live in a registry for the lifetime of the process and
+    are updated with relaxed atomics, so a production service can keep the
+    timers in place and dump the registry on demand.  ForgePerfCounters adds
+    user-space cycles, instructions, cache misses and branch misses of the
+    calling thread through perf_event on Linux (and reports itself
+    unavailable elsewhere, or where perf_event_paranoid forbids it); reading
+    them is a system call, so they are meant for sampled phases.
+    ForgeInstrumentedKernel bundles the execute, input, output and gradient
+    phases of one kernel.
+
+    The tick conversion assumes an invariant TSC, as on all x86-64 CPUs of
+    the last decade; on AArch64 the virtual counter is used instead, and on
+    other targets steady_clock nanoseconds.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/kernelcache.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define QL_FORGE_HAS_TSC
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace QuantLib {
+
+    /// current value of the timestamp counter
+    /// The load fence keeps earlier instructions from drifting past the read.
+    inline std::uint64_t forgeReadTsc() {
+#if defined(QL_FORGE_HAS_TSC)
+        _mm_lfence();
+        return __rdtsc();
+#elif defined(__aarch64__) && !defined(_MSC_VER)
+        std::uint64_t ticks;
+        asm volatile("isb; mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+#endif
+    }
+
+    /// timestamp counter ticks per nanosecond, calibrated on first use
+    inline double forgeTscTicksPerNanosecond() {
+        static const double ticksPerNs = [] {
+            using clock = std::chrono::steady_clock;
+            auto start = clock::now();
+            std::uint64_t startTicks = forgeReadTsc();
+            while (clock::now() - start < std::chrono::milliseconds(10)) {
+            }
+            std::uint64_t ticks = forgeReadTsc() - startTicks;
+            double ns = double(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count());
+            return ticks > 0 && ns > 0.0 ? double(ticks) / ns : 1.0;
+        }();
+        return ticksPerNs;
+    }
+
+    inline double forgeTicksToNanoseconds(double ticks) {
+        return ticks / forgeTscTicksPerNanosecond();
+    }
+
+    /// hardware events ForgePerfCounters reads
+    enum class ForgePerfEvent { Cycles, Instructions, CacheMisses, BranchMisses };
+
+    constexpr Size forgeNumPerfEvents = 4;
+
+    inline const char* forgePerfEventName(ForgePerfEvent event) {
+        switch (event) {
+            case ForgePerfEvent::Cycles:
+                return "cycles";
+            case ForgePerfEvent::Instructions:
+                return "instructions";
+            case ForgePerfEvent::CacheMisses:
+                return "cache_misses";
+            case ForgePerfEvent::BranchMisses:
+                return "branch_misses";
+            default:
+                QL_FAIL("unknown perf event");
+        }
+    }
+
+    /// user-space hardware counters of the constructing thread
+    /// Events the kernel or CPU does not provide read as zero; available()
+    /// is false if none could be opened.  Not shareable between threads.
+    class ForgePerfCounters {
+      public:
+        typedef std::uint64_t Values[forgeNumPerfEvents];
+
+        ForgePerfCounters() {
+            std::fill(fds_, fds_ + forgeNumPerfEvents, -1);
+#if defined(__linux__)
+            const std::uint64_t configs[forgeNumPerfEvents] = {
+                PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+            for (Size e = 0; e < forgeNumPerfEvents; ++e) {
+                perf_event_attr attr = {};
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.size = sizeof(attr);
+                attr.config = configs[e];
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_GROUP;
+                attr.disabled = leader_ < 0 ? 1 : 0;
+                int fd = int(syscall(SYS_perf_event_open, &attr, 0, -1, leader_, 0));
+                if (fd < 0)
+                    continue;
+                fds_[e] = fd;
+                slots_[e] = opened_++;
+                if (leader_ < 0)
+                    leader_ = fd;
+            }
+            if (leader_ >= 0) {
+                ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+                ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            }
+#endif
+        }
+
+        ~ForgePerfCounters() {
+#if defined(__linux__)
+            for (int fd : fds_)
+                if (fd >= 0)
+                    close(fd);
+#endif
+        }
+
+        ForgePerfCounters(const ForgePerfCounters&) = delete;
+        ForgePerfCounters& operator=(const ForgePerfCounters&) = delete;
+
+        bool available() const { return leader_ >= 0; }
+        bool available(ForgePerfEvent event) const { return fds_[Size(event)] >= 0; }
+
+        /// running counts since construction
+        void read(Values values) const {
+            std::fill(values, values + forgeNumPerfEvents, std::uint64_t(0));
+#if defined(__linux__)
+            if (leader_ < 0)
+                return;
+            // PERF_FORMAT_GROUP: { nr, value[nr] } in opening order
+            std::uint64_t buffer[1 + forgeNumPerfEvents];
+            if (::read(leader_, buffer, sizeof(buffer)) < ssize_t(sizeof(std::uint64_t)))
+                return;
+            for (Size e = 0; e < forgeNumPerfEvents; ++e)
+                if (fds_[e] >= 0 && slots_[e] < buffer[0])
+                    values[e] = buffer[1 + slots_[e]];
+#endif
+        }
+
+      private:
+        int fds_[forgeNumPerfEvents];
+        Size slots_[forgeNumPerfEvents] = {};
+        Size opened_ = 0;
+        int leader_ = -1;
+    };
+
+    /// aggregate of a phase at one point in time
+    struct ForgePhaseStats {
+        std::string name;
+        /// all calls, and the timed ones among them
+        std::uint64_t calls = 0, samples = 0;
+        std::uint64_t ticks = 0, minTicks = 0, maxTicks = 0;
+        /// hardware counts summed over the timed calls that read counters
+        std::uint64_t counted = 0;
+        std::uint64_t counters[forgeNumPerfEvents] = {};
+
+        double meanNanoseconds() const {
+            return samples > 0 ? forgeTicksToNanoseconds(double(ticks) / samples) : 0.0;
+        }
+        /// time of all calls, extrapolated from the timed ones
+        double estimatedTotalNanoseconds() const { return meanNanoseconds() * calls; }
+        double counterPerCall(ForgePerfEvent event) const {
+            return counted > 0 ? double(counters[Size(event)]) / counted : 0.0;
+        }
+    };
+
+    /// named phase, updated lock-free from any thread
+    class ForgePhase {
+      public:
+        /// times every sampleEvery-th call
+        explicit ForgePhase(std::string name, std::uint64_t sampleEvery = 1)
+        : name_(std::move(name)), sampleEvery_(std::max<std::uint64_t>(sampleEvery, 1)) {
+            reset();
+        }
+
+        const std::string& name() const { return name_; }
+        std::uint64_t sampleEvery() const { return sampleEvery_; }
+
+        /// counts a call; true if it is to be timed
+        bool sampleNext() {
+            return calls_.fetch_add(1, std::memory_order_relaxed) % sampleEvery_ == 0;
+        }
+
+        /// adds one timed call, with optional hardware counter deltas
+        void record(std::uint64_t ticks, const std::uint64_t* counters = nullptr) {
+            samples_.fetch_add(1, std::memory_order_relaxed);
+            ticks_.fetch_add(ticks, std::memory_order_relaxed);
+            std::uint64_t current = minTicks_.load(std::memory_order_relaxed);
+            while (ticks < current &&
+                   !minTicks_.compare_exchange_weak(current, ticks, std::memory_order_relaxed)) {
+            }
+            current = maxTicks_.load(std::memory_order_relaxed);
+            while (ticks > current &&
+                   !maxTicks_.compare_exchange_weak(current, ticks, std::memory_order_relaxed)) {
+            }
+            if (counters != nullptr) {
+                counted_.fetch_add(1, std::memory_order_relaxed);
+                for (Size e = 0; e < forgeNumPerfEvents; ++e)
+                    counters_[e].fetch_add(counters[e], std::memory_order_relaxed);
+            }
+        }
+
+        ForgePhaseStats stats() const {
+            ForgePhaseStats s;
+            s.name = name_;
+            s.calls = calls_.load(std::memory_order_relaxed);
+            s.samples = samples_.load(std::memory_order_relaxed);
+            s.ticks = ticks_.load(std::memory_order_relaxed);
+            s.minTicks = s.samples > 0 ? minTicks_.load(std::memory_order_relaxed) : 0;
+            s.maxTicks = maxTicks_.load(std::memory_order_relaxed);
+            s.counted = counted_.load(std::memory_order_relaxed);
+            for (Size e = 0; e < forgeNumPerfEvents; ++e)
+                s.counters[e] = counters_[e].load(std::memory_order_relaxed);
+            return s;
+        }
+
+        void reset() {
+            calls_ = samples_ = ticks_ = maxTicks_ = counted_ = 0;
+            minTicks_ = std::numeric_limits<std::uint64_t>::max();
+            for (auto& c : counters_)
+                c = 0;
+        }
+
+      private:
+        std::string name_;
+        std::uint64_t sampleEvery_;
+        std::atomic<std::uint64_t> calls_, samples_, ticks_, minTicks_, maxTicks_, counted_;
+        std::atomic<std::uint64_t> counters_[forgeNumPerfEvents];
+    };
+
+    /// named phases of a process or of one component
+    class ForgePhaseRegistry {
+      public:
+        /// the process-wide registry
+        static ForgePhaseRegistry& instance() {
+            static ForgePhaseRegistry registry;
+            return registry;
+        }
+
+        /// the phase with the given name, created on first use
+        /// The reference stays valid for the lifetime of the registry; the
+        /// sampling rate of an existing phase is not changed.
+        ForgePhase& phase(const std::string& name, std::uint64_t sampleEvery = 1) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto& slot = phases_[name];
+            if (slot == nullptr)
+                slot.reset(new ForgePhase(name, sampleEvery));
+            return *slot;
+        }
+
+        /// statistics of all phases, ordered by name
+        std::vector<ForgePhaseStats> snapshot() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::vector<ForgePhaseStats> result;
+            for (const auto& p : phases_)
+                result.push_back(p.second->stats());
+            return result;
+        }
+
+        void reset() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& p : phases_)
+                p.second->reset();
+        }
+
+        /// one line per phase: calls, samples, mean/min/max in ns, counters per timed call
+        void dump(std::ostream& out) const {
+            std::vector<ForgePhaseStats> phases = snapshot();
+            Size width = 5;
+            for (const auto& s : phases)
+                width = std::max(width, s.name.size());
+            out << std::left << std::setw(int(width)) << "phase" << std::right << std::setw(12)
+                << "calls" << std::setw(12) << "samples" << std::setw(12) << "mean ns"
+                << std::setw(12) << "min ns" << std::setw(12) << "max ns" << std::setw(14)
+                << "total ms";
+            for (Size e = 0; e < forgeNumPerfEvents; ++e)
+                out << std::setw(15) << forgePerfEventName(ForgePerfEvent(e));
+            out << "\n" << std::fixed << std::setprecision(1);
+            for (const auto& s : phases) {
+                out << std::left << std::setw(int(width)) << s.name << std::right << std::setw(12)
+                    << s.calls << std::setw(12) << s.samples << std::setw(12)
+                    << s.meanNanoseconds() << std::setw(12)
+                    << forgeTicksToNanoseconds(double(s.minTicks)) << std::setw(12)
+                    << forgeTicksToNanoseconds(double(s.maxTicks)) << std::setw(14)
+                    << std::setprecision(3) << s.estimatedTotalNanoseconds() * 1e-6
+                    << std::setprecision(1);
+                for (Size e = 0; e < forgeNumPerfEvents; ++e) {
+                    if (s.counted > 0)
+                        out << std::setw(15) << s.counterPerCall(ForgePerfEvent(e));
+                    else
+                        out << std::setw(15) << "-";
+                }
+                out << "\n";
+            }
+            out << std::defaultfloat;
+        }
+
+      private:
+        mutable std::mutex mutex_;
+        std::map<std::string, std::unique_ptr<ForgePhase>> phases_;
+    };
+
+    /// times the scope into a phase if the phase samples this call
+    class ForgeScopedTimer {
+      public:
+        explicit ForgeScopedTimer(ForgePhase& phase, const ForgePerfCounters* counters = nullptr)
+        : phase_(phase.sampleNext() ? &phase : nullptr),
+          counters_(counters != nullptr && counters->available() ? counters : nullptr) {
+            if (phase_ == nullptr)
+                return;
+            if (counters_ != nullptr)
+                counters_->read(start_);
+            startTicks_ = forgeReadTsc();
+        }
+
+        ~ForgeScopedTimer() {
+            if (phase_ == nullptr)
+                return;
+            std::uint64_t ticks = forgeReadTsc() - startTicks_;
+            if (counters_ != nullptr) {
+                ForgePerfCounters::Values end;
+                counters_->read(end);
+                for (Size e = 0; e < forgeNumPerfEvents; ++e)
+                    end[e] -= start_[e];
+                phase_->record(ticks, end);
+            } else {
+                phase_->record(ticks);
+            }
+        }
+
+        ForgeScopedTimer(const ForgeScopedTimer&) = delete;
+        ForgeScopedTimer& operator=(const ForgeScopedTimer&) = delete;
+
+      private:
+        ForgePhase* phase_;
+        const ForgePerfCounters* counters_;
+        ForgePerfCounters::Values start_ = {};
+        std::uint64_t startTicks_ = 0;
+    };
+
+    /// calls f() inside a ForgeScopedTimer on the phase
+    template <class F>
+    decltype(auto) forgeTimed(ForgePhase& phase, F&& f, const ForgePerfCounters* counters = nullptr) {
+        ForgeScopedTimer timer(phase, counters);
+        return f();
+    }
+
+    /// the execute, input, output and gradient phases of one kernel
+    /// Phases are named prefix + ".execute", ".set_inputs", ".outputs" and
+    /// ".gradients".  Counters, if given, must belong to the calling thread.
+    class ForgeInstrumentedKernel {
+      public:
+        ForgeInstrumentedKernel(ForgeKernel& kernel,
+                                const std::string& prefix = "forge",
+                                std::uint64_t sampleEvery = 1,
+                                ForgePhaseRegistry& registry = ForgePhaseRegistry::instance(),
+                                const ForgePerfCounters* counters = nullptr)
+        : kernel_(kernel), execute_(registry.phase(prefix + ".execute", sampleEvery)),
+          setInputs_(registry.phase(prefix + ".set_inputs", sampleEvery)),
+          outputs_(registry.phase(prefix + ".outputs", sampleEvery)),
+          gradients_(registry.phase(prefix + ".gradients", sampleEvery)), counters_(counters) {}
+
+        void execute(ForgeBuffer& buffer) {
+            ForgeScopedTimer timer(execute_, counters_);
+            kernel_.execute(buffer);
+        }
+        template <class F>
+        decltype(auto) setInputs(F&& f) {
+            return forgeTimed(setInputs_, std::forward<F>(f), counters_);
+        }
+        template <class F>
+        decltype(auto) outputs(F&& f) {
+            return forgeTimed(outputs_, std::forward<F>(f), counters_);
+        }
+        template <class F>
+        decltype(auto) gradients(F&& f) {
+            return forgeTimed(gradients_, std::forward<F>(f), counters_);
+        }
+
+        ForgeKernel& kernel() const { return kernel_; }
+        ForgePhase& executePhase() const { return execute_; }
+        ForgePhase& setInputsPhase() const { return setInputs_; }
+        ForgePhase& outputsPhase() const { return outputs_; }
+        ForgePhase& gradientsPhase() const { return gradients_; }
+
+      private:
+        ForgeKernel& kernel_;
+        ForgePhase& execute_;
+        ForgePhase& setInputs_;
+        ForgePhase& outputs_;
+        ForgePhase& gradients_;
+        const ForgePerfCounters* counters_;
+    };
+
+}
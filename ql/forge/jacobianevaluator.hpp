@@ -0,0 +1,192 @@
+/*******************************************************************************
+
+   Multi-output kernels with seeded adjoints and lane-batched Jacobians.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    An XVA calculation wants CVA, DVA, FVA and the NPV itself from the same
+    pricing graph, with sensitivities of each or of a weighted combination.
+    Recording one kernel per component repeats the pricing; marking them
+    all as outputs only gives adjoints of the first one, since Forge seeds
+    its reverse pass from the first output.
+
+    ForgeMultiOutput records the components once and, on close(), one seed
+    input per component together with the scalar objective sum of
+    seed_o * y_o as the first output, followed by the components:
+
+        forge::GraphRecorder recorder;
+        recorder.start();
+        ... mark the market inputs, price ...
+        ForgeMultiOutput outputs;
+        outputs.add(cva);
+        outputs.add(dva);
+        outputs.add(fva);
+        outputs.add(npv);
+        outputs.close();
+        recorder.stop();
+
+    The adjoints of the compiled kernel are then the vector-Jacobian product
+    seed^T J for whatever seed vector is fed, so a single forward and reverse
+    sweep gives all component values and the sensitivities of any linear
+    combination (e.g. CVA + DVA + FVA with unit seeds).
+
+    ForgeJacobianEvaluator<Width> feeds the seeds: evaluate() with one seed
+    vector for a batch of scenarios, and jacobian() with the unit seeds of
+    the components laid out as lanes of one scenario, so each execute()
+    returns Width rows of the full Jacobian and ceil(numOutputs / Width)
+    executions give all of it.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/batchevaluator.hpp>
+#include <graph/handles.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace QuantLib {
+
+    /// recording helper marking several outputs behind a seeded objective
+    class ForgeMultiOutput {
+      public:
+        /// adds a component; returns its index
+        Size add(const Real& y) {
+            QL_REQUIRE(!closed_, "multi-output recording already closed");
+            components_.push_back(y);
+            return components_.size() - 1;
+        }
+
+        /// records the seed inputs and marks the objective and the components as outputs
+        void close() {
+            QL_REQUIRE(!closed_, "multi-output recording already closed");
+            QL_REQUIRE(!components_.empty(), "no outputs added to the multi-output recording");
+            Real objective = 0.0;
+            for (const auto& y : components_) {
+                Real seed = 0.0;
+                seed.markForgeInput();
+                seedInputs_.push_back(seed.forgeNodeId());
+                objective += seed * y;
+            }
+            objective.markForgeOutput();
+            objective_ = objective.forgeNodeId();
+            for (auto& y : components_) {
+                y.markForgeOutput();
+                outputs_.push_back(y.forgeNodeId());
+            }
+            components_.clear();
+            closed_ = true;
+        }
+
+        bool closed() const { return closed_; }
+        Size numOutputs() const { return closed_ ? outputs_.size() : components_.size(); }
+
+        const std::vector<forge::NodeId>& seedInputs() const { return seedInputs_; }
+        const std::vector<forge::NodeId>& outputs() const { return outputs_; }
+        forge::NodeId objective() const { return objective_; }
+
+      private:
+        std::vector<Real> components_;
+        std::vector<forge::NodeId> seedInputs_, outputs_;
+        forge::NodeId objective_ = 0;
+        bool closed_ = false;
+    };
+
+    /// values, seeded adjoints and Jacobians of a ForgeMultiOutput kernel
+    template <Size Width>
+    class ForgeJacobianEvaluator {
+      public:
+        static constexpr Size width = Width;
+
+        /// inputs are the nodes fed per scenario, gradientInputs the nodes
+        /// differentiated (usually the inputs marked with markForgeInputAndDiff)
+        ForgeJacobianEvaluator(ForgeKernel& kernel,
+                               ForgeBuffer& buffer,
+                               const ForgeMultiOutput& outputs,
+                               std::vector<forge::NodeId> inputs,
+                               std::vector<forge::NodeId> gradientInputs)
+        : numInputs_(inputs.size()), numOutputs_(outputs.numOutputs()),
+          numGradients_(gradientInputs.size()),
+          evaluator_(kernel, buffer, withSeeds(outputs, std::move(inputs)), outputs.outputs(),
+                     std::move(gradientInputs)) {
+            QL_REQUIRE(outputs.closed(), "multi-output recording not closed");
+            rows_.resize(Width * (numInputs_ + numOutputs_));
+            values_.resize(Width * numOutputs_);
+        }
+
+        Size numInputs() const { return numInputs_; }
+        Size numOutputs() const { return numOutputs_; }
+        Size numGradients() const { return numGradients_; }
+        /// kernel executions for the Jacobian of one scenario
+        Size jacobianExecutions() const { return (numOutputs_ + Width - 1) / Width; }
+
+        /// evaluates numScenarios row-major scenarios with the same seed vector
+        /// values takes numOutputs() and gradients numGradients() entries per
+        /// scenario, the latter being seeds^T J; gradients may be null.
+        void evaluate(const double* scenarios, Size numScenarios, Size stride,
+                      const std::vector<double>& seeds, double* values, double* gradients) {
+            QL_REQUIRE(seeds.size() == numOutputs_,
+                       seeds.size() << " seeds given for " << numOutputs_ << " outputs");
+            const Size n = numInputs_, m = numOutputs_, row = n + m;
+            for (Size lane = 0; lane < Width; ++lane)
+                std::copy(seeds.begin(), seeds.end(), &rows_[lane * row + n]);
+            for (Size first = 0; first < numScenarios; first += Width) {
+                const Size count = std::min(Width, numScenarios - first);
+                for (Size lane = 0; lane < count; ++lane) {
+                    const double* x = scenarios + (first + lane) * stride;
+                    std::copy(x, x + n, &rows_[lane * row]);
+                }
+                evaluator_.load(rows_.data(), row, 0, count);
+                evaluator_.execute();
+                evaluator_.readOutputs(values + first * m, m);
+                if (gradients != nullptr)
+                    evaluator_.readGradients(gradients + first * numGradients_, numGradients_);
+            }
+        }
+
+        /// the full Jacobian of one scenario given as inputs[i * stride]
+        /// values takes numOutputs() entries (may be null) and jacobian[o *
+        /// numGradients() + g] is d output_o / d gradientInput_g.
+        void jacobian(const double* inputs, Size stride, double* values, double* jacobian) {
+            const Size n = numInputs_, m = numOutputs_, row = n + m;
+            for (Size lane = 0; lane < Width; ++lane)
+                for (Size i = 0; i < n; ++i)
+                    rows_[lane * row + i] = inputs[i * stride];
+            for (Size first = 0; first < m; first += Width) {
+                const Size count = std::min(Width, m - first);
+                for (Size lane = 0; lane < count; ++lane) {
+                    double* seeds = &rows_[lane * row + n];
+                    std::fill(seeds, seeds + m, 0.0);
+                    seeds[first + lane] = 1.0;
+                }
+                evaluator_.load(rows_.data(), row, 0, count);
+                evaluator_.execute();
+                if (first == 0 && values != nullptr) {
+                    evaluator_.readOutputs(values_.data(), m);
+                    std::copy(values_.begin(), values_.begin() + m, values);
+                }
+                evaluator_.readGradients(jacobian + first * numGradients_, numGradients_);
+            }
+        }
+
+      private:
+        static std::vector<forge::NodeId> withSeeds(const ForgeMultiOutput& outputs,
+                                                    std::vector<forge::NodeId> inputs) {
+            inputs.insert(inputs.end(), outputs.seedInputs().begin(), outputs.seedInputs().end());
+            return inputs;
+        }
+
+        Size numInputs_, numOutputs_, numGradients_;
+        ForgeBatchEvaluator<Width> evaluator_;
+        std::vector<double> rows_, values_;
+    };
+
+}
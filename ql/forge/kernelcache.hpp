@@ -0,0 +1,177 @@
+/*******************************************************************************
+
+   Kernel cache keyed by the structural hash of the recorded graph.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    A book of vanilla swaps re-records the same pricing code over and over;
+    trades with identical terms (and time steps with identical remaining
+    schedules) give structurally identical graphs.  ForgeKernelCache compiles
+    each distinct graph once and hands out the shared kernel together with a
+    fresh NodeValueBuffer per caller:
+
+        ForgeKernelCache cache(config);
+        ...
+        recorder.stop();
+        auto entry = cache.acquire(recorder.graph());
+        entry.kernel->execute(*entry.buffer);
+
+    Node ids of an equivalent graph are identical to those of the graph the
+    kernel was compiled from, so ids captured during the new recording can
+    be used directly with the returned buffer.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/graphhash.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace QuantLib {
+
+    /// compiled kernel type as returned by forge::ForgeEngine::compile
+    using ForgeKernelPtr =
+        decltype(std::declval<forge::ForgeEngine&>().compile(std::declval<const forge::Graph&>()));
+    using ForgeKernel = typename std::pointer_traits<ForgeKernelPtr>::element_type;
+
+    /// buffer type as returned by forge::NodeValueBufferFactory::create
+    using ForgeBufferPtr = decltype(forge::NodeValueBufferFactory::create(
+        std::declval<const forge::Graph&>(), std::declval<ForgeKernel&>()));
+    using ForgeBuffer = typename std::pointer_traits<ForgeBufferPtr>::element_type;
+
+    /// compiles each structurally distinct graph once
+    class ForgeKernelCache {
+      public:
+        /// what a caller gets back: a shared kernel and a private buffer
+        struct Entry {
+            std::shared_ptr<ForgeKernel> kernel;
+            ForgeBufferPtr buffer;
+            std::uint64_t hash = 0;
+            bool hit = false;
+        };
+
+        explicit ForgeKernelCache(const forge::CompilerConfig& config = forge::CompilerConfig(),
+                                  const ForgeGraphHashOptions& options = ForgeGraphHashOptions())
+        : config_(config), options_(options), configHash_(forgeConfigHash(config)) {}
+
+        /// returns a compiled kernel for the graph, compiling it on a miss
+        Entry acquire(const forge::Graph& graph) {
+            Entry result;
+            result.hash = forgeGraphHash(graph, options_);
+            std::shared_ptr<const Slot> slot = find(result.hash, graph);
+            if (slot != nullptr) {
+                result.hit = true;
+            } else {
+                // compile outside the lock; concurrent misses on the same
+                // graph compile twice and the first insertion wins
+                auto compiled = std::make_shared<Slot>();
+                compiled->graph = graph;
+                forge::ForgeEngine compiler(config_);
+                compiled->kernel = std::shared_ptr<ForgeKernel>(compiler.compile(compiled->graph));
+                QL_REQUIRE(compiled->kernel != nullptr, "Forge kernel compilation failed");
+                slot = insert(result.hash, std::move(compiled));
+            }
+            result.kernel = slot->kernel;
+            result.buffer = forge::NodeValueBufferFactory::create(slot->graph, *slot->kernel);
+            return result;
+        }
+
+        /// true if an equivalent graph has already been compiled
+        bool contains(const forge::Graph& graph) const {
+            return find(forgeGraphHash(graph, options_), graph, false) != nullptr;
+        }
+
+        /// inserts an externally compiled kernel (e.g. one loaded from disk)
+        void insert(const forge::Graph& graph, std::shared_ptr<ForgeKernel> kernel) {
+            QL_REQUIRE(kernel != nullptr, "null Forge kernel");
+            auto slot = std::make_shared<Slot>();
+            slot->graph = graph;
+            slot->kernel = std::move(kernel);
+            insert(forgeGraphHash(graph, options_), std::move(slot));
+        }
+
+        void clear() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            slots_.clear();
+            hits_ = misses_ = 0;
+        }
+
+        Size size() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            Size n = 0;
+            for (const auto& bucket : slots_)
+                n += bucket.second.size();
+            return n;
+        }
+        Size hits() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return hits_;
+        }
+        Size misses() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return misses_;
+        }
+
+        const forge::CompilerConfig& config() const { return config_; }
+        const ForgeGraphHashOptions& hashOptions() const { return options_; }
+        std::uint64_t configHash() const { return configHash_; }
+
+      private:
+        struct Slot {
+            forge::Graph graph;
+            std::shared_ptr<ForgeKernel> kernel;
+        };
+
+        std::shared_ptr<const Slot>
+        find(std::uint64_t hash, const forge::Graph& graph, bool count = true) const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = slots_.find(hash);
+            if (it != slots_.end()) {
+                for (const auto& slot : it->second) {
+                    if (forgeGraphsEquivalent(slot->graph, graph, options_)) {
+                        if (count)
+                            ++hits_;
+                        return slot;
+                    }
+                }
+            }
+            if (count)
+                ++misses_;
+            return nullptr;
+        }
+
+        std::shared_ptr<const Slot> insert(std::uint64_t hash, std::shared_ptr<Slot> slot) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto& bucket = slots_[hash];
+            for (const auto& existing : bucket) {
+                if (forgeGraphsEquivalent(existing->graph, slot->graph, options_))
+                    return existing;
+            }
+            bucket.push_back(std::move(slot));
+            return bucket.back();
+        }
+
+        forge::CompilerConfig config_;
+        ForgeGraphHashOptions options_;
+        std::uint64_t configHash_;
+
+        mutable std::mutex mutex_;
+        std::unordered_map<std::uint64_t, std::vector<std::shared_ptr<const Slot>>> slots_;
+        mutable Size hits_ = 0, misses_ = 0;
+    };
+
+}
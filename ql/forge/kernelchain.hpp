@@ -0,0 +1,164 @@
+/*******************************************************************************
+
+   A curve kernel feeding several trade kernels, with chained adjoints.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Every swap kernel recorded against market quotes re-derives the same
+    discount factors: the curve bootstrap and interpolation are unrolled
+    into each trade graph, so each trade kernel is large and slow to
+    compile.  Splitting the graph at the curve gives one curve kernel, from
+    the market quotes to the curve nodes (discount factors or zero rates on
+    a time grid), and one small kernel per trade, from those curve nodes to
+    the trade NPV.
+
+    The curve is recorded with ForgeMultiOutput so that its reverse pass can
+    be seeded, and each trade marks its copies of the curve nodes as inputs,
+    in the order of the curve outputs:
+
+        // curve kernel
+        recorder.start();
+        ... mark the quotes (markForgeInputAndDiff) and build the curve ...
+        ForgeMultiOutput curveNodes;
+        for (Time t : grid)
+            curveNodes.add(curve->discount(t));
+        curveNodes.close();
+        recorder.stop();
+
+        // one trade kernel, recorded against the curve nodes
+        recorder.start();
+        std::vector<Real> df(grid.size());
+        ... df[i].markForgeInputAndDiff(), build an interpolated curve on them,
+            price the swap and mark its NPV ...
+        recorder.stop();
+
+        ForgeCurveTradeChain<4> chain(*curveKernel, *curveBuffer, curveNodes,
+                                      quotes, quotes);
+        chain.addTrade(*swapKernel, *swapBuffer, dfIds, npvId);
+        chain.evaluate(scenarios, numScenarios, stride, npvs, sensitivities);
+
+    evaluate() runs the curve kernel, copies its outputs into the inputs of
+    every trade kernel and runs those.  For sensitivities, the trade adjoints
+    with respect to the curve nodes are summed and fed back as the seeds of
+    a second curve execution, which turns them into portfolio sensitivities
+    to the market quotes.  A curve change thus costs one or two curve runs
+    plus one cheap run per trade, however many trades share the curve.
+
+    Forge kernels do not share buffers, so the curve nodes are carried from
+    the curve buffer to the trade buffers by the chain, Width lanes at a time.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/batchevaluator.hpp>
+#include <ql/forge/jacobianevaluator.hpp>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace QuantLib {
+
+    /// a curve kernel chained into trade kernels recorded on its outputs
+    template <Size Width>
+    class ForgeCurveTradeChain {
+      public:
+        static constexpr Size width = Width;
+
+        /// marketInputs are the nodes fed per scenario, marketGradientInputs
+        /// those differentiated; curveNodes the closed curve outputs
+        ForgeCurveTradeChain(ForgeKernel& curveKernel,
+                             ForgeBuffer& curveBuffer,
+                             const ForgeMultiOutput& curveNodes,
+                             std::vector<forge::NodeId> marketInputs,
+                             std::vector<forge::NodeId> marketGradientInputs)
+        : numInputs_(marketInputs.size()), numCurveNodes_(curveNodes.numOutputs()),
+          numGradients_(marketGradientInputs.size()) {
+            QL_REQUIRE(curveNodes.closed(), "curve node recording not closed");
+            marketInputs.insert(marketInputs.end(), curveNodes.seedInputs().begin(),
+                                curveNodes.seedInputs().end());
+            curve_ = std::make_unique<ForgeBatchEvaluator<Width>>(
+                curveKernel, curveBuffer, std::move(marketInputs), curveNodes.outputs(),
+                std::move(marketGradientInputs));
+            rows_.resize(Width * (numInputs_ + numCurveNodes_));
+            nodes_.resize(Width * numCurveNodes_);
+            seeds_.resize(Width * numCurveNodes_);
+        }
+
+        /// adds a trade whose kernel reads the curve nodes from curveInputs,
+        /// recorded with markForgeInputAndDiff; returns the trade index
+        Size addTrade(ForgeKernel& kernel,
+                      ForgeBuffer& buffer,
+                      std::vector<forge::NodeId> curveInputs,
+                      forge::NodeId npv) {
+            QL_REQUIRE(curveInputs.size() == numCurveNodes_,
+                       "trade reads " << curveInputs.size() << " curve nodes, the curve has "
+                                      << numCurveNodes_);
+            std::vector<forge::NodeId> gradients = curveInputs;
+            trades_.push_back(std::make_unique<ForgeBatchEvaluator<Width>>(
+                kernel, buffer, std::move(curveInputs), std::vector<forge::NodeId>{npv},
+                std::move(gradients)));
+            return trades_.size() - 1;
+        }
+
+        Size numInputs() const { return numInputs_; }
+        Size numCurveNodes() const { return numCurveNodes_; }
+        Size numGradients() const { return numGradients_; }
+        Size numTrades() const { return trades_.size(); }
+
+        /// evaluates numScenarios row-major market scenarios
+        /// npvs[s * numTrades() + t] is the NPV of trade t; sensitivities
+        /// takes numGradients() entries per scenario, those of the sum of
+        /// the trade NPVs to the market gradient inputs (may be null).
+        void evaluate(const double* scenarios, Size numScenarios, Size stride, double* npvs,
+                      double* sensitivities) {
+            QL_REQUIRE(!trades_.empty(), "no trades added to the curve chain");
+            const Size n = numInputs_, m = numCurveNodes_, row = n + m, T = trades_.size();
+            for (Size first = 0; first < numScenarios; first += Width) {
+                const Size count = std::min(Width, numScenarios - first);
+                for (Size lane = 0; lane < count; ++lane) {
+                    const double* x = scenarios + (first + lane) * stride;
+                    std::copy(x, x + n, &rows_[lane * row]);
+                    std::fill(&rows_[lane * row + n], &rows_[lane * row + n] + m, 0.0);
+                }
+                curve_->load(rows_.data(), row, 0, count);
+                curve_->execute();
+                curve_->readOutputs(nodes_.data(), m);
+
+                std::fill(seeds_.begin(), seeds_.end(), 0.0);
+                for (Size t = 0; t < T; ++t) {
+                    ForgeBatchEvaluator<Width>& trade = *trades_[t];
+                    trade.load(nodes_.data(), m, 0, count);
+                    trade.execute();
+                    trade.readOutputs(npvs + first * T + t, T);
+                    if (sensitivities != nullptr)
+                        trade.readGradients(seeds_.data(), m, 1, true);
+                }
+                if (sensitivities == nullptr)
+                    continue;
+
+                // vector-Jacobian product of the summed trade adjoints through the curve
+                for (Size lane = 0; lane < count; ++lane)
+                    std::copy(&seeds_[lane * m], &seeds_[lane * m] + m, &rows_[lane * row + n]);
+                curve_->load(rows_.data(), row, 0, count);
+                curve_->execute();
+                curve_->readGradients(sensitivities + first * numGradients_, numGradients_);
+            }
+        }
+
+      private:
+        Size numInputs_, numCurveNodes_, numGradients_;
+        std::unique_ptr<ForgeBatchEvaluator<Width>> curve_;
+        std::vector<std::unique_ptr<ForgeBatchEvaluator<Width>>> trades_;
+        std::vector<double> rows_, nodes_, seeds_;
+    };
+
+}
@@ -0,0 +1,230 @@
+/*******************************************************************************
+
+   Float32 scenario screening with double-precision forward kernels.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Pre-deal screening and PFE estimation run forward kernels (recorded
+    with markForgeInput) over scenario sets far larger than the cache, so
+    that reading scenarios and writing values costs more than executing
+    the kernel.  None of it needs double precision.
+
+    ForgeFloatScenarioCube stores the scenarios as float32 in the layout of
+    ForgeScenarioCube, halving the bytes per scenario, and
+    ForgeMixedPrecisionEvaluator<Width> runs a kernel over it: each batch is
+    widened into the double lanes of the buffer on load, and the values come
+    back as float32, or are summed in double where only path averages are
+    needed (expected exposure),
+
+        ForgeFloatScenarioCube screening = forgeFloatScenarioCube(cube);
+        ForgeMixedPrecisionEvaluator<4> evaluator(*kernel, *buffer, inputs, {npv});
+        std::vector<float> npvs(screening.paths());
+        evaluator.evaluate(screening, t, npvs.data());
+        ...
+        double sum = 0.0;
+        evaluator.accumulate(screening, t, &sum);
+
+    The kernels themselves stay double: Forge generates SSE2 and AVX2
+    double code only, so the lane count is that of the instruction set and
+    the rounding error comes from the float32 scenarios and values alone.
+    forgeMixedPrecisionAccuracy() measures it on a sample batch against the
+    double scenarios and values of the same kernel; the report tells
+    whether the screening results are good enough for the trade at hand.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/batchevaluator.hpp>
+#include <ql/forge/scenariocube.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+namespace QuantLib {
+
+    /// the cube rounded to float32, with the same shape and lane width
+    inline ForgeFloatScenarioCube forgeFloatScenarioCube(const ForgeScenarioCube& cube) {
+        ForgeFloatScenarioCube result(cube.timeSteps(), cube.paths(), cube.factors(),
+                                      cube.laneWidth());
+        const double* in = cube.data();
+        float* out = result.data();
+        for (Size k = 0; k < cube.size(); ++k)
+            out[k] = float(in[k]);
+        return result;
+    }
+
+    /// forward kernel evaluation over float32 scenarios
+    template <Size Width>
+    class ForgeMixedPrecisionEvaluator {
+      public:
+        ForgeMixedPrecisionEvaluator(ForgeKernel& kernel,
+                                     ForgeBuffer& buffer,
+                                     std::vector<forge::NodeId> inputs,
+                                     std::vector<forge::NodeId> outputs)
+        : evaluator_(kernel, buffer, std::move(inputs), std::move(outputs)),
+          values_(evaluator_.numOutputs() * Width) {
+            QL_REQUIRE(evaluator_.numOutputs() > 0, "no outputs given for the evaluator");
+        }
+
+        Size numInputs() const { return evaluator_.numInputs(); }
+        Size numOutputs() const { return evaluator_.numOutputs(); }
+
+        /// writes the outputs of every path of time step t to values[p * numOutputs() + o]
+        void evaluate(const ForgeFloatScenarioCube& cube, Size t, float* values) {
+            const Size m = numOutputs();
+            run(cube, t, [=](Size p, Size o, double v) { values[p * m + o] = float(v); });
+        }
+
+        /// adds the outputs of every path of time step t to sums[o], in double
+        void accumulate(const ForgeFloatScenarioCube& cube, Size t, double* sums) {
+            run(cube, t, [=](Size, Size o, double v) { sums[o] += v; });
+        }
+
+      private:
+        template <class Sink>
+        void run(const ForgeFloatScenarioCube& cube, Size t, Sink sink) {
+            QL_REQUIRE(cube.laneWidth() == Width,
+                       "cube of lane width " << cube.laneWidth() << " for batch width " << Width);
+            QL_REQUIRE(cube.factors() == numInputs(),
+                       "cube has " << cube.factors() << " factors for " << numInputs() << " inputs");
+            const Size m = numOutputs();
+            for (Size b = 0; b < cube.batches(); ++b) {
+                const Size count = cube.batchSize(b);
+                evaluator_.loadInterleaved(cube.batch(t, b), count);
+                evaluator_.execute();
+                evaluator_.readOutputBlock(values_.data());
+                for (Size o = 0; o < m; ++o)
+                    for (Size lane = 0; lane < count; ++lane)
+                        sink(b * Width + lane, o, values_[o * Width + lane]);
+            }
+        }
+
+        ForgeBatchEvaluator<Width> evaluator_;
+        std::vector<double> values_;
+    };
+
+    /// float32 against double results of one kernel on a sample of paths
+    struct ForgeMixedPrecisionAccuracy {
+        Size paths = 0;
+        /// per output: the largest absolute error over the paths and the path where it occurs
+        std::vector<double> maxAbsError;
+        std::vector<Size> worstPath;
+        /// per output: the root mean square error
+        std::vector<double> rmsError;
+        /// per output: the largest absolute double value, the scale of the errors
+        std::vector<double> scale;
+        /// per output: the error of the path average, from double accumulation
+        std::vector<double> meanError;
+
+        Size outputs() const { return maxAbsError.size(); }
+        /// largest absolute error relative to the scale of the output
+        double maxRelativeError(Size o) const {
+            return scale[o] > 0.0 ? maxAbsError[o] / scale[o] : maxAbsError[o];
+        }
+
+        void report(std::ostream& out) const {
+            out << "[Forge] float32 scenarios and values against double, " << paths << " paths\n";
+            out << std::setw(8) << "output" << std::setw(14) << "scale" << std::setw(14)
+                << "max abs err" << std::setw(14) << "max rel err" << std::setw(14) << "rms err"
+                << std::setw(14) << "mean err" << std::setw(8) << "worst\n";
+            for (Size o = 0; o < outputs(); ++o)
+                out << std::setw(8) << o << std::scientific << std::setprecision(3)
+                    << std::setw(14) << scale[o] << std::setw(14) << maxAbsError[o]
+                    << std::setw(14) << maxRelativeError(o) << std::setw(14) << rmsError[o]
+                    << std::setw(14) << meanError[o] << std::defaultfloat << std::setw(7)
+                    << worstPath[o] << "\n";
+        }
+    };
+
+    /// compares the kernel on the first samplePaths paths of time step t of a double
+    /// cube with the same paths rounded to float32 and their values rounded on output
+    template <Size Width>
+    ForgeMixedPrecisionAccuracy forgeMixedPrecisionAccuracy(ForgeKernel& kernel,
+                                                            ForgeBuffer& buffer,
+                                                            const std::vector<forge::NodeId>& inputs,
+                                                            const std::vector<forge::NodeId>& outputs,
+                                                            const ForgeScenarioCube& cube,
+                                                            Size t,
+                                                            Size samplePaths) {
+        QL_REQUIRE(cube.laneWidth() == Width,
+                   "cube of lane width " << cube.laneWidth() << " for batch width " << Width);
+        QL_REQUIRE(cube.factors() == inputs.size(),
+                   "cube has " << cube.factors() << " factors for " << inputs.size() << " inputs");
+        const Size paths = std::min(samplePaths, cube.paths());
+        QL_REQUIRE(paths > 0, "no sample paths for the accuracy report");
+        const Size n = inputs.size(), m = outputs.size();
+
+        ForgeBatchEvaluator<Width> evaluator(kernel, buffer, inputs, outputs);
+        ForgeMixedPrecisionAccuracy accuracy;
+        accuracy.paths = paths;
+        accuracy.maxAbsError.assign(m, 0.0);
+        accuracy.worstPath.assign(m, 0);
+        accuracy.rmsError.assign(m, 0.0);
+        accuracy.scale.assign(m, 0.0);
+        accuracy.meanError.assign(m, 0.0);
+        std::vector<double> exact(m * Width), rounded(m * Width), exactSums(m, 0.0),
+            roundedSums(m, 0.0);
+        std::vector<float> block(n * Width);
+
+        for (Size first = 0, b = 0; first < paths; first += Width, ++b) {
+            const Size count = std::min(Width, paths - first);
+            evaluator.loadInterleaved(cube.batch(t, b), count);
+            evaluator.execute();
+            evaluator.readOutputBlock(exact.data());
+            const double* source = cube.batch(t, b);
+            for (Size k = 0; k < n * Width; ++k)
+                block[k] = float(source[k]);
+            evaluator.loadInterleaved(block.data(), count);
+            evaluator.execute();
+            evaluator.readOutputBlock(rounded.data());
+
+            for (Size o = 0; o < m; ++o) {
+                for (Size lane = 0; lane < count; ++lane) {
+                    const double x = exact[o * Width + lane];
+                    const double y = rounded[o * Width + lane];
+                    const double error = std::fabs(double(float(y)) - x);
+                    if (error > accuracy.maxAbsError[o] || first + lane == 0) {
+                        accuracy.maxAbsError[o] = error;
+                        accuracy.worstPath[o] = first + lane;
+                    }
+                    accuracy.rmsError[o] += error * error;
+                    accuracy.scale[o] = std::max(accuracy.scale[o], std::fabs(x));
+                    exactSums[o] += x;
+                    roundedSums[o] += y;
+                }
+            }
+        }
+        for (Size o = 0; o < m; ++o) {
+            accuracy.rmsError[o] = std::sqrt(accuracy.rmsError[o] / paths);
+            accuracy.meanError[o] = std::fabs(roundedSums[o] - exactSums[o]) / paths;
+        }
+        return accuracy;
+    }
+
+    /// as above, with the batch width picked from the buffer
+    inline ForgeMixedPrecisionAccuracy forgeMixedPrecisionAccuracy(
+        ForgeKernel& kernel,
+        ForgeBuffer& buffer,
+        const std::vector<forge::NodeId>& inputs,
+        const std::vector<forge::NodeId>& outputs,
+        const ForgeScenarioCube& cube,
+        Size t,
+        Size samplePaths = 256) {
+        return forgeWithBatchWidth(Size(buffer.getVectorWidth()), [&](auto w) {
+            return forgeMixedPrecisionAccuracy<decltype(w)::value>(kernel, buffer, inputs, outputs,
+                                                                   cube, t, samplePaths);
+        });
+    }
+
+}
@@ -0,0 +1,288 @@
+/*******************************************************************************
+
+   Monte Carlo path evaluation inside one recorded single-path Forge kernel.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    A Monte Carlo pricer is recorded for one path, with the Gaussian draws of
+    the path as kernel inputs next to the model parameters:
+
+        recorder.start();
+        std::vector<Real> params = {s0, vol, rate};
+        for (auto& p : params) p.markForgeInputAndDiff();
+        std::vector<Real> z(numSteps);
+        for (auto& x : z) x.markForgeInput();
+        Real payoff = discountedPayoff(params, z);
+        payoff.markForgeOutput();
+        recorder.stop();
+
+    ForgeMonteCarloKernelRunner<Width> then evaluates Width paths per
+    execute() call.  The draws of every batch are generated straight into
+    the lane-interleaved input block from a Philox4x32-10 counter-based
+    generator keyed by the seed, with the counter holding the path index and
+    the draw index, so no scenario cube is kept in memory and path p sees the
+    same draws whatever the batch, the vector width or the thread that runs
+    it.  Payoffs, their squares and the pathwise adjoints of the first output
+    are summed per lane across batches, and the lanes are only reduced at the
+    end of run():
+
+        ForgeMonteCarloKernelRunner<4> runner(*kernel, *buffer, zIds, {payoffId},
+                                              paramIds, paramIds, seed);
+        runner.setParameters({100.0, 0.2, 0.03});
+        ForgeMonteCarloResult mc = runner.run(numPaths);
+        Real price = mc.mean(0), delta = mc.gradient(0);
+
+    Paths [first, first + n) can be run separately, e.g. by the workers of a
+    ForgeParallelScenarioEvaluator with one runner per buffer, and the results
+    added up.  The draws do not depend on the split, only the order of the
+    floating-point sums does.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/batchevaluator.hpp>
+#include <expressions/ExpressionTemplates/ForgeSpecialFunctions.hpp>
+#include <graph/handles.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace QuantLib {
+
+    /// Philox4x32-10 counter-based generator (Salmon et al., SC'11)
+    class ForgePhilox4x32 {
+      public:
+        typedef std::array<std::uint32_t, 4> Counter;
+        typedef std::array<std::uint32_t, 2> Key;
+
+        explicit ForgePhilox4x32(std::uint64_t seed = 0)
+        : key_{{std::uint32_t(seed), std::uint32_t(seed >> 32)}} {}
+        explicit ForgePhilox4x32(const Key& key) : key_(key) {}
+
+        const Key& key() const { return key_; }
+
+        /// the four random words of one counter value
+        Counter operator()(Counter ctr) const {
+            Key key = key_;
+            for (int round = 0; round < 10; ++round) {
+                if (round > 0) {
+                    key[0] += 0x9E3779B9U;
+                    key[1] += 0xBB67AE85U;
+                }
+                const std::uint64_t p0 = std::uint64_t(0xD2511F53U) * ctr[0];
+                const std::uint64_t p1 = std::uint64_t(0xCD9E8D57U) * ctr[2];
+                ctr = {{std::uint32_t(p1 >> 32) ^ ctr[1] ^ key[0], std::uint32_t(p1),
+                        std::uint32_t(p0 >> 32) ^ ctr[3] ^ key[1], std::uint32_t(p0)}};
+            }
+            return ctr;
+        }
+
+        /// writes standard normal draws [0, n) of a path to out[d * stride]
+        /// Each counter value (path, d / 2) gives two 53-bit uniforms, which are
+        /// mapped through the inverse normal CDF.
+        void gaussians(std::uint64_t path, Size n, double* out, Size stride = 1) const {
+            for (Size d = 0; d < n; d += 2) {
+                const std::uint64_t block = d / 2;
+                Counter r = (*this)({{std::uint32_t(path), std::uint32_t(path >> 32),
+                                      std::uint32_t(block), std::uint32_t(block >> 32)}});
+                out[d * stride] = gaussian(r[0], r[1]);
+                if (d + 1 < n)
+                    out[(d + 1) * stride] = gaussian(r[2], r[3]);
+            }
+        }
+
+        /// uniform in (0, 1) from two random words
+        static double uniform(std::uint32_t hi, std::uint32_t lo) {
+            const std::uint64_t bits = ((std::uint64_t(hi) << 32) | lo) >> 11;
+            return (double(bits) + 0.5) * (1.0 / 9007199254740992.0);
+        }
+
+      private:
+        static double gaussian(std::uint32_t hi, std::uint32_t lo) {
+            return forge::expr::inverse_normcdf(uniform(hi, lo));
+        }
+
+        Key key_;
+    };
+
+    /// path statistics of a Monte Carlo run
+    struct ForgeMonteCarloResult {
+        Size paths = 0;
+        /// sums over paths, one entry per output
+        std::vector<double> sum, sumSquares;
+        /// sums over paths of the adjoints of the first output, one per gradient input
+        std::vector<double> gradientSum;
+
+        double mean(Size output = 0) const {
+            QL_REQUIRE(output < sum.size(), "output " << output << " out of range");
+            QL_REQUIRE(paths > 0, "no paths evaluated");
+            return sum[output] / paths;
+        }
+        /// standard error of mean(output)
+        double errorEstimate(Size output = 0) const {
+            const double m = mean(output);
+            if (paths < 2)
+                return 0.0;
+            const double variance = (sumSquares[output] / paths - m * m) * paths / (paths - 1);
+            return std::sqrt(std::max(variance, 0.0) / paths);
+        }
+        /// pathwise estimate of the derivative of mean(0) with respect to gradient input g
+        double gradient(Size g) const {
+            QL_REQUIRE(g < gradientSum.size(), "gradient input " << g << " out of range");
+            QL_REQUIRE(paths > 0, "no paths evaluated");
+            return gradientSum[g] / paths;
+        }
+
+        /// adds the paths of another run of the same kernel
+        ForgeMonteCarloResult& operator+=(const ForgeMonteCarloResult& other) {
+            if (paths == 0) {
+                *this = other;
+                return *this;
+            }
+            QL_REQUIRE(other.sum.size() == sum.size() &&
+                           other.gradientSum.size() == gradientSum.size(),
+                       "Monte Carlo results of different kernels");
+            paths += other.paths;
+            for (Size o = 0; o < sum.size(); ++o) {
+                sum[o] += other.sum[o];
+                sumSquares[o] += other.sumSquares[o];
+            }
+            for (Size g = 0; g < gradientSum.size(); ++g)
+                gradientSum[g] += other.gradientSum[g];
+            return *this;
+        }
+    };
+
+    /// evaluates a single-path kernel over Philox-generated paths, Width paths per execute()
+    template <Size Width>
+    class ForgeMonteCarloKernelRunner {
+      public:
+        static constexpr Size width = Width;
+
+        /// gaussianInputs are the draws of one path, in draw order; parameterInputs
+        /// are set once with setParameters(); gradientInputs are the nodes whose
+        /// adjoints are averaged (usually the parameters marked for differentiation)
+        ForgeMonteCarloKernelRunner(ForgeKernel& kernel,
+                                    ForgeBuffer& buffer,
+                                    const std::vector<forge::NodeId>& gaussianInputs,
+                                    const std::vector<forge::NodeId>& outputs,
+                                    const std::vector<forge::NodeId>& parameterInputs = {},
+                                    const std::vector<forge::NodeId>& gradientInputs = {},
+                                    std::uint64_t seed = 0)
+        : evaluator_(kernel, buffer, concat(parameterInputs, gaussianInputs), outputs,
+                     gradientInputs),
+          rng_(seed), numParameters_(parameterInputs.size()),
+          numDraws_(gaussianInputs.size()) {
+            QL_REQUIRE(numDraws_ > 0, "no Gaussian inputs given");
+            QL_REQUIRE(!outputs.empty(), "no outputs given");
+            block_.resize((numParameters_ + numDraws_) * Width);
+            values_.resize(Width * outputs.size());
+            parametersSet_ = numParameters_ == 0;
+        }
+
+        Size numDraws() const { return numDraws_; }
+        Size numParameters() const { return numParameters_; }
+        Size numOutputs() const { return evaluator_.numOutputs(); }
+        Size numGradients() const { return evaluator_.numGradients(); }
+        const ForgePhilox4x32& generator() const { return rng_; }
+
+        /// values of the parameter inputs, the same on every path
+        void setParameters(const std::vector<double>& values) {
+            QL_REQUIRE(values.size() == numParameters_,
+                       values.size() << " parameter values for " << numParameters_
+                                     << " parameter inputs");
+            for (Size i = 0; i < numParameters_; ++i)
+                std::fill(block_.begin() + i * Width, block_.begin() + (i + 1) * Width, values[i]);
+            parametersSet_ = true;
+        }
+
+        /// evaluates paths [firstPath, firstPath + numPaths)
+        ForgeMonteCarloResult run(Size numPaths, std::uint64_t firstPath = 0) {
+            QL_REQUIRE(parametersSet_, "parameter values not set");
+            const Size numOutputs = evaluator_.numOutputs();
+            const Size numGradients = evaluator_.numGradients();
+            // per-lane sums, reduced across lanes once at the end
+            std::vector<double> laneSum(Width * numOutputs, 0.0),
+                laneSumSquares(Width * numOutputs, 0.0), laneGradients(Width * numGradients, 0.0);
+            double* draws = block_.data() + numParameters_ * Width;
+
+            for (Size first = 0; first < numPaths; first += Width) {
+                const Size count = std::min(Width, numPaths - first);
+                for (Size lane = 0; lane < count; ++lane)
+                    rng_.gaussians(firstPath + first + lane, numDraws_, draws + lane, Width);
+                evaluator_.loadInterleaved(block_.data(), count);
+                evaluator_.execute();
+                evaluator_.readOutputs(values_.data(), numOutputs);
+                for (Size lane = 0; lane < count; ++lane) {
+                    for (Size o = 0; o < numOutputs; ++o) {
+                        const double v = values_[lane * numOutputs + o];
+                        laneSum[lane * numOutputs + o] += v;
+                        laneSumSquares[lane * numOutputs + o] += v * v;
+                    }
+                }
+                if (numGradients > 0)
+                    evaluator_.readGradients(laneGradients.data(), numGradients, 1, true);
+            }
+
+            ForgeMonteCarloResult result;
+            result.paths = numPaths;
+            result.sum.assign(numOutputs, 0.0);
+            result.sumSquares.assign(numOutputs, 0.0);
+            result.gradientSum.assign(numGradients, 0.0);
+            for (Size lane = 0; lane < Width; ++lane) {
+                for (Size o = 0; o < numOutputs; ++o) {
+                    result.sum[o] += laneSum[lane * numOutputs + o];
+                    result.sumSquares[o] += laneSumSquares[lane * numOutputs + o];
+                }
+                for (Size g = 0; g < numGradients; ++g)
+                    result.gradientSum[g] += laneGradients[lane * numGradients + g];
+            }
+            return result;
+        }
+
+      private:
+        static std::vector<forge::NodeId> concat(const std::vector<forge::NodeId>& a,
+                                                 const std::vector<forge::NodeId>& b) {
+            std::vector<forge::NodeId> r(a);
+            r.insert(r.end(), b.begin(), b.end());
+            return r;
+        }
+
+        ForgeBatchEvaluator<Width> evaluator_;
+        ForgePhilox4x32 rng_;
+        Size numParameters_, numDraws_;
+        std::vector<double> block_, values_;
+        bool parametersSet_ = false;
+    };
+
+    /// Monte Carlo run with the batch width picked from the buffer
+    inline ForgeMonteCarloResult forgeRunMonteCarlo(ForgeKernel& kernel,
+                                                    ForgeBuffer& buffer,
+                                                    const std::vector<forge::NodeId>& gaussianInputs,
+                                                    const std::vector<forge::NodeId>& outputs,
+                                                    const std::vector<forge::NodeId>& parameterInputs,
+                                                    const std::vector<double>& parameters,
+                                                    const std::vector<forge::NodeId>& gradientInputs,
+                                                    Size numPaths,
+                                                    std::uint64_t seed = 0,
+                                                    std::uint64_t firstPath = 0) {
+        return forgeWithBatchWidth(Size(buffer.getVectorWidth()), [&](auto w) {
+            ForgeMonteCarloKernelRunner<decltype(w)::value> runner(
+                kernel, buffer, gaussianInputs, outputs, parameterInputs, gradientInputs, seed);
+            runner.setParameters(parameters);
+            return runner.run(numPaths, firstPath);
+        });
+    }
+
+}
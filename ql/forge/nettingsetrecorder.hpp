@@ -0,0 +1,164 @@
+/*******************************************************************************
+
+   Recording a netting set of trades into one multi-output Forge graph.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Recording every trade on its own gives one kernel per trade, each of
+    which re-evaluates the same curve from the same market inputs.
+    ForgeNettingSetRecorder records all trades of a netting set between a
+    single start() and stop(): the market inputs are marked once and shared,
+    each trade's NPV becomes an output, and optionally the netting-set total
+    is added as well.  One execute() then values the whole netting set for a
+    scenario, and with CSE enabled the compiler folds identical curve
+    sub-graphs built by different trades into one.
+
+    Trades can share more than the inputs: build the curve once from
+    inputs() and price every trade against it, which avoids relying on CSE
+    altogether.
+
+        ForgeNettingSetRecorder recorder(marketValues);
+        recorder.start();
+        auto curve = buildCurve(recorder.inputs());
+        for (const auto& trade : trades)
+            recorder.addTrade(priceOn(trade, curve));
+        recorder.stop();
+
+    Outputs are marked in stop().  The netting-set total, when requested,
+    comes first: the reverse pass is seeded from the first output, so the
+    kernel adjoints are then netting-set sensitivities while the trade NPVs
+    remain readable as further outputs.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <graph/graph_recorder.hpp>
+#include <graph/handles.hpp>
+#include <vector>
+
+namespace QuantLib {
+
+    /// output options of ForgeNettingSetRecorder
+    struct ForgeNettingSetOptions {
+        /// mark inputs for differentiation (markForgeInputAndDiff)
+        bool differentiate = true;
+        /// mark every trade NPV as an output
+        bool tradeOutputs = true;
+        /// add the sum of all trade NPVs as the first output
+        bool totalOutput = false;
+    };
+
+    /// records N trades sharing one set of market inputs into one graph
+    class ForgeNettingSetRecorder {
+      public:
+        explicit ForgeNettingSetRecorder(std::vector<double> inputValues,
+                                         const ForgeNettingSetOptions& options = ForgeNettingSetOptions())
+        : values_(std::move(inputValues)), options_(options) {
+            QL_REQUIRE(options_.tradeOutputs || options_.totalOutput,
+                       "netting set recording without outputs");
+        }
+
+        /// starts recording and marks the shared inputs
+        void start() {
+            QL_REQUIRE(!recording_, "netting set recording already started");
+            recorder_.start();
+            recording_ = true;
+            inputs_.assign(values_.begin(), values_.end());
+            inputIds_.clear();
+            outputIds_.clear();
+            tradeIds_.clear();
+            trades_.clear();
+            numTrades_ = 0;
+            for (auto& x : inputs_) {
+                if (options_.differentiate)
+                    x.markForgeInputAndDiff();
+                else
+                    x.markForgeInput();
+                inputIds_.push_back(x.forgeNodeId());
+            }
+        }
+
+        /// shared inputs to price the trades from
+        const std::vector<Real>& inputs() const {
+            QL_REQUIRE(recording_, "netting set recording not started");
+            return inputs_;
+        }
+
+        /// adds a trade NPV computed from inputs(); returns the trade index
+        Size addTrade(const Real& npv) {
+            QL_REQUIRE(recording_, "netting set recording not started");
+            trades_.push_back(npv);
+            return trades_.size() - 1;
+        }
+
+        /// prices a trade with pricer(inputs()) and adds it
+        template <class Pricer>
+        Size priceTrade(Pricer pricer) {
+            return addTrade(Real(pricer(inputs())));
+        }
+
+        /// marks the outputs, total first, and stops recording
+        void stop() {
+            QL_REQUIRE(recording_, "netting set recording not started");
+            QL_REQUIRE(!trades_.empty(), "no trades recorded in netting set");
+            if (options_.totalOutput) {
+                Real total = trades_.front();
+                for (Size i = 1; i < trades_.size(); ++i)
+                    total += trades_[i];
+                total.markForgeOutput();
+                totalId_ = total.forgeNodeId();
+                outputIds_.push_back(totalId_);
+            }
+            if (options_.tradeOutputs) {
+                for (auto& npv : trades_) {
+                    npv.markForgeOutput();
+                    tradeIds_.push_back(npv.forgeNodeId());
+                    outputIds_.push_back(npv.forgeNodeId());
+                }
+            }
+            numTrades_ = trades_.size();
+            trades_.clear();
+            recorder_.stop();
+            recording_ = false;
+        }
+
+        const forge::Graph& graph() const {
+            QL_REQUIRE(!recording_, "netting set recording still active");
+            return recorder_.graph();
+        }
+
+        Size numTrades() const { return recording_ ? trades_.size() : numTrades_; }
+        const std::vector<forge::NodeId>& inputNodeIds() const { return inputIds_; }
+        /// all output nodes in marking order: the total, if any, then the trades
+        const std::vector<forge::NodeId>& outputNodeIds() const { return outputIds_; }
+        forge::NodeId tradeNodeId(Size i) const {
+            QL_REQUIRE(options_.tradeOutputs, "trade NPVs are not recorded as outputs");
+            QL_REQUIRE(i < tradeIds_.size(), "trade index " << i << " out of range");
+            return tradeIds_[i];
+        }
+        forge::NodeId totalNodeId() const {
+            QL_REQUIRE(options_.totalOutput, "netting-set total is not recorded as an output");
+            return totalId_;
+        }
+
+      private:
+        std::vector<double> values_;
+        ForgeNettingSetOptions options_;
+        forge::GraphRecorder recorder_;
+        bool recording_ = false;
+        std::vector<Real> inputs_, trades_;
+        std::vector<forge::NodeId> inputIds_, outputIds_, tradeIds_;
+        Size numTrades_ = 0;
+        forge::NodeId totalId_ = forge::NodeId();
+    };
+
+}
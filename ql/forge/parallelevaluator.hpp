@@ -0,0 +1,207 @@
+/*******************************************************************************
+
+   Multi-threaded scenario evaluation sharing one compiled Forge kernel.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    A compiled kernel is immutable and can be executed concurrently, as long
+    as every thread works on its own NodeValueBuffer.  The evaluator keeps
+    one buffer per worker and splits a scenario range into chunks which the
+    workers claim from a shared atomic counter, so fast threads simply take
+    more chunks (the dynamic equivalent of work stealing, but without
+    per-thread deques).
+
+    Each worker allocates its buffer itself on first use; with first-touch
+    page placement this puts the buffer on the worker's NUMA node.  With
+    pinning enabled, worker i is bound to logical CPU i (Linux only), so the
+    placement stays valid across runs.
+
+        ForgeParallelScenarioEvaluator evaluator(kernel, graph);
+        evaluator.run(numPaths, [&](auto& buffer, Size begin, Size end, Size) {
+            for (Size p = begin; p < end; p += buffer.getVectorWidth()) {
+                ... set inputs for paths [p, p + width) ...
+                evaluator.kernel().execute(buffer);
+                ... read outputs ...
+            }
+        });
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/kernelcache.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace QuantLib {
+
+    /// threading options for ForgeParallelScenarioEvaluator
+    struct ForgeParallelOptions {
+        /// number of worker threads, 0 for std::thread::hardware_concurrency()
+        Size numThreads = 0;
+        /// scenarios per chunk, 0 to choose from the range size; rounded up to the vector width
+        Size chunkSize = 0;
+        /// pin worker i to logical CPU i (Linux only, ignored elsewhere)
+        bool pinThreads = false;
+    };
+
+    /// evaluates scenario ranges on several threads with one shared kernel
+    class ForgeParallelScenarioEvaluator {
+      public:
+        using Options = ForgeParallelOptions;
+
+        /// per-worker statistics of the last run
+        struct ThreadStats {
+            Size chunks = 0;
+            Size scenarios = 0;
+            double seconds = 0.0;
+
+            double scenariosPerSecond() const { return seconds > 0.0 ? scenarios / seconds : 0.0; }
+        };
+
+        ForgeParallelScenarioEvaluator(std::shared_ptr<ForgeKernel> kernel,
+                                       const forge::Graph& graph,
+                                       const Options& options = Options())
+        : kernel_(std::move(kernel)), graph_(graph), options_(options) {
+            QL_REQUIRE(kernel_ != nullptr, "null Forge kernel");
+            Size n = options_.numThreads;
+            if (n == 0)
+                n = std::max<Size>(1, std::thread::hardware_concurrency());
+            buffers_.resize(n);
+            stats_.resize(n);
+            // the vector width is a property of the kernel, not of the buffer
+            // instance; probe it once on the calling thread
+            vectorWidth_ = Size(forge::NodeValueBufferFactory::create(graph_, *kernel_)->getVectorWidth());
+        }
+
+        /// shares the kernel and graph of a cache entry
+        ForgeParallelScenarioEvaluator(const ForgeKernelCache::Entry& entry,
+                                       const forge::Graph& graph,
+                                       const Options& options = Options())
+        : ForgeParallelScenarioEvaluator(entry.kernel, graph, options) {}
+
+        /// runs body(buffer, begin, end, thread) over chunks covering [0, numScenarios)
+        /// Chunk boundaries are multiples of the kernel vector width, except for the
+        /// end of the range.  The first exception thrown by any worker is rethrown
+        /// once all workers have stopped.
+        template <class Body>
+        void run(Size numScenarios, Body body) {
+            const Size nThreads = buffers_.size();
+            const Size chunk = chunkSize(numScenarios, nThreads);
+            std::atomic<Size> next(0);
+            std::atomic<bool> failed(false);
+            std::exception_ptr error;
+            std::mutex errorMutex;
+
+            auto worker = [&](Size thread) {
+                ThreadStats stats;
+                auto start = std::chrono::steady_clock::now();
+                try {
+                    pin(thread);
+                    auto& buffer = buffers_[thread];
+                    if (buffer == nullptr)
+                        buffer = forge::NodeValueBufferFactory::create(graph_, *kernel_);
+                    while (!failed.load(std::memory_order_relaxed)) {
+                        Size begin = next.fetch_add(chunk, std::memory_order_relaxed);
+                        if (begin >= numScenarios)
+                            break;
+                        Size end = std::min(begin + chunk, numScenarios);
+                        body(*buffer, begin, end, thread);
+                        ++stats.chunks;
+                        stats.scenarios += end - begin;
+                    }
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error)
+                        error = std::current_exception();
+                    failed = true;
+                }
+                stats.seconds =
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                stats_[thread] = stats;
+            };
+
+            if (nThreads == 1 && !options_.pinThreads) {
+                worker(0);
+            } else {
+                // the calling thread only waits, so that pinning never
+                // changes its affinity
+                std::vector<std::thread> threads;
+                threads.reserve(nThreads);
+                for (Size i = 0; i < nThreads; ++i)
+                    threads.emplace_back(worker, i);
+                for (auto& t : threads)
+                    t.join();
+            }
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+        ForgeKernel& kernel() const { return *kernel_; }
+        Size numThreads() const { return buffers_.size(); }
+        Size vectorWidth() const { return vectorWidth_; }
+        const std::vector<ThreadStats>& threadStats() const { return stats_; }
+
+        /// total throughput of the last run, in scenarios per second of wall time
+        double scenariosPerSecond() const {
+            Size scenarios = 0;
+            double seconds = 0.0;
+            for (const auto& s : stats_) {
+                scenarios += s.scenarios;
+                seconds = std::max(seconds, s.seconds);
+            }
+            return seconds > 0.0 ? scenarios / seconds : 0.0;
+        }
+
+      private:
+        Size chunkSize(Size numScenarios, Size nThreads) const {
+            Size chunk = options_.chunkSize;
+            if (chunk == 0) {
+                // a few chunks per thread balances load without hammering the counter
+                chunk = std::max<Size>(1, numScenarios / (8 * nThreads));
+            }
+            return (chunk + vectorWidth_ - 1) / vectorWidth_ * vectorWidth_;
+        }
+
+        void pin(Size thread) const {
+#if defined(__linux__)
+            if (!options_.pinThreads)
+                return;
+            unsigned int nCpus = std::max(1U, std::thread::hardware_concurrency());
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(thread % nCpus, &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+            (void)thread;
+#endif
+        }
+
+        std::shared_ptr<ForgeKernel> kernel_;
+        forge::Graph graph_;
+        Options options_;
+        Size vectorWidth_ = 1;
+        std::vector<ForgeBufferPtr> buffers_;
+        std::vector<ThreadStats> stats_;
+    };
+
+}
@@ -0,0 +1,247 @@
+/*******************************************************************************
+
+   Recording and compiling kernels for many trades on a thread pool.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Building the kernels of a large book at start of day is serial: every
+    trade is recorded, compiled and allocated one after the other.  The
+    recording state of the integration layer is per thread already (the
+    active tape and branch guards are thread-local, and AReal asks
+    forge::GraphRecorder::isAnyRecording() for the state of the calling
+    thread), so what decides whether two threads may record at the same
+    time is the recorder state of Forge itself.
+
+    ForgeParallelKernelBuilder records and compiles numKernels kernels on a
+    pool of workers, each with its own GraphRecorder:
+
+        ForgeParallelKernelBuilder builder(config);
+        auto kernels = builder.build(trades.size(), [&](Size k) {
+            ForgeRecordedIds ids;
+            ... build trade k and its curves, mark the inputs (ids.inputs),
+                price, mark the NPV (ids.outputs) ...
+            return ids;
+        });
+
+    record(k) runs on a worker thread between start() and stop() of that
+    worker's recorder, and the node ids it returns belong to kernels[k].
+    Whether recordings overlap is chosen by ForgeRecordingConcurrency: with
+    Auto, forgeRecorderIsThreadLocal() probes once whether a recording
+    started on one thread is visible on another.  If it is, recording is
+    serialised by a mutex and only compilation and buffer allocation run
+    in parallel, which still takes the larger part of kernel creation off
+    the critical path.
+
+    QuantLib objects are not thread-safe: record(k) should only touch
+    objects it creates, and global settings such as the evaluation date
+    must be set before build().  The first exception thrown by record or
+    the compiler is rethrown once all workers have stopped.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/kernelcache.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace QuantLib {
+
+    /// true if Forge's recorder state is per thread
+    /// Probed once, by starting a recording on one helper thread and
+    /// checking GraphRecorder::isAnyRecording() on another.
+    inline bool forgeRecorderIsThreadLocal() {
+        static const bool threadLocal = [] {
+            std::promise<void> started, checked;
+            std::future<void> startedFuture = started.get_future();
+            std::shared_future<void> checkedFuture = checked.get_future().share();
+            std::thread recording([&]() {
+                forge::GraphRecorder recorder;
+                recorder.start();
+                started.set_value();
+                checkedFuture.wait();
+                recorder.stop();
+            });
+            bool visible = true;
+            std::thread probe([&]() {
+                startedFuture.wait();
+                visible = forge::GraphRecorder::isAnyRecording();
+                checked.set_value();
+            });
+            probe.join();
+            recording.join();
+            return !visible;
+        }();
+        return threadLocal;
+    }
+
+    /// whether ForgeParallelKernelBuilder records on several threads at once
+    enum class ForgeRecordingConcurrency {
+        /// parallel if forgeRecorderIsThreadLocal(), serialised otherwise
+        Auto,
+        /// one recording at a time; compilation still runs in parallel
+        Serialised,
+        /// overlapping recordings
+        Parallel
+    };
+
+    /// threading options for ForgeParallelKernelBuilder
+    struct ForgeParallelKernelBuilderOptions {
+        /// worker threads, 0 for std::thread::hardware_concurrency()
+        Size numThreads = 0;
+        ForgeRecordingConcurrency recording = ForgeRecordingConcurrency::Auto;
+    };
+
+    /// node ids returned by the record callback of ForgeParallelKernelBuilder
+    struct ForgeRecordedIds {
+        std::vector<forge::NodeId> inputs;
+        std::vector<forge::NodeId> outputs;
+    };
+
+    /// a kernel built by ForgeParallelKernelBuilder
+    struct ForgeBuiltKernel {
+        std::shared_ptr<ForgeKernel> kernel;
+        ForgeBufferPtr buffer;
+        std::vector<forge::NodeId> inputs;
+        std::vector<forge::NodeId> outputs;
+        /// time spent recording, including any wait for the recording lock
+        double recordSeconds = 0.0;
+        double compileSeconds = 0.0;
+        /// true if the kernel came from the cache
+        bool cacheHit = false;
+    };
+
+    /// records and compiles kernels on a pool of worker threads
+    class ForgeParallelKernelBuilder {
+      public:
+        using Options = ForgeParallelKernelBuilderOptions;
+
+        explicit ForgeParallelKernelBuilder(const forge::CompilerConfig& config = forge::CompilerConfig(),
+                                            const Options& options = Options())
+        : config_(config), options_(options) {}
+
+        /// compiles through a cache, which may be shared with other users
+        explicit ForgeParallelKernelBuilder(ForgeKernelCache& cache, const Options& options = Options())
+        : config_(cache.config()), options_(options), cache_(&cache) {}
+
+        Size numThreads() const {
+            return options_.numThreads != 0 ?
+                       options_.numThreads :
+                       std::max<Size>(1, std::thread::hardware_concurrency());
+        }
+
+        /// true if build() lets recordings overlap
+        bool parallelRecording() const {
+            switch (options_.recording) {
+                case ForgeRecordingConcurrency::Parallel:
+                    return true;
+                case ForgeRecordingConcurrency::Serialised:
+                    return false;
+                default:
+                    return forgeRecorderIsThreadLocal();
+            }
+        }
+
+        /// builds kernels [0, numKernels), record(k) recording kernel k
+        template <class Record>
+        std::vector<ForgeBuiltKernel> build(Size numKernels, Record record) {
+            std::vector<ForgeBuiltKernel> kernels(numKernels);
+            const Size nThreads = std::min(numThreads(), std::max<Size>(numKernels, 1));
+            const bool parallel = parallelRecording();
+            std::atomic<Size> next(0);
+            std::atomic<bool> failed(false);
+            std::exception_ptr error;
+            std::mutex errorMutex, recordMutex;
+
+            auto worker = [&]() {
+                try {
+                    forge::GraphRecorder recorder;
+                    while (!failed.load(std::memory_order_relaxed)) {
+                        const Size k = next.fetch_add(1, std::memory_order_relaxed);
+                        if (k >= numKernels)
+                            break;
+                        ForgeBuiltKernel& built = kernels[k];
+                        auto start = std::chrono::steady_clock::now();
+                        {
+                            std::unique_lock<std::mutex> lock(recordMutex, std::defer_lock);
+                            if (!parallel)
+                                lock.lock();
+                            recorder.start();
+                            ForgeRecordedIds ids;
+                            try {
+                                ids = record(k);
+                            } catch (...) {
+                                recorder.stop();
+                                throw;
+                            }
+                            recorder.stop();
+                            built.inputs = std::move(ids.inputs);
+                            built.outputs = std::move(ids.outputs);
+                        }
+                        auto recorded = std::chrono::steady_clock::now();
+                        compile(recorder.graph(), built);
+                        built.recordSeconds =
+                            std::chrono::duration<double>(recorded - start).count();
+                        built.compileSeconds = std::chrono::duration<double>(
+                                                   std::chrono::steady_clock::now() - recorded)
+                                                   .count();
+                    }
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error)
+                        error = std::current_exception();
+                    failed = true;
+                }
+            };
+
+            if (nThreads <= 1) {
+                worker();
+            } else {
+                std::vector<std::thread> threads;
+                threads.reserve(nThreads);
+                for (Size i = 0; i < nThreads; ++i)
+                    threads.emplace_back(worker);
+                for (auto& t : threads)
+                    t.join();
+            }
+            if (error)
+                std::rethrow_exception(error);
+            return kernels;
+        }
+
+      private:
+        void compile(const forge::Graph& graph, ForgeBuiltKernel& built) const {
+            if (cache_ != nullptr) {
+                ForgeKernelCache::Entry entry = cache_->acquire(graph);
+                built.kernel = std::move(entry.kernel);
+                built.buffer = std::move(entry.buffer);
+                built.cacheHit = entry.hit;
+            } else {
+                forge::ForgeEngine compiler(config_);
+                built.kernel = std::shared_ptr<ForgeKernel>(compiler.compile(graph));
+                QL_REQUIRE(built.kernel != nullptr, "Forge kernel compilation failed");
+                built.buffer = forge::NodeValueBufferFactory::create(graph, *built.kernel);
+            }
+        }
+
+        forge::CompilerConfig config_;
+        Options options_;
+        ForgeKernelCache* cache_ = nullptr;
+    };
+
+}
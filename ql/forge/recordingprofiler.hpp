@@ -0,0 +1,321 @@
+/*******************************************************************************
+
+   Attribution of recorded graph nodes to the source scopes that produced them.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    A slow kernel says nothing about which pricing code produced its
+    nodes.  Code under recording can tag its nodes with scopes (see
+    expressions/RecordingScope.hpp), and the patched QuantLib functions
+    do so already:
+
+        Real CumulativeNormalDistribution::operator()(Real z) const {
+            FORGE_SCOPE("CumulativeNormalDistribution");
+            ...
+        }
+
+    A ForgeRecordingProfiler installed on the recording thread turns the
+    tags into node ranges: nodes are numbered in recording order, so each
+    scope change closes a segment of the graph, which is attributed to
+    the chain of scopes open at the time.
+
+        forge::GraphRecorder recorder;
+        recorder.start();
+        ForgeRecordingProfiler profiler(recorder, "barrier");
+        ... mark inputs, price, mark outputs ...
+        recorder.stop();
+        ForgeRecordingProfile profile = profiler.profile();
+        profile.attributeCycles(forgeKernelTicksPerExecution(*kernel, *buffer));
+        profile.report(std::cout);
+        profile.writeFolded(file, ForgeProfileMetric::EstimatedCycles);
+
+    Each path gets the nodes recorded directly in it, their opcode
+    histogram, constant, input and active counts, and an estimated cost:
+    the sum of ForgeOpcodeWeights over its nodes, which attributeCycles()
+    rescales so that the scopes add up to a measured execution time.  The
+    folded output, one "path value" line per path such as
+
+        barrier;AnalyticBarrierEngine::calculate;CumulativeNormalDistribution 1234
+
+    is the input format of flamegraph.pl and speedscope.
+
+    The profiler reads the node count of recorder.graph() at every scope
+    change, so the recorder must expose the graph under construction there;
+    profile(graph) analyses a copy instead.  Scopes opened while the
+    profiler is installed must close before it is destroyed, which holds
+    when both live on the stack of the recording function.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/graphhash.hpp>
+#include <ql/forge/instrumentation.hpp>
+#include <ql/forge/kernelcache.hpp>
+#include <expressions/RecordingScope.hpp>
+#include <graph/graph_recorder.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace QuantLib {
+
+    /// relative execution cost of nodes, by opcode
+    /// Inputs and constants cost nothing; other opcodes cost defaultWeight
+    /// unless listed.  The unit is arbitrary, cycles per lane being natural.
+    struct ForgeOpcodeWeights {
+        double defaultWeight = 1.0;
+        std::map<std::uint32_t, double> weights;
+
+        double weight(const ForgeNodeInfo& node) const {
+            if (node.input || node.constant)
+                return 0.0;
+            auto it = weights.find(node.opcode);
+            return it != weights.end() ? it->second : defaultWeight;
+        }
+    };
+
+    /// node statistics of one scope path
+    struct ForgeScopeProfile {
+        /// scope names from the outermost, separated by ';'
+        std::string path;
+        /// nodes recorded directly in the scope, not in scopes inside it
+        Size nodes = 0;
+        /// nodes recorded in the scope and the scopes inside it
+        Size inclusiveNodes = 0;
+        Size activeNodes = 0;
+        Size constants = 0;
+        Size inputs = 0;
+        /// opcode -> nodes
+        std::map<std::uint32_t, Size> opcodes;
+        /// sum of the opcode weights of the nodes
+        double weight = 0.0;
+        /// weight, rescaled by attributeCycles() to a measured execution
+        double estimatedCycles = 0.0;
+    };
+
+    /// what writeFolded() reports per path
+    enum class ForgeProfileMetric { Nodes, ActiveNodes, Constants, EstimatedCycles };
+
+    /// per-scope statistics of one recorded graph
+    class ForgeRecordingProfile {
+      public:
+        ForgeRecordingProfile() = default;
+        explicit ForgeRecordingProfile(std::vector<ForgeScopeProfile> scopes)
+        : scopes_(std::move(scopes)) {
+            for (auto& scope : scopes_) {
+                scope.inclusiveNodes = 0;
+                totalNodes_ += scope.nodes;
+                totalWeight_ += scope.weight;
+            }
+            for (auto& outer : scopes_) {
+                const std::string prefix = outer.path + ";";
+                for (const auto& inner : scopes_)
+                    if (&inner == &outer || inner.path.compare(0, prefix.size(), prefix) == 0)
+                        outer.inclusiveNodes += inner.nodes;
+            }
+        }
+
+        /// scope paths in order of first entry
+        const std::vector<ForgeScopeProfile>& scopes() const { return scopes_; }
+        Size totalNodes() const { return totalNodes_; }
+        double totalWeight() const { return totalWeight_; }
+
+        /// the profile of a path, or null
+        const ForgeScopeProfile* find(const std::string& path) const {
+            for (const auto& scope : scopes_)
+                if (scope.path == path)
+                    return &scope;
+            return nullptr;
+        }
+
+        /// splits the cycles of one kernel execution over the scopes by weight
+        void attributeCycles(double cyclesPerExecution) {
+            for (auto& scope : scopes_)
+                scope.estimatedCycles =
+                    totalWeight_ > 0.0 ? cyclesPerExecution * scope.weight / totalWeight_ : 0.0;
+        }
+
+        /// one "path value" line per path with a non-zero value, for flamegraph.pl
+        void writeFolded(std::ostream& out, ForgeProfileMetric metric = ForgeProfileMetric::Nodes) const {
+            for (const auto& scope : scopes_) {
+                double value = 0.0;
+                switch (metric) {
+                    case ForgeProfileMetric::Nodes:
+                        value = double(scope.nodes);
+                        break;
+                    case ForgeProfileMetric::ActiveNodes:
+                        value = double(scope.activeNodes);
+                        break;
+                    case ForgeProfileMetric::Constants:
+                        value = double(scope.constants);
+                        break;
+                    case ForgeProfileMetric::EstimatedCycles:
+                        value = scope.estimatedCycles;
+                        break;
+                }
+                const auto rounded = static_cast<unsigned long long>(value + 0.5);
+                if (rounded > 0)
+                    out << scope.path << ' ' << rounded << '\n';
+            }
+        }
+
+        /// table of the paths by inclusive node count, with their most frequent opcodes
+        void report(std::ostream& out, Size topOpcodes = 4) const {
+            std::vector<const ForgeScopeProfile*> sorted;
+            for (const auto& scope : scopes_)
+                sorted.push_back(&scope);
+            std::stable_sort(sorted.begin(), sorted.end(),
+                             [](const ForgeScopeProfile* a, const ForgeScopeProfile* b) {
+                                 return a->inclusiveNodes > b->inclusiveNodes;
+                             });
+            out << "[Forge] recording profile: " << totalNodes_ << " nodes in " << scopes_.size()
+                << " scopes\n";
+            out << std::setw(10) << "incl" << std::setw(10) << "self" << std::setw(10) << "active"
+                << std::setw(10) << "const" << std::setw(12) << "est.cycles"
+                << "  scope / top opcodes\n";
+            for (const ForgeScopeProfile* scope : sorted) {
+                std::vector<std::pair<std::uint32_t, Size>> ops(scope->opcodes.begin(),
+                                                                scope->opcodes.end());
+                std::stable_sort(ops.begin(), ops.end(),
+                                 [](const std::pair<std::uint32_t, Size>& a,
+                                    const std::pair<std::uint32_t, Size>& b) {
+                                     return a.second > b.second;
+                                 });
+                out << std::setw(10) << scope->inclusiveNodes << std::setw(10) << scope->nodes
+                    << std::setw(10) << scope->activeNodes << std::setw(10) << scope->constants
+                    << std::setw(12) << std::fixed << std::setprecision(0)
+                    << scope->estimatedCycles << std::defaultfloat << "  " << scope->path;
+                for (Size k = 0; k < std::min(topOpcodes, Size(ops.size())); ++k)
+                    out << (k == 0 ? "  [" : ", ") << forgeOpcodeName(ops[k].first) << " x"
+                        << ops[k].second;
+                out << (ops.empty() || topOpcodes == 0 ? "\n" : "]\n");
+            }
+        }
+
+      private:
+        std::vector<ForgeScopeProfile> scopes_;
+        Size totalNodes_ = 0;
+        double totalWeight_ = 0.0;
+    };
+
+    /// collects the FORGE_SCOPE changes of the constructing thread during a recording
+    class ForgeRecordingProfiler : public forge::expr::RecordingScopeSink {
+      public:
+        /// nodes recorded before construction are not attributed
+        explicit ForgeRecordingProfiler(const forge::GraphRecorder& recorder,
+                                        std::string root = "recording",
+                                        ForgeOpcodeWeights weights = ForgeOpcodeWeights())
+        : recorder_(recorder), weights_(std::move(weights)),
+          previous_(forge::expr::activeRecordingScopeSink()) {
+            paths_.push_back(std::move(root));
+            stack_.push_back(0);
+            segments_.push_back({0, position()});
+            forge::expr::activeRecordingScopeSink() = this;
+        }
+
+        ~ForgeRecordingProfiler() override { forge::expr::activeRecordingScopeSink() = previous_; }
+
+        ForgeRecordingProfiler(const ForgeRecordingProfiler&) = delete;
+        ForgeRecordingProfiler& operator=(const ForgeRecordingProfiler&) = delete;
+
+        void enter(const char* tag) override {
+            const std::string path = paths_[stack_.back()] + ";" + tag;
+            auto it = index_.find(path);
+            if (it == index_.end()) {
+                it = index_.emplace(path, paths_.size()).first;
+                paths_.push_back(path);
+            }
+            stack_.push_back(it->second);
+            open(it->second);
+        }
+
+        void leave() override {
+            if (stack_.size() <= 1)
+                return;
+            stack_.pop_back();
+            open(stack_.back());
+        }
+
+        /// open scopes, outermost first, root included
+        Size depth() const { return stack_.size(); }
+
+        /// statistics of the recorder's graph
+        ForgeRecordingProfile profile() const { return profile(recorder_.graph()); }
+
+        /// statistics of a copy of the recorded graph
+        ForgeRecordingProfile profile(const forge::Graph& graph) const {
+            std::vector<ForgeScopeProfile> scopes(paths_.size());
+            for (Size p = 0; p < paths_.size(); ++p)
+                scopes[p].path = paths_[p];
+            const Size n = graph.nodes.size();
+            for (Size s = 0; s < segments_.size(); ++s) {
+                const Size begin = std::min(segments_[s].begin, n);
+                const Size end = s + 1 < segments_.size() ? std::min(segments_[s + 1].begin, n) : n;
+                ForgeScopeProfile& scope = scopes[segments_[s].path];
+                for (Size i = begin; i < end; ++i) {
+                    const ForgeNodeInfo node = forgeNodeInfo(graph.nodes[i]);
+                    ++scope.nodes;
+                    scope.activeNodes += node.active ? 1 : 0;
+                    scope.constants += node.constant ? 1 : 0;
+                    scope.inputs += node.input ? 1 : 0;
+                    ++scope.opcodes[node.opcode];
+                    scope.weight += weights_.weight(node);
+                }
+            }
+            for (auto& scope : scopes)
+                scope.estimatedCycles = scope.weight;
+            return ForgeRecordingProfile(std::move(scopes));
+        }
+
+      private:
+        struct Segment {
+            Size path;
+            Size begin;
+        };
+
+        Size position() const { return recorder_.graph().nodes.size(); }
+
+        void open(Size path) {
+            const Size begin = position();
+            if (segments_.back().begin == begin)
+                segments_.back().path = path;
+            else
+                segments_.push_back({path, begin});
+        }
+
+        const forge::GraphRecorder& recorder_;
+        ForgeOpcodeWeights weights_;
+        forge::expr::RecordingScopeSink* previous_;
+        std::vector<std::string> paths_;
+        std::map<std::string, Size> index_;
+        std::vector<Size> stack_;
+        std::vector<Segment> segments_;
+    };
+
+    /// timestamp-counter ticks per kernel execution, the average over the given runs
+    /// TSC ticks count reference cycles at the nominal clock (see instrumentation.hpp).
+    inline double forgeKernelTicksPerExecution(ForgeKernel& kernel, ForgeBuffer& buffer,
+                                               Size executions = 100) {
+        QL_REQUIRE(executions > 0, "no kernel executions to time");
+        kernel.execute(buffer);
+        const std::uint64_t start = forgeReadTsc();
+        for (Size i = 0; i < executions; ++i)
+            kernel.execute(buffer);
+        return double(forgeReadTsc() - start) / double(executions);
+    }
+
+}
@@ -0,0 +1,426 @@
+/*******************************************************************************
+
+   Recording one iteration of a rollback loop and repeating it over a state vector.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Recording a lattice or finite-difference backward induction unrolls every
+    time step into the graph, so graph memory and compile time grow with
+    steps x grid nodes.  A ForgeRepeatRegion records the body of one step
+    once, as a kernel from the state vector before the step to the state
+    vector after it:
+
+        forge::GraphRecorder recorder;
+        recorder.start();
+        ForgeRepeatRegion region;
+        std::vector<Real> v = region.state(gridSize);  // state entering the step
+        Real t = region.stepInput();                   // changes per iteration
+        Real vol = region.parameter(0.2);              // the same on every iteration
+        region.close(rollbackStep(v, t, vol));         // state leaving the step
+        recorder.stop();
+
+    ForgeRepeatRegionEvaluator<Width> then iterates the compiled kernel over
+    the state, with Width independent scenarios in the lanes, so the graph is
+    O(one step) however many steps are rolled.
+
+    close() also records one seed input per state entry and, as the first
+    output, the scalar sum of seed * state.  Forge seeds its reverse pass from
+    the first output, so each execute() returns the adjoint of the incoming
+    state, the step inputs and the parameters for the adjoint of the outgoing
+    state given as seeds.  adjoint() chains these vector-Jacobian products
+    through the steps in reverse, re-running each step from the state stored
+    for it by roll(): the only per-step memory is the state vector.
+
+    For long rollbacks even that can be too much, as it grows with steps x
+    grid nodes x lanes.  With a budget of maxStoredStates, roll() keeps only
+    the initial state and adjoint() recomputes the others, storing at most
+    c = maxStoredStates - 1 further checkpoints at a time and placing them
+    by Revolve's binomial schedule.  That reverses n steps with at most
+    (r + 1) * n step executions, for the smallest r with C(c + r, c) >= n:
+    e.g. 500 steps with c = 10 take r = 4.  With c = 0 every step is
+    recomputed from the initial state.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/batchevaluator.hpp>
+#include <graph/handles.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace QuantLib {
+
+    /// recording helper for the body of one iteration of a loop over a state vector
+    class ForgeRepeatRegion {
+      public:
+        /// marks the state entering the step; values are only used while recording
+        std::vector<Real> state(Size size, double value = 0.0) {
+            QL_REQUIRE(stateInputs_.empty(), "repeat region state already marked");
+            QL_REQUIRE(size > 0, "empty repeat region state");
+            std::vector<Real> x(size, value);
+            for (auto& xi : x) {
+                xi.markForgeInputAndDiff();
+                stateInputs_.push_back(xi.forgeNodeId());
+            }
+            return x;
+        }
+
+        /// marks an input set per iteration, e.g. the time or index of the step
+        Real stepInput(double value = 0.0) {
+            Real x = value;
+            x.markForgeInputAndDiff();
+            stepInputs_.push_back(x.forgeNodeId());
+            return x;
+        }
+
+        /// marks a loop-invariant input, e.g. a model parameter
+        Real parameter(double value) {
+            Real x = value;
+            x.markForgeInputAndDiff();
+            parameterInputs_.push_back(x.forgeNodeId());
+            return x;
+        }
+
+        /// marks the state leaving the step, which must have the size of state()
+        void close(const std::vector<Real>& next) {
+            QL_REQUIRE(!closed_, "repeat region already closed");
+            QL_REQUIRE(next.size() == stateInputs_.size(),
+                       "repeat region maps " << stateInputs_.size() << " state entries to "
+                                             << next.size());
+            Real objective = 0.0;
+            for (const auto& y : next) {
+                Real seed = 0.0;
+                seed.markForgeInput();
+                seedInputs_.push_back(seed.forgeNodeId());
+                objective += seed * y;
+            }
+            objective.markForgeOutput();
+            objective_ = objective.forgeNodeId();
+            for (auto y : next) {
+                y.markForgeOutput();
+                stateOutputs_.push_back(y.forgeNodeId());
+            }
+            closed_ = true;
+        }
+
+        bool closed() const { return closed_; }
+        Size stateSize() const { return stateInputs_.size(); }
+        Size numStepInputs() const { return stepInputs_.size(); }
+        Size numParameters() const { return parameterInputs_.size(); }
+
+        const std::vector<forge::NodeId>& stateInputs() const { return stateInputs_; }
+        const std::vector<forge::NodeId>& stepInputs() const { return stepInputs_; }
+        const std::vector<forge::NodeId>& parameterInputs() const { return parameterInputs_; }
+        const std::vector<forge::NodeId>& seedInputs() const { return seedInputs_; }
+        const std::vector<forge::NodeId>& stateOutputs() const { return stateOutputs_; }
+        forge::NodeId objective() const { return objective_; }
+
+      private:
+        std::vector<forge::NodeId> stateInputs_, stepInputs_, parameterInputs_, seedInputs_,
+            stateOutputs_;
+        forge::NodeId objective_ = 0;
+        bool closed_ = false;
+    };
+
+    /// iterates the compiled kernel of a ForgeRepeatRegion, up to Width scenarios at a time
+    template <Size Width>
+    class ForgeRepeatRegionEvaluator {
+      public:
+        static constexpr Size width = Width;
+
+        /// maxStoredStates bounds the states kept for the reverse pass (0: keep every step's)
+        ForgeRepeatRegionEvaluator(ForgeKernel& kernel,
+                                   ForgeBuffer& buffer,
+                                   const ForgeRepeatRegion& region,
+                                   Size maxStoredStates = 0)
+        : evaluator_(kernel, buffer, inputsOf(region), outputsOf(region), gradientInputsOf(region)),
+          stateSize_(region.stateSize()), numStepInputs_(region.numStepInputs()),
+          numParameters_(region.numParameters()), maxStoredStates_(maxStoredStates) {
+            QL_REQUIRE(region.closed(), "repeat region not closed");
+            block_.assign((2 * stateSize_ + numStepInputs_ + numParameters_) * Width, 0.0);
+            rows_.resize(Width * (1 + stateSize_));
+            gradients_.resize((stateSize_ + numStepInputs_ + numParameters_) * Width);
+            finalState_.resize(stateSize_ * Width);
+        }
+
+        Size stateSize() const { return stateSize_; }
+        Size numStepInputs() const { return numStepInputs_; }
+        Size numParameters() const { return numParameters_; }
+        Size numSteps() const { return numSteps_; }
+        Size numScenarios() const { return count_; }
+        Size maxStoredStates() const { return maxStoredStates_; }
+        /// true if the last roll() kept fewer states than steps, so adjoint() recomputes
+        bool checkpointed() const { return numSlots_ < numSteps_; }
+        /// kernel executions since the last roll(), including it
+        Size numExecutions() const { return executions_; }
+
+        /// iterates the region numSteps times from the given states
+        /// initialStates is [scenario][state entry] and parameters, which may be
+        /// null without parameter inputs, [scenario][parameter]; stepInputs is
+        /// [step][step input] and shared by the scenarios.
+        void roll(const double* initialStates,
+                  const double* parameters,
+                  Size count,
+                  const double* stepInputs,
+                  Size numSteps) {
+            QL_REQUIRE(count > 0 && count <= Width,
+                       count << " scenarios for width " << Width);
+            QL_REQUIRE(numSteps > 0, "no steps to roll");
+            QL_REQUIRE(numParameters_ == 0 || parameters != nullptr, "parameter values not given");
+            QL_REQUIRE(numStepInputs_ == 0 || stepInputs != nullptr, "step input values not given");
+            count_ = count;
+            numSteps_ = numSteps;
+            executions_ = 0;
+            stepInputs_.assign(stepInputs, stepInputs + numSteps * numStepInputs_);
+            numSlots_ = maxStoredStates_ == 0 ? numSteps : std::min(maxStoredStates_, numSteps);
+            slots_.resize(numSlots_ * stateSize_ * Width);
+            interleave(initialStates, stateSize_, slot(0));
+            interleave(parameters, numParameters_, block_.data() + parameterRow() * Width);
+            std::fill(block_.begin() + seedRow() * Width, block_.end(), 0.0);
+
+            // with every state kept, slot k holds the state entering step k
+            const bool full = !checkpointed();
+            std::copy(slot(0), slot(0) + stateSize_ * Width, finalState_.begin());
+            for (Size k = 0; k < numSteps; ++k) {
+                if (full && k > 0)
+                    std::copy(finalState_.begin(), finalState_.end(), slot(k));
+                advance(k, finalState_.data());
+            }
+            adjointsReady_ = false;
+        }
+
+        /// writes the states after the last step to out[scenario * stateSize() + i]
+        void readStates(double* out) const {
+            QL_REQUIRE(numSteps_ > 0, "region not rolled");
+            deinterleave(finalState_.data(), stateSize_, out);
+        }
+
+        /// propagates the adjoints of the final states, [scenario][state entry], back through the steps
+        /// When roll() kept fewer states than steps, the missing ones are
+        /// recomputed from the stored checkpoints with the binomial schedule of
+        /// Griewank's Revolve, which needs the fewest step executions for the budget.
+        void adjoint(const double* finalStateAdjoints) {
+            QL_REQUIRE(numSteps_ > 0, "region not rolled");
+            double* seeds = block_.data() + seedRow() * Width;
+            interleave(finalStateAdjoints, stateSize_, seeds);
+            parameterAdjoints_.assign(numParameters_ * Width, 0.0);
+            stepInputAdjoints_.assign(numSteps_ * numStepInputs_ * Width, 0.0);
+
+            if (checkpointed()) {
+                reverse(0, numSteps_, 0);
+            } else {
+                for (Size k = numSteps_; k-- > 0;)
+                    adjointStep(k, slot(k));
+            }
+            stateAdjoints_.assign(seeds, seeds + stateSize_ * Width);
+            std::fill(seeds, seeds + stateSize_ * Width, 0.0);
+            adjointsReady_ = true;
+        }
+
+        /// adjoints of the initial states, out[scenario * stateSize() + i]
+        void readStateAdjoints(double* out) const {
+            QL_REQUIRE(adjointsReady_, "adjoint() not run");
+            deinterleave(stateAdjoints_.data(), stateSize_, out);
+        }
+
+        /// adjoints of the parameters, summed over steps, out[scenario * numParameters() + p]
+        void readParameterAdjoints(double* out) const {
+            QL_REQUIRE(adjointsReady_, "adjoint() not run");
+            deinterleave(parameterAdjoints_.data(), numParameters_, out);
+        }
+
+        /// adjoints of the step inputs, out[(scenario * numSteps() + step) * numStepInputs() + j]
+        void readStepInputAdjoints(double* out) const {
+            QL_REQUIRE(adjointsReady_, "adjoint() not run");
+            deinterleave(stepInputAdjoints_.data(), numSteps_ * numStepInputs_, out);
+        }
+
+      private:
+        Size parameterRow() const { return stateSize_ + numStepInputs_; }
+        Size seedRow() const { return stateSize_ + numStepInputs_ + numParameters_; }
+
+        double* slot(Size i) { return slots_.data() + i * stateSize_ * Width; }
+
+        // state and step inputs of iteration k next to the parameter and seed rows
+        void loadStep(Size k, const double* state) {
+            std::copy(state, state + stateSize_ * Width, block_.begin());
+            for (Size j = 0; j < numStepInputs_; ++j) {
+                auto row = block_.begin() + (stateSize_ + j) * Width;
+                std::fill(row, row + Width, stepInputs_[k * numStepInputs_ + j]);
+            }
+            evaluator_.loadInterleaved(block_.data(), count_);
+        }
+
+        // replaces the state entering step k by the state leaving it
+        void advance(Size k, double* state) {
+            loadStep(k, state);
+            evaluator_.execute();
+            ++executions_;
+            const Size numOutputs = 1 + stateSize_;
+            evaluator_.readOutputs(rows_.data(), numOutputs);
+            for (Size lane = 0; lane < count_; ++lane)
+                for (Size i = 0; i < stateSize_; ++i)
+                    state[i * Width + lane] = rows_[lane * numOutputs + 1 + i];
+        }
+
+        // pulls the seeds, the adjoint of the state leaving step k, back through the step
+        void adjointStep(Size k, const double* state) {
+            loadStep(k, state);
+            evaluator_.execute();
+            ++executions_;
+            evaluator_.readGradients(gradients_.data(), 1, Width);
+            const Size stepRow = stateSize_, parameterEnd = stateSize_ + numStepInputs_;
+            // the adjoint of the incoming state seeds the previous step
+            std::copy(gradients_.begin(), gradients_.begin() + stateSize_ * Width,
+                      block_.begin() + seedRow() * Width);
+            std::copy(gradients_.begin() + stepRow * Width, gradients_.begin() + parameterEnd * Width,
+                      stepInputAdjoints_.begin() + k * numStepInputs_ * Width);
+            for (Size g = 0; g < numParameters_ * Width; ++g)
+                parameterAdjoints_[g] += gradients_[parameterEnd * Width + g];
+        }
+
+        // reverses steps [first, first + length) from the state entering them in
+        // slot s, with the slots above s free
+        void reverse(Size first, Size length, Size s) {
+            if (length == 1) {
+                adjointStep(first, slot(s));
+                return;
+            }
+            const Size freeSlots = numSlots_ - 1 - s;
+            if (freeSlots == 0) {
+                scratch_.resize(stateSize_ * Width);
+                for (Size k = first + length; k-- > first;) {
+                    std::copy(slot(s), slot(s) + stateSize_ * Width, scratch_.begin());
+                    for (Size j = first; j < k; ++j)
+                        advance(j, scratch_.data());
+                    adjointStep(k, scratch_.data());
+                }
+                return;
+            }
+            // fewest repetitions r such that freeSlots checkpoints reverse length
+            // steps; the part after the split then fits freeSlots - 1 checkpoints
+            // with r repetitions and the part before it freeSlots with r - 1
+            Size r = 1;
+            while (binomialCapacity(freeSlots, r, length) < length)
+                ++r;
+            const Size right = binomialCapacity(freeSlots - 1, r, length);
+            const Size split = length > right ? length - right : 1;
+            std::copy(slot(s), slot(s) + stateSize_ * Width, slot(s + 1));
+            for (Size k = first; k < first + split; ++k)
+                advance(k, slot(s + 1));
+            reverse(first + split, length - split, s + 1);
+            reverse(first, split, s);
+        }
+
+        // steps reversible with m checkpoints and r repetitions, C(m + r, r), capped at cap
+        static Size binomialCapacity(Size m, Size r, Size cap) {
+            Size c = 1;
+            for (Size i = 1; i <= r && c < cap; ++i)
+                c = c * (m + i) / i;
+            return std::min(c, cap);
+        }
+
+        // rows[scenario * n + i] -> dst[i * Width + scenario]
+        void interleave(const double* rows, Size n, double* dst) const {
+            for (Size lane = 0; lane < count_; ++lane)
+                for (Size i = 0; i < n; ++i)
+                    dst[i * Width + lane] = rows[lane * n + i];
+        }
+
+        void deinterleave(const double* src, Size n, double* rows) const {
+            for (Size lane = 0; lane < count_; ++lane)
+                for (Size i = 0; i < n; ++i)
+                    rows[lane * n + i] = src[i * Width + lane];
+        }
+
+        static std::vector<forge::NodeId> inputsOf(const ForgeRepeatRegion& region) {
+            std::vector<forge::NodeId> ids(region.stateInputs());
+            ids.insert(ids.end(), region.stepInputs().begin(), region.stepInputs().end());
+            ids.insert(ids.end(), region.parameterInputs().begin(), region.parameterInputs().end());
+            ids.insert(ids.end(), region.seedInputs().begin(), region.seedInputs().end());
+            return ids;
+        }
+        static std::vector<forge::NodeId> outputsOf(const ForgeRepeatRegion& region) {
+            std::vector<forge::NodeId> ids(1, region.objective());
+            ids.insert(ids.end(), region.stateOutputs().begin(), region.stateOutputs().end());
+            return ids;
+        }
+        static std::vector<forge::NodeId> gradientInputsOf(const ForgeRepeatRegion& region) {
+            std::vector<forge::NodeId> ids(region.stateInputs());
+            ids.insert(ids.end(), region.stepInputs().begin(), region.stepInputs().end());
+            ids.insert(ids.end(), region.parameterInputs().begin(), region.parameterInputs().end());
+            return ids;
+        }
+
+        ForgeBatchEvaluator<Width> evaluator_;
+        Size stateSize_, numStepInputs_, numParameters_;
+        Size maxStoredStates_, numSlots_ = 0;
+        Size numSteps_ = 0, count_ = 0, executions_ = 0;
+        // block_: state, step input, parameter and seed rows, Width lanes each
+        std::vector<double> block_, rows_, gradients_, stepInputs_;
+        // slots_: states entering the stored steps; slot 0 is the initial state
+        std::vector<double> slots_, finalState_, scratch_;
+        std::vector<double> stateAdjoints_, parameterAdjoints_, stepInputAdjoints_;
+        bool adjointsReady_ = false;
+    };
+
+    /// final state and adjoints of one scenario rolled through a ForgeRepeatRegion
+    struct ForgeRepeatRegionResult {
+        std::vector<double> finalState;
+        /// adjoints for the final-state adjoint given; empty if none was given
+        std::vector<double> stateAdjoints, parameterAdjoints, stepInputAdjoints;
+    };
+
+    /// rolls one scenario with the batch width picked from the buffer
+    /// stepInputs is [step][step input]; with finalStateAdjoint non-empty, the
+    /// adjoints of the initial state, parameters and step inputs are returned too,
+    /// keeping at most maxStoredStates states if non-zero.
+    inline ForgeRepeatRegionResult forgeRollRepeatRegion(ForgeKernel& kernel,
+                                                         ForgeBuffer& buffer,
+                                                         const ForgeRepeatRegion& region,
+                                                         const std::vector<double>& initialState,
+                                                         const std::vector<double>& parameters,
+                                                         const std::vector<double>& stepInputs,
+                                                         Size numSteps,
+                                                         const std::vector<double>& finalStateAdjoint = {},
+                                                         Size maxStoredStates = 0) {
+        QL_REQUIRE(initialState.size() == region.stateSize(),
+                   initialState.size() << " initial values for " << region.stateSize() << " state entries");
+        QL_REQUIRE(parameters.size() == region.numParameters(),
+                   parameters.size() << " parameter values for " << region.numParameters() << " parameters");
+        QL_REQUIRE(stepInputs.size() == numSteps * region.numStepInputs(),
+                   stepInputs.size() << " step input values for " << numSteps << " steps of "
+                                     << region.numStepInputs() << " inputs");
+        QL_REQUIRE(finalStateAdjoint.empty() || finalStateAdjoint.size() == region.stateSize(),
+                   finalStateAdjoint.size() << " final adjoints for " << region.stateSize()
+                                            << " state entries");
+        return forgeWithBatchWidth(Size(buffer.getVectorWidth()), [&](auto w) {
+            ForgeRepeatRegionEvaluator<decltype(w)::value> evaluator(kernel, buffer, region,
+                                                                     maxStoredStates);
+            evaluator.roll(initialState.data(), parameters.data(), 1, stepInputs.data(), numSteps);
+            ForgeRepeatRegionResult result;
+            result.finalState.resize(region.stateSize());
+            evaluator.readStates(result.finalState.data());
+            if (!finalStateAdjoint.empty()) {
+                evaluator.adjoint(finalStateAdjoint.data());
+                result.stateAdjoints.resize(region.stateSize());
+                result.parameterAdjoints.resize(region.numParameters());
+                result.stepInputAdjoints.resize(stepInputs.size());
+                evaluator.readStateAdjoints(result.stateAdjoints.data());
+                evaluator.readParameterAdjoints(result.parameterAdjoints.data());
+                evaluator.readStepInputAdjoints(result.stepInputAdjoints.data());
+            }
+            return result;
+        });
+    }
+
+}
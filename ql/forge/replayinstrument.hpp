@@ -0,0 +1,256 @@
+/*******************************************************************************
+
+   Record-once, replay-many wrapper for QuantLib instruments.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Inputs flow through SimpleQuote and Handle<Quote> into the graph (see
+    testSimpleQuoteConnection), but a pricing service still has to drive a
+    GraphRecorder by hand, and every SimpleQuote::setValue() re-runs the
+    whole engine through the Observer/LazyObject cascade.
+
+    ForgeQuote is a quote for the inputs of a compiled instrument and
+    ForgeInstrument an Instrument decorating the one to be priced:
+
+        auto spot = ext::make_shared<ForgeQuote>(100.0);
+        auto vol = ext::make_shared<ForgeQuote>(0.2);
+        ... build the option, engine and term structures on Handle<Quote>(spot),
+            Handle<Quote>(vol) as usual ...
+        ForgeInstrument forged(option, {spot, vol});
+        forged.NPV();         // records option->NPV() and compiles it
+        spot->setValue(101.0);
+        forged.NPV();         // writes 101 into the buffer and replays the kernel
+        forged.sensitivities(); // d NPV / d spot, d NPV / d vol
+
+    The first NPV() marks the quote values as inputs, lets the quotes
+    notify their observers once so that the engine re-runs on them, and
+    compiles the recorded NPV; once that has succeeded, the ForgeInstrument
+    registers with its quotes as an observer.  From then on setValue()
+    still notifies the observers of the quote, so that other instruments
+    built on it reprice as usual, but a notification reaching a
+    ForgeInstrument while one of its own quotes is notifying only makes its
+    next NPV() replay the kernel.  The curves, engines and the decorated
+    instrument are marked as not calculated and are not recalculated by
+    the replays; the decorated instrument is set to always forward
+    notifications, so that it keeps reporting other changes.
+
+    Any other notification of the decorated instrument, e.g. a change of the
+    evaluation date or a relinked handle, makes the next NPV() record and
+    compile again.  A lazy object between the quotes and the decorated
+    instrument, e.g. a bootstrapped curve, stops forwarding notifications
+    after the first quote change until it is recalculated, as in any
+    QuantLib graph; call update() on the ForgeInstrument after changing
+    such an object otherwise than through the quotes.  As for every
+    recorded kernel, branches taken by the engine are fixed at recording
+    time, so quotes should stay in the region where the engine takes the
+    same branches.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/instrument.hpp>
+#include <ql/quote.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/kernelcache.hpp>
+#include <compiler/compiler_config.hpp>
+#include <graph/graph_recorder.hpp>
+#include <graph/handles.hpp>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace QuantLib {
+
+    class ForgeInstrument;
+
+    /// market quote whose changes are replayed through compiled instruments
+    class ForgeQuote : public Quote {
+      public:
+        explicit ForgeQuote(double value) : value_(value) {}
+
+        Real value() const override { return recording_ ? recorded_ : Real(value_); }
+        bool isValid() const override { return true; }
+
+        /// sets the value; the instruments compiled on it replay instead of recording again
+        void setValue(double value);
+
+        /// the value as a plain double
+        double rawValue() const { return value_; }
+
+      private:
+        friend class ForgeInstrument;
+
+        forge::NodeId beginRecording() {
+            recorded_ = value_;
+            recorded_.markForgeInputAndDiff();
+            recording_ = true;
+            notifyObservers();
+            return recorded_.forgeNodeId();
+        }
+
+        void endRecording() {
+            recording_ = false;
+            recorded_ = value_;
+        }
+
+        double value_;
+        Real recorded_;
+        bool recording_ = false, notifying_ = false;
+    };
+
+    /// Instrument decorator pricing through a kernel recorded from the decorated instrument
+    class ForgeInstrument : public Instrument {
+      public:
+        ForgeInstrument(ext::shared_ptr<Instrument> instrument,
+                        std::vector<ext::shared_ptr<ForgeQuote>> quotes,
+                        forge::CompilerConfig config = forge::CompilerConfig())
+        : instrument_(std::move(instrument)), quotes_(std::move(quotes)), config_(config) {
+            QL_REQUIRE(instrument_ != nullptr, "no instrument given to ForgeInstrument");
+            QL_REQUIRE(!quotes_.empty(), "no quotes given to ForgeInstrument");
+            // the replays leave it not calculated; it must still forward other changes
+            instrument_->alwaysForwardNotifications();
+            registerWith(instrument_);
+        }
+
+        ForgeInstrument(const ForgeInstrument&) = delete;
+        ForgeInstrument& operator=(const ForgeInstrument&) = delete;
+
+        bool isExpired() const override { return instrument_->isExpired(); }
+
+        /// the decorated instrument has changed otherwise than through the quotes
+        void update() override {
+            if (recording_)
+                return;
+            if (std::none_of(quotes_.begin(), quotes_.end(),
+                             [](const ext::shared_ptr<ForgeQuote>& q) { return q->notifying_; }))
+                stale_ = true;
+            Instrument::update();
+        }
+
+        /// d NPV / d quote, in the order of the quotes given
+        const std::vector<double>& sensitivities() const {
+            calculate();
+            return sensitivities_;
+        }
+
+        const ext::shared_ptr<Instrument>& instrument() const { return instrument_; }
+        const std::vector<ext::shared_ptr<ForgeQuote>>& quotes() const { return quotes_; }
+        /// true once a recording has succeeded and the quotes notify this instrument
+        bool bound() const { return bound_; }
+        /// number of times the decorated instrument has been recorded and compiled
+        Size recordings() const { return recordings_; }
+        /// number of kernel executions, including the one after each recording
+        Size replays() const { return replays_; }
+
+      protected:
+        void performCalculations() const override {
+            if (kernel_ == nullptr || stale_)
+                record();
+            replay();
+        }
+
+      private:
+        void endRecording() const {
+            for (const auto& q : quotes_)
+                q->endRecording();
+            recording_ = false;
+        }
+
+        void record() const {
+            recording_ = true;
+            forge::GraphRecorder recorder;
+            recorder.start();
+            try {
+                inputs_.clear();
+                for (const auto& q : quotes_)
+                    inputs_.push_back(q->beginRecording());
+                Real npv = instrument_->NPV();
+                npv.markForgeOutput();
+                output_ = npv.forgeNodeId();
+            } catch (...) {
+                recorder.stop();
+                endRecording();
+                throw;
+            }
+            recorder.stop();
+            endRecording();
+
+            forge::ForgeEngine compiler(config_);
+            kernel_ = compiler.compile(recorder.graph());
+            QL_REQUIRE(kernel_ != nullptr, "Forge kernel compilation failed");
+            buffer_ = forge::NodeValueBufferFactory::create(recorder.graph(), *kernel_);
+            gradientIndices_.clear();
+            for (auto id : inputs_)
+                gradientIndices_.push_back(buffer_->getBufferIndex(id));
+            const Size width = buffer_->getVectorWidth();
+            lanes_.assign(width, 0.0);
+            gradients_.assign(inputs_.size() * width, 0.0);
+            sensitivities_.assign(inputs_.size(), 0.0);
+            stale_ = false;
+            ++recordings_;
+
+            // the quotes notify this instrument directly, also where a lazy
+            // object in between would not forward the change
+            if (!bound_) {
+                auto self = const_cast<ForgeInstrument*>(this);
+                for (const auto& q : quotes_)
+                    self->registerWith(q);
+                bound_ = true;
+            }
+        }
+
+        void replay() const {
+            for (Size i = 0; i < quotes_.size(); ++i) {
+                std::fill(lanes_.begin(), lanes_.end(), quotes_[i]->rawValue());
+                buffer_->setLanes(inputs_[i], lanes_.data());
+            }
+            buffer_->clearGradients();
+            kernel_->execute(*buffer_);
+            buffer_->getLanes(output_, lanes_.data());
+            NPV_ = lanes_[0];
+            errorEstimate_ = Null<Real>();
+            buffer_->getGradientLanes(gradientIndices_, gradients_.data());
+            const Size width = lanes_.size();
+            for (Size i = 0; i < sensitivities_.size(); ++i)
+                sensitivities_[i] = gradients_[i * width];
+            ++replays_;
+        }
+
+        ext::shared_ptr<Instrument> instrument_;
+        std::vector<ext::shared_ptr<ForgeQuote>> quotes_;
+        forge::CompilerConfig config_;
+        mutable ForgeKernelPtr kernel_;
+        mutable ForgeBufferPtr buffer_;
+        mutable std::vector<forge::NodeId> inputs_;
+        mutable forge::NodeId output_ = 0;
+        mutable std::vector<size_t> gradientIndices_;
+        mutable std::vector<double> lanes_, gradients_, sensitivities_;
+        mutable bool stale_ = true, recording_ = false, bound_ = false;
+        mutable Size recordings_ = 0, replays_ = 0;
+    };
+
+    inline void ForgeQuote::setValue(double value) {
+        if (value == value_)
+            return;
+        value_ = value;
+        // the compiled instruments notified, directly or through the graph,
+        // recognize their own quote
+        notifying_ = true;
+        try {
+            notifyObservers();
+        } catch (...) {
+            notifying_ = false;
+            throw;
+        }
+        notifying_ = false;
+    }
+
+}
@@ -0,0 +1,179 @@
+/*******************************************************************************
+
+   Contiguous, lane-interleaved scenario storage for Forge kernels.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Market scenarios for exposure simulation form a cube indexed by
+    (time step, path, risk factor).  ForgeScenarioCube keeps the whole cube
+    in a single 64-byte aligned allocation, laid out as
+
+        [time step][batch][risk factor][lane]
+
+    where a batch holds laneWidth consecutive paths.  A batch is therefore
+    exactly the block a packed kernel wants for one execute() call, and can
+    be handed to ForgeBatchEvaluator::loadInterleaved without transposing.
+    Single paths are available as strided views for scalar pricing and
+    bump-and-revalue loops.
+
+    Lanes past the last path of the final batch are padding; padTails()
+    fills them with the last valid path so packed kernels never see
+    uninitialised data.
+
+    The storage type is a parameter: ForgeScenarioCube holds doubles, and
+    ForgeFloatScenarioCube the float32 scenarios of screening runs, which
+    halve the memory and bandwidth of a cube and are widened when loaded
+    into a kernel (see mixedprecision.hpp).
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace QuantLib {
+
+    /// read-only view of equally spaced values
+    template <class T>
+    class ForgeBasicStridedView {
+      public:
+        ForgeBasicStridedView(const T* data, Size size, Size stride)
+        : data_(data), size_(size), stride_(stride) {}
+
+        T operator[](Size i) const { return data_[i * stride_]; }
+        Size size() const { return size_; }
+        Size stride() const { return stride_; }
+        const T* data() const { return data_; }
+
+      private:
+        const T* data_;
+        Size size_, stride_;
+    };
+
+    using ForgeStridedView = ForgeBasicStridedView<double>;
+
+    /// (time step, path, risk factor) scenario cube in one aligned buffer
+    template <class T>
+    class ForgeBasicScenarioCube {
+        static_assert(std::is_floating_point<T>::value, "scenario cubes store floating-point values");
+
+      public:
+        using value_type = T;
+        static constexpr Size alignment = 64;
+
+        ForgeBasicScenarioCube() = default;
+        ForgeBasicScenarioCube(Size timeSteps, Size paths, Size factors, Size laneWidth)
+        : timeSteps_(timeSteps), paths_(paths), factors_(factors), laneWidth_(laneWidth) {
+            QL_REQUIRE(laneWidth_ > 0, "lane width must be positive");
+            batches_ = (paths_ + laneWidth_ - 1) / laneWidth_;
+            size_ = timeSteps_ * batches_ * factors_ * laneWidth_;
+            if (size_ > 0) {
+                Size bytes = (size_ * sizeof(T) + alignment - 1) / alignment * alignment;
+#ifdef _WIN32
+                void* p = _aligned_malloc(bytes, alignment);
+#else
+                void* p = std::aligned_alloc(alignment, bytes);
+#endif
+                QL_REQUIRE(p != nullptr, "cannot allocate " << bytes << " bytes for scenario cube");
+                std::memset(p, 0, bytes);
+                data_.reset(static_cast<T*>(p));
+            }
+        }
+
+        ForgeBasicScenarioCube(ForgeBasicScenarioCube&&) = default;
+        ForgeBasicScenarioCube& operator=(ForgeBasicScenarioCube&&) = default;
+        ForgeBasicScenarioCube(const ForgeBasicScenarioCube&) = delete;
+        ForgeBasicScenarioCube& operator=(const ForgeBasicScenarioCube&) = delete;
+
+        Size timeSteps() const { return timeSteps_; }
+        Size paths() const { return paths_; }
+        Size factors() const { return factors_; }
+        Size laneWidth() const { return laneWidth_; }
+        /// batches per time step
+        Size batches() const { return batches_; }
+        /// number of valid paths in batch b
+        Size batchSize(Size b) const { return std::min(laneWidth_, paths_ - b * laneWidth_); }
+
+        T& operator()(Size t, Size p, Size f) { return data_[index(t, p, f)]; }
+        T operator()(Size t, Size p, Size f) const { return data_[index(t, p, f)]; }
+
+        /// risk factors of one path
+        ForgeBasicStridedView<T> path(Size t, Size p) const {
+            return ForgeBasicStridedView<T>(data_.get() + index(t, p, 0), factors_, laneWidth_);
+        }
+        /// one risk factor across the paths of a batch
+        ForgeBasicStridedView<T> lanes(Size t, Size b, Size f) const {
+            return ForgeBasicStridedView<T>(batch(t, b) + f * laneWidth_, batchSize(b), 1);
+        }
+
+        /// [risk factor][lane] block of batch b at time step t
+        const T* batch(Size t, Size b) const { return data_.get() + offset(t, b); }
+        T* batch(Size t, Size b) { return data_.get() + offset(t, b); }
+
+        /// fills the padding lanes of every final batch with the last valid path
+        void padTails() {
+            if (batches_ == 0)
+                return;
+            Size b = batches_ - 1;
+            Size valid = batchSize(b);
+            for (Size t = 0; t < timeSteps_; ++t) {
+                T* block = batch(t, b);
+                for (Size f = 0; f < factors_; ++f) {
+                    T* row = block + f * laneWidth_;
+                    for (Size lane = valid; lane < laneWidth_; ++lane)
+                        row[lane] = row[valid - 1];
+                }
+            }
+        }
+
+        const T* data() const { return data_.get(); }
+        T* data() { return data_.get(); }
+        /// number of values stored, including padding lanes
+        Size size() const { return size_; }
+
+      private:
+        struct AlignedDeleter {
+            void operator()(T* p) const {
+#ifdef _WIN32
+                _aligned_free(p);
+#else
+                std::free(p);
+#endif
+            }
+        };
+
+        Size offset(Size t, Size b) const {
+            QL_REQUIRE(t < timeSteps_ && b < batches_,
+                       "scenario batch (" << t << ", " << b << ") out of range");
+            return (t * batches_ + b) * factors_ * laneWidth_;
+        }
+        Size index(Size t, Size p, Size f) const {
+            QL_REQUIRE(p < paths_ && f < factors_,
+                       "scenario (" << t << ", " << p << ", " << f << ") out of range");
+            return offset(t, p / laneWidth_) + f * laneWidth_ + p % laneWidth_;
+        }
+
+        Size timeSteps_ = 0, paths_ = 0, factors_ = 0, laneWidth_ = 1, batches_ = 0, size_ = 0;
+        std::unique_ptr<T[], AlignedDeleter> data_;
+    };
+
+    using ForgeScenarioCube = ForgeBasicScenarioCube<double>;
+    using ForgeFloatScenarioCube = ForgeBasicScenarioCube<float>;
+
+}
@@ -0,0 +1,434 @@
+/*******************************************************************************
+
+   Memory-mapped binary scenario files with double-buffered batch streaming.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    A scenario generator producing 100 risk factors x 10k paths x 100
+    dates writes 800MB of doubles; holding them in memory, or converting
+    them to per-path vectors, is what the pricing should not have to do.
+    The scenario file stores the cube exactly as ForgeScenarioCube lays it
+    out in memory,
+
+        header (4096 bytes, see ForgeScenarioFileHeader)
+        [time step][batch][risk factor][lane] float64 in the writer's byte order
+
+    so every batch is already the block ForgeBatchEvaluator::loadInterleaved
+    wants, and tail lanes are padded with the last valid path.
+    ForgeScenarioFileWriter writes paths in (time step, path) order as a
+    generator produces them, one batch buffered at a time;
+    ForgeMappedScenarioFile maps a file read-only and hands out batches and
+    path views straight from the mapping.
+
+    ForgeScenarioStream walks the batches of a mapped file in file order
+    through two staging chunks: while the caller evaluates the batches of
+    one chunk, a background task copies the next chunk out of the mapping,
+    which takes the page faults and disk reads off the evaluation thread.
+    Copied ranges are dropped from the mapping, so resident memory stays at
+    two chunks whatever the size of the file:
+
+        ForgeMappedScenarioFile file("esg.qlfs");
+        ForgeScenarioStream stream(file, 256);
+        ForgeScenarioStream::Batch batch;
+        while (stream.next(batch)) {
+            evaluator.loadInterleaved(batch.data, batch.count);
+            evaluator.execute();
+            ...
+        }
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/scenariocube.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace QuantLib {
+
+    /// fixed-size header at the start of a scenario file
+    struct ForgeScenarioFileHeader {
+        static constexpr std::uint32_t currentVersion = 1;
+        static constexpr std::uint32_t byteOrderTag = 0x01020304;
+        /// offset of the data, a multiple of the page size on all supported systems
+        static constexpr std::uint64_t dataOffset = 4096;
+
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byteOrder;
+        std::uint64_t timeSteps;
+        std::uint64_t paths;
+        std::uint64_t factors;
+        std::uint64_t laneWidth;
+        std::uint64_t offset;
+        std::uint64_t reserved[1];
+
+        static const char* expectedMagic() { return "QLFGSCN"; }
+
+        Size batches() const { return Size((paths + laneWidth - 1) / laneWidth); }
+        /// doubles in the data section
+        Size size() const { return Size(timeSteps) * batches() * Size(factors) * Size(laneWidth); }
+    };
+
+    static_assert(sizeof(ForgeScenarioFileHeader) == 64, "scenario file header must be 64 bytes");
+    static_assert(std::is_trivially_copyable<ForgeScenarioFileHeader>::value,
+                  "scenario file header must be trivially copyable");
+
+    inline ForgeScenarioFileHeader
+    forgeScenarioFileHeader(Size timeSteps, Size paths, Size factors, Size laneWidth) {
+        QL_REQUIRE(laneWidth > 0, "lane width must be positive");
+        ForgeScenarioFileHeader header = {};
+        std::memcpy(header.magic, ForgeScenarioFileHeader::expectedMagic(), 8);
+        header.version = ForgeScenarioFileHeader::currentVersion;
+        header.byteOrder = ForgeScenarioFileHeader::byteOrderTag;
+        header.timeSteps = timeSteps;
+        header.paths = paths;
+        header.factors = factors;
+        header.laneWidth = laneWidth;
+        header.offset = ForgeScenarioFileHeader::dataOffset;
+        return header;
+    }
+
+    /// writes a scenario file path by path, in (time step, path) order
+    class ForgeScenarioFileWriter {
+      public:
+        ForgeScenarioFileWriter(const std::string& filename,
+                                Size timeSteps,
+                                Size paths,
+                                Size factors,
+                                Size laneWidth)
+        : filename_(filename), header_(forgeScenarioFileHeader(timeSteps, paths, factors, laneWidth)),
+          block_(factors * laneWidth) {
+            QL_REQUIRE(paths > 0 && factors > 0, "empty scenario file " << filename);
+            out_.open(filename, std::ios::binary | std::ios::trunc);
+            QL_REQUIRE(out_, "cannot create scenario file " << filename);
+            std::vector<char> head(ForgeScenarioFileHeader::dataOffset, 0);
+            std::memcpy(head.data(), &header_, sizeof(header_));
+            out_.write(head.data(), std::streamsize(head.size()));
+        }
+
+        ~ForgeScenarioFileWriter() {
+            if (out_.is_open())
+                out_.close();
+        }
+
+        ForgeScenarioFileWriter(const ForgeScenarioFileWriter&) = delete;
+        ForgeScenarioFileWriter& operator=(const ForgeScenarioFileWriter&) = delete;
+
+        /// appends the risk factors of the next path
+        void writePath(const double* factors) {
+            QL_REQUIRE(timeStep_ < header_.timeSteps, "scenario file " << filename_ << " is full");
+            const Size width = Size(header_.laneWidth), n = Size(header_.factors);
+            const Size lane = path_ % width;
+            for (Size f = 0; f < n; ++f)
+                block_[f * width + lane] = factors[f];
+            if (++path_ == header_.paths) {
+                // pad the final batch with the last valid path
+                for (Size f = 0; f < n; ++f)
+                    std::fill(block_.begin() + f * width + lane + 1,
+                              block_.begin() + (f + 1) * width, factors[f]);
+                flush();
+                path_ = 0;
+                ++timeStep_;
+            } else if (lane + 1 == width) {
+                flush();
+            }
+        }
+
+        /// checks that every path was written and closes the file
+        void close() {
+            QL_REQUIRE(timeStep_ == header_.timeSteps,
+                       "scenario file " << filename_ << " has " << timeStep_ << " of "
+                                        << header_.timeSteps << " time steps");
+            out_.close();
+            QL_REQUIRE(!out_.fail(), "cannot write scenario file " << filename_);
+        }
+
+        const ForgeScenarioFileHeader& header() const { return header_; }
+
+      private:
+        void flush() {
+            out_.write(reinterpret_cast<const char*>(block_.data()),
+                       std::streamsize(block_.size() * sizeof(double)));
+            QL_REQUIRE(out_, "cannot write scenario file " << filename_);
+        }
+
+        std::string filename_;
+        ForgeScenarioFileHeader header_;
+        std::ofstream out_;
+        std::vector<double> block_;
+        Size timeStep_ = 0, path_ = 0;
+    };
+
+    /// writes a whole cube; tails are written as stored, so pad them first
+    inline void forgeWriteScenarioFile(const std::string& filename, const ForgeScenarioCube& cube) {
+        ForgeScenarioFileHeader header =
+            forgeScenarioFileHeader(cube.timeSteps(), cube.paths(), cube.factors(), cube.laneWidth());
+        std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+        QL_REQUIRE(out, "cannot create scenario file " << filename);
+        std::vector<char> head(ForgeScenarioFileHeader::dataOffset, 0);
+        std::memcpy(head.data(), &header, sizeof(header));
+        out.write(head.data(), std::streamsize(head.size()));
+        out.write(reinterpret_cast<const char*>(cube.data()),
+                  std::streamsize(cube.size() * sizeof(double)));
+        out.close();
+        QL_REQUIRE(!out.fail(), "cannot write scenario file " << filename);
+    }
+
+    /// read-only mapping of a scenario file
+    class ForgeMappedScenarioFile {
+      public:
+        explicit ForgeMappedScenarioFile(const std::string& filename) : filename_(filename) {
+            std::uint64_t fileSize = map();
+            QL_REQUIRE(fileSize >= sizeof(ForgeScenarioFileHeader),
+                       filename << " is too short for a scenario file");
+            std::memcpy(&header_, base_, sizeof(header_));
+            QL_REQUIRE(std::memcmp(header_.magic, ForgeScenarioFileHeader::expectedMagic(), 8) == 0,
+                       filename << " is not a scenario file");
+            QL_REQUIRE(header_.version == ForgeScenarioFileHeader::currentVersion,
+                       filename << " has unsupported scenario file version " << header_.version);
+            QL_REQUIRE(header_.byteOrder == ForgeScenarioFileHeader::byteOrderTag,
+                       filename << " was written with another byte order");
+            QL_REQUIRE(header_.laneWidth > 0 && header_.offset % sizeof(double) == 0,
+                       filename << " has a corrupt header");
+            QL_REQUIRE(fileSize >= header_.offset + header_.size() * sizeof(double),
+                       filename << " is truncated: " << fileSize << " bytes, expected "
+                                << header_.offset + header_.size() * sizeof(double));
+            data_ = reinterpret_cast<const double*>(base_ + header_.offset);
+        }
+
+        ~ForgeMappedScenarioFile() { unmap(); }
+
+        ForgeMappedScenarioFile(const ForgeMappedScenarioFile&) = delete;
+        ForgeMappedScenarioFile& operator=(const ForgeMappedScenarioFile&) = delete;
+
+        const ForgeScenarioFileHeader& header() const { return header_; }
+        Size timeSteps() const { return Size(header_.timeSteps); }
+        Size paths() const { return Size(header_.paths); }
+        Size factors() const { return Size(header_.factors); }
+        Size laneWidth() const { return Size(header_.laneWidth); }
+        Size batches() const { return header_.batches(); }
+        Size batchSize(Size b) const { return std::min(laneWidth(), paths() - b * laneWidth()); }
+        /// doubles in one batch block
+        Size batchStride() const { return factors() * laneWidth(); }
+
+        /// [risk factor][lane] block of batch b at time step t, inside the mapping
+        const double* batch(Size t, Size b) const {
+            QL_REQUIRE(t < timeSteps() && b < batches(),
+                       "scenario batch (" << t << ", " << b << ") out of range");
+            return data_ + (t * batches() + b) * batchStride();
+        }
+        /// risk factors of one path
+        ForgeStridedView path(Size t, Size p) const {
+            QL_REQUIRE(p < paths(), "scenario path " << p << " out of range");
+            return ForgeStridedView(batch(t, p / laneWidth()) + p % laneWidth(), factors(),
+                                    laneWidth());
+        }
+        double operator()(Size t, Size p, Size f) const { return path(t, p)[f]; }
+
+        /// asks the system to read the batches [first, first + count) in file order ahead
+        void willNeed(Size first, Size count) const { advise(first, count, true); }
+        /// lets the system drop the pages of the batches [first, first + count) in file order
+        void release(Size first, Size count) const { advise(first, count, false); }
+
+      private:
+        std::uint64_t map() {
+#ifdef _WIN32
+            file_ = CreateFileA(filename_.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            QL_REQUIRE(file_ != INVALID_HANDLE_VALUE, "cannot open scenario file " << filename_);
+            LARGE_INTEGER size;
+            GetFileSizeEx(file_, &size);
+            size_ = std::uint64_t(size.QuadPart);
+            mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping_ != nullptr)
+                base_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+            if (base_ == nullptr) {
+                unmap();
+                QL_FAIL("cannot map scenario file " << filename_);
+            }
+#else
+            fd_ = ::open(filename_.c_str(), O_RDONLY);
+            QL_REQUIRE(fd_ >= 0, "cannot open scenario file " << filename_);
+            struct stat st;
+            if (::fstat(fd_, &st) != 0 || st.st_size == 0) {
+                unmap();
+                QL_FAIL("cannot read scenario file " << filename_);
+            }
+            size_ = std::uint64_t(st.st_size);
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+            if (p == MAP_FAILED) {
+                unmap();
+                QL_FAIL("cannot map scenario file " << filename_);
+            }
+            base_ = static_cast<const char*>(p);
+#endif
+            return size_;
+        }
+
+        void unmap() {
+#ifdef _WIN32
+            if (base_ != nullptr)
+                UnmapViewOfFile(base_);
+            if (mapping_ != nullptr)
+                CloseHandle(mapping_);
+            if (file_ != INVALID_HANDLE_VALUE)
+                CloseHandle(file_);
+            mapping_ = nullptr;
+            file_ = INVALID_HANDLE_VALUE;
+#else
+            if (base_ != nullptr)
+                ::munmap(const_cast<char*>(base_), size_);
+            if (fd_ >= 0)
+                ::close(fd_);
+            fd_ = -1;
+#endif
+            base_ = nullptr;
+        }
+
+        void advise(Size first, Size count, bool willNeed) const {
+#ifndef _WIN32
+            const Size total = timeSteps() * batches();
+            if (first >= total || count == 0)
+                return;
+            count = std::min(count, total - first);
+            const std::uintptr_t page = std::uintptr_t(::sysconf(_SC_PAGESIZE));
+            std::uintptr_t begin = std::uintptr_t(data_ + first * batchStride());
+            std::uintptr_t end = std::uintptr_t(data_ + (first + count) * batchStride());
+            // whole pages only: read-ahead may round out, dropping must round in
+            if (willNeed) {
+                begin = begin / page * page;
+                end = (end + page - 1) / page * page;
+            } else {
+                begin = (begin + page - 1) / page * page;
+                end = end / page * page;
+            }
+            if (begin < end)
+                ::madvise(reinterpret_cast<void*>(begin), end - begin,
+                          willNeed ? MADV_WILLNEED : MADV_DONTNEED);
+#else
+            (void)first;
+            (void)count;
+            (void)willNeed;
+#endif
+        }
+
+        std::string filename_;
+        ForgeScenarioFileHeader header_ = {};
+        const char* base_ = nullptr;
+        const double* data_ = nullptr;
+        std::uint64_t size_ = 0;
+#ifdef _WIN32
+        HANDLE file_ = INVALID_HANDLE_VALUE;
+        HANDLE mapping_ = nullptr;
+#else
+        int fd_ = -1;
+#endif
+    };
+
+    /// batches of a mapped scenario file in file order, staged one chunk ahead
+    class ForgeScenarioStream {
+      public:
+        /// one lane-interleaved block, valid until the next call to next()
+        struct Batch {
+            Size timeStep = 0, index = 0, count = 0;
+            const double* data = nullptr;
+        };
+
+        /// batchesPerChunk batches are staged per buffer; the last chunk may be shorter
+        ForgeScenarioStream(const ForgeMappedScenarioFile& file,
+                            Size batchesPerChunk = 64,
+                            bool releaseConsumed = true)
+        : file_(file), chunk_(std::max<Size>(batchesPerChunk, 1)),
+          total_(file.timeSteps() * file.batches()), releaseConsumed_(releaseConsumed) {
+            for (auto& b : buffers_)
+                b.resize(chunk_ * file_.batchStride());
+            if (total_ > 0)
+                pending_ = stage(0, 1);
+        }
+
+        ~ForgeScenarioStream() {
+            if (pending_.valid())
+                pending_.wait();
+        }
+
+        ForgeScenarioStream(const ForgeScenarioStream&) = delete;
+        ForgeScenarioStream& operator=(const ForgeScenarioStream&) = delete;
+
+        /// the next batch, or false after the last one
+        bool next(Batch& batch) {
+            if (position_ == total_)
+                return false;
+            if (position_ == chunkEnd_) {
+                // the staged chunk becomes current, the other buffer is refilled in the background
+                Size first = pending_.get();
+                current_ = 1 - current_;
+                chunkBegin_ = first;
+                chunkEnd_ = std::min(first + chunk_, total_);
+                if (chunkEnd_ < total_)
+                    pending_ = stage(chunkEnd_, 1 - current_);
+            }
+            const Size batches = file_.batches();
+            batch.timeStep = position_ / batches;
+            batch.index = position_ % batches;
+            batch.count = file_.batchSize(batch.index);
+            batch.data = buffers_[current_].data() + (position_ - chunkBegin_) * file_.batchStride();
+            ++position_;
+            return true;
+        }
+
+        /// batches handed out so far
+        Size position() const { return position_; }
+        Size size() const { return total_; }
+
+      private:
+        std::future<Size> stage(Size first, Size buffer) {
+            const Size count = std::min(chunk_, total_ - first);
+            file_.willNeed(first, count);
+            double* target = buffers_[buffer].data();
+            return std::async(std::launch::async, [this, first, count, target] {
+                const Size batches = file_.batches();
+                const double* src = file_.batch(first / batches, first % batches);
+                std::memcpy(target, src, count * file_.batchStride() * sizeof(double));
+                if (releaseConsumed_)
+                    file_.release(first, count);
+                return first;
+            });
+        }
+
+        const ForgeMappedScenarioFile& file_;
+        Size chunk_, total_;
+        bool releaseConsumed_;
+        std::vector<double> buffers_[2];
+        std::future<Size> pending_;
+        // the first chunk is staged into buffer 1 so that the swap in next() selects it
+        Size current_ = 0, position_ = 0, chunkBegin_ = 0, chunkEnd_ = 0;
+    };
+
+}
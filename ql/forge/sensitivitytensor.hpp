@@ -0,0 +1,200 @@
+/*******************************************************************************
+
+   Contiguous trade x date x path x factor sensitivity storage.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Pathwise sensitivities of an exposure simulation, one block of
+    doubles instead of nested vectors. The layout is chosen up front:
+
+        PathMajor    [trade][date][path][factor], a gradient row per path
+        FactorMajor  [trade][date][factor][path], a path vector per factor
+        Aggregated   [trade][date][factor], the sum over paths only
+
+    CVA sensitivities only need the path average, so the aggregated
+    layout keeps trades x dates x factors sums; the gradient lanes are
+    summed in the evaluator, with no per-path rows to scatter into,
+
+        ForgeSensitivityTensor deltas(trades, dates, paths, factors,
+                                      ForgeSensitivityLayout::Aggregated);
+        evaluator.loadInterleaved(cube.batch(t, b), count);
+        evaluator.execute();
+        deltas.add(trade, t, b * width, evaluator);
+        double delta = deltas.mean(trade, t, factor);
+
+    add() and addPath() count the paths of each (trade, date) so that
+    mean() is the average over the paths actually added; values written
+    through operator() are not counted.  addPathCells() counts a path and
+    hands out its cells, for writers such as ForgeBumpBatch that produce
+    the factors one by one.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/batchevaluator.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace QuantLib {
+
+    enum class ForgeSensitivityLayout { PathMajor, FactorMajor, Aggregated };
+
+    class ForgeSensitivityTensor {
+      public:
+        ForgeSensitivityTensor() = default;
+        ForgeSensitivityTensor(Size trades,
+                               Size timeSteps,
+                               Size paths,
+                               Size factors,
+                               ForgeSensitivityLayout layout = ForgeSensitivityLayout::PathMajor)
+        : trades_(trades), timeSteps_(timeSteps), paths_(paths), factors_(factors), layout_(layout),
+          counts_(trades * timeSteps, 0) {
+            QL_REQUIRE(trades > 0 && timeSteps > 0 && paths > 0 && factors > 0,
+                       "empty sensitivity tensor");
+            data_.assign(trades * timeSteps * factors * (storesPaths() ? paths : 1), 0.0);
+        }
+
+        Size trades() const { return trades_; }
+        Size timeSteps() const { return timeSteps_; }
+        Size paths() const { return paths_; }
+        Size factors() const { return factors_; }
+        ForgeSensitivityLayout layout() const { return layout_; }
+        bool storesPaths() const { return layout_ != ForgeSensitivityLayout::Aggregated; }
+
+        /// pathwise sensitivity; not available in the aggregated layout
+        double& operator()(Size trade, Size t, Size path, Size factor) {
+            return data_[index(trade, t, path, factor)];
+        }
+        double operator()(Size trade, Size t, Size path, Size factor) const {
+            return data_[index(trade, t, path, factor)];
+        }
+
+        /// where the factors of one path go: first[f * stride], added to if accumulate is set
+        struct PathCells {
+            double* first;
+            Size stride;
+            bool accumulate;
+        };
+
+        /// counts one path like addPath() and returns its cells, for writers that fill them in place
+        PathCells addPathCells(Size trade, Size t, Size path) {
+            QL_REQUIRE(path < paths_, "path " << path << " out of range");
+            double* block = cellBlock(trade, t);
+            ++counts_[trade * timeSteps_ + t];
+            switch (layout_) {
+              case ForgeSensitivityLayout::PathMajor:
+                return {block + path * factors_, 1, false};
+              case ForgeSensitivityLayout::FactorMajor:
+                return {block + path, paths_, false};
+              default:
+                return {block, 1, true};
+            }
+        }
+
+        /// adds the gradients in row[0..factors) of one path
+        void addPath(Size trade, Size t, Size path, const double* row) {
+            PathCells cells = addPathCells(trade, t, path);
+            for (Size f = 0; f < factors_; ++f) {
+                double& cell = cells.first[f * cells.stride];
+                cell = cells.accumulate ? cell + row[f] : row[f];
+            }
+        }
+
+        /// adds the gradients of the evaluator's valid lanes, paths firstPath onwards
+        template <Size Width>
+        void add(Size trade, Size t, Size firstPath, ForgeBatchEvaluator<Width>& evaluator) {
+            QL_REQUIRE(evaluator.numGradients() == factors_,
+                       "evaluator has " << evaluator.numGradients() << " gradients, tensor "
+                                        << factors_ << " factors");
+            QL_REQUIRE(firstPath + evaluator.count() <= paths_,
+                       "paths " << firstPath << " to " << firstPath + evaluator.count()
+                                << " out of range");
+            double* block = cellBlock(trade, t);
+            switch (layout_) {
+              case ForgeSensitivityLayout::PathMajor:
+                evaluator.readGradientRows(
+                    [=](Size lane) { return block + (firstPath + lane) * factors_; });
+                break;
+              case ForgeSensitivityLayout::FactorMajor:
+                evaluator.readGradientRows([=](Size lane) { return block + firstPath + lane; },
+                                           paths_);
+                break;
+              case ForgeSensitivityLayout::Aggregated:
+                evaluator.sumGradients(block);
+                break;
+            }
+            counts_[trade * timeSteps_ + t] += evaluator.count();
+        }
+
+        /// paths added to a (trade, date)
+        Size count(Size trade, Size t) const { return counts_[trade * timeSteps_ + t]; }
+
+        /// sum over the stored or added paths
+        double sum(Size trade, Size t, Size factor) const {
+            QL_REQUIRE(trade < trades_ && t < timeSteps_ && factor < factors_,
+                       "sensitivity (" << trade << ", " << t << ", " << factor << ") out of range");
+            const double* block = data_.data() + (trade * timeSteps_ + t) * blockSize();
+            switch (layout_) {
+              case ForgeSensitivityLayout::PathMajor: {
+                double s = 0.0;
+                for (Size p = 0; p < paths_; ++p)
+                    s += block[p * factors_ + factor];
+                return s;
+              }
+              case ForgeSensitivityLayout::FactorMajor: {
+                double s = 0.0;
+                for (Size p = 0; p < paths_; ++p)
+                    s += block[factor * paths_ + p];
+                return s;
+              }
+              default:
+                return block[factor];
+            }
+        }
+
+        /// path average over the paths added with add() or addPath()
+        double mean(Size trade, Size t, Size factor) const {
+            QL_REQUIRE(count(trade, t) > 0,
+                       "no paths added for trade " << trade << ", date " << t);
+            return sum(trade, t, factor) / count(trade, t);
+        }
+
+        void reset() {
+            std::fill(data_.begin(), data_.end(), 0.0);
+            std::fill(counts_.begin(), counts_.end(), Size(0));
+        }
+
+        double* data() { return data_.data(); }
+        const double* data() const { return data_.data(); }
+        Size size() const { return data_.size(); }
+
+      private:
+        Size blockSize() const { return factors_ * (storesPaths() ? paths_ : 1); }
+        double* cellBlock(Size trade, Size t) {
+            QL_REQUIRE(trade < trades_ && t < timeSteps_,
+                       "sensitivity cell (" << trade << ", " << t << ") out of range");
+            return data_.data() + (trade * timeSteps_ + t) * blockSize();
+        }
+        Size index(Size trade, Size t, Size path, Size factor) const {
+            const Size cell = (trade * timeSteps_ + t) * blockSize();
+            return layout_ == ForgeSensitivityLayout::PathMajor ?
+                       cell + path * factors_ + factor :
+                       cell + factor * paths_ + path;
+        }
+
+        Size trades_ = 0, timeSteps_ = 0, paths_ = 0, factors_ = 0;
+        ForgeSensitivityLayout layout_ = ForgeSensitivityLayout::PathMajor;
+        std::vector<double> data_;
+        std::vector<Size> counts_;
+    };
+
+}
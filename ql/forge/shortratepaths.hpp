@@ -0,0 +1,205 @@
+/*******************************************************************************
+
+   G2++ and Hull-White short-rate paths recorded into the pricing kernel.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    XVA kernels are usually fed from a precomputed scenario cube: every
+    path and time step stores the curve pillars a trade is priced on, so a
+    kernel execution reads some hundred bytes per scenario, and AAD through
+    the kernel stops at the pillars.  ForgeShortRatePaths records the model
+    instead: the Gaussian shocks of one path are the kernel inputs, the
+    factors are evolved exactly from one simulation time to the next, and
+    discount factors P(t_k, T) are closed-form functions of the factors and
+    the initial curve, so pillars only ever live in registers,
+
+        recorder.start();
+        ForgeG2Parameters params{0.05, 0.01, 0.3, 0.008, -0.7};
+        std::vector<forge::NodeId> modelInputs = params.markInputs();
+        ... build the initial curve from rates marked with markForgeInputAndDiff ...
+        ForgeShortRatePaths paths(params, *curve, exposureTimes);
+        for (Size k = 0; k < paths.numSteps(); ++k) {
+            Real v = ... swap value from paths.discount(k, T) ...;
+            v.markForgeOutput();
+        }
+        recorder.stop();
+
+        ForgeMonteCarloKernelRunner<4> runner(*kernel, *buffer, paths.shocks(),
+                                              outputs, parameterInputs, parameterInputs);
+
+    The runner generates the shocks in place, so a path costs its draws
+    (one or two per time step) instead of the cube entries, and the averaged
+    adjoints are sensitivities to the model parameters and to the inputs of
+    the initial curve.
+
+    The G2++ model is that of Brigo and Mercurio: r(t) = x(t) + y(t) + phi(t)
+    with x and y zero-mean Ornstein-Uhlenbeck processes of mean reversions
+    a, b and volatilities sigma, eta, correlated by rho, and phi fitting the
+    initial curve.  HullWhite keeps x alone.  Path values are as seen at the
+    simulation time, under the risk-neutral measure; discounting them to
+    today is left to the caller.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/termstructures/yieldtermstructure.hpp>
+#include <expressions/ExpressionTemplates/BinaryOperators.hpp>
+#include <expressions/ExpressionTemplates/UnaryOperators.hpp>
+#include <graph/handles.hpp>
+#include <utility>
+#include <vector>
+
+namespace QuantLib {
+
+    /// short-rate model evolved by ForgeShortRatePaths
+    enum class ForgeShortRateModel {
+        HullWhite,  ///< one factor x: a, sigma
+        G2          ///< two correlated factors x, y: a, sigma, b, eta, rho
+    };
+
+    /// G2++ parameters; Hull-White uses a and sigma only
+    struct ForgeG2Parameters {
+        Real a, sigma, b, eta, rho;
+
+        /// marks the parameters of the model as differentiated inputs and
+        /// returns their nodes, in declaration order
+        std::vector<forge::NodeId> markInputs(ForgeShortRateModel model = ForgeShortRateModel::G2) {
+            std::vector<Real*> used = {&a, &sigma};
+            if (model == ForgeShortRateModel::G2)
+                used.insert(used.end(), {&b, &eta, &rho});
+            std::vector<forge::NodeId> ids;
+            for (Real* p : used) {
+                p->markForgeInputAndDiff();
+                ids.push_back(p->forgeNodeId());
+            }
+            return ids;
+        }
+    };
+
+    /// one recorded path of the short-rate factors, with bond prices on it
+    /// The curve is referenced, not copied, and must outlive the paths.
+    class ForgeShortRatePaths {
+      public:
+        /// records the factors at the increasing positive simulation times,
+        /// marking the shocks of each step as inputs
+        ForgeShortRatePaths(const ForgeG2Parameters& parameters,
+                            const YieldTermStructure& curve,
+                            std::vector<Time> times,
+                            ForgeShortRateModel model = ForgeShortRateModel::G2)
+        : parameters_(parameters), curve_(curve), times_(std::move(times)), model_(model) {
+            QL_REQUIRE(!times_.empty(), "no simulation times given");
+            QL_REQUIRE(parameters_.a.getValue() > 0.0 && parameters_.sigma.getValue() > 0.0,
+                       "non-positive mean reversion or volatility of x");
+            if (model_ == ForgeShortRateModel::G2)
+                QL_REQUIRE(parameters_.b.getValue() > 0.0 && parameters_.eta.getValue() > 0.0,
+                           "non-positive mean reversion or volatility of y");
+            const Real &a = parameters_.a, &sigma = parameters_.sigma, &b = parameters_.b,
+                       &eta = parameters_.eta, &rho = parameters_.rho;
+
+            Real x = 0.0, y = 0.0;
+            Time previous = 0.0;
+            for (Size k = 0; k < times_.size(); ++k) {
+                QL_REQUIRE(times_[k] > previous, "simulation time " << times_[k]
+                                                                     << " not after " << previous);
+                const Time dt = times_[k] - previous;
+                Real z1 = 0.0;
+                z1.markForgeInput();
+                shocks_.push_back(z1.forgeNodeId());
+                // exact transition of the Ornstein-Uhlenbeck factors over dt
+                Real ea = exp(-a * dt);
+                Real sx = sigma * sqrt((1.0 - ea * ea) / (2.0 * a));
+                x = x * ea + sx * z1;
+                if (model_ == ForgeShortRateModel::G2) {
+                    Real z2 = 0.0;
+                    z2.markForgeInput();
+                    shocks_.push_back(z2.forgeNodeId());
+                    Real eb = exp(-b * dt);
+                    Real sy = eta * sqrt((1.0 - eb * eb) / (2.0 * b));
+                    // Cholesky factor of the covariance of the two increments
+                    Real cxy = rho * sigma * eta * (1.0 - ea * eb) / ((a + b) * sx);
+                    y = y * eb + cxy * z1 + sqrt(sy * sy - cxy * cxy) * z2;
+                    y_.push_back(y);
+                }
+                x_.push_back(x);
+                // time-t_k parts of the bond price formula, shared by every maturity
+                curveDiscounts_.push_back(curve_.discount(times_[k]));
+                variances_.push_back(variance(times_[k]));
+                previous = times_[k];
+            }
+        }
+
+        ForgeShortRateModel model() const { return model_; }
+        Size numSteps() const { return times_.size(); }
+        const std::vector<Time>& times() const { return times_; }
+        /// the shock inputs, step by step and x before y within a step
+        const std::vector<forge::NodeId>& shocks() const { return shocks_; }
+        Size shocksPerStep() const { return model_ == ForgeShortRateModel::G2 ? 2 : 1; }
+
+        /// factor values at simulation time k; y is zero for Hull-White
+        const Real& x(Size k) const {
+            QL_REQUIRE(k < x_.size(), "step " << k << " out of range");
+            return x_[k];
+        }
+        Real y(Size k) const {
+            QL_REQUIRE(k < x_.size(), "step " << k << " out of range");
+            return model_ == ForgeShortRateModel::G2 ? y_[k] : Real(0.0);
+        }
+
+        /// zero-coupon bond price P(t_k, T) on the path, for T >= t_k
+        ///   P^M(0,T) / P^M(0,t) exp(0.5 [V(T-t) - V(T) + V(t)] - B_a(T-t) x - B_b(T-t) y)
+        Real discount(Size k, Time T) const {
+            QL_REQUIRE(k < times_.size(), "step " << k << " out of range");
+            const Time tau = T - times_[k];
+            QL_REQUIRE(tau >= 0.0, "maturity " << T << " before simulation time " << times_[k]);
+            if (tau == 0.0)
+                return 1.0;
+            Real exponent = 0.5 * (variance(tau) - variance(T) + variances_[k]) -
+                            loading(parameters_.a, tau) * x_[k];
+            if (model_ == ForgeShortRateModel::G2)
+                exponent -= loading(parameters_.b, tau) * y_[k];
+            return curve_.discount(T) / curveDiscounts_[k] * exp(exponent);
+        }
+
+      private:
+        // B(z, tau) = (1 - exp(-z tau)) / z
+        static Real loading(const Real& z, Time tau) { return (1.0 - exp(-z * tau)) / z; }
+
+        // tau + 2/z exp(-z tau) - 1/(2z) exp(-2 z tau) - 3/(2z); V(tau) of a single
+        // factor of mean reversion z and volatility s is s^2 / z^2 times this
+        static Real term(const Real& z, Time tau) {
+            Real e = exp(-z * tau);
+            return tau + 2.0 / z * e - 0.5 / z * e * e - 1.5 / z;
+        }
+
+        // V(tau), the variance of the integral of x + y over a period of length tau
+        Real variance(Time tau) const {
+            const Real &a = parameters_.a, &sigma = parameters_.sigma;
+            Real v = sigma * sigma / (a * a) * term(a, tau);
+            if (model_ == ForgeShortRateModel::G2) {
+                const Real &b = parameters_.b, &eta = parameters_.eta, &rho = parameters_.rho;
+                v += eta * eta / (b * b) * term(b, tau) +
+                     2.0 * rho * sigma * eta / (a * b) *
+                         (tau + (exp(-a * tau) - 1.0) / a + (exp(-b * tau) - 1.0) / b -
+                          (exp(-(a + b) * tau) - 1.0) / (a + b));
+            }
+            return v;
+        }
+
+        ForgeG2Parameters parameters_;
+        const YieldTermStructure& curve_;
+        std::vector<Time> times_;
+        ForgeShortRateModel model_;
+        std::vector<forge::NodeId> shocks_;
+        std::vector<Real> x_, y_, curveDiscounts_, variances_;
+    };
+
+}
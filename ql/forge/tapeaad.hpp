@@ -0,0 +1,187 @@
+/*******************************************************************************
+
+   Tape-based AAD for workloads too small to compile a kernel for.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    A single-shot risk request evaluates its pricing function once, and
+    recording plus compiling a Forge kernel for it costs far more than the
+    valuation.  Real carries an operator-overloading tape as well (see
+    expressions/Tape.hpp): with a Real::tape_type active on the thread,
+    every assignment is recorded as a statement and computeAdjoints()
+    sweeps them backwards, with no compilation at all.
+
+    forgeTapeEvaluator() turns a pricing function on Real into a direct
+    evaluator (for ForgeTieredExecutor, say) that tapes one scenario per
+    call; the tape's memory is kept between calls.
+
+    forgeEvaluateAad() picks the backend from the expected reuse count:
+
+        ForgeAadBackend used = forgeEvaluateAad(numInputs, price, scenarios,
+                                                count, stride, npvs, gradients);
+
+    below breakEvenScenarios every scenario is taped; from there on the
+    function is recorded once, compiled, and all scenarios run through the
+    kernel.  forgeBreakEvenScenarios() derives the threshold from measured
+    costs.  The pricing function must take the same branches for all
+    scenarios to be evaluated through one kernel.
+
+    Helpers that compute their value on passive scalars and record their
+    Forge side apart (the boost special functions in ql/qlforge.hpp, the
+    packed std::complex operations, horner()) tape the result with its
+    analytic partials, so both backends give the same gradients.
+
+    Builds with FEXPR_NO_TAPE have no tape: forgeEvaluateAad() always
+    compiles, and forgeTapeEvaluator() fails.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/batchevaluator.hpp>
+#include <ql/forge/tieredexecutor.hpp>
+#include <graph/graph_recorder.hpp>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace QuantLib {
+
+    /// pricing function of numInputs active inputs, one output
+    using ForgeActiveFunction = std::function<Real(const Real* inputs)>;
+
+    /// false in builds with the tape compiled out
+#ifdef FEXPR_NO_TAPE
+    constexpr bool forgeTapeAvailable = false;
+#else
+    constexpr bool forgeTapeAvailable = true;
+#endif
+
+    /// how forgeEvaluateAad() computed the gradients
+    enum class ForgeAadBackend { Tape, Kernel };
+
+    /// backend selection of forgeEvaluateAad()
+    struct ForgeAadSelectorOptions {
+        /// scenarios from which the function is compiled rather than taped
+        Size breakEvenScenarios = 64;
+        /// compiler settings for the kernel backend
+        forge::CompilerConfig config;
+    };
+
+    /// scenarios from which compiling beats taping, given per-scenario costs
+    /// Returns the largest Size if the kernel is not faster per scenario.
+    inline Size forgeBreakEvenScenarios(double compileSeconds,
+                                        double tapeSecondsPerScenario,
+                                        double kernelSecondsPerScenario) {
+        QL_REQUIRE(compileSeconds >= 0.0 && tapeSecondsPerScenario >= 0.0 &&
+                       kernelSecondsPerScenario >= 0.0,
+                   "negative cost given for the AAD backend selection");
+        const double saving = tapeSecondsPerScenario - kernelSecondsPerScenario;
+        if (saving <= 0.0)
+            return std::numeric_limits<Size>::max();
+        return Size(std::ceil(compileSeconds / saving));
+    }
+
+    inline ForgeAadBackend
+    forgeSelectAadBackend(Size expectedScenarios,
+                          const ForgeAadSelectorOptions& options = ForgeAadSelectorOptions()) {
+        return forgeTapeAvailable && expectedScenarios < options.breakEvenScenarios
+                   ? ForgeAadBackend::Tape
+                   : ForgeAadBackend::Kernel;
+    }
+
+    /// direct evaluator taping price once per scenario
+    /// Not to be called concurrently, nor while another tape is active on the thread.
+    inline ForgeDirectEvaluator forgeTapeEvaluator(Size numInputs, ForgeActiveFunction price) {
+        QL_REQUIRE(price, "no pricing function given");
+        QL_REQUIRE(forgeTapeAvailable, "the tape is compiled out (FEXPR_NO_TAPE)");
+        typedef Real::tape_type tape_type;
+        struct State {
+            tape_type tape{false};
+            std::vector<Real> inputs;
+        };
+        auto state = std::make_shared<State>();
+        state->inputs.resize(numInputs);
+        return [state, numInputs, price](const double* x, double* outputs, double* gradients) {
+            tape_type& tape = state->tape;
+            std::vector<Real>& inputs = state->inputs;
+            tape.activate();
+            struct Deactivate {
+                tape_type& t;
+                ~Deactivate() { t.deactivate(); }
+            } deactivate{tape};
+
+            tape.clearAll();
+            for (Size i = 0; i < numInputs; ++i) {
+                inputs[i] = x[i];
+                if (gradients != nullptr)
+                    tape.registerInput(inputs[i]);
+            }
+            tape.newRecording();
+            Real y = price(inputs.data());
+            outputs[0] = y.getValue();
+            if (gradients == nullptr)
+                return;
+            tape.registerOutput(y);
+            derivative(y) = 1.0;
+            tape.computeAdjoints();
+            for (Size i = 0; i < numInputs; ++i)
+                gradients[i] = derivative(inputs[i]);
+        };
+    }
+
+    /// evaluates price and (if not null) its gradients on count row-major scenarios
+    /// Outputs take one value and gradients numInputs values per scenario.
+    inline ForgeAadBackend
+    forgeEvaluateAad(Size numInputs,
+                     const ForgeActiveFunction& price,
+                     const double* scenarios,
+                     Size count,
+                     Size stride,
+                     double* outputs,
+                     double* gradients = nullptr,
+                     const ForgeAadSelectorOptions& options = ForgeAadSelectorOptions()) {
+        if (count == 0)
+            return forgeSelectAadBackend(count, options);
+
+        if (forgeSelectAadBackend(count, options) == ForgeAadBackend::Tape) {
+            ForgeDirectEvaluator direct = forgeTapeEvaluator(numInputs, price);
+            for (Size i = 0; i < count; ++i)
+                direct(scenarios + i * stride, outputs + i,
+                       gradients != nullptr ? gradients + i * numInputs : nullptr);
+            return ForgeAadBackend::Tape;
+        }
+
+        forge::GraphRecorder recorder;
+        recorder.start();
+        std::vector<Real> x(scenarios, scenarios + numInputs);
+        std::vector<forge::NodeId> inputs(numInputs);
+        for (Size i = 0; i < numInputs; ++i) {
+            x[i].markForgeInputAndDiff();
+            inputs[i] = x[i].forgeNodeId();
+        }
+        Real y = price(x.data());
+        y.markForgeOutput();
+        recorder.stop();
+
+        forge::ForgeEngine compiler(options.config);
+        auto kernel = compiler.compile(recorder.graph());
+        QL_REQUIRE(kernel != nullptr, "Forge kernel compilation failed");
+        auto buffer = forge::NodeValueBufferFactory::create(recorder.graph(), *kernel);
+        forgeEvaluateBatched(*kernel, *buffer, inputs, {y.forgeNodeId()},
+                             gradients != nullptr ? inputs : std::vector<forge::NodeId>(),
+                             scenarios, count, stride, outputs, gradients);
+        return ForgeAadBackend::Kernel;
+    }
+
+}
@@ -0,0 +1,365 @@
+/*******************************************************************************
+
+   Tiered execution: direct evaluation until the compiled kernel pays off.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    A trade touched once or twice (an intraday what-if) pays the full
+    kernel compilation for one or two scenarios, which is where a
+    plain evaluation wins by a wide margin.  ForgeTieredExecutor starts
+    with a direct evaluation, submits the recorded graph to a
+    ForgeCompilePipeline right away and switches to the compiled kernel
+    as soon as it is ready, or blocks for it once a scenario threshold is
+    crossed and compiling is known to pay off:
+
+        ForgeCompilePipeline pipeline(config);
+        ForgeTieredExecutor executor(pipeline, recorder.graph(), inputs,
+                                     {npv}, inputs);
+        executor.evaluate(scenarios, count, stride, npvs, gradients);
+
+    The switch happens between calls, never within one, and both tiers
+    fill the same row-major outputs and gradients, one row per scenario.
+    A compile error is rethrown by the call that would have switched;
+    the executor then stays on the direct tier.
+
+    By default the direct tier is a ForgeGraphInterpreter, which walks the
+    recorded graph node by node, forward for the values and backward for
+    the adjoints of the first output as the kernel does.  Each scenario
+    then costs some multiple of one kernel execution (a dispatch per node
+    instead of generated code) but nothing is compiled first, so only the
+    recording is needed.  Graphs with operations outside forgeOpcodeTable()
+    cannot be interpreted; without an override the first call then waits
+    for the kernel.
+
+    A ForgeDirectEvaluator passed to the constructor replaces the
+    interpreter: forgeTapeEvaluator() (ql/forge/tapeaad.hpp) tapes a
+    pricing function on Real with the same exact gradients, and
+    forgeBumpedEvaluator() turns a pricing function of plain doubles into
+    one with forward-difference gradients.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/forge/batchevaluator.hpp>
+#include <ql/forge/compilepipeline.hpp>
+#include <ql/forge/graphhash.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <future>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace QuantLib {
+
+    /// switching policy of ForgeTieredExecutor
+    struct ForgeTieredOptions {
+        /// scenarios after which to wait for the compiled kernel, 0 to never wait
+        Size waitAfter = 64;
+    };
+
+    /// evaluates one scenario: inputs to outputs and (if not null) gradients
+    using ForgeDirectEvaluator =
+        std::function<void(const double* inputs, double* outputs, double* gradients)>;
+
+    /// direct evaluator of one output with forward-difference gradients
+    inline ForgeDirectEvaluator
+    forgeBumpedEvaluator(Size numInputs, std::function<double(const double*)> price, double bump = 1e-6) {
+        return [=](const double* inputs, double* outputs, double* gradients) {
+            const double base = price(inputs);
+            outputs[0] = base;
+            if (gradients == nullptr)
+                return;
+            std::vector<double> bumped(inputs, inputs + numInputs);
+            for (Size i = 0; i < numInputs; ++i) {
+                bumped[i] += bump;
+                gradients[i] = (price(bumped.data()) - base) / bump;
+                bumped[i] = inputs[i];
+            }
+        };
+    }
+
+    /// evaluates a recorded graph node by node, with the adjoints of its first output
+    /// Values come from the recording for inputs not given and for inactive
+    /// nodes; active nodes are recomputed from their operands.
+    class ForgeGraphInterpreter {
+      public:
+        ForgeGraphInterpreter(const forge::Graph& graph,
+                              std::vector<forge::NodeId> inputs,
+                              std::vector<forge::NodeId> outputs,
+                              std::vector<forge::NodeId> gradientInputs)
+        : inputs_(std::move(inputs)), outputs_(std::move(outputs)),
+          gradientInputs_(std::move(gradientInputs)), values_(graph.nodes.size()),
+          adjoints_(graph.nodes.size()) {
+            const Size n = graph.nodes.size();
+            for (const auto* ids : {&inputs_, &outputs_, &gradientInputs_})
+                for (auto id : *ids)
+                    QL_REQUIRE(std::size_t(id) < n, "node " << id << " is not in the graph");
+            if (!graph.outputs.empty())
+                seed_ = graph.outputs.front();
+            steps_.reserve(n);
+            const auto& table = forgeOpcodeTable();
+            for (Size i = 0; i < n; ++i) {
+                const ForgeNodeInfo node = forgeNodeInfo(graph.nodes[i]);
+                Step step;
+                step.value = node.value;
+                if (node.input) {
+                    step.op = Op::Input;
+                } else if (node.active && !node.constant) {
+                    auto it = table.find(node.opcode);
+                    step.op = it != table.end() ? operation(it->second.name) : Op::Unknown;
+                    const std::uint32_t slots = it != table.end() ? it->second.operands : 0U;
+                    for (std::uint32_t k = 0; k < 3; ++k)
+                        if ((slots & (1U << k)) != 0) {
+                            QL_REQUIRE(std::size_t(node.operands[k]) < i,
+                                       "node " << i << " uses node " << node.operands[k]
+                                               << " recorded after it");
+                            step.operands[k] = node.operands[k];
+                        }
+                    supported_ = supported_ && step.op != Op::Unknown;
+                }
+                steps_.push_back(step);
+            }
+        }
+
+        /// false if the graph has active nodes of operations the interpreter does not know
+        bool supported() const { return supported_; }
+
+        /// evaluates one scenario, as a ForgeDirectEvaluator does
+        void operator()(const double* inputs, double* outputs, double* gradients) {
+            QL_REQUIRE(supported_, "the graph has operations the Forge interpreter does not know");
+            const Size n = steps_.size();
+            for (Size i = 0; i < n; ++i)
+                values_[i] = steps_[i].value;
+            for (Size k = 0; k < inputs_.size(); ++k)
+                values_[inputs_[k]] = inputs[k];
+            for (Size i = 0; i < n; ++i)
+                if (steps_[i].op != Op::Input && steps_[i].op != Op::Constant)
+                    values_[i] = forward(steps_[i]);
+            for (Size k = 0; k < outputs_.size(); ++k)
+                outputs[k] = values_[outputs_[k]];
+            if (gradients == nullptr)
+                return;
+
+            std::fill(adjoints_.begin(), adjoints_.end(), 0.0);
+            if (seed_ < n)
+                adjoints_[seed_] = 1.0;
+            for (Size i = n; i-- > 0;)
+                if (adjoints_[i] != 0.0)
+                    backward(steps_[i], values_[i], adjoints_[i]);
+            for (Size k = 0; k < gradientInputs_.size(); ++k)
+                gradients[k] = adjoints_[gradientInputs_[k]];
+        }
+
+      private:
+        enum class Op {
+            Input, Constant, Add, Sub, Mul, Div, Neg, Exp, Log, Sqrt, Abs, Pow, Min, Max,
+            Fma, Fnma, Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual, If, Unknown
+        };
+
+        struct Step {
+            Op op = Op::Constant;
+            forge::NodeId operands[3] = {0, 0, 0};
+            double value = 0.0;
+        };
+
+        // operands come in the order of the fdouble operation's arguments;
+        // If takes the condition, then the selected values
+        static Op operation(const std::string& name) {
+            static const std::map<std::string, Op> operations = {
+                {"Add", Op::Add},       {"Sub", Op::Sub},           {"Mul", Op::Mul},
+                {"Div", Op::Div},       {"Neg", Op::Neg},           {"Exp", Op::Exp},
+                {"Log", Op::Log},       {"Sqrt", Op::Sqrt},         {"Abs", Op::Abs},
+                {"Pow", Op::Pow},       {"Min", Op::Min},           {"Max", Op::Max},
+                {"Fma", Op::Fma},       {"Fnma", Op::Fnma},         {"Less", Op::Less},
+                {"LessEqual", Op::LessEqual}, {"Greater", Op::Greater},
+                {"GreaterEqual", Op::GreaterEqual}, {"Equal", Op::Equal},
+                {"NotEqual", Op::NotEqual}, {"If", Op::If}};
+            auto it = operations.find(name);
+            return it != operations.end() ? it->second : Op::Unknown;
+        }
+
+        double forward(const Step& s) const {
+            const double a = values_[s.operands[0]], b = values_[s.operands[1]],
+                         c = values_[s.operands[2]];
+            switch (s.op) {
+              case Op::Add: return a + b;
+              case Op::Sub: return a - b;
+              case Op::Mul: return a * b;
+              case Op::Div: return a / b;
+              case Op::Neg: return -a;
+              case Op::Exp: return std::exp(a);
+              case Op::Log: return std::log(a);
+              case Op::Sqrt: return std::sqrt(a);
+              case Op::Abs: return std::fabs(a);
+              case Op::Pow: return std::pow(a, b);
+              case Op::Min: return a <= b ? a : b;
+              case Op::Max: return a >= b ? a : b;
+              case Op::Fma: return a * b + c;
+              case Op::Fnma: return c - a * b;
+              case Op::Less: return a < b ? 1.0 : 0.0;
+              case Op::LessEqual: return a <= b ? 1.0 : 0.0;
+              case Op::Greater: return a > b ? 1.0 : 0.0;
+              case Op::GreaterEqual: return a >= b ? 1.0 : 0.0;
+              case Op::Equal: return a == b ? 1.0 : 0.0;
+              case Op::NotEqual: return a != b ? 1.0 : 0.0;
+              case Op::If: return a != 0.0 ? b : c;
+              default: return s.value;
+            }
+        }
+
+        void backward(const Step& s, double result, double adjoint) {
+            const forge::NodeId ia = s.operands[0], ib = s.operands[1], ic = s.operands[2];
+            const double a = values_[ia], b = values_[ib];
+            switch (s.op) {
+              case Op::Add: adjoints_[ia] += adjoint; adjoints_[ib] += adjoint; break;
+              case Op::Sub: adjoints_[ia] += adjoint; adjoints_[ib] -= adjoint; break;
+              case Op::Mul: adjoints_[ia] += adjoint * b; adjoints_[ib] += adjoint * a; break;
+              case Op::Div:
+                adjoints_[ia] += adjoint / b;
+                adjoints_[ib] -= adjoint * result / b;
+                break;
+              case Op::Neg: adjoints_[ia] -= adjoint; break;
+              case Op::Exp: adjoints_[ia] += adjoint * result; break;
+              case Op::Log: adjoints_[ia] += adjoint / a; break;
+              case Op::Sqrt: adjoints_[ia] += adjoint * 0.5 / result; break;
+              case Op::Abs: adjoints_[ia] += a >= 0.0 ? adjoint : -adjoint; break;
+              case Op::Pow:
+                adjoints_[ia] += adjoint * b * std::pow(a, b - 1.0);
+                if (a > 0.0)
+                    adjoints_[ib] += adjoint * result * std::log(a);
+                break;
+              case Op::Min: adjoints_[a <= b ? ia : ib] += adjoint; break;
+              case Op::Max: adjoints_[a >= b ? ia : ib] += adjoint; break;
+              case Op::Fma:
+                adjoints_[ia] += adjoint * b;
+                adjoints_[ib] += adjoint * a;
+                adjoints_[ic] += adjoint;
+                break;
+              case Op::Fnma:
+                adjoints_[ia] -= adjoint * b;
+                adjoints_[ib] -= adjoint * a;
+                adjoints_[ic] += adjoint;
+                break;
+              case Op::If: adjoints_[a != 0.0 ? ib : ic] += adjoint; break;
+              default: break;
+            }
+        }
+
+        std::vector<forge::NodeId> inputs_, outputs_, gradientInputs_;
+        std::vector<Step> steps_;
+        std::vector<double> values_, adjoints_;
+        std::size_t seed_ = std::size_t(-1);
+        bool supported_ = true;
+    };
+
+    /// one recorded graph, run directly and then through its compiled kernel
+    class ForgeTieredExecutor {
+      public:
+        using Options = ForgeTieredOptions;
+
+        /// interprets the graph until the kernel is ready
+        ForgeTieredExecutor(ForgeCompilePipeline& pipeline,
+                            const forge::Graph& graph,
+                            std::vector<forge::NodeId> inputs,
+                            std::vector<forge::NodeId> outputs,
+                            std::vector<forge::NodeId> gradientInputs,
+                            const Options& options = Options())
+        : ForgeTieredExecutor(pipeline, graph, std::move(inputs), std::move(outputs),
+                              std::move(gradientInputs), ForgeDirectEvaluator(), options) {}
+
+        /// runs the given direct evaluator until the kernel is ready, or interprets the graph if it is null
+        ForgeTieredExecutor(ForgeCompilePipeline& pipeline,
+                            const forge::Graph& graph,
+                            std::vector<forge::NodeId> inputs,
+                            std::vector<forge::NodeId> outputs,
+                            std::vector<forge::NodeId> gradientInputs,
+                            ForgeDirectEvaluator direct,
+                            const Options& options = Options())
+        : inputs_(std::move(inputs)), outputs_(std::move(outputs)),
+          gradientInputs_(std::move(gradientInputs)), direct_(std::move(direct)),
+          options_(options) {
+            if (!direct_) {
+                ForgeGraphInterpreter interpreter(graph, inputs_, outputs_, gradientInputs_);
+                if (interpreter.supported())
+                    direct_ = std::move(interpreter);
+            }
+            pending_ = pipeline.submit(graph);
+        }
+
+        /// evaluates count scenarios of a row-major matrix with the given row stride
+        /// outputs and gradients are row-major, numOutputs() and numGradients() columns.
+        void evaluate(const double* scenarios, Size count, Size stride,
+                      double* outputValues, double* gradients = nullptr) {
+            if (compiled_.kernel == nullptr)
+                trySwitch(count);
+            // without a direct tier, the first call waits for the kernel
+            if (compiled_.kernel == nullptr && !direct_)
+                waitForKernel();
+            if (compiled_.kernel != nullptr) {
+                forgeEvaluateBatched(*compiled_.kernel, *compiled_.buffer, inputs_, outputs_,
+                                     gradientInputs_, scenarios, count, stride, outputValues,
+                                     gradients);
+                kernelScenarios_ += count;
+                return;
+            }
+            const Size nOut = outputs_.size(), nGrad = gradientInputs_.size();
+            for (Size i = 0; i < count; ++i)
+                direct_(scenarios + i * stride, outputValues + i * nOut,
+                        gradients != nullptr ? gradients + i * nGrad : nullptr);
+            directScenarios_ += count;
+        }
+
+        /// true once the compiled kernel is in use
+        bool compiled() const { return compiled_.kernel != nullptr; }
+        /// false if the graph could not be interpreted and no direct evaluator was given
+        bool hasDirectTier() const { return bool(direct_); }
+        /// waits for the compiled kernel and switches to it
+        void waitForKernel() {
+            QL_REQUIRE(compiled_.kernel != nullptr || pending_.valid(),
+                       "the kernel of the tiered executor failed to compile");
+            if (compiled_.kernel == nullptr)
+                take();
+        }
+
+        Size numInputs() const { return inputs_.size(); }
+        Size numOutputs() const { return outputs_.size(); }
+        Size numGradients() const { return gradientInputs_.size(); }
+        /// scenarios evaluated by each tier
+        Size directScenarios() const { return directScenarios_; }
+        Size kernelScenarios() const { return kernelScenarios_; }
+        /// compile time on the pipeline thread, 0 before the switch
+        double compileSeconds() const { return compiled_.compileSeconds; }
+
+      private:
+        void trySwitch(Size upcoming) {
+            if (!pending_.valid())
+                return;
+            const bool due = options_.waitAfter > 0 &&
+                             directScenarios_ + upcoming > options_.waitAfter;
+            if (due || pending_.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+                take();
+        }
+
+        void take() { compiled_ = pending_.get(); }
+
+        std::vector<forge::NodeId> inputs_, outputs_, gradientInputs_;
+        ForgeDirectEvaluator direct_;
+        Options options_;
+        std::future<ForgeCompiledKernel> pending_;
+        ForgeCompiledKernel compiled_;
+        Size directScenarios_ = 0, kernelScenarios_ = 0;
+    };
+
+}
@@ -0,0 +1,153 @@
+/*******************************************************************************
+
+   Swap valuation parameterised by the evaluation time, for one kernel per trade.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Re-pricing a swap at every exposure date means rebuilding its remaining
+    schedule, an integer and date computation outside the graph, so every
+    time step records and compiles its own kernel.  ForgeTimeParameterisedSwap
+    records the full cashflow schedule once instead.  Every cashflow is
+    valued against the curve and masked by a recorded comparison of its
+    payment time with an evaluation-time input, so one kernel prices the
+    trade at any time step:
+
+        recorder.start();
+        Real t = 0.0;
+        t.markForgeInput();
+        ... build the curve and the full-tenor swap from the marked inputs ...
+        ForgeTimeParameterisedSwap timed(*swap, today, dayCounter);
+        Real npv = timed.npv(t, **termStructure);
+        npv.markForgeOutput();
+        recorder.stop();
+
+    and then sets t per time step as any other kernel input.
+
+    With ForgeCashflowMask::PaidAfter, a cashflow is alive while it is paid
+    after t, the usual exposure at time t, discounted to the reference date.
+    With PaidOnOrBefore, it is alive if it is paid at or before t, i.e. t is
+    a maturity horizon: this reproduces a swap whose schedule is cut at t,
+    as the XVA benchmarks model later time steps.
+
+    The legs are taken from the swap at construction and amounts are
+    computed in npv(), so floating coupons are forecast from whatever curves
+    their indexes are linked to while recording.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <ql/cashflow.hpp>
+#include <ql/instruments/swap.hpp>
+#include <ql/termstructures/yieldtermstructure.hpp>
+#include <ql/time/daycounter.hpp>
+#include <expressions/ExpressionTemplates/BinaryOperators.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace QuantLib {
+
+    /// which cashflows ForgeTimeParameterisedSwap counts at evaluation time t
+    enum class ForgeCashflowMask {
+        PaidAfter,      ///< payment time > t: exposure at t
+        PaidOnOrBefore  ///< payment time <= t: schedule cut at horizon t
+    };
+
+    /// swap NPV as a function of a recorded evaluation time
+    class ForgeTimeParameterisedSwap {
+      public:
+        /// one flow of the recorded schedule
+        struct Flow {
+            ext::shared_ptr<CashFlow> cashflow;
+            double paymentTime;
+            bool payer;
+        };
+
+        ForgeTimeParameterisedSwap(const Swap& swap,
+                                   const Date& referenceDate,
+                                   const DayCounter& dayCounter,
+                                   ForgeCashflowMask mask = ForgeCashflowMask::PaidAfter)
+        : ForgeTimeParameterisedSwap(legsOf(swap), payersOf(swap), referenceDate, dayCounter, mask) {}
+
+        ForgeTimeParameterisedSwap(const std::vector<Leg>& legs,
+                                   const std::vector<bool>& payer,
+                                   const Date& referenceDate,
+                                   const DayCounter& dayCounter,
+                                   ForgeCashflowMask mask = ForgeCashflowMask::PaidAfter)
+        : referenceDate_(referenceDate), mask_(mask) {
+            QL_REQUIRE(legs.size() == payer.size(),
+                       legs.size() << " legs but " << payer.size() << " payer flags");
+            for (Size j = 0; j < legs.size(); ++j) {
+                for (const auto& cf : legs[j]) {
+                    // flows paid on or before the reference date never contribute
+                    if (cf->date() <= referenceDate_)
+                        continue;
+                    double time = value(dayCounter.yearFraction(referenceDate_, cf->date()));
+                    flows_.push_back({cf, time, bool(payer[j])});
+                }
+            }
+            QL_REQUIRE(!flows_.empty(), "no cashflows after " << referenceDate_);
+        }
+
+        Size numCashflows() const { return flows_.size(); }
+        const std::vector<Flow>& flows() const { return flows_; }
+        const Date& referenceDate() const { return referenceDate_; }
+        ForgeCashflowMask mask() const { return mask_; }
+
+        /// payment time of the last flow: with PaidAfter, the NPV is zero from there on
+        double lastPaymentTime() const {
+            double last = flows_.front().paymentTime;
+            for (const auto& f : flows_)
+                last = std::max(last, f.paymentTime);
+            return last;
+        }
+
+        /// NPV of the alive flows at time t, discounted to the reference date
+        /// Each flow is masked by a recorded comparison with t, so a kernel
+        /// recorded with t as an input is valid for every t.
+        Real npv(const Real& t, const YieldTermStructure& discountCurve) const {
+            QL_REQUIRE(discountCurve.referenceDate() == referenceDate_,
+                       "discount curve reference date " << discountCurve.referenceDate()
+                                                        << " differs from " << referenceDate_);
+            Real total = 0.0;
+            for (const auto& f : flows_) {
+                Real pv = f.cashflow->amount() * discountCurve.discount(f.cashflow->date());
+                Real alive = mask_ == ForgeCashflowMask::PaidAfter ?
+                                 forge::expr::where(t < f.paymentTime, pv, Real(0.0)) :
+                                 forge::expr::where(t >= f.paymentTime, pv, Real(0.0));
+                if (f.payer)
+                    total -= alive;
+                else
+                    total += alive;
+            }
+            return total;
+        }
+
+      private:
+        static std::vector<Leg> legsOf(const Swap& swap) {
+            std::vector<Leg> legs;
+            for (Size j = 0; j < swap.numberOfLegs(); ++j)
+                legs.push_back(swap.leg(j));
+            return legs;
+        }
+        static std::vector<bool> payersOf(const Swap& swap) {
+            std::vector<bool> payer;
+            for (Size j = 0; j < swap.numberOfLegs(); ++j)
+                payer.push_back(swap.payer(j));
+            return payer;
+        }
+
+        Date referenceDate_;
+        ForgeCashflowMask mask_;
+        std::vector<Flow> flows_;
+    };
+
+}
@@ -0,0 +1,136 @@
+/*******************************************************************************
+
+   Trade skeletons shared by every recording of the same trade.
+
+   This file is part of QuantLib-Forge, a Forge integration layer for QuantLib.
+
+   Copyright (C) 2025 The QuantLib-Forge Authors
+
+   SPDX-License-Identifier: AGPL-3.0-or-later
+
+******************************************************************************/
+
+/*
+    Recording a swap the way the XVA benchmarks do builds its schedules,
+    its index, the pillar dates of its curve and the coupons of both legs
+    from scratch, although none of them depends on the market inputs being
+    recorded: calendar adjustments and schedule generation take a large
+    share of the recording time, and they are repeated whenever a kernel is
+    re-recorded, at every exposure date or after a branch guard has tripped.
+
+    A skeleton is that market-independent structure, built once against a
+    RelinkableHandle to the curve it is priced on; re-recording only links
+    the handle to a curve made from the new inputs and prices, so the
+    recorded graph holds the same arithmetic as one built from scratch.
+    ForgeSkeletonCache keeps skeletons by trade terms and evaluation date,
+    building them on first use:
+
+        ForgeSkeletonCache<Size, ForgeSwapSkeleton> skeletons([&](const Size& s) {
+            auto skeleton = ext::make_shared<ForgeSwapSkeleton>();
+            auto index = ext::make_shared<Euribor6M>(skeleton->curve);
+            ... schedules, the VanillaSwap on index and a DiscountingSwapEngine
+                on skeleton->curve; skeleton->pillarDates for the curve ...
+            skeleton->swap = swap;
+            return skeleton;
+        });
+
+        recorder.start();
+        auto skeleton = skeletons.get(s);
+        ... mark the rates, build a ZeroCurve on skeleton->pillarDates ...
+        Real npv = skeleton->npv(zeroCurve);
+
+    The evaluation date is part of the key, since schedules and pillar dates
+    are relative to it; purge() drops the skeletons of other dates.  The
+    key must be ordered by operator<, and should hold the terms as plain
+    numbers or an index into immutable trade definitions: comparing Real
+    terms while recording is not a plain comparison.
+
+    Skeletons are QuantLib object graphs and carry the usual restrictions:
+    a cache belongs to one thread, and its skeletons must not be shared by
+    recordings in flight at the same time.
+*/
+
+#pragma once
+
+#include <ql/errors.hpp>
+#include <ql/handle.hpp>
+#include <ql/settings.hpp>
+#include <ql/types.hpp>
+#include <ql/instruments/swap.hpp>
+#include <ql/termstructures/yieldtermstructure.hpp>
+#include <ql/time/date.hpp>
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace QuantLib {
+
+    /// the market-independent part of a swap, priced off a relinkable curve
+    struct ForgeSwapSkeleton {
+        /// the handle the legs, the index and the engine were built on
+        RelinkableHandle<YieldTermStructure> curve;
+        ext::shared_ptr<Swap> swap;
+        /// pillar dates of the curve, if the factory computes them
+        std::vector<Date> pillarDates;
+
+        /// NPV of the swap on the given curve, recorded if the curve is
+        Real npv(const ext::shared_ptr<YieldTermStructure>& market) {
+            QL_REQUIRE(swap, "skeleton has no swap");
+            curve.linkTo(market);
+            // a relink to a curve at the address of the previous one does not
+            // notify, and the cached NPV would belong to an earlier recording
+            swap->recalculate();
+            return swap->NPV();
+        }
+    };
+
+    /// skeletons by trade terms and evaluation date, built on first use
+    template <class Key, class Skeleton>
+    class ForgeSkeletonCache {
+      public:
+        using Factory = std::function<ext::shared_ptr<Skeleton>(const Key&)>;
+
+        explicit ForgeSkeletonCache(Factory factory) : factory_(std::move(factory)) {
+            QL_REQUIRE(factory_, "no skeleton factory given");
+        }
+
+        /// the skeleton of the given terms at the current evaluation date
+        ext::shared_ptr<Skeleton> get(const Key& key) {
+            const Date today = Settings::instance().evaluationDate();
+            auto it = skeletons_.find(std::make_pair(today, key));
+            if (it != skeletons_.end()) {
+                ++hits_;
+                return it->second;
+            }
+            ++misses_;
+            ext::shared_ptr<Skeleton> skeleton = factory_(key);
+            QL_REQUIRE(skeleton, "skeleton factory returned no skeleton");
+            skeletons_.emplace(std::make_pair(today, key), skeleton);
+            return skeleton;
+        }
+
+        /// drops the skeletons built for other evaluation dates
+        void purge() {
+            const Date today = Settings::instance().evaluationDate();
+            for (auto it = skeletons_.begin(); it != skeletons_.end();) {
+                if (it->first.first != today)
+                    it = skeletons_.erase(it);
+                else
+                    ++it;
+            }
+        }
+
+        void clear() { skeletons_.clear(); }
+
+        Size size() const { return skeletons_.size(); }
+        Size hits() const { return hits_; }
+        Size misses() const { return misses_; }
+
+      private:
+        Factory factory_;
+        std::map<std::pair<Date, Key>, ext::shared_ptr<Skeleton>> skeletons_;
+        Size hits_ = 0, misses_ = 0;
+    };
+
+}
@@ -28,6 +28,8 @@
 
 #include <boost/accumulators/numeric/functional.hpp>
 #include <boost/accumulators/statistics/tail_quantile.hpp>
+#include <boost/math/constants/constants.hpp>
+#include <boost/math/special_functions/digamma.hpp>
 #include <boost/math/special_functions/math_fwd.hpp>
 #include <boost/math/tools/promotion.hpp>
 #include <boost/math/tools/rational.hpp>
@@ -41,6 +43,8 @@
 #include <expressions/ExpressionTemplates/UnaryExpr.hpp>
 #include <expressions/Compatibility/Complex.hpp>
 #include <expressions/Compatibility/StdCompatibility.hpp>
+#include <expressions/ExpressionTemplates/ForgeSpecialFunctions.hpp>
+#include <graph/graph_recorder.hpp>
 #include <limits>
 #include <type_traits>
 
@@ -506,6 +510,116 @@ namespace boost {
 
     template <>
     struct is_convertible<forge::expr::AReal<double>, forge::expr::AReal<double> > : public true_type {};
+
+    namespace math {
+
+            /* Forge-recorded special functions for AReal.  The value is boost's, computed on
+             * double; while recording an active argument, the Forge side is the intrinsic of
+             * expressions/ExpressionTemplates/ForgeSpecialFunctions.hpp instead of boost's
+             * series code run on AReal, which records huge graphs with native branches.
+             * With a tape active, the result is taped with its analytic derivative.
+             * Other entry points (gamma_p, ibeta, ...) still run on AReal; see
+             * forge-test-suite/specialfunctions_forge.cpp for the coverage.
+             */
+            namespace forge_detail {
+                typedef forge::expr::AReal<double> areal;
+
+                // the value of x; reading it is not a graph drop, the Forge side is recorded apart
+                inline double passive(const areal& x) { return forge::expr::detail::passiveValueOf(x); }
+
+                inline bool recording(const areal& x) {
+                    return forge::GraphRecorder::isAnyRecording() && x.forgeValue().isActive();
+                }
+
+                // tapes r = f(x) with f'(x) given by partial(x, f(x))
+                template <class Partial>
+                inline void taped(areal& r, const areal& x, Partial partial) {
+                    areal::tape_type* tape = areal::tape_type::getActive();
+                    if (tape != nullptr && x.shouldRecord())
+                        tape->pushPartials(r, {{partial(passive(x), passive(r)), x.getSlot()}});
+                }
+
+                template <class Record, class Partial>
+                inline areal recorded(const areal& x, double v, Record record, Partial partial) {
+                    areal r = v;
+                    if (recording(x))
+                        r.setForgeValue(record(x.forgeValue()));
+                    taped(r, x, partial);
+                    return r;
+                }
+
+                template <class Policy>
+                using if_policy = typename std::enable_if<policies::is_policy<Policy>::value, areal>::type;
+            }
+
+#define QLFORGE_BOOST_SPECIAL_FUNCTION(func, intrinsic, derivative)                                        \
+            inline forge::expr::AReal<double> func(const forge::expr::AReal<double>& x) {                  \
+                return forge_detail::recorded(x, boost::math::func(forge_detail::passive(x)),              \
+                                              &forge::expr::detail::intrinsic, derivative);                \
+            }                                                                                              \
+            template <class Policy>                                                                        \
+            inline forge_detail::if_policy<Policy> func(const forge::expr::AReal<double>& x,               \
+                                                        const Policy& pol) {                               \
+                return forge_detail::recorded(x, boost::math::func(forge_detail::passive(x), pol),         \
+                                              &forge::expr::detail::intrinsic, derivative);                \
+            }
+
+            // derivatives in terms of the argument x and the value v
+#define QLFORGE_DERIVATIVE(expression) [](double x, double v) { (void)x; (void)v; return expression; }
+
+            QLFORGE_BOOST_SPECIAL_FUNCTION(erf, forgeErf,
+                QLFORGE_DERIVATIVE(boost::math::constants::two_div_root_pi<double>() * std::exp(-x * x)))
+            QLFORGE_BOOST_SPECIAL_FUNCTION(erfc, forgeErfc,
+                QLFORGE_DERIVATIVE(-boost::math::constants::two_div_root_pi<double>() * std::exp(-x * x)))
+            QLFORGE_BOOST_SPECIAL_FUNCTION(erf_inv, forgeErfInv,
+                QLFORGE_DERIVATIVE(std::exp(v * v) / boost::math::constants::two_div_root_pi<double>()))
+            QLFORGE_BOOST_SPECIAL_FUNCTION(erfc_inv, forgeErfcInv,
+                QLFORGE_DERIVATIVE(-std::exp(v * v) / boost::math::constants::two_div_root_pi<double>()))
+            QLFORGE_BOOST_SPECIAL_FUNCTION(log1p, forgeLog1p, QLFORGE_DERIVATIVE(1.0 / (1.0 + x)))
+            QLFORGE_BOOST_SPECIAL_FUNCTION(expm1, forgeExpm1, QLFORGE_DERIVATIVE(v + 1.0))
+            // the gamma intrinsics hold for positive arguments only
+            QLFORGE_BOOST_SPECIAL_FUNCTION(tgamma, forgeTgamma,
+                QLFORGE_DERIVATIVE(v * boost::math::digamma(x)))
+            QLFORGE_BOOST_SPECIAL_FUNCTION(lgamma, forgeLgamma, QLFORGE_DERIVATIVE(boost::math::digamma(x)))
+
+            inline forge::expr::AReal<double> lgamma(const forge::expr::AReal<double>& x, int* sign) {
+                return forge_detail::recorded(x, boost::math::lgamma(forge_detail::passive(x), sign),
+                                              &forge::expr::detail::forgeLgamma,
+                                              QLFORGE_DERIVATIVE(boost::math::digamma(x)));
+            }
+
+#undef QLFORGE_DERIVATIVE
+#undef QLFORGE_BOOST_SPECIAL_FUNCTION
+
+            // complete beta function through lgamma, for positive arguments
+            template <class Policy>
+            inline forge_detail::if_policy<Policy> beta(const forge::expr::AReal<double>& a,
+                                                        const forge::expr::AReal<double>& b,
+                                                        const Policy& pol) {
+                forge::expr::AReal<double> r =
+                    boost::math::beta(forge_detail::passive(a), forge_detail::passive(b), pol);
+                if (forge_detail::recording(a) || forge_detail::recording(b)) {
+                    const forge::fdouble &fa = a.forgeValue(), &fb = b.forgeValue();
+                    r.setForgeValue(forge::exp(forge::expr::detail::forgeLgamma(fa) +
+                                               forge::expr::detail::forgeLgamma(fb) -
+                                               forge::expr::detail::forgeLgamma(fa + fb)));
+                }
+                typedef forge::expr::AReal<double>::tape_type tape_type;
+                if (tape_type* tape = tape_type::getActive()) {
+                    // dB/da = B (psi(a) - psi(a + b)), and the same in b
+                    const double pa = forge_detail::passive(a), pb = forge_detail::passive(b);
+                    const double v = forge_detail::passive(r), psi = boost::math::digamma(pa + pb);
+                    tape->pushPartials(r, {{v * (boost::math::digamma(pa) - psi), a.getSlot()},
+                                           {v * (boost::math::digamma(pb) - psi), b.getSlot()}});
+                }
+                return r;
+            }
+
+            inline forge::expr::AReal<double> beta(const forge::expr::AReal<double>& a,
+                                                   const forge::expr::AReal<double>& b) {
+                return beta(a, b, policies::policy<>());
+            }
+    }
 }
 
 